@@ -0,0 +1,72 @@
+#include "bench.h"
+
+#include "cebus/collection/aho_corasick.h"
+#include "cebus/core/arena.h"
+#include "cebus/type/string.h"
+
+#define TEXT (1 << 22)
+#define PATTERNS 64
+
+static void count_match(void *ctx, AcMatch match) {
+  (void)match;
+  (*(usize *)ctx)++;
+}
+
+int main(void) {
+  Arena arena = {0};
+
+  // words of random lowercase letters, separated by spaces
+  u64 seed = 0x853c49e6748fea9b;
+  char *text_buffer = arena_alloc(&arena, TEXT);
+  for (usize i = 0; i < TEXT; i++) {
+    const u64 r = bench_random(&seed);
+    text_buffer[i] = r % 6 == 0 ? ' ' : (char)('a' + (r >> 8) % 26);
+  }
+  const Str text = str_from_parts(TEXT, text_buffer);
+
+  Str patterns[PATTERNS];
+  Str replacements[PATTERNS];
+  for (usize p = 0; p < PATTERNS; p++) {
+    char buffer[8];
+    const usize len = 3 + p % 4;
+    for (usize i = 0; i < len; i++) {
+      buffer[i] = (char)('a' + bench_random(&seed) % 26);
+    }
+    patterns[p] = str_copy(str_from_parts(len, buffer), &arena);
+    replacements[p] = str_format(&arena, "<%" USIZE_FMT ">", p);
+  }
+  AhoCorasick *ac = ac_create(&arena, PATTERNS, patterns);
+  cebus_log_info("%d bytes, %d patterns", TEXT, PATTERNS);
+
+  cebus_log_info("count every pattern");
+  BENCH("  str_count for every pattern", TEXT, {
+    for (usize p = 0; p < PATTERNS; p++) {
+      bench_sink += str_count(text, patterns[p]);
+    }
+  });
+  BENCH("  ac_each", TEXT, {
+    usize count = 0;
+    AcStream stream = ac_stream(ac);
+    ac_each(&stream, str_to_bytes(text), count_match, &count);
+    bench_sink += count;
+  });
+
+  cebus_log_info("replace every pattern");
+  BENCH("  str_replace for every pattern", TEXT, {
+    Arena scratch = {0};
+    Str s = text;
+    for (usize p = 0; p < PATTERNS; p++) {
+      s = str_replace(s, patterns[p], replacements[p], &scratch);
+    }
+    bench_sink += s.len;
+    arena_free(&scratch);
+  });
+  BENCH("  str_replace_many", TEXT, {
+    Arena scratch = {0};
+    const Str s = str_replace_many(text, PATTERNS, patterns, replacements, &scratch);
+    bench_sink += s.len;
+    arena_free(&scratch);
+  });
+
+  arena_free(&arena);
+}
@@ -0,0 +1,55 @@
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+// 'clock_gettime()' is POSIX, so this has to be included before anything else.
+#if defined(__linux__) && !defined(_POSIX_C_SOURCE)
+#define _POSIX_C_SOURCE 199309L
+#endif
+
+#include "cebus/core/defines.h" // IWYU pragma: export
+#include "cebus/core/logging.h" // IWYU pragma: export
+
+#if defined(LINUX)
+#include <time.h>
+#endif
+
+// Benchmarks only make sense in an optimized build.
+
+static volatile u64 bench_sink;
+
+UNUSED static f64 bench_now(void) {
+#if defined(LINUX)
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (f64)ts.tv_sec + (f64)ts.tv_nsec * 1e-9;
+#elif defined(WINDOWS)
+  LARGE_INTEGER frequency, counter;
+  QueryPerformanceFrequency(&frequency);
+  QueryPerformanceCounter(&counter);
+  return (f64)counter.QuadPart / (f64)frequency.QuadPart;
+#else
+  return 0;
+#endif
+}
+
+UNUSED static u64 bench_random(u64 *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+UNUSED static void bench_report(const char *name, usize count, f64 seconds) {
+  cebus_log_info("%-48s %10.3f ms %8.2f ns/op", name, seconds * 1e3,
+                 seconds * 1e9 / (f64)(count ? count : 1));
+}
+
+// Runs the block once and reports the time per operation.
+#define BENCH(name, count, ...)                                                                    \
+  do {                                                                                             \
+    const f64 __bench_start = bench_now();                                                         \
+    __VA_ARGS__;                                                                                   \
+    bench_report((name), (count), bench_now() - __bench_start);                                    \
+  } while (0)
+
+#endif /* !__BENCH_H__ */
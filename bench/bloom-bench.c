@@ -0,0 +1,86 @@
+#include "bench.h"
+
+#include "cebus/collection/bloom.h"
+#include "cebus/collection/set.h"
+
+static void bench_accuracy(usize n, f64 fp_rate, bool blocked) {
+  Arena arena = {0};
+  BloomFilter bf = blocked ? bloom_create_blocked(&arena, n, fp_rate)
+                           : bloom_create(&arena, n, fp_rate);
+  u64 seed = 0x2545F4914F6CDD1D;
+  for (usize i = 0; i < n; i++) {
+    bloom_add(&bf, bench_random(&seed));
+  }
+  usize fp = 0;
+  const usize lookups = 1000000;
+  for (usize i = 0; i < lookups; i++) {
+    fp += bloom_contains(&bf, bench_random(&seed));
+  }
+  cebus_log_info("  %-8s target %.4f: %5.2f bits/member k=%2" USIZE_FMT
+                 " measured %.5f estimated %.5f",
+                 blocked ? "blocked" : "classic", fp_rate, (f64)bf.bits / (f64)n, bf.k,
+                 (f64)fp / (f64)lookups, bloom_fp_rate(&bf));
+  arena_free(&arena);
+}
+
+static void bench_throughput(usize n) {
+  Arena arena = {0};
+  u64 *hashes = arena_alloc(&arena, n * sizeof(u64));
+  u64 seed = 0x9E3779B97F4A7C15;
+  for (usize i = 0; i < n; i++) {
+    hashes[i] = bench_random(&seed);
+  }
+  // half of the lookups are members
+  u64 *lookups = arena_alloc(&arena, n * sizeof(u64));
+  for (usize i = 0; i < n; i++) {
+    lookups[i] = i % 2 ? hashes[(i * 7) % n] : bench_random(&seed);
+  }
+
+  cebus_log_info("%" USIZE_FMT " members", n);
+
+  Set set = set_create(&arena);
+  BENCH("  set_add", n, set_extend(&set, n, hashes));
+  BENCH("  set_contains", n, {
+    for (usize i = 0; i < n; i++) {
+      bench_sink += set_contains(&set, lookups[i]);
+    }
+  });
+
+  BloomFilter classic = bloom_create(&arena, n, 0.01);
+  BloomFilter blocked = bloom_create_blocked(&arena, n, 0.01);
+  BENCH("  bloom_add (classic)", n, bloom_extend(&classic, n, hashes));
+  BENCH("  bloom_add (blocked)", n, bloom_extend(&blocked, n, hashes));
+  BENCH("  bloom_contains (classic)", n, {
+    for (usize i = 0; i < n; i++) {
+      bench_sink += bloom_contains(&classic, lookups[i]);
+    }
+  });
+  BENCH("  bloom_contains (blocked)", n, {
+    for (usize i = 0; i < n; i++) {
+      bench_sink += bloom_contains(&blocked, lookups[i]);
+    }
+  });
+  BENCH("  bloom_contains_batch (classic)", n,
+        bench_sink += bloom_contains_batch(&classic, n, lookups, NULL));
+  BENCH("  bloom_contains_batch (blocked)", n,
+        bench_sink += bloom_contains_batch(&blocked, n, lookups, NULL));
+
+  cebus_log_info("  memory: set %" USIZE_FMT " KiB, classic %" USIZE_FMT
+                 " KiB, blocked %" USIZE_FMT " KiB",
+                 set.cap * sizeof(u64) / 1024, classic.bits / 8 / 1024, blocked.bits / 8 / 1024);
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  cebus_log_info("accuracy with 1000000 members");
+  const f64 rates[] = {0.1, 0.01, 0.001, 0.0001};
+  for (usize i = 0; i < ARRAY_LEN(rates); i++) {
+    bench_accuracy(1000000, rates[i], false);
+    bench_accuracy(1000000, rates[i], true);
+  }
+
+  bench_throughput(100000);
+  bench_throughput(1000000);
+  bench_throughput(10000000);
+}
@@ -0,0 +1,88 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/core/arena.h"
+#include "cebus/type/char.h"
+#include "cebus/type/integer.h"
+#include "cebus/type/string.h"
+
+#include <string.h>
+
+static bool is_separator(char c) { return c_is_space(c) || c_is_punct(c); }
+
+// Words of 1 to 12 letters, separated by spaces, punctuation and newlines.
+static Str bench_text(Arena *arena, usize len) {
+  static const char separators[] = "   ,.;\n(){}";
+  char *buffer = arena_alloc(arena, len);
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < len;) {
+    const u64 r = bench_random(&seed);
+    const usize word = usize_min(r % 12 + 1, len - i);
+    for (usize j = 0; j < word; j++) {
+      buffer[i++] = (char)('a' + (r >> (8 + j * 4)) % 26);
+    }
+    if (i < len) {
+      buffer[i++] = separators[(r >> 58) % (sizeof(separators) - 1)];
+    }
+  }
+  return str_from_parts(len, buffer);
+}
+
+static usize predicate_count(Str s) {
+  usize count = 0;
+  for (usize i = 0; i < s.len; i++) {
+    count += is_separator(s.data[i]);
+  }
+  return count;
+}
+
+int main(void) {
+  Arena arena = {0};
+  const Str text = bench_text(&arena, 1 << 20);
+  const CharSet separators = charset_from_predicate(is_separator);
+  cebus_log_info("%" USIZE_FMT " bytes of words", text.len);
+
+  cebus_log_info("chop every word");
+  BENCH("  str_try_chop_by_predicate", text.len, {
+    Str rest = text;
+    for (Str word; str_try_chop_by_predicate(&rest, is_separator, &word);) {
+      bench_sink += word.len;
+    }
+  });
+  BENCH("  str_try_chop_by_charset", text.len, {
+    Str rest = text;
+    for (Str word; str_try_chop_by_charset(&rest, &separators, &word);) {
+      bench_sink += word.len;
+    }
+  });
+  BENCH("  str_split", text.len, {
+    Arena scratch = {0};
+    DA(Str) words = da_new(&scratch);
+    str_split(text, &separators, &words);
+    bench_sink += words.len;
+    arena_free(&scratch);
+  });
+
+  cebus_log_info("count separators");
+  BENCH("  predicate loop", text.len, { bench_sink += predicate_count(text); });
+  BENCH("  str_count_by_charset", text.len, {
+    bench_sink += str_count_by_charset(text, &separators);
+  });
+
+  // a long run of padding, like an indented or aligned line
+  char *padded = arena_alloc(&arena, 4096);
+  memset(padded, ' ', 4096);
+  memcpy(&padded[2000], "value", 5);
+  const Str line = str_from_parts(4096, padded);
+  const CharSet space = charset_from_predicate(c_is_space);
+
+  cebus_log_info("trim 4 KiB of padding");
+  BENCH("  str_trim_by_predicate", line.len, {
+    bench_sink += str_trim_by_predicate(line, c_is_space).len;
+  });
+  BENCH("  str_trim_by_charset", line.len, {
+    bench_sink += str_trim_by_charset(line, &space).len;
+  });
+
+  arena_free(&arena);
+}
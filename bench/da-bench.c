@@ -0,0 +1,142 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+
+typedef DA(u64) U64Array;
+
+// the old way: shift one element at a time
+static void loop_insert(U64Array *list, u64 value, usize idx) {
+  da_reserve(list, 1);
+  for (usize i = da_len(list); idx < i; i--) {
+    da_get(list, i) = da_get(list, i - 1);
+  }
+  da_get(list, idx) = value;
+  da_len(list)++;
+}
+
+static void loop_remove(U64Array *list, usize idx) {
+  for (usize i = idx + 1; i < da_len(list); i++) {
+    da_get(list, i - 1) = da_get(list, i);
+  }
+  da_len(list)--;
+}
+
+static bool keep(u64 value) { return value % 3 != 0; }
+static bool keep_most(u64 value) { return value % 1000 < 900; }
+
+static void fill(U64Array *list, usize n) {
+  da_clear(list);
+  for (usize i = 0; i < n; i++) {
+    da_push(list, i);
+  }
+}
+
+static void bench_single(U64Array *list, usize n) {
+  const usize ops = 1000;
+  fill(list, n);
+  BENCH("  1000 front inserts (loop)", ops, {
+    for (usize i = 0; i < ops; i++) {
+      loop_insert(list, i, 0);
+    }
+  });
+  fill(list, n);
+  BENCH("  1000 front inserts (da_insert)", ops, {
+    for (usize i = 0; i < ops; i++) {
+      da_insert(list, i, 0);
+    }
+  });
+  fill(list, n);
+  BENCH("  1000 front removes (loop)", ops, {
+    for (usize i = 0; i < ops; i++) {
+      loop_remove(list, 0);
+    }
+  });
+  fill(list, n);
+  BENCH("  1000 front removes (da_remove)", ops, {
+    for (usize i = 0; i < ops; i++) {
+      da_remove(list, 0);
+    }
+  });
+  fill(list, n);
+  BENCH("  remove a third (loop remove)", n, {
+    for (usize i = 0; i < da_len(list);) {
+      if (keep(da_get(list, i))) {
+        i++;
+      } else {
+        loop_remove(list, i);
+      }
+    }
+  });
+}
+
+static void bench_size(usize n) {
+  Arena arena = {0};
+  U64Array list = da_new(&arena);
+  const usize ops = 1000;
+  cebus_log_info("%" USIZE_FMT " elements", n);
+
+  // moving one element at a time is quadratic
+  if (n <= 100000) {
+    bench_single(&list, n);
+  }
+
+  u64 block[1000];
+  for (usize i = 0; i < ARRAY_LEN(block); i++) {
+    block[i] = i;
+  }
+  fill(&list, n);
+  BENCH("  1000 front inserts (da_insert_n)", ops, da_insert_n(&list, ops, block, 0));
+  fill(&list, n);
+  BENCH("  1000 front removes (da_remove_range)", ops, da_remove_range(&list, 0, ops));
+  fill(&list, n);
+  BENCH("  1000 removes (da_swap_remove)", ops, {
+    for (usize i = 0; i < ops; i++) {
+      da_swap_remove(&list, i);
+    }
+  });
+
+  fill(&list, n);
+  BENCH("  remove a third (da_filter)", n, da_filter(&list, &list, keep));
+  fill(&list, n);
+  BENCH("  remove a third (da_retain)", n, da_retain(&list, keep));
+  fill(&list, n);
+  BENCH("  remove every 10th block of 100 (da_filter)", n, da_filter(&list, &list, keep_most));
+  fill(&list, n);
+  BENCH("  remove every 10th block of 100 (da_retain)", n, da_retain(&list, keep_most));
+  bench_sink += da_len(&list);
+
+  arena_free(&arena);
+}
+
+// lots of tiny arrays, like the arguments of a command
+static void bench_small(usize n) {
+  Arena arena = {0};
+  cebus_log_info("%" USIZE_FMT " arrays of 4 elements", n);
+  BENCH("  DA(u64)", n, {
+    for (usize i = 0; i < n; i++) {
+      U64Array list = da_new(&arena);
+      for (u64 j = 0; j < 4; j++) {
+        da_push(&list, i + j);
+      }
+      bench_sink += da_last(&list);
+      arena_free_chunk(&arena, list.items);
+    }
+  });
+  BENCH("  SDA(u64, 8)", n, {
+    for (usize i = 0; i < n; i++) {
+      SDA(u64, 8) list = sda_new(&list, &arena);
+      for (u64 j = 0; j < 4; j++) {
+        da_push(&list, i + j);
+      }
+      bench_sink += da_last(&list);
+    }
+  });
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_small(1000000);
+  bench_size(10000);
+  bench_size(100000);
+  bench_size(10000000);
+}
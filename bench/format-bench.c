@@ -0,0 +1,83 @@
+#include "bench.h"
+
+#include "cebus/collection/string_builder.h"
+#include "cebus/core/arena.h"
+#include "cebus/type/byte.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// What 'bytes_to_hex' did before, for comparison.
+static Str snprintf_to_hex(Bytes bytes, Arena *arena) {
+  char *buf = arena_calloc(arena, bytes.size * 2 + 1);
+  usize idx = 0;
+  for (usize i = 0; i < bytes.size; i++) {
+    idx += (usize)snprintf(&buf[idx], 3, "%0*x", (i != 0) + 1, bytes.data[i]);
+  }
+  return (Str){.len = idx, .data = buf};
+}
+
+int main(void) {
+  Arena arena = {0};
+  const usize count = 1000000;
+  u64 *integers = arena_alloc(&arena, count * sizeof(u64));
+  f64 *floats = arena_alloc(&arena, count * sizeof(f64));
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < count; i++) {
+    const u64 r = bench_random(&seed);
+    integers[i] = r >> (r % 48);
+    floats[i] = (f64)(r % 100000000) / 1000.0;
+  }
+  StringBuilder sb = sb_init(&arena);
+  da_reserve(&sb, count * 32);
+
+  cebus_log_info("u64 (ns/number)");
+  BENCH("  sb_append_fmt", count, {
+    sb_clear(&sb);
+    for (usize i = 0; i < count; i++) {
+      sb_append_fmt(&sb, "%" U64_FMT, integers[i]);
+    }
+  });
+  BENCH("  sb_append_u64", count, {
+    sb_clear(&sb);
+    for (usize i = 0; i < count; i++) {
+      sb_append_u64(&sb, integers[i]);
+    }
+  });
+
+  cebus_log_info("hex (ns/number)");
+  BENCH("  sb_append_fmt", count, {
+    sb_clear(&sb);
+    for (usize i = 0; i < count; i++) {
+      sb_append_fmt(&sb, "%" U64_HEX, integers[i]);
+    }
+  });
+  BENCH("  sb_append_hex", count, {
+    sb_clear(&sb);
+    for (usize i = 0; i < count; i++) {
+      sb_append_hex(&sb, integers[i]);
+    }
+  });
+
+  cebus_log_info("f64, 3 decimals (ns/number)");
+  BENCH("  sb_append_fmt %.17g", count, {
+    sb_clear(&sb);
+    for (usize i = 0; i < count; i++) {
+      sb_append_fmt(&sb, "%.17g", floats[i]);
+    }
+  });
+  BENCH("  sb_append_f64", count, {
+    sb_clear(&sb);
+    for (usize i = 0; i < count; i++) {
+      sb_append_f64(&sb, floats[i]);
+    }
+  });
+  bench_sink += sb.len;
+
+  const Bytes bytes = bytes_from_parts(count * sizeof(u64), integers);
+  cebus_log_info("bytes_to_hex (ns/byte)");
+  BENCH("  snprintf", bytes.size, { bench_sink += snprintf_to_hex(bytes, &arena).len; });
+  BENCH("  bytes_to_hex", bytes.size, { bench_sink += bytes_to_hex(bytes, &arena).len; });
+
+  arena_free(&arena);
+}
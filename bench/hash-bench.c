@@ -0,0 +1,81 @@
+#include "bench.h"
+
+#include "cebus/core/arena.h"
+#include "cebus/type/byte.h"
+#include "cebus/type/integer.h"
+
+#include <stdio.h>
+
+// The byte at a time FNV-1a, that 'bytes_hash' used before, for comparison.
+static u64 fnv1a_hash(Bytes bytes) {
+  u64 hash = 2166136261UL;
+  for (usize i = 0; i < bytes.size; i++) {
+    hash ^= bytes.data[i];
+    hash *= 16777619;
+  }
+  return hash;
+}
+
+// The integer hash, that 'u64_hash' used before, with two divisions.
+static u64 modulo_hash(u64 value) {
+  u64 hash = value + 1;
+  hash = (((hash >> 16) ^ hash) % 0x3AA387A8B1) * 0x45d9f3b;
+  hash = (((hash >> 16) ^ hash) % 0x3AA387A8B1) * 0x45d9f3b;
+  return (hash >> 16) ^ hash;
+}
+
+static void bench_integers(Arena *arena) {
+  const usize count = 16 * 1024 * 1024;
+  u64 *values = arena_alloc(arena, count * sizeof(u64));
+  u64 *hashes = arena_alloc(arena, count * sizeof(u64));
+  u64 seed = 0x2545f4914f6cdd1d;
+  for (usize i = 0; i < count; i++) {
+    values[i] = bench_random(&seed);
+  }
+  cebus_log_info("u64 keys (ns/key)");
+  BENCH("  modulo hash", count, {
+    for (usize i = 0; i < count; i++) {
+      hashes[i] = modulo_hash(values[i]);
+    }
+  });
+  BENCH("  u64_hash", count, {
+    for (usize i = 0; i < count; i++) {
+      hashes[i] = u64_hash(values[i]);
+    }
+  });
+  BENCH("  u64_hash_batch", count, { u64_hash_batch(count, values, hashes, 0); });
+  bench_sink += hashes[count / 2];
+}
+
+int main(void) {
+  Arena arena = {0};
+  const usize total = 64 * 1024 * 1024;
+  u8 *data = arena_alloc(&arena, total);
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < total; i++) {
+    data[i] = (u8)bench_random(&seed);
+  }
+
+  const usize lengths[] = {4, 8, 16, 32, 64, 256, 4096};
+  for (usize l = 0; l < ARRAY_LEN(lengths); l++) {
+    const usize len = lengths[l];
+    const usize keys = total / len;
+    char label[64];
+    snprintf(label, sizeof(label), "%" USIZE_FMT " byte keys (ns/byte)", len);
+    cebus_log_info("%s", label);
+    BENCH("  fnv1a", total, {
+      for (usize i = 0; i < keys; i++) {
+        bench_sink += fnv1a_hash(bytes_from_parts(len, &data[i * len]));
+      }
+    });
+    BENCH("  bytes_hash", total, {
+      for (usize i = 0; i < keys; i++) {
+        bench_sink += bytes_hash(bytes_from_parts(len, &data[i * len]));
+      }
+    });
+  }
+
+  bench_integers(&arena);
+
+  arena_free(&arena);
+}
@@ -0,0 +1,86 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/collection/heap.h"
+
+HEAP_DEFINE(Heap2, u64, 2, *a < *b)
+HEAP_DEFINE(Heap4, u64, 4, *a < *b)
+
+typedef DA(u64) U64Array;
+
+static int compare_desc(const void *a, const void *b) {
+  const u64 x = *(const u64 *)a;
+  const u64 y = *(const u64 *)b;
+  return (x < y) - (y < x);
+}
+
+static void bench_queue(usize n) {
+  Arena arena = {0};
+  U64Array values = da_new(&arena);
+  u64 seed = 0x9E3779B97F4A7C15;
+  for (usize i = 0; i < n; i++) {
+    da_push(&values, bench_random(&seed));
+  }
+  cebus_log_info("%" USIZE_FMT " elements", n);
+
+  // the old way: sort after every push and pop from the back
+  if (n <= 10000) {
+    U64Array sorted = da_new(&arena);
+    BENCH("  da_push + da_sort", n, {
+      for (usize i = 0; i < n; i++) {
+        da_push(&sorted, da_get(&values, i));
+        da_sort(&sorted, compare_desc);
+      }
+      for (usize i = 0; i < n; i++) {
+        bench_sink += da_pop(&sorted);
+      }
+    });
+  }
+
+  Heap2 binary = da_new(&arena);
+  BENCH("  push + pop (binary)", n, {
+    for (usize i = 0; i < n; i++) {
+      Heap2_push(&binary, da_get(&values, i));
+    }
+    for (usize i = 0; i < n; i++) {
+      bench_sink += Heap2_pop(&binary);
+    }
+  });
+  Heap4 quad = da_new(&arena);
+  BENCH("  push + pop (4-ary)", n, {
+    for (usize i = 0; i < n; i++) {
+      Heap4_push(&quad, da_get(&values, i));
+    }
+    for (usize i = 0; i < n; i++) {
+      bench_sink += Heap4_pop(&quad);
+    }
+  });
+  BENCH("  heapify (4-ary)", n, {
+    Heap4 heap = Heap4_from(&arena, DA_ARG(&values));
+    bench_sink += Heap4_peek(&heap);
+  });
+
+  const usize k = 100;
+  U64Array copy = da_new(&arena);
+  BENCH("  top 100 (da_sort_by)", n, {
+    da_copy(&values, &copy);
+    da_sort_by(&copy, u64, *b < *a);
+    bench_sink += da_get(&copy, k - 1);
+  });
+  Heap2 best = da_new(&arena);
+  BENCH("  top 100 (push_top_k)", n, {
+    da_clear(&best);
+    for (usize i = 0; i < n; i++) {
+      Heap2_push_top_k(&best, k, da_get(&values, i));
+    }
+    bench_sink += Heap2_peek(&best);
+  });
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_queue(10000);
+  bench_queue(1000000);
+  bench_queue(10000000);
+}
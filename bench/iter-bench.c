@@ -0,0 +1,96 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/collection/iter.h"
+#include "cebus/core/debug.h"
+
+typedef DA(u64) U64Array;
+
+static bool is_kept(u64 value) { return value % 4 != 0; }
+static u64 scramble(u64 value) { return (value ^ (value >> 29)) * 0xbf58476d1ce4e5b9; }
+static bool is_small(u64 value) { return value < ((u64)1 << 62); }
+
+static void bench_pipeline(usize n) {
+  Arena source = {0};
+  U64Array numbers = da_new(&source);
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < n; i++) {
+    da_push(&numbers, bench_random(&seed));
+  }
+  cebus_log_info("%" USIZE_FMT " elements: filter -> map -> filter -> collect", n);
+
+  Arena eager = {0};
+  usize eager_len = 0;
+  BENCH("  da_filter + da_map (eager)", n, {
+    U64Array kept = da_new(&eager);
+    U64Array mapped = da_new(&eager);
+    U64Array result = da_new(&eager);
+    da_filter(&numbers, &kept, is_kept);
+    da_map(&kept, &mapped, scramble);
+    da_filter(&mapped, &result, is_small);
+    eager_len = da_len(&result);
+  });
+
+  Arena fused = {0};
+  usize fused_len = 0;
+  BENCH("  it_da pipeline (fused)", n, {
+    U64Array result = da_new(&fused);
+    it_da(u64, x, &numbers)
+      it_filter(is_kept(x))
+        it_map(u64, y, scramble(x))
+          it_filter(is_small(y))
+            it_collect(&result, y);
+    fused_len = da_len(&result);
+  });
+  cebus_assert(eager_len == fused_len, "The pipelines disagree");
+
+
+  // one more run of each on an empty arena for the memory usage
+  arena_free(&eager);
+  arena_free(&fused);
+  U64Array kept = da_new(&eager);
+  U64Array mapped = da_new(&eager);
+  U64Array eager_result = da_new(&eager);
+  da_filter(&numbers, &kept, is_kept);
+  da_map(&kept, &mapped, scramble);
+  da_filter(&mapped, &eager_result, is_small);
+  U64Array fused_result = da_new(&fused);
+  it_da(u64, x, &numbers)
+    it_filter(is_kept(x))
+      it_map(u64, y, scramble(x))
+        it_filter(is_small(y))
+          it_collect(&fused_result, y);
+  cebus_log_info("  memory: eager %" USIZE_FMT " KiB, fused %" USIZE_FMT " KiB",
+                 arena_size(&eager) / 1024, arena_size(&fused) / 1024);
+
+  u64 sum = 0;
+  BENCH("  it_da pipeline (fold, no allocation)", n, {
+    sum = 0;
+    it_da(u64, x, &numbers)
+      it_filter(is_kept(x))
+        it_map(u64, y, scramble(x))
+          it_filter(is_small(y))
+            it_fold(sum, sum + y);
+  });
+  bench_sink += sum;
+
+  BENCH("  it_da pipeline (take 100)", n, {
+    U64Array result = da_new(&fused);
+    it_da(u64, x, &numbers)
+      it_filter(is_kept(x))
+        it_map(u64, y, scramble(x))
+          it_take(100)
+            it_collect(&result, y);
+    bench_sink += da_len(&result);
+  });
+
+  arena_free(&eager);
+  arena_free(&fused);
+  arena_free(&source);
+}
+
+int main(void) {
+  bench_pipeline(100000);
+  bench_pipeline(1000000);
+  bench_pipeline(10000000);
+}
@@ -0,0 +1,158 @@
+#include "bench.h"
+
+#include "cebus/core/arena.h"
+#include "cebus/type/numeric.h"
+
+static void bench_f64(usize n) {
+  Arena arena = {0};
+  f64 *values = arena_alloc(&arena, n * sizeof(f64));
+  f64 *out = arena_alloc(&arena, n * sizeof(f64));
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < n; i++) {
+    values[i] = (f64)(bench_random(&seed) % 1000);
+  }
+  cebus_log_info("%" USIZE_FMT " f64", n);
+
+  BENCH("  sum (loop)", n, {
+    f64 sum = 0;
+    for (usize i = 0; i < n; i++) {
+      sum += values[i];
+    }
+    bench_sink += (u64)sum;
+  });
+  BENCH("  sum (f64_sum)", n, { bench_sink += (u64)f64_sum(n, values); });
+  BENCH("  minmax (loop)", n, {
+    f64 lo = values[0], hi = values[0];
+    for (usize i = 1; i < n; i++) {
+      lo = values[i] < lo ? values[i] : lo;
+      hi = hi < values[i] ? values[i] : hi;
+    }
+    bench_sink += (u64)(lo + hi);
+  });
+  BENCH("  minmax (f64_minmax)", n, {
+    f64 lo, hi;
+    f64_minmax(n, values, &lo, &hi);
+    bench_sink += (u64)(lo + hi);
+  });
+  BENCH("  dot (loop)", n, {
+    f64 sum = 0;
+    for (usize i = 0; i < n; i++) {
+      sum += values[i] * values[i];
+    }
+    bench_sink += (u64)sum;
+  });
+  BENCH("  dot (f64_dot)", n, { bench_sink += (u64)f64_dot(n, values, values); });
+  BENCH("  prefix sum (loop)", n, {
+    f64 sum = 0;
+    for (usize i = 0; i < n; i++) {
+      sum += values[i];
+      out[i] = sum;
+    }
+    bench_sink += (u64)out[n - 1];
+  });
+  BENCH("  prefix sum (f64_prefix_sum)", n, {
+    f64_prefix_sum(n, values, out);
+    bench_sink += (u64)out[n - 1];
+  });
+  BENCH("  histogram (loop)", n, {
+    usize counts[64] = {0};
+    for (usize i = 0; i < n; i++) {
+      if (0 <= values[i] && values[i] < 1000) {
+        counts[(usize)(values[i] * 64 / 1000)]++;
+      }
+    }
+    bench_sink += counts[0];
+  });
+  BENCH("  histogram (f64_histogram)", n, {
+    usize counts[64] = {0};
+    f64_histogram(n, values, 0, 1000, 64, counts);
+    bench_sink += counts[0];
+  });
+  // most values in the same bin
+  for (usize i = 0; i < n; i++) {
+    values[i] = i % 8 ? 1 : values[i];
+  }
+  BENCH("  skewed histogram (loop)", n, {
+    usize counts[64] = {0};
+    for (usize i = 0; i < n; i++) {
+      if (0 <= values[i] && values[i] < 1000) {
+        counts[(usize)(values[i] * 64 / 1000)]++;
+      }
+    }
+    bench_sink += counts[0];
+  });
+  BENCH("  skewed histogram (f64_histogram)", n, {
+    usize counts[64] = {0};
+    f64_histogram(n, values, 0, 1000, 64, counts);
+    bench_sink += counts[0];
+  });
+
+  arena_free(&arena);
+}
+
+static void bench_f32(usize n) {
+  Arena arena = {0};
+  f32 *values = arena_alloc(&arena, n * sizeof(f32));
+  f32 *out = arena_alloc(&arena, n * sizeof(f32));
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < n; i++) {
+    values[i] = (f32)(bench_random(&seed) % 100);
+  }
+  cebus_log_info("%" USIZE_FMT " f32", n);
+
+  BENCH("  sum (loop)", n, {
+    f32 sum = 0;
+    for (usize i = 0; i < n; i++) {
+      sum += values[i];
+    }
+    bench_sink += (u64)sum;
+  });
+  BENCH("  sum (f32_sum)", n, { bench_sink += (u64)f32_sum(n, values); });
+  BENCH("  prefix sum (loop)", n, {
+    f32 sum = 0;
+    for (usize i = 0; i < n; i++) {
+      sum += values[i];
+      out[i] = sum;
+    }
+    bench_sink += (u64)out[n - 1];
+  });
+  BENCH("  prefix sum (f32_prefix_sum)", n, {
+    f32_prefix_sum(n, values, out);
+    bench_sink += (u64)out[n - 1];
+  });
+
+  arena_free(&arena);
+}
+
+static void bench_i64(usize n) {
+  Arena arena = {0};
+  i64 *values = arena_alloc(&arena, n * sizeof(i64));
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < n; i++) {
+    values[i] = (i64)bench_random(&seed);
+  }
+  cebus_log_info("%" USIZE_FMT " i64", n);
+
+  BENCH("  minmax (loop)", n, {
+    i64 lo = values[0], hi = values[0];
+    for (usize i = 1; i < n; i++) {
+      lo = values[i] < lo ? values[i] : lo;
+      hi = hi < values[i] ? values[i] : hi;
+    }
+    bench_sink += (u64)(lo ^ hi);
+  });
+  BENCH("  minmax (i64_minmax)", n, {
+    i64 lo, hi;
+    i64_minmax(n, values, &lo, &hi);
+    bench_sink += (u64)(lo ^ hi);
+  });
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_f64(100000);
+  bench_f64(10000000);
+  bench_f32(10000000);
+  bench_i64(10000000);
+}
@@ -0,0 +1,83 @@
+#include "bench.h"
+
+#include "cebus/collection/da_par.h"
+#include "cebus/core/cpu.h"
+#include "cebus/type/integer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// some work per item, so the map is not only bound by memory
+static u64 mix(u64 value) {
+  for (usize i = 0; i < 8; i++) {
+    value ^= value >> 31;
+    value *= 0x7fb5d329728ea185;
+  }
+  return value;
+}
+
+static void mix_item(const void *item, void *out) { *(u64 *)out = mix(*(const u64 *)item); }
+
+static bool is_small(const void *item) { return *(const u64 *)item < (U64_MAX / 4); }
+
+#define MIX(value) mix(value)
+#define IS_SMALL(value) ((value) < (U64_MAX / 4))
+
+static void bench_scaling(usize n, usize max_threads) {
+  Arena arena = {0};
+  DA(u64) values = da_new(&arena);
+  DA(u64) dest = da_new(&arena);
+  DA(u64) sorted = da_new(&arena);
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < n; i++) {
+    da_push(&values, bench_random(&seed));
+  }
+  da_reserve(&sorted, n);
+  da_len(&sorted) = n;
+  cebus_log_info("%" USIZE_FMT " u64, %" USIZE_FMT " cpus", n, cpu_count());
+
+  BENCH("  map (da_map)", n, {
+    da_map(&values, &dest, MIX);
+    bench_sink += da_get(&dest, n - 1);
+  });
+  BENCH("  filter (da_filter)", n, {
+    da_filter(&values, &dest, IS_SMALL);
+    bench_sink += da_len(&dest);
+  });
+  memcpy(sorted.items, values.items, n * sizeof(u64));
+  BENCH("  sort (da_sort)", n, {
+    da_sort(&sorted, u64_compare_qsort(CMP_LESS));
+    bench_sink += da_get(&sorted, 0);
+  });
+
+  char name[64];
+  for (usize threads = 1; threads <= max_threads; threads *= 2) {
+    ThreadPool *pool = thread_pool_create(&arena, threads);
+    snprintf(name, sizeof(name), "  map (da_par_map, %" USIZE_FMT " threads)", threads);
+    BENCH(name, n, {
+      da_par_map(pool, &values, &dest, mix_item);
+      bench_sink += da_get(&dest, n - 1);
+    });
+    snprintf(name, sizeof(name), "  filter (da_par_filter, %" USIZE_FMT " threads)", threads);
+    BENCH(name, n, {
+      da_par_filter(pool, &values, &dest, is_small);
+      bench_sink += da_len(&dest);
+    });
+    memcpy(sorted.items, values.items, n * sizeof(u64));
+    snprintf(name, sizeof(name), "  sort (da_par_sort, %" USIZE_FMT " threads)", threads);
+    BENCH(name, n, {
+      da_par_sort(pool, &sorted, u64_compare_qsort(CMP_LESS));
+      bench_sink += da_get(&sorted, 0);
+    });
+    thread_pool_destroy(pool);
+  }
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  const usize cpus = cpu_count();
+  const usize max_threads = cpus < 8 ? 8 : cpus;
+  bench_scaling(100000, max_threads);
+  bench_scaling(10000000, max_threads);
+}
@@ -0,0 +1,90 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/core/arena.h"
+#include "cebus/type/string.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+// What 'str_u64' and 'str_f64' did before, for comparison.
+static u64 copy_u64(Str s) {
+  Arena arena = {0};
+  Str owned = str_copy(s, &arena);
+  u64 value = strtoull(owned.data, NULL, 10);
+  arena_free(&arena);
+  return value;
+}
+
+static f64 copy_f64(Str s) {
+  Arena arena = {0};
+  Str owned = str_copy(s, &arena);
+  f64 value = strtod(owned.data, NULL);
+  arena_free(&arena);
+  return value;
+}
+
+// One number per line.
+static Str bench_column(Arena *arena, usize lines, const char *fmt, bool floats) {
+  char *buffer = arena_alloc(arena, lines * 32);
+  usize len = 0;
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < lines; i++) {
+    const u64 r = bench_random(&seed);
+    if (floats) {
+      len += (usize)sprintf(&buffer[len], fmt, (f64)(r % 100000000) / 1000.0);
+    } else {
+      len += (usize)sprintf(&buffer[len], fmt, r >> (r % 48));
+    }
+  }
+  return str_from_parts(len, buffer);
+}
+
+int main(void) {
+  Arena arena = {0};
+  const usize lines = 1000000;
+
+  const Str integers = bench_column(&arena, lines, "%" U64_FMT "\n", false);
+  cebus_log_info("u64 column (ns/number)");
+  BENCH("  copy + strtoull", lines, {
+    Str s = integers;
+    for (Str field; str_try_chop_by_delim(&s, '\n', &field);) {
+      bench_sink += copy_u64(field);
+    }
+  });
+  BENCH("  str_u64", lines, {
+    Str s = integers;
+    for (Str field; str_try_chop_by_delim(&s, '\n', &field);) {
+      bench_sink += str_u64(field);
+    }
+  });
+  DA(u64) ids = da_new(&arena);
+  BENCH("  str_parse_u64_da", lines, {
+    da_clear(&ids);
+    str_parse_u64_da(integers, '\n', &ids, ErrPanic);
+    bench_sink += da_len(&ids);
+  });
+
+  const Str floats = bench_column(&arena, lines, "%.3f\n", true);
+  cebus_log_info("f64 column, 3 decimals (ns/number)");
+  BENCH("  copy + strtod", lines, {
+    Str s = floats;
+    for (Str field; str_try_chop_by_delim(&s, '\n', &field);) {
+      bench_sink += (u64)copy_f64(field);
+    }
+  });
+  BENCH("  str_f64", lines, {
+    Str s = floats;
+    for (Str field; str_try_chop_by_delim(&s, '\n', &field);) {
+      bench_sink += (u64)str_f64(field);
+    }
+  });
+  DA(f64) prices = da_new(&arena);
+  BENCH("  str_parse_f64_da", lines, {
+    da_clear(&prices);
+    str_parse_f64_da(floats, '\n', &prices, ErrPanic);
+    bench_sink += da_len(&prices);
+  });
+
+  arena_free(&arena);
+}
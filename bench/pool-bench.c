@@ -0,0 +1,93 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/collection/hashmap.h"
+#include "cebus/collection/str_pool.h"
+#include "cebus/core/arena.h"
+#include "cebus/type/string.h"
+
+#include <stdio.h>
+
+#define WORDS 1000000
+#define UNIQUE 20000
+
+int main(void) {
+  Arena arena = {0};
+
+  // identifiers with a zipf like distribution, like the tokens of source code
+  Str *words = arena_alloc(&arena, WORDS * sizeof(Str));
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < WORDS; i++) {
+    const u64 r = bench_random(&seed);
+    const u64 n = (r % UNIQUE) * ((r >> 32) % UNIQUE) / UNIQUE;
+    char buffer[32];
+    const int len = snprintf(buffer, sizeof(buffer), "identifier_%" U64_FMT, n);
+    words[i] = str_copy(str_from_parts((usize)len, buffer), &arena);
+  }
+  cebus_log_info("%d words, %d unique at most", WORDS, UNIQUE);
+
+  cebus_log_info("count every word");
+  BENCH("  str_hash + HashMap + DA", WORDS, {
+    Arena scratch = {0};
+    HashMap *idx = hm_create(&scratch);
+    DA(u32) counts = da_new(&scratch);
+    for (usize i = 0; i < WORDS; i++) {
+      const u64 hash = str_hash(words[i]);
+      const usize *j = hm_get_usize(idx, hash);
+      if (j == NULL) {
+        hm_insert_usize(idx, hash, counts.len);
+        da_push(&counts, 1);
+      } else {
+        counts.items[*j]++;
+      }
+    }
+    bench_sink += counts.len;
+    arena_free(&scratch);
+  });
+  BENCH("  str_pool_intern", WORDS, {
+    Arena scratch = {0};
+    StrPool *pool = str_pool_create(&scratch);
+    DA(u32) counts = da_new(&scratch);
+    for (usize i = 0; i < WORDS; i++) {
+      const u32 id = str_pool_intern(pool, words[i]);
+      if (id == counts.len) {
+        da_push(&counts, 0);
+      }
+      counts.items[id]++;
+    }
+    bench_sink += counts.len;
+    arena_free(&scratch);
+  });
+
+  u32 *ids = arena_alloc(&arena, WORDS * sizeof(u32));
+  StrPool *pool = str_pool_create(&arena);
+  BENCH("  str_pool_intern_batch", WORDS, {
+    Arena scratch = {0};
+    StrPool *batch = str_pool_create(&scratch);
+    str_pool_intern_batch(batch, WORDS, words, ids);
+    bench_sink += str_pool_len(batch);
+    arena_free(&scratch);
+  });
+  StrPool *shared = str_pool_create_shared(&arena);
+  BENCH("  str_pool_intern shared", WORDS, {
+    for (usize i = 0; i < WORDS; i++) {
+      bench_sink += str_pool_intern(shared, words[i]);
+    }
+  });
+  str_pool_destroy(shared);
+
+  str_pool_intern_batch(pool, WORDS, words, ids);
+  cebus_log_info("compare neighbours");
+  BENCH("  str_eq", WORDS - 1, {
+    for (usize i = 0; i + 1 < WORDS; i++) {
+      bench_sink += str_eq(words[i], words[i + 1]);
+    }
+  });
+  BENCH("  id ==", WORDS - 1, {
+    for (usize i = 0; i + 1 < WORDS; i++) {
+      bench_sink += ids[i] == ids[i + 1];
+    }
+  });
+
+  arena_free(&arena);
+}
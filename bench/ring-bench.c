@@ -0,0 +1,66 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/collection/ring_buffer.h"
+
+// A FIFO queue, that always holds 'size' elements.
+static void bench_queue(usize size) {
+  Arena arena = {0};
+  const usize ops = 100000;
+  cebus_log_info("queue with %" USIZE_FMT " elements", size);
+
+  DA(u64) list = da_new(&arena);
+  for (usize i = 0; i < size; i++) {
+    da_push(&list, i);
+  }
+  BENCH("  da_push + da_remove(0)", ops, {
+    for (usize i = 0; i < ops; i++) {
+      da_push(&list, i);
+      bench_sink += da_get(&list, 0);
+      da_remove(&list, 0);
+    }
+  });
+  BENCH("  da_insert(0) + da_pop", ops, {
+    for (usize i = 0; i < ops; i++) {
+      da_insert(&list, i, 0);
+      bench_sink += da_pop(&list);
+    }
+  });
+
+  RingBuffer(u64) rb = rb_new(&arena);
+  for (usize i = 0; i < size; i++) {
+    rb_push_back(&rb, i);
+  }
+  BENCH("  rb_push_back + rb_pop_front", ops, {
+    for (usize i = 0; i < ops; i++) {
+      rb_push_back(&rb, i);
+      bench_sink += rb_pop_front(&rb);
+    }
+  });
+  BENCH("  rb_push_front + rb_pop_back", ops, {
+    for (usize i = 0; i < ops; i++) {
+      rb_push_front(&rb, i);
+      bench_sink += rb_pop_back(&rb);
+    }
+  });
+
+  u64 block[64];
+  for (usize i = 0; i < ARRAY_LEN(block); i++) {
+    block[i] = i;
+  }
+  BENCH("  rb_push_back_n + rb_pop_front_n (64)", ops, {
+    for (usize i = 0; i < ops; i += ARRAY_LEN(block)) {
+      rb_push_back_n(&rb, ARRAY_LEN(block), block);
+      rb_pop_front_n(&rb, ARRAY_LEN(block), block);
+    }
+  });
+  bench_sink += block[0];
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_queue(100);
+  bench_queue(1000);
+  bench_queue(10000);
+}
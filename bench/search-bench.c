@@ -0,0 +1,59 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/collection/eytzinger.h"
+#include "cebus/collection/set.h"
+
+static void bench_lookups(usize n) {
+  Arena arena = {0};
+  DA(u64) keys = da_new(&arena);
+  u64 seed = 0x9E3779B97F4A7C15;
+  for (usize i = 0; i < n; i++) {
+    da_push(&keys, bench_random(&seed));
+  }
+  // half of the lookups are members
+  const usize count = 1000000;
+  u64 *lookups = arena_alloc(&arena, count * sizeof(u64));
+  for (usize i = 0; i < count; i++) {
+    lookups[i] = i % 2 ? da_get(&keys, bench_random(&seed) % n) : bench_random(&seed);
+  }
+  cebus_log_info("%" USIZE_FMT " keys", n);
+
+  Set set = set_create(&arena);
+  set_extend(&set, n, keys.items);
+  Eytzinger ez = eytzinger_create(&arena, n, keys.items);
+  DA(u64) sorted = da_new(&arena);
+  da_copy(&keys, &sorted);
+  da_sort_by(&sorted, u64, *a < *b);
+
+  BENCH("  set_contains", count, {
+    for (usize i = 0; i < count; i++) {
+      bench_sink += set_contains(&set, lookups[i]);
+    }
+  });
+  BENCH("  da_bsearch", count, {
+    for (usize i = 0; i < count; i++) {
+      usize idx;
+      da_bsearch(&sorted, u64, lookups[i], idx, *a < *b);
+      bench_sink += idx != DA_NOT_FOUND;
+    }
+  });
+  BENCH("  eytzinger_contains", count, {
+    for (usize i = 0; i < count; i++) {
+      bench_sink += eytzinger_contains(&ez, lookups[i]);
+    }
+  });
+  BENCH("  eytzinger_contains_batch", count,
+        bench_sink += eytzinger_contains_batch(&ez, count, lookups, NULL));
+
+  cebus_log_info("  memory: set %" USIZE_FMT " KiB, sorted array and eytzinger %" USIZE_FMT " KiB",
+                 set.cap * sizeof(u64) / 1024, n * sizeof(u64) / 1024);
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_lookups(10000);
+  bench_lookups(1000000);
+  bench_lookups(10000000);
+}
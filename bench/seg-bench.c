@@ -0,0 +1,82 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/collection/seg_array.h"
+#include "cebus/type/float.h"
+
+#define BENCH_BATCH 4096
+
+typedef DA(u64) U64Array;
+typedef SEG(u64) U64Segments;
+
+static void bench_size(usize n) {
+  Arena arena = {0};
+  U64Array array = da_new(&arena);
+  U64Segments segments = seg_new(&arena);
+  cebus_log_info("%" USIZE_FMT " elements", n);
+
+  // the slowest batch of pushes shows the cost of copying on growth
+  f64 worst_da = 0;
+  BENCH("  da_push", n, {
+    for (usize i = 0; i < n; i += BENCH_BATCH) {
+      const f64 start = bench_now();
+      for (usize j = i; j < n && j < i + BENCH_BATCH; j++) {
+        da_push(&array, j);
+      }
+      worst_da = f64_max(worst_da, bench_now() - start);
+    }
+  });
+  f64 worst_seg = 0;
+  BENCH("  seg_push", n, {
+    for (usize i = 0; i < n; i += BENCH_BATCH) {
+      const f64 start = bench_now();
+      for (usize j = i; j < n && j < i + BENCH_BATCH; j++) {
+        seg_push(&segments, j);
+      }
+      worst_seg = f64_max(worst_seg, bench_now() - start);
+    }
+  });
+  cebus_log_info("  slowest batch of %d pushes: da %.3f ms, seg %.3f ms", BENCH_BATCH,
+                 worst_da * 1e3, worst_seg * 1e3);
+
+  BENCH("  sum (da_for_each)", n, {
+    u64 sum = 0;
+    da_for_each(u64 *, v, &array) { sum += *v; }
+    bench_sink += sum;
+  });
+  BENCH("  sum (seg_for_each)", n, {
+    u64 sum = 0;
+    seg_for_each(u64 *, v, &segments) { sum += *v; }
+    bench_sink += sum;
+  });
+  BENCH("  sum (seg_get)", n, {
+    u64 sum = 0;
+    for (usize i = 0; i < seg_len(&segments); i++) {
+      sum += seg_get(&segments, i);
+    }
+    bench_sink += sum;
+  });
+
+  const usize lookups = 1000000;
+  u64 seed = 0x9E3779B97F4A7C15;
+  BENCH("  random da_get", lookups, {
+    for (usize i = 0; i < lookups; i++) {
+      const usize idx = bench_random(&seed) % n;
+      bench_sink += da_get(&array, idx);
+    }
+  });
+  BENCH("  random seg_get", lookups, {
+    for (usize i = 0; i < lookups; i++) {
+      const usize idx = bench_random(&seed) % n;
+      bench_sink += seg_get(&segments, idx);
+    }
+  });
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_size(100000);
+  bench_size(10000000);
+  bench_size(50000000);
+}
@@ -0,0 +1,69 @@
+#include "bench.h"
+
+#include "cebus/collection/set.h"
+#include "cebus/type/integer.h"
+
+// the old way: iterate one table and probe the other one
+static usize probe_intersection(const Set *set, const Set *other) {
+  usize count = 0;
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set_contains(other, set->items[i])) {
+      count++;
+    }
+  }
+  return count;
+}
+
+static void bench_sizes(usize n1, usize n2) {
+  Arena arena = {0};
+  u64 seed = 0x2545F4914F6CDD1D;
+
+  Set s1 = set_create(&arena);
+  Set s2 = set_create(&arena);
+  for (usize i = 0; i < n1; i++) {
+    set_add(&s1, bench_random(&seed));
+  }
+  // half of the smaller set is shared
+  for (usize i = 0; i < n2; i++) {
+    set_add(&s2, i % 2 && i < n1 ? s1.items[i] : bench_random(&seed));
+  }
+
+  cebus_log_info("sets with %" USIZE_FMT " and %" USIZE_FMT " members", s1.count, s2.count);
+  const usize ops = s1.count + s2.count;
+
+  BENCH("  probing intersection (count only)", ops,
+        bench_sink += probe_intersection(&s2, &s1));
+  BENCH("  set_intersection", ops, {
+    Arena temp = {0};
+    bench_sink += set_intersection(&s1, &s2, &temp).count;
+    arena_free(&temp);
+  });
+  BENCH("  set_difference", ops, {
+    Arena temp = {0};
+    bench_sink += set_difference(&s1, &s2, &temp).count;
+    arena_free(&temp);
+  });
+  BENCH("  set_union", ops, {
+    Arena temp = {0};
+    bench_sink += set_union(&s1, &s2, &temp).count;
+    arena_free(&temp);
+  });
+  BENCH("  set_subset", ops, bench_sink += set_subset(&s2, &s1));
+  BENCH("  set_disjoint", ops, bench_sink += set_disjoint(&s1, &s2));
+  BENCH("  set_sorted", ops, {
+    Arena temp = {0};
+    bench_sink += set_sorted(&s1, &temp)[0];
+    arena_free(&temp);
+  });
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_sizes(1000, 1000);
+  bench_sizes(100000, 100000);
+  bench_sizes(1000000, 1000000);
+  bench_sizes(10000000, 10000000);
+  bench_sizes(10000000, 100000);
+  bench_sizes(8200000, 8200000);
+}
@@ -0,0 +1,103 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/collection/soa.h"
+#include "cebus/type/string.h"
+
+typedef struct {
+  Str word;
+  usize count;
+} WordCount;
+
+#define WORD_COUNT_FIELDS(X) X(Str, word) X(usize, count)
+SOA_DEFINE(WordCounts, WORD_COUNT_FIELDS)
+
+typedef struct {
+  f32 x, y, z;
+  f32 vx, vy, vz;
+  u32 id;
+  u32 flags;
+} Particle;
+
+#define PARTICLE_FIELDS(X)                                                                         \
+  X(f32, x) X(f32, y) X(f32, z) X(f32, vx) X(f32, vy) X(f32, vz) X(u32, id) X(u32, flags)
+SOA_DEFINE(Particles, PARTICLE_FIELDS)
+
+static void bench_word_counts(usize n) {
+  Arena arena = {0};
+  DA(WordCount) aos = da_new(&arena);
+  WordCounts soa = soa_new(&arena);
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < n; i++) {
+    const usize count = bench_random(&seed) % 100;
+    da_push(&aos, ((WordCount){.word = STR("word"), .count = count}));
+    WordCounts_push(&soa, (WordCountsRow){.word = STR("word"), .count = count});
+  }
+  cebus_log_info("%" USIZE_FMT " word counts", n);
+
+  BENCH("  sum count (DA(WordCount))", n, {
+    usize total = 0;
+    for (usize i = 0; i < da_len(&aos); i++) {
+      total += da_get(&aos, i).count;
+    }
+    bench_sink += total;
+  });
+  BENCH("  sum count (SOA column)", n, {
+    usize total = 0;
+    for (usize i = 0; i < soa_len(&soa); i++) {
+      total += soa.count[i];
+    }
+    bench_sink += total;
+  });
+  BENCH("  count > 90 (DA(WordCount))", n, {
+    usize found = 0;
+    for (usize i = 0; i < da_len(&aos); i++) {
+      found += da_get(&aos, i).count > 90;
+    }
+    bench_sink += found;
+  });
+  BENCH("  count > 90 (SOA column)", n, {
+    usize found = 0;
+    for (usize i = 0; i < soa_len(&soa); i++) {
+      found += soa.count[i] > 90;
+    }
+    bench_sink += found;
+  });
+
+  arena_free(&arena);
+}
+
+static void bench_particles(usize n) {
+  Arena arena = {0};
+  DA(Particle) aos = da_new(&arena);
+  Particles soa = soa_new(&arena);
+  for (usize i = 0; i < n; i++) {
+    const Particle p = {.x = (f32)i, .vx = 1, .id = (u32)i};
+    da_push(&aos, p);
+    Particles_push(&soa, (ParticlesRow){.x = p.x, .vx = p.vx, .id = p.id});
+  }
+  cebus_log_info("%" USIZE_FMT " particles", n);
+
+  BENCH("  x += vx (DA(Particle))", n, {
+    for (usize i = 0; i < da_len(&aos); i++) {
+      da_get(&aos, i).x += da_get(&aos, i).vx;
+    }
+  });
+  BENCH("  x += vx (SOA columns)", n, {
+    f32 *restrict x = soa.x;
+    const f32 *restrict vx = soa.vx;
+    for (usize i = 0; i < soa_len(&soa); i++) {
+      x[i] += vx[i];
+    }
+  });
+  bench_sink += (u64)da_get(&aos, n - 1).x + (u64)soa.x[n - 1];
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_word_counts(100000);
+  bench_word_counts(10000000);
+  bench_particles(100000);
+  bench_particles(10000000);
+}
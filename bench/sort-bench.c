@@ -0,0 +1,73 @@
+#include "bench.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/type/integer.h"
+
+typedef struct {
+  u64 key;
+  u64 value;
+} Record;
+
+#define RECORD_KEY(r) ((r).key)
+#define U64_KEY(v) (v)
+
+static int compare_record(const void *a, const void *b) {
+  const Record *r1 = a;
+  const Record *r2 = b;
+  return r1->key < r2->key ? -1 : r1->key > r2->key;
+}
+
+static void bench_u64(usize n) {
+  Arena arena = {0};
+  DA(u64) input = da_new(&arena);
+  DA(u64) list = da_new(&arena);
+  u64 seed = 0x2545F4914F6CDD1D;
+  for (usize i = 0; i < n; i++) {
+    da_push(&input, bench_random(&seed));
+  }
+  cebus_log_info("%" USIZE_FMT " u64", n);
+
+  da_copy(&input, &list);
+  BENCH("  da_sort (qsort)", n, da_sort(&list, usize_compare_qsort(CMP_LESS)));
+  da_copy(&input, &list);
+  BENCH("  da_sort_by", n, da_sort_by(&list, u64, *a < *b));
+  da_copy(&input, &list);
+  BENCH("  da_sort_stable_by", n, da_sort_stable_by(&list, u64, *a < *b));
+  da_copy(&input, &list);
+  BENCH("  da_radix_sort_u64", n, da_radix_sort_u64(&list, U64_KEY));
+  BENCH("  da_sort_by (already sorted)", n, da_sort_by(&list, u64, *a < *b));
+  bench_sink += list.items[n / 2];
+
+  arena_free(&arena);
+}
+
+static void bench_records(usize n) {
+  Arena arena = {0};
+  DA(Record) input = da_new(&arena);
+  DA(Record) list = da_new(&arena);
+  u64 seed = 0x9E3779B97F4A7C15;
+  for (usize i = 0; i < n; i++) {
+    da_push(&input, (Record){.key = bench_random(&seed), .value = i});
+  }
+  cebus_log_info("%" USIZE_FMT " records of 16 bytes", n);
+
+  da_copy(&input, &list);
+  BENCH("  da_sort (qsort)", n, da_sort(&list, compare_record));
+  da_copy(&input, &list);
+  BENCH("  da_sort_by", n, da_sort_by(&list, Record, a->key < b->key));
+  da_copy(&input, &list);
+  BENCH("  da_sort_stable_by", n, da_sort_stable_by(&list, Record, a->key < b->key));
+  da_copy(&input, &list);
+  BENCH("  da_radix_sort_u64", n, da_radix_sort_u64(&list, RECORD_KEY));
+  bench_sink += list.items[n / 2].value;
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  bench_u64(1000);
+  bench_u64(1000000);
+  bench_u64(10000000);
+  bench_records(1000000);
+  bench_records(10000000);
+}
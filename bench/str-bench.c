@@ -0,0 +1,129 @@
+#include "bench.h"
+
+#include "cebus/collection/string_builder.h"
+#include "cebus/core/arena.h"
+#include "cebus/os/io.h"
+#include "cebus/type/string.h"
+
+#include <stdio.h>
+#include <string.h>
+
+// The loops that 'str_find' and 'str_count' used before, for comparison.
+static usize naive_find(Str haystack, Str needle) {
+  for (usize i = 0; i + needle.len <= haystack.len; i++) {
+    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static usize naive_count(Str haystack, Str needle) {
+  usize count = 0;
+  for (usize i = 0; i + needle.len <= haystack.len; i++) {
+    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
+      count++;
+      i += needle.len - 1;
+    }
+  }
+  return count;
+}
+
+// Something that looks like a server log.
+static Str bench_log(Arena *arena, usize lines) {
+  static const char *levels[] = {"INFO", "INFO", "INFO", "DEBUG", "WARN", "ERROR"};
+  static const char *paths[] = {"/api/users", "/api/orders", "/static/app.js", "/health"};
+  char *buffer = arena_alloc(arena, lines * 128);
+  usize len = 0;
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < lines; i++) {
+    const u64 r = bench_random(&seed);
+    len += (usize)sprintf(&buffer[len],
+                          "2024-05-%02d 12:%02d:%02d %-5s request id=%08x path=%s status=%d\n",
+                          (int)(r % 28 + 1), (int)(r >> 8 & 63) % 60, (int)(r >> 16 & 63) % 60,
+                          levels[(r >> 24) % 6], (unsigned)(r >> 32), paths[(r >> 28) % 4],
+                          (r >> 40) % 10 ? 200 : 500);
+  }
+  return str_from_parts(len, buffer);
+}
+
+static void bench_count(Str text, const char *label, Str needle) {
+  cebus_log_info("count %s: \"" STR_FMT "\"", label, STR_ARG(needle));
+  BENCH("  memcmp loop", text.len, { bench_sink += naive_count(text, needle); });
+  BENCH("  str_count", text.len, { bench_sink += str_count(text, needle); });
+}
+
+static void bench_find(Str text, const char *label, Str needle) {
+  cebus_log_info("find %s: %" USIZE_FMT " bytes", label, needle.len);
+  BENCH("  memcmp loop", text.len, { bench_sink += naive_find(text, needle); });
+  BENCH("  str_find", text.len, { bench_sink += str_find(text, needle); });
+}
+
+static void bench_find_ignorecase(Str text, Str needle) {
+  cebus_log_info("find ignoring case: \"" STR_FMT "\"", STR_ARG(needle));
+  BENCH("  str_lower + str_find", text.len, {
+    Arena scratch = {0};
+    bench_sink += str_find(str_lower(text, &scratch), str_lower(needle, &scratch));
+    arena_free(&scratch);
+  });
+  BENCH("  str_find_ignorecase", text.len, {
+    bench_sink += str_find_ignorecase(text, needle);
+  });
+}
+
+int main(void) {
+  Arena arena = {0};
+  const Str text = bench_log(&arena, 100000);
+  cebus_log_info("%" USIZE_FMT " bytes of log", text.len);
+
+  bench_count(text, "single byte", STR("\n"));
+  bench_count(text, "short", STR("ERROR"));
+  bench_count(text, "medium", STR("path=/api/orders status=500"));
+  bench_count(text, "missing", STR("FATAL"));
+  bench_find(text, "last two lines", str_substring(text, text.len - 150, text.len));
+  bench_find(text, "missing line", STR("2024-05-01 12:00:00 FATAL request id=00000000 path=/"));
+  bench_find_ignorecase(text, STR("fatal"));
+
+  // a small alphabet has a lot more partial matches
+  char *dna = arena_alloc(&arena, text.len);
+  u64 seed = 0x853c49e6748fea9b;
+  for (usize i = 0; i < text.len; i++) {
+    dna[i] = "ACGT"[bench_random(&seed) % 4];
+  }
+  const Str genome = str_from_parts(text.len, dna);
+  bench_find(genome, "dna", str_substring(genome, genome.len - 64, genome.len));
+  bench_find(genome, "dna", str_substring(genome, genome.len - 16, genome.len));
+
+  cebus_log_info("replace");
+  BENCH("  str_replace(\"status=500\", \"status=error\")", text.len, {
+    Arena scratch = {0};
+    bench_sink += str_replace(text, STR("status=500"), STR("status=error"), &scratch).len;
+    arena_free(&scratch);
+  });
+  BENCH("  sb_append_replace", text.len, {
+    Arena scratch = {0};
+    StringBuilder sb = sb_init(&scratch);
+    sb_append_replace(&sb, text, STR("status=500"), STR("status=error"));
+    bench_sink += sb.len;
+    arena_free(&scratch);
+  });
+  BENCH("  sb_append_replace_ignorecase", text.len, {
+    Arena scratch = {0};
+    StringBuilder sb = sb_init(&scratch);
+    sb_append_replace_ignorecase(&sb, text, STR("STATUS=500"), STR("status=error"));
+    bench_sink += sb.len;
+    arena_free(&scratch);
+  });
+  FILE *null = fopen("/dev/null", "wb");
+  if (null) {
+    BENCH("  io_write_replace", text.len, {
+      io_write_replace(null, text, STR("status=500"), STR("status=error"), ErrPanic);
+    });
+    fclose(null);
+  }
+  BENCH("  str_find_last(\"ERROR\")", text.len, {
+    bench_sink += str_find_last(text, STR("ERROR"));
+  });
+
+  arena_free(&arena);
+}
@@ -43,6 +43,8 @@ ARM.
 MSVC.
 - **CPU Bitness**: Distinguishes between 32-bit and 64-bit environments.
 - **Byte Order**: Defines the system's byte order (endianness).
+- **SIMD**: Defines `CEBUS_SIMD_X86` if x86 vector intrinsics can be used and
+`CEBUS_TARGET_AVX2` to compile single functions for AVX2.
 */
 
 #ifndef __CEBUS_PLATFORM_H__
@@ -196,6 +198,17 @@ MSVC.
 #endif
 /* !Byte-Order */
 
+////////////////////////////////////////////////////////////////////////////
+/* SIMD */
+#if defined(x86_64) && (defined(GCC) || defined(CLANG))
+#define CEBUS_SIMD_X86
+#define CEBUS_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(x86_64) && defined(MSVC)
+#define CEBUS_SIMD_X86
+#define CEBUS_TARGET_AVX2
+#endif
+/* !SIMD */
+
 ////////////////////////////////////////////////////////////////////////////
 
 #ifdef __cross__
@@ -701,6 +714,24 @@ Arena arena = {0};
 DA(int) vec = da_new(&arena);
 ```
 
+## Small Dynamic Arrays
+
+`SDA(T, N)` stores up to `N` elements inside of the struct and only allocates
+in the arena once it grows past that. Use it for arrays that are small most of
+the time. All `da_*` operations work on it.
+
+```c
+SDA(Str, 8) args = sda_new(&args, &arena);
+da_push(&args, STR("gcc"));
+```
+
+- `sda_new`: Initializer, that needs the address of the array itself.
+- `sda_init`: Initialize the small dynamic array.
+- `sda_is_inline`: Check if the elements are still stored inside of the struct.
+
+> :warning: While the elements are inline, `items` points into the struct
+itself. Do not copy or move the struct, pass a pointer to it instead.
+
 ## Adding Elements
 
 Elements can be added to the dynamic array using `da_push`, which automatically
@@ -740,7 +771,21 @@ int popped = da_pop(&vec);
 > :warning: These operations do not perform any bound checks.
 
 - `da_insert`: Insert a value at a specified index.
+- `da_insert_n`: Insert `count` values from an array at a specified index. The
+array must not point into the dynamic array itself.
 - `da_remove`: Remove a value at a specified index.
+- `da_remove_range`: Remove `count` values starting at a specified index.
+- `da_swap_remove`: Remove a value by replacing it with the last one. Does not
+keep the order, but does not need to move the other elements.
+- `da_retain`: Keep only the elements for which the predicate returns `true`.
+Compacts the array in place in one pass.
+- `da_retain_ctx`: Same but the predicate also takes a context.
+
+```c
+da_insert_n(&vec, 3, ((int[]){1, 2, 3}), 0);
+da_remove_range(&vec, 0, 2);
+da_retain(&vec, is_even);
+```
 
 ## Resizing and Reserving Space
 
@@ -761,6 +806,50 @@ destination.
 `void*` as a context, and place it into a destination.
 - `da_sort`: Sort the array using a comparison function.
 - `da_reverse`: Reverse the order of elements in the array.
+
+## Sorting
+
+`da_sort` calls the comparison function through a pointer for every
+comparison. The following macros inline the comparison instead, which is a lot
+faster for big arrays.
+
+- `da_sort_by(list, T, less)`: Sorts the array with introsort. `less` is an
+expression that compares the items `const T *a` and `const T *b`.
+- `da_sort_stable_by(list, T, less)`: Same but keeps the order of equal items.
+Needs a temporary buffer of the size of the array.
+- `da_radix_sort_u64(list, key)`: Stable radix sort by a `u64` key. `key` is a
+function or macro that takes an item and returns its key. Signed or floating
+point keys have to be mapped to an unsigned key that keeps the order.
+
+```c
+da_sort_by(&vec, int, *a < *b);
+da_sort_stable_by(&people, Person, a->age < b->age);
+#define PERSON_ID(p) ((p).id)
+da_radix_sort_u64(&people, PERSON_ID);
+```
+## Sorted Arrays
+
+These macros work on arrays sorted by the same `less` expression as
+`da_sort_by`. The key is a value of type `T` and the result is written into
+the `usize` variable `idx`.
+
+- `da_lower_bound(list, T, key, idx, less)`: Index of the first item that is
+not less than `key`, or the length.
+- `da_upper_bound(list, T, key, idx, less)`: Index of the first item that is
+greater than `key`, or the length.
+- `da_bsearch(list, T, key, idx, less)`: Index of an item equal to `key`, or
+`DA_NOT_FOUND`.
+- `da_unique(list, T, less)`: Removes all but the first of equal items.
+- `da_merge_sorted(first, second, dest, T, less)`: Appends the items of both
+arrays to `dest` in sorted order. `dest` must not be one of them.
+
+```c
+usize idx;
+da_bsearch(&vec, int, 42, idx, *a < *b);
+if (idx != DA_NOT_FOUND) {
+  // found
+}
+```
 */
 
 #ifndef __CEBUS_DA_H__
@@ -769,7 +858,9 @@ destination.
 // #include "cebus/core/arena.h"   // IWYU pragma: export
 // #include "cebus/core/defines.h" // IWYU pragma: export
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -792,6 +883,8 @@ destination.
 
 #define DA_ARG(da) (da)->len, (da)->items
 
+#define DA_NOT_FOUND ((usize)-1)
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define da_new(_arena)                                                                             \
@@ -823,6 +916,35 @@ destination.
     da_init_list(list, _arena, ARRAY_LEN((__VA_ARGS__)), (__VA_ARGS__));                           \
   } while (0)
 
+// Small dynamic array, that stores up to N items inside of the struct. The
+// items only move into the arena once it grows past that.
+#define SDA(T, N)                                                                                  \
+  struct {                                                                                         \
+    usize cap;                                                                                     \
+    usize len;                                                                                     \
+    Arena *arena;                                                                                  \
+    T *items;                                                                                      \
+    T inline_items[N];                                                                             \
+  }
+
+#define sda_new(list, _arena)                                                                      \
+  {                                                                                                \
+    .cap = ARRAY_LEN((list)->inline_items), .arena = (_arena), .items = (list)->inline_items,      \
+  }
+
+#define sda_init(list, _arena)                                                                     \
+  do {                                                                                             \
+    (list)->len = 0;                                                                               \
+    (list)->cap = ARRAY_LEN((list)->inline_items);                                                 \
+    (list)->arena = _arena;                                                                        \
+    (list)->items = (list)->inline_items;                                                          \
+  } while (0)
+
+// Checks if the items point into the struct itself. Always false for 'DA'.
+#define sda_is_inline(list)                                                                        \
+  ((list)->items != NULL &&                                                                        \
+   (uintptr_t)(const void *)(list)->items - (uintptr_t)(const void *)(list) < sizeof(*(list)))
+
 #define da_copy(src, dest)                                                                         \
   do {                                                                                             \
     da_resize((dest), (src)->len);                                                                 \
@@ -836,7 +958,14 @@ destination.
 
 #define da_resize(list, size)                                                                      \
   do {                                                                                             \
-    if (size < (list)->cap) {                                                                      \
+    if ((size) <= (list)->cap) {                                                                   \
+      break;                                                                                       \
+    }                                                                                              \
+    if (sda_is_inline(list)) {                                                                     \
+      void *const __rz_items = arena_alloc_chunk((list)->arena, (size) * sizeof(*(list)->items));  \
+      memcpy(__rz_items, (list)->items, (list)->len * sizeof(*(list)->items));                     \
+      (list)->items = __rz_items;                                                                  \
+      (list)->cap = (size);                                                                        \
       break;                                                                                       \
     }                                                                                              \
     (list)->cap = size;                                                                            \
@@ -847,7 +976,7 @@ destination.
 #define da_reserve(list, size)                                                                     \
   do {                                                                                             \
     const usize __rs = da_len(list) + size;                                                        \
-    if (__rs < (list)->cap) {                                                                      \
+    if (__rs <= (list)->cap) {                                                                     \
       break;                                                                                       \
     }                                                                                              \
     usize __ns = (list)->cap == 0 ? 5 : (list)->cap;                                               \
@@ -885,22 +1014,82 @@ destination.
 
 #define da_insert(list, value, idx)                                                                \
   do {                                                                                             \
+    const usize __in_idx = (idx);                                                                  \
     da_reserve(list, 1);                                                                           \
-    for (usize __r_i = idx + 1; __r_i < da_len(list) + 1; __r_i++) {                               \
-      da_get(list, __r_i) = da_get(list, __r_i - 1);                                               \
-    }                                                                                              \
-    da_get(list, idx) = value;                                                                     \
+    memmove(&da_get(list, __in_idx + 1), &da_get(list, __in_idx),                                  \
+            (da_len(list) - __in_idx) * sizeof((list)->items[0]));                                 \
+    da_get(list, __in_idx) = value;                                                                \
     da_len(list)++;                                                                                \
   } while (0)
 
+#define da_insert_n(list, count, array, idx)                                                       \
+  do {                                                                                             \
+    const usize __in_idx = (idx);                                                                  \
+    const usize __in_count = (count);                                                              \
+    da_reserve(list, __in_count);                                                                  \
+    memmove(&da_get(list, __in_idx + __in_count), &da_get(list, __in_idx),                         \
+            (da_len(list) - __in_idx) * sizeof((list)->items[0]));                                 \
+    memcpy(&da_get(list, __in_idx), (array), __in_count * sizeof((list)->items[0]));               \
+    da_len(list) += __in_count;                                                                    \
+  } while (0)
+
 #define da_remove(list, idx)                                                                       \
   do {                                                                                             \
-    for (usize __r_i = idx + 1; __r_i < da_len(list); __r_i++) {                                   \
-      da_get(list, __r_i - 1) = da_get(list, __r_i);                                               \
-    }                                                                                              \
+    const usize __r_idx = (idx);                                                                   \
+    memmove(&da_get(list, __r_idx), &da_get(list, __r_idx + 1),                                    \
+            (da_len(list) - __r_idx - 1) * sizeof((list)->items[0]));                              \
     da_len(list)--;                                                                                \
   } while (0)
 
+#define da_remove_range(list, idx, count)                                                          \
+  do {                                                                                             \
+    const usize __r_idx = (idx);                                                                   \
+    const usize __r_count = (count);                                                               \
+    memmove(&da_get(list, __r_idx), &da_get(list, __r_idx + __r_count),                            \
+            (da_len(list) - __r_idx - __r_count) * sizeof((list)->items[0]));                      \
+    da_len(list) -= __r_count;                                                                     \
+  } while (0)
+
+#define da_swap_remove(list, idx)                                                                  \
+  do {                                                                                             \
+    const usize __r_idx = (idx);                                                                   \
+    da_get(list, __r_idx) = da_get(list, da_len(list) - 1);                                        \
+    da_len(list)--;                                                                                \
+  } while (0)
+
+// Moves every run of kept elements with one memmove, short runs are copied
+// directly. The run is moved when the first element after it is removed, or
+// after the last element.
+#define _da_retain(list, keep)                                                                     \
+  do {                                                                                             \
+    usize __rt_w = 0;                                                                              \
+    usize __rt_start = 0;                                                                          \
+    const usize __rt_n = da_len(list);                                                             \
+    for (usize __rt_r = 0; __rt_r <= __rt_n; __rt_r++) {                                           \
+      if (__rt_r < __rt_n && (keep)) {                                                             \
+        continue;                                                                                  \
+      }                                                                                            \
+      if (__rt_w == __rt_start) {                                                                  \
+        __rt_w = __rt_r;                                                                           \
+      } else if (__rt_r - __rt_start < 8) {                                                        \
+        for (usize __rt_i = __rt_start; __rt_i < __rt_r; __rt_i++) {                               \
+          da_get(list, __rt_w++) = da_get(list, __rt_i);                                           \
+        }                                                                                          \
+      } else {                                                                                     \
+        memmove(&da_get(list, __rt_w), &da_get(list, __rt_start),                                  \
+                (__rt_r - __rt_start) * sizeof((list)->items[0]));                                 \
+        __rt_w += __rt_r - __rt_start;                                                             \
+      }                                                                                            \
+      __rt_start = __rt_r + 1;                                                                     \
+    }                                                                                              \
+    da_len(list) = __rt_w;                                                                         \
+  } while (0)
+
+#define da_retain(list, predicate) _da_retain(list, predicate(da_get(list, __rt_r)))
+
+#define da_retain_ctx(list, predicate, ctx)                                                        \
+  _da_retain(list, predicate((ctx), da_get(list, __rt_r)))
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define da_map(src, dest, map)                                                                     \
@@ -947,6 +1136,322 @@ destination.
 
 #define da_sort(src, sort) qsort(&da_get(src, 0), da_len(src), sizeof((src)->items[0]), sort)
 
+// Evaluates the comparison expression with 'a' and 'b' pointing to the items.
+#define _da_less(T, result, x, y, ...)                                                             \
+  do {                                                                                             \
+    const T *a = (x);                                                                              \
+    const T *b = (y);                                                                              \
+    (void)a;                                                                                       \
+    (void)b;                                                                                       \
+    (result) = (__VA_ARGS__);                                                                      \
+  } while (0)
+
+#define _da_swap(T, x, y)                                                                          \
+  do {                                                                                             \
+    T __sw_t = (x);                                                                                \
+    (x) = (y);                                                                                     \
+    (y) = __sw_t;                                                                                  \
+  } while (0)
+
+// Stable insertion sort of [lo, hi).
+#define _da_insertion_sort(T, items, lo, hi, ...)                                                  \
+  do {                                                                                             \
+    for (usize __is_i = (lo) + 1; __is_i < (hi); __is_i++) {                                       \
+      T __is_v = (items)[__is_i];                                                                  \
+      usize __is_j = __is_i;                                                                       \
+      for (; (lo) < __is_j; __is_j--) {                                                            \
+        bool __is_lt;                                                                              \
+        _da_less(T, __is_lt, &__is_v, &(items)[__is_j - 1], __VA_ARGS__);                          \
+        if (!__is_lt) {                                                                            \
+          break;                                                                                   \
+        }                                                                                          \
+        (items)[__is_j] = (items)[__is_j - 1];                                                     \
+      }                                                                                            \
+      (items)[__is_j] = __is_v;                                                                    \
+    }                                                                                              \
+  } while (0)
+
+// Heapsort of [lo, hi). The first 'n / 2' steps build the heap, the other 'n'
+// steps move the biggest item to the end.
+#define _da_heap_sort(T, items, lo, hi, ...)                                                       \
+  do {                                                                                             \
+    T *__hs_h = &(items)[lo];                                                                      \
+    const usize __hs_n = (hi) - (lo);                                                              \
+    for (usize __hs_s = __hs_n + __hs_n / 2; __hs_s-- > 0;) {                                      \
+      usize __hs_root = 0;                                                                         \
+      usize __hs_end = __hs_n;                                                                     \
+      if (__hs_s < __hs_n) {                                                                       \
+        _da_swap(T, __hs_h[0], __hs_h[__hs_s]);                                                    \
+        __hs_end = __hs_s;                                                                         \
+      } else {                                                                                     \
+        __hs_root = __hs_s - __hs_n;                                                               \
+      }                                                                                            \
+      for (usize __hs_c = __hs_root * 2 + 1; __hs_c < __hs_end; __hs_c = __hs_root * 2 + 1) {      \
+        bool __hs_lt;                                                                              \
+        if (__hs_c + 1 < __hs_end) {                                                               \
+          _da_less(T, __hs_lt, &__hs_h[__hs_c], &__hs_h[__hs_c + 1], __VA_ARGS__);                 \
+          __hs_c += __hs_lt;                                                                       \
+        }                                                                                          \
+        _da_less(T, __hs_lt, &__hs_h[__hs_root], &__hs_h[__hs_c], __VA_ARGS__);                    \
+        if (!__hs_lt) {                                                                            \
+          break;                                                                                   \
+        }                                                                                          \
+        _da_swap(T, __hs_h[__hs_root], __hs_h[__hs_c]);                                            \
+        __hs_root = __hs_c;                                                                        \
+      }                                                                                            \
+    }                                                                                              \
+  } while (0)
+
+#define DA_SORT_INSERTION_SIZE 16
+
+// Introsort: quicksort with a median of three pivot, that falls back to
+// heapsort if the partitions get too unbalanced. Partitions smaller than
+// 'DA_SORT_INSERTION_SIZE' are left alone and sorted by one insertion sort at
+// the end.
+#define da_sort_by(list, T, ...)                                                                   \
+  do {                                                                                             \
+    T *const __qs_items = (list)->items;                                                           \
+    usize __qs_stack[64 * 3];                                                                      \
+    usize __qs_top = 0;                                                                            \
+    usize __qs_depth = 0;                                                                          \
+    for (usize __qs_n = da_len(list); 1 < __qs_n; __qs_n >>= 1) {                                  \
+      __qs_depth += 2;                                                                             \
+    }                                                                                              \
+    __qs_stack[__qs_top++] = 0;                                                                    \
+    __qs_stack[__qs_top++] = da_len(list);                                                         \
+    __qs_stack[__qs_top++] = __qs_depth;                                                           \
+    while (__qs_top) {                                                                             \
+      usize __qs_d = __qs_stack[--__qs_top];                                                       \
+      usize __qs_hi = __qs_stack[--__qs_top];                                                      \
+      usize __qs_lo = __qs_stack[--__qs_top];                                                      \
+      while (DA_SORT_INSERTION_SIZE < __qs_hi - __qs_lo) {                                         \
+        if (__qs_d-- == 0) {                                                                       \
+          _da_heap_sort(T, __qs_items, __qs_lo, __qs_hi, __VA_ARGS__);                             \
+          break;                                                                                   \
+        }                                                                                          \
+        bool __qs_lt;                                                                              \
+        const usize __qs_mid = __qs_lo + (__qs_hi - __qs_lo) / 2;                                  \
+        _da_less(T, __qs_lt, &__qs_items[__qs_mid], &__qs_items[__qs_lo], __VA_ARGS__);            \
+        if (__qs_lt) {                                                                             \
+          _da_swap(T, __qs_items[__qs_mid], __qs_items[__qs_lo]);                                  \
+        }                                                                                          \
+        _da_less(T, __qs_lt, &__qs_items[__qs_hi - 1], &__qs_items[__qs_mid], __VA_ARGS__);        \
+        if (__qs_lt) {                                                                             \
+          _da_swap(T, __qs_items[__qs_hi - 1], __qs_items[__qs_mid]);                              \
+          _da_less(T, __qs_lt, &__qs_items[__qs_mid], &__qs_items[__qs_lo], __VA_ARGS__);          \
+          if (__qs_lt) {                                                                           \
+            _da_swap(T, __qs_items[__qs_mid], __qs_items[__qs_lo]);                                \
+          }                                                                                        \
+        }                                                                                          \
+        const T __qs_pivot = __qs_items[__qs_mid];                                                 \
+        usize __qs_i = __qs_lo;                                                                    \
+        usize __qs_j = __qs_hi - 1;                                                                \
+        while (true) {                                                                             \
+          do {                                                                                     \
+            __qs_i++;                                                                              \
+            _da_less(T, __qs_lt, &__qs_items[__qs_i], &__qs_pivot, __VA_ARGS__);                   \
+          } while (__qs_lt);                                                                       \
+          do {                                                                                     \
+            __qs_j--;                                                                              \
+            _da_less(T, __qs_lt, &__qs_pivot, &__qs_items[__qs_j], __VA_ARGS__);                   \
+          } while (__qs_lt);                                                                       \
+          if (__qs_j <= __qs_i) {                                                                  \
+            break;                                                                                 \
+          }                                                                                        \
+          _da_swap(T, __qs_items[__qs_i], __qs_items[__qs_j]);                                     \
+        }                                                                                          \
+        /* continue with the smaller partition, so the stack stays small */                        \
+        if (__qs_i - __qs_lo < __qs_hi - __qs_i) {                                                 \
+          __qs_stack[__qs_top++] = __qs_i;                                                         \
+          __qs_stack[__qs_top++] = __qs_hi;                                                        \
+          __qs_stack[__qs_top++] = __qs_d;                                                         \
+          __qs_hi = __qs_i;                                                                        \
+        } else {                                                                                   \
+          __qs_stack[__qs_top++] = __qs_lo;                                                        \
+          __qs_stack[__qs_top++] = __qs_i;                                                         \
+          __qs_stack[__qs_top++] = __qs_d;                                                         \
+          __qs_lo = __qs_i;                                                                        \
+        }                                                                                          \
+      }                                                                                            \
+    }                                                                                              \
+    _da_insertion_sort(T, __qs_items, (usize)0, da_len(list), __VA_ARGS__);                        \
+  } while (0)
+
+// Bottom up merge sort. Sorts runs of 'DA_SORT_INSERTION_SIZE' with insertion
+// sort and then merges them between the array and a temporary buffer.
+#define da_sort_stable_by(list, T, ...)                                                            \
+  do {                                                                                             \
+    const usize __ms_n = da_len(list);                                                             \
+    if (__ms_n <= 1) {                                                                             \
+      break;                                                                                       \
+    }                                                                                              \
+    T *__ms_src = (list)->items;                                                                   \
+    T *__ms_dst = arena_alloc_chunk((list)->arena, __ms_n * sizeof(T));                            \
+    T *const __ms_temp = __ms_dst;                                                                 \
+    for (usize __ms_lo = 0; __ms_lo < __ms_n; __ms_lo += DA_SORT_INSERTION_SIZE) {                 \
+      const usize __ms_hi =                                                                        \
+          __ms_n - __ms_lo < DA_SORT_INSERTION_SIZE ? __ms_n : __ms_lo + DA_SORT_INSERTION_SIZE;   \
+      _da_insertion_sort(T, __ms_src, __ms_lo, __ms_hi, __VA_ARGS__);                              \
+    }                                                                                              \
+    for (usize __ms_w = DA_SORT_INSERTION_SIZE; __ms_w < __ms_n; __ms_w *= 2) {                    \
+      for (usize __ms_lo = 0; __ms_lo < __ms_n; __ms_lo += 2 * __ms_w) {                           \
+        const usize __ms_mid = __ms_n - __ms_lo < __ms_w ? __ms_n : __ms_lo + __ms_w;              \
+        const usize __ms_hi = __ms_n - __ms_mid < __ms_w ? __ms_n : __ms_mid + __ms_w;             \
+        usize __ms_i = __ms_lo;                                                                    \
+        usize __ms_j = __ms_mid;                                                                   \
+        usize __ms_k = __ms_lo;                                                                    \
+        while (__ms_i < __ms_mid && __ms_j < __ms_hi) {                                            \
+          bool __ms_lt;                                                                            \
+          _da_less(T, __ms_lt, &__ms_src[__ms_j], &__ms_src[__ms_i], __VA_ARGS__);                 \
+          __ms_dst[__ms_k++] = __ms_lt ? __ms_src[__ms_j++] : __ms_src[__ms_i++];                  \
+        }                                                                                          \
+        while (__ms_i < __ms_mid) {                                                                \
+          __ms_dst[__ms_k++] = __ms_src[__ms_i++];                                                 \
+        }                                                                                          \
+        while (__ms_j < __ms_hi) {                                                                 \
+          __ms_dst[__ms_k++] = __ms_src[__ms_j++];                                                 \
+        }                                                                                          \
+      }                                                                                            \
+      T *__ms_swap = __ms_src;                                                                     \
+      __ms_src = __ms_dst;                                                                         \
+      __ms_dst = __ms_swap;                                                                        \
+    }                                                                                              \
+    if (__ms_src != (list)->items) {                                                               \
+      memcpy((list)->items, __ms_src, __ms_n * sizeof(T));                                         \
+    }                                                                                              \
+    arena_free_chunk((list)->arena, __ms_temp);                                                    \
+  } while (0)
+
+// LSD radix sort over the 'u64' key of every item, one byte per pass. Passes
+// where all keys have the same byte are skipped. The sort is stable.
+#define da_radix_sort_u64(list, key)                                                               \
+  do {                                                                                             \
+    const usize __rx_n = da_len(list);                                                             \
+    const usize __rx_size = sizeof((list)->items[0]);                                              \
+    if (__rx_n <= 1) {                                                                             \
+      break;                                                                                       \
+    }                                                                                              \
+    usize __rx_counts[8][256] = {0};                                                               \
+    for (usize __rx_i = 0; __rx_i < __rx_n; __rx_i++) {                                            \
+      const u64 __rx_key = key((list)->items[__rx_i]);                                             \
+      for (usize __rx_d = 0; __rx_d < 8; __rx_d++) {                                               \
+        __rx_counts[__rx_d][(__rx_key >> (__rx_d * 8)) & 0xff]++;                                  \
+      }                                                                                            \
+    }                                                                                              \
+    void *const __rx_items = (list)->items;                                                        \
+    void *const __rx_temp = arena_alloc_chunk((list)->arena, __rx_n * __rx_size);                  \
+    void *__rx_dst = __rx_temp;                                                                    \
+    for (usize __rx_d = 0; __rx_d < 8; __rx_d++) {                                                 \
+      usize *__rx_offsets = __rx_counts[__rx_d];                                                   \
+      if (__rx_offsets[(key((list)->items[0]) >> (__rx_d * 8)) & 0xff] == __rx_n) {                \
+        continue;                                                                                  \
+      }                                                                                            \
+      for (usize __rx_b = 0, __rx_sum = 0; __rx_b < 256; __rx_b++) {                               \
+        const usize __rx_c = __rx_offsets[__rx_b];                                                 \
+        __rx_offsets[__rx_b] = __rx_sum;                                                           \
+        __rx_sum += __rx_c;                                                                        \
+      }                                                                                            \
+      for (usize __rx_i = 0; __rx_i < __rx_n; __rx_i++) {                                          \
+        const usize __rx_b = (usize)((key((list)->items[__rx_i]) >> (__rx_d * 8)) & 0xff);         \
+        memcpy((u8 *)__rx_dst + __rx_offsets[__rx_b]++ * __rx_size, &(list)->items[__rx_i],        \
+               __rx_size);                                                                         \
+      }                                                                                            \
+      void *__rx_src = (list)->items;                                                              \
+      (list)->items = __rx_dst;                                                                    \
+      __rx_dst = __rx_src;                                                                         \
+    }                                                                                              \
+    if ((void *)(list)->items != __rx_items) {                                                     \
+      memcpy(__rx_items, (list)->items, __rx_n * __rx_size);                                       \
+      (list)->items = __rx_items;                                                                  \
+    }                                                                                              \
+    arena_free_chunk((list)->arena, __rx_temp);                                                    \
+  } while (0)
+
+// Branchless binary search: the range only shrinks by moving its start, so the
+// compiler emits a conditional move instead of a hard to predict branch.
+#define _da_search(list, T, key, idx, upper, ...)                                                  \
+  do {                                                                                             \
+    const T __bs_key = (key);                                                                      \
+    const T *__bs_base = (list)->items;                                                            \
+    usize __bs_n = da_len(list);                                                                   \
+    bool __bs_lt = false;                                                                          \
+    if (__bs_n == 0) {                                                                             \
+      (idx) = 0;                                                                                   \
+      break;                                                                                       \
+    }                                                                                              \
+    while (1 < __bs_n) {                                                                           \
+      const usize __bs_half = __bs_n / 2;                                                          \
+      if (upper) {                                                                                 \
+        _da_less(T, __bs_lt, &__bs_key, &__bs_base[__bs_half], __VA_ARGS__);                       \
+        __bs_lt = !__bs_lt;                                                                        \
+      } else {                                                                                     \
+        _da_less(T, __bs_lt, &__bs_base[__bs_half], &__bs_key, __VA_ARGS__);                       \
+      }                                                                                            \
+      __bs_base = __bs_lt ? __bs_base + __bs_half : __bs_base;                                     \
+      __bs_n -= __bs_half;                                                                         \
+    }                                                                                              \
+    if (upper) {                                                                                   \
+      _da_less(T, __bs_lt, &__bs_key, __bs_base, __VA_ARGS__);                                     \
+      __bs_lt = !__bs_lt;                                                                          \
+    } else {                                                                                       \
+      _da_less(T, __bs_lt, __bs_base, &__bs_key, __VA_ARGS__);                                     \
+    }                                                                                              \
+    (idx) = (usize)(__bs_base - (list)->items) + __bs_lt;                                          \
+  } while (0)
+
+#define da_lower_bound(list, T, key, idx, ...) _da_search(list, T, key, idx, false, __VA_ARGS__)
+#define da_upper_bound(list, T, key, idx, ...) _da_search(list, T, key, idx, true, __VA_ARGS__)
+
+#define da_bsearch(list, T, key, idx, ...)                                                         \
+  do {                                                                                             \
+    const T __bf_key = (key);                                                                      \
+    usize __bf_idx;                                                                                \
+    da_lower_bound(list, T, __bf_key, __bf_idx, __VA_ARGS__);                                      \
+    bool __bf_gt = true;                                                                           \
+    if (__bf_idx < da_len(list)) {                                                                 \
+      _da_less(T, __bf_gt, &__bf_key, &da_get(list, __bf_idx), __VA_ARGS__);                       \
+    }                                                                                              \
+    (idx) = __bf_gt ? DA_NOT_FOUND : __bf_idx;                                                     \
+  } while (0)
+
+// Keeps the first item of every run of equal items.
+#define da_unique(list, T, ...)                                                                    \
+  do {                                                                                             \
+    const usize __uq_n = da_len(list);                                                             \
+    usize __uq_w = __uq_n ? 1 : 0;                                                                 \
+    for (usize __uq_r = 1; __uq_r < __uq_n; __uq_r++) {                                            \
+      bool __uq_lt;                                                                                \
+      _da_less(T, __uq_lt, &da_get(list, __uq_w - 1), &da_get(list, __uq_r), __VA_ARGS__);         \
+      if (__uq_lt) {                                                                               \
+        da_get(list, __uq_w++) = da_get(list, __uq_r);                                             \
+      }                                                                                            \
+    }                                                                                              \
+    da_len(list) = __uq_w;                                                                         \
+  } while (0)
+
+// Takes from 'a' on ties, so the merge is stable.
+#define da_merge_sorted(first, second, dest, T, ...)                                               \
+  do {                                                                                             \
+    const usize __mg_n = da_len(first);                                                            \
+    const usize __mg_m = da_len(second);                                                           \
+    da_reserve((dest), __mg_n + __mg_m);                                                           \
+    T *__mg_out = &da_get(dest, da_len(dest));                                                     \
+    usize __mg_i = 0;                                                                              \
+    usize __mg_j = 0;                                                                              \
+    while (__mg_i < __mg_n && __mg_j < __mg_m) {                                                   \
+      bool __mg_lt;                                                                                \
+      _da_less(T, __mg_lt, &da_get(second, __mg_j), &da_get(first, __mg_i), __VA_ARGS__);          \
+      *__mg_out++ = __mg_lt ? da_get(second, __mg_j++) : da_get(first, __mg_i++);                  \
+    }                                                                                              \
+    while (__mg_i < __mg_n) {                                                                      \
+      *__mg_out++ = da_get(first, __mg_i++);                                                       \
+    }                                                                                              \
+    while (__mg_j < __mg_m) {                                                                      \
+      *__mg_out++ = da_get(second, __mg_j++);                                                      \
+    }                                                                                              \
+    da_len(dest) += __mg_n + __mg_m;                                                               \
+  } while (0)
+
 #define da_reverse(list)                                                                           \
   do {                                                                                             \
     da_reserve((list), 1);                                                                         \
@@ -964,313 +1469,104 @@ destination.
 #endif /* !__CEBUS_DA_H__ */
 
 /* DOCUMENTATION
-My HashMap takes a unique approach: it stores only the hashes of keys, not the
-keys themselves. Most of the time, you don’t really need the original keys
-hanging around. If you find yourself in a situation where you do, just pair it
-with a dynamic array to cover those bases. See
-[this](https://github.com/Code-Nycticebus/cebus/blob/main/examples/word.c)
-example.
+The `StringBuilder` provides functionality for efficiently constructing
+strings.
 
-As for the values, the HashMap is set up to work with simple, primitive
-data types. You can use pointers to handle more complex values. But make sure
-they have the same lifetime as the `HashMap`.
+> :warning: StringBuilder does not construct '\0' terminated strings.
 
-## Initialization
+## Functions
 
-Creating a new `HashMap` involves initializing an `Arena`, then calling
-`hm_create` or `hm_with_size` to initialize the hashmap with an optional initial
-size:
+- **`StringBuilder sb_init(Arena *arena);`**
+  Initializes a new `StringBuilder` instance, allocating its buffer using the
+provided memory `arena`.
 
-```c
-Arena arena = {0};
-HashMap* hm = hm_create(&arena);
-```
+- **`Str sb_to_str(StringBuilder *sb);`**
+  Converts the contents of the `StringBuilder` to a `Str`, effectively
+finalizing the string construction.
 
-## HashMap Operations
+- **`void sb_append_parts(StringBuilder *sb, usize size, const char *s);`**
+  Appends parts of a string to the `StringBuilder`, where `size` specifies the
+number of characters to append, and `s` points to the string parts to be
+appended.
 
-Basic hashmap management includes clearing, copying, resizing, reserving
-capacity, and updating from another hashmap:
+- **`void sb_append_cstr(StringBuilder *sb, const char *cstr);`**
+  Appends a C-style null-terminated string to the `StringBuilder`.
 
-- `hm_clear`: Clears the hashmap.
-- `hm_copy`: Creates a copy of the hashmap.
-- `hm_resize`: Resizes the hashmap. Used for preallocating space
-- `hm_reserve`: Reserves space in the hashmap. Used before adding multiple
-elements.
-- `hm_update`: Merges another hashmap into the current one.
+- **`void sb_append_str(StringBuilder *sb, Str str);`**
+  Appends a `Str` type string to the `StringBuilder`.
 
-## Inserting Elements
+- **`void sb_append_fmt(StringBuilder *sb, const char *fmt, ...);`**
+  Appends a formatted string to the `StringBuilder`, similar to `printf` style
+formatting.
 
-Elements of various types can be inserted into the hashmap, including integers,
-floating-point numbers, and pointers:
+- **`void sb_append_va(StringBuilder *sb, const char *fmt, va_list va);`**
+  Appends a formatted string and va_list to the `StringBuilder`, similar to
+`vprintf` style formatting.
 
-- `hm_insert_<T>`: Insert `u8`, `i8`, `u32`, `i32`, `u64`, `i64`, `usize`, `f32`
-or `f64` values.
-- `hm_insert_mut_ptr`, `hm_insert_ptr`: Insert mutable or constant pointers.
+- **`void sb_append_u64(StringBuilder *sb, u64 value);`**,
+**`void sb_append_i64(StringBuilder *sb, i64 value);`**
+  Appends a number in decimal, two digits at a time from a table.
 
-## Querying Elements
+- **`void sb_append_hex(StringBuilder *sb, u64 value);`**
+  Appends a number in lowercase hexadecimal without a prefix.
 
-Retrieve pointers to the values stored in the hashmap by their key hashes,
-allowing for mutable or immutable access. Returns `NULL` if key was not found:
+- **`void sb_append_f64(StringBuilder *sb, f64 value);`**
+  Appends the shortest digits that read back as the same `f64` (Grisu2), like
+JavaScript: `0.1`, `1e+21`, `1.5e-7`, `nan`, `-inf`.
 
-> :warning: Avoid storing pointers from the hashmap for extended periods.
-> Keeping these pointers beyond the immediate scope can lead to undefined
-behavior, as the underlying storage may change.
+None of these go through `printf`, so they do not depend on the locale.
+
+- **`void sb_append_replace(StringBuilder *sb, Str s, Str old, Str new);`**,
+**`void sb_append_replace_ignorecase(StringBuilder *sb, Str s, Str old, Str
+new);`**
+  Appends `s` with every non overlapping occurrence of `old` replaced by `new`,
+in a single pass. Unlike `str_replace`, it does not keep a scratch list of the
+match positions and does not allocate the whole result at once at the end, it
+copies every span into the builder as soon as it is found. The `_ignorecase`
+version ignores the case of ASCII letters. `io_write_replace` writes into a
+`FILE *` instead.
 
-- `hm_get_<T>`: Get `u8`, `i8`, `u32`, `i32`, `u64`, `i64`, `usize`, `f32`
-or `f64` pointers.
-- `hm_get_<T>_mut`: Get `u8`, `i8`, `u32`, `i32`, `u64`, `i64`, `usize`, `f32`
-or `f64` pointers.
 */
 
-#ifndef __CEBUS_HASHMAP_H__
-#define __CEBUS_HASHMAP_H__
+#ifndef __CEBUS_STRING_BUILDER_H__
+#define __CEBUS_STRING_BUILDER_H__
 
-// #include "cebus/core/arena.h"
 // #include "cebus/core/defines.h"
 
-typedef struct HashMap HashMap;
-
-///////////////////////////////////////////////////////////////////////////////
+// #include "cebus/collection/da.h"
+// #include "cebus/core/arena.h"
 
-HashMap *hm_create(Arena *arena);
-HashMap *hm_with_size(Arena *arena, usize size);
+#include <stdarg.h>
 
-void hm_clear(HashMap *hm);
+typedef DA(char) StringBuilder;
 
-HashMap *hm_copy(HashMap *hm, Arena *arena);
+StringBuilder sb_init(Arena *arena);
+void sb_clear(StringBuilder *sb);
 
-void hm_resize(HashMap *hm, usize size);
-void hm_reserve(HashMap *hm, usize size);
+Str sb_to_str(StringBuilder *sb);
 
-void hm_update(HashMap *hm, HashMap *other);
+void sb_append_parts(StringBuilder *sb, usize size, const char *s);
+void sb_append_cstr(StringBuilder *sb, const char *cstr);
+void sb_append_str(StringBuilder *sb, Str str);
+void sb_append_c(StringBuilder *sb, char c);
+FMT(2) usize sb_append_fmt(StringBuilder *sb, const char *fmt, ...);
+usize sb_append_va(StringBuilder *sb, const char *fmt, va_list va);
 
-bool hm_remove(HashMap *hm, u64 hash);
+void sb_append_u64(StringBuilder *sb, u64 value);
+void sb_append_i64(StringBuilder *sb, i64 value);
+void sb_append_hex(StringBuilder *sb, u64 value);
+void sb_append_f64(StringBuilder *sb, f64 value);
 
-///////////////////////////////////////////////////////////////////////////////
+void sb_append_replace(StringBuilder *sb, Str s, Str old, Str new);
+void sb_append_replace_ignorecase(StringBuilder *sb, Str s, Str old, Str new);
 
-bool hm_insert_f32(HashMap *hm, u64 hash, f32 value);
-bool hm_insert_f64(HashMap *hm, u64 hash, f64 value);
-bool hm_insert_i8(HashMap *hm, u64 hash, i8 value);
-bool hm_insert_u8(HashMap *hm, u64 hash, u8 value);
-bool hm_insert_i16(HashMap *hm, u64 hash, i16 value);
-bool hm_insert_u16(HashMap *hm, u64 hash, u16 value);
-bool hm_insert_i32(HashMap *hm, u64 hash, i32 value);
-bool hm_insert_u32(HashMap *hm, u64 hash, u32 value);
-bool hm_insert_i64(HashMap *hm, u64 hash, i64 value);
-bool hm_insert_u64(HashMap *hm, u64 hash, u64 value);
-bool hm_insert_usize(HashMap *hm, u64 hash, usize value);
-bool hm_insert_mut_ptr(HashMap *hm, u64 hash, void *value);
-bool hm_insert_ptr(HashMap *hm, u64 hash, const void *value);
+#endif /* !__CEBUS_STRING_BUILDER_H__ */
 
-///////////////////////////////////////////////////////////////////////////////
-
-f32 *hm_get_f32_mut(const HashMap *hm, u64 hash);
-f64 *hm_get_f64_mut(const HashMap *hm, u64 hash);
-i8 *hm_get_i8_mut(const HashMap *hm, u64 hash);
-u8 *hm_get_u8_mut(const HashMap *hm, u64 hash);
-i16 *hm_get_i16_mut(const HashMap *hm, u64 hash);
-u16 *hm_get_u16_mut(const HashMap *hm, u64 hash);
-i32 *hm_get_i32_mut(const HashMap *hm, u64 hash);
-u32 *hm_get_u32_mut(const HashMap *hm, u64 hash);
-i64 *hm_get_i64_mut(const HashMap *hm, u64 hash);
-u64 *hm_get_u64_mut(const HashMap *hm, u64 hash);
-usize *hm_get_usize_mut(const HashMap *hm, u64 hash);
-void *hm_get_ptr_mut(const HashMap *hm, u64 hash);
-
-///////////////////////////////////////////////////////////////////////////////
-
-const f32 *hm_get_f32(const HashMap *hm, u64 hash);
-const f64 *hm_get_f64(const HashMap *hm, u64 hash);
-const i8 *hm_get_i8(const HashMap *hm, u64 hash);
-const u8 *hm_get_u8(const HashMap *hm, u64 hash);
-const i16 *hm_get_i16(const HashMap *hm, u64 hash);
-const u16 *hm_get_u16(const HashMap *hm, u64 hash);
-const i32 *hm_get_i32(const HashMap *hm, u64 hash);
-const u32 *hm_get_u32(const HashMap *hm, u64 hash);
-const i64 *hm_get_i64(const HashMap *hm, u64 hash);
-const u64 *hm_get_u64(const HashMap *hm, u64 hash);
-const usize *hm_get_usize(const HashMap *hm, u64 hash);
-const void *hm_get_ptr(const HashMap *hm, u64 hash);
-
-///////////////////////////////////////////////////////////////////////////////
-
-#endif /* !__CEBUS_HASHMAP_H__ */
-
-/* DOCUMENTATION
-My `Set` implementation follows the same principle as my `HashMap`: it stores
-only the hashes for lookup. This means you get efficient way to check
-if something is in the set without the overhead of storing the actual elements.
-It’s pretty handy for cases where you just need to keep track of existence
-rather than the elements themselves.
-
-## Initialization
-
-To start using the set, you need to initialize an `Arena` and create a new set:
-
-```c
-Arena arena = {0};
-Set set = set_create(&arena);
-```
-
-## Set Operations
-
-Perform basic set operations such as adding, removing, and extending sets with
-multiple elements:
-
-- `set_add`: Add an element to the set. Returns false if the element already
-exists.
-- `set_remove`: Remove an element from the set.
-- `set_extend`: Add multiple elements to the set at once.
-
-Copy and resize sets for handling dynamic set sizes:
-
-- `set_copy`: Create a duplicate of a set.
-- `set_resize`: Adjust the capacity of the set. Used for preallocating
-space.
-- `set_reserve`: Reserves space in the set. Used before adding multiple
-elements
-
-
-## Set Query Operations
-
-Query the set for the presence of elements, equality with another set, or subset
-and disjoint relationships:
-
-- `set_contains`: Check if an element is in the set.
-- `set_eq`: Check if two sets are equal.
-- `set_subset`: Determine if one set is a subset of another.
-- `set_disjoint`: Determine if two sets have no elements in common.
-
-## Set Algebraic Operations
-
-Combine sets or find their differences using algebraic set operations:
-
-- `set_intersection`: Find the intersection of two sets.
-- `set_difference`: Find the difference between two sets.
-- `set_union`: Combine two sets into a union.
-*/
-
-#ifndef __CEBUS_SET_H__
-#define __CEBUS_SET_H__
-
-// #include "cebus/core/arena.h"
-// #include "cebus/core/defines.h"
-
-//////////////////////////////////////////////////////////////////////////////
-
-typedef struct {
-  usize cap;
-  usize count;
-  usize deleted;
-  Arena *arena;
-  u64 *items;
-} Set;
-
-///////////////////////////////////////////////////////////////////////////////
-
-Set set_create(Arena *arena);
-Set set_with_size(Arena *arena, usize size);
-
-void set_clear(Set *set);
-
-Set set_copy(Arena *arena, Set *set);
-
-void set_resize(Set *set, usize size);
-void set_reserve(Set *set, usize size);
-
-///////////////////////////////////////////////////////////////////////////////
-
-bool set_add(Set *set, u64 hash);
-void set_extend(Set *set, usize count, const u64 *hashes);
-void set_update(Set *dest, const Set *set);
-
-bool set_remove(Set *set, u64 hash);
-
-//////////////////////////////////////////////////////////////////////////////
-
-bool set_contains(const Set *set, u64 hash);
-bool set_eq(const Set *set, const Set *other);
-bool set_subset(const Set *set, const Set *other);
-bool set_disjoint(const Set *set, const Set *other);
-
-///////////////////////////////////////////////////////////////////////////////
-
-Set set_intersection(const Set *set, const Set *other, Arena *arena);
-Set set_difference(const Set *set, const Set *other, Arena *arena);
-Set set_union(const Set *set, const Set *other, Arena *arena);
-
-///////////////////////////////////////////////////////////////////////////////
-
-#endif /* !__CEBUS_SET_H__ */
-
-/* DOCUMENTATION
-The `StringBuilder` provides functionality for efficiently constructing
-strings.
-
-> :warning: StringBuilder does not construct '\0' terminated strings.
-
-## Functions
-
-- **`StringBuilder sb_init(Arena *arena);`**
-  Initializes a new `StringBuilder` instance, allocating its buffer using the
-provided memory `arena`.
-
-- **`Str sb_to_str(StringBuilder *sb);`**
-  Converts the contents of the `StringBuilder` to a `Str`, effectively
-finalizing the string construction.
-
-- **`void sb_append_parts(StringBuilder *sb, usize size, const char *s);`**
-  Appends parts of a string to the `StringBuilder`, where `size` specifies the
-number of characters to append, and `s` points to the string parts to be
-appended.
-
-- **`void sb_append_cstr(StringBuilder *sb, const char *cstr);`**
-  Appends a C-style null-terminated string to the `StringBuilder`.
-
-- **`void sb_append_str(StringBuilder *sb, Str str);`**
-  Appends a `Str` type string to the `StringBuilder`.
-
-- **`void sb_append_fmt(StringBuilder *sb, const char *fmt, ...);`**
-  Appends a formatted string to the `StringBuilder`, similar to `printf` style
-formatting.
-
-- **`void sb_append_va(StringBuilder *sb, const char *fmt, va_list va);`**
-  Appends a formatted string and va_list to the `StringBuilder`, similar to
-`vprintf` style formatting.
-
-*/
-
-#ifndef __CEBUS_STRING_BUILDER_H__
-#define __CEBUS_STRING_BUILDER_H__
-
-// #include "cebus/core/defines.h"
-
-// #include "cebus/collection/da.h"
-// #include "cebus/core/arena.h"
-
-#include <stdarg.h>
-
-typedef DA(char) StringBuilder;
-
-StringBuilder sb_init(Arena *arena);
-void sb_clear(StringBuilder *sb);
-
-Str sb_to_str(StringBuilder *sb);
-
-void sb_append_parts(StringBuilder *sb, usize size, const char *s);
-void sb_append_cstr(StringBuilder *sb, const char *cstr);
-void sb_append_str(StringBuilder *sb, Str str);
-void sb_append_c(StringBuilder *sb, char c);
-FMT(2) usize sb_append_fmt(StringBuilder *sb, const char *fmt, ...);
-usize sb_append_va(StringBuilder *sb, const char *fmt, va_list va);
-
-#endif /* !__CEBUS_STRING_BUILDER_H__ */
-
-/* DOCUMENTATION
-### Initialization Macros
-- `ErrNew`: Initializes a new Error instance.
-- `ErrPanic`: Initializes an Error that will trigger a panic on `error_emit()`.
-- `ErrDefault`: Empty Error that will panic on `error_emit()`.
+/* DOCUMENTATION
+### Initialization Macros
+- `ErrNew`: Initializes a new Error instance.
+- `ErrPanic`: Initializes an Error that will trigger a panic on `error_emit()`.
+- `ErrDefault`: Empty Error that will panic on `error_emit()`.
 
 ### Error Emitting and Context
 - `error_emit(E, code, fmt, ...)` initializes the passed in error.
@@ -1411,3610 +1707,9732 @@ void FMT(2) _error_internal_add_note(Error *err, const char *fmt, ...);
 #endif /* !__CEBUS_ERROR_H__ */
 
 /* DOCUMENTATION
-## Usage
-
-Call the function with the message format and arguments:
+## Thread Pool
+
+A thread pool keeps worker threads alive between jobs, so splitting a loop
+into tasks does not pay for starting threads every time. The thread that calls
+`thread_pool_run` works on the tasks too, so a pool with `threads` threads
+starts `threads - 1` workers.
+
+- `thread_pool_create(arena, threads)`: Creates a pool. With `0` threads it
+uses one per CPU.
+- `thread_pool_run(pool, tasks, fn, ctx)`: Calls `fn(ctx, task)` for every task
+from `0` to `tasks - 1` and returns after all of them are done. The tasks run in
+any order and on any thread.
+- `thread_pool_threads(pool)`: Returns the number of threads, including the
+calling one.
+- `thread_pool_destroy(pool)`: Stops the workers and waits for them. The memory
+belongs to the arena.
 
 ```c
-cebus_log_error("This is an error message: %s", error_details);
+static void square(void *ctx, usize task) {
+  u64 *values = ctx;
+  values[task] *= values[task];
+}
+
+Arena arena = {0};
+ThreadPool *pool = thread_pool_create(&arena, 0);
+thread_pool_run(pool, 1000, square, values);
+thread_pool_destroy(pool);
+arena_free(&arena);
 ```
 
-## Functions
+## Thread Lock
 
-- `cebus_log_level(log_level, fmt, ...)`: Logs a message with the specified log
-level.
-- `cebus_log(fmt, ...)`: Logs a message.
-- `cebus_log_fatal(fmt, ...)`: Logs a fatal message.
-- `cebus_log_error(fmt, ...)`: Logs an error message.
-- `cebus_log_warning(fmt, ...)`: Logs a warning message.
-- `cebus_log_info(fmt, ...)`: Logs an info message.
-- `cebus_log_debug(fmt, ...)`: Logs a debug message (only in debug builds).
-- `cebus_log_trace(fmt, ...)`: Logs a trace message (only in debug builds).
+A mutex for data that is shared between the tasks.
+
+- `thread_lock_create(arena)`: Creates an unlocked lock.
+- `thread_lock_acquire(lock)`, `thread_lock_release(lock)`: Locks and unlocks
+it.
+- `thread_lock_destroy(lock)`: Destroys the lock. The memory belongs to the
+arena.
+
+On platforms without threads the pool runs every task on the calling thread and
+the lock does nothing.
 */
 
-#ifndef __CEBUS_LOGGING_H__
-#define __CEBUS_LOGGING_H__
+#ifndef __CEBUS_THREAD_H__
+#define __CEBUS_THREAD_H__
 
+// #include "cebus/core/arena.h"
 // #include "cebus/core/defines.h"
 
 ////////////////////////////////////////////////////////////////////////////
 
-typedef enum {
-  CEBUS_LOG = 0,
-  CEBUS_LOG_FATAL,
-  CEBUS_LOG_ERROR,
-  CEBUS_LOG_WARNING,
-  CEBUS_LOG_INFO,
-  CEBUS_LOG_DEBUG,
-  CEBUS_LOG_TRACE,
-} LogLevel;
+typedef struct ThreadPool ThreadPool;
+typedef void (*ThreadTask)(void *ctx, usize task);
 
-////////////////////////////////////////////////////////////////////////////
+ThreadPool *thread_pool_create(Arena *arena, usize threads);
+void thread_pool_destroy(ThreadPool *pool);
 
-void FMT(2) cebus_log_level(LogLevel log_level, const char *fmt, ...);
-void FMT(1) cebus_log(const char *fmt, ...);
-void FMT(1) cebus_log_fatal(const char *fmt, ...);
-void FMT(1) cebus_log_error(const char *fmt, ...);
-void FMT(1) cebus_log_warning(const char *fmt, ...);
-void FMT(1) cebus_log_info(const char *fmt, ...);
+void thread_pool_run(ThreadPool *pool, usize tasks, ThreadTask fn, void *ctx);
+usize thread_pool_threads(const ThreadPool *pool);
 
 ////////////////////////////////////////////////////////////////////////////
 
-void FMT(1) _cebus_log_debug(const char *fmt, ...);
-void FMT(1) _cebus_log_trace(const char *fmt, ...);
+typedef struct ThreadLock ThreadLock;
 
-#ifndef NDEBUG
-#define cebus_log_debug(...) _cebus_log_debug(__VA_ARGS__)
-#define cebus_log_trace(...) _cebus_log_trace(__VA_ARGS__)
-#else
-#define cebus_log_debug(...)
-#define cebus_log_trace(...)
-#endif
+ThreadLock *thread_lock_create(Arena *arena);
+void thread_lock_destroy(ThreadLock *lock);
+
+void thread_lock_acquire(ThreadLock *lock);
+void thread_lock_release(ThreadLock *lock);
 
 ////////////////////////////////////////////////////////////////////////////
 
-#endif /* !__CEBUS_LOGGING_H__ */
+#endif /* !__CEBUS_THREAD_H__ */
 
-#ifndef __CEBUS_ARGS_H__
-#define __CEBUS_ARGS_H__
+/* DOCUMENTATION
+`AhoCorasick` searches for many patterns at once in a single pass over the
+text, no matter how many patterns there are. It is built once from the
+patterns and never changes, so it can be shared between threads.
 
-// #include "cebus/collection/da.h"
-// #include "cebus/collection/hashmap.h"
+Small pattern sets are compiled into a dense table with one transition for
+every state and byte class, so every byte of the text costs one lookup. The
+bytes that do not occur in any pattern share a class. Large sets, where that
+table would get too big, keep the sorted edges of every state and follow the
+failure links instead.
+
+```c
+Arena arena = {0};
+const Str keywords[] = {STR("if"), STR("else"), STR("while")};
+AhoCorasick *ac = ac_create(&arena, ARRAY_LEN(keywords), keywords);
+
+AcStream stream = ac_stream(ac);
+ac_feed_str(&stream, text);
+for (AcMatch match; ac_next(&stream, &match);) {
+  printf("%" USIZE_FMT ": %" USIZE_FMT "\n", match.pattern, match.start);
+}
+```
+
+- `ac_create(arena, count, patterns)`, `ac_create_bytes(arena, count,
+patterns)`: Builds the automaton from `Str` or `Bytes` patterns. Empty patterns
+never match.
+- `ac_len(ac)`: Returns the number of patterns.
+- `ac_is_dense(ac)`: Checks if it uses the dense table.
+
+## Searching
+
+A stream keeps the state between chunks, so matches that cross the border of
+two chunks are found too. The positions are counted from the start of the
+first chunk.
+
+- `ac_stream(ac)`: Starts a search.
+- `ac_feed(&stream, bytes)`, `ac_feed_str(&stream, str)`: Continues the search
+with the next chunk. Call it after `ac_next` returned `false`, the chunk has to
+stay valid until then.
+- `ac_next(&stream, &match)`: Finds the next match in the current chunk. Every
+match is reported, including overlapping ones, ordered by their end. Matches
+with the same end are reported from the longest to the shortest.
+- `ac_each(&stream, bytes, fn, ctx)`: Feeds a chunk and calls `fn(ctx, match)`
+for every match.
+- `ac_find(ac, str, &match)`: Finds the match that ends first.
+
+## Replacing
+
+- `ac_replace(ac, str, replacements, &sb)`: Appends the string to a
+`StringBuilder`, with every match replaced by `replacements[pattern]`. The
+matches do not overlap. If matches overlap, the one that starts first wins,
+and the longest one wins if they start at the same position.
+
+`str_replace_many` builds an automaton for a single call.
+*/
+
+#ifndef __CEBUS_AHO_CORASICK_H__
+#define __CEBUS_AHO_CORASICK_H__
+
+// #include "cebus/collection/string_builder.h"
+// #include "cebus/core/arena.h"
 // #include "cebus/core/defines.h"
 
-typedef struct {
-  Str name;
-  Str description;
-  bool parsed;
-  bool pos;
-  enum {
-    ARG_TYPE_NONE,
-    ARG_TYPE_FLAG,
-    ARG_TYPE_I64,
-    ARG_TYPE_U64,
-    ARG_TYPE_STR,
-  } type;
-  union {
-    bool flag;
-    i64 i64;
-    u64 u64;
-    Str str;
-  } as;
-} Argument;
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct AhoCorasick AhoCorasick;
 
 typedef struct {
-  Str program;
-  Str description;
+  // index of the pattern
+  usize pattern;
+  // position of the first byte and after the last byte
+  usize start;
+  usize end;
+} AcMatch;
 
-  const char **argv;
-  int argc;
+typedef struct {
+  const AhoCorasick *ac;
+  u32 state;
+  // the state and pattern of the next match that ends at 'pos'
+  u32 report;
+  u32 pattern;
+  usize offset;
+  usize pos;
+  Bytes chunk;
+} AcStream;
+
+typedef void (*AcMatchFn)(void *ctx, AcMatch match);
 
-  usize positional;
-  DA(Argument) arguments;
+//////////////////////////////////////////////////////////////////////////////
 
-  HashMap *hm;
-} Args;
+AhoCorasick *ac_create(Arena *arena, usize count, const Str *patterns);
+AhoCorasick *ac_create_bytes(Arena *arena, usize count, const Bytes *patterns);
 
-bool args_c_shift(int *argc, const char ***argv);
-Str args_shift(Args *args);
+usize ac_len(const AhoCorasick *ac);
+bool ac_is_dense(const AhoCorasick *ac);
 
-Args args_init(Arena *arena, int argc, const char **argv);
+//////////////////////////////////////////////////////////////////////////////
 
-void args_print_usage(Args *args, FILE *file);
-void args_print_help(Args *args, FILE *file);
-bool args_parse(Args *args);
+AcStream ac_stream(const AhoCorasick *ac);
+void ac_feed(AcStream *stream, Bytes chunk);
+void ac_feed_str(AcStream *stream, Str chunk);
+bool ac_next(AcStream *stream, AcMatch *match);
 
-void args_add_description(Args *args, const char *description);
+void ac_each(AcStream *stream, Bytes chunk, AcMatchFn fn, void *ctx);
+bool ac_find(const AhoCorasick *ac, Str s, AcMatch *match);
 
-void args_add_i64(Args *args, const char *argument, const char *description);
-void args_add_u64(Args *args, const char *argument, const char *description);
-void args_add_str(Args *args, const char *argument, const char *description);
+//////////////////////////////////////////////////////////////////////////////
 
-void args_add_opt_i64(Args *args, const char *argument, i64 def, const char *description);
-void args_add_opt_u64(Args *args, const char *argument, u64 def, const char *description);
-void args_add_opt_str(Args *args, const char *argument, Str def, const char *description);
-void args_add_opt_flag(Args *args, const char *argument, const char *description);
+void ac_replace(const AhoCorasick *ac, Str s, const Str *replacements, StringBuilder *sb);
 
-i64 args_get_i64(Args *args, const char *argument);
-u64 args_get_u64(Args *args, const char *argument);
-Str args_get_str(Args *args, const char *argument);
-bool args_get_flag(Args *args, const char *argument);
+//////////////////////////////////////////////////////////////////////////////
 
-#endif /* !__CEBUS_ARGS_H__ */
+#endif /* !__CEBUS_AHO_CORASICK_H__ */
 
 /* DOCUMENTATION
-## Functions
+A `BloomFilter` answers the question "was this hash added?" with either
+"definitely not" or "probably yes". It only stores a few bits per member, so it
+is a lot smaller than a `Set`, which needs 8 bytes per member. Use it in front
+of a `Set`, `HashMap` or something more expensive to reject most of the
+candidates early.
 
-- **`cmd_exec(error, argc, argv)`**: Executes a system command.
-- **`cmd_exec_da(error, da)`**: Executes a with a dynamic array.
+Like `Set` and `HashMap` it works on precomputed `u64` hashes.
 
-## Construction a dynamic array
+## Initialization
+
+The filter is sized from the expected number of members and the accepted
+false positive rate:
 
 ```c
 Arena arena = {0};
+BloomFilter bf = bloom_create(&arena, 1000000, 0.01);
+```
 
-Cmd cmd = cmd_new(&arena);
+- `bloom_create`: Creates a classic bloom filter, the bits of one member are
+spread over the whole filter.
+- `bloom_create_blocked`: Creates a blocked bloom filter. All bits of a member
+are in a single 64 byte block, so every operation touches only one cache line.
+It is a lot faster for big filters, but needs a few more bits per member for
+the same false positive rate.
+- `bloom_with_size`: Creates a filter with an explicit number of bits and
+hashes per member.
+- `bloom_clear`: Removes all members.
+- `bloom_copy`: Creates a copy of the filter.
+
+## Operations
+
+- `bloom_add`: Adds a hash. Returns false if it was probably added before.
+- `bloom_extend`: Adds multiple hashes at once.
+- `bloom_contains`: Checks if the hash was probably added.
+- `bloom_contains_batch`: Checks multiple hashes at once and writes the results
+into an array. Returns how many of them were probably added. The memory of the
+next hashes is prefetched while the current ones are checked.
+- `bloom_union`: Adds all members of another filter. Both filters need to be
+created with the same parameters. Members of both filters are only counted
+once, so the new count is estimated from the number of set bits.
+- `bloom_fp_rate`: Estimates the false positive rate for the current number of
+members.
 
-cmd_push(&cmd, STR("gcc"), STR("-o"), STR("main"));
+```c
+bloom_add(&bf, str_hash(STR("hello")));
+if (bloom_contains(&bf, str_hash(STR("hello")))) {
+  // probably in the filter, now check the real set
+}
+```
+*/
 
-Str cflags[] = {STR("-Wall"), STR("-Wextra")};
-cmd_extend(&cmd, words);
+#ifndef __CEBUS_BLOOM_H__
+#define __CEBUS_BLOOM_H__
 
-DA(Str) files = da_new(&arena);
-// collect files...
-cmd_extend_da(&cmd, &files);
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
 
-cmd_exec_da(ErrPanic, &cmd);
+//////////////////////////////////////////////////////////////////////////////
 
-arena_free(&arena);
+typedef struct {
+  usize bits;
+  usize k;
+  usize count;
+  bool blocked;
+  Arena *arena;
+  u64 *items;
+} BloomFilter;
+
+//////////////////////////////////////////////////////////////////////////////
+
+BloomFilter bloom_create(Arena *arena, usize expected, f64 fp_rate);
+BloomFilter bloom_create_blocked(Arena *arena, usize expected, f64 fp_rate);
+BloomFilter bloom_with_size(Arena *arena, usize bits, usize k, bool blocked);
+
+void bloom_clear(BloomFilter *bf);
+
+BloomFilter bloom_copy(Arena *arena, const BloomFilter *bf);
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool bloom_add(BloomFilter *bf, u64 hash);
+void bloom_extend(BloomFilter *bf, usize count, const u64 *hashes);
+
+bool bloom_contains(const BloomFilter *bf, u64 hash);
+usize bloom_contains_batch(const BloomFilter *bf, usize count, const u64 *hashes, bool *result);
+
+void bloom_union(BloomFilter *bf, const BloomFilter *other);
+
+f64 bloom_fp_rate(const BloomFilter *bf);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_BLOOM_H__ */
+
+/* DOCUMENTATION
+`CountMin` is a Count-Min sketch. It estimates how often a hash was added to a
+stream with a fixed amount of memory. The estimate is never lower than the
+real count. With a width `w` and a depth `d` it overestimates by more than
+`e / w * total` with a probability of `e^-d`.
+
+The items are `u64` hashes, for example from `str_hash`. Every row derives its
+column from that one hash, so an item is never hashed more than once.
+
+## Initialization
+
+```c
+Arena arena = {0};
+// error of 0.1% of the total count with a probability of 99%
+CountMin cms = cms_create(&arena, 0.001, 0.01);
 ```
 
-## Error Handling
+- `cms_create`: Creates a sketch from the accepted error (relative to the total
+count) and the probability to exceed it.
+- `cms_with_size`: Creates a sketch with an explicit width and depth. The width
+is rounded up to a power of two.
+- `cms_clear`: Resets all counters.
+- `cms_copy`: Creates a copy of the sketch.
 
-Defines `CmdError` enum for different command execution outcomes:
-- `CMD_OK`: Command executed successfully.
-- `CMD_FORK`: Error occurred while forking the process.
-- `CMD_NOT_FOUND`: Command not found, typically returns `127`.
+## Operations
 
-## Usage Example
+- `cms_add`: Adds `count` to the hash. It uses the conservative update: only
+the counters that are smaller than the new estimate are increased, which
+makes the estimates a lot more accurate. Returns the new estimate.
+- `cms_estimate`: Estimates how often the hash was added.
+- `cms_merge`: Adds all counters of another sketch with the same dimensions.
 
 ```c
-Error error = ErrNew;
-Str args[] = {STR("/bin/echo"), STR("Hello, world!")};
-cmd_exec(&error, 2, args);
-error_context(&error, {
-    // Handle error
-});
+cms_add(&cms, str_hash(word), 1);
+u64 count = cms_estimate(&cms, str_hash(word));
 ```
 */
 
-#ifndef __CEBUS_CMD_H__
-#define __CEBUS_CMD_H__
+#ifndef __CEBUS_COUNT_MIN_H__
+#define __CEBUS_COUNT_MIN_H__
 
-// #include "cebus/collection/da.h"
+// #include "cebus/core/arena.h"
 // #include "cebus/core/defines.h"
-// #include "cebus/core/error.h"
 
-typedef enum {
-  CMD_OK,
-  CMD_FORK,
-  CMD_NOT_FOUND = 127,
-} CmdError;
+//////////////////////////////////////////////////////////////////////////////
 
-void cmd_exec(Error *error, size_t argc, Str *argv);
+typedef struct {
+  usize width;
+  usize depth;
+  u64 total;
+  Arena *arena;
+  u64 *items;
+} CountMin;
 
-typedef DA(Str) Cmd;
+//////////////////////////////////////////////////////////////////////////////
 
-#define cmd_new(arena) da_new(arena)
-#define cmd_push(cmd, ...) da_extend(cmd, ARRAY_LEN((Str[]){__VA_ARGS__}), (Str[]){__VA_ARGS__})
-#define cmd_extend(cmd, ...) da_extend(cmd, ARRAY_LEN(__VA_ARGS__), (__VA_ARGS__))
-#define cmd_extend_da(cmd, da) da_extend(cmd, (da)->len, (da)->items)
+CountMin cms_create(Arena *arena, f64 epsilon, f64 delta);
+CountMin cms_with_size(Arena *arena, usize width, usize depth);
 
-void cmd_exec_da(Error *error, const Cmd *cmd);
+void cms_clear(CountMin *cms);
 
-#endif // !__CEBUS_CMD_H__
+CountMin cms_copy(Arena *arena, const CountMin *cms);
+
+//////////////////////////////////////////////////////////////////////////////
+
+u64 cms_add(CountMin *cms, u64 hash, u64 count);
+u64 cms_estimate(const CountMin *cms, u64 hash);
+
+void cms_merge(CountMin *cms, const CountMin *other);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_COUNT_MIN_H__ */
 
 /* DOCUMENTATION
-## Functions
+Parallel versions of `da_map`, `da_filter` and `da_sort`, that split the array
+into chunks and run them on a `ThreadPool`. The chunks only depend on the
+length of the array, so the result is the same for every number of threads.
 
-- **`dll_load(path, error)`**: Loads a dynamic link library.
-- **`dll_close(handle)`**: Closes an opened dynamic link library.
-- **`dll_symbol(handle, symbol, error)`**: Retrieves a symbol from the dynamic
-link library.
+The functions are called through pointers, like the comparison function of
+`da_sort`, because a macro can not hand an expression to another thread.
 
+## Functions
 
-## Usage Example
+- `da_par_map(pool, src, dest, map)`: Calls `void map(const void *item, void
+*out)` for every item and stores the results in `dest`.
+- `da_par_map_ctx(pool, src, dest, map, ctx)`: Same but calls `void map(void
+*ctx, const void *item, void *out)`. Every thread gets the same `ctx`, so it
+should only be read.
+- `da_par_filter(pool, src, dest, filter)`: Copies the items for which `bool
+filter(const void *item)` returns `true` into `dest`, in the same order. The
+chunks are filtered in parallel and then copied to their offsets from a prefix
+sum of their counts.
+- `da_par_filter_ctx(pool, src, dest, filter, ctx)`: Same but calls `bool
+filter(void *ctx, const void *item)`.
+- `da_par_sort(pool, list, compare)`: Sorts the array with a `CompareFn`,
+like `da_sort`. The chunks are sorted in parallel and then merged in
+rounds, with every merge split into parallel parts.
+
+`dest` must not be `src`.
 
 ```c
-Error error = ErrNew;
-Dll *myLib = dll_load(STR("myLibrary.dll"), &error);
-error_context(&error, {
-  error_raise();
-});
-Function *myFunction = dll_symbol(myLib, "myFunctionName", &error);
-// Use the function pointer as needed
-dll_close(myLib);
+static void square(const void *item, void *out) {
+  *(u64 *)out = *(const u64 *)item * *(const u64 *)item;
+}
+
+ThreadPool *pool = thread_pool_create(&arena, 0);
+DA(u64) squares = da_new(&arena);
+da_par_map(pool, &values, &squares, square);
+da_par_sort(pool, &squares, u64_compare_qsort(CMP_LESS));
+thread_pool_destroy(pool);
 ```
 */
 
-#ifndef __CEBUS_DLL_H__
-#define __CEBUS_DLL_H__
+#ifndef __CEBUS_DA_PAR_H__
+#define __CEBUS_DA_PAR_H__
 
+// #include "cebus/collection/da.h" // IWYU pragma: export
 // #include "cebus/core/defines.h"
-// #include "cebus/core/error.h"
+// #include "cebus/os/thread.h" // IWYU pragma: export
 
-typedef void Dll;
-typedef void (*Function)(void);
+///////////////////////////////////////////////////////////////////////////////
 
-Dll *dll_load(Path path, Error *error);
-void dll_close(Dll *handle);
+#define da_par_map(pool, src, dest, map)                                                           \
+  do {                                                                                             \
+    da_reserve((dest), da_len(src));                                                               \
+    _da_par_map(pool, da_len(src), (src)->items, sizeof(*(src)->items), (dest)->items,             \
+                sizeof(*(dest)->items), map);                                                      \
+    da_len(dest) = da_len(src);                                                                    \
+  } while (0)
 
-Function dll_symbol(Dll *handle, Str symbol, Error *error);
+#define da_par_map_ctx(pool, src, dest, map, ctx)                                                  \
+  do {                                                                                             \
+    da_reserve((dest), da_len(src));                                                               \
+    _da_par_map_ctx(pool, da_len(src), (src)->items, sizeof(*(src)->items), (dest)->items,         \
+                    sizeof(*(dest)->items), map, ctx);                                             \
+    da_len(dest) = da_len(src);                                                                    \
+  } while (0)
 
-#endif /*  !__CEBUS_DLL_H__ */
+#define da_par_filter(pool, src, dest, filter)                                                     \
+  do {                                                                                             \
+    da_reserve((dest), da_len(src));                                                               \
+    da_len(dest) = _da_par_filter(pool, da_len(src), (src)->items, (dest)->items,                  \
+                                  sizeof(*(src)->items), filter);                                  \
+  } while (0)
 
-/* DOCUMENTATION
-## Functions
+#define da_par_filter_ctx(pool, src, dest, filter, ctx)                                            \
+  do {                                                                                             \
+    da_reserve((dest), da_len(src));                                                               \
+    da_len(dest) = _da_par_filter_ctx(pool, da_len(src), (src)->items, (dest)->items,              \
+                                      sizeof(*(src)->items), filter, ctx);                         \
+  } while (0)
 
-- **Reading Files**:
-  - `fs_file_read_bytes(filename, arena, error)`: Reads the entire file into a
-byte array.
-  - `fs_file_read_str(filename, arena, error)`: Reads the entire file into a
-string.
-  - `fs_file_read_utf8(filename, arena, error)`: Reads the entire file into
-UTF-8 format.
+#define da_par_sort(pool, list, compare)                                                           \
+  _da_par_sort(pool, da_len(list), (list)->items, sizeof(*(list)->items), compare)
 
-- **Writing Files**:
-  - `fs_file_write_bytes(filename, bytes, error)`: Writes byte data to a file.
-  - `fs_file_write_str(filename, content, error)`: Writes a string to a file.
-  - `fs_file_write_utf8(filename, content, error)`: Writes UTF-8 formatted data
-to a file.
+///////////////////////////////////////////////////////////////////////////////
 
-- **File Management**:
-  - `fs_file_open(filename, mode, error)`: Opens a file with the specified mode.
-  - `fs_file_close(file, error)`: Closes an open file.
-  - `fs_rename(old_name, new_name, error)`: Renames a file.
-  - `fs_remove(filename, error)`: Removes a file.
-  - `fs_exists(filename)`: Checks if a file exists.
+void _da_par_map(ThreadPool *pool, usize count, const void *src, usize src_size, void *dest,
+                 usize dest_size, void (*map)(const void *item, void *out));
+void _da_par_map_ctx(ThreadPool *pool, usize count, const void *src, usize src_size, void *dest,
+                     usize dest_size, void (*map)(void *ctx, const void *item, void *out),
+                     void *ctx);
+usize _da_par_filter(ThreadPool *pool, usize count, const void *src, void *dest, usize size,
+                     bool (*filter)(const void *item));
+usize _da_par_filter_ctx(ThreadPool *pool, usize count, const void *src, void *dest, usize size,
+                         bool (*filter)(void *ctx, const void *item), void *ctx);
+void _da_par_sort(ThreadPool *pool, usize count, void *items, usize size, CompareFn compare);
 
-## Usage Example
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_DA_PAR_H__ */
+
+/* DOCUMENTATION
+`Eytzinger` is a static sorted set of `u64` keys for fast lookups. The keys
+are stored in breadth first order of a complete binary search tree: the
+children of the key at `k` are at `2k` and `2k + 1`. A search always walks
+down the array, the first levels of the tree share a few cache lines, and the
+keys a few levels further down can be prefetched while comparing. The search
+loop has no branches that depend on the keys.
+
+It uses one `u64` per key, which is a lot smaller than a `Set`, and does not
+need the keys to be hashes.
 
 ```c
 Arena arena = {0};
-Error error = ErrNew;
-Str content = fs_file_read_str(STR("filename.txt"), &arena, &error);
-error_context(&error, {
-    error_raise();
-});
-arena_free(&arena);
+Eytzinger ez = eytzinger_create(&arena, count, keys);
+if (eytzinger_contains(&ez, 42)) {
+  // ...
+}
 ```
 
-
+- `eytzinger_create`: Creates the set from an array of keys in any order.
+Duplicates are removed.
+- `eytzinger_contains`: Checks if a key is in the set.
+- `eytzinger_lower_bound`: Finds the smallest key that is not less than a
+key. Returns `false` if there is none.
+- `eytzinger_contains_batch`: Checks multiple keys at once and returns how many
+were found. Writes the result for every key into `result` if it is not
+`NULL`.
 */
 
-#ifndef __CEBUS_FS_H__
-#define __CEBUS_FS_H__
+#ifndef __CEBUS_EYTZINGER_H__
+#define __CEBUS_EYTZINGER_H__
 
 // #include "cebus/core/arena.h"
 // #include "cebus/core/defines.h"
-// #include "cebus/core/error.h"
 
-#include <errno.h>
+//////////////////////////////////////////////////////////////////////////////
 
-////////////////////////////////////////////////////////////////////////////
+typedef struct {
+  usize len;
+  Arena *arena;
+  u64 *keys;
+} Eytzinger;
 
-typedef enum {
-  FS_OK,
-  FS_PERMISSION = EACCES,
-  FS_NOT_FOUND = ENOENT,
-  FS_INVALID = EBADF,
-} FileError;
+//////////////////////////////////////////////////////////////////////////////
 
-////////////////////////////////////////////////////////////////////////////
+Eytzinger eytzinger_create(Arena *arena, usize count, const u64 *keys);
 
-FILE *fs_file_open(Path path, const char *mode, Error *error);
-void fs_file_close(FILE *file, Error *error);
+bool eytzinger_contains(const Eytzinger *ez, u64 key);
+bool eytzinger_lower_bound(const Eytzinger *ez, u64 key, u64 *result);
+usize eytzinger_contains_batch(const Eytzinger *ez, usize count, const u64 *keys, bool *result);
 
-Bytes fs_file_read_bytes(Path filename, Arena *arena, Error *error);
-Str fs_file_read_str(Path filename, Arena *arena, Error *error);
-Utf8 fs_file_read_utf8(Path filename, Arena *arena, Error *error);
+//////////////////////////////////////////////////////////////////////////////
 
-void fs_file_write_bytes(Path filename, Bytes bytes, Error *error);
-void fs_file_write_str(Path filename, Str content, Error *error);
-void fs_file_write_utf8(Path filename, Utf8 content, Error *error);
+#endif /* !__CEBUS_EYTZINGER_H__ */
 
-void fs_rename(Path old_path, Path new_path, Error *error);
-void fs_remove(Path path, Error *error);
-bool fs_exists(Path path);
-bool fs_is_dir(Path path);
+/* DOCUMENTATION
+My HashMap takes a unique approach: it stores only the hashes of keys, not the
+keys themselves. Most of the time, you don’t really need the original keys
+hanging around. If you find yourself in a situation where you do, just pair it
+with a dynamic array to cover those bases. See
+[this](https://github.com/Code-Nycticebus/cebus/blob/main/examples/word.c)
+example.
 
-////////////////////////////////////////////////////////////////////////////
+As for the values, the HashMap is set up to work with simple, primitive
+data types. You can use pointers to handle more complex values. But make sure
+they have the same lifetime as the `HashMap`.
 
-/* DOCUMENTATION
-## Directory Iteration
+## Initialization
 
-```c
-int main(void) {
-  // initialize and configure iterator
-  FsIter it = fs_iter_begin(STR("."), true);
+Creating a new `HashMap` involves initializing an `Arena`, then calling
+`hm_create` or `hm_with_size` to initialize the hashmap with an optional initial
+size:
 
-  // iterate over directory with certain filters
-  while (fs_iter_next_suffix(&it, STR(".clangd"))) {
-    // every allocation in the scratch buffer gets reset after each iteration
-    Str data = fs_file_read_str(it.current.path, &it.scratch, &it.error);
+```c
+Arena arena = {0};
+HashMap* hm = hm_create(&arena);
+```
 
-    // do not return before you call 'fs_iter_end'
-    error_propagate(&it.error, { break; });
+## HashMap Operations
 
-    // do something with data...
-    cebus_log_debug(STR_FMT, STR_ARG(data));
-  }
+Basic hashmap management includes clearing, copying, resizing, reserving
+capacity, and updating from another hashmap:
 
-  // collect errors and deinitializes iterator
-  Error err = ErrNew;
-  fs_iter_end(&it, &err);
-  error_context(&err, { error_panic(); });
-}
-```
-*/
+- `hm_clear`: Clears the hashmap.
+- `hm_copy`: Creates a copy of the hashmap.
+- `hm_resize`: Resizes the hashmap. Used for preallocating space
+- `hm_reserve`: Reserves space in the hashmap. Used before adding multiple
+elements.
+- `hm_update`: Merges another hashmap into the current one.
 
-typedef struct {
-  bool is_dir;
-  Path path;
-} FsEntity;
+## Inserting Elements
 
-typedef struct {
-  Error error;
-  Arena scratch;
-  bool recursive;
-  FsEntity current;
-  void *_stack;
-} FsIter;
+Elements of various types can be inserted into the hashmap, including integers,
+floating-point numbers, and pointers:
 
-FsIter fs_iter_begin(Path directory, bool recursive);
-void fs_iter_end(FsIter *it, Error *error);
+- `hm_insert_<T>`: Insert `u8`, `i8`, `u32`, `i32`, `u64`, `i64`, `usize`, `f32`
+or `f64` values.
+- `hm_insert_mut_ptr`, `hm_insert_ptr`: Insert mutable or constant pointers.
 
-bool fs_iter_next(FsIter *it);
-bool fs_iter_next_filter(FsIter *it, bool (*filter)(FsEntity *entity));
-bool fs_iter_next_directory(FsIter *it);
-bool fs_iter_next_files(FsIter *it);
-bool fs_iter_next_suffix(FsIter *it, Str suffix);
+## Querying Elements
 
-////////////////////////////////////////////////////////////////////////////
+Retrieve pointers to the values stored in the hashmap by their key hashes,
+allowing for mutable or immutable access. Returns `NULL` if key was not found:
 
-#endif /* !__CEBUS_FS_H__ */
+> :warning: Avoid storing pointers from the hashmap for extended periods.
+> Keeping these pointers beyond the immediate scope can lead to undefined
+behavior, as the underlying storage may change.
 
-/* DOCUMENTATION
-## Functions
+- `hm_get_<T>`: Get `u8`, `i8`, `u32`, `i32`, `u64`, `i64`, `usize`, `f32`
+or `f64` pointers.
+- `hm_get_<T>_mut`: Get `u8`, `i8`, `u32`, `i32`, `u64`, `i64`, `usize`, `f32`
+or `f64` pointers.
+*/
 
-- **Output**:
-  - `io_write(file, fmt, ...)`: Writes a formated string into the file
-  - `io_write_bytes(file, bytes, error)`: Writes byte data to a file or stream.
+#ifndef __CEBUS_HASHMAP_H__
+#define __CEBUS_HASHMAP_H__
 
-- **Input**:
-  - `io_read_bytes(file, size, buffer, error)`: Reads a specified amount of byte
-data from a file or stream into a buffer.
-  - `io_read_line(file, size, buffer, error)`: Reads a line of text from a file
-or stream into a buffer.
-  - `input(prefix)`: Displays a prompt and reads a line of text from standard
-input.
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
 
-## Usage Example
+typedef struct HashMap HashMap;
 
-```c
-Error e = ErrNew;
-io_write(stdout, BYTES_STR("Hello, World"), &e);
-error_context(&e, { error_raise(); });
+///////////////////////////////////////////////////////////////////////////////
 
-Str ret = input(STR(":> "));
-printf("input: '"STR_FMT"'\n", STR_ARG(ret));
-```
+HashMap *hm_create(Arena *arena);
+HashMap *hm_with_size(Arena *arena, usize size);
 
-Output when running the example:
-```console
-:> name
-input: 'name'
-```
+void hm_clear(HashMap *hm);
 
-*/
+HashMap *hm_copy(HashMap *hm, Arena *arena);
 
-#ifndef __CEBUS_IO_H__
-#define __CEBUS_IO_H__
+void hm_resize(HashMap *hm, usize size);
+void hm_reserve(HashMap *hm, usize size);
 
-// #include "cebus/core/defines.h"
-// #include "cebus/core/error.h"
+void hm_update(HashMap *hm, HashMap *other);
 
-////////////////////////////////////////////////////////////////////////////
+bool hm_remove(HashMap *hm, u64 hash);
 
-FMT(2) usize io_write_fmt(FILE *file, const char *fmt, ...);
-void io_write_bytes(FILE *file, Bytes bytes, Error *error);
-void io_write_str(FILE *file, Str string, Error *error);
+///////////////////////////////////////////////////////////////////////////////
 
-Bytes io_read_bytes(FILE *file, usize size, void *buffer, Error *error);
-Str io_read_line(FILE *file, usize size, char *buffer, Error *error);
+bool hm_insert_f32(HashMap *hm, u64 hash, f32 value);
+bool hm_insert_f64(HashMap *hm, u64 hash, f64 value);
+bool hm_insert_i8(HashMap *hm, u64 hash, i8 value);
+bool hm_insert_u8(HashMap *hm, u64 hash, u8 value);
+bool hm_insert_i16(HashMap *hm, u64 hash, i16 value);
+bool hm_insert_u16(HashMap *hm, u64 hash, u16 value);
+bool hm_insert_i32(HashMap *hm, u64 hash, i32 value);
+bool hm_insert_u32(HashMap *hm, u64 hash, u32 value);
+bool hm_insert_i64(HashMap *hm, u64 hash, i64 value);
+bool hm_insert_u64(HashMap *hm, u64 hash, u64 value);
+bool hm_insert_usize(HashMap *hm, u64 hash, usize value);
+bool hm_insert_mut_ptr(HashMap *hm, u64 hash, void *value);
+bool hm_insert_ptr(HashMap *hm, u64 hash, const void *value);
 
-////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
 
-Str input(Str prefix);
+f32 *hm_get_f32_mut(const HashMap *hm, u64 hash);
+f64 *hm_get_f64_mut(const HashMap *hm, u64 hash);
+i8 *hm_get_i8_mut(const HashMap *hm, u64 hash);
+u8 *hm_get_u8_mut(const HashMap *hm, u64 hash);
+i16 *hm_get_i16_mut(const HashMap *hm, u64 hash);
+u16 *hm_get_u16_mut(const HashMap *hm, u64 hash);
+i32 *hm_get_i32_mut(const HashMap *hm, u64 hash);
+u32 *hm_get_u32_mut(const HashMap *hm, u64 hash);
+i64 *hm_get_i64_mut(const HashMap *hm, u64 hash);
+u64 *hm_get_u64_mut(const HashMap *hm, u64 hash);
+usize *hm_get_usize_mut(const HashMap *hm, u64 hash);
+void *hm_get_ptr_mut(const HashMap *hm, u64 hash);
 
-////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
 
-#endif /* !__CEBUS_IO_H__ */
+const f32 *hm_get_f32(const HashMap *hm, u64 hash);
+const f64 *hm_get_f64(const HashMap *hm, u64 hash);
+const i8 *hm_get_i8(const HashMap *hm, u64 hash);
+const u8 *hm_get_u8(const HashMap *hm, u64 hash);
+const i16 *hm_get_i16(const HashMap *hm, u64 hash);
+const u16 *hm_get_u16(const HashMap *hm, u64 hash);
+const i32 *hm_get_i32(const HashMap *hm, u64 hash);
+const u32 *hm_get_u32(const HashMap *hm, u64 hash);
+const i64 *hm_get_i64(const HashMap *hm, u64 hash);
+const u64 *hm_get_u64(const HashMap *hm, u64 hash);
+const usize *hm_get_usize(const HashMap *hm, u64 hash);
+const void *hm_get_ptr(const HashMap *hm, u64 hash);
 
-/* DOCUMENTATION
-## Functions
+///////////////////////////////////////////////////////////////////////////////
 
-- **Environment Variables**:
-  - `os_getenv(env, error)`: Retrieves the value of an environment variable.
+#endif /* !__CEBUS_HASHMAP_H__ */
 
-- **Current Working Directory**:
-  - `os_getcwd(arena)`: Returns the current working directory, allocating memory
-from the specified `Arena`.
-  - `os_chdir(path)`: Changes the current working directory to the specified
-path.
+/* DOCUMENTATION
+A heap is a priority queue, that always knows its smallest element. The heap
+is stored in a dynamic array, so `Heap(T)` is the same as `DA(T)` and the
+`da_*` macros like `da_len` work on it.
 
-## Usage Example
+`HEAP_DEFINE(Name, T, ARITY, less)` defines the type `Name` and its
+functions. The comparison `less` is an expression that compares the items
+`const T *a` and `const T *b`, like in `da_sort_by`. It gets inlined into the
+functions. `ARITY` is the number of children per node. A binary heap (2) does
+the fewest comparisons, a 4-ary heap is shallower and touches fewer cache
+lines, which is usually faster for big heaps.
 
 ```c
-Error error = ErrNew;
-Str cwd = os_getcwd(&arena);
-Str home = os_getenv("HOME", &error);
-error_context(&error, {
-  error_raise();
-});
+HEAP_DEFINE(TaskQueue, Task, 4, a->deadline < b->deadline)
 
-printf("Current working directory: " STR_FMT "\n", STR_ARG(cwd));
-printf("Home directory: " STR_FMT "\n", STR_ARG(home));
+Arena arena = {0};
+TaskQueue queue = da_new(&arena);
+TaskQueue_push(&queue, task);
+Task next = TaskQueue_pop(&queue);
 ```
-*/
 
-#ifndef __CEBUS_OS_H__
-#define __CEBUS_OS_H__
+## Functions
 
-// #include "cebus/core/arena.h"
-// #include "cebus/core/defines.h"
-// #include "cebus/core/error.h"
+> :warning: `pop` and `peek` do not check if the heap is empty.
 
-////////////////////////////////////////////////////////////////////////////
+- `Name_push(heap, value)`: Adds a value.
+- `Name_pop(heap)`: Removes and returns the smallest value.
+- `Name_peek(heap)`: Returns the smallest value.
+- `Name_replace(heap, value)`: Removes the smallest value and adds a new one.
+Faster than a pop followed by a push.
+- `Name_heapify(heap)`: Turns the items of the dynamic array into a heap in
+linear time.
+- `Name_from(arena, count, items)`: Creates a heap from an array in linear time.
+Use `DA_ARG` to create it from an existing dynamic array.
 
-Str os_getenv(const char *env, Error *error);
-void os_mkdir(Path path);
-void os_mkdir_mode(Path path, u32 mode);
-void os_chdir(Path path);
-Path os_getcwd(Arena *arena);
+## Top-K
 
-////////////////////////////////////////////////////////////////////////////
+`Name_push_top_k(heap, k, value)` keeps the `k` biggest values pushed into the
+heap. The smallest of them is at the top, so a new value only has to be
+compared with it. Returns `true` if the value was kept.
 
-#endif /* !__CEBUS_OS_H__ */
+```c
+HEAP_DEFINE(Scores, u64, 2, *a < *b)
+Scores best = da_new(&arena);
+for (usize i = 0; i < count; i++) {
+  Scores_push_top_k(&best, 10, scores[i]);
+}
+```
+*/
 
-#ifndef __CEBUS_BOOL_H__
-#define __CEBUS_BOOL_H__
+#ifndef __CEBUS_HEAP_H__
+#define __CEBUS_HEAP_H__
 
+// #include "cebus/collection/da.h"
 // #include "cebus/core/defines.h"
 
-bool bool_toggle(bool b);
-
-bool bool_any(usize count, const bool *array);
-bool bool_all(usize count, const bool *array);
-
-#endif
-
-/* DOCUMENTATION
-## Features and Functions
-
-- **Creating Byte Arrays**:
-  - `BYTES`: Create a byte array from byte literals.
-  - `BYTES_STR`: Create a byte array from a string literal.
-
-- **Creating from Pointer and Size**:
-  - `bytes_from_parts(size, data)`: Creates a byte array from given size and
-data pointer.
+///////////////////////////////////////////////////////////////////////////////
 
-- **Copying Byte Arrays**:
-  - `bytes_copy(bytes, arena)`: Performs a deep copy of a byte array, allocating
-memory from the specified arena.
+#define Heap(T) DA(T)
 
-- **Slicing and Taking Bytes**:
-  - `bytes_slice(bytes, idx1, idx2)`: Returns a new byte array that is a slice
-from the original, from `idx1` to `idx2`.
-  - `bytes_take(bytes, count)`: Modifies the original byte array to keep only
-the first `count` bytes, returning the removed portion.
+#define HEAP_DEFINE(Name, T, ARITY, ...)                                                           \
+  typedef Heap(T) Name;                                                                            \
+                                                                                                   \
+  UNUSED static inline bool Name##_less(const T *a, const T *b) {                                  \
+    (void)a;                                                                                       \
+    (void)b;                                                                                       \
+    return (__VA_ARGS__);                                                                          \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_sift_up(Name *heap, usize idx) {                                       \
+    T value = heap->items[idx];                                                                    \
+    while (0 < idx) {                                                                              \
+      const usize parent = (idx - 1) / (ARITY);                                                    \
+      if (!Name##_less(&value, &heap->items[parent])) {                                            \
+        break;                                                                                     \
+      }                                                                                            \
+      heap->items[idx] = heap->items[parent];                                                      \
+      idx = parent;                                                                                \
+    }                                                                                              \
+    heap->items[idx] = value;                                                                      \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_sift_down(Name *heap, usize idx) {                                     \
+    const usize len = heap->len;                                                                   \
+    T *const items = heap->items;                                                                  \
+    T value = items[idx];                                                                          \
+    while (true) {                                                                                 \
+      const usize first = idx * (ARITY) + 1;                                                       \
+      if (len <= first) {                                                                          \
+        break;                                                                                     \
+      }                                                                                            \
+      const usize last = len - first < (ARITY) ? len : first + (ARITY);                            \
+      usize child = first;                                                                         \
+      for (usize i = first + 1; i < last; i++) {                                                   \
+        child = Name##_less(&items[i], &items[child]) ? i : child;                                 \
+      }                                                                                            \
+      if (!Name##_less(&items[child], &value)) {                                                   \
+        break;                                                                                     \
+      }                                                                                            \
+      items[idx] = items[child];                                                                   \
+      idx = child;                                                                                 \
+    }                                                                                              \
+    items[idx] = value;                                                                            \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_push(Name *heap, T value) {                                            \
+    da_push(heap, value);                                                                          \
+    Name##_sift_up(heap, heap->len - 1);                                                           \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static T Name##_peek(const Name *heap) { return heap->items[0]; }                         \
+                                                                                                   \
+  UNUSED static T Name##_pop(Name *heap) {                                                         \
+    const T top = heap->items[0];                                                                  \
+    heap->items[0] = heap->items[--heap->len];                                                     \
+    if (heap->len) {                                                                               \
+      Name##_sift_down(heap, 0);                                                                   \
+    }                                                                                              \
+    return top;                                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static T Name##_replace(Name *heap, T value) {                                            \
+    const T top = heap->items[0];                                                                  \
+    heap->items[0] = value;                                                                        \
+    Name##_sift_down(heap, 0);                                                                     \
+    return top;                                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_heapify(Name *heap) {                                                  \
+    for (usize i = heap->len / (ARITY) + 1; 0 < i; i--) {                                          \
+      if (i - 1 < heap->len) {                                                                     \
+        Name##_sift_down(heap, i - 1);                                                             \
+      }                                                                                            \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static Name Name##_from(Arena *arena, usize count, const T *items) {                      \
+    Name heap = da_new(arena);                                                                     \
+    da_extend(&heap, count, items);                                                                \
+    Name##_heapify(&heap);                                                                         \
+    return heap;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static bool Name##_push_top_k(Name *heap, usize k, T value) {                             \
+    if (heap->len < k) {                                                                           \
+      Name##_push(heap, value);                                                                    \
+      return true;                                                                                 \
+    }                                                                                              \
+    if (k == 0 || !Name##_less(&heap->items[0], &value)) {                                         \
+      return false;                                                                                \
+    }                                                                                              \
+    heap->items[0] = value;                                                                        \
+    Name##_sift_down(heap, 0);                                                                     \
+    return true;                                                                                   \
+  }
 
-- **Checking Equality**:
-  - `bytes_eq(b1, b2)`: Checks if two byte arrays are equal.
+///////////////////////////////////////////////////////////////////////////////
 
-- **Hexadecimal Conversion**:
-  - `bytes_to_hex(bytes, arena)`: Converts a byte array into a hexadecimal
-string representation, using memory from the arena.
-  - `bytes_from_hex(s, arena)`: Creates a byte array from a hexadecimal string,
-allocating memory from the arena.
+#endif /* !__CEBUS_HEAP_H__ */
+
+/* DOCUMENTATION
+`HyperLogLog` estimates the number of distinct hashes in a stream without
+storing them. With a precision of `p` it uses at most `2^p` bytes, the
+standard error of the estimate is about `1.04 / sqrt(2^p)`:
+
+| precision | memory   | error |
+|-----------|----------|-------|
+| 10        | 1 KiB    | 3.3%  |
+| 12        | 4 KiB    | 1.6%  |
+| 14        | 16 KiB   | 0.8%  |
+
+Like `Set` it works on precomputed `u64` hashes, for example from `str_hash` or
+`bytes_hash`.
+
+## Initialization
 
-## Usage
-Create new Bytes from a literal.
 ```c
-Bytes bytes = BYTES(0xff, 0x11);
-Bytes bytes_str = BYTES_STR("Bytes from a string");
+Arena arena = {0};
+HyperLogLog hll = hll_create(&arena, 12);
 ```
 
-Or from a pointer with size.
+- `hll_create`: Creates a new sketch. The precision has to be between
+`HLL_MIN_PRECISION` and `HLL_MAX_PRECISION`.
+- `hll_clear`: Removes all hashes.
+- `hll_copy`: Creates a copy of the sketch.
+
+Small sketches start in a sparse representation that only stores the
+registers that were set. It is exact enough for a few thousand distinct
+hashes and switches to the dense registers once it would need more memory
+than them.
+
+## Operations
+
+- `hll_add`: Adds a hash.
+- `hll_extend`: Adds multiple hashes at once.
+- `hll_merge`: Adds all hashes of another sketch with the same precision. Use
+it to combine the sketches of multiple threads or shards.
+- `hll_count`: Estimates the number of distinct hashes.
+
 ```c
-int a = 69;
-Bytes bytes = bytes_from_parts(sizeof(a), &a);
+for (usize i = 0; i < words.len; i++) {
+  hll_add(&hll, str_hash(words.items[i]));
+}
+printf("%" U64_FMT "\n", hll_count(&hll));
 ```
 
-if you need to take ownership of the bytes you can copy it.
-```c
-int a = 69;
-Bytes bytes = bytes_from_parts(sizeof(a), &a);
+## Serialization
+
+- `hll_serialize`: Writes the sketch into a byte array. The format does not
+depend on the platform.
+- `hll_deserialize`: Reads a sketch from a byte array. Emits `HLL_INVALID` if
+the data is not a valid sketch.
 
-Arena arena = {0};
-Bytes owned_bytes = bytes_copy(bytes, &arena);
-```
 */
 
-#ifndef __CEBUS_BYTES_H__
-#define __CEBUS_BYTES_H__
+#ifndef __CEBUS_HLL_H__
+#define __CEBUS_HLL_H__
 
 // #include "cebus/core/arena.h"
 // #include "cebus/core/defines.h"
+// #include "cebus/core/error.h"
 
-////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-Bytes bytes_from_parts(usize size, const void *data);
+#define HLL_MIN_PRECISION 4
+#define HLL_MAX_PRECISION 18
 
-////////////////////////////////////////////////////////////////////////////
+typedef enum {
+  HLL_OK,
+  HLL_INVALID,
+} HllError;
 
-Bytes bytes_copy(Bytes bytes, Arena *arena);
+typedef struct {
+  usize precision;
+  bool sparse;
+  usize len;
+  usize cap;
+  Arena *arena;
+  u32 *entries;
+  u8 *registers;
+} HyperLogLog;
 
-////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-Bytes bytes_slice(Bytes bytes, usize idx1, size_t idx2);
-Bytes bytes_take(Bytes *bytes, usize count);
+HyperLogLog hll_create(Arena *arena, usize precision);
 
-////////////////////////////////////////////////////////////////////////////
+void hll_clear(HyperLogLog *hll);
 
-bool bytes_eq(Bytes b1, Bytes b2);
-u64 bytes_hash(Bytes bytes);
+HyperLogLog hll_copy(Arena *arena, const HyperLogLog *hll);
 
-////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-Str bytes_to_hex(Bytes bytes, Arena *arena);
-Bytes bytes_from_hex(Str s, Arena *arena);
+void hll_add(HyperLogLog *hll, u64 hash);
+void hll_extend(HyperLogLog *hll, usize count, const u64 *hashes);
 
-////////////////////////////////////////////////////////////////////////////
+void hll_merge(HyperLogLog *hll, const HyperLogLog *other);
 
-#endif /* !__CEBUS_BYTES_H__ */
+u64 hll_count(const HyperLogLog *hll);
+
+//////////////////////////////////////////////////////////////////////////////
+
+Bytes hll_serialize(const HyperLogLog *hll, Arena *arena);
+HyperLogLog hll_deserialize(Bytes bytes, Arena *arena, Error *error);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_HLL_H__ */
 
 /* DOCUMENTATION
-## Character Classification Functions
+Lazy iterator pipelines. Chaining `da_filter` and `da_map` fills a whole
+intermediate array for every step. These macros expand into nested loops
+instead, so the whole pipeline runs as one loop over the source and nothing
+is allocated until the end of the pipeline.
 
-- `c_is_alnum(c)`: Checks if a character is alphanumeric.
-- `c_is_alpha(c)`: Checks if a character is alphabetic.
-- `c_is_lower(c)`: Checks if a character is lowercase.
-- `c_is_upper(c)`: Checks if a character is uppercase.
-- `c_is_space(c)`: Checks if a character is a whitespace character.
-- `c_is_cntrl(c)`: Checks if a character is a control character.
-- `c_is_print(c)`: Checks if a character is printable.
-- `c_is_graph(c)`: Checks if a character has a graphical representation.
-- `c_is_blank(c)`: Checks if a character is blank (space or tab).
-- `c_is_punct(c)`: Checks if a character is punctuation.
-- `c_is_digit(c)`: Checks if a character is a digit.
-- `c_is_xdigit(c)`: Checks if a character is a hexadecimal digit.
+Every pipeline starts with a source, followed by any number of adapters, and
+ends with a terminal or a normal statement:
 
-## Character Conversion Functions
+```c
+DA(usize) squares = da_new(&arena);
+it_da(usize, x, &numbers)
+  it_filter(x % 2 == 0)
+    it_map(usize, y, x * x)
+      it_take(10)
+        it_collect(&squares, y);
+```
 
-- `c_to_lower(c)`: Converts a character to lowercase.
-- `c_to_upper(c)`: Converts a character to uppercase.
-- `c_to_u8(c)`: Converts a character to an unsigned 8-bit integer.
-- `c_hex_to_u8(c)`: Converts a hexadecimal character to an unsigned 8-bit
-integer.
-- `c_u8_to_c(d)`: Converts an unsigned 8-bit integer to a character.
-- `c_u8_to_hex(d)`: Converts an unsigned 8-bit integer to a hexadecimal
-character (lowercase).
-- `c_u8_to_HEX(d)`: Converts an unsigned 8-bit integer to a hexadecimal
-character (uppercase).
+## Sources
+
+Each source declares the variable that holds the current element.
+
+- `it_da(T, x, list)`: Iterates over the elements of a dynamic array.
+- `it_range(T, x, begin, end)`: Iterates over the numbers in `[begin, end)`.
+- `it_split(x, str, delim)`: Iterates over the parts of a `Str` split by a
+character.
+- `it_fs(e, it)`: Iterates over the `FsEntity`s of a started `FsIter`. The
+entities are only valid for one iteration, see `fs_iter_next`.
+
+## Adapters
+
+- `it_map(U, y, expr)`: Declares `y` as the result of `expr`.
+- `it_filter(cond)`: Skips elements where `cond` is false.
+- `it_take(n)`: Stops the whole pipeline after `n` elements reached it. Only one
+`it_take` per pipeline.
+- `it_zip(U, y, list)`: Declares `y` as the next element of another dynamic
+array. Stops the pipeline when that array has no elements left. Only one
+`it_zip` per pipeline.
+
+## Terminals
+
+- `it_collect(list, value)`: Pushes the value into a dynamic array.
+- `it_fold(acc, expr)`: Assigns `expr` to the accumulator `acc`.
+- `it_count(n)`: Counts the elements.
+
+```c
+u64 sum = 0;
+it_split(line, content, '\n')
+  it_filter(line.len != 0)
+    it_fold(sum, sum + line.len);
+```
+
+> :warning: `break` inside of a pipeline only skips the current element. Use
+`it_take` to stop early.
 */
 
-#ifndef __CEBUS_CHAR_H__
-#define __CEBUS_CHAR_H__
+#ifndef __CEBUS_ITER_H__
+#define __CEBUS_ITER_H__
 
+// #include "cebus/collection/da.h"
 // #include "cebus/core/defines.h"
+// #include "cebus/os/fs.h"
+// #include "cebus/type/string.h"
 
 ///////////////////////////////////////////////////////////////////////////////
 
-CONST_FN bool c_is_alnum(char c);
-CONST_FN bool c_is_alpha(char c);
-CONST_FN bool c_is_lower(char c);
-CONST_FN bool c_is_upper(char c);
-CONST_FN bool c_is_space(char c);
-CONST_FN bool c_is_cntrl(char c);
-CONST_FN bool c_is_print(char c);
-CONST_FN bool c_is_graph(char c);
-CONST_FN bool c_is_blank(char c);
-CONST_FN bool c_is_punct(char c);
-CONST_FN bool c_is_digit(char c);
-CONST_FN bool c_is_xdigit(char c);
+// The state of the pipeline is declared by the source, so the adapters can
+// stop it.
+#define _IT_STATE __it_stop = 0, __it_taken = 0, __it_z = 0
+#define _IT_RUNNING ((void)__it_taken, (void)__it_z, !__it_stop)
+
+// Declares a variable for exactly one iteration.
+#define _it_let(T, x, expr)                                                                        \
+  for (int __it_once = 1; __it_once; __it_once = 0)                                               \
+    for (T x = (expr); (void)x, __it_once; __it_once = 0)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-CONST_FN char c_to_lower(char c);
-CONST_FN char c_to_upper(char c);
+#define it_da(T, x, list)                                                                          \
+  for (usize __it_i = 0, _IT_STATE; _IT_RUNNING && __it_i < da_len(list); __it_i++)               \
+  _it_let(T, x, da_get(list, __it_i))
 
-CONST_FN u8 c_to_u8(char c);
-CONST_FN u8 c_hex_to_u8(char c);
+#define it_range(T, x, begin, end)                                                                 \
+  for (usize _IT_STATE; _IT_RUNNING; __it_stop = 1)                                                \
+    for (T x = (begin); _IT_RUNNING && x < (end); x++)
 
-CONST_FN char c_u8_to_c(u8 d);
-CONST_FN char c_u8_to_hex(u8 d);
-CONST_FN char c_u8_to_HEX(u8 d);
+#define it_split(x, str, delim)                                                                    \
+  for (usize _IT_STATE; _IT_RUNNING; __it_stop = 1)                                                \
+    for (Str __it_s = (str), x = {0}; _IT_RUNNING && str_try_chop_by_delim(&__it_s, delim, &x);)
+
+#define it_fs(e, it)                                                                               \
+  for (usize _IT_STATE; _IT_RUNNING; __it_stop = 1)                                                \
+    while (_IT_RUNNING && fs_iter_next(it))                                                        \
+  _it_let(FsEntity, e, (it)->current)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#endif /* !__CEBUS_CHAR_H__ */
+#define it_map(U, y, expr) _it_let(U, y, expr)
 
-/* DOCUMENTATION
-## Functions
+#define it_filter(cond) if (cond)
 
-These functions are available for `f32` and `f64`.
+#define it_take(n)                                                                                 \
+  if (__it_taken + 1 <= (n) ? (++__it_taken == (n) ? (__it_stop = 1, 1) : 1) : (__it_stop = 1, 0))
 
-- `f32_eq(a, b)`: Tests if two `f32` are equal.
-- `f32_eq_eps(a, b)`: Tests if two `f32` are equal within a give epsilon.
-- `f32_isnan(value)`: Tests if `f32` is `nan`.
-- `f32_abs(value)`: Returns the absolute value.
-- `f32_min(a, b)`: Returns the min of `a` or `b`.
-- `f32_max(a, b)` Returns the max of `a` or b.
-- `f32_clamp(min, max, value)`: Clamps a `f32` between `min` and `max`.
-- `f32_lerp(min, max, value)`: Linear interpolation between `min` and `max`.
-- `f32_rad(deg)`: Converts degrees to radians.
-- `f32_deg(rad)`: Converts radians to degrees.
-*/
+#define it_zip(U, y, list)                                                                         \
+  for (int __it_once = 1; __it_once && (__it_z < da_len(list) || (__it_stop = 1, 0));             \
+       __it_once = 0)                                                                              \
+    for (U y = da_get(list, __it_z++); (void)y, __it_once; __it_once = 0)
 
-#ifndef __CEBUS_FLOATS_H__
-#define __CEBUS_FLOATS_H__
+///////////////////////////////////////////////////////////////////////////////
 
-// #include "cebus/core/defines.h"
+#define it_collect(list, value) da_push(list, value)
+#define it_fold(acc, expr) (acc) = (expr)
+#define it_count(n) (n)++
 
-#define FLOAT_DECL(T)                                                                              \
-  CONST_FN bool T##_eq(T a, T b);                                                                  \
-  CONST_FN bool T##_eq_eps(T a, T b, T epsilon);                                                   \
-  CONST_FN bool T##_isnan(T value);                                                                \
-  CONST_FN T T##_abs(T value);                                                                     \
-  CONST_FN T T##_min(T a, T b);                                                                    \
-  CONST_FN T T##_max(T a, T b);                                                                    \
-  CONST_FN T T##_clamp(T min, T max, T value);                                                     \
-  CONST_FN T T##_lerp(T min, T max, T value);                                                      \
-  CONST_FN T T##_rad(T deg);                                                                       \
-  CONST_FN T T##_deg(T rad);
+///////////////////////////////////////////////////////////////////////////////
 
-FLOAT_DECL(f32)
-FLOAT_DECL(f64)
+#endif /* !__CEBUS_ITER_H__ */
 
-#undef FLOAT_DECL
+/* DOCUMENTATION
+A ring buffer stores its elements in a power of two sized array, that wraps
+around at the end. Elements can be added and removed at both ends in constant
+time, so it works as a FIFO queue or a double ended queue. `Deque(T)` is the
+same type as `RingBuffer(T)`. Like `DA` the memory belongs to an `Arena`.
 
-#endif /* !__CEBUS_FLOATS_H__ */
+```c
+Arena arena = {0};
+RingBuffer(int) queue = rb_new(&arena);
+rb_push_back(&queue, 1);
+rb_push_back(&queue, 2);
+int first = rb_pop_front(&queue); // 1
+```
 
-/* DOCUMENTATION
+## Accessing Elements
 
-All these functions are defined for these types: `u8`, `i8`, `u16`, `i16`,
-`u32`, `i32`, `u64`, `i64`, `usize`.
+> :warning: These operations do not perform any bounds checks.
 
-## Bit Operations
+- `rb_get`: Get the element at an index, counted from the front.
+- `rb_front`, `rb_back`: Get the first or last element.
+- `rb_len`, `rb_empty`: Get the number of elements or check if there are
+none.
 
-- `T_reverse_bits(T value)`: Reverses the bits in `value`.
-- `T_leading_ones(T value)`: Counts the number of leading ones in `value`.
-- `T_trailing_ones(T value)`: Counts the number of trailing ones in `value`.
-- `T_leading_zeros(T value)`: Counts the number of leading zeros in `value`.
-- `T_trailing_zeros(T value)`: Counts the number of trailing zeros in `value`.
-- `T_count_zeros(T value)`: Counts the number of zeros in `value`.
-- `T_count_ones(T value)`: Counts the number of ones in `value`.
+## Adding and Removing
 
-## Byte Order Operations
+- `rb_push_back`, `rb_push_front`: Add an element at the back or front.
+- `rb_pop_back`, `rb_pop_front`: Remove and return the last or first element.
+- `rb_push_back_n`: Add `count` elements from an array at the back. Copies at
+most two spans.
+- `rb_pop_front_n`: Remove `count` elements from the front and copy them into
+an array. Copies at most two spans.
+- `rb_clear`: Remove all elements.
 
-- `T_swap_bytes(T value)`: Swaps the byte order of `value`.
-- `T_to_be(T value)`: Converts `value` to big endian format.
-- `T_from_be(T value)`: Converts `value` from big endian format.
-- `T_to_le(T value)`: Converts `value` to little endian format.
-- `T_from_le(T value)`: Converts `value` from little endian format.
-- `T_to_ne_bytes(T value)`: Converts `value` to native endian format.
+## Resizing and Reserving Space
 
-## Math Operations
+- `rb_reserve`: Ensure there is enough space for additional elements. The
+capacity is always a power of two. When it grows, the part that wrapped around
+is moved behind the old end, so the elements are contiguous again.
+*/
 
-Basic math operations including max, min, and clamp are provided.
+#ifndef __CEBUS_RING_BUFFER_H__
+#define __CEBUS_RING_BUFFER_H__
 
-- `T_max(T a, T b)`: Returns the maximum of `a` and `b`.
-- `T_min(T a, T b)`: Returns the minimum of `a` and `b`.
-- `T_clamp(T min, T max, T value)`: Clamps `value` between `min` and `max`.
+// #include "cebus/core/arena.h"   // IWYU pragma: export
+// #include "cebus/core/defines.h" // IWYU pragma: export
 
-## Utilities
+#include <string.h>
 
-- `T_hash(T value)`: Generates a hash for `value`.
-- `T_swap(T *v1, T *v2)`: Swaps the values of `v1` and `v2`.
-- `T_compare_lt(T a, T b)`: Compares `a` and `b` for less than.
-- `T_compare_gt(T a, T b)`: Compares `a` and `b` for greater than.
-- `T_compare_qsort(CmpOrdering ordering)`: Provides a comparison function
-suitable for `qsort`.
+///////////////////////////////////////////////////////////////////////////////
 
-*/
+#define RingBuffer(T)                                                                              \
+  struct {                                                                                         \
+    usize cap;                                                                                     \
+    usize len;                                                                                     \
+    usize head;                                                                                    \
+    Arena *arena;                                                                                  \
+    T *items;                                                                                      \
+  }
 
-#ifndef __CEBUS_INTEGERS_H__
-#define __CEBUS_INTEGERS_H__
+#define Deque(T) RingBuffer(T)
 
-// #include "cebus/core/arena.h"
-// #include "cebus/core/defines.h"
+#define RB_MIN_CAP 8
 
-#define INTEGER_DECL(T)                                                                            \
-  /* BIT OPERATIONS */                                                                             \
-  CONST_FN T T##_reverse_bits(T value);                                                            \
-  CONST_FN usize T##_leading_ones(T value);                                                        \
-  CONST_FN usize T##_trailing_ones(T value);                                                       \
-  CONST_FN usize T##_leading_zeros(T value);                                                       \
-  CONST_FN usize T##_trailing_zeros(T value);                                                      \
-  CONST_FN usize T##_count_zeros(T value);                                                         \
-  CONST_FN usize T##_count_ones(T value);                                                          \
-  /* BIT OPERATIONS END */                                                                         \
-                                                                                                   \
-  /* BYTE ORDER OPERATIONS */                                                                      \
-  CONST_FN T T##_swap_bytes(T value);                                                              \
-  /*  BIG ENDIAN OPERATIONS */                                                                     \
-  CONST_FN T T##_to_be(T value);                                                                   \
-  CONST_FN T T##_from_be(T value);                                                                 \
-  T T##_from_be_bytes(Bytes bytes);                                                                \
-  Bytes T##_to_be_bytes(T value, Arena *arena);                                                    \
-  /*  LITTLE ENDIAN OPERATIONS */                                                                  \
-  CONST_FN T T##_to_le(T value);                                                                   \
-  CONST_FN T T##_from_le(T value);                                                                 \
-  T T##_from_le_bytes(Bytes bytes);                                                                \
-  Bytes T##_to_le_bytes(T value, Arena *arena);                                                    \
-  /*  NATIVE ENDIAN OPERATIONS */                                                                  \
-  T T##_from_ne_bytes(Bytes bytes);                                                                \
-  Bytes T##_to_ne_bytes(T value, Arena *arena);                                                    \
-  /* BYTE ORDER OPERATIONS END */                                                                  \
-                                                                                                   \
-  /* MATH OPERATIONS */                                                                            \
-  CONST_FN T T##_max(T a, T b);                                                                    \
-  CONST_FN T T##_min(T a, T b);                                                                    \
-  CONST_FN T T##_clamp(T min, T max, T value);                                                     \
-  /* MATH OPERATIONS END */                                                                        \
-                                                                                                   \
-  /* UTILS */                                                                                      \
-  CONST_FN u64 T##_hash(T value);                                                                  \
-  void T##_swap(T *v1, T *v2);                                                                     \
-  CONST_FN CmpOrdering T##_compare_lt(T a, T b);                                                   \
-  CONST_FN CmpOrdering T##_compare_gt(T a, T b);                                                   \
-  CONST_FN CompareFn T##_compare_qsort(CmpOrdering ordering);                                      \
-  /* UTILS END */
+///////////////////////////////////////////////////////////////////////////////
 
-INTEGER_DECL(u8)
-INTEGER_DECL(i8)
-INTEGER_DECL(u16)
-INTEGER_DECL(i16)
-INTEGER_DECL(u32)
-INTEGER_DECL(i32)
-INTEGER_DECL(u64)
-INTEGER_DECL(i64)
-INTEGER_DECL(usize)
+#define _rb_idx(rb, idx) (((rb)->head + (idx)) & ((rb)->cap - 1))
 
-#undef INTEGER_DECL
+#define rb_get(rb, idx) (rb)->items[_rb_idx(rb, idx)]
+#define rb_front(rb) (rb)->items[(rb)->head]
+#define rb_back(rb) rb_get(rb, (rb)->len - 1)
+#define rb_empty(rb) (!(rb)->len)
+#define rb_len(rb) ((rb)->len)
 
-#endif /* !__CEBUS_INTEGERS_H__ */
+#define rb_clear(rb) ((rb)->len = 0, (rb)->head = 0)
 
-#ifndef __CEBUS_PATH_H__
-#define __CEBUS_PATH_H__
+///////////////////////////////////////////////////////////////////////////////
 
-// #include "cebus/collection/da.h"
-// #include "cebus/core/arena.h"
-// #include "cebus/core/defines.h" // IWYU pragma: export
+#define rb_new(_arena)                                                                             \
+  { .arena = (_arena), .items = NULL, }
 
-typedef DA(Path) PathDa;
+#define rb_reserve(rb, size)                                                                       \
+  do {                                                                                             \
+    const usize __rr_size = (rb)->len + (size);                                                    \
+    if (__rr_size <= (rb)->cap) {                                                                  \
+      break;                                                                                       \
+    }                                                                                              \
+    const usize __rr_old = (rb)->cap;                                                              \
+    usize __rr_cap = __rr_old == 0 ? RB_MIN_CAP : __rr_old;                                        \
+    while (__rr_cap < __rr_size) {                                                                 \
+      __rr_cap *= 2;                                                                               \
+    }                                                                                              \
+    (rb)->items = arena_realloc_chunk((rb)->arena, (rb)->items, __rr_cap * sizeof(*(rb)->items));  \
+    (rb)->cap = __rr_cap;                                                                          \
+    if (__rr_old < (rb)->head + (rb)->len) {                                                       \
+      memcpy(&(rb)->items[__rr_old], &(rb)->items[0],                                              \
+             ((rb)->head + (rb)->len - __rr_old) * sizeof(*(rb)->items));                          \
+    }                                                                                              \
+  } while (0)
 
-#define path_new(arena, ...)                                                                       \
-  path_join(arena, ARRAY_LEN((Path[]){__VA_ARGS__}), (Path[]){__VA_ARGS__})
+///////////////////////////////////////////////////////////////////////////////
 
-Path path_join(Arena *arena, usize size, Path *paths);
-Path path_join_da(Arena *arena, PathDa *da);
+#define rb_push_back(rb, ...)                                                                      \
+  do {                                                                                             \
+    rb_reserve(rb, 1);                                                                             \
+    rb_get(rb, (rb)->len) = (__VA_ARGS__);                                                         \
+    (rb)->len++;                                                                                   \
+  } while (0)
 
-Str path_name(Path path);
-Str path_suffix(Path path);
-Str path_stem(Path path);
-Path path_parent(Path path);
+#define rb_push_front(rb, ...)                                                                     \
+  do {                                                                                             \
+    rb_reserve(rb, 1);                                                                             \
+    (rb)->head = ((rb)->head - 1) & ((rb)->cap - 1);                                               \
+    (rb)->items[(rb)->head] = (__VA_ARGS__);                                                       \
+    (rb)->len++;                                                                                   \
+  } while (0)
 
-// TODO
-// keep it io-less. i want a "pure" path api
-// TODO: operating system dependent delimiter
-// bool path_relative(Path path);
-// bool path_absolute(Path path);
-// bool path_relative_to(Path p1, Path p2);
-// Path path_resolve(Path path);
-// void path_collect_parts(Path path, PathDa* da);
-// void path_collect_parents(Path path, PathDa* da);
+#define rb_pop_back(rb) ((rb)->len--, rb_get(rb, (rb)->len))
 
-#endif /* !__CEBUS_PATH_H__ */
+#define rb_pop_front(rb)                                                                           \
+  ((rb)->len--, (rb)->head = _rb_idx(rb, 1), (rb)->items[((rb)->head - 1) & ((rb)->cap - 1)])
 
-/* DOCUMENTATION
-## Features and Functions
-- **String Creation and Printing**:
-  - `STR("Hello World")`: Create a new string from a string literal.
-  - `STR_STATIC("Hello")`: Create a new static string from a string literal.
-  - `str_from_cstr(str)`: Create new string from a char array.
-  - `str_from_bytes(str)`: Create new string from bytes.
-  - `str_format(fmt, ...)`: Create new string as formated.
-  - `printf(STR_FMT"\n", STR_ARG(str))`: Print strings using macros.
+///////////////////////////////////////////////////////////////////////////////
 
-- **String Manipulation**:
-  - `str_lower(str, &arena)`, `str_upper(str, &arena)`: Convert to lower or
-upper case.
-  - `str_append(str, suffix, &arena)`, `str_prepend(str, prefix, &arena)`:
-Append or prepend strings.
-  - `str_wrap(str, wrap, &arena)`: Wrap a string.
-  - `str_join(sep, count, strs, &arena)`: Join strings with a separator.
+#define rb_push_back_n(rb, count, array)                                                           \
+  do {                                                                                             \
+    const usize __rp_count = (count);                                                              \
+    if (__rp_count == 0) {                                                                         \
+      break;                                                                                       \
+    }                                                                                              \
+    rb_reserve(rb, __rp_count);                                                                    \
+    const usize __rp_tail = _rb_idx(rb, (rb)->len);                                                \
+    const usize __rp_first =                                                                       \
+        __rp_count < (rb)->cap - __rp_tail ? __rp_count : (rb)->cap - __rp_tail;                   \
+    memcpy(&(rb)->items[__rp_tail], &(array)[0], __rp_first * sizeof(*(rb)->items));               \
+    if (__rp_first < __rp_count) {                                                                 \
+      memcpy(&(rb)->items[0], &(array)[__rp_first],                                                \
+             (__rp_count - __rp_first) * sizeof(*(rb)->items));                                    \
+    }                                                                                              \
+    (rb)->len += __rp_count;                                                                       \
+  } while (0)
 
-- **String Trimming and Slicing**:
-  - `str_trim(str)`, `str_trim_left(str)`, `str_trim_right(str)`: Trim
-whitespace.
-  - `str_chop_by_delim(str, delim)`, `str_try_chop_by_delim(str, delim,
-&chunk)`: Chop strings by delimiter.
-  - `str_substring(str, start, end)`: Extract a substring.
+#define rb_pop_front_n(rb, count, array)                                                           \
+  do {                                                                                             \
+    const usize __rp_count = (count);                                                              \
+    if (__rp_count == 0) {                                                                         \
+      break;                                                                                       \
+    }                                                                                              \
+    const usize __rp_first =                                                                       \
+        __rp_count < (rb)->cap - (rb)->head ? __rp_count : (rb)->cap - (rb)->head;                 \
+    memcpy(&(array)[0], &(rb)->items[(rb)->head], __rp_first * sizeof(*(rb)->items));              \
+    if (__rp_first < __rp_count) {                                                                 \
+      memcpy(&(array)[__rp_first], &(rb)->items[0],                                                \
+             (__rp_count - __rp_first) * sizeof(*(rb)->items));                                    \
+    }                                                                                              \
+    (rb)->head = _rb_idx(rb, __rp_count);                                                          \
+    (rb)->len -= __rp_count;                                                                       \
+  } while (0)
 
-- **String Comparison and Search**:
-  - `str_eq(s1, s2)`, `str_eq_ignorecase(s1, s2)`: Check string equality.
-  - `str_startswith(str, prefix)`, `str_endswith(str, suffix)`: Check
-prefixes/suffixes.
-  - `str_contains(haystack, needle)`: Check if string contains a substring.
+///////////////////////////////////////////////////////////////////////////////
 
-- **Conversion and Utility**:
-  - `str_to_u64(str)`, `str_u64(n, &arena)`: Convert between strings and
-unsigned 64-bit integers.
-  - `str_hash(str)`: Generate a hash value for a string.
+#endif /* !__CEBUS_RING_BUFFER_H__ */
 
-## Usage Example
+/* DOCUMENTATION
+A segmented array stores its elements in segments that double in size:
+16, 32, 64, ... elements. Growing allocates a new segment instead of
+reallocating, so elements are never copied and pointers to them stay valid
+until the arena is freed.
 
 ```c
 Arena arena = {0};
-Str greeting = STR("Hello World");
-Str lower = str_lower(greeting, &arena);
-printf(STR_FMT"\n", STR_ARG(lower));
+SEG(Node) nodes = seg_new(&arena);
+seg_push(&nodes, ((Node){.id = 1}));
+Node *node = &seg_get(&nodes, 0); // stays valid
 ```
-*/
 
-#ifndef __CEBUS_STR_H__
-#define __CEBUS_STR_H__
+## Accessing Elements
 
-// #include "cebus/core/arena.h"
-// #include "cebus/core/defines.h" // IWYU pragma: private: include "str.h"
+> :warning: These operations do not perform any bounds checks. `seg_get`
+evaluates the index more than once.
 
-///////////////////////////////////////////////////////////////////////////////
+- `seg_get`: Get any element. Finding the segment of an index costs one count
+leading zeros instruction.
+- `seg_first`, `seg_last`: Get the first or last element.
+- `seg_pop`: Remove and return the last element.
+- `seg_len`, `seg_empty`: Get the number of elements or check if there are
+none.
 
-#define STR_NOT_FOUND SIZE_MAX
+## Adding Elements
 
-#define STR_LETTERS STR("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz")
-#define STR_UPPERCASE STR("ABCDEFGHIJKLMNOPQRSTUVWXYZ")
-#define STR_LOWERCASE STR("abcdefghijklmnopqrstuvwxyz")
-#define STR_DIGITS STR("0123456789")
-#define STR_HEXDIGITS STR("0123456789abcdefABCDEF")
-#define STR_PUNCTUATION STR("!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~")
-#define STR_WHITESPACE STR(" \t\n\r\x0b\x0c")
+- `seg_push`: Add an element.
+- `seg_extend`: Add multiple elements from an array.
+- `seg_reserve`: Allocate the segments for additional elements.
+- `seg_clear`: Remove all elements. Keeps the segments for reuse.
 
-///////////////////////////////////////////////////////////////////////////////
+## Iteration
 
-Str str_from_parts(usize size, const char *cstr);
-Str str_from_bytes(Bytes bytes);
-Bytes str_to_bytes(Str s);
-Str str_from_cstr(const char *cstr);
-FMT(2) Str str_format(Arena *arena, const char *fmt, ...);
+`seg_for_each` walks over the elements one segment at a time with a pointer,
+which is as fast as iterating over a dynamic array:
 
-///////////////////////////////////////////////////////////////////////////////
+```c
+seg_for_each(Node *, node, &nodes) {
+  node->visited = false;
+}
+```
 
-Str str_copy(Str s, Arena *arena);
-Str str_append(Str s1, Str suffix, Arena *arena);
-Str str_prepend(Str s1, Str prefix, Arena *arena);
-Str str_wrap(Str s, Str wrap, Arena *arena);
+> :warning: `break` only leaves the current segment.
+*/
 
-// Inserts sep in between elements
-Str str_join(Str sep, usize count, Str *s, Arena *arena);
-// Appends suffix to every element
-Str str_join_suffix(Str suffix, usize count, Str *s, Arena *arena);
-// Prepends prefix to every element
-Str str_join_prefix(Str prefix, usize count, Str *s, Arena *arena);
+#ifndef __CEBUS_SEG_ARRAY_H__
+#define __CEBUS_SEG_ARRAY_H__
 
-Str str_join_wrap(Str sep, Str wrap, usize count, Str *s, Arena *arena);
+// #include "cebus/core/arena.h"    // IWYU pragma: export
+// #include "cebus/core/defines.h"  // IWYU pragma: export
+// #include "cebus/core/platform.h" // IWYU pragma: export
+// #include "cebus/type/integer.h"  // IWYU pragma: export
 
-Str str_upper(Str s, Arena *arena);
-Str str_lower(Str s, Arena *arena);
-Str str_replace(Str s, Str old, Str new, Arena *arena);
-Str str_center(Str s, usize width, char fillchar, Arena *arena);
-Str str_ljust(Str s, usize width, char fillchar, Arena *arena);
-Str str_rjust(Str s, usize width, char fillchar, Arena *arena);
-Str str_repeat(Str s, usize count, Arena *arena);
-Str str_reverse(Str s, Arena *arena);
+#include <string.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
-bool str_eq(Str s1, Str s2);
-bool str_eq_ignorecase(Str s1, Str s2);
-bool str_startswith(Str s1, Str prefix);
-bool str_endswith(Str s1, Str suffix);
-
-bool str_contains(Str haystack, Str needle);
-bool str_includes(Str haystack, char needle);
-bool str_empty(Str s);
-CmpOrdering str_compare_gt(Str s1, Str s2);
-CmpOrdering str_compare_lt(Str s1, Str s2);
+// The first segment holds 2^SEG_FIRST_BITS elements.
+#define SEG_FIRST_BITS 4
+#define SEG_FIRST ((usize)1 << SEG_FIRST_BITS)
+#define SEG_MAX_SEGMENTS 48
 
-// Returns function that you can pass to qsort
-CompareFn str_compare_qsort(CmpOrdering ordering);
+#define SEG(T)                                                                                     \
+  struct {                                                                                         \
+    usize cap;                                                                                     \
+    usize len;                                                                                     \
+    Arena *arena;                                                                                  \
+    T *segments[SEG_MAX_SEGMENTS];                                                                 \
+  }
 
 ///////////////////////////////////////////////////////////////////////////////
 
-Str str_trim_left(Str s);
-Str str_trim_left_by_delim(Str s, char delim);
-Str str_trim_left_by_predicate(Str s, bool (*predicate)(char));
-
-Str str_trim_right(Str s);
-Str str_trim_right_by_delim(Str s, char delim);
-Str str_trim_right_by_predicate(Str s, bool (*predicate)(char));
-
-Str str_trim(Str s);
-Str str_trim_by_delim(Str s, char delim);
-Str str_trim_by_predicate(Str s, bool (*predicate)(char));
+#if defined(GCC) || defined(CLANG)
+#define _seg_log2(x) ((usize)(63 - __builtin_clzll((unsigned long long)(x))))
+#else
+#define _seg_log2(x) (63 - u64_leading_zeros((u64)(x)))
+#endif
 
-bool str_try_chop_by_delim(Str *s, char delim, Str *chunk);
-Str str_chop_by_delim(Str *s, char delim);
-bool str_try_chop_by_predicate(Str *s, bool (*predicate)(char), Str *chunk);
-Str str_chop_by_predicate(Str *s, bool (*predicate)(char));
-Str str_chop_right_by_delim(Str *s, char delim);
-Str str_chop_right_by_predicate(Str *s, bool (*predicate)(char));
-Str str_take(Str *s, usize count);
-bool str_try_take(Str *s, usize count, Str *chunk);
-Str str_take_right(Str *s, usize count);
-bool str_try_take_right(Str *s, usize count, Str *chunk);
+// Segment 'k' holds the indices [SEG_FIRST * (2^k - 1), SEG_FIRST * (2^(k+1) - 1)).
+#define _seg_segment(idx) (_seg_log2((idx) + SEG_FIRST) - SEG_FIRST_BITS)
+#define _seg_offset(idx) ((idx) + SEG_FIRST - (SEG_FIRST << _seg_segment(idx)))
 
-Str str_substring(Str s, usize start, usize end);
+#define _seg_grow(list)                                                                            \
+  do {                                                                                             \
+    const usize __sg_k = _seg_segment((list)->cap);                                                \
+    (list)->segments[__sg_k] =                                                                     \
+        arena_alloc_chunk((list)->arena, (SEG_FIRST << __sg_k) * sizeof(*(list)->segments[0]));    \
+    (list)->cap += SEG_FIRST << __sg_k;                                                            \
+  } while (0)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-u64 str_u64(Str s);
-u64 str_chop_u64(Str *s);
+#define seg_new(_arena)                                                                            \
+  { .arena = (_arena), }
 
-i64 str_i64(Str s);
-i64 str_chop_i64(Str *s);
+#define seg_get(list, idx) (list)->segments[_seg_segment(idx)][_seg_offset(idx)]
+#define seg_first(list) (list)->segments[0][0]
+#define seg_last(list) seg_get(list, (list)->len - 1)
+#define seg_pop(list) ((list)->len--, seg_get(list, (list)->len))
+#define seg_empty(list) (!(list)->len)
+#define seg_len(list) ((list)->len)
 
-f64 str_f64(Str s);
-f64 str_chop_f64(Str *s);
+#define seg_clear(list) ((list)->len = 0)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-// Returns 'STR_NOT_FOUND' if 'needle' was not found.
-usize str_find(Str haystack, Str needle);
-// Returns 'STR_NOT_FOUND' if 'needle' was not found.
-usize str_find_last(Str haystack, Str needle);
-usize str_count(Str haystack, Str needle);
-// Returns '\0' if the index is out of bounds.
-char str_getc(Str s, usize idx);
+#define seg_reserve(list, size)                                                                    \
+  do {                                                                                             \
+    const usize __sr_size = (list)->len + (size);                                                  \
+    while ((list)->cap < __sr_size) {                                                              \
+      _seg_grow(list);                                                                             \
+    }                                                                                              \
+  } while (0)
 
-// Basic FNV hash.
-u64 str_hash(Str s);
+#define seg_push(list, ...)                                                                        \
+  do {                                                                                             \
+    if ((list)->len == (list)->cap) {                                                              \
+      _seg_grow(list);                                                                             \
+    }                                                                                              \
+    const usize __sp_i = (list)->len++;                                                            \
+    seg_get(list, __sp_i) = (__VA_ARGS__);                                                         \
+  } while (0)
+
+// Copies the array one segment at a time.
+#define seg_extend(list, count, ...)                                                               \
+  do {                                                                                             \
+    const usize __se_count = (count);                                                              \
+    seg_reserve(list, __se_count);                                                                 \
+    for (usize __se_i = 0; __se_i < __se_count;) {                                                 \
+      const usize __se_idx = (list)->len;                                                          \
+      const usize __se_k = _seg_segment(__se_idx);                                                 \
+      const usize __se_off = _seg_offset(__se_idx);                                                \
+      const usize __se_n = usize_min((SEG_FIRST << __se_k) - __se_off, __se_count - __se_i);       \
+      memcpy(&(list)->segments[__se_k][__se_off], &(__VA_ARGS__)[__se_i],                          \
+             __se_n * sizeof(*(list)->segments[0]));                                               \
+      (list)->len += __se_n;                                                                       \
+      __se_i += __se_n;                                                                            \
+    }                                                                                              \
+  } while (0)
 
 ///////////////////////////////////////////////////////////////////////////////
 
-#endif /* !__CEBUS_STR_H__ */
+#define seg_for_each(T, iter, list)                                                                \
+  for (usize __sf_k = 0, __sf_i = 0, __sf_n = 0;                                                   \
+       __sf_i < (list)->len &&                                                                     \
+       (__sf_n = usize_min(SEG_FIRST << __sf_k, (list)->len - __sf_i), true);                      \
+       __sf_i += SEG_FIRST << __sf_k++)                                                            \
+    for (T iter = (list)->segments[__sf_k]; iter < (list)->segments[__sf_k] + __sf_n; iter++)
 
-#ifndef __CEBUS_UTF8_H__
-#define __CEBUS_UTF8_H__
+///////////////////////////////////////////////////////////////////////////////
 
-// #include "cebus/core/arena.h"
-// #include "cebus/core/defines.h" // IWYU pragma: private: include "utf8.h"
-// #include "cebus/core/error.h"
+#endif /* !__CEBUS_SEG_ARRAY_H__ */
 
-typedef enum {
-  UTF8_OK,
-  UTF8_DECODE,
-  UTF8_ENCODE,
-} Utf8Error;
+/* DOCUMENTATION
+My `Set` implementation follows the same principle as my `HashMap`: it stores
+only the hashes for lookup. This means you get efficient way to check
+if something is in the set without the overhead of storing the actual elements.
+It’s pretty handy for cases where you just need to keep track of existence
+rather than the elements themselves.
 
-Utf8 utf8_decode(Bytes bytes, Error *error);
-Bytes utf8_encode(Utf8 s, Error *error);
+## Initialization
 
-bool utf8_eq(Utf8 s1, Utf8 s2);
-bool utf8_starts_with(Utf8 s, Utf8 prefix);
-bool utf8_ends_with(Utf8 s, Utf8 suffix);
+To start using the set, you need to initialize an `Arena` and create a new set:
 
-bool utf8_try_next(Utf8 *str, Utf8 *out);
-Utf8 utf8_next(Utf8 *str);
+```c
+Arena arena = {0};
+Set set = set_create(&arena);
+```
 
-Utf8 utf8_copy(Utf8 str, Arena *arena);
-Utf8 utf8_append(Utf8 s, Utf8 suffix, Arena *arena);
-Utf8 utf8_prepend(Utf8 s, Utf8 prefix, Arena *arena);
-Utf8 utf8_join(Utf8 sep, usize count, Utf8 *s, Arena *arena);
-Utf8 utf8_upper(Utf8 s, Arena *arena);
-Utf8 utf8_lower(Utf8 s, Arena *arena);
-// Utf8 utf8_replace(Utf8 s, Utf8 old, Utf8 new, Arena *arena);
-// Utf8 utf8_center(Utf8 s, usize width, char fillchar, Arena *arena);
-// Utf8 utf8_ljust(Utf8 s, usize width, char fillchar, Arena *arena);
-// Utf8 utf8_rjust(Utf8 s, usize width, char fillchar, Arena *arena);
-// Utf8 utf8_repeat(Utf8 s, usize count, Arena *arena);
-// Utf8 utf8_reverse(Utf8 s, Arena *arena);
+## Set Operations
 
-bool utf8_validate_bytes(Bytes s);
-bool utf8_validate(Utf8 s);
+Perform basic set operations such as adding, removing, and extending sets with
+multiple elements:
 
-#endif /* !__CEBUS_UTF8_H__ */
+- `set_add`: Add an element to the set. Returns false if the element already
+exists.
+- `set_remove`: Remove an element from the set.
+- `set_extend`: Add multiple elements to the set at once.
 
+Copy and resize sets for handling dynamic set sizes:
 
-#ifdef CEBUS_IMPLEMENTATION
-/* this is needed so clangd does not report errors in single header */
-#if defined(__clang__)
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Weverything"
-#endif /* !__clang__ */
-// #include "hashmap.h"
+- `set_copy`: Create a duplicate of a set.
+- `set_resize`: Adjust the capacity of the set. Used for preallocating
+space.
+- `set_reserve`: Reserves space in the set. Used before adding multiple
+elements
 
-// #include "cebus/core/debug.h"
-// #include "cebus/core/defines.h"
-// #include "cebus/type/integer.h"
 
-#include <stdio.h>
-#include <string.h>
+## Set Query Operations
 
-////////////////////////////////////////////////////////////////////////////
+Query the set for the presence of elements, equality with another set, or subset
+and disjoint relationships:
 
-#define HM_TYPES(DO)                                                                               \
-  DO(f32)                                                                                          \
-  DO(f64)                                                                                          \
-  DO(i8)                                                                                           \
-  DO(u8)                                                                                           \
-  DO(i16)                                                                                          \
-  DO(u16)                                                                                          \
-  DO(i32)                                                                                          \
-  DO(u32)                                                                                          \
-  DO(i64)                                                                                          \
-  DO(u64)                                                                                          \
-  DO(usize)
+- `set_contains`: Check if an element is in the set.
+- `set_eq`: Check if two sets are equal.
+- `set_subset`: Determine if one set is a subset of another.
+- `set_disjoint`: Determine if two sets have no elements in common.
 
-#define HM_DECLARE_ENUM(T) HM_TYPE_##T,
+## Set Algebraic Operations
 
-typedef enum { HM_NONE, HM_PTR, HM_CONST_PTR, HM_TYPES(HM_DECLARE_ENUM) } HashTypes;
+Combine sets or find their differences using algebraic set operations:
 
-#undef HM_DECLARE_ENUM
+- `set_intersection`: Find the intersection of two sets.
+- `set_difference`: Find the difference between two sets.
+- `set_union`: Combine two sets into a union.
 
-#define HM_DECLARE_MEMBER(T) T T;
+## Sorted Members
 
-typedef struct {
-  union {
-    void *ptr;
-    const void *const_ptr;
-    HM_TYPES(HM_DECLARE_MEMBER)
-  } as;
-} HashValue;
+Large sets of similar size are not compared by probing one table with the
+members of the other. Both sets are radix sorted into `u64` arrays and merged
+instead, which reads memory sequentially. Sets that are small or very
+different in size still use the hash lookups.
 
-#undef HM_DECLARE_MEMBER
+- `set_sorted`: Get the members of the set as a sorted array with `count`
+elements, allocated in the arena.
 
-typedef struct {
-  u64 key;
-  HashValue value;
-} HashNode;
+```c
+u64 *members = set_sorted(&set, &arena);
+for (usize i = 0; i < set.count; i++) {
+  printf("%" U64_HEX "\n", members[i]);
+}
+```
+*/
 
-struct HashMap {
-  HashTypes type;
+#ifndef __CEBUS_SET_H__
+#define __CEBUS_SET_H__
+
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
   usize cap;
   usize count;
   usize deleted;
   Arena *arena;
-  HashNode *nodes;
-};
+  u64 *items;
+} Set;
 
-////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
 
-#define HM_DEFAULT_SIZE 8
-#define HM_DELETED_HASH ((u64)0xdeaddeaddeaddead)
+Set set_create(Arena *arena);
+Set set_with_size(Arena *arena, usize size);
 
-////////////////////////////////////////////////////////////////////////////
+void set_clear(Set *set);
 
-static bool hm_insert(HashMap *hm, u64 hash, HashValue value) {
-  if (hash == 0 || hash == HM_DELETED_HASH) {
-    hash = u64_hash(hash);
-  }
-  if (hm->cap <= hm->count + hm->deleted) {
-    hm_resize(hm, hm->cap * 2);
-  }
+Set set_copy(Arena *arena, Set *set);
 
-  while (true) {
-    usize idx = hash % hm->cap;
+void set_resize(Set *set, usize size);
+void set_reserve(Set *set, usize size);
 
-    for (usize i = 0; i < hm->cap; i++) {
-      if (!hm->nodes[idx].key) {
-        hm->nodes[idx] = (HashNode){.key = hash, .value = value};
-        hm->count++;
-        return true;
-      }
-      if (hm->nodes[idx].key == hash) {
-        hm->nodes[idx].value = value;
-        return false;
-      }
-      idx = (idx + i * i) % hm->cap;
-    }
+u64 *set_sorted(const Set *set, Arena *arena);
 
-    hm_resize(hm, hm->cap * 2);
-  }
-}
+///////////////////////////////////////////////////////////////////////////////
 
-static HashValue *hm_get(const HashMap *hm, u64 hash) {
-  if (hm->count == 0) {
-    return NULL;
-  }
-  if (hash == 0 || hash == HM_DELETED_HASH) {
-    hash = u64_hash(hash);
-  }
+bool set_add(Set *set, u64 hash);
+void set_extend(Set *set, usize count, const u64 *hashes);
+void set_update(Set *dest, const Set *set);
 
-  usize idx = hash % hm->cap;
-  for (usize i = 0; i < hm->cap; i++) {
-    if (hm->nodes[idx].key == 0) {
-      return NULL;
-    }
-    if (hm->nodes[idx].key == hash) {
-      return &hm->nodes[idx].value;
-    }
-    idx = (idx + i * i) % hm->cap;
-  }
-  return NULL;
-}
+bool set_remove(Set *set, u64 hash);
 
-static const char *hm_type(HashTypes type) {
-#define RETURN_STR(T)                                                                              \
-  case HM_TYPE_##T:                                                                                \
-    return #T;
+//////////////////////////////////////////////////////////////////////////////
 
-  switch (type) {
-  case HM_PTR:
-    return "HM_PTR";
-  case HM_CONST_PTR:
-    return "HM_CONST_PTR";
-  case HM_NONE:
-    return "HM_NONE";
+bool set_contains(const Set *set, u64 hash);
+bool set_eq(const Set *set, const Set *other);
+bool set_subset(const Set *set, const Set *other);
+bool set_disjoint(const Set *set, const Set *other);
 
-    HM_TYPES(RETURN_STR)
-  }
+///////////////////////////////////////////////////////////////////////////////
 
-  UNREACHABLE();
-#undef RETURN_STR
-}
+Set set_intersection(const Set *set, const Set *other, Arena *arena);
+Set set_difference(const Set *set, const Set *other, Arena *arena);
+Set set_union(const Set *set, const Set *other, Arena *arena);
 
-////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
 
-HashMap *hm_create(Arena *arena) {
-  HashMap *hm = arena_calloc(arena, sizeof(HashMap));
-  hm->type = HM_NONE;
-  hm->arena = arena;
-  return hm;
-}
+#endif /* !__CEBUS_SET_H__ */
 
-HashMap *hm_with_size(Arena *arena, usize size) {
-  HashMap *hm = arena_calloc(arena, sizeof(HashMap));
-  hm->type = HM_NONE;
-  hm->arena = arena;
-  hm->cap = usize_max(size, HM_DEFAULT_SIZE);
-  hm->nodes = arena_calloc_chunk(arena, hm->cap * sizeof(hm->nodes[0]));
-  return hm;
-}
+/* DOCUMENTATION
+A structure of arrays stores every field of a record in its own column. A loop
+that only reads one field then only loads that column into the cache instead
+of the whole records, and the compiler can vectorize it.
 
-void hm_clear(HashMap *hm) {
-  hm->type = HM_NONE;
-  hm->count = 0;
-  memset(hm->nodes, 0, hm->cap * sizeof(hm->nodes[0]));
-}
+The fields are given as a list macro, that calls `X(T, name)` for every field.
+`SOA_DEFINE(Name, FIELDS)` defines the type `Name` with one column per field,
+the type `NameRow` with one member per field and the functions.
 
-HashMap *hm_copy(HashMap *hm, Arena *arena) {
-  HashMap *new = hm_with_size(arena, hm->count * 2);
-  new->type = hm->type;
-  for (size_t i = 0; i < hm->cap; i++) {
-    if (hm->nodes[i].key && hm->nodes[i].key != HM_DELETED_HASH) {
-      hm_insert(new, hm->nodes[i].key, hm->nodes[i].value);
-    }
-  }
-  return new;
+```c
+#define WORD_COUNT_FIELDS(X) X(Str, word) X(usize, count)
+SOA_DEFINE(WordCounts, WORD_COUNT_FIELDS)
+
+Arena arena = {0};
+WordCounts counts = soa_new(&arena);
+WordCounts_push(&counts, (WordCountsRow){.word = STR("hello"), .count = 1});
+
+usize total = 0;
+for (usize i = 0; i < soa_len(&counts); i++) {
+  total += counts.count[i];
 }
+```
 
-void hm_resize(HashMap *hm, usize size) {
-  if (size < hm->cap) {
-    return;
-  }
-  usize old_cap = hm->cap;
-  HashNode *old_nodes = hm->nodes;
+## Columns
 
-  hm->cap = size == 0 ? HM_DEFAULT_SIZE : size;
-  hm->nodes = arena_calloc_chunk(hm->arena, hm->cap * sizeof(hm->nodes[0]));
+Every column is a pointer with the name of the field, that can be used
+directly: `counts.count[i]`. Like `DA` the columns belong to the arena and are
+reallocated when they grow, so do not keep pointers into them.
 
-  hm->count = 0;
-  hm->deleted = 0;
-  for (usize i = 0; i < old_cap; ++i) {
-    if (old_nodes[i].key && hm->nodes[i].key != HM_DELETED_HASH) {
-      hm_insert(hm, old_nodes[i].key, old_nodes[i].value);
-    }
-  }
-  arena_free_chunk(hm->arena, old_nodes);
-}
+- `soa_new`: Initializer.
+- `soa_len`, `soa_empty`: Get the number of rows or check if there are none.
+- `soa_clear`: Removes all rows.
 
-void hm_reserve(HashMap *hm, usize size) {
-  const usize required_size = hm->count + size;
-  if (required_size < hm->cap) {
-    return;
-  }
-  usize new_size = hm->cap == 0 ? HM_DEFAULT_SIZE : hm->cap;
-  while (new_size < required_size) {
-    new_size *= 2;
-  }
-  hm_resize(hm, new_size);
-}
+## Functions
 
-void hm_update(HashMap *hm, HashMap *other) {
-  hm_reserve(hm, other->count);
-  for (usize i = 0; i < other->cap; ++i) {
-    if (other->nodes[i].key && other->nodes[i].key != HM_DELETED_HASH) {
-      hm_insert(hm, other->nodes[i].key, other->nodes[i].value);
-    }
-  }
-}
+> :warning: These operations do not perform any bounds checks.
 
-bool hm_remove(HashMap *hm, u64 hash) {
-  if (hm->count == 0) {
-    return false;
-  }
-  if (hash == 0 || hash == HM_DELETED_HASH) {
-    hash = u64_hash(hash);
+- `Name_reserve(soa, size)`: Ensures there is enough space for `size`
+additional rows in every column.
+- `Name_push(soa, row)`: Adds a row.
+- `Name_get(soa, idx)`: Gathers the row at an index.
+- `Name_set(soa, idx, row)`: Overwrites the row at an index.
+- `Name_swap_remove(soa, idx)`: Removes a row by replacing it with the last
+one.
+*/
+
+#ifndef __CEBUS_SOA_H__
+#define __CEBUS_SOA_H__
+
+// #include "cebus/core/arena.h"   // IWYU pragma: export
+// #include "cebus/core/defines.h" // IWYU pragma: export
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define _SOA_COLUMN(T, name) T *name;
+#define _SOA_MEMBER(T, name) T name;
+#define _SOA_RESIZE(T, name)                                                                       \
+  soa->name = arena_realloc_chunk(soa->arena, soa->name, cap * sizeof(T));
+#define _SOA_SET(T, name) soa->name[idx] = row.name;
+#define _SOA_GET(T, name) row.name = soa->name[idx];
+#define _SOA_MOVE_LAST(T, name) soa->name[idx] = soa->name[soa->len];
+
+#define SOA_DEFINE(Name, FIELDS)                                                                   \
+  typedef struct {                                                                                 \
+    FIELDS(_SOA_MEMBER)                                                                            \
+  } Name##Row;                                                                                     \
+                                                                                                   \
+  typedef struct {                                                                                 \
+    usize cap;                                                                                     \
+    usize len;                                                                                     \
+    Arena *arena;                                                                                  \
+    FIELDS(_SOA_COLUMN)                                                                            \
+  } Name;                                                                                          \
+                                                                                                   \
+  UNUSED static void Name##_reserve(Name *soa, usize size) {                                       \
+    const usize needed = soa->len + size;                                                          \
+    if (needed <= soa->cap) {                                                                      \
+      return;                                                                                      \
+    }                                                                                              \
+    usize cap = soa->cap == 0 ? 8 : soa->cap;                                                      \
+    while (cap < needed) {                                                                         \
+      cap *= 2;                                                                                    \
+    }                                                                                              \
+    FIELDS(_SOA_RESIZE)                                                                            \
+    soa->cap = cap;                                                                                \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_set(Name *soa, usize idx, Name##Row row) { FIELDS(_SOA_SET) }          \
+                                                                                                   \
+  UNUSED static Name##Row Name##_get(const Name *soa, usize idx) {                                 \
+    Name##Row row;                                                                                 \
+    FIELDS(_SOA_GET)                                                                               \
+    return row;                                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_push(Name *soa, Name##Row row) {                                       \
+    Name##_reserve(soa, 1);                                                                        \
+    Name##_set(soa, soa->len++, row);                                                              \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_swap_remove(Name *soa, usize idx) {                                    \
+    soa->len--;                                                                                    \
+    FIELDS(_SOA_MOVE_LAST)                                                                         \
   }
 
-  usize idx = hash % hm->cap;
-  for (usize i = 0; i < hm->cap; i++) {
-    if (hm->nodes[idx].key && hm->nodes[idx].key == hash) {
-      hm->nodes[idx].key = HM_DELETED_HASH;
-      hm->count--;
-      hm->deleted++;
-      return true;
-    }
-    idx = (idx + i * i) % hm->cap;
+///////////////////////////////////////////////////////////////////////////////
+
+#define soa_new(_arena)                                                                            \
+  { .arena = (_arena), }
+
+#define soa_len(soa) ((soa)->len)
+#define soa_empty(soa) (!(soa)->len)
+#define soa_clear(soa) ((soa)->len = 0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_SOA_H__ */
+
+/* DOCUMENTATION
+A `StrPool` interns strings: every unique string is stored once and gets a
+dense `u32` id, starting at `0` in the order they were added. Comparing two
+interned strings is comparing their ids, and data for every string can be kept
+in a plain array that is indexed by the id.
+
+The strings are copied into large blocks of the arena and are terminated with
+a `'\0'`. They never move, so the `Str` of an id stays valid for the lifetime of
+the arena. Two canonical `Str`s are equal if their `data` pointers are equal.
+
+The table stores the id together with 32 bits of the hash, so looking up a
+string compares the whole string only if the hashes match. Adding a string that
+is not in the pool uses the empty slot that the lookup ended on.
+
+## Initialization
+
+```c
+Arena arena = {0};
+StrPool *pool = str_pool_create(&arena);
+```
+
+- `str_pool_create(arena)`: Creates a pool for a single thread.
+- `str_pool_create_shared(arena)`: Creates a pool that can be used by multiple
+threads at once. Every call locks it. It allocates from the arena while it is
+locked, so no other thread may use the arena at the same time.
+- `str_pool_destroy(pool)`: Destroys the lock of a shared pool. The memory
+belongs to the arena.
+- `str_pool_reserve(pool, count)`: Makes room for `count` unique strings.
+
+## Operations
+
+- `str_pool_intern(pool, str)`: Returns the id of the string and adds it, if
+it is not in the pool yet.
+- `str_pool_intern_str(pool, str)`: Same, but returns the canonical `Str`.
+- `str_pool_intern_batch(pool, count, strs, ids)`: Interns `count` strings and
+stores their ids. The next strings are hashed and their slots are prefetched
+while the current ones are looked up. A shared pool is only locked once.
+- `str_pool_find(pool, str, &id)`: Returns `true` and the id if the string is
+in the pool, without adding it.
+- `str_pool_get(pool, id)`: Returns the canonical `Str` of an id.
+- `str_pool_hash(pool, id)`: Returns `str_hash` of the string, without hashing
+it again.
+- `str_pool_len(pool)`: Returns the number of unique strings.
+
+```c
+DA(u32) counts = da_new(&arena);
+for (Str word; str_try_chop_by_charset(&text, &separators, &word);) {
+  const u32 id = str_pool_intern(pool, word);
+  if (id == counts.len) {
+    da_push(&counts, 0);
   }
-  return false;
+  counts.items[id]++;
 }
+```
+*/
 
-#define TYPE_CHECK(hm, T, ret)                                                                     \
-  do {                                                                                             \
-    if (hm->type != HM_NONE && (hm->type != T)) {                                                  \
-      cebus_log_warning("HashMap Type Error: expected '%s' got '%s'", hm_type(hm->type), #T);      \
-      return ret;                                                                                  \
-    }                                                                                              \
-  } while (0)
+#ifndef __CEBUS_STR_POOL_H__
+#define __CEBUS_STR_POOL_H__
 
-#define HM_INSERT_IMPL(T)                                                                          \
-  bool hm_insert_##T(HashMap *hm, u64 hash, T value) {                                             \
-    TYPE_CHECK(hm, HM_TYPE_##T, false);                                                            \
-    hm->type = HM_TYPE_##T;                                                                        \
-    return hm_insert(hm, hash, (HashValue){.as.T = value});                                        \
-  }
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
 
-HM_TYPES(HM_INSERT_IMPL)
+//////////////////////////////////////////////////////////////////////////////
 
-#undef HM_INSERT_IMPL
+typedef struct StrPool StrPool;
 
-bool hm_insert_mut_ptr(HashMap *hm, u64 hash, void *value) {
-  TYPE_CHECK(hm, HM_PTR, false);
-  hm->type = HM_PTR;
-  return hm_insert(hm, hash, (HashValue){.as.ptr = value});
-}
+StrPool *str_pool_create(Arena *arena);
+StrPool *str_pool_create_shared(Arena *arena);
+void str_pool_destroy(StrPool *pool);
 
-bool hm_insert_ptr(HashMap *hm, u64 hash, const void *value) {
-  TYPE_CHECK(hm, HM_CONST_PTR, false);
-  hm->type = HM_CONST_PTR;
-  return hm_insert(hm, hash, (HashValue){.as.const_ptr = value});
-}
+void str_pool_reserve(StrPool *pool, usize count);
 
-////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-#define HM_GET_MUT_IMPL(T)                                                                         \
-  T *hm_get_##T##_mut(const HashMap *hm, u64 hash) {                                               \
-    TYPE_CHECK(hm, HM_TYPE_##T, NULL);                                                             \
-    HashValue *value = hm_get(hm, hash);                                                           \
-    return value ? &value->as.T : NULL;                                                            \
-  }
+u32 str_pool_intern(StrPool *pool, Str s);
+Str str_pool_intern_str(StrPool *pool, Str s);
+void str_pool_intern_batch(StrPool *pool, usize count, const Str *strs, u32 *ids);
 
-HM_TYPES(HM_GET_MUT_IMPL)
+bool str_pool_find(StrPool *pool, Str s, u32 *id);
 
-void *hm_get_ptr_mut(const HashMap *hm, u64 hash) {
-  TYPE_CHECK(hm, HM_PTR, NULL);
-  HashValue *value = hm_get(hm, hash);
-  return value ? value->as.ptr : NULL;
-}
+Str str_pool_get(StrPool *pool, u32 id);
+u64 str_pool_hash(StrPool *pool, u32 id);
+usize str_pool_len(StrPool *pool);
 
-///////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-#define HM_GET_IMPL(T)                                                                             \
-  const T *hm_get_##T(const HashMap *hm, u64 hash) { return hm_get_##T##_mut(hm, hash); }
+#endif /* !__CEBUS_STR_POOL_H__ */
 
-HM_TYPES(HM_GET_IMPL)
+/* DOCUMENTATION
+`TopK` keeps track of the `k` most frequent hashes of a stream with the
+Space-Saving algorithm. It never stores more than `k` hashes, no matter how big
+the stream gets.
 
-#undef HM_GET_IMPL
+Every tracked hash has a `count` and an `error`. The real count of the hash is
+between `count - error` and `count`. Every hash that occurs more than
+`total / k` times is guaranteed to be tracked.
 
-const void *hm_get_ptr(const HashMap *hm, u64 hash) {
-  TYPE_CHECK(hm, HM_CONST_PTR && hm->type != HM_PTR, NULL);
-  HashValue *value = hm_get(hm, hash);
-  return value ? value->as.const_ptr : NULL;
-}
+Only the `u64` hashes are tracked, not the items themselves. Keep a `HashMap`
+from the hash to the item, if the items are needed for the report.
 
-///////////////////////////////////////////////////////////////////////////////
+## Initialization
 
-#undef TYPE_CHECK
+```c
+Arena arena = {0};
+TopK topk = topk_create(&arena, 100);
+```
 
-#undef HM_TYPES
-#undef HM_DELETED_HASH
-#undef HM_DEFAULT_SIZE
+- `topk_create`: Creates a tracker for `k` hashes.
+- `topk_clear`: Removes all hashes.
+- `topk_copy`: Creates a copy of the tracker.
 
-///////////////////////////////////////////////////////////////////////////////
+## Operations
 
-// #include "set.h"
+- `topk_add`: Adds `count` occurences of the hash. If `k` hashes are already
+tracked, the least frequent one is replaced.
+- `topk_get`: Gets the entry of a tracked hash or `NULL`.
+- `topk_min`: Gets the smallest tracked count. Every hash that is not tracked
+occured at most this many times.
+- `topk_sorted`: Gets all tracked entries sorted by their count, the most
+frequent first. The array has `len` elements and is allocated in the arena.
+- `topk_merge`: Adds another tracker, for example from another thread or shard.
 
-// #include "cebus/type/integer.h"
+```c
+for (usize i = 0; i < words.len; i++) {
+  topk_add(&topk, str_hash(words.items[i]), 1);
+}
+TopKEntry *top = topk_sorted(&topk, &arena);
+for (usize i = 0; i < topk.len; i++) {
+  printf("%" U64_FMT "\n", top[i].count);
+}
+```
+*/
 
-#include <string.h>
+#ifndef __CEBUS_TOP_K_H__
+#define __CEBUS_TOP_K_H__
+
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
 
 //////////////////////////////////////////////////////////////////////////////
 
-#define SET_DEFAULT_SIZE 8
-#define SET_DELETED_HASH 0xdeaddeaddeaddead
+typedef struct {
+  u64 hash;
+  u64 count;
+  u64 error;
+} TopKEntry;
+
+typedef struct {
+  usize k;
+  usize len;
+  u64 total;
+  Arena *arena;
+  TopKEntry *items;
+  usize *heap;
+  usize *positions;
+  usize table_cap;
+  usize *table;
+} TopK;
 
 //////////////////////////////////////////////////////////////////////////////
 
-Set set_create(Arena *arena) {
-  Set set = {0};
-  set.arena = arena;
-  return set;
-}
+TopK topk_create(Arena *arena, usize k);
 
-Set set_with_size(Arena *arena, usize size) {
-  Set set = {0};
-  set.arena = arena;
-  set.cap = usize_max(size, SET_DEFAULT_SIZE);
-  set.items = arena_calloc_chunk(arena, set.cap * sizeof(set.items[0]));
-  return set;
-}
+void topk_clear(TopK *topk);
 
-void set_clear(Set *set) {
-  set->count = 0;
-  set->deleted = 0;
-  memset(set->items, 0, set->cap * sizeof(set->items[0]));
-}
+TopK topk_copy(Arena *arena, const TopK *topk);
 
-Set set_copy(Arena *arena, Set *set) {
-  Set new = set_with_size(arena, set->count * 2);
-  for (size_t i = 0; i < set->cap; i++) {
-    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
-      set_add(&new, set->items[i]);
-    }
-  }
-  return new;
-}
+//////////////////////////////////////////////////////////////////////////////
 
-void set_resize(Set *set, usize size) {
-  if (size < set->cap) {
-    return;
-  }
-  usize old_cap = set->cap;
-  u64 *old_items = set->items;
+void topk_add(TopK *topk, u64 hash, u64 count);
 
-  set->cap = size == 0 ? SET_DEFAULT_SIZE : size;
-  set->items = arena_calloc_chunk(set->arena, set->cap * sizeof(set->items[0]));
+const TopKEntry *topk_get(const TopK *topk, u64 hash);
+u64 topk_min(const TopK *topk);
 
-  set->count = 0;
-  set->deleted = 0;
-  for (usize i = 0; i < old_cap; ++i) {
-    if (old_items[i] && old_items[i] != SET_DELETED_HASH) {
-      set_add(set, old_items[i]);
-    }
-  }
-  arena_free_chunk(set->arena, old_items);
-}
+TopKEntry *topk_sorted(const TopK *topk, Arena *arena);
 
-void set_reserve(Set *set, usize size) {
-  const usize required_size = set->count + size;
-  if (required_size < set->cap) {
-    return;
-  }
-  usize new_size = set->cap == 0 ? SET_DEFAULT_SIZE : set->cap;
-  while (new_size < required_size) {
-    new_size *= 2;
-  }
-  set_resize(set, new_size);
-}
+void topk_merge(TopK *topk, const TopK *other);
 
 //////////////////////////////////////////////////////////////////////////////
 
-bool set_add(Set *set, u64 hash) {
-  if (hash == 0 || hash == SET_DELETED_HASH) {
-    hash = u64_hash(hash);
-  }
-  if (set->cap <= set->count + set->deleted) {
-    set_resize(set, set->cap * 2);
-  }
+#endif /* !__CEBUS_TOP_K_H__ */
 
-  while (true) {
-    usize idx = hash % set->cap;
+/* DOCUMENTATION
+## Runtime CPU Features
 
-    for (usize i = 0; i < set->cap; i++) {
-      if (!set->items[idx]) {
-        set->items[idx] = hash;
-        set->count++;
-        return true;
-      }
-      if (set->items[idx] == hash) {
-        return false;
-      }
-      idx = (idx + i * i) % set->cap;
-    }
+Functions that have a vectorized implementation check these at runtime, so the
+library can be compiled for the baseline architecture and still use wider
+instructions if the machine supports them.
 
-    set_resize(set, set->cap * 2);
-  }
-}
+- `cpu_has_sse2()`: Checks if the CPU supports SSE2.
+- `cpu_has_avx2()`: Checks if the CPU and the operating system support AVX2.
+- `cpu_count()`: Returns the number of logical CPUs that are online.
 
-void set_extend(Set *set, usize count, const u64 *hashes) {
-  set_reserve(set, count);
-  for (usize i = 0; i < count; i++) {
-    set_add(set, hashes[i]);
-  }
+```c
+if (cpu_has_avx2()) {
+  // use the AVX2 kernel
 }
+```
+*/
 
-void set_update(Set *dest, const Set *set) {
-  set_reserve(dest, set->count);
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[i]) {
-      set_add(dest, set->items[i]);
-    }
-  }
-}
+#ifndef __CEBUS_CPU_H__
+#define __CEBUS_CPU_H__
 
-bool set_remove(Set *set, u64 hash) {
-  if (set->count == 0) {
-    return false;
-  }
-  if (hash == 0 || hash == SET_DELETED_HASH) {
-    hash = u64_hash(hash);
-  }
+// #include "cebus/core/defines.h"
 
-  usize idx = hash % set->cap;
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[idx] && set->items[idx] == hash) {
-      set->items[idx] = SET_DELETED_HASH;
-      set->count--;
-      set->deleted++;
-      return true;
-    }
-    idx = (idx + i * i) % set->cap;
-  }
-  return false;
-}
+////////////////////////////////////////////////////////////////////////////
 
-//////////////////////////////////////////////////////////////////////////////
+bool cpu_has_sse2(void);
+bool cpu_has_avx2(void);
+usize cpu_count(void);
 
-bool set_contains(const Set *set, u64 hash) {
-  if (hash == 0 || hash == SET_DELETED_HASH) {
-    hash = u64_hash(hash);
-  }
+////////////////////////////////////////////////////////////////////////////
 
-  usize idx = hash % set->cap;
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[idx] == 0) {
-      return false;
-    }
-    if (set->items[idx] == hash) {
-      return true;
-    }
-    idx = (idx + i * i) % set->cap;
-  }
-  return false;
-}
+#endif /* !__CEBUS_CPU_H__ */
 
-bool set_eq(const Set *set, const Set *other) {
-  if (other->count != set->count) {
-    return false;
-  }
+/* DOCUMENTATION
+## Usage
 
-  if (other->cap < set->cap) {
-    const Set *temp = set;
-    set = other;
-    other = temp;
-  }
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
-      if (!set_contains(other, set->items[i])) {
-        return false;
-      }
-    }
-  }
-  return true;
-}
+Call the function with the message format and arguments:
 
-bool set_subset(const Set *set, const Set *other) {
-  if (other->count < set->count) {
-    return false;
-  }
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
-      if (!set_contains(other, set->items[i])) {
-        return false;
-      }
-    }
-  }
-  return true;
-}
+```c
+cebus_log_error("This is an error message: %s", error_details);
+```
 
-bool set_disjoint(const Set *set, const Set *other) {
-  if (other->count == 0 || set->count == 0) {
-    return true;
-  }
+## Functions
 
-  if (other->cap < set->cap) {
-    const Set *temp = set;
-    set = other;
-    other = temp;
-  }
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
-      if (set_contains(other, set->items[i])) {
-        return false;
-      }
-    }
-  }
-  return true;
-}
+- `cebus_log_level(log_level, fmt, ...)`: Logs a message with the specified log
+level.
+- `cebus_log(fmt, ...)`: Logs a message.
+- `cebus_log_fatal(fmt, ...)`: Logs a fatal message.
+- `cebus_log_error(fmt, ...)`: Logs an error message.
+- `cebus_log_warning(fmt, ...)`: Logs a warning message.
+- `cebus_log_info(fmt, ...)`: Logs an info message.
+- `cebus_log_debug(fmt, ...)`: Logs a debug message (only in debug builds).
+- `cebus_log_trace(fmt, ...)`: Logs a trace message (only in debug builds).
+*/
 
-//////////////////////////////////////////////////////////////////////////////
+#ifndef __CEBUS_LOGGING_H__
+#define __CEBUS_LOGGING_H__
 
-Set set_intersection(const Set *set, const Set *other, Arena *arena) {
-  if (other->cap < set->cap) {
-    const Set *temp = set;
-    set = other;
-    other = temp;
-  }
+// #include "cebus/core/defines.h"
 
-  Set intersection = set_create(arena);
-  set_reserve(&intersection, usize_min(set->count, other->count) * 2);
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
-      if (set_contains(other, set->items[i])) {
-        set_add(&intersection, set->items[i]);
-      }
-    }
-  }
-  return intersection;
-}
+////////////////////////////////////////////////////////////////////////////
 
-Set set_difference(const Set *set, const Set *other, Arena *arena) {
-  Set difference = set_create(arena);
-  set_reserve(&difference, set->count * 2);
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
-      if (!set_contains(other, set->items[i])) {
-        set_add(&difference, set->items[i]);
-      }
-    }
-  }
-  return difference;
-}
+typedef enum {
+  CEBUS_LOG = 0,
+  CEBUS_LOG_FATAL,
+  CEBUS_LOG_ERROR,
+  CEBUS_LOG_WARNING,
+  CEBUS_LOG_INFO,
+  CEBUS_LOG_DEBUG,
+  CEBUS_LOG_TRACE,
+} LogLevel;
 
-Set set_union(const Set *set, const Set *other, Arena *arena) {
-  Set _union = set_with_size(arena, set->count * 2);
-  for (usize i = 0; i < set->cap; i++) {
-    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
-      if (!set_contains(other, set->items[i])) {
-        set_add(&_union, set->items[i]);
-      }
-    }
-  }
+////////////////////////////////////////////////////////////////////////////
 
-  for (usize i = 0; i < other->cap; i++) {
-    if (other->items[i] && set->items[i] != SET_DELETED_HASH) {
-      if (!set_contains(set, other->items[i])) {
-        set_add(&_union, other->items[i]);
-      }
-    }
-  }
-  return _union;
-}
+void FMT(2) cebus_log_level(LogLevel log_level, const char *fmt, ...);
+void FMT(1) cebus_log(const char *fmt, ...);
+void FMT(1) cebus_log_fatal(const char *fmt, ...);
+void FMT(1) cebus_log_error(const char *fmt, ...);
+void FMT(1) cebus_log_warning(const char *fmt, ...);
+void FMT(1) cebus_log_info(const char *fmt, ...);
 
-//////////////////////////////////////////////////////////////////////////////
+////////////////////////////////////////////////////////////////////////////
 
-#undef SET_DELETED_HASH
-#undef SET_DEFAULT_SIZE
+void FMT(1) _cebus_log_debug(const char *fmt, ...);
+void FMT(1) _cebus_log_trace(const char *fmt, ...);
 
-//////////////////////////////////////////////////////////////////////////////
+#ifndef NDEBUG
+#define cebus_log_debug(...) _cebus_log_debug(__VA_ARGS__)
+#define cebus_log_trace(...) _cebus_log_trace(__VA_ARGS__)
+#else
+#define cebus_log_debug(...)
+#define cebus_log_trace(...)
+#endif
 
-// #include "string_builder.h"
+////////////////////////////////////////////////////////////////////////////
 
-// #include "cebus/type/string.h"
+#endif /* !__CEBUS_LOGGING_H__ */
 
-#include <stdarg.h>
-#include <stdio.h>
-#include <string.h>
+#ifndef __CEBUS_ARGS_H__
+#define __CEBUS_ARGS_H__
 
-StringBuilder sb_init(Arena *arena) {
-  StringBuilder sb = {0};
-  da_init(&sb, arena);
-  return sb;
-}
+// #include "cebus/collection/da.h"
+// #include "cebus/collection/hashmap.h"
+// #include "cebus/core/defines.h"
 
-void sb_clear(StringBuilder *sb) { da_clear(sb); }
+typedef struct {
+  Str name;
+  Str description;
+  bool parsed;
+  bool pos;
+  enum {
+    ARG_TYPE_NONE,
+    ARG_TYPE_FLAG,
+    ARG_TYPE_I64,
+    ARG_TYPE_U64,
+    ARG_TYPE_STR,
+  } type;
+  union {
+    bool flag;
+    i64 i64;
+    u64 u64;
+    Str str;
+  } as;
+} Argument;
 
-Str sb_to_str(StringBuilder *sb) { return str_from_parts(sb->len, sb->items); }
+typedef struct {
+  Str program;
+  Str description;
 
-void sb_append_parts(StringBuilder *sb, usize size, const char *s) { da_extend(sb, size, s); }
+  const char **argv;
+  int argc;
 
-void sb_append_cstr(StringBuilder *sb, const char *cstr) { da_extend(sb, strlen(cstr), cstr); }
+  usize positional;
+  DA(Argument) arguments;
 
-void sb_append_str(StringBuilder *sb, Str str) { da_extend(sb, str.len, str.data); }
+  HashMap *hm;
+} Args;
 
-void sb_append_c(StringBuilder *sb, char c) { da_push(sb, c); }
+bool args_c_shift(int *argc, const char ***argv);
+Str args_shift(Args *args);
 
-usize sb_append_fmt(StringBuilder *sb, const char *fmt, ...) {
-  va_list va;
+Args args_init(Arena *arena, int argc, const char **argv);
 
-  // get the size without '\0'
-  va_start(va, fmt);
-  usize size = (usize)vsnprintf(NULL, 0, fmt, va);
-  va_end(va);
+void args_print_usage(Args *args, FILE *file);
+void args_print_help(Args *args, FILE *file);
+bool args_parse(Args *args);
 
-  // allocate +1 so it does not overwrite
-  da_reserve(sb, size + 1);
+void args_add_description(Args *args, const char *description);
 
-  va_start(va, fmt);
-  vsnprintf(&da_last(sb) + 1, size + 1, fmt, va);
-  va_end(va);
-  sb->len += size;
+void args_add_i64(Args *args, const char *argument, const char *description);
+void args_add_u64(Args *args, const char *argument, const char *description);
+void args_add_str(Args *args, const char *argument, const char *description);
 
-  return size;
-}
+void args_add_opt_i64(Args *args, const char *argument, i64 def, const char *description);
+void args_add_opt_u64(Args *args, const char *argument, u64 def, const char *description);
+void args_add_opt_str(Args *args, const char *argument, Str def, const char *description);
+void args_add_opt_flag(Args *args, const char *argument, const char *description);
 
-usize sb_append_va(StringBuilder *sb, const char *fmt, va_list va) {
-  // copy the va_list
-  va_list va2;
-  va_copy(va2, va);
+i64 args_get_i64(Args *args, const char *argument);
+u64 args_get_u64(Args *args, const char *argument);
+Str args_get_str(Args *args, const char *argument);
+bool args_get_flag(Args *args, const char *argument);
 
-  // get the size without '\0'
-  usize size = (usize)vsnprintf(NULL, 0, fmt, va);
+#endif /* !__CEBUS_ARGS_H__ */
 
-  // allocate +1 so it does not overwrite
-  da_reserve(sb, size + 1);
+/* DOCUMENTATION
+## Functions
 
-  // write into buffer
-  vsnprintf(&da_last(sb) + 1, size + 1, fmt, va2);
-  sb->len += size;
+- **`cmd_exec(error, argc, argv)`**: Executes a system command.
+- **`cmd_exec_da(error, da)`**: Executes a with a dynamic array.
 
-  return size;
-}
+## Construction a dynamic array
 
-// #include "arena.h"
+```c
+Arena arena = {0};
 
-// #include "cebus/core/debug.h"
-// #include "cebus/core/defines.h"
-// #include "cebus/type/integer.h"
+Cmd cmd = cmd_new(&arena);
 
-#include <errno.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
+cmd_push(&cmd, STR("gcc"), STR("-o"), STR("main"));
 
-////////////////////////////////////////////////////////////////////////////
+Str cflags[] = {STR("-Wall"), STR("-Wextra")};
+cmd_extend(&cmd, words);
 
-#define CHUNK_DEFAULT_SIZE KILOBYTES(4)
+DA(Str) files = da_new(&arena);
+// collect files...
+cmd_extend_da(&cmd, &files);
 
-struct Chunk {
-  Chunk *next, *prev;
-  usize cap;
-  usize allocated;
-  u8 data[];
-};
+cmd_exec_da(ErrPanic, &cmd);
 
-////////////////////////////////////////////////////////////////////////////
+arena_free(&arena);
+```
 
-static Chunk *chunk_allocate(usize size) {
-  Chunk *chunk = malloc(sizeof(Chunk) + size);
-  cebus_assert(chunk != NULL, "Memory allocation failed: %s", strerror(errno));
-  chunk->cap = size;
-  chunk->allocated = 0;
-  chunk->next = chunk->prev = 0;
-  return chunk;
-}
+## Error Handling
 
-static void chunk_free(Chunk *chunk) { free(chunk); }
+Defines `CmdError` enum for different command execution outcomes:
+- `CMD_OK`: Command executed successfully.
+- `CMD_FORK`: Error occurred while forking the process.
+- `CMD_NOT_FOUND`: Command not found, typically returns `127`.
 
-CONST_FN static usize align(usize size) {
-  const usize mask = sizeof(void *) - 1;
-  return (size + mask) & ~mask;
-}
+## Usage Example
 
-////////////////////////////////////////////////////////////////////////////
+```c
+Error error = ErrNew;
+Str args[] = {STR("/bin/echo"), STR("Hello, world!")};
+cmd_exec(&error, 2, args);
+error_context(&error, {
+    // Handle error
+});
+```
+*/
 
-void arena_free(Arena *arena) {
-  Chunk *next = arena->begin;
-  while (next != NULL) {
-    Chunk *temp = next;
-    next = next->next;
-    chunk_free(temp);
-  }
-  arena->begin = NULL;
-}
+#ifndef __CEBUS_CMD_H__
+#define __CEBUS_CMD_H__
 
-void arena_reset(Arena *arena) {
-  for (Chunk *next = arena->begin; next != NULL; next = next->next) {
-    if (next->cap != 0) {
-      next->allocated = 0;
-    }
-  }
-}
+// #include "cebus/collection/da.h"
+// #include "cebus/core/defines.h"
+// #include "cebus/core/error.h"
 
-usize arena_size(Arena *arena) {
-  usize size = 0;
-  for (Chunk *chunk = arena->begin; chunk != NULL; chunk = chunk->next) {
-    size += chunk->allocated;
-  }
-  return size;
-}
+typedef enum {
+  CMD_OK,
+  CMD_FORK,
+  CMD_NOT_FOUND = 127,
+} CmdError;
 
-usize arena_real_size(Arena *arena) {
-  usize size = 0;
-  for (Chunk *chunk = arena->begin; chunk != NULL; chunk = chunk->next) {
-    size += chunk->cap ? chunk->cap : chunk->allocated;
-  }
-  return size;
-}
+void cmd_exec(Error *error, size_t argc, Str *argv);
 
-void *arena_alloc(Arena *arena, usize size) {
-  size = align(size);
-  Chunk *chunk = arena->begin;
-  for (; chunk != NULL; chunk = chunk->next) {
-    cebus_assert_debug(size <= SIZE_MAX - chunk->allocated, "integer overflow");
-    if (chunk->allocated + size < chunk->cap) {
-      break;
-    }
-  }
-  if (chunk == NULL) {
-    const usize chunk_size = usize_max(size, CHUNK_DEFAULT_SIZE);
-    chunk = chunk_allocate(chunk_size);
-    chunk->next = arena->begin;
-    if (arena->begin) {
-      arena->begin->prev = chunk;
-    }
-    arena->begin = chunk;
-  }
-  void *ptr = &chunk->data[chunk->allocated];
-  chunk->allocated += size;
-  return ptr;
-}
+typedef DA(Str) Cmd;
 
-void *arena_calloc(Arena *arena, usize size) {
-  void *ptr = arena_alloc(arena, size);
-  memset(ptr, 0, size);
-  return ptr;
-}
+#define cmd_new(arena) da_new(arena)
+#define cmd_push(cmd, ...) da_extend(cmd, ARRAY_LEN((Str[]){__VA_ARGS__}), (Str[]){__VA_ARGS__})
+#define cmd_extend(cmd, ...) da_extend(cmd, ARRAY_LEN(__VA_ARGS__), (__VA_ARGS__))
+#define cmd_extend_da(cmd, da) da_extend(cmd, (da)->len, (da)->items)
 
-////////////////////////////////////////////////////////////////////////////
+void cmd_exec_da(Error *error, const Cmd *cmd);
 
-void *arena_alloc_chunk(Arena *arena, usize size) {
-  Chunk *chunk = chunk_allocate(size);
-  chunk->cap = 0;
-  chunk->allocated = size;
-  chunk->next = arena->begin;
-  if (arena->begin) {
-    arena->begin->prev = chunk;
-  }
-  arena->begin = chunk;
-  return chunk->data;
-}
+#endif // !__CEBUS_CMD_H__
 
-void *arena_calloc_chunk(Arena *arena, usize size) {
-  void *data = arena_alloc_chunk(arena, size);
-  memset(data, 0, size);
-  return data;
-}
+/* DOCUMENTATION
+## Functions
 
-void *arena_realloc_chunk(Arena *arena, void *ptr, usize size) {
-  if (ptr == NULL) {
-    return arena_alloc_chunk(arena, size);
-  }
-  Chunk *chunk = (Chunk *)((u8 *)ptr - sizeof(Chunk));
-  if (size < chunk->allocated) {
-    return chunk->data;
-  }
-  Chunk *new_chunk = realloc(chunk, sizeof(Chunk) + size);
-  if (new_chunk->prev) {
-    new_chunk->prev->next = new_chunk;
-  }
-  if (new_chunk->next) {
-    new_chunk->next->prev = new_chunk;
-  }
-  if (arena->begin == chunk) {
-    arena->begin = new_chunk;
-  }
-  return new_chunk->data;
-}
+- **`dll_load(path, error)`**: Loads a dynamic link library.
+- **`dll_close(handle)`**: Closes an opened dynamic link library.
+- **`dll_symbol(handle, symbol, error)`**: Retrieves a symbol from the dynamic
+link library.
 
-void arena_free_chunk(Arena *arena, void *ptr) {
-  if (ptr == NULL) {
-    return;
-  }
-  Chunk *chunk = (Chunk *)((u8 *)ptr - sizeof(Chunk));
-  if (chunk == arena->begin) {
-    arena->begin = chunk->next;
-  }
-  if (chunk->prev) {
-    chunk->prev->next = chunk->next;
-  }
-  if (chunk->next) {
-    chunk->next->prev = chunk->prev;
-  }
-  free(chunk);
-}
 
-////////////////////////////////////////////////////////////////////////////
+## Usage Example
 
-// #include "error.h"
+```c
+Error error = ErrNew;
+Dll *myLib = dll_load(STR("myLibrary.dll"), &error);
+error_context(&error, {
+  error_raise();
+});
+Function *myFunction = dll_symbol(myLib, "myFunctionName", &error);
+// Use the function pointer as needed
+dll_close(myLib);
+```
+*/
 
-// #include "cebus/core/arena.h"
+#ifndef __CEBUS_DLL_H__
+#define __CEBUS_DLL_H__
+
+// #include "cebus/core/defines.h"
 // #include "cebus/core/error.h"
-// #include "cebus/type/string.h"
 
-#include <stdarg.h>
-#include <stdio.h>
-#include <stdlib.h>
+typedef void Dll;
+typedef void (*Function)(void);
 
-////////////////////////////////////////////////////////////////////////////
+Dll *dll_load(Path path, Error *error);
+void dll_close(Dll *handle);
 
-static void error_dump(Error *error) {
+Function dll_symbol(Dll *handle, Str symbol, Error *error);
 
-  fprintf(stderr, "[Error]: %s:%d: %s()\n", error->location.file, error->location.line,
-          error->location.function);
-  Str message = sb_to_str(&error->info->message);
-  Str msg = str_chop_by_delim(&message, '\n');
-  fprintf(stderr, "  [Message]: " STR_FMT "\n", STR_ARG(msg));
-  for (Str note = {0}; str_try_chop_by_delim(&message, '\n', &note);) {
-    fprintf(stderr, "  [NOTE]: " STR_FMT "\n", STR_ARG(note));
-  }
-
-  // Stack trace
-  fprintf(stderr, "[STACK TRACE]\n");
-  usize location_count = error->info->locations.len;
-  for (usize i = 0; i < location_count; ++i) {
-    FileLocation *location = &da_pop(&error->info->locations);
-    fprintf(stderr, "  [%" USIZE_FMT "]: %s:%d: %s()\n", i + 1, location->file, location->line,
-            location->function);
-  }
-}
-
-////////////////////////////////////////////////////////////////////////////
-
-void _error_internal_emit(Error *err, i32 code, FileLocation location, const char *fmt, ...) {
-  if (err == ErrDefault) {
-    err = ((Error[]){{
-        .failure = true,
-        .panic_on_emit = true,
-        .location = location,
-        .arena = {0},
-    }});
-  }
+#endif /*  !__CEBUS_DLL_H__ */
 
-  err->failure = true;
+/* DOCUMENTATION
+## Functions
 
-  err->info = arena_calloc(&err->arena, sizeof(ErrorInfo));
-  err->info->code = code;
+- **Reading Files**:
+  - `fs_file_read_bytes(filename, arena, error)`: Reads the entire file into a
+byte array.
+  - `fs_file_read_str(filename, arena, error)`: Reads the entire file into a
+string.
+  - `fs_file_read_utf8(filename, arena, error)`: Reads the entire file into
+UTF-8 format.
 
-  err->info->message = sb_init(&err->arena);
-  da_init(&err->info->locations, &err->arena);
+- **Hashing Files**:
+  - `fs_file_hash(filename, error)`: Hashes the file in chunks with a `Hasher`,
+without reading all of it into memory. Same as `bytes_hash` of its content.
 
-  da_push(&err->info->locations, location);
+- **Writing Files**:
+  - `fs_file_write_bytes(filename, bytes, error)`: Writes byte data to a file.
+  - `fs_file_write_str(filename, content, error)`: Writes a string to a file.
+  - `fs_file_write_utf8(filename, content, error)`: Writes UTF-8 formatted data
+to a file.
 
-  va_list va;
-  va_start(va, fmt);
-  sb_append_va(&err->info->message, fmt, va);
-  va_end(va);
-  err->info->msg = sb_to_str(&err->info->message);
+- **File Management**:
+  - `fs_file_open(filename, mode, error)`: Opens a file with the specified mode.
+  - `fs_file_close(file, error)`: Closes an open file.
+  - `fs_rename(old_name, new_name, error)`: Renames a file.
+  - `fs_remove(filename, error)`: Removes a file.
+  - `fs_exists(filename)`: Checks if a file exists.
 
-  if (err->panic_on_emit) {
-    _error_internal_panic(err);
-  }
-}
+## Usage Example
 
-bool _error_internal_occured(Error *err) { return err && err->failure; }
+```c
+Arena arena = {0};
+Error error = ErrNew;
+Str content = fs_file_read_str(STR("filename.txt"), &arena, &error);
+error_context(&error, {
+    error_raise();
+});
+arena_free(&arena);
+```
 
-void _error_internal_panic(Error *err) {
-  error_dump(err);
-  arena_free(&err->arena);
-  abort();
-}
 
-void _error_internal_except(Error *err) {
-  arena_free(&err->arena);
-  err->info = NULL;
-  err->failure = false;
-}
+*/
 
-void _error_internal_set_code(Error *err, i32 code) { err->info->code = code; }
+#ifndef __CEBUS_FS_H__
+#define __CEBUS_FS_H__
 
-void _error_internal_set_msg(Error *err, const char *fmt, ...) {
-  sb_clear(&err->info->message);
-  va_list va;
-  va_start(va, fmt);
-  sb_append_va(&err->info->message, fmt, va);
-  va_end(va);
-  err->info->msg = sb_to_str(&err->info->message);
-}
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
+// #include "cebus/core/error.h"
 
-void _error_internal_add_note(Error *err, const char *fmt, ...) {
-  va_list va;
-  va_start(va, fmt);
-  sb_append_c(&err->info->message, '\n');
-  sb_append_va(&err->info->message, fmt, va);
-  va_end(va);
+#include <errno.h>
 
-  err->info->msg.data = err->info->message.items;
-}
+////////////////////////////////////////////////////////////////////////////
 
-void _error_internal_add_location(Error *err, FileLocation location) {
-  da_push(&err->info->locations, location);
-}
+typedef enum {
+  FS_OK,
+  FS_PERMISSION = EACCES,
+  FS_NOT_FOUND = ENOENT,
+  FS_INVALID = EBADF,
+} FileError;
 
 ////////////////////////////////////////////////////////////////////////////
 
-// #include "logging.h"
+FILE *fs_file_open(Path path, const char *mode, Error *error);
+void fs_file_close(FILE *file, Error *error);
 
-#include <stdarg.h>
-#include <stdio.h>
+Bytes fs_file_read_bytes(Path filename, Arena *arena, Error *error);
+Str fs_file_read_str(Path filename, Arena *arena, Error *error);
+Utf8 fs_file_read_utf8(Path filename, Arena *arena, Error *error);
 
-////////////////////////////////////////////////////////////////////////////
+u64 fs_file_hash(Path filename, Error *error);
 
-#if defined(LINUX)
-#include <unistd.h>
-#elif defined(WINDOWS)
-#include <io.h>
-#define isatty(...) _isatty(__VA_ARGS__)
-#else
-#define isatty(...) false
-#endif
+void fs_file_write_bytes(Path filename, Bytes bytes, Error *error);
+void fs_file_write_str(Path filename, Str content, Error *error);
+void fs_file_write_utf8(Path filename, Utf8 content, Error *error);
 
-#ifndef STDERR_FILENO
-#define STDERR_FILENO 1
-#endif
-#ifndef STDOUT_FILENO
-#define STDOUT_FILENO 2
-#endif
+void fs_rename(Path old_path, Path new_path, Error *error);
+void fs_remove(Path path, Error *error);
+bool fs_exists(Path path);
+bool fs_is_dir(Path path);
 
 ////////////////////////////////////////////////////////////////////////////
 
-struct CmLogLevelPrefix {
-  const char *prefix;
-  const char *color;
-  int file;
-};
-
-static const struct CmLogLevelPrefix log_level_str[] = {
-    [CEBUS_LOG_FATAL] = {"FATAL", "\033[1m\033[91m", STDERR_FILENO},
-    [CEBUS_LOG_ERROR] = {"ERROR", "\033[91m", STDERR_FILENO},
-    [CEBUS_LOG_WARNING] = {"WARNING", "\033[33m", STDERR_FILENO},
-    [CEBUS_LOG_INFO] = {"INFO", "\033[34m", STDOUT_FILENO},
-    [CEBUS_LOG_DEBUG] = {"DEBUG", "\033[1m\033[95m", STDOUT_FILENO},
-    [CEBUS_LOG_TRACE] = {"TRACE", "\033[97m", STDOUT_FILENO},
-};
-
-#define FMT_RESET "\033[0m"
+/* DOCUMENTATION
+## Directory Iteration
 
-////////////////////////////////////////////////////////////////////////////
+```c
+int main(void) {
+  // initialize and configure iterator
+  FsIter it = fs_iter_begin(STR("."), true);
 
-#define _LOG(__log_level, __fmt)                                                                   \
-  _cebus_log(__log_level);                                                                         \
-  va_list __args;                                                                                  \
-  va_start(__args, __fmt);                                                                         \
-  vfprintf(log_level_str[__log_level].file == STDERR_FILENO ? stderr : stdout, __fmt, __args);     \
-  va_end(__args);                                                                                  \
-  fprintf(log_level_str[__log_level].file == STDERR_FILENO ? stderr : stdout, "%s\n",              \
-          display_colors ? FMT_RESET : "");
+  // iterate over directory with certain filters
+  while (fs_iter_next_suffix(&it, STR(".clangd"))) {
+    // every allocation in the scratch buffer gets reset after each iteration
+    Str data = fs_file_read_str(it.current.path, &it.scratch, &it.error);
 
-static bool display_colors = false;
-static bool tty_checked = false;
+    // do not return before you call 'fs_iter_end'
+    error_propagate(&it.error, { break; });
 
-static void _cebus_log(LogLevel log_level) {
-  if (UNLIKELY(!tty_checked)) {
-    tty_checked = true;
-    display_colors = isatty(STDOUT_FILENO) && isatty(STDERR_FILENO);
+    // do something with data...
+    cebus_log_debug(STR_FMT, STR_ARG(data));
   }
 
-  fprintf(log_level_str[log_level].file == STDERR_FILENO ? stderr : stdout,
-          "%s[%s]: ", display_colors ? log_level_str[log_level].color : "",
-          log_level_str[log_level].prefix);
+  // collect errors and deinitializes iterator
+  Error err = ErrNew;
+  fs_iter_end(&it, &err);
+  error_context(&err, { error_panic(); });
 }
+```
+*/
 
-////////////////////////////////////////////////////////////////////////////
+typedef struct {
+  bool is_dir;
+  Path path;
+} FsEntity;
 
-void cebus_log_level(LogLevel level, const char *fmt, ...) { _LOG(level, fmt); }
+typedef struct {
+  Error error;
+  Arena scratch;
+  bool recursive;
+  FsEntity current;
+  void *_stack;
+} FsIter;
 
-void cebus_log(const char *fmt, ...) {
-  va_list args;
-  va_start(args, fmt);
-  vprintf(fmt, args);
-  printf("\n");
-  va_end(args);
-}
-void cebus_log_fatal(const char *fmt, ...) { _LOG(CEBUS_LOG_FATAL, fmt); }
-void cebus_log_error(const char *fmt, ...) { _LOG(CEBUS_LOG_ERROR, fmt); }
-void cebus_log_warning(const char *fmt, ...) { _LOG(CEBUS_LOG_WARNING, fmt); }
-void cebus_log_info(const char *fmt, ...) { _LOG(CEBUS_LOG_INFO, fmt); }
+FsIter fs_iter_begin(Path directory, bool recursive);
+void fs_iter_end(FsIter *it, Error *error);
+
+bool fs_iter_next(FsIter *it);
+bool fs_iter_next_filter(FsIter *it, bool (*filter)(FsEntity *entity));
+bool fs_iter_next_directory(FsIter *it);
+bool fs_iter_next_files(FsIter *it);
+bool fs_iter_next_suffix(FsIter *it, Str suffix);
 
 ////////////////////////////////////////////////////////////////////////////
 
-void _cebus_log_debug(const char *fmt, ...) { _LOG(CEBUS_LOG_DEBUG, fmt); }
-void _cebus_log_trace(const char *fmt, ...) { _LOG(CEBUS_LOG_TRACE, fmt); }
+#endif /* !__CEBUS_FS_H__ */
 
-////////////////////////////////////////////////////////////////////////////
+/* DOCUMENTATION
+## Functions
 
-#undef _LOG
+- **Output**:
+  - `io_write(file, fmt, ...)`: Writes a formated string into the file
+  - `io_write_bytes(file, bytes, error)`: Writes byte data to a file or stream.
+  - `io_write_replace(file, str, old, new, error)`,
+`io_write_replace_ignorecase(...)`: Writes the string with every occurrence of
+`old` replaced by `new`, like `sb_append_replace`, without building the result
+in memory first.
 
-////////////////////////////////////////////////////////////////////////////
+- **Input**:
+  - `io_read_bytes(file, size, buffer, error)`: Reads a specified amount of byte
+data from a file or stream into a buffer.
+  - `io_read_line(file, size, buffer, error)`: Reads a line of text from a file
+or stream into a buffer.
+  - `input(prefix)`: Displays a prompt and reads a line of text from standard
+input.
 
-// #include "args.h"
+## Usage Example
 
-// #include "cebus/core/debug.h"
-// #include "cebus/core/error.h"
-// #include "cebus/type/char.h"
-// #include "cebus/type/integer.h"
-// #include "cebus/type/string.h"
+```c
+Error e = ErrNew;
+io_write(stdout, BYTES_STR("Hello, World"), &e);
+error_context(&e, { error_raise(); });
 
-#include <stdio.h>
-#include <stdlib.h>
+Str ret = input(STR(":> "));
+printf("input: '"STR_FMT"'\n", STR_ARG(ret));
+```
 
-typedef enum {
-  ERR_INTERNAL,
-  ERR_PARSE,
-} ArgParseError;
+Output when running the example:
+```console
+:> name
+input: 'name'
+```
 
-bool args_c_shift(int *argc, const char ***argv) {
-  if ((*argc) == 0) {
-    return false;
-  }
-  (*argc)--;
-  (*argv)++;
-  return true;
-}
+*/
 
-Str args_shift(Args *args) {
-  if (args->argc == 0) {
-    return (Str){0};
-  }
-  args->argc--;
-  return str_from_cstr(*args->argv++);
-}
+#ifndef __CEBUS_IO_H__
+#define __CEBUS_IO_H__
 
-Args args_init(Arena *arena, int argc, const char **argv) {
-  Args args = {.argc = argc, .argv = argv};
+// #include "cebus/core/defines.h"
+// #include "cebus/core/error.h"
 
-  da_init(&args.arguments, arena);
-  args.hm = NULL;
-  hm_create(arena);
+////////////////////////////////////////////////////////////////////////////
 
-  args.program = args_shift(&args);
+FMT(2) usize io_write_fmt(FILE *file, const char *fmt, ...);
+void io_write_bytes(FILE *file, Bytes bytes, Error *error);
+void io_write_str(FILE *file, Str string, Error *error);
+void io_write_replace(FILE *file, Str s, Str old, Str new, Error *error);
+void io_write_replace_ignorecase(FILE *file, Str s, Str old, Str new, Error *error);
 
-  return args;
-}
+Bytes io_read_bytes(FILE *file, usize size, void *buffer, Error *error);
+Str io_read_line(FILE *file, usize size, char *buffer, Error *error);
 
-void args_add_description(Args *args, const char *description) {
-  args->description = str_from_cstr(description);
-}
+////////////////////////////////////////////////////////////////////////////
 
-void args_print_usage(Args *args, FILE *file) {
-  fprintf(file, "usage: " STR_FMT, STR_ARG(args->program));
-  for (u32 i = 0; i < args->positional; ++i) {
-    Argument *argument = &args->arguments.items[i];
-    fprintf(file, " <" STR_FMT ">", STR_ARG(argument->name));
-  }
-  if (args->arguments.len > args->positional) {
-    fprintf(file, " [...options]");
-  }
-  fprintf(file, "\n");
-}
+Str input(Str prefix);
 
-void args_print_help(Args *args, FILE *file) {
-  args_print_usage(args, file);
-  fprintf(file, "\n");
+////////////////////////////////////////////////////////////////////////////
 
-  if (args->description.len) {
-    fprintf(file, STR_FMT "\n", STR_ARG(args->description));
-    fprintf(file, "\n");
-  }
+#endif /* !__CEBUS_IO_H__ */
 
-  if (args->positional) {
-    fprintf(file, "positional arguments:\n");
-  }
-  for (u32 i = 0; i < args->arguments.len && i < args->positional; ++i) {
-    Argument *argument = &args->arguments.items[i];
-    const i32 padding = i32_max(0, 28 - (i32)argument->name.len);
-    fprintf(file, "  " STR_FMT " %*c " STR_FMT "\n", STR_ARG(argument->name), padding, ' ',
-            STR_ARG(argument->description));
-  }
-  if (args->positional) {
-    fprintf(file, "\n");
-  }
+/* DOCUMENTATION
+## Functions
 
-  fprintf(file, "options:\n");
-  fprintf(file, "  -h, --help                    show usage or this help message\n");
-  for (usize i = args->positional; i < args->arguments.len; i++) {
-    Argument *argument = &args->arguments.items[i];
-    const i32 padding = i32_max(0, 28 - (i32)argument->name.len);
-    fprintf(file, "  --" STR_FMT "%*c" STR_FMT "\n", STR_ARG(argument->name), padding, ' ',
-            STR_ARG(argument->description));
-  }
-}
+- **Environment Variables**:
+  - `os_getenv(env, error)`: Retrieves the value of an environment variable.
 
-static void args_parse_argument(Argument *argument, Str arg, Error *error) {
-  if (arg.len == 0 || arg.data == NULL || str_startswith(arg, STR("--"))) {
-    error_emit(error, ERR_PARSE, STR_REPR " needs parameter: got " STR_REPR,
-               STR_ARG(argument->name), STR_ARG(arg));
-    return;
-  }
+- **Current Working Directory**:
+  - `os_getcwd(arena)`: Returns the current working directory, allocating memory
+from the specified `Arena`.
+  - `os_chdir(path)`: Changes the current working directory to the specified
+path.
 
-  if (arg.data[0] == '"') {
-    arg.data += 1;
-    arg.len -= 2;
-  }
+## Usage Example
 
-  switch (argument->type) {
-  case ARG_TYPE_NONE:
-  case ARG_TYPE_FLAG: {
-    error_emit(error, ERR_INTERNAL, "this type should never be parsed here: %d", argument->type);
-    return;
-  } break;
-  case ARG_TYPE_I64: {
-    bool minus_number = arg.data[0] == '-' && c_is_digit(arg.data[1]);
-    if (!minus_number && !c_is_digit(arg.data[0])) {
-      error_emit(error, ERR_PARSE, STR_REPR ": " STR_REPR " not a valid i64",
-                 STR_ARG(argument->name), STR_ARG(arg));
-      return;
-    }
-    argument->as.i64 = str_i64(arg);
-  } break;
-  case ARG_TYPE_U64: {
-    bool minus_number = arg.data[0] == '-' && c_is_digit(arg.data[1]);
-    if (minus_number) {
-      error_emit(error, ERR_PARSE, STR_REPR ": " STR_REPR "minus numbers are not valid u64",
-                 STR_ARG(argument->name), STR_ARG(arg));
-      return;
-    }
-    if (!c_is_digit(arg.data[0])) {
-      error_emit(error, ERR_PARSE, STR_REPR ": " STR_REPR " not a valid u64",
-                 STR_ARG(argument->name), STR_ARG(arg));
-      return;
-    }
-    argument->as.u64 = str_u64(arg);
-  } break;
-  case ARG_TYPE_STR: {
-    argument->as.str = arg;
-  } break;
-  }
+```c
+Error error = ErrNew;
+Str cwd = os_getcwd(&arena);
+Str home = os_getenv("HOME", &error);
+error_context(&error, {
+  error_raise();
+});
 
-  argument->parsed = true;
-}
+printf("Current working directory: " STR_FMT "\n", STR_ARG(cwd));
+printf("Home directory: " STR_FMT "\n", STR_ARG(home));
+```
+*/
 
-bool args_parse(Args *args) {
-  Error error = ErrNew;
+#ifndef __CEBUS_OS_H__
+#define __CEBUS_OS_H__
 
-  u32 argument_idx = 0;
-  u32 positional_count = 0;
-  for (Str arg = {0}; (arg = args_shift(args)).data;) {
-    if (str_eq(arg, STR("-h"))) {
-      args_print_usage(args, stdout);
-      exit(0);
-    }
-    if (str_eq(arg, STR("--help"))) {
-      args_print_help(args, stdout);
-      exit(0);
-    }
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
+// #include "cebus/core/error.h"
 
-    bool arg_is_optional = arg.data[0] == '-' && (arg.data[1] == '-' || !c_is_digit(arg.data[1]));
-    if (arg_is_optional) {
-      if (str_eq(arg, STR("--"))) {
-        break;
-      }
-      usize dash_count = str_count(str_substring(arg, 0, 2), STR("-"));
-      Str arg_no_prefix = str_substring(arg, dash_count, arg.len);
-      Str real_argument = str_chop_by_delim(&arg_no_prefix, '=');
-      const usize *idx = hm_get_usize(args->hm, str_hash(real_argument));
-      if (idx == NULL) {
-        error_emit(&error, ERR_PARSE, STR_REPR ": unknown argument", STR_ARG(arg));
-        goto defer;
-      }
-      Argument *argument = &args->arguments.items[*idx];
-      if (argument->parsed) {
-        error_emit(&error, ERR_PARSE, STR_REPR ": argument was passed twice", STR_ARG(arg));
-        goto defer;
-      }
-      if (argument->type == ARG_TYPE_FLAG) {
-        argument->as.flag = true; // flag turned on
-        continue;
-      }
-      if (argument->pos) {
-        positional_count++;
-      }
+////////////////////////////////////////////////////////////////////////////
 
-      Str next_arg = arg_no_prefix.len ? arg_no_prefix : args_shift(args);
-      args_parse_argument(argument, next_arg, &error);
-      error_propagate(&error, { goto defer; });
+Str os_getenv(const char *env, Error *error);
+void os_mkdir(Path path);
+void os_mkdir_mode(Path path, u32 mode);
+void os_chdir(Path path);
+Path os_getcwd(Arena *arena);
 
-      continue;
-    }
+////////////////////////////////////////////////////////////////////////////
 
-    while (true) {
-      if (argument_idx >= args->arguments.len) {
-        error_emit(&error, ERR_PARSE,
-                   STR_REPR ": too many positional arguments: got %d expected %" USIZE_FMT,
-                   STR_ARG(arg), argument_idx, args->positional);
-        goto defer;
-      }
-      Argument *argument = &args->arguments.items[argument_idx++];
-      if (argument->parsed) {
-        continue; // next
-      }
-      if (argument->type == ARG_TYPE_FLAG) {
-        continue; // next
-      }
+#endif /* !__CEBUS_OS_H__ */
 
-      positional_count++;
-      args_parse_argument(argument, arg, &error);
-      error_propagate(&error, { goto defer; });
+#ifndef __CEBUS_BOOL_H__
+#define __CEBUS_BOOL_H__
 
-      break;
-    }
-  }
+// #include "cebus/core/defines.h"
 
-  if (positional_count < args->positional) {
-    error_emit(&error, ERR_PARSE, "not enough positional arguments: got %d expected %" USIZE_FMT,
-               positional_count, args->positional);
-    goto defer;
-  }
+bool bool_toggle(bool b);
 
-defer:
-  error_context(&error, {
-    if (error_code(ArgParseError) == ERR_PARSE) {
-      fprintf(stderr, STR_FMT "\n", STR_ARG(error_msg()));
-      args_print_usage(args, stderr);
-      error_except();
-      return false;
-    }
-  });
+bool bool_any(usize count, const bool *array);
+bool bool_all(usize count, const bool *array);
 
-  return true;
-}
+#endif
 
-#define ARGS_GENERIC_IMPLEMENTATION(NAME, T, T_ENUM)                                               \
-  void args_add_##NAME(Args *args, const char *argument, const char *description) {                \
-    cebus_assert(args->positional == args->arguments.len,                                          \
-                 "an optional argument was passed before!");                                       \
-    args->positional++;                                                                            \
-    args->hm = args->hm ? args->hm : hm_create(args->arguments.arena);                             \
-    Str name = str_from_cstr(argument);                                                            \
-    hm_insert_usize(args->hm, str_hash(name), da_len(&args->arguments));                           \
-    da_push(&args->arguments, (Argument){                                                          \
-                                  .name = name,                                                    \
-                                  .description = str_from_cstr(description),                       \
-                                  .pos = true,                                                     \
-                                  .type = T_ENUM,                                                  \
-                                  .as = {0},                                                       \
-                              });                                                                  \
-  }                                                                                                \
-  void args_add_opt_##NAME(Args *args, const char *argument, T def, const char *description) {     \
-    args->hm = args->hm ? args->hm : hm_create(args->arguments.arena);                             \
-    Str name = str_from_cstr(argument);                                                            \
-    hm_insert_usize(args->hm, str_hash(name), da_len(&args->arguments));                           \
-    da_push(&args->arguments, (Argument){                                                          \
-                                  .name = name,                                                    \
-                                  .description = str_from_cstr(description),                       \
-                                  .type = T_ENUM,                                                  \
-                                  .as.NAME = def,                                                  \
-                              });                                                                  \
-  }                                                                                                \
-  T args_get_##NAME(Args *args, const char *argument) {                                            \
-    cebus_assert(args->hm != NULL, "no arguments were given");                                     \
-    const usize *idx = hm_get_usize(args->hm, str_hash(str_from_cstr(argument)));                  \
-    cebus_assert(idx && args->arguments.items[*idx].type == T_ENUM, "");                           \
-    return args->arguments.items[*idx].as.NAME;                                                    \
-  }
+/* DOCUMENTATION
+## Features and Functions
 
-ARGS_GENERIC_IMPLEMENTATION(i64, i64, ARG_TYPE_I64)
-ARGS_GENERIC_IMPLEMENTATION(u64, u64, ARG_TYPE_U64)
-ARGS_GENERIC_IMPLEMENTATION(str, Str, ARG_TYPE_STR)
+- **Creating Byte Arrays**:
+  - `BYTES`: Create a byte array from byte literals.
+  - `BYTES_STR`: Create a byte array from a string literal.
 
-void args_add_opt_flag(Args *args, const char *argument, const char *description) {
-  args->hm = args->hm ? args->hm : hm_create(args->arguments.arena);
-  usize idx = da_len(&args->arguments);
-  Str name = str_from_cstr(argument);
-  hm_insert_usize(args->hm, str_hash(name), idx);
-  da_push(&args->arguments, (Argument){
-                                .name = name,
-                                .description = str_from_cstr(description),
-                                .type = ARG_TYPE_FLAG,
-                                .as.flag = false,
-                            });
-}
+- **Creating from Pointer and Size**:
+  - `bytes_from_parts(size, data)`: Creates a byte array from given size and
+data pointer.
 
-bool args_get_flag(Args *args, const char *argument) {
-  cebus_assert(args->hm != NULL, "no arguments were given");
-  const usize *idx = hm_get_usize(args->hm, str_hash(str_from_cstr(argument)));
-  cebus_assert(idx && args->arguments.items[*idx].type == ARG_TYPE_FLAG, "");
-  return args->arguments.items[*idx].as.flag;
-}
+- **Copying Byte Arrays**:
+  - `bytes_copy(bytes, arena)`: Performs a deep copy of a byte array, allocating
+memory from the specified arena.
 
-#undef ARGS_GENERIC_IMPLEMENTATION
+- **Slicing and Taking Bytes**:
+  - `bytes_slice(bytes, idx1, idx2)`: Returns a new byte array that is a slice
+from the original, from `idx1` to `idx2`.
+  - `bytes_take(bytes, count)`: Modifies the original byte array to keep only
+the first `count` bytes, returning the removed portion.
 
-// #include "cmd.h"
+- **Checking Equality**:
+  - `bytes_eq(b1, b2)`: Checks if two byte arrays are equal.
 
-// #include "cebus/collection/da.h"
-// #include "cebus/core/arena.h"
+- **Hashing**:
+  - `bytes_hash(bytes)`: Hashes the bytes with XXH64 and seed `0`.
+  - `bytes_hash_seed(bytes, seed)`: Same with another seed, for example to get
+independent hash functions.
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
+The hash is XXH64, which processes 32 bytes per step. Its output is stable: the
+same bytes and seed give the same hash on every platform and in every future
+version, so it can be stored or sent over the network.
 
-void cmd_exec_da(Error *error, const Cmd *cmd) { cmd_exec(error, cmd->len, cmd->items); }
+- **Streaming Hash**:
+  - `hasher_init(seed)`: Creates a `Hasher` for input that arrives in pieces.
+  - `hasher_update(hasher, bytes)`: Adds the next bytes.
+  - `hasher_final(hasher)`: Returns the hash of everything added so far. The
+hasher can still be updated afterwards.
 
-////////////////////////////////////////////////////////////////////////////
-#if defined(LINUX)
+The result is the same as `bytes_hash_seed` of all the bytes one after another,
+no matter how they were split.
 
-#include <errno.h>
-#include <sys/wait.h>
-#include <unistd.h>
+  - `hasher_update_u64(hasher, value)`, `hasher_update_i64(hasher, value)`,
+`hasher_update_f64(hasher, value)`: Add a number as 8 little endian bytes, so
+the hash does not depend on the byte order of the platform.
+  - `hasher_update_str(hasher, s)`: Adds the length and then the characters, so
+`"ab", "c"` and `"a", "bc"` hash differently.
 
-void cmd_exec(Error *error, size_t argc, Str *argv) {
-  errno = 0;
-  pid_t pid = fork();
-  if (pid == -1) {
-    error_emit(error, CMD_FORK, "fork failed: %s", strerror(errno));
-  } else if (pid == 0) {
-    Arena arena = {0};
+These hash a struct field by field, without its padding:
+```c
+u64 user_hash(const User *user) {
+  Hasher hasher = hasher_init(0);
+  hasher_update_u64(&hasher, user->id);
+  hasher_update_str(&hasher, user->name);
+  return hasher_final(&hasher);
+}
+```
 
-    DA(char *) args = {0};
-    da_init(&args, &arena);
-    for (size_t i = 0; i < argc; i++) {
-      char *cmd = arena_calloc(&arena, argv[i].len + 1);
-      strncpy(cmd, argv[i].data, argv[i].len);
-      da_push(&args, cmd);
-    }
-    da_push(&args, NULL);
-    execvp(args.items[0], args.items);
+- **Hexadecimal Conversion**:
+  - `bytes_to_hex(bytes, arena)`: Converts a byte array into a hexadecimal
+string representation, using memory from the arena.
+  - `bytes_from_hex(s, arena)`: Creates a byte array from a hexadecimal string,
+allocating memory from the arena.
 
-    arena_free(&arena);
-    exit(CMD_NOT_FOUND);
-  }
+## Usage
+Create new Bytes from a literal.
+```c
+Bytes bytes = BYTES(0xff, 0x11);
+Bytes bytes_str = BYTES_STR("Bytes from a string");
+```
 
-  int status = 0;
-  waitpid(pid, &status, 0);
-  if (WIFEXITED(status)) {
-    int exit_code = WEXITSTATUS(status);
-    if (exit_code == CMD_NOT_FOUND) {
-      error_emit(error, CMD_NOT_FOUND, "command not found: " STR_FMT, STR_ARG(argv[0]));
-    } else if (exit_code != 0) {
-      error_emit(error, exit_code, "command failed: " STR_FMT ": exit code: %d\n", STR_ARG(argv[0]),
-                 exit_code);
-    }
-  }
-}
+Or from a pointer with size.
+```c
+int a = 69;
+Bytes bytes = bytes_from_parts(sizeof(a), &a);
+```
 
-////////////////////////////////////////////////////////////////////////////
-#elif defined(WINDOWS)
+if you need to take ownership of the bytes you can copy it.
+```c
+int a = 69;
+Bytes bytes = bytes_from_parts(sizeof(a), &a);
 
-// #include "cebus/type/string.h"
+Arena arena = {0};
+Bytes owned_bytes = bytes_copy(bytes, &arena);
+```
+*/
 
-void cmd_exec(Error *error, size_t argc, Str *argv) {
-  STARTUPINFOA si;
-  PROCESS_INFORMATION pi;
-  ZeroMemory(&si, sizeof(si));
-  si.cb = sizeof(si);
-  ZeroMemory(&pi, sizeof(pi));
+#ifndef __CEBUS_BYTES_H__
+#define __CEBUS_BYTES_H__
 
-  Arena arena = {0};
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
 
-  Str command = str_wrap(argv[0], STR("\""), &arena);
-  Str args = str_join(STR(" "), argc - 1, argv + 1, &arena);
-  char *cmd = arena_calloc(&arena, command.len + 1 + args.len + 1);
-  strncpy(cmd, command.data, command.len);
-  cmd[command.len] = ' ';
-  strncpy(cmd + command.len + 1, args.data, args.len);
+////////////////////////////////////////////////////////////////////////////
 
-  if (!CreateProcessA(NULL, cmd, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi)) {
-    DWORD ec = GetLastError();
-    if (ec == 0x2) {
-      error_emit(error, CMD_NOT_FOUND, "command not found: " STR_FMT, STR_ARG(argv[0]));
-    } else {
-      error_emit(error, (i32)ec, "command creation failed: " STR_FMT ": %lu", STR_ARG(argv[0]), ec);
-    }
-    goto defer;
-  }
-  WaitForSingleObject(pi.hProcess, INFINITE);
+Bytes bytes_from_parts(usize size, const void *data);
 
-  DWORD exit_code = 0;
-  if (!GetExitCodeProcess(pi.hProcess, &exit_code)) {
-    DWORD ec = GetLastError();
-    error_emit(error, (i32)ec, "Could not get exit code of process: " STR_FMT ": %lu",
-               STR_ARG(argv[0]), ec);
-    goto defer;
-  }
-  if (exit_code != 0) {
-    error_emit(error, (i32)exit_code, "command failed: " STR_FMT ": %lu", STR_ARG(command),
-               exit_code);
-    goto defer;
-  }
+////////////////////////////////////////////////////////////////////////////
 
-defer:
-  arena_free(&arena);
-  CloseHandle(pi.hProcess);
-  CloseHandle(pi.hThread);
-}
+Bytes bytes_copy(Bytes bytes, Arena *arena);
 
 ////////////////////////////////////////////////////////////////////////////
-#endif
 
-// #include "dll.h"
+Bytes bytes_slice(Bytes bytes, usize idx1, size_t idx2);
+Bytes bytes_take(Bytes *bytes, usize count);
 
-// #include "cebus/core/platform.h"
-// #include "cebus/os/fs.h"
-// #include "cebus/type/integer.h"
-// #include "cebus/type/string.h"
+////////////////////////////////////////////////////////////////////////////
 
-#include <stdio.h>
-#include <string.h>
+bool bytes_eq(Bytes b1, Bytes b2);
+u64 bytes_hash(Bytes bytes);
+u64 bytes_hash_seed(Bytes bytes, u64 seed);
 
-//////////////////////////////////////////////////////////////////////////////
-#if defined(LINUX)
-#include <dlfcn.h>
+////////////////////////////////////////////////////////////////////////////
 
-Dll *dll_load(Path path, Error *error) {
-  if (!fs_exists(path)) {
-    error_emit(error, FS_NOT_FOUND, "dll: library does not exist: " STR_FMT, STR_ARG(path));
-    return NULL;
-  }
-  char lib_path[FILENAME_MAX] = {0};
-  memcpy(lib_path, path.data, usize_min(path.len, FILENAME_MAX));
+typedef struct {
+  u64 seed;
+  u64 lanes[4];
+  u64 total;
+  usize buffered;
+  u8 buffer[32];
+} Hasher;
+
+Hasher hasher_init(u64 seed);
+void hasher_update(Hasher *hasher, Bytes bytes);
+void hasher_update_u64(Hasher *hasher, u64 value);
+void hasher_update_i64(Hasher *hasher, i64 value);
+void hasher_update_f64(Hasher *hasher, f64 value);
+void hasher_update_str(Hasher *hasher, Str s);
+u64 hasher_final(const Hasher *hasher);
 
-  Dll *handle = dlopen(lib_path, RTLD_LAZY);
-  if (handle == NULL) {
-    error_emit(error, -1, "dll: %s: %s\n", lib_path, dlerror());
-    return NULL;
-  }
-  return handle;
-}
+////////////////////////////////////////////////////////////////////////////
 
-void dll_close(Dll *handle) { dlclose(handle); }
+Str bytes_to_hex(Bytes bytes, Arena *arena);
+Bytes bytes_from_hex(Str s, Arena *arena);
 
-Function dll_symbol(Dll *handle, Str symbol, Error *error) {
-  Arena arena = {0};
-  symbol = str_copy(symbol, &arena);
+////////////////////////////////////////////////////////////////////////////
 
-  Function fn;
-  *(void **)(&fn) = dlsym(handle, symbol.data);
-  if (fn == NULL) {
-    error_emit(error, -1, "dll function: %s: %s\n", symbol.data, dlerror());
-    goto defer;
-  }
+#endif /* !__CEBUS_BYTES_H__ */
 
-defer:
-  arena_free(&arena);
-  return fn;
-}
-
-//////////////////////////////////////////////////////////////////////////////
-#elif defined(WINDOWS)
+/* DOCUMENTATION
+## Character Classification Functions
 
-Dll *dll_load(Str path, Error *error) {
-  if (!fs_exists(path)) {
-    error_emit(error, -1, "dll: library does not exist: " STR_FMT, STR_ARG(path));
-    return NULL;
-  }
-  char lib_path[FILENAME_MAX] = {0};
-  memcpy(lib_path, path.data, usize_min(path.len, FILENAME_MAX));
+- `c_is_alnum(c)`: Checks if a character is alphanumeric.
+- `c_is_alpha(c)`: Checks if a character is alphabetic.
+- `c_is_lower(c)`: Checks if a character is lowercase.
+- `c_is_upper(c)`: Checks if a character is uppercase.
+- `c_is_space(c)`: Checks if a character is a whitespace character.
+- `c_is_cntrl(c)`: Checks if a character is a control character.
+- `c_is_print(c)`: Checks if a character is printable.
+- `c_is_graph(c)`: Checks if a character has a graphical representation.
+- `c_is_blank(c)`: Checks if a character is blank (space or tab).
+- `c_is_punct(c)`: Checks if a character is punctuation.
+- `c_is_digit(c)`: Checks if a character is a digit.
+- `c_is_xdigit(c)`: Checks if a character is a hexadecimal digit.
 
-  char temp_path[MAX_PATH];
-  GetTempPath(MAX_PATH, temp_path);
+## Character Conversion Functions
 
-  char temp_file_name[MAX_PATH];
-  GetTempFileName(temp_path, TEXT("lib"), 0, temp_file_name);
-  CopyFile(lib_path, temp_file_name, 0);
+- `c_to_lower(c)`: Converts a character to lowercase.
+- `c_to_upper(c)`: Converts a character to uppercase.
+- `c_to_u8(c)`: Converts a character to an unsigned 8-bit integer.
+- `c_hex_to_u8(c)`: Converts a hexadecimal character to an unsigned 8-bit
+integer.
+- `c_u8_to_c(d)`: Converts an unsigned 8-bit integer to a character.
+- `c_u8_to_hex(d)`: Converts an unsigned 8-bit integer to a hexadecimal
+character (lowercase).
+- `c_u8_to_HEX(d)`: Converts an unsigned 8-bit integer to a hexadecimal
+character (uppercase).
+*/
 
-  HINSTANCE handle = LoadLibraryA(temp_file_name);
-  if (handle == NULL) {
-    DWORD ec = GetLastError();
-    error_emit(error, (i32)ec, "error loading library: " STR_FMT ": %lu\n", STR_ARG(path),
-               GetLastError());
-    return NULL;
-  }
-  return handle;
-}
+#ifndef __CEBUS_CHAR_H__
+#define __CEBUS_CHAR_H__
 
-void dll_close(Dll *handle) {
-  char temp_file_name[MAX_PATH];
-  GetModuleFileName(handle, temp_file_name, MAX_PATH);
-  FreeLibrary(handle);
-  DeleteFile(temp_file_name);
-}
+// #include "cebus/core/defines.h"
 
-Function dll_symbol(Dll *handle, Str symbol, Error *error) {
-  Arena arena = {0};
-  symbol = str_copy(symbol, &arena);
-  Function fn = (Function)GetProcAddress(handle, symbol.data);
-  if (fn == NULL) {
-    DWORD err_code = GetLastError();
-    error_emit(error, (i32)err_code, "dll function: %s: %lu\n", symbol.data, err_code);
-    goto defer;
-  }
+///////////////////////////////////////////////////////////////////////////////
 
-defer:
-  arena_free(&arena);
-  return fn;
-}
+CONST_FN bool c_is_alnum(char c);
+CONST_FN bool c_is_alpha(char c);
+CONST_FN bool c_is_lower(char c);
+CONST_FN bool c_is_upper(char c);
+CONST_FN bool c_is_space(char c);
+CONST_FN bool c_is_cntrl(char c);
+CONST_FN bool c_is_print(char c);
+CONST_FN bool c_is_graph(char c);
+CONST_FN bool c_is_blank(char c);
+CONST_FN bool c_is_punct(char c);
+CONST_FN bool c_is_digit(char c);
+CONST_FN bool c_is_xdigit(char c);
 
-//////////////////////////////////////////////////////////////////////////////
-#endif
+///////////////////////////////////////////////////////////////////////////////
 
-// #include "fs.h"
+CONST_FN char c_to_lower(char c);
+CONST_FN char c_to_upper(char c);
 
-// #include "cebus/core/debug.h"
-// #include "cebus/core/error.h"
-// #include "cebus/type/path.h"
-// #include "cebus/type/string.h"
-// #include "cebus/type/utf8.h"
-// #include "io.h"
+CONST_FN u8 c_to_u8(char c);
+CONST_FN u8 c_hex_to_u8(char c);
 
-#include <errno.h>
-#include <stdio.h>
-#include <string.h>
+CONST_FN char c_u8_to_c(u8 d);
+CONST_FN char c_u8_to_hex(u8 d);
+CONST_FN char c_u8_to_HEX(u8 d);
 
-////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
 
-static usize file_size(FILE *handle, Error *error) {
-  fseek(handle, 0, SEEK_END);
-  const long size = ftell(handle);
-  fseek(handle, 0, SEEK_SET);
-  if (size < 0) {
-    error_emit(error, errno, "Could not get file size: %s", strerror(errno));
-    return 0;
-  }
-  return (usize)size;
-}
+#endif /* !__CEBUS_CHAR_H__ */
 
-////////////////////////////////////////////////////////////////////////////
+/* DOCUMENTATION
+## Character Sets
+
+A `CharSet` is a table with one bit for each of the 256 byte values. It is
+built once, from a predicate or from a list of characters, and then replaces
+calling a predicate for every character. Scanning a string checks 32 bytes at
+once with AVX2, if the CPU supports it.
+
+- `charset_from_predicate(predicate)`: Contains every character for which
+`predicate` returns `true`.
+- `charset_from_str(chars)`: Contains every character of `chars`.
+- `charset_invert(set)`: Contains every character that `set` does not contain.
+- `charset_contains(&set, c)`: Checks if `c` is in the set.
+- `charset_span(&set, str)`, `charset_cspan(&set, str)`: Number of characters
+at the start of the string that are or are not in the set, like `strspn` and
+`strcspn`.
+- `charset_rspan(&set, str)`, `charset_rcspan(&set, str)`: Same for the end of
+the string.
+- `charset_count(&set, str)`: Number of characters of the string that are in
+the set.
+
+The string functions `str_trim_by_charset`, `str_chop_by_charset`,
+`str_split` etc. use these.
 
-FILE *fs_file_open(Path path, const char *mode, Error *error) {
-  char _filename[FILENAME_MAX] = {0};
-  memcpy(_filename, path.data, path.len);
-  errno = 0;
-  FILE *handle = fopen(_filename, mode);
-  if (handle == NULL) {
-    error_emit(error, errno, "Could not open file: '%s': %s", _filename, strerror(errno));
-  }
-  return handle;
-}
+```c
+const CharSet separators = charset_from_predicate(c_is_space);
+const usize word = charset_cspan(&separators, STR("hello world"));
+```
+*/
 
-void fs_file_close(FILE *file, Error *error) {
-  if (file == NULL) {
-    error_emit(error, FS_INVALID, "can't close a FILE* that is NULL");
-    return;
-  }
-  errno = 0;
-  int ret = fclose(file);
-  if (ret == EOF) {
-    error_emit(error, errno, "closing file failed: %s", strerror(errno));
-  }
-}
+#ifndef __CEBUS_CHARSET_H__
+#define __CEBUS_CHARSET_H__
 
-Bytes fs_file_read_bytes(Path filename, Arena *arena, Error *error) {
-  Bytes result = {0};
+// #include "cebus/core/defines.h"
 
-  FILE *handle = fs_file_open(filename, "rb", error);
-  error_propagate(error, { goto defer; });
+///////////////////////////////////////////////////////////////////////////////
 
-  usize size = file_size(handle, error);
-  error_propagate(error, { goto defer; });
+// Bit 'c >> 4 & 7' of byte 'c & 0x0f | c >> 3 & 0x10' is set if 'c' is in the
+// set. Every half is indexed by the low nibble, so a shuffle can look up 32
+// characters at once.
+typedef struct {
+  u8 table[32];
+} CharSet;
 
-  u8 *buffer = arena_alloc(arena, size);
+CharSet charset_from_predicate(bool (*predicate)(char));
+CharSet charset_from_str(Str chars);
+CONST_FN CharSet charset_invert(CharSet set);
 
-  result = io_read_bytes(handle, size, buffer, error);
-  error_propagate(error, { goto defer; });
+bool charset_contains(const CharSet *set, char c);
 
-defer:
-  if (handle) {
-    fs_file_close(handle, error);
-  }
-  return result;
-}
+///////////////////////////////////////////////////////////////////////////////
 
-Str fs_file_read_str(Path filename, Arena *arena, Error *error) {
-  Bytes result = {0};
+usize charset_span(const CharSet *set, Str s);
+usize charset_cspan(const CharSet *set, Str s);
+usize charset_rspan(const CharSet *set, Str s);
+usize charset_rcspan(const CharSet *set, Str s);
 
-  FILE *handle = fs_file_open(filename, "r", error);
-  error_propagate(error, { goto defer; });
+usize charset_count(const CharSet *set, Str s);
 
-  usize size = file_size(handle, error);
-  error_propagate(error, { goto defer; });
+///////////////////////////////////////////////////////////////////////////////
 
-  u8 *buffer = arena_alloc(arena, size + 1);
-  buffer[size] = '\0';
+#endif /* !__CEBUS_CHARSET_H__ */
 
-  result = io_read_bytes(handle, size, buffer, error);
-  error_propagate(error, { goto defer; });
+/* DOCUMENTATION
+## Functions
 
-defer:
-  if (handle) {
-    fs_file_close(handle, error);
-  }
-  return str_from_bytes(result);
-}
+These functions are available for `f32` and `f64`.
 
-Utf8 fs_file_read_utf8(Path filename, Arena *arena, Error *error) {
-  Bytes result = {0};
+- `f32_eq(a, b)`: Tests if two `f32` are equal.
+- `f32_eq_eps(a, b)`: Tests if two `f32` are equal within a give epsilon.
+- `f32_isnan(value)`: Tests if `f32` is `nan`.
+- `f32_abs(value)`: Returns the absolute value.
+- `f32_min(a, b)`: Returns the min of `a` or `b`.
+- `f32_max(a, b)` Returns the max of `a` or b.
+- `f32_clamp(min, max, value)`: Clamps a `f32` between `min` and `max`.
+- `f32_lerp(min, max, value)`: Linear interpolation between `min` and `max`.
+- `f32_rad(deg)`: Converts degrees to radians.
+- `f32_deg(rad)`: Converts radians to degrees.
 
-  FILE *handle = fs_file_open(filename, "r", error);
-  error_propagate(error, { goto defer; });
+These are only available for `f64`:
 
-  usize size = file_size(handle, error);
-  error_propagate(error, { goto defer; });
+- `f64_exp(x)`, `f64_ln(x)`, `f64_sqrt(x)`: The exponential function, the
+natural logarithm and the square root. The sketches need them for sizing and
+estimates, and they are implemented here so the library does not have to link
+against libm. They are close to, but not always exactly, the results of
+`<math.h>`.
+*/
 
-  u8 *buffer = arena_alloc(arena, size + 1);
-  buffer[size] = '\0';
+#ifndef __CEBUS_FLOATS_H__
+#define __CEBUS_FLOATS_H__
 
-  result = io_read_bytes(handle, size, buffer, error);
-  error_propagate(error, { goto defer; });
+// #include "cebus/core/defines.h"
 
-defer:
-  if (handle) {
-    fs_file_close(handle, error);
-  }
+#define FLOAT_DECL(T)                                                                              \
+  CONST_FN bool T##_eq(T a, T b);                                                                  \
+  CONST_FN bool T##_eq_eps(T a, T b, T epsilon);                                                   \
+  CONST_FN bool T##_isnan(T value);                                                                \
+  CONST_FN T T##_abs(T value);                                                                     \
+  CONST_FN T T##_min(T a, T b);                                                                    \
+  CONST_FN T T##_max(T a, T b);                                                                    \
+  CONST_FN T T##_clamp(T min, T max, T value);                                                     \
+  CONST_FN T T##_lerp(T min, T max, T value);                                                      \
+  CONST_FN T T##_rad(T deg);                                                                       \
+  CONST_FN T T##_deg(T rad);
 
-  Utf8 res = utf8_decode(result, error);
-  error_propagate(error, { return (Utf8){0}; });
-  return res;
-}
+FLOAT_DECL(f32)
+FLOAT_DECL(f64)
 
-void fs_file_write_bytes(Path filename, Bytes bytes, Error *error) {
-  FILE *handle = fs_file_open(filename, "w", error);
-  error_propagate(error, { goto defer; });
+#undef FLOAT_DECL
 
-  io_write_bytes(handle, bytes, error);
-  error_propagate(error, { goto defer; });
+CONST_FN f64 f64_exp(f64 x);
+CONST_FN f64 f64_ln(f64 x);
+CONST_FN f64 f64_sqrt(f64 x);
 
-defer:
-  if (handle) {
-    fclose(handle);
-  }
-}
+#endif /* !__CEBUS_FLOATS_H__ */
 
-void fs_file_write_str(Path filename, Str content, Error *error) {
-  fs_file_write_bytes(filename, str_to_bytes(content), error);
-}
+/* DOCUMENTATION
 
-void fs_file_write_utf8(Path filename, Utf8 content, Error *error) {
-  Bytes bytes = utf8_encode(content, error);
-  error_propagate(error, { return; });
-  fs_file_write_bytes(filename, bytes, error);
-}
+All these functions are defined for these types: `u8`, `i8`, `u16`, `i16`,
+`u32`, `i32`, `u64`, `i64`, `usize`.
 
-void fs_rename(Path old_path, Path new_path, Error *error) {
-  char _old_path[FILENAME_MAX] = {0};
-  memcpy(_old_path, old_path.data, old_path.len);
+## Bit Operations
 
-  char _new_path[FILENAME_MAX] = {0};
-  memcpy(_new_path, new_path.data, new_path.len);
+- `T_reverse_bits(T value)`: Reverses the bits in `value`.
+- `T_leading_ones(T value)`: Counts the number of leading ones in `value`.
+- `T_trailing_ones(T value)`: Counts the number of trailing ones in `value`.
+- `T_leading_zeros(T value)`: Counts the number of leading zeros in `value`.
+- `T_trailing_zeros(T value)`: Counts the number of trailing zeros in `value`.
+- `T_count_zeros(T value)`: Counts the number of zeros in `value`.
+- `T_count_ones(T value)`: Counts the number of ones in `value`.
 
-  errno = 0;
-  int ret = rename(_old_path, _new_path);
-  if (ret == -1) {
-    error_emit(error, errno, "Could not rename the file: " STR_FMT ": %s", STR_ARG(old_path),
-               strerror(errno));
-  }
-}
+## Byte Order Operations
 
-void fs_remove(Path path, Error *error) {
-  char _path[FILENAME_MAX] = {0};
-  memcpy(_path, path.data, path.len);
+- `T_swap_bytes(T value)`: Swaps the byte order of `value`.
+- `T_to_be(T value)`: Converts `value` to big endian format.
+- `T_from_be(T value)`: Converts `value` from big endian format.
+- `T_to_le(T value)`: Converts `value` to little endian format.
+- `T_from_le(T value)`: Converts `value` from little endian format.
+- `T_to_ne_bytes(T value)`: Converts `value` to native endian format.
 
-  errno = 0;
-  int ret = remove(_path);
-  if (ret == -1) {
-    error_emit(error, errno, "Could not remove the file: " STR_FMT ": %s", STR_ARG(path),
-               strerror(errno));
-  }
-}
+## Math Operations
 
-bool fs_iter_next_filter(FsIter *it, bool (*filter)(FsEntity *entity)) {
-  while (fs_iter_next(it)) {
-    if (filter(&it->current)) {
-      return true;
-    }
-  }
-  return false;
-}
+Basic math operations including max, min, and clamp are provided.
 
-bool fs_iter_next_directory(FsIter *it) {
-  while (fs_iter_next(it)) {
-    if (it->current.is_dir) {
-      return true;
-    }
-  }
-  return false;
-}
+- `T_max(T a, T b)`: Returns the maximum of `a` and `b`.
+- `T_min(T a, T b)`: Returns the minimum of `a` and `b`.
+- `T_clamp(T min, T max, T value)`: Clamps `value` between `min` and `max`.
 
-bool fs_iter_next_files(FsIter *it) {
-  while (fs_iter_next(it)) {
-    if (!it->current.is_dir) {
-      return true;
-    }
-  }
-  return false;
-}
+## Utilities
 
-bool fs_iter_next_suffix(FsIter *it, Str suffix) {
-  while (fs_iter_next_files(it)) {
-    if (str_eq(path_suffix(it->current.path), suffix)) {
-      return true;
-    }
-  }
-  return false;
-}
+- `T_hash(T value)`: Generates a hash for `value`. This is the splitmix64 mixer,
+a few multiplications and shifts without any division. Different values never
+get the same hash, and the high bits are as good as the low ones, so they can
+index power of two tables.
+- `T_hash_seed(T value, u64 seed)`: Same with another seed, for example to get
+independent hash functions. Seed `0` gives `T_hash`.
+- `u64_hash_batch(count, values, hashes, seed)`: Writes `u64_hash_seed` of
+every value into `hashes`, four at a time with AVX2.
+- `u64_mix(hash)`: Remixes a hash that is already a hash, with the finalizer
+of MurmurHash3. The sketches use it to derive their indices, so they also work
+with hashes whose low or high bits are weak.
+- `T_swap(T *v1, T *v2)`: Swaps the values of `v1` and `v2`.
+- `T_compare_lt(T a, T b)`: Compares `a` and `b` for less than.
+- `T_compare_gt(T a, T b)`: Compares `a` and `b` for greater than.
+- `T_compare_qsort(CmpOrdering ordering)`: Provides a comparison function
+suitable for `qsort`.
 
-////////////////////////////////////////////////////////////////////////////
-#if defined(LINUX)
+*/
 
-#include <dirent.h>
-#include <sys/stat.h> // For struct stat and S_ISDIR
-#include <unistd.h>
+#ifndef __CEBUS_INTEGERS_H__
+#define __CEBUS_INTEGERS_H__
 
-typedef struct FsNode {
-  DIR *handle;
-  struct FsNode *next;
-  char name[];
-} FsNode;
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h"
 
-bool fs_exists(Path path) {
-  char _path[FILENAME_MAX] = {0};
-  memcpy(_path, path.data, path.len);
-  return access(_path, 0) == 0;
-}
+#define INTEGER_DECL(T)                                                                            \
+  /* BIT OPERATIONS */                                                                             \
+  CONST_FN T T##_reverse_bits(T value);                                                            \
+  CONST_FN usize T##_leading_ones(T value);                                                        \
+  CONST_FN usize T##_trailing_ones(T value);                                                       \
+  CONST_FN usize T##_leading_zeros(T value);                                                       \
+  CONST_FN usize T##_trailing_zeros(T value);                                                      \
+  CONST_FN usize T##_count_zeros(T value);                                                         \
+  CONST_FN usize T##_count_ones(T value);                                                          \
+  /* BIT OPERATIONS END */                                                                         \
+                                                                                                   \
+  /* BYTE ORDER OPERATIONS */                                                                      \
+  CONST_FN T T##_swap_bytes(T value);                                                              \
+  /*  BIG ENDIAN OPERATIONS */                                                                     \
+  CONST_FN T T##_to_be(T value);                                                                   \
+  CONST_FN T T##_from_be(T value);                                                                 \
+  T T##_from_be_bytes(Bytes bytes);                                                                \
+  Bytes T##_to_be_bytes(T value, Arena *arena);                                                    \
+  /*  LITTLE ENDIAN OPERATIONS */                                                                  \
+  CONST_FN T T##_to_le(T value);                                                                   \
+  CONST_FN T T##_from_le(T value);                                                                 \
+  T T##_from_le_bytes(Bytes bytes);                                                                \
+  Bytes T##_to_le_bytes(T value, Arena *arena);                                                    \
+  /*  NATIVE ENDIAN OPERATIONS */                                                                  \
+  T T##_from_ne_bytes(Bytes bytes);                                                                \
+  Bytes T##_to_ne_bytes(T value, Arena *arena);                                                    \
+  /* BYTE ORDER OPERATIONS END */                                                                  \
+                                                                                                   \
+  /* MATH OPERATIONS */                                                                            \
+  CONST_FN T T##_max(T a, T b);                                                                    \
+  CONST_FN T T##_min(T a, T b);                                                                    \
+  CONST_FN T T##_clamp(T min, T max, T value);                                                     \
+  /* MATH OPERATIONS END */                                                                        \
+                                                                                                   \
+  /* UTILS */                                                                                      \
+  CONST_FN u64 T##_hash(T value);                                                                  \
+  CONST_FN u64 T##_hash_seed(T value, u64 seed);                                                   \
+  void T##_swap(T *v1, T *v2);                                                                     \
+  CONST_FN CmpOrdering T##_compare_lt(T a, T b);                                                   \
+  CONST_FN CmpOrdering T##_compare_gt(T a, T b);                                                   \
+  CONST_FN CompareFn T##_compare_qsort(CmpOrdering ordering);                                      \
+  /* UTILS END */
 
-bool fs_is_dir(Path path) {
-  char _path[FILENAME_MAX] = {0};
-  memcpy(_path, path.data, path.len);
+INTEGER_DECL(u8)
+INTEGER_DECL(i8)
+INTEGER_DECL(u16)
+INTEGER_DECL(i16)
+INTEGER_DECL(u32)
+INTEGER_DECL(i32)
+INTEGER_DECL(u64)
+INTEGER_DECL(i64)
+INTEGER_DECL(usize)
 
-  struct stat entry_info;
-  if (stat(_path, &entry_info) == -1) {
-    return false;
-  }
+#undef INTEGER_DECL
 
-  return S_ISDIR(entry_info.st_mode);
-}
+void u64_hash_batch(usize count, const u64 *values, u64 *hashes, u64 seed);
+CONST_FN u64 u64_mix(u64 hash);
 
-FsIter fs_iter_begin(Path directory, bool recursive) {
-  FsIter it = {.recursive = recursive, .error = ErrNew};
+#endif /* !__CEBUS_INTEGERS_H__ */
 
-  const usize size = sizeof(FsNode) + directory.len + 1;
-  FsNode *node = arena_calloc_chunk(&it.scratch, size);
-  memcpy(node->name, directory.data, directory.len);
+/* DOCUMENTATION
+## Functions
 
-  node->handle = opendir(node->name);
-  if (node->handle == NULL) {
-    error_emit(&it.error, errno, "opendir failed: %s", strerror(errno));
-    return it;
-  }
-  it._stack = node;
-  return it;
-}
+Reductions over arrays of numbers. They take a count and a pointer, so a
+dynamic array can be passed with `DA_ARG`. They use AVX2 or SSE2 if the CPU
+supports it and fall back to a scalar implementation otherwise.
 
-void fs_iter_end(FsIter *it, Error *error) {
-  error_propagate(&it->error, {
-    if (!error) {
-      error_panic();
-    }
-    const FileLocation loc = error->location;
-    bool panic = error->panic_on_emit;
-    *error = it->error;
-    error->location = loc;
-    if (panic) {
-      error_panic();
-    }
-  });
-  while (it->_stack != NULL) {
-    FsNode *current = it->_stack;
-    it->_stack = current->next;
-    closedir(current->handle);
-    arena_free_chunk(&it->scratch, current);
-  }
-  arena_free(&it->scratch);
-}
+These functions are available for `f32`, `f64`, `i64` and `u64`.
 
-bool fs_iter_next(FsIter *it) {
-  while (it->_stack != NULL) {
-    arena_reset(&it->scratch);
-    FsNode *current = it->_stack;
+- `T_sum(count, values)`: Returns the sum of the values.
+- `T_minmax(count, values, min, max)`: Writes the smallest and the biggest
+value into `min` and `max`. Returns `false` if there are no values.
+- `T_dot(count, a, b)`: Returns the dot product of two arrays.
+- `T_prefix_sum(count, values, out)`: Writes the inclusive prefix sums into
+`out`. `out` can be `values`.
+- `T_histogram(count, values, min, max, bins, counts)`: Splits `[min, max)`
+into `bins` bins of the same width and adds the number of values in every bin
+to `counts`. Values outside of the range are ignored. For integers, the value
+`v` goes into bin `(v - min) * bins / (max - min)`, so if the range is not a
+multiple of `bins` some bins are one wider than others.
 
-    struct dirent *entry = readdir(current->handle);
-    if (entry == NULL) {
-      closedir(current->handle);
-      it->_stack = current->next;
-      arena_free_chunk(&it->scratch, current);
-      continue;
-    }
+```c
+DA(f64) samples = da_new(&arena);
+// ...
+f64 mean = f64_sum(DA_ARG(&samples)) / (f64)da_len(&samples);
+f64 min, max;
+f64_minmax(DA_ARG(&samples), &min, &max);
+```
 
-    // skip "." and ".." directories
-    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
-      continue;
-    }
+The floating point functions add the values in multiple lanes, so the result
+can differ from a simple loop in the last bits. The integer functions wrap
+around on overflow.
+*/
 
-    Str path = str_format(&it->scratch, "%s/%s", current->name, entry->d_name);
+#ifndef __CEBUS_NUMERIC_H__
+#define __CEBUS_NUMERIC_H__
 
-    struct stat entry_info;
-    if (stat(path.data, &entry_info) == -1) {
-      error_emit(&it->error, errno, "stat failed: %s", strerror(errno));
-      return false;
-    }
+// #include "cebus/core/defines.h"
 
-    it->current.path = path;
-    it->current.is_dir = S_ISDIR(entry_info.st_mode);
+#define NUMERIC_DECL(T)                                                                            \
+  T T##_sum(usize count, const T *values);                                                         \
+  bool T##_minmax(usize count, const T *values, T *min, T *max);                                   \
+  T T##_dot(usize count, const T *a, const T *b);                                                  \
+  void T##_prefix_sum(usize count, const T *values, T *out);                                       \
+  void T##_histogram(usize count, const T *values, T min, T max, usize bins, usize *counts);
 
-    if (it->current.is_dir && it->recursive) {
-      const usize size = sizeof(FsNode) + path.len + 1;
-      FsNode *node = arena_calloc_chunk(&it->scratch, size);
-      memcpy(node->name, path.data, path.len);
-      node->handle = opendir(path.data);
-      if (node->handle == NULL) {
-        error_emit(&it->error, errno, "opendir failed: %s", strerror(errno));
-        return false;
-      }
-      node->next = it->_stack;
-      it->_stack = node;
-    }
+NUMERIC_DECL(f32)
+NUMERIC_DECL(f64)
+NUMERIC_DECL(i64)
+NUMERIC_DECL(u64)
 
-    return true;
-  }
+#undef NUMERIC_DECL
 
-  return false;
-}
+#endif /* !__CEBUS_NUMERIC_H__ */
 
-//////////////////////////////////////////////////////////////////////////////
-#elif defined(WINDOWS)
+#ifndef __CEBUS_PATH_H__
+#define __CEBUS_PATH_H__
 
-#include <io.h>
+// #include "cebus/collection/da.h"
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h" // IWYU pragma: export
 
-typedef struct FsNode {
-  HANDLE handle;
-  struct FsNode *next;
-  usize len;
-  char name[];
-} FsNode;
+typedef DA(Path) PathDa;
 
-bool fs_exists(Path path) {
-  char _path[FILENAME_MAX] = {0};
-  memcpy(_path, path.data, path.len);
-  return _access(_path, 0) == 0;
-}
-
-bool fs_is_dir(Path path) {
-  char _path[FILENAME_MAX] = {0};
-  memcpy(_path, path.data, path.len);
-  DWORD attributes = GetFileAttributes(_path);
-  if (attributes == INVALID_FILE_ATTRIBUTES) {
-    return false;
-  }
-  if (attributes & FILE_ATTRIBUTE_DIRECTORY) {
-    return true;
-  }
+#define path_new(arena, ...)                                                                       \
+  path_join(arena, ARRAY_LEN((Path[]){__VA_ARGS__}), (Path[]){__VA_ARGS__})
 
-  return false;
-}
+Path path_join(Arena *arena, usize size, Path *paths);
+Path path_join_da(Arena *arena, PathDa *da);
 
-FsIter fs_iter_begin(Path directory, bool recursive) {
-  FsIter it = {.recursive = recursive, .error = ErrNew};
+Str path_name(Path path);
+Str path_suffix(Path path);
+Str path_stem(Path path);
+Path path_parent(Path path);
 
-  const usize len = directory.len + (sizeof("/*") - 1);
-  const usize size = sizeof(FsNode) + len + 1;
-  FsNode *node = arena_calloc_chunk(&it.scratch, size);
-  memcpy(node->name, directory.data, directory.len);
-  memcpy(&node->name[directory.len], "/*", 2);
-  node->len = len;
+// TODO
+// keep it io-less. i want a "pure" path api
+// TODO: operating system dependent delimiter
+// bool path_relative(Path path);
+// bool path_absolute(Path path);
+// bool path_relative_to(Path p1, Path p2);
+// Path path_resolve(Path path);
+// void path_collect_parts(Path path, PathDa* da);
+// void path_collect_parents(Path path, PathDa* da);
 
-  WIN32_FIND_DATA findFileData;
-  node->handle = FindFirstFile(node->name, &findFileData);
-  if (node->handle == INVALID_HANDLE_VALUE) {
-    DWORD err = GetLastError();
-    error_emit(&it.error, (i32)err, "FindFirstFile failed (%ld)\n", err);
-    return it;
-  }
+#endif /* !__CEBUS_PATH_H__ */
 
-  it._stack = node;
+/* DOCUMENTATION
+## Features and Functions
+- **String Creation and Printing**:
+  - `STR("Hello World")`: Create a new string from a string literal.
+  - `STR_STATIC("Hello")`: Create a new static string from a string literal.
+  - `str_from_cstr(str)`: Create new string from a char array.
+  - `str_from_bytes(str)`: Create new string from bytes.
+  - `str_format(fmt, ...)`: Create new string as formated.
+  - `str_from_u64(n, &arena)`, `str_from_i64(n, &arena)`, `str_from_hex(n,
+&arena)`, `str_from_f64(n, &arena)`: Format a number without `printf`, like
+the `sb_append_*` functions of the `StringBuilder`.
+  - `printf(STR_FMT"\n", STR_ARG(str))`: Print strings using macros.
 
-  return it;
-}
+- **String Manipulation**:
+  - `str_lower(str, &arena)`, `str_upper(str, &arena)`: Convert to lower or
+upper case.
+  - `str_append(str, suffix, &arena)`, `str_prepend(str, prefix, &arena)`:
+Append or prepend strings.
+  - `str_wrap(str, wrap, &arena)`: Wrap a string.
+  - `str_join(sep, count, strs, &arena)`: Join strings with a separator.
 
-void fs_iter_end(FsIter *it, Error *error) {
-  error_propagate(&it->error, {
-    if (!error) {
-      error_panic();
-    }
-    const FileLocation loc = error->location;
-    bool panic = error->panic_on_emit;
-    *error = it->error;
-    error->location = loc;
-    if (panic) {
-      error_panic();
-    }
-  });
-  while (it->_stack != NULL) {
-    FsNode *current = it->_stack;
-    it->_stack = current->next;
-    FindClose(current->handle);
-    arena_free_chunk(&it->scratch, current);
-  }
-  arena_free(&it->scratch);
-}
+- **String Trimming and Slicing**:
+  - `str_trim(str)`, `str_trim_left(str)`, `str_trim_right(str)`: Trim
+whitespace.
+  - `str_chop_by_delim(str, delim)`, `str_try_chop_by_delim(str, delim,
+&chunk)`: Chop strings by delimiter.
+  - `str_trim_by_charset(str, &set)`, `str_chop_by_charset(&str, &set)`,
+`str_try_chop_by_charset(&str, &set, &chunk)`, etc.: Same as the `_by_predicate`
+versions, with a `CharSet` that is built once instead of calling a predicate
+for every character.
+  - `str_split(str, &set, list)`: Appends every run of characters that are not
+in the set to a `DA(Str)`, in a single pass. Empty fields are skipped.
+  - `str_substring(str, start, end)`: Extract a substring.
 
-bool fs_iter_next(FsIter *it) {
-  while (it->_stack != NULL) {
-    arena_reset(&it->scratch);
-    FsNode *current = it->_stack;
+- **String Comparison and Search**:
+  - `str_eq(s1, s2)`, `str_eq_ignorecase(s1, s2)`: Check string equality.
+  - `str_startswith(str, prefix)`, `str_endswith(str, suffix)`: Check
+prefixes/suffixes.
+  - `str_contains(haystack, needle)`: Check if string contains a substring.
+  - `str_find(haystack, needle)`, `str_find_last(haystack, needle)`: Find the
+first or last position of a substring.
+  - `str_find_ignorecase(haystack, needle)`: Find the first position of a
+substring, ignoring the case of ASCII letters.
+  - `str_count(haystack, needle)`: Count the non overlapping occurrences of a
+substring.
+  - `str_count_by_charset(str, &set)`: Count the characters that are in a
+`CharSet`.
+
+The search compares the first and last byte of the needle at 16 or 32
+positions at once with SSE2 or AVX2, if the CPU supports it.
 
-    WIN32_FIND_DATA findFileData;
-    if (!FindNextFile(current->handle, &findFileData)) {
-      FindClose(current->handle);
-      it->_stack = current->next;
-      arena_free_chunk(&it->scratch, current);
-      continue;
-    }
+- **Conversion and Utility**:
+  - `str_u64(str)`, `str_i64(str)`, `str_f64(str)`: Parse a number at the
+start of the string, like `strtoull`, `strtoll` and `strtod`. They return `0`
+if there is no number.
+  - `str_chop_u64(&str)`, `str_chop_i64(&str)`, `str_chop_f64(&str)`: Same, and
+remove the number from the string.
+  - `str_parse_u64(str, error)`, `str_parse_i64(str, error)`,
+`str_parse_f64(str, error)`: The whole string has to be the number. Emits
+`STR_PARSE_INVALID` or `STR_PARSE_OVERFLOW` and returns `0` otherwise.
+  - `str_parse_u64_da(str, delim, list, error)`, `str_parse_i64_da(...)`,
+`str_parse_f64_da(...)`: Parse every field between the delimiters, for
+example a column, and append them to a `DA`. Whitespace around the fields and
+an empty last field are ignored. Stops at the first invalid field.
+  - `str_hash(str)`, `str_hash_seed(str, seed)`: Generate a hash value for a
+string. Same as `bytes_hash` of the string.
+
+The parsers do not allocate. Integers are converted 8 digits at a time. Floats
+with up to 19 significant digits and a small exponent are converted with a
+single exact multiplication or division, everything else goes to `strtod`.
 
-    // skip "." and ".." directories
-    if (strcmp(findFileData.cFileName, ".") == 0 || strcmp(findFileData.cFileName, "..") == 0) {
-      continue;
-    }
+## Usage Example
 
-    Str path = str_format(&it->scratch, "%.*s/%s", (i32)current->len - 2, current->name,
-                          findFileData.cFileName);
+```c
+Arena arena = {0};
+Str greeting = STR("Hello World");
+Str lower = str_lower(greeting, &arena);
+printf(STR_FMT"\n", STR_ARG(lower));
+```
+*/
 
-    it->current.path = path;
-    it->current.is_dir = findFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+#ifndef __CEBUS_STR_H__
+#define __CEBUS_STR_H__
 
-    if (it->current.is_dir && it->recursive) {
-      const usize len = path.len + (sizeof("/*") - 1);
-      const usize size = sizeof(FsNode) + len + 1;
-      FsNode *node = arena_calloc_chunk(&it->scratch, size);
-      memcpy(node->name, path.data, path.len);
-      memcpy(&node->name[path.len], "/*", 2);
-      node->len = len;
-      node->handle = FindFirstFile(node->name, &findFileData);
-      if (node->handle == INVALID_HANDLE_VALUE) {
-        DWORD err = GetLastError();
-        error_emit(&it->error, (i32)err, "FindFirstFile failed (%ld)\n", err);
-        return false;
-      }
-      node->next = it->_stack;
-      it->_stack = node;
-    }
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h" // IWYU pragma: private: include "str.h"
+// #include "cebus/core/error.h"
+// #include "cebus/type/charset.h" // IWYU pragma: export
 
-    return true;
-  }
+///////////////////////////////////////////////////////////////////////////////
 
-  return false;
-}
+#define STR_NOT_FOUND SIZE_MAX
 
-//////////////////////////////////////////////////////////////////////////////
-#endif
+#define STR_LETTERS STR("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz")
+#define STR_UPPERCASE STR("ABCDEFGHIJKLMNOPQRSTUVWXYZ")
+#define STR_LOWERCASE STR("abcdefghijklmnopqrstuvwxyz")
+#define STR_DIGITS STR("0123456789")
+#define STR_HEXDIGITS STR("0123456789abcdefABCDEF")
+#define STR_PUNCTUATION STR("!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~")
+#define STR_WHITESPACE STR(" \t\n\r\x0b\x0c")
 
-// #include "io.h"
+///////////////////////////////////////////////////////////////////////////////
 
-// #include "cebus/type/byte.h"
-// #include "cebus/type/string.h"
+Str str_from_parts(usize size, const char *cstr);
+Str str_from_bytes(Bytes bytes);
+Bytes str_to_bytes(Str s);
+Str str_from_cstr(const char *cstr);
+FMT(2) Str str_format(Arena *arena, const char *fmt, ...);
 
-#include <errno.h>
-#include <stdarg.h>
-#include <stdio.h>
-#include <string.h>
+Str str_from_u64(u64 value, Arena *arena);
+Str str_from_i64(i64 value, Arena *arena);
+Str str_from_hex(u64 value, Arena *arena);
+Str str_from_f64(f64 value, Arena *arena);
 
-////////////////////////////////////////////////////////////////////////////
+///////////////////////////////////////////////////////////////////////////////
 
-#define IO_MAX_INPUT 512
+Str str_copy(Str s, Arena *arena);
+Str str_append(Str s1, Str suffix, Arena *arena);
+Str str_prepend(Str s1, Str prefix, Arena *arena);
+Str str_wrap(Str s, Str wrap, Arena *arena);
 
-////////////////////////////////////////////////////////////////////////////
+// Inserts sep in between elements
+Str str_join(Str sep, usize count, Str *s, Arena *arena);
+// Appends suffix to every element
+Str str_join_suffix(Str suffix, usize count, Str *s, Arena *arena);
+// Prepends prefix to every element
+Str str_join_prefix(Str prefix, usize count, Str *s, Arena *arena);
 
-usize io_write_fmt(FILE *file, const char *fmt, ...) {
-  va_list va;
-  va_start(va, fmt);
-  i32 size = vfprintf(file, fmt, va);
-  va_end(va);
-  return (usize)size;
-}
+Str str_join_wrap(Str sep, Str wrap, usize count, Str *s, Arena *arena);
 
-void io_write_bytes(FILE *file, Bytes bytes, Error *error) {
-  errno = 0;
-  fwrite(bytes.data, sizeof(bytes.data[0]), bytes.size, file);
-  if (ferror(file)) {
-    error_emit(error, errno, "Could not write file: %s", strerror(errno));
-  }
-}
+Str str_upper(Str s, Arena *arena);
+Str str_lower(Str s, Arena *arena);
+Str str_replace(Str s, Str old, Str new, Arena *arena);
+Str str_replace_many(Str s, usize count, const Str *olds, const Str *news, Arena *arena);
+Str str_center(Str s, usize width, char fillchar, Arena *arena);
+Str str_ljust(Str s, usize width, char fillchar, Arena *arena);
+Str str_rjust(Str s, usize width, char fillchar, Arena *arena);
+Str str_repeat(Str s, usize count, Arena *arena);
+Str str_reverse(Str s, Arena *arena);
 
-void io_write_str(FILE *file, Str string, Error *error) {
-  io_write_bytes(file, str_to_bytes(string), error);
-}
+///////////////////////////////////////////////////////////////////////////////
 
-Bytes io_read_bytes(FILE *file, usize size, void *buffer, Error *error) {
-  errno = 0;
-  const usize bytes_read = fread(buffer, sizeof(u8), size, file);
-  if (ferror(file)) {
-    error_emit(error, errno, "Could not read file: %s", strerror(errno));
-    return (Bytes){0};
-  }
-  return bytes_from_parts(bytes_read, buffer);
-}
+bool str_eq(Str s1, Str s2);
+bool str_eq_ignorecase(Str s1, Str s2);
+bool str_startswith(Str s1, Str prefix);
+bool str_endswith(Str s1, Str suffix);
 
-Str io_read_line(FILE *file, usize size, char *buffer, Error *error) {
-  clearerr(file);
-  if (fgets(buffer, (int)size, file) == NULL) {
-    if (ferror(file)) {
-      error_emit(error, errno, "Could not read line: %s", strerror(errno));
-      return (Str){0};
-    }
-    error_emit(error, EOF, "EOF");
-    return (Str){0};
-  }
-  return str_from_cstr(buffer);
-}
+bool str_contains(Str haystack, Str needle);
+bool str_includes(Str haystack, char needle);
+bool str_empty(Str s);
+CmpOrdering str_compare_gt(Str s1, Str s2);
+CmpOrdering str_compare_lt(Str s1, Str s2);
 
-////////////////////////////////////////////////////////////////////////////
+// Returns function that you can pass to qsort
+CompareFn str_compare_qsort(CmpOrdering ordering);
 
-Str input(Str prefix) {
-  static char buffer[IO_MAX_INPUT] = {0};
-  printf(STR_FMT, STR_ARG(prefix));
-  fflush(stdout);
-  Str res = io_read_line(stdin, IO_MAX_INPUT, buffer, NULL);
-  return str_substring(res, 0, res.len - 1);
-}
+///////////////////////////////////////////////////////////////////////////////
 
-////////////////////////////////////////////////////////////////////////////
+Str str_trim_left(Str s);
+Str str_trim_left_by_delim(Str s, char delim);
+Str str_trim_left_by_predicate(Str s, bool (*predicate)(char));
+Str str_trim_left_by_charset(Str s, const CharSet *set);
 
-// #include "os.h"
+Str str_trim_right(Str s);
+Str str_trim_right_by_delim(Str s, char delim);
+Str str_trim_right_by_predicate(Str s, bool (*predicate)(char));
+Str str_trim_right_by_charset(Str s, const CharSet *set);
 
-// #include "cebus/core/debug.h"
-// #include "cebus/type/integer.h"
-// #include "cebus/type/string.h"
+Str str_trim(Str s);
+Str str_trim_by_delim(Str s, char delim);
+Str str_trim_by_predicate(Str s, bool (*predicate)(char));
+Str str_trim_by_charset(Str s, const CharSet *set);
 
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
+bool str_try_chop_by_delim(Str *s, char delim, Str *chunk);
+Str str_chop_by_delim(Str *s, char delim);
+bool str_try_chop_by_predicate(Str *s, bool (*predicate)(char), Str *chunk);
+Str str_chop_by_predicate(Str *s, bool (*predicate)(char));
+bool str_try_chop_by_charset(Str *s, const CharSet *set, Str *chunk);
+Str str_chop_by_charset(Str *s, const CharSet *set);
+Str str_chop_right_by_delim(Str *s, char delim);
+Str str_chop_right_by_predicate(Str *s, bool (*predicate)(char));
+Str str_chop_right_by_charset(Str *s, const CharSet *set);
+Str str_take(Str *s, usize count);
+bool str_try_take(Str *s, usize count, Str *chunk);
+Str str_take_right(Str *s, usize count);
+bool str_try_take_right(Str *s, usize count, Str *chunk);
 
-////////////////////////////////////////////////////////////////////////////
+Str str_substring(Str s, usize start, usize end);
 
-Str os_getenv(const char *env, Error *error) {
-  const char *var = getenv(env);
-  if (var == NULL) {
-    error_emit(error, 0, "Could not get environment variable: %s", env);
-    return (Str){0};
-  }
-  return str_from_cstr(var);
-}
+#define str_split(s, set, list)                                                                    \
+  do {                                                                                             \
+    Str __ss = (s);                                                                                \
+    for (Str __field; _str_split_next(&__ss, set, &__field);) {                                    \
+      da_push(list, __field);                                                                      \
+    }                                                                                              \
+  } while (0)
 
-////////////////////////////////////////////////////////////////////////////
-#if defined(LINUX)
+bool _str_split_next(Str *s, const CharSet *set, Str *field);
 
-#include <errno.h>
-#include <string.h>
-#include <sys/stat.h>
-#include <unistd.h>
+// Calls 'write' with every span of 's' between the matches of 'old' and with
+// 'new' for every match, in order. Stops early if 'write' returns 'false'.
+// Used by 'sb_append_replace' and 'io_write_replace'.
+void _str_replace_each(Str s, Str old, Str new, bool ignorecase,
+                       bool (*write)(void *ctx, Str part), void *ctx);
 
-void os_chdir(Path path) {
-  char pathname[FILENAME_MAX] = {0};
-  memcpy(pathname, path.data, usize_min(path.len, FILENAME_MAX));
-  cebus_assert(chdir(pathname) == -1, "Could not change directory to '" STR_FMT "': %s",
-               STR_ARG(path), strerror(errno));
-}
+///////////////////////////////////////////////////////////////////////////////
 
-void os_mkdir(Path path) {
-  os_mkdir_mode(path, 0755); // NOLINT
-}
+u64 str_u64(Str s);
+u64 str_chop_u64(Str *s);
 
-void os_mkdir_mode(Path path, u32 mode) {
-  char pathname[FILENAME_MAX] = {0};
-  memcpy(pathname, path.data, usize_min(path.len, FILENAME_MAX));
-  mkdir(pathname, mode);
-}
+i64 str_i64(Str s);
+i64 str_chop_i64(Str *s);
 
-Path os_getcwd(Arena *arena) {
-  char *buf = arena_alloc(arena, FILENAME_MAX);
-  char *ret = getcwd(buf, FILENAME_MAX);
-  cebus_assert(ret, "Could not get cwd");
-  return str_from_cstr(ret);
-}
+f64 str_f64(Str s);
+f64 str_chop_f64(Str *s);
 
-//////////////////////////////////////////////////////////////////////////////
-#elif defined(WINDOWS)
+typedef enum {
+  STR_PARSE_OK,
+  STR_PARSE_INVALID,
+  STR_PARSE_OVERFLOW,
+} StrParseError;
+
+u64 str_parse_u64(Str s, Error *error);
+i64 str_parse_i64(Str s, Error *error);
+f64 str_parse_f64(Str s, Error *error);
+
+#define str_parse_u64_da(s, delim, list, error)                                                    \
+  _STR_PARSE_DA(s, delim, list, error, _str_parse_u64s)
+#define str_parse_i64_da(s, delim, list, error)                                                    \
+  _STR_PARSE_DA(s, delim, list, error, _str_parse_i64s)
+#define str_parse_f64_da(s, delim, list, error)                                                    \
+  _STR_PARSE_DA(s, delim, list, error, _str_parse_f64s)
+
+#define _STR_PARSE_DA(s, delim, list, error, parse)                                                \
+  do {                                                                                             \
+    const Str __ps = (s);                                                                          \
+    da_reserve((list), _str_field_count(__ps, delim));                                             \
+    da_len(list) += parse(__ps, delim, &(list)->items[da_len(list)], error);                       \
+  } while (0)
 
-#include <direct.h>
+usize _str_field_count(Str s, char delim);
+usize _str_parse_u64s(Str s, char delim, u64 *out, Error *error);
+usize _str_parse_i64s(Str s, char delim, i64 *out, Error *error);
+usize _str_parse_f64s(Str s, char delim, f64 *out, Error *error);
 
-void os_chdir(Path path) {
-  char buffer[FILENAME_MAX] = {0};
-  memcpy(buffer, path.data, usize_min(path.len, FILENAME_MAX));
-  _chdir(buffer);
-}
+///////////////////////////////////////////////////////////////////////////////
 
-void os_mkdir(Path path) {
-  char pathname[FILENAME_MAX] = {0};
-  memcpy(pathname, path.data, usize_min(path.len, FILENAME_MAX));
-  _mkdir(pathname);
-}
+// Returns 'STR_NOT_FOUND' if 'needle' was not found.
+usize str_find(Str haystack, Str needle);
+// Returns 'STR_NOT_FOUND' if 'needle' was not found.
+usize str_find_last(Str haystack, Str needle);
+// Returns 'STR_NOT_FOUND' if 'needle' was not found.
+usize str_find_ignorecase(Str haystack, Str needle);
+usize str_count(Str haystack, Str needle);
+usize str_count_by_charset(Str s, const CharSet *set);
+// Returns '\0' if the index is out of bounds.
+char str_getc(Str s, usize idx);
 
-void os_mkdir_mode(Path path, u32 mode) {
-  (void)mode;
-  os_mkdir(path);
-}
+// XXH64, the same as 'bytes_hash' of the string.
+u64 str_hash(Str s);
+u64 str_hash_seed(Str s, u64 seed);
 
-Path os_getcwd(Arena *arena) {
-  DWORD size = GetCurrentDirectory(0, NULL);
-  char *buf = arena_alloc(arena, size);
-  GetCurrentDirectory((DWORD)size, buf);
-  // TODO error handling
-  return str_from_parts(size, buf);
-}
+///////////////////////////////////////////////////////////////////////////////
 
-//////////////////////////////////////////////////////////////////////////////
+#endif /* !__CEBUS_STR_H__ */
 
-#endif
+#ifndef __CEBUS_UTF8_H__
+#define __CEBUS_UTF8_H__
 
-// #include "bool.h"
+// #include "cebus/core/arena.h"
+// #include "cebus/core/defines.h" // IWYU pragma: private: include "utf8.h"
+// #include "cebus/core/error.h"
 
-bool bool_toggle(bool b) { return !b; }
+typedef enum {
+  UTF8_OK,
+  UTF8_DECODE,
+  UTF8_ENCODE,
+} Utf8Error;
 
-bool bool_any(usize count, const bool *array) {
-  for (usize i = 0; i < count; ++i) {
-    if (array[i]) {
-      return true;
-    }
-  }
-  return false;
-}
+Utf8 utf8_decode(Bytes bytes, Error *error);
+Bytes utf8_encode(Utf8 s, Error *error);
 
-bool bool_all(usize count, const bool *array) {
-  for (usize i = 0; i < count; ++i) {
-    if (!array[i]) {
-      return false;
-    }
-  }
-  return true;
-}
+bool utf8_eq(Utf8 s1, Utf8 s2);
+bool utf8_starts_with(Utf8 s, Utf8 prefix);
+bool utf8_ends_with(Utf8 s, Utf8 suffix);
 
-// #include "byte.h"
+bool utf8_try_next(Utf8 *str, Utf8 *out);
+Utf8 utf8_next(Utf8 *str);
 
-// #include "cebus/type/char.h"
+Utf8 utf8_copy(Utf8 str, Arena *arena);
+Utf8 utf8_append(Utf8 s, Utf8 suffix, Arena *arena);
+Utf8 utf8_prepend(Utf8 s, Utf8 prefix, Arena *arena);
+Utf8 utf8_join(Utf8 sep, usize count, Utf8 *s, Arena *arena);
+Utf8 utf8_upper(Utf8 s, Arena *arena);
+Utf8 utf8_lower(Utf8 s, Arena *arena);
+// Utf8 utf8_replace(Utf8 s, Utf8 old, Utf8 new, Arena *arena);
+// Utf8 utf8_center(Utf8 s, usize width, char fillchar, Arena *arena);
+// Utf8 utf8_ljust(Utf8 s, usize width, char fillchar, Arena *arena);
+// Utf8 utf8_rjust(Utf8 s, usize width, char fillchar, Arena *arena);
+// Utf8 utf8_repeat(Utf8 s, usize count, Arena *arena);
+// Utf8 utf8_reverse(Utf8 s, Arena *arena);
+
+bool utf8_validate_bytes(Bytes s);
+bool utf8_validate(Utf8 s);
+
+#endif /* !__CEBUS_UTF8_H__ */
+
+
+#ifdef CEBUS_IMPLEMENTATION
+/* this is needed so clangd does not report errors in single header */
+#if defined(__clang__)
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Weverything"
+#endif /* !__clang__ */
+// #include "aho_corasick.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/type/byte.h"
 // #include "cebus/type/integer.h"
-// #include "cebus/type/string.h"
 
-#include <stdio.h>
 #include <string.h>
 
-///////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-Bytes bytes_from_parts(usize size, const void *data) { return (Bytes){.size = size, .data = data}; }
+#define AC_NONE U32_MAX
+// The dense table is used up to this many transitions, 1 MiB.
+#define AC_DENSE_MAX 262144
 
-///////////////////////////////////////////////////////////////////////////////
+struct AhoCorasick {
+  usize count;
+  usize *lens;
+  // the next pattern with the same bytes
+  u32 *next_same;
+  usize max_len;
+
+  usize states;
+  // the first pattern that ends in the state
+  u32 *ends;
+  // the closest state on the failure path that ends a pattern, '0' if none
+  u32 *output;
+  // if the state ends a pattern or has an output
+  bool *reports;
+
+  // dense: 'delta[state * classes + class_of[byte]]'
+  usize classes;
+  u8 class_of[256];
+  u32 *delta;
+
+  // compact: the sorted edges of every state and the failure links
+  u32 root[256];
+  u32 *fail;
+  u32 *edge_start;
+  u8 *edge_bytes;
+  u32 *edge_targets;
+};
 
-Bytes bytes_copy(Bytes bytes, Arena *arena) {
-  u8 *buffer = arena_alloc(arena, bytes.size);
-  memcpy(buffer, bytes.data, bytes.size);
-  return bytes_from_parts(bytes.size, buffer);
-}
+// The edges of the trie while it is built, a list for every node.
+typedef struct {
+  u32 target;
+  u32 next;
+  u8 byte;
+} AcEdge;
 
-///////////////////////////////////////////////////////////////////////////////
+typedef struct {
+  u32 *first;
+  AcEdge *edges;
+} AcTrie;
 
-Bytes bytes_slice(Bytes bytes, usize idx1, usize idx2) {
-  if (idx2 <= idx1 || bytes.size <= idx1 || bytes.size < idx2) {
-    return bytes_from_parts(0, bytes.data);
+//////////////////////////////////////////////////////////////////////////////
+
+static u32 ac_trie_child(const AcTrie *trie, u32 node, u8 byte) {
+  for (u32 e = trie->first[node]; e != AC_NONE; e = trie->edges[e].next) {
+    if (trie->edges[e].byte == byte) {
+      return trie->edges[e].target;
+    }
   }
-  return bytes_from_parts(idx2 - idx1, &bytes.data[idx1]);
+  return AC_NONE;
 }
 
-Bytes bytes_take(Bytes *bytes, usize count) {
-  count = usize_min(bytes->size, count);
-  Bytes ret = bytes_from_parts(count, bytes->data);
-  bytes->size -= count;
-  bytes->data += count;
-  return ret;
+static void ac_build_dense(AhoCorasick *ac, Arena *arena, const AcTrie *trie, const u32 *order) {
+  const usize k = ac->classes;
+  ac->delta = arena_alloc(arena, ac->states * k * sizeof(u32));
+  // a failure link always points to a state that comes earlier in the breadth
+  // first order, so its row is already done
+  for (usize i = 0; i < ac->states; i++) {
+    const u32 node = order[i];
+    u32 *row = &ac->delta[node * k];
+    if (node == 0) {
+      memset(row, 0, k * sizeof(u32));
+    } else {
+      memcpy(row, &ac->delta[ac->fail[node] * k], k * sizeof(u32));
+    }
+    for (u32 e = trie->first[node]; e != AC_NONE; e = trie->edges[e].next) {
+      row[ac->class_of[trie->edges[e].byte]] = trie->edges[e].target;
+    }
+  }
 }
 
-///////////////////////////////////////////////////////////////////////////////
-
-bool bytes_eq(Bytes b1, Bytes b2) {
-  if (b1.size != b2.size) {
-    return false;
+static void ac_build_compact(AhoCorasick *ac, Arena *arena, const AcTrie *trie) {
+  ac->edge_start = arena_alloc(arena, (ac->states + 1) * sizeof(u32));
+  ac->edge_bytes = arena_alloc(arena, ac->states * sizeof(u8));
+  ac->edge_targets = arena_alloc(arena, ac->states * sizeof(u32));
+  u32 n = 0;
+  for (usize node = 0; node < ac->states; node++) {
+    ac->edge_start[node] = n;
+    for (u32 e = trie->first[node]; e != AC_NONE; e = trie->edges[e].next) {
+      // insertion sort by byte, most states only have a single edge
+      u32 i = n++;
+      for (; ac->edge_start[node] < i && trie->edges[e].byte < ac->edge_bytes[i - 1]; i--) {
+        ac->edge_bytes[i] = ac->edge_bytes[i - 1];
+        ac->edge_targets[i] = ac->edge_targets[i - 1];
+      }
+      ac->edge_bytes[i] = trie->edges[e].byte;
+      ac->edge_targets[i] = trie->edges[e].target;
+    }
+  }
+  ac->edge_start[ac->states] = n;
+  for (u32 e = trie->first[0]; e != AC_NONE; e = trie->edges[e].next) {
+    ac->root[trie->edges[e].byte] = trie->edges[e].target;
   }
-  return memcmp(b1.data, b2.data, b1.size) == 0;
 }
 
-u64 bytes_hash(Bytes bytes) {
-  const u64 offset = 2166136261UL;
-  const u64 prime = 16777619;
-  u64 hash = offset;
-  for (usize i = 0; i < bytes.size; i++) {
-    hash ^= (unsigned long)bytes.data[i];
-    hash *= prime;
+static inline u32 ac_step_compact(const AhoCorasick *ac, u32 state, u8 byte) {
+  while (state) {
+    const u32 end = ac->edge_start[state + 1];
+    for (u32 e = ac->edge_start[state]; e < end && ac->edge_bytes[e] <= byte; e++) {
+      if (ac->edge_bytes[e] == byte) {
+        return ac->edge_targets[e];
+      }
+    }
+    state = ac->fail[state];
   }
-  return hash;
+  return ac->root[byte];
 }
 
-///////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-Str bytes_to_hex(Bytes bytes, Arena *arena) {
-  char *buf = arena_calloc(arena, bytes.size * 2 + 1);
-  usize idx = 0;
-  for (usize i = 0; i < bytes.size; i++) {
-    idx += (usize)snprintf(&buf[idx], 3, "%0*x", (i != 0) + 1, bytes.data[i]);
+AhoCorasick *ac_create(Arena *arena, usize count, const Str *patterns) {
+  Arena scratch = {0};
+  Bytes *bytes = arena_alloc(&scratch, count * sizeof(Bytes) + 1);
+  for (usize i = 0; i < count; i++) {
+    bytes[i] = bytes_from_parts(patterns[i].len, patterns[i].data);
   }
-  return (Str){.len = idx, .data = buf};
+  AhoCorasick *ac = ac_create_bytes(arena, count, bytes);
+  arena_free(&scratch);
+  return ac;
 }
 
-Bytes bytes_from_hex(Str s, Arena *arena) {
-  if (str_startswith(s, STR("0x"))) {
-    s = str_substring(s, 2, s.len);
-  }
+AhoCorasick *ac_create_bytes(Arena *arena, usize count, const Bytes *patterns) {
+  AhoCorasick *ac = arena_calloc(arena, sizeof(AhoCorasick));
+  ac->count = count;
+  ac->lens = arena_alloc(arena, count * sizeof(usize) + 1);
+  ac->next_same = arena_alloc(arena, count * sizeof(u32) + 1);
 
-  u8 *buffer = arena_calloc(arena, (s.len / 2) + (s.len % 2));
-  // to convert strings like "0x101".
-  // in the first iteration:
-  // take 1 or 2 chars depending if s.len is even or odd
-  usize idx = 0;
-  for (Str ch = {0}; str_try_take(&s, idx == 0 ? 2 - s.len % 2 : 2, &ch);) {
-    for (usize i = 0; i < ch.len; i++) {
-      buffer[idx] <<= 4;
-      if (c_is_xdigit(ch.data[i])) {
-        buffer[idx] |= c_hex_to_u8(ch.data[i]);
+  usize total = 0;
+  for (usize i = 0; i < count; i++) {
+    total += patterns[i].size;
+  }
+  cebus_assert(total < AC_NONE && count < AC_NONE, "AhoCorasick: too many patterns");
+
+  // the trie has at most one node for every byte of the patterns
+  Arena scratch = {0};
+  AcTrie trie = {
+      .first = arena_alloc(&scratch, (total + 1) * sizeof(u32)),
+      .edges = arena_alloc(&scratch, (total + 1) * sizeof(AcEdge)),
+  };
+  u32 *ends = arena_alloc(&scratch, (total + 1) * sizeof(u32));
+  trie.first[0] = AC_NONE;
+  ends[0] = AC_NONE;
+  u32 states = 1;
+  bool used[256] = {0};
+  for (usize p = 0; p < count; p++) {
+    ac->lens[p] = patterns[p].size;
+    ac->next_same[p] = AC_NONE;
+    if (patterns[p].size == 0) {
+      continue;
+    }
+    ac->max_len = usize_max(ac->max_len, patterns[p].size);
+    u32 node = 0;
+    for (usize i = 0; i < patterns[p].size; i++) {
+      const u8 byte = patterns[p].data[i];
+      u32 child = ac_trie_child(&trie, node, byte);
+      if (child == AC_NONE) {
+        child = states++;
+        trie.first[child] = AC_NONE;
+        ends[child] = AC_NONE;
+        trie.edges[child] = (AcEdge){.target = child, .next = trie.first[node], .byte = byte};
+        trie.first[node] = child;
+        used[byte] = true;
       }
+      node = child;
+    }
+    // duplicates are reported in the order of the patterns
+    u32 *last = &ends[node];
+    while (*last != AC_NONE) {
+      last = &ac->next_same[*last];
+    }
+    *last = (u32)p;
+  }
+
+  ac->states = states;
+  ac->ends = arena_alloc(arena, states * sizeof(u32));
+  memcpy(ac->ends, ends, states * sizeof(u32));
+  ac->output = arena_alloc(arena, states * sizeof(u32));
+  ac->reports = arena_alloc(arena, states * sizeof(bool));
+  ac->fail = arena_alloc(arena, states * sizeof(u32));
+
+  // breadth first, so the failure link of a node is known before its children
+  u32 *order = arena_alloc(&scratch, states * sizeof(u32));
+  usize head = 0;
+  usize tail = 1;
+  order[0] = 0;
+  ac->fail[0] = 0;
+  ac->output[0] = 0;
+  ac->reports[0] = false;
+  while (head < tail) {
+    const u32 node = order[head++];
+    for (u32 e = trie.first[node]; e != AC_NONE; e = trie.edges[e].next) {
+      const u32 child = trie.edges[e].target;
+      u32 fail = 0;
+      if (node != 0) {
+        u32 f = ac->fail[node];
+        while ((fail = ac_trie_child(&trie, f, trie.edges[e].byte)) == AC_NONE && f != 0) {
+          f = ac->fail[f];
+        }
+        fail = fail == AC_NONE ? 0 : fail;
+      }
+      ac->fail[child] = fail;
+      ac->output[child] = ac->ends[fail] != AC_NONE ? fail : ac->output[fail];
+      ac->reports[child] = ac->ends[child] != AC_NONE || ac->output[child] != 0;
+      order[tail++] = child;
     }
-    idx++;
   }
-  return bytes_from_parts(idx, buffer);
-}
+
+  ac->classes = 1;
+  for (usize b = 0; b < 256; b++) {
+    ac->class_of[b] = used[b] ? (u8)ac->classes++ : 0;
+  }
+  if (ac->classes == 257 || AC_DENSE_MAX < states * ac->classes) {
+    ac_build_compact(ac, arena, &trie);
+  } else {
+    ac_build_dense(ac, arena, &trie, order);
+  }
+
+  arena_free(&scratch);
+  return ac;
+}
+
+usize ac_len(const AhoCorasick *ac) { return ac->count; }
+
+bool ac_is_dense(const AhoCorasick *ac) { return ac->delta != NULL; }
+
+//////////////////////////////////////////////////////////////////////////////
+
+AcStream ac_stream(const AhoCorasick *ac) {
+  return (AcStream){.ac = ac, .report = 0, .pattern = AC_NONE};
+}
+
+void ac_feed(AcStream *stream, Bytes chunk) {
+  stream->offset += stream->pos;
+  stream->pos = 0;
+  stream->chunk = chunk;
+}
+
+void ac_feed_str(AcStream *stream, Str chunk) {
+  ac_feed(stream, bytes_from_parts(chunk.len, chunk.data));
+}
+
+bool ac_next(AcStream *stream, AcMatch *match) {
+  const AhoCorasick *ac = stream->ac;
+  if (stream->pattern == AC_NONE) {
+    const u8 *data = stream->chunk.data;
+    const usize size = stream->chunk.size;
+    usize pos = stream->pos;
+    u32 state = stream->state;
+    bool found = false;
+    if (ac->delta) {
+      const usize k = ac->classes;
+      while (pos < size && !found) {
+        state = ac->delta[state * k + ac->class_of[data[pos++]]];
+        found = ac->reports[state];
+      }
+    } else {
+      while (pos < size && !found) {
+        state = ac_step_compact(ac, state, data[pos++]);
+        found = ac->reports[state];
+      }
+    }
+    stream->pos = pos;
+    stream->state = state;
+    if (!found) {
+      return false;
+    }
+    stream->report = ac->ends[state] != AC_NONE ? state : ac->output[state];
+    stream->pattern = ac->ends[stream->report];
+  }
+
+  const u32 pattern = stream->pattern;
+  match->pattern = pattern;
+  match->end = stream->offset + stream->pos;
+  match->start = match->end - ac->lens[pattern];
+
+  stream->pattern = ac->next_same[pattern];
+  if (stream->pattern == AC_NONE) {
+    stream->report = ac->output[stream->report];
+    stream->pattern = stream->report ? ac->ends[stream->report] : AC_NONE;
+  }
+  return true;
+}
+
+void ac_each(AcStream *stream, Bytes chunk, AcMatchFn fn, void *ctx) {
+  ac_feed(stream, chunk);
+  for (AcMatch match; ac_next(stream, &match);) {
+    fn(ctx, match);
+  }
+}
+
+bool ac_find(const AhoCorasick *ac, Str s, AcMatch *match) {
+  AcStream stream = ac_stream(ac);
+  ac_feed_str(&stream, s);
+  return ac_next(&stream, match);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// The leftmost candidate, the longest one if they start at the same position.
+static usize ac_replace_best(usize count, const AcMatch *candidates) {
+  usize best = 0;
+  for (usize i = 1; i < count; i++) {
+    if (candidates[i].start < candidates[best].start ||
+        (candidates[i].start == candidates[best].start &&
+         candidates[best].end < candidates[i].end)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+void ac_replace(const AhoCorasick *ac, Str s, const Str *replacements, StringBuilder *sb) {
+  Arena scratch = {0};
+  DA(AcMatch) candidates = da_new(&scratch);
+  AcStream stream = ac_stream(ac);
+  ac_feed_str(&stream, s);
+
+  usize copied = 0;
+  AcMatch match = {0};
+  for (bool more = true; more;) {
+    more = ac_next(&stream, &match);
+    if (more && copied <= match.start) {
+      da_push(&candidates, match);
+    }
+    // The best candidate is final once no match that ends later can start at
+    // or before it.
+    while (da_len(&candidates)) {
+      const usize idx = ac_replace_best(da_len(&candidates), candidates.items);
+      const AcMatch best = da_get(&candidates, idx);
+      if (more && match.end - best.start <= ac->max_len) {
+        break;
+      }
+      sb_append_parts(sb, best.start - copied, &s.data[copied]);
+      sb_append_str(sb, replacements[best.pattern]);
+      copied = best.end;
+      usize kept = 0;
+      for (usize i = 0; i < da_len(&candidates); i++) {
+        if (copied <= da_get(&candidates, i).start) {
+          da_get(&candidates, kept++) = da_get(&candidates, i);
+        }
+      }
+      da_len(&candidates) = kept;
+    }
+  }
+  sb_append_parts(sb, s.len - copied, &s.data[copied]);
+  arena_free(&scratch);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef AC_NONE
+#undef AC_DENSE_MAX
+
+// #include "bloom.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/core/platform.h"
+// #include "cebus/type/float.h"
+// #include "cebus/type/integer.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define BLOOM_BLOCK_BITS 512
+#define BLOOM_BLOCK_WORDS (BLOOM_BLOCK_BITS / 64)
+#define BLOOM_MAX_K 32
+#define BLOOM_MAX_BLOCKED_K 16
+#define BLOOM_BATCH 16
+
+#if defined(GCC) || defined(CLANG)
+#define BLOOM_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define BLOOM_PREFETCH(ptr) ((void)(ptr))
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+static f64 bloom_powi(f64 x, usize n) {
+  f64 result = 1.0;
+  while (n) {
+    if (n & 1) {
+      result *= x;
+    }
+    x *= x;
+    n >>= 1;
+  }
+  return result;
+}
+
+static f64 bloom_classic_fp(usize bits, usize k, usize count) {
+  const f64 filled = 1.0 - f64_exp(-(f64)k * (f64)count / (f64)bits);
+  return bloom_powi(filled, k);
+}
+
+// The number of members per block is poisson distributed, so sum up the false
+// positive rate of every block load weighted by its probability.
+static f64 bloom_blocked_fp(usize bits, usize k, usize count) {
+  const f64 lambda = (f64)count * BLOOM_BLOCK_BITS / (f64)bits;
+  const f64 empty = bloom_powi(1.0 - 1.0 / BLOOM_BLOCK_BITS, k);
+  f64 probability = f64_exp(-lambda);
+  f64 empty_bits = 1.0;
+  f64 fp = 0;
+  for (usize i = 0; i < 4 * BLOOM_BLOCK_BITS; i++) {
+    fp += probability * bloom_powi(1.0 - empty_bits, k);
+    probability *= lambda / (f64)(i + 1);
+    empty_bits *= empty;
+    if (lambda < (f64)i && probability < 1e-18) {
+      break;
+    }
+  }
+  return fp;
+}
+
+static usize bloom_best_k(usize bits, usize count, bool blocked, f64 *fp) {
+  usize best = 1;
+  *fp = 1.0;
+  const usize max_k = blocked ? BLOOM_MAX_BLOCKED_K : BLOOM_MAX_K;
+  for (usize k = 1; k <= max_k; k++) {
+    const f64 rate =
+        blocked ? bloom_blocked_fp(bits, k, count) : bloom_classic_fp(bits, k, count);
+    if (rate < *fp) {
+      *fp = rate;
+      best = k;
+    }
+  }
+  return best;
+}
+
+static BloomFilter bloom_create_sized(Arena *arena, usize expected, f64 fp_rate, bool blocked) {
+  cebus_assert(0 < fp_rate && fp_rate < 1, "The false positive rate has to be in (0, 1)");
+  const usize align = blocked ? BLOOM_BLOCK_BITS : 64;
+  usize bits = usize_max(expected, align);
+  f64 fp = 1.0;
+  usize k = bloom_best_k(bits, expected, blocked, &fp);
+  while (fp_rate < fp) {
+    bits += bits / 64 + align;
+    k = bloom_best_k(bits, expected, blocked, &fp);
+  }
+  return bloom_with_size(arena, bits, k, blocked);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static u64 *bloom_block(const BloomFilter *bf, u64 hash) {
+  const u64 blocks = bf->bits / BLOOM_BLOCK_BITS;
+  return &bf->items[((hash >> 32) * blocks >> 32) * BLOOM_BLOCK_WORDS];
+}
+
+// Double hashing inside of a small block correlates the bits too much, so every
+// position takes the top 9 bits of the next step of a LCG instead.
+static u64 bloom_block_next(u64 state) {
+  return state * 0x5851f42d4c957f2d + 0x14057b7ef767814f;
+}
+
+static bool bloom_block_add(BloomFilter *bf, u64 hash) {
+  u64 *block = bloom_block(bf, hash);
+  u64 missing = 0;
+  for (usize i = 0; i < bf->k; i++) {
+    hash = bloom_block_next(hash);
+    const usize pos = hash >> 55;
+    const u64 bit = (u64)1 << (pos % 64);
+    missing |= ~block[pos / 64] & bit;
+    block[pos / 64] |= bit;
+  }
+  return missing != 0;
+}
+
+static bool bloom_block_contains(const BloomFilter *bf, u64 hash) {
+  const u64 *block = bloom_block(bf, hash);
+  for (usize i = 0; i < bf->k; i++) {
+    hash = bloom_block_next(hash);
+    const usize pos = hash >> 55;
+    if (!(block[pos / 64] & ((u64)1 << (pos % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool bloom_classic_add(BloomFilter *bf, u64 hash) {
+  usize pos = hash % bf->bits;
+  const usize step = u64_mix(hash) % (bf->bits - 1) + 1;
+  u64 missing = 0;
+  for (usize i = 0; i < bf->k; i++) {
+    const u64 bit = (u64)1 << (pos % 64);
+    missing |= ~bf->items[pos / 64] & bit;
+    bf->items[pos / 64] |= bit;
+    pos += step;
+    pos -= bf->bits <= pos ? bf->bits : 0;
+  }
+  return missing != 0;
+}
+
+static bool bloom_classic_contains(const BloomFilter *bf, u64 hash) {
+  usize pos = hash % bf->bits;
+  const usize step = u64_mix(hash) % (bf->bits - 1) + 1;
+  for (usize i = 0; i < bf->k; i++) {
+    if (!(bf->items[pos / 64] & ((u64)1 << (pos % 64)))) {
+      return false;
+    }
+    pos += step;
+    pos -= bf->bits <= pos ? bf->bits : 0;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BloomFilter bloom_create(Arena *arena, usize expected, f64 fp_rate) {
+  return bloom_create_sized(arena, expected, fp_rate, false);
+}
+
+BloomFilter bloom_create_blocked(Arena *arena, usize expected, f64 fp_rate) {
+  return bloom_create_sized(arena, expected, fp_rate, true);
+}
+
+BloomFilter bloom_with_size(Arena *arena, usize bits, usize k, bool blocked) {
+  cebus_assert(k != 0, "The bloom filter needs at least one hash per member");
+  const usize align = blocked ? BLOOM_BLOCK_BITS : 64;
+  BloomFilter bf = {0};
+  bf.arena = arena;
+  bf.blocked = blocked;
+  bf.k = usize_min(k, blocked ? BLOOM_MAX_BLOCKED_K : BLOOM_MAX_K);
+  bf.bits = usize_max((bits + align - 1) / align * align, align);
+  cebus_assert(!blocked || bf.bits / BLOOM_BLOCK_BITS <= U32_MAX, "Too many blocks");
+  bf.items = arena_calloc_chunk(arena, bf.bits / 8);
+  return bf;
+}
+
+void bloom_clear(BloomFilter *bf) {
+  bf->count = 0;
+  memset(bf->items, 0, bf->bits / 8);
+}
+
+BloomFilter bloom_copy(Arena *arena, const BloomFilter *bf) {
+  BloomFilter new = bloom_with_size(arena, bf->bits, bf->k, bf->blocked);
+  memcpy(new.items, bf->items, bf->bits / 8);
+  new.count = bf->count;
+  return new;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool bloom_add(BloomFilter *bf, u64 hash) {
+  hash = u64_mix(hash);
+  const bool added = bf->blocked ? bloom_block_add(bf, hash) : bloom_classic_add(bf, hash);
+  bf->count += added;
+  return added;
+}
+
+void bloom_extend(BloomFilter *bf, usize count, const u64 *hashes) {
+  for (usize i = 0; i < count; i++) {
+    bloom_add(bf, hashes[i]);
+  }
+}
+
+bool bloom_contains(const BloomFilter *bf, u64 hash) {
+  hash = u64_mix(hash);
+  return bf->blocked ? bloom_block_contains(bf, hash) : bloom_classic_contains(bf, hash);
+}
+
+usize bloom_contains_batch(const BloomFilter *bf, usize count, const u64 *hashes, bool *result) {
+  usize found = 0;
+  u64 mixed[BLOOM_BATCH];
+  for (usize i = 0; i < count; i += BLOOM_BATCH) {
+    const usize n = usize_min(BLOOM_BATCH, count - i);
+    for (usize j = 0; j < n; j++) {
+      mixed[j] = u64_mix(hashes[i + j]);
+      if (bf->blocked) {
+        BLOOM_PREFETCH(bloom_block(bf, mixed[j]));
+      } else {
+        BLOOM_PREFETCH(&bf->items[mixed[j] % bf->bits / 64]);
+      }
+    }
+    for (usize j = 0; j < n; j++) {
+      const bool contains = bf->blocked ? bloom_block_contains(bf, mixed[j])
+                                        : bloom_classic_contains(bf, mixed[j]);
+      if (result) {
+        result[i + j] = contains;
+      }
+      found += contains;
+    }
+  }
+  return found;
+}
+
+void bloom_union(BloomFilter *bf, const BloomFilter *other) {
+  cebus_assert(bf->bits == other->bits && bf->k == other->k && bf->blocked == other->blocked,
+               "Bloom filters need the same parameters for a union");
+  for (usize i = 0; i < bf->bits / 64; i++) {
+    bf->items[i] |= other->items[i];
+  }
+  // Shared members would be counted twice, so the count is estimated from the
+  // number of set bits. The real count lies between the larger and the sum of
+  // both counts.
+  const usize sum = bf->count + other->count;
+  const usize low = usize_max(bf->count, other->count);
+  usize set = 0;
+  for (usize i = 0; i < bf->bits / 64; i++) {
+    set += u64_count_ones(bf->items[i]);
+  }
+  if (set == bf->bits) {
+    bf->count = sum;
+    return;
+  }
+  const f64 m = (f64)bf->bits;
+  const f64 estimate = -m / (f64)bf->k * f64_ln(1.0 - (f64)set / m);
+  bf->count = usize_min(usize_max((usize)(estimate + 0.5), low), sum);
+}
+
+f64 bloom_fp_rate(const BloomFilter *bf) {
+  return bf->blocked ? bloom_blocked_fp(bf->bits, bf->k, bf->count)
+                     : bloom_classic_fp(bf->bits, bf->k, bf->count);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef BLOOM_BLOCK_BITS
+#undef BLOOM_BLOCK_WORDS
+#undef BLOOM_MAX_K
+#undef BLOOM_MAX_BLOCKED_K
+#undef BLOOM_BATCH
+#undef BLOOM_PREFETCH
+
+// #include "count_min.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/type/integer.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define CMS_MAX_DEPTH 32
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Every row uses its own hash function: h1 + row * h2.
+static void cms_indices(const CountMin *cms, u64 hash, usize *indices) {
+  const u64 h1 = u64_mix(hash);
+  const u64 h2 = u64_mix(h1) | 1;
+  for (usize row = 0; row < cms->depth; row++) {
+    indices[row] = row * cms->width + ((h1 + row * h2) & (cms->width - 1));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CountMin cms_create(Arena *arena, f64 epsilon, f64 delta) {
+  cebus_assert(0 < epsilon && epsilon < 1, "epsilon has to be in (0, 1)");
+  cebus_assert(0 < delta && delta < 1, "delta has to be in (0, 1)");
+  // width = e / epsilon, depth = ln(1 / delta)
+  const usize width = (usize)(2.718281828459045 / epsilon) + 1;
+  usize depth = 1;
+  for (f64 p = 1 / 2.718281828459045; delta < p; p /= 2.718281828459045) {
+    depth++;
+  }
+  return cms_with_size(arena, width, depth);
+}
+
+CountMin cms_with_size(Arena *arena, usize width, usize depth) {
+  cebus_assert(0 < depth && depth <= CMS_MAX_DEPTH, "depth has to be in [1, %d]", CMS_MAX_DEPTH);
+  CountMin cms = {0};
+  cms.arena = arena;
+  cms.width = 1;
+  while (cms.width < width) {
+    cms.width *= 2;
+  }
+  cms.depth = depth;
+  cms.items = arena_calloc_chunk(arena, cms.width * cms.depth * sizeof(u64));
+  return cms;
+}
+
+void cms_clear(CountMin *cms) {
+  cms->total = 0;
+  memset(cms->items, 0, cms->width * cms->depth * sizeof(u64));
+}
+
+CountMin cms_copy(Arena *arena, const CountMin *cms) {
+  CountMin new = cms_with_size(arena, cms->width, cms->depth);
+  memcpy(new.items, cms->items, cms->width * cms->depth * sizeof(u64));
+  new.total = cms->total;
+  return new;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+u64 cms_add(CountMin *cms, u64 hash, u64 count) {
+  usize indices[CMS_MAX_DEPTH];
+  cms_indices(cms, hash, indices);
+  u64 estimate = U64_MAX;
+  for (usize row = 0; row < cms->depth; row++) {
+    estimate = u64_min(estimate, cms->items[indices[row]]);
+  }
+  estimate += count;
+  for (usize row = 0; row < cms->depth; row++) {
+    cms->items[indices[row]] = u64_max(cms->items[indices[row]], estimate);
+  }
+  cms->total += count;
+  return estimate;
+}
+
+u64 cms_estimate(const CountMin *cms, u64 hash) {
+  usize indices[CMS_MAX_DEPTH];
+  cms_indices(cms, hash, indices);
+  u64 estimate = U64_MAX;
+  for (usize row = 0; row < cms->depth; row++) {
+    estimate = u64_min(estimate, cms->items[indices[row]]);
+  }
+  return estimate;
+}
+
+void cms_merge(CountMin *cms, const CountMin *other) {
+  cebus_assert(cms->width == other->width && cms->depth == other->depth,
+               "Sketches need the same dimensions to be merged");
+  for (usize i = 0; i < cms->width * cms->depth; i++) {
+    cms->items[i] += other->items[i];
+  }
+  cms->total += other->total;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef CMS_MAX_DEPTH
+
+// #include "da_par.h"
+
+// #include "cebus/core/arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+// The chunks only depend on the number of items, never on the number of
+// threads, so every pool computes the same result.
+#define DA_PAR_MIN_CHUNK 1024
+#define DA_PAR_MAX_TASKS 256
+// Sorting uses a power of two number of runs, so they can be merged in pairs.
+#define DA_PAR_MIN_RUN 4096
+#define DA_PAR_MAX_RUNS 64
+
+static usize da_par_tasks(usize count) {
+  usize chunk = (count + DA_PAR_MAX_TASKS - 1) / DA_PAR_MAX_TASKS;
+  chunk = chunk < DA_PAR_MIN_CHUNK ? DA_PAR_MIN_CHUNK : chunk;
+  return (count + chunk - 1) / chunk;
+}
+
+// Start of part 'idx' if 'count' items are split into 'parts' parts.
+static usize da_par_bound(usize count, usize parts, usize idx) {
+  return count / parts * idx + count % parts * idx / parts;
+}
+
+// Copies one item. The common sizes get a copy with a constant size, that the
+// compiler turns into a single move instead of a call.
+static inline void da_par_copy(u8 *dest, const u8 *src, usize size) {
+  switch (size) {
+  case sizeof(u32):
+    memcpy(dest, src, sizeof(u32));
+    break;
+  case sizeof(u64):
+    memcpy(dest, src, sizeof(u64));
+    break;
+  default:
+    memcpy(dest, src, size);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize count;
+  usize tasks;
+  const u8 *src;
+  usize src_size;
+  u8 *dest;
+  usize dest_size;
+  // only one of them is set
+  void (*map)(const void *item, void *out);
+  void (*map_ctx)(void *ctx, const void *item, void *out);
+  void *ctx;
+} DaParMap;
+
+static void da_par_map_task(void *ctx, usize task) {
+  const DaParMap *m = ctx;
+  const usize begin = da_par_bound(m->count, m->tasks, task);
+  const usize end = da_par_bound(m->count, m->tasks, task + 1);
+  if (m->map_ctx) {
+    for (usize i = begin; i < end; i++) {
+      m->map_ctx(m->ctx, &m->src[i * m->src_size], &m->dest[i * m->dest_size]);
+    }
+  } else {
+    for (usize i = begin; i < end; i++) {
+      m->map(&m->src[i * m->src_size], &m->dest[i * m->dest_size]);
+    }
+  }
+}
+
+void _da_par_map(ThreadPool *pool, usize count, const void *src, usize src_size, void *dest,
+                 usize dest_size, void (*map)(const void *item, void *out)) {
+  DaParMap m = {
+      .count = count,
+      .tasks = da_par_tasks(count),
+      .src = src,
+      .src_size = src_size,
+      .dest = dest,
+      .dest_size = dest_size,
+      .map = map,
+  };
+  thread_pool_run(pool, m.tasks, da_par_map_task, &m);
+}
+
+void _da_par_map_ctx(ThreadPool *pool, usize count, const void *src, usize src_size, void *dest,
+                     usize dest_size, void (*map)(void *ctx, const void *item, void *out),
+                     void *ctx) {
+  DaParMap m = {
+      .count = count,
+      .tasks = da_par_tasks(count),
+      .src = src,
+      .src_size = src_size,
+      .dest = dest,
+      .dest_size = dest_size,
+      .map_ctx = map,
+      .ctx = ctx,
+  };
+  thread_pool_run(pool, m.tasks, da_par_map_task, &m);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize count;
+  usize tasks;
+  const u8 *src;
+  u8 *dest;
+  usize size;
+  // only one of them is set
+  bool (*filter)(const void *item);
+  bool (*filter_ctx)(void *ctx, const void *item);
+  void *ctx;
+  bool *keep;
+  // number of kept items per chunk, then the offset of every chunk in 'dest'
+  usize *offsets;
+} DaParFilter;
+
+static void da_par_filter_count(void *ctx, usize task) {
+  DaParFilter *f = ctx;
+  const usize end = da_par_bound(f->count, f->tasks, task + 1);
+  usize kept = 0;
+  for (usize i = da_par_bound(f->count, f->tasks, task); i < end; i++) {
+    const u8 *item = &f->src[i * f->size];
+    f->keep[i] = f->filter_ctx ? f->filter_ctx(f->ctx, item) : f->filter(item);
+    kept += f->keep[i];
+  }
+  f->offsets[task] = kept;
+}
+
+static void da_par_filter_copy(void *ctx, usize task) {
+  const DaParFilter *f = ctx;
+  const usize end = da_par_bound(f->count, f->tasks, task + 1);
+  u8 *out = &f->dest[f->offsets[task] * f->size];
+  for (usize i = da_par_bound(f->count, f->tasks, task); i < end; i++) {
+    if (f->keep[i]) {
+      da_par_copy(out, &f->src[i * f->size], f->size);
+      out += f->size;
+    }
+  }
+}
+
+static usize da_par_filter_run(ThreadPool *pool, DaParFilter f) {
+  if (f.count == 0) {
+    return 0;
+  }
+  Arena scratch = {0};
+  f.tasks = da_par_tasks(f.count);
+  f.keep = arena_alloc(&scratch, f.count * sizeof(bool));
+  f.offsets = arena_alloc(&scratch, f.tasks * sizeof(usize));
+
+  thread_pool_run(pool, f.tasks, da_par_filter_count, &f);
+  usize total = 0;
+  for (usize task = 0; task < f.tasks; task++) {
+    const usize kept = f.offsets[task];
+    f.offsets[task] = total;
+    total += kept;
+  }
+  thread_pool_run(pool, f.tasks, da_par_filter_copy, &f);
+
+  arena_free(&scratch);
+  return total;
+}
+
+usize _da_par_filter(ThreadPool *pool, usize count, const void *src, void *dest, usize size,
+                     bool (*filter)(const void *item)) {
+  DaParFilter f = {.count = count, .src = src, .dest = dest, .size = size, .filter = filter};
+  return da_par_filter_run(pool, f);
+}
+
+usize _da_par_filter_ctx(ThreadPool *pool, usize count, const void *src, void *dest, usize size,
+                         bool (*filter)(void *ctx, const void *item), void *ctx) {
+  DaParFilter f = {
+      .count = count,
+      .src = src,
+      .dest = dest,
+      .size = size,
+      .filter_ctx = filter,
+      .ctx = ctx,
+  };
+  return da_par_filter_run(pool, f);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize count;
+  usize runs;
+  usize size;
+  CompareFn compare;
+  u8 *src;
+  u8 *dest;
+  // number of runs in each half of a merge
+  usize width;
+} DaParSort;
+
+static void da_par_sort_run(void *ctx, usize task) {
+  const DaParSort *s = ctx;
+  const usize begin = da_par_bound(s->count, s->runs, task);
+  const usize end = da_par_bound(s->count, s->runs, task + 1);
+  qsort(&s->src[begin * s->size], end - begin, s->size, s->compare);
+}
+
+// Number of items taken from 'a' for the first 'k' items of the merge. Items
+// of 'a' come first if they are equal, so the merge is stable.
+static usize da_par_sort_split(const DaParSort *s, const u8 *a, usize a_len, const u8 *b,
+                               usize b_len, usize k) {
+  usize lo = b_len < k ? k - b_len : 0;
+  usize hi = a_len < k ? a_len : k;
+  while (lo < hi) {
+    const usize i = lo + (hi - lo) / 2;
+    if (s->compare(&a[i * s->size], &b[(k - i - 1) * s->size]) <= 0) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+// Every merge is split into 'runs / pairs' parts of the output, so every
+// round has 'runs' tasks of about the same size.
+static void da_par_sort_merge(void *ctx, usize task) {
+  const DaParSort *s = ctx;
+  const usize pairs = s->runs / (2 * s->width);
+  const usize parts = s->runs / pairs;
+  const usize pair = task / parts;
+  const usize part = task % parts;
+
+  const usize begin = da_par_bound(s->count, s->runs, pair * 2 * s->width);
+  const usize mid = da_par_bound(s->count, s->runs, pair * 2 * s->width + s->width);
+  const usize end = da_par_bound(s->count, s->runs, (pair + 1) * 2 * s->width);
+  const u8 *a = &s->src[begin * s->size];
+  const u8 *b = &s->src[mid * s->size];
+  const usize a_len = mid - begin;
+  const usize b_len = end - mid;
+
+  const usize k_begin = da_par_bound(end - begin, parts, part);
+  const usize k_end = da_par_bound(end - begin, parts, part + 1);
+  usize i = da_par_sort_split(s, a, a_len, b, b_len, k_begin);
+  usize j = k_begin - i;
+  const usize i_end = da_par_sort_split(s, a, a_len, b, b_len, k_end);
+  const usize j_end = k_end - i_end;
+
+  u8 *out = &s->dest[(begin + k_begin) * s->size];
+  while (i < i_end && j < j_end) {
+    if (s->compare(&b[j * s->size], &a[i * s->size]) < 0) {
+      da_par_copy(out, &b[j++ * s->size], s->size);
+    } else {
+      da_par_copy(out, &a[i++ * s->size], s->size);
+    }
+    out += s->size;
+  }
+  memcpy(out, &a[i * s->size], (i_end - i) * s->size);
+  out += (i_end - i) * s->size;
+  memcpy(out, &b[j * s->size], (j_end - j) * s->size);
+}
+
+void _da_par_sort(ThreadPool *pool, usize count, void *items, usize size, CompareFn compare) {
+  usize runs = 1;
+  while (runs < DA_PAR_MAX_RUNS && DA_PAR_MIN_RUN <= count / (runs * 2)) {
+    runs *= 2;
+  }
+  if (runs == 1) {
+    if (count) {
+      qsort(items, count, size, compare);
+    }
+    return;
+  }
+
+  Arena scratch = {0};
+  DaParSort s = {
+      .count = count,
+      .runs = runs,
+      .size = size,
+      .compare = compare,
+      .src = items,
+      .dest = arena_alloc(&scratch, count * size),
+  };
+  thread_pool_run(pool, runs, da_par_sort_run, &s);
+  for (s.width = 1; s.width < runs; s.width *= 2) {
+    thread_pool_run(pool, runs, da_par_sort_merge, &s);
+    u8 *temp = s.src;
+    s.src = s.dest;
+    s.dest = temp;
+  }
+  if (s.src != items) {
+    memcpy(items, s.src, count * size);
+  }
+  arena_free(&scratch);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef DA_PAR_MIN_CHUNK
+#undef DA_PAR_MAX_TASKS
+#undef DA_PAR_MIN_RUN
+#undef DA_PAR_MAX_RUNS
+
+// #include "eytzinger.h"
+
+// #include "cebus/collection/da.h"
+// #include "cebus/core/platform.h"
+// #include "cebus/type/integer.h"
+
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define EYTZINGER_LINE 64
+#define EYTZINGER_KEYS_PER_LINE (EYTZINGER_LINE / sizeof(u64))
+
+#if defined(GCC) || defined(CLANG)
+#define EYTZINGER_PREFETCH(ptr) __builtin_prefetch(ptr)
+#define EYTZINGER_TRAILING_ONES(x) ((usize)__builtin_ctzll(~(unsigned long long)(x)))
+#else
+#define EYTZINGER_PREFETCH(ptr) ((void)(ptr))
+#define EYTZINGER_TRAILING_ONES(x) u64_trailing_ones(x)
+#endif
+
+#define EYTZINGER_KEY(key) (key)
+#define EYTZINGER_BATCH 8
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Fills the tree with an in order traversal, so it takes the sorted keys in
+// order.
+static usize eytzinger_fill(u64 *tree, usize n, const u64 *sorted, usize i, usize k) {
+  if (k <= n) {
+    i = eytzinger_fill(tree, n, sorted, i, 2 * k);
+    tree[k] = sorted[i++];
+    i = eytzinger_fill(tree, n, sorted, i, 2 * k + 1);
+  }
+  return i;
+}
+
+// Walks down to a leaf and returns the position of the lower bound: Every step
+// to the right appends a 1 bit to 'k'. The lower bound is the last node where
+// the search went left, so remove the trailing ones and that zero bit.
+static usize eytzinger_search(const Eytzinger *ez, u64 key) {
+  const u64 *tree = ez->keys;
+  usize k = 1;
+  while (k <= ez->len) {
+    // the 8 keys 3 levels further down share a cache line
+    EYTZINGER_PREFETCH(&tree[k * EYTZINGER_KEYS_PER_LINE]);
+    k = 2 * k + (tree[k] < key);
+  }
+  return k >> (EYTZINGER_TRAILING_ONES(k) + 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Eytzinger eytzinger_create(Arena *arena, usize count, const u64 *keys) {
+  Arena scratch = {0};
+  DA(u64) sorted = da_new(&scratch);
+  da_extend(&sorted, count, keys);
+  da_radix_sort_u64(&sorted, EYTZINGER_KEY);
+  da_unique(&sorted, u64, *a < *b);
+
+  Eytzinger ez = {0};
+  ez.arena = arena;
+  ez.len = da_len(&sorted);
+  // index 0 is unused, align index 0 to a cache line so the prefetched groups
+  // of 8 keys do not cross cache lines
+  u8 *data = arena_alloc_chunk(arena, (ez.len + 1) * sizeof(u64) + EYTZINGER_LINE);
+  const usize misaligned = (uintptr_t)data % EYTZINGER_LINE;
+  ez.keys = (u64 *)(void *)(data + (misaligned ? EYTZINGER_LINE - misaligned : 0));
+  ez.keys[0] = 0;
+  eytzinger_fill(ez.keys, ez.len, sorted.items, 0, 1);
+
+  arena_free(&scratch);
+  return ez;
+}
+
+bool eytzinger_contains(const Eytzinger *ez, u64 key) {
+  const usize k = eytzinger_search(ez, key);
+  return k != 0 && ez->keys[k] == key;
+}
+
+bool eytzinger_lower_bound(const Eytzinger *ez, u64 key, u64 *result) {
+  const usize k = eytzinger_search(ez, key);
+  if (k == 0) {
+    return false;
+  }
+  *result = ez->keys[k];
+  return true;
+}
+
+// Searches for multiple keys in lockstep, so the cache misses of the searches
+// overlap.
+usize eytzinger_contains_batch(const Eytzinger *ez, usize count, const u64 *keys, bool *result) {
+  const u64 *tree = ez->keys;
+  usize found = 0;
+  usize k[EYTZINGER_BATCH];
+  for (usize i = 0; i < count; i += EYTZINGER_BATCH) {
+    const usize n = usize_min(EYTZINGER_BATCH, count - i);
+    for (usize j = 0; j < n; j++) {
+      k[j] = 1;
+    }
+    for (bool running = true; running;) {
+      running = false;
+      for (usize j = 0; j < n; j++) {
+        if (k[j] <= ez->len) {
+          EYTZINGER_PREFETCH(&tree[k[j] * EYTZINGER_KEYS_PER_LINE]);
+          k[j] = 2 * k[j] + (tree[k[j]] < keys[i + j]);
+          running = true;
+        }
+      }
+    }
+    for (usize j = 0; j < n; j++) {
+      const usize lower = k[j] >> (EYTZINGER_TRAILING_ONES(k[j]) + 1);
+      const bool contains = lower != 0 && tree[lower] == keys[i + j];
+      if (result) {
+        result[i + j] = contains;
+      }
+      found += contains;
+    }
+  }
+  return found;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef EYTZINGER_LINE
+#undef EYTZINGER_KEY
+#undef EYTZINGER_KEYS_PER_LINE
+#undef EYTZINGER_PREFETCH
+#undef EYTZINGER_TRAILING_ONES
+#undef EYTZINGER_BATCH
+
+// #include "hashmap.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/core/defines.h"
+// #include "cebus/type/integer.h"
+
+#include <stdio.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////
+
+#define HM_TYPES(DO)                                                                               \
+  DO(f32)                                                                                          \
+  DO(f64)                                                                                          \
+  DO(i8)                                                                                           \
+  DO(u8)                                                                                           \
+  DO(i16)                                                                                          \
+  DO(u16)                                                                                          \
+  DO(i32)                                                                                          \
+  DO(u32)                                                                                          \
+  DO(i64)                                                                                          \
+  DO(u64)                                                                                          \
+  DO(usize)
+
+#define HM_DECLARE_ENUM(T) HM_TYPE_##T,
+
+typedef enum { HM_NONE, HM_PTR, HM_CONST_PTR, HM_TYPES(HM_DECLARE_ENUM) } HashTypes;
+
+#undef HM_DECLARE_ENUM
+
+#define HM_DECLARE_MEMBER(T) T T;
+
+typedef struct {
+  union {
+    void *ptr;
+    const void *const_ptr;
+    HM_TYPES(HM_DECLARE_MEMBER)
+  } as;
+} HashValue;
+
+#undef HM_DECLARE_MEMBER
+
+typedef struct {
+  u64 key;
+  HashValue value;
+} HashNode;
+
+struct HashMap {
+  HashTypes type;
+  usize cap;
+  usize count;
+  usize deleted;
+  Arena *arena;
+  HashNode *nodes;
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+#define HM_DEFAULT_SIZE 8
+#define HM_DELETED_HASH ((u64)0xdeaddeaddeaddead)
+
+////////////////////////////////////////////////////////////////////////////
+
+static bool hm_insert(HashMap *hm, u64 hash, HashValue value) {
+  if (hash == 0 || hash == HM_DELETED_HASH) {
+    hash = u64_hash(hash);
+  }
+  if (hm->cap <= hm->count + hm->deleted) {
+    hm_resize(hm, hm->cap * 2);
+  }
+
+  while (true) {
+    usize idx = hash % hm->cap;
+
+    for (usize i = 0; i < hm->cap; i++) {
+      if (!hm->nodes[idx].key) {
+        hm->nodes[idx] = (HashNode){.key = hash, .value = value};
+        hm->count++;
+        return true;
+      }
+      if (hm->nodes[idx].key == hash) {
+        hm->nodes[idx].value = value;
+        return false;
+      }
+      idx = (idx + i * i) % hm->cap;
+    }
+
+    hm_resize(hm, hm->cap * 2);
+  }
+}
+
+static HashValue *hm_get(const HashMap *hm, u64 hash) {
+  if (hm->count == 0) {
+    return NULL;
+  }
+  if (hash == 0 || hash == HM_DELETED_HASH) {
+    hash = u64_hash(hash);
+  }
+
+  usize idx = hash % hm->cap;
+  for (usize i = 0; i < hm->cap; i++) {
+    if (hm->nodes[idx].key == 0) {
+      return NULL;
+    }
+    if (hm->nodes[idx].key == hash) {
+      return &hm->nodes[idx].value;
+    }
+    idx = (idx + i * i) % hm->cap;
+  }
+  return NULL;
+}
+
+static const char *hm_type(HashTypes type) {
+#define RETURN_STR(T)                                                                              \
+  case HM_TYPE_##T:                                                                                \
+    return #T;
+
+  switch (type) {
+  case HM_PTR:
+    return "HM_PTR";
+  case HM_CONST_PTR:
+    return "HM_CONST_PTR";
+  case HM_NONE:
+    return "HM_NONE";
+
+    HM_TYPES(RETURN_STR)
+  }
+
+  UNREACHABLE();
+#undef RETURN_STR
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+HashMap *hm_create(Arena *arena) {
+  HashMap *hm = arena_calloc(arena, sizeof(HashMap));
+  hm->type = HM_NONE;
+  hm->arena = arena;
+  return hm;
+}
+
+HashMap *hm_with_size(Arena *arena, usize size) {
+  HashMap *hm = arena_calloc(arena, sizeof(HashMap));
+  hm->type = HM_NONE;
+  hm->arena = arena;
+  hm->cap = usize_max(size, HM_DEFAULT_SIZE);
+  hm->nodes = arena_calloc_chunk(arena, hm->cap * sizeof(hm->nodes[0]));
+  return hm;
+}
+
+void hm_clear(HashMap *hm) {
+  hm->type = HM_NONE;
+  hm->count = 0;
+  memset(hm->nodes, 0, hm->cap * sizeof(hm->nodes[0]));
+}
+
+HashMap *hm_copy(HashMap *hm, Arena *arena) {
+  HashMap *new = hm_with_size(arena, hm->count * 2);
+  new->type = hm->type;
+  for (size_t i = 0; i < hm->cap; i++) {
+    if (hm->nodes[i].key && hm->nodes[i].key != HM_DELETED_HASH) {
+      hm_insert(new, hm->nodes[i].key, hm->nodes[i].value);
+    }
+  }
+  return new;
+}
+
+void hm_resize(HashMap *hm, usize size) {
+  if (size < hm->cap) {
+    return;
+  }
+  usize old_cap = hm->cap;
+  HashNode *old_nodes = hm->nodes;
+
+  hm->cap = size == 0 ? HM_DEFAULT_SIZE : size;
+  hm->nodes = arena_calloc_chunk(hm->arena, hm->cap * sizeof(hm->nodes[0]));
+
+  hm->count = 0;
+  hm->deleted = 0;
+  for (usize i = 0; i < old_cap; ++i) {
+    if (old_nodes[i].key && hm->nodes[i].key != HM_DELETED_HASH) {
+      hm_insert(hm, old_nodes[i].key, old_nodes[i].value);
+    }
+  }
+  arena_free_chunk(hm->arena, old_nodes);
+}
+
+void hm_reserve(HashMap *hm, usize size) {
+  const usize required_size = hm->count + size;
+  if (required_size < hm->cap) {
+    return;
+  }
+  usize new_size = hm->cap == 0 ? HM_DEFAULT_SIZE : hm->cap;
+  while (new_size < required_size) {
+    new_size *= 2;
+  }
+  hm_resize(hm, new_size);
+}
+
+void hm_update(HashMap *hm, HashMap *other) {
+  hm_reserve(hm, other->count);
+  for (usize i = 0; i < other->cap; ++i) {
+    if (other->nodes[i].key && other->nodes[i].key != HM_DELETED_HASH) {
+      hm_insert(hm, other->nodes[i].key, other->nodes[i].value);
+    }
+  }
+}
+
+bool hm_remove(HashMap *hm, u64 hash) {
+  if (hm->count == 0) {
+    return false;
+  }
+  if (hash == 0 || hash == HM_DELETED_HASH) {
+    hash = u64_hash(hash);
+  }
+
+  usize idx = hash % hm->cap;
+  for (usize i = 0; i < hm->cap; i++) {
+    if (hm->nodes[idx].key && hm->nodes[idx].key == hash) {
+      hm->nodes[idx].key = HM_DELETED_HASH;
+      hm->count--;
+      hm->deleted++;
+      return true;
+    }
+    idx = (idx + i * i) % hm->cap;
+  }
+  return false;
+}
+
+#define TYPE_CHECK(hm, T, ret)                                                                     \
+  do {                                                                                             \
+    if (hm->type != HM_NONE && (hm->type != T)) {                                                  \
+      cebus_log_warning("HashMap Type Error: expected '%s' got '%s'", hm_type(hm->type), #T);      \
+      return ret;                                                                                  \
+    }                                                                                              \
+  } while (0)
+
+#define HM_INSERT_IMPL(T)                                                                          \
+  bool hm_insert_##T(HashMap *hm, u64 hash, T value) {                                             \
+    TYPE_CHECK(hm, HM_TYPE_##T, false);                                                            \
+    hm->type = HM_TYPE_##T;                                                                        \
+    return hm_insert(hm, hash, (HashValue){.as.T = value});                                        \
+  }
+
+HM_TYPES(HM_INSERT_IMPL)
+
+#undef HM_INSERT_IMPL
+
+bool hm_insert_mut_ptr(HashMap *hm, u64 hash, void *value) {
+  TYPE_CHECK(hm, HM_PTR, false);
+  hm->type = HM_PTR;
+  return hm_insert(hm, hash, (HashValue){.as.ptr = value});
+}
+
+bool hm_insert_ptr(HashMap *hm, u64 hash, const void *value) {
+  TYPE_CHECK(hm, HM_CONST_PTR, false);
+  hm->type = HM_CONST_PTR;
+  return hm_insert(hm, hash, (HashValue){.as.const_ptr = value});
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+#define HM_GET_MUT_IMPL(T)                                                                         \
+  T *hm_get_##T##_mut(const HashMap *hm, u64 hash) {                                               \
+    TYPE_CHECK(hm, HM_TYPE_##T, NULL);                                                             \
+    HashValue *value = hm_get(hm, hash);                                                           \
+    return value ? &value->as.T : NULL;                                                            \
+  }
+
+HM_TYPES(HM_GET_MUT_IMPL)
+
+void *hm_get_ptr_mut(const HashMap *hm, u64 hash) {
+  TYPE_CHECK(hm, HM_PTR, NULL);
+  HashValue *value = hm_get(hm, hash);
+  return value ? value->as.ptr : NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define HM_GET_IMPL(T)                                                                             \
+  const T *hm_get_##T(const HashMap *hm, u64 hash) { return hm_get_##T##_mut(hm, hash); }
+
+HM_TYPES(HM_GET_IMPL)
+
+#undef HM_GET_IMPL
+
+const void *hm_get_ptr(const HashMap *hm, u64 hash) {
+  TYPE_CHECK(hm, HM_CONST_PTR && hm->type != HM_PTR, NULL);
+  HashValue *value = hm_get(hm, hash);
+  return value ? value->as.const_ptr : NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#undef TYPE_CHECK
+
+#undef HM_TYPES
+#undef HM_DELETED_HASH
+#undef HM_DEFAULT_SIZE
+
+///////////////////////////////////////////////////////////////////////////////
+
+// #include "hll.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/core/platform.h"
+// #include "cebus/type/byte.h"
+// #include "cebus/type/float.h"
+// #include "cebus/type/integer.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+// The sparse representation stores the register index with this precision,
+// so it can be converted into the dense registers of every precision.
+#define HLL_SPARSE_PRECISION 25
+#define HLL_SPARSE_RHO_BITS 6
+#define HLL_SPARSE_DEFAULT_SIZE 16
+
+#define HLL_HEADER_SIZE 6
+#define HLL_VERSION 1
+
+//////////////////////////////////////////////////////////////////////////////
+
+static usize hll_leading_zeros(u64 value) {
+  if (value == 0) {
+    return 64;
+  }
+#if defined(GCC) || defined(CLANG)
+  return (usize)__builtin_clzll(value);
+#else
+  return u64_leading_zeros(value);
+#endif
+}
+
+// The register value: position of the first set bit after the index bits.
+static u8 hll_rho(u64 hash, usize precision) {
+  return (u8)usize_min(hll_leading_zeros(hash << precision), 64 - precision) + 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static u32 hll_sparse_entry(u64 hash) {
+  const u32 idx = (u32)(hash >> (64 - HLL_SPARSE_PRECISION));
+  return (u32)(idx << HLL_SPARSE_RHO_BITS) | hll_rho(hash, HLL_SPARSE_PRECISION);
+}
+
+static u32 hll_sparse_idx(u32 entry) { return entry >> HLL_SPARSE_RHO_BITS; }
+
+static u8 hll_sparse_rho(u32 entry) {
+  return (u8)(entry & ((1u << HLL_SPARSE_RHO_BITS) - 1));
+}
+
+static usize hll_sparse_max(usize precision) { return ((usize)1 << precision) / sizeof(u32); }
+
+static void hll_dense_set(HyperLogLog *hll, usize idx, u8 rho) {
+  hll->registers[idx] = hll->registers[idx] < rho ? rho : hll->registers[idx];
+}
+
+// Converts the sparse entry into the register of the dense representation.
+static void hll_dense_add_entry(HyperLogLog *hll, u32 entry) {
+  const usize shift = HLL_SPARSE_PRECISION - hll->precision;
+  const u32 idx = hll_sparse_idx(entry);
+  const u32 low = idx & (((u32)1 << shift) - 1);
+  u8 rho = 0;
+  if (low) {
+    rho = (u8)(shift - (64 - hll_leading_zeros(low)) + 1);
+  } else {
+    rho = (u8)(shift + hll_sparse_rho(entry));
+  }
+  hll_dense_set(hll, idx >> shift, rho);
+}
+
+static void hll_to_dense(HyperLogLog *hll) {
+  hll->registers = arena_calloc_chunk(hll->arena, (usize)1 << hll->precision);
+  for (usize i = 0; i < hll->len; i++) {
+    hll_dense_add_entry(hll, hll->entries[i]);
+  }
+  arena_free_chunk(hll->arena, hll->entries);
+  hll->entries = NULL;
+  hll->sparse = false;
+  hll->len = 0;
+  hll->cap = 0;
+}
+
+static void hll_sparse_insert(HyperLogLog *hll, u32 entry) {
+  const u32 idx = hll_sparse_idx(entry);
+  usize lo = 0;
+  usize hi = hll->len;
+  while (lo < hi) {
+    const usize mid = lo + (hi - lo) / 2;
+    if (hll_sparse_idx(hll->entries[mid]) < idx) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < hll->len && hll_sparse_idx(hll->entries[lo]) == idx) {
+    if (hll->entries[lo] < entry) {
+      hll->entries[lo] = entry;
+    }
+    return;
+  }
+
+  if (hll_sparse_max(hll->precision) <= hll->len) {
+    hll_to_dense(hll);
+    hll_dense_add_entry(hll, entry);
+    return;
+  }
+  if (hll->cap <= hll->len) {
+    hll->cap = usize_max(hll->cap * 2, HLL_SPARSE_DEFAULT_SIZE);
+    hll->entries = arena_realloc_chunk(hll->arena, hll->entries, hll->cap * sizeof(u32));
+  }
+  memmove(&hll->entries[lo + 1], &hll->entries[lo], (hll->len - lo) * sizeof(u32));
+  hll->entries[lo] = entry;
+  hll->len++;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Ertl, "New cardinality estimation algorithms for HyperLogLog sketches"
+static f64 hll_sigma(f64 x) {
+  if (x == 1) {
+    return F64_INF;
+  }
+  f64 y = 1;
+  f64 z = x;
+  f64 prev = 0;
+  do {
+    x *= x;
+    prev = z;
+    z += x * y;
+    y += y;
+  } while (z != prev);
+  return z;
+}
+
+static f64 hll_tau(f64 x) {
+  if (x == 0 || x == 1) {
+    return 0;
+  }
+  f64 y = 1;
+  f64 z = 1 - x;
+  f64 prev = 0;
+  do {
+    x = f64_sqrt(x);
+    prev = z;
+    y *= 0.5;
+    z -= (1 - x) * (1 - x) * y;
+  } while (z != prev);
+  return z / 3;
+}
+
+static f64 hll_dense_estimate(const HyperLogLog *hll) {
+  const usize m = (usize)1 << hll->precision;
+  const usize q = 64 - hll->precision;
+  usize histogram[64 + 2] = {0};
+  for (usize i = 0; i < m; i++) {
+    histogram[hll->registers[i]]++;
+  }
+  if (histogram[0] == m) {
+    return 0;
+  }
+  f64 z = (f64)m * hll_tau(1 - (f64)histogram[q + 1] / (f64)m);
+  for (usize k = q; 0 < k; k--) {
+    z = 0.5 * (z + (f64)histogram[k]);
+  }
+  z += (f64)m * hll_sigma((f64)histogram[0] / (f64)m);
+  return 0.5 / 0.6931471805599453 * (f64)m * (f64)m / z;
+}
+
+// Linear counting is very precise with this many registers.
+static f64 hll_sparse_estimate(const HyperLogLog *hll) {
+  const f64 m = (f64)((u64)1 << HLL_SPARSE_PRECISION);
+  return m * f64_ln(m / (m - (f64)hll->len));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+HyperLogLog hll_create(Arena *arena, usize precision) {
+  cebus_assert(HLL_MIN_PRECISION <= precision && precision <= HLL_MAX_PRECISION,
+               "precision has to be between %d and %d: %" USIZE_FMT, HLL_MIN_PRECISION,
+               HLL_MAX_PRECISION, precision);
+  HyperLogLog hll = {0};
+  hll.arena = arena;
+  hll.precision = precision;
+  hll.sparse = true;
+  return hll;
+}
+
+void hll_clear(HyperLogLog *hll) {
+  if (!hll->sparse) {
+    arena_free_chunk(hll->arena, hll->registers);
+    hll->registers = NULL;
+  }
+  hll->sparse = true;
+  hll->len = 0;
+}
+
+HyperLogLog hll_copy(Arena *arena, const HyperLogLog *hll) {
+  HyperLogLog new = hll_create(arena, hll->precision);
+  if (hll->sparse) {
+    new.cap = usize_max(hll->len, HLL_SPARSE_DEFAULT_SIZE);
+    new.len = hll->len;
+    new.entries = arena_alloc_chunk(arena, new.cap * sizeof(u32));
+    if (hll->len) {
+      memcpy(new.entries, hll->entries, hll->len * sizeof(u32));
+    }
+  } else {
+    new.sparse = false;
+    new.registers = arena_alloc_chunk(arena, (usize)1 << hll->precision);
+    memcpy(new.registers, hll->registers, (usize)1 << hll->precision);
+  }
+  return new;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void hll_add(HyperLogLog *hll, u64 hash) {
+  hash = u64_mix(hash);
+  if (hll->sparse) {
+    hll_sparse_insert(hll, hll_sparse_entry(hash));
+  } else {
+    hll_dense_set(hll, hash >> (64 - hll->precision), hll_rho(hash, hll->precision));
+  }
+}
+
+void hll_extend(HyperLogLog *hll, usize count, const u64 *hashes) {
+  for (usize i = 0; i < count; i++) {
+    hll_add(hll, hashes[i]);
+  }
+}
+
+void hll_merge(HyperLogLog *hll, const HyperLogLog *other) {
+  cebus_assert(hll->precision == other->precision,
+               "Sketches need the same precision to be merged: %" USIZE_FMT " != %" USIZE_FMT,
+               hll->precision, other->precision);
+  if (other->sparse) {
+    for (usize i = 0; i < other->len; i++) {
+      if (hll->sparse) {
+        hll_sparse_insert(hll, other->entries[i]);
+      } else {
+        hll_dense_add_entry(hll, other->entries[i]);
+      }
+    }
+    return;
+  }
+  if (hll->sparse) {
+    hll_to_dense(hll);
+  }
+  for (usize i = 0; i < (usize)1 << hll->precision; i++) {
+    hll_dense_set(hll, i, other->registers[i]);
+  }
+}
+
+u64 hll_count(const HyperLogLog *hll) {
+  const f64 estimate = hll->sparse ? hll_sparse_estimate(hll) : hll_dense_estimate(hll);
+  return (u64)(estimate + 0.5);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Bytes hll_serialize(const HyperLogLog *hll, Arena *arena) {
+  const usize m = (usize)1 << hll->precision;
+  const usize size = HLL_HEADER_SIZE + (hll->sparse ? sizeof(u32) + hll->len * sizeof(u32) : m);
+  u8 *data = arena_alloc(arena, size);
+  data[0] = 'H';
+  data[1] = 'L';
+  data[2] = 'L';
+  data[3] = HLL_VERSION;
+  data[4] = (u8)hll->precision;
+  data[5] = hll->sparse;
+  if (hll->sparse) {
+    u8 *p = &data[HLL_HEADER_SIZE];
+    for (usize i = 0; i < hll->len + 1; i++) {
+      const u32 value = i == 0 ? (u32)hll->len : hll->entries[i - 1];
+      for (usize b = 0; b < sizeof(u32); b++) {
+        *p++ = (u8)(value >> (b * 8));
+      }
+    }
+  } else {
+    memcpy(&data[HLL_HEADER_SIZE], hll->registers, m);
+  }
+  return bytes_from_parts(size, data);
+}
+
+static u32 hll_read_u32(const u8 *data) {
+  return (u32)data[0] | (u32)data[1] << 8 | (u32)data[2] << 16 | (u32)data[3] << 24;
+}
+
+HyperLogLog hll_deserialize(Bytes bytes, Arena *arena, Error *error) {
+  HyperLogLog hll = {0};
+  if (bytes.size < HLL_HEADER_SIZE || memcmp(bytes.data, "HLL", 3) != 0) {
+    error_emit(error, HLL_INVALID, "HyperLogLog: data is not a sketch");
+    return hll;
+  }
+  if (bytes.data[3] != HLL_VERSION) {
+    error_emit(error, HLL_INVALID, "HyperLogLog: unknown version %d", bytes.data[3]);
+    return hll;
+  }
+  const usize precision = bytes.data[4];
+  if (precision < HLL_MIN_PRECISION || HLL_MAX_PRECISION < precision || 1 < bytes.data[5]) {
+    error_emit(error, HLL_INVALID, "HyperLogLog: invalid header");
+    return hll;
+  }
+  const usize m = (usize)1 << precision;
+  const u8 *data = &bytes.data[HLL_HEADER_SIZE];
+  const usize size = bytes.size - HLL_HEADER_SIZE;
+
+  if (bytes.data[5]) {
+    const usize len = size < sizeof(u32) ? 0 : hll_read_u32(data);
+    if (size < sizeof(u32) || hll_sparse_max(precision) < len ||
+        size != sizeof(u32) + len * sizeof(u32)) {
+      error_emit(error, HLL_INVALID, "HyperLogLog: wrong size of sparse data");
+      return hll;
+    }
+    for (usize i = 0; i < len; i++) {
+      const u32 entry = hll_read_u32(&data[(i + 1) * sizeof(u32)]);
+      const u8 rho = hll_sparse_rho(entry);
+      const bool sorted =
+          i == 0 || hll_sparse_idx(hll_read_u32(&data[i * sizeof(u32)])) < hll_sparse_idx(entry);
+      if (!sorted || rho == 0 || 64 - HLL_SPARSE_PRECISION + 1 < rho ||
+          (entry >> (HLL_SPARSE_PRECISION + HLL_SPARSE_RHO_BITS))) {
+        error_emit(error, HLL_INVALID, "HyperLogLog: invalid sparse entry at %" USIZE_FMT, i);
+        return hll;
+      }
+    }
+    hll = hll_create(arena, precision);
+    hll.cap = usize_max(len, HLL_SPARSE_DEFAULT_SIZE);
+    hll.len = len;
+    hll.entries = arena_alloc_chunk(arena, hll.cap * sizeof(u32));
+    for (usize i = 0; i < len; i++) {
+      hll.entries[i] = hll_read_u32(&data[(i + 1) * sizeof(u32)]);
+    }
+    return hll;
+  }
+
+  if (size != m) {
+    error_emit(error, HLL_INVALID, "HyperLogLog: wrong size of registers");
+    return hll;
+  }
+  for (usize i = 0; i < m; i++) {
+    if (64 - precision + 1 < data[i]) {
+      error_emit(error, HLL_INVALID, "HyperLogLog: invalid register at %" USIZE_FMT, i);
+      return hll;
+    }
+  }
+  hll = hll_create(arena, precision);
+  hll.sparse = false;
+  hll.registers = arena_alloc_chunk(arena, m);
+  memcpy(hll.registers, data, m);
+  return hll;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef HLL_SPARSE_PRECISION
+#undef HLL_SPARSE_RHO_BITS
+#undef HLL_SPARSE_DEFAULT_SIZE
+#undef HLL_HEADER_SIZE
+#undef HLL_VERSION
+
+// #include "set.h"
+
+// #include "cebus/core/cpu.h"
+// #include "cebus/core/platform.h"
+// #include "cebus/type/integer.h"
+
+#include <string.h>
+
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define SET_DEFAULT_SIZE 8
+#define SET_DELETED_HASH 0xdeaddeaddeaddead
+
+// Both sets need this many members before sorting beats probing the tables.
+#define SET_SORTED_MIN_COUNT 1048576
+// If one set is this many times bigger, probing it with the smaller one wins.
+#define SET_SORTED_MAX_RATIO 4
+// Probing only gets slow once the probe sequences of the table get long.
+#define SET_SORTED_MIN_LOAD_PERCENT 75
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void set_radix_sort(usize count, u64 *items, u64 *temp) {
+  if (count == 0) {
+    return;
+  }
+  static const usize digits = sizeof(u64);
+  usize histogram[sizeof(u64)][256] = {0};
+  for (usize i = 0; i < count; i++) {
+    for (usize d = 0; d < digits; d++) {
+      histogram[d][(items[i] >> (d * 8)) & 0xff]++;
+    }
+  }
+
+  u64 *src = items;
+  u64 *dst = temp;
+  for (usize d = 0; d < digits; d++) {
+    usize *offsets = histogram[d];
+    // every member has the same digit, this pass would not change anything
+    if (offsets[(src[0] >> (d * 8)) & 0xff] == count) {
+      continue;
+    }
+    usize offset = 0;
+    for (usize b = 0; b < 256; b++) {
+      const usize c = offsets[b];
+      offsets[b] = offset;
+      offset += c;
+    }
+    for (usize i = 0; i < count; i++) {
+      dst[offsets[(src[i] >> (d * 8)) & 0xff]++] = src[i];
+    }
+    u64 *swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if (src != items) {
+    memcpy(items, src, count * sizeof(u64));
+  }
+}
+
+static usize set_sorted_intersection_scalar(usize n1, const u64 *s1, usize n2, const u64 *s2,
+                                            u64 *out) {
+  usize i = 0, j = 0, k = 0;
+  while (i < n1 && j < n2) {
+    const u64 a = s1[i];
+    const u64 b = s2[j];
+    out[k] = a;
+    k += a == b;
+    i += a <= b;
+    j += b <= a;
+  }
+  return k;
+}
+
+#if defined(CEBUS_SIMD_X86)
+// Compares blocks of four against each other and advances the block with the
+// smaller maximum. Every block writes all four members and only keeps the
+// matches, so the last blocks, that could write past the end of 'out', are
+// left to the scalar loop.
+CEBUS_TARGET_AVX2 static usize set_sorted_intersection_avx2(usize n1, const u64 *s1, usize n2,
+                                                           const u64 *s2, u64 *out) {
+  const usize cap = usize_min(n1, n2);
+  usize i = 0, j = 0, k = 0;
+  while (i + 4 <= n1 && j + 4 <= n2 && k + 4 <= cap) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)&s1[i]);
+    const __m256i b = _mm256_loadu_si256((const __m256i *)&s2[j]);
+    __m256i eq = _mm256_cmpeq_epi64(a, b);
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x39)));
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x4e)));
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x93)));
+    const u32 mask = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(eq));
+    for (usize l = 0; l < 4; l++) {
+      out[k] = s1[i + l];
+      k += (mask >> l) & 1;
+    }
+    const u64 a_max = s1[i + 3];
+    const u64 b_max = s2[j + 3];
+    i += a_max <= b_max ? 4 : 0;
+    j += b_max <= a_max ? 4 : 0;
+  }
+  return k + set_sorted_intersection_scalar(n1 - i, &s1[i], n2 - j, &s2[j], &out[k]);
+}
+#endif
+
+// 'out' needs space for the smaller of the two.
+static usize set_sorted_intersection(usize n1, const u64 *s1, usize n2, const u64 *s2, u64 *out) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return set_sorted_intersection_avx2(n1, s1, n2, s2, out);
+  }
+#endif
+  return set_sorted_intersection_scalar(n1, s1, n2, s2, out);
+}
+
+// 'out' needs space for 'n1' members.
+static usize set_sorted_difference(usize n1, const u64 *s1, usize n2, const u64 *s2, u64 *out) {
+  usize i = 0, j = 0, k = 0;
+  while (i < n1 && j < n2) {
+    const u64 a = s1[i];
+    const u64 b = s2[j];
+    out[k] = a;
+    k += a < b;
+    i += a <= b;
+    j += b <= a;
+  }
+  memcpy(&out[k], &s1[i], (n1 - i) * sizeof(u64));
+  return k + n1 - i;
+}
+
+// 'out' needs space for 'n1 + n2' members.
+static usize set_sorted_symmetric_difference(usize n1, const u64 *s1, usize n2, const u64 *s2,
+                                             u64 *out) {
+  usize i = 0, j = 0, k = 0;
+  while (i < n1 && j < n2) {
+    const u64 a = s1[i];
+    const u64 b = s2[j];
+    out[k] = a < b ? a : b;
+    k += a != b;
+    i += a <= b;
+    j += b <= a;
+  }
+  memcpy(&out[k], &s1[i], (n1 - i) * sizeof(u64));
+  k += n1 - i;
+  memcpy(&out[k], &s2[j], (n2 - j) * sizeof(u64));
+  return k + n2 - j;
+}
+
+static bool set_sorted_subset(usize n1, const u64 *s1, usize n2, const u64 *s2) {
+  usize j = 0;
+  for (usize i = 0; i < n1; i++) {
+    while (j < n2 && s2[j] < s1[i]) {
+      j++;
+    }
+    if (j == n2 || s2[j] != s1[i]) {
+      return false;
+    }
+    j++;
+  }
+  return true;
+}
+
+static bool set_sorted_disjoint(usize n1, const u64 *s1, usize n2, const u64 *s2) {
+  usize i = 0, j = 0;
+  while (i < n1 && j < n2) {
+    const u64 a = s1[i];
+    const u64 b = s2[j];
+    if (a == b) {
+      return false;
+    }
+    i += a < b;
+    j += b < a;
+  }
+  return true;
+}
+
+// Decides if iterating 'set' and probing 'probed' is slower than sorting both.
+static bool set_use_sorted(const Set *set, const Set *probed) {
+  const usize small = usize_min(set->count, probed->count);
+  const usize large = usize_max(set->count, probed->count);
+  if (small < SET_SORTED_MIN_COUNT || SET_SORTED_MAX_RATIO < large / small) {
+    return false;
+  }
+  return probed->cap * SET_SORTED_MIN_LOAD_PERCENT <= probed->count * 100;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Set set_create(Arena *arena) {
+  Set set = {0};
+  set.arena = arena;
+  return set;
+}
+
+Set set_with_size(Arena *arena, usize size) {
+  Set set = {0};
+  set.arena = arena;
+  set.cap = usize_max(size, SET_DEFAULT_SIZE);
+  set.items = arena_calloc_chunk(arena, set.cap * sizeof(set.items[0]));
+  return set;
+}
+
+void set_clear(Set *set) {
+  set->count = 0;
+  set->deleted = 0;
+  memset(set->items, 0, set->cap * sizeof(set->items[0]));
+}
+
+Set set_copy(Arena *arena, Set *set) {
+  Set new = set_with_size(arena, set->count * 2);
+  for (size_t i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      set_add(&new, set->items[i]);
+    }
+  }
+  return new;
+}
+
+void set_resize(Set *set, usize size) {
+  if (size < set->cap) {
+    return;
+  }
+  usize old_cap = set->cap;
+  u64 *old_items = set->items;
+
+  set->cap = size == 0 ? SET_DEFAULT_SIZE : size;
+  set->items = arena_calloc_chunk(set->arena, set->cap * sizeof(set->items[0]));
+
+  set->count = 0;
+  set->deleted = 0;
+  for (usize i = 0; i < old_cap; ++i) {
+    if (old_items[i] && old_items[i] != SET_DELETED_HASH) {
+      set_add(set, old_items[i]);
+    }
+  }
+  arena_free_chunk(set->arena, old_items);
+}
+
+u64 *set_sorted(const Set *set, Arena *arena) {
+  u64 *members = arena_alloc_chunk(arena, usize_max(set->count, 1) * sizeof(u64));
+  usize count = 0;
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      members[count++] = set->items[i];
+    }
+  }
+  u64 *temp = arena_alloc_chunk(arena, usize_max(count, 1) * sizeof(u64));
+  set_radix_sort(count, members, temp);
+  arena_free_chunk(arena, temp);
+  return members;
+}
+
+void set_reserve(Set *set, usize size) {
+  const usize required_size = set->count + size;
+  if (required_size < set->cap) {
+    return;
+  }
+  usize new_size = set->cap == 0 ? SET_DEFAULT_SIZE : set->cap;
+  while (new_size < required_size) {
+    new_size *= 2;
+  }
+  set_resize(set, new_size);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool set_add(Set *set, u64 hash) {
+  if (hash == 0 || hash == SET_DELETED_HASH) {
+    hash = u64_hash(hash);
+  }
+  if (set->cap <= set->count + set->deleted) {
+    set_resize(set, set->cap * 2);
+  }
+
+  while (true) {
+    usize idx = hash % set->cap;
+
+    for (usize i = 0; i < set->cap; i++) {
+      if (!set->items[idx]) {
+        set->items[idx] = hash;
+        set->count++;
+        return true;
+      }
+      if (set->items[idx] == hash) {
+        return false;
+      }
+      idx = (idx + i * i) % set->cap;
+    }
+
+    set_resize(set, set->cap * 2);
+  }
+}
+
+void set_extend(Set *set, usize count, const u64 *hashes) {
+  set_reserve(set, count);
+  for (usize i = 0; i < count; i++) {
+    set_add(set, hashes[i]);
+  }
+}
+
+void set_update(Set *dest, const Set *set) {
+  set_reserve(dest, set->count);
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i]) {
+      set_add(dest, set->items[i]);
+    }
+  }
+}
+
+bool set_remove(Set *set, u64 hash) {
+  if (set->count == 0) {
+    return false;
+  }
+  if (hash == 0 || hash == SET_DELETED_HASH) {
+    hash = u64_hash(hash);
+  }
+
+  usize idx = hash % set->cap;
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[idx] && set->items[idx] == hash) {
+      set->items[idx] = SET_DELETED_HASH;
+      set->count--;
+      set->deleted++;
+      return true;
+    }
+    idx = (idx + i * i) % set->cap;
+  }
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool set_contains(const Set *set, u64 hash) {
+  if (hash == 0 || hash == SET_DELETED_HASH) {
+    hash = u64_hash(hash);
+  }
+
+  usize idx = hash % set->cap;
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[idx] == 0) {
+      return false;
+    }
+    if (set->items[idx] == hash) {
+      return true;
+    }
+    idx = (idx + i * i) % set->cap;
+  }
+  return false;
+}
+
+bool set_eq(const Set *set, const Set *other) {
+  if (other->count != set->count) {
+    return false;
+  }
+
+  if (other->cap < set->cap) {
+    const Set *temp = set;
+    set = other;
+    other = temp;
+  }
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    const bool eq = memcmp(s1, s2, set->count * sizeof(u64)) == 0;
+    arena_free(&scratch);
+    return eq;
+  }
+
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      if (!set_contains(other, set->items[i])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool set_subset(const Set *set, const Set *other) {
+  if (other->count < set->count) {
+    return false;
+  }
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    const bool subset = set_sorted_subset(set->count, s1, other->count, s2);
+    arena_free(&scratch);
+    return subset;
+  }
+
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      if (!set_contains(other, set->items[i])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool set_disjoint(const Set *set, const Set *other) {
+  if (other->count == 0 || set->count == 0) {
+    return true;
+  }
+
+  if (other->cap < set->cap) {
+    const Set *temp = set;
+    set = other;
+    other = temp;
+  }
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    const bool disjoint = set_sorted_disjoint(set->count, s1, other->count, s2);
+    arena_free(&scratch);
+    return disjoint;
+  }
+
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      if (set_contains(other, set->items[i])) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Set set_intersection(const Set *set, const Set *other, Arena *arena) {
+  if (other->cap < set->cap) {
+    const Set *temp = set;
+    set = other;
+    other = temp;
+  }
+
+  Set intersection = set_create(arena);
+  set_reserve(&intersection, usize_min(set->count, other->count) * 2);
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    u64 *out = arena_alloc_chunk(&scratch, usize_min(set->count, other->count) * sizeof(u64));
+    const usize count = set_sorted_intersection(set->count, s1, other->count, s2, out);
+    for (usize i = 0; i < count; i++) {
+      set_add(&intersection, out[i]);
+    }
+    arena_free(&scratch);
+    return intersection;
+  }
+
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      if (set_contains(other, set->items[i])) {
+        set_add(&intersection, set->items[i]);
+      }
+    }
+  }
+  return intersection;
+}
+
+Set set_difference(const Set *set, const Set *other, Arena *arena) {
+  Set difference = set_create(arena);
+  set_reserve(&difference, set->count * 2);
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    u64 *out = arena_alloc_chunk(&scratch, set->count * sizeof(u64));
+    const usize count = set_sorted_difference(set->count, s1, other->count, s2, out);
+    for (usize i = 0; i < count; i++) {
+      set_add(&difference, out[i]);
+    }
+    arena_free(&scratch);
+    return difference;
+  }
+
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      if (!set_contains(other, set->items[i])) {
+        set_add(&difference, set->items[i]);
+      }
+    }
+  }
+  return difference;
+}
+
+Set set_union(const Set *set, const Set *other, Arena *arena) {
+  Set _union = set_with_size(arena, set->count * 2);
+
+  if (set_use_sorted(set, other) || set_use_sorted(other, set)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    u64 *out = arena_alloc_chunk(&scratch, (set->count + other->count) * sizeof(u64));
+    const usize count = set_sorted_symmetric_difference(set->count, s1, other->count, s2, out);
+    set_reserve(&_union, count);
+    for (usize i = 0; i < count; i++) {
+      set_add(&_union, out[i]);
+    }
+    arena_free(&scratch);
+    return _union;
+  }
+
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      if (!set_contains(other, set->items[i])) {
+        set_add(&_union, set->items[i]);
+      }
+    }
+  }
+
+  for (usize i = 0; i < other->cap; i++) {
+    if (other->items[i] && other->items[i] != SET_DELETED_HASH) {
+      if (!set_contains(set, other->items[i])) {
+        set_add(&_union, other->items[i]);
+      }
+    }
+  }
+  return _union;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef SET_SORTED_MIN_LOAD_PERCENT
+#undef SET_SORTED_MAX_RATIO
+#undef SET_SORTED_MIN_COUNT
+#undef SET_DELETED_HASH
+#undef SET_DEFAULT_SIZE
+
+//////////////////////////////////////////////////////////////////////////////
+
+// #include "str_pool.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/core/platform.h"
+// #include "cebus/os/thread.h"
+// #include "cebus/type/string.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define STR_POOL_DEFAULT_SIZE 16
+// Strings are copied into blocks of this size. Strings bigger than a quarter
+// of it get their own allocation, so a block never wastes much.
+#define STR_POOL_BLOCK 65536
+#define STR_POOL_BATCH 16
+// The slot index comes from the low bits of the hash, the slot stores the high
+// bits next to the id.
+#define STR_POOL_TAG ((u64)0xffffffff00000000)
+
+#if defined(GCC) || defined(CLANG)
+#define STR_POOL_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define STR_POOL_PREFETCH(ptr) ((void)(ptr))
+#endif
+
+struct StrPool {
+  Arena *arena;
+  ThreadLock *lock;
+  // the unique strings and their hashes, indexed by id
+  usize len;
+  usize cap;
+  Str *strs;
+  u64 *hashes;
+  // open addressing with linear probing, '0' is an empty slot
+  usize mask;
+  u64 *table;
+  char *block;
+  usize block_left;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+static inline void str_pool_lock(StrPool *pool) {
+  if (pool->lock) {
+    thread_lock_acquire(pool->lock);
+  }
+}
+
+static inline void str_pool_unlock(StrPool *pool) {
+  if (pool->lock) {
+    thread_lock_release(pool->lock);
+  }
+}
+
+static void str_pool_rehash(StrPool *pool, usize size) {
+  arena_free_chunk(pool->arena, pool->table);
+  pool->table = arena_calloc_chunk(pool->arena, size * sizeof(pool->table[0]));
+  pool->mask = size - 1;
+  for (usize id = 0; id < pool->len; id++) {
+    usize idx = pool->hashes[id] & pool->mask;
+    while (pool->table[idx]) {
+      idx = (idx + 1) & pool->mask;
+    }
+    pool->table[idx] = (pool->hashes[id] & STR_POOL_TAG) | (id + 1);
+  }
+}
+
+// Keeps the table at most three quarters full.
+static void str_pool_reserve_table(StrPool *pool, usize count) {
+  usize size = pool->mask + 1;
+  while (size / 4 * 3 < count) {
+    size *= 2;
+  }
+  if (size != pool->mask + 1) {
+    str_pool_rehash(pool, size);
+  }
+}
+
+static void str_pool_reserve_ids(StrPool *pool, usize count) {
+  if (count <= pool->cap) {
+    return;
+  }
+  usize cap = pool->cap ? pool->cap : STR_POOL_DEFAULT_SIZE;
+  while (cap < count) {
+    cap *= 2;
+  }
+  pool->strs = arena_realloc_chunk(pool->arena, pool->strs, cap * sizeof(pool->strs[0]));
+  pool->hashes = arena_realloc_chunk(pool->arena, pool->hashes, cap * sizeof(pool->hashes[0]));
+  pool->cap = cap;
+}
+
+static const char *str_pool_store(StrPool *pool, Str s) {
+  const usize size = s.len + 1;
+  char *data;
+  if (STR_POOL_BLOCK / 4 < size) {
+    data = arena_alloc(pool->arena, size);
+  } else {
+    if (pool->block_left < size) {
+      pool->block = arena_alloc(pool->arena, STR_POOL_BLOCK);
+      pool->block_left = STR_POOL_BLOCK;
+    }
+    data = pool->block;
+    pool->block += size;
+    pool->block_left -= size;
+  }
+  if (s.len) {
+    memcpy(data, s.data, s.len);
+  }
+  data[s.len] = '\0';
+  return data;
+}
+
+// Returns the slot with the string or the empty slot where it belongs.
+static usize str_pool_probe(const StrPool *pool, Str s, u64 hash) {
+  const u64 tag = hash & STR_POOL_TAG;
+  usize idx = hash & pool->mask;
+  for (u64 slot; (slot = pool->table[idx]); idx = (idx + 1) & pool->mask) {
+    if ((slot & STR_POOL_TAG) == tag && str_eq(pool->strs[(u32)slot - 1], s)) {
+      break;
+    }
+  }
+  return idx;
+}
+
+static u32 str_pool_insert(StrPool *pool, Str s, u64 hash) {
+  str_pool_reserve_table(pool, pool->len + 1);
+  const usize idx = str_pool_probe(pool, s, hash);
+  if (pool->table[idx]) {
+    return (u32)pool->table[idx] - 1;
+  }
+
+  cebus_assert(pool->len < U32_MAX, "StrPool: more than U32_MAX strings");
+  str_pool_reserve_ids(pool, pool->len + 1);
+  pool->strs[pool->len] = str_from_parts(s.len, str_pool_store(pool, s));
+  pool->hashes[pool->len] = hash;
+  pool->table[idx] = (hash & STR_POOL_TAG) | (pool->len + 1);
+  return (u32)pool->len++;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+StrPool *str_pool_create(Arena *arena) {
+  StrPool *pool = arena_calloc(arena, sizeof(StrPool));
+  pool->arena = arena;
+  pool->table = arena_calloc_chunk(arena, STR_POOL_DEFAULT_SIZE * sizeof(pool->table[0]));
+  pool->mask = STR_POOL_DEFAULT_SIZE - 1;
+  return pool;
+}
+
+StrPool *str_pool_create_shared(Arena *arena) {
+  StrPool *pool = str_pool_create(arena);
+  pool->lock = thread_lock_create(arena);
+  return pool;
+}
+
+void str_pool_destroy(StrPool *pool) {
+  if (pool->lock) {
+    thread_lock_destroy(pool->lock);
+    pool->lock = NULL;
+  }
+}
+
+void str_pool_reserve(StrPool *pool, usize count) {
+  str_pool_lock(pool);
+  str_pool_reserve_table(pool, count);
+  str_pool_reserve_ids(pool, count);
+  str_pool_unlock(pool);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+u32 str_pool_intern(StrPool *pool, Str s) {
+  const u64 hash = str_hash(s);
+  str_pool_lock(pool);
+  const u32 id = str_pool_insert(pool, s, hash);
+  str_pool_unlock(pool);
+  return id;
+}
+
+Str str_pool_intern_str(StrPool *pool, Str s) {
+  const u64 hash = str_hash(s);
+  str_pool_lock(pool);
+  const u32 id = str_pool_insert(pool, s, hash);
+  const Str result = pool->strs[id];
+  str_pool_unlock(pool);
+  return result;
+}
+
+void str_pool_intern_batch(StrPool *pool, usize count, const Str *strs, u32 *ids) {
+  u64 hashes[STR_POOL_BATCH];
+  str_pool_lock(pool);
+  for (usize i = 0; i < count; i += STR_POOL_BATCH) {
+    const usize n = count - i < STR_POOL_BATCH ? count - i : STR_POOL_BATCH;
+    for (usize j = 0; j < n; j++) {
+      hashes[j] = str_hash(strs[i + j]);
+      STR_POOL_PREFETCH(&pool->table[hashes[j] & pool->mask]);
+    }
+    for (usize j = 0; j < n; j++) {
+      ids[i + j] = str_pool_insert(pool, strs[i + j], hashes[j]);
+    }
+  }
+  str_pool_unlock(pool);
+}
+
+bool str_pool_find(StrPool *pool, Str s, u32 *id) {
+  const u64 hash = str_hash(s);
+  str_pool_lock(pool);
+  const u64 slot = pool->table[str_pool_probe(pool, s, hash)];
+  str_pool_unlock(pool);
+  if (slot && id) {
+    *id = (u32)slot - 1;
+  }
+  return slot != 0;
+}
+
+Str str_pool_get(StrPool *pool, u32 id) {
+  str_pool_lock(pool);
+  cebus_assert(id < pool->len, "StrPool: id %u out of bounds", id);
+  const Str s = pool->strs[id];
+  str_pool_unlock(pool);
+  return s;
+}
+
+u64 str_pool_hash(StrPool *pool, u32 id) {
+  str_pool_lock(pool);
+  cebus_assert(id < pool->len, "StrPool: id %u out of bounds", id);
+  const u64 hash = pool->hashes[id];
+  str_pool_unlock(pool);
+  return hash;
+}
+
+usize str_pool_len(StrPool *pool) {
+  str_pool_lock(pool);
+  const usize len = pool->len;
+  str_pool_unlock(pool);
+  return len;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef STR_POOL_DEFAULT_SIZE
+#undef STR_POOL_BLOCK
+#undef STR_POOL_BATCH
+#undef STR_POOL_TAG
+#undef STR_POOL_PREFETCH
+
+// #include "string_builder.h"
+
+// #include "cebus/type/string.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+StringBuilder sb_init(Arena *arena) {
+  StringBuilder sb = {0};
+  da_init(&sb, arena);
+  return sb;
+}
+
+void sb_clear(StringBuilder *sb) { da_clear(sb); }
+
+Str sb_to_str(StringBuilder *sb) { return str_from_parts(sb->len, sb->items); }
+
+void sb_append_parts(StringBuilder *sb, usize size, const char *s) {
+  if (size == 0) {
+    return;
+  }
+  da_reserve(sb, size);
+  memcpy(&sb->items[sb->len], s, size);
+  sb->len += size;
+}
+
+void sb_append_cstr(StringBuilder *sb, const char *cstr) {
+  sb_append_parts(sb, strlen(cstr), cstr);
+}
+
+void sb_append_str(StringBuilder *sb, Str str) { sb_append_parts(sb, str.len, str.data); }
+
+void sb_append_c(StringBuilder *sb, char c) { da_push(sb, c); }
+
+usize sb_append_fmt(StringBuilder *sb, const char *fmt, ...) {
+  va_list va;
+
+  // get the size without '\0'
+  va_start(va, fmt);
+  usize size = (usize)vsnprintf(NULL, 0, fmt, va);
+  va_end(va);
+
+  // allocate +1 so it does not overwrite
+  da_reserve(sb, size + 1);
+
+  va_start(va, fmt);
+  vsnprintf(&da_last(sb) + 1, size + 1, fmt, va);
+  va_end(va);
+  sb->len += size;
+
+  return size;
+}
+
+usize sb_append_va(StringBuilder *sb, const char *fmt, va_list va) {
+  // copy the va_list
+  va_list va2;
+  va_copy(va2, va);
+
+  // get the size without '\0'
+  usize size = (usize)vsnprintf(NULL, 0, fmt, va);
+
+  // allocate +1 so it does not overwrite
+  da_reserve(sb, size + 1);
+
+  // write into buffer
+  vsnprintf(&da_last(sb) + 1, size + 1, fmt, va2);
+  sb->len += size;
+
+  return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const char sb_digit_pairs[] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+// Writes the digits backwards from 'end', two at a time, and returns the
+// first one.
+static char *sb_write_u64(char *end, u64 value) {
+  while (100 <= value) {
+    end -= 2;
+    memcpy(end, &sb_digit_pairs[(value % 100) * 2], 2);
+    value /= 100;
+  }
+  if (10 <= value) {
+    end -= 2;
+    memcpy(end, &sb_digit_pairs[value * 2], 2);
+  } else {
+    *--end = (char)('0' + value);
+  }
+  return end;
+}
+
+void sb_append_u64(StringBuilder *sb, u64 value) {
+  char buffer[20];
+  const char *start = sb_write_u64(&buffer[sizeof(buffer)], value);
+  sb_append_parts(sb, (usize)(&buffer[sizeof(buffer)] - start), start);
+}
+
+void sb_append_i64(StringBuilder *sb, i64 value) {
+  char buffer[21];
+  char *start = sb_write_u64(&buffer[sizeof(buffer)], value < 0 ? 0 - (u64)value : (u64)value);
+  if (value < 0) {
+    *--start = '-';
+  }
+  sb_append_parts(sb, (usize)(&buffer[sizeof(buffer)] - start), start);
+}
+
+void sb_append_hex(StringBuilder *sb, u64 value) {
+  static const char digits[] = "0123456789abcdef";
+  char buffer[16];
+  char *start = &buffer[sizeof(buffer)];
+  do {
+    *--start = digits[value & 0xf];
+    value >>= 4;
+  } while (value);
+  sb_append_parts(sb, (usize)(&buffer[sizeof(buffer)] - start), start);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Grisu2 by Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+// Accurately with Integers". It finds the shortest digits in almost every case
+// and digits that round trip in all of them, with 64 bit integers only.
+
+typedef struct {
+  u64 f;
+  i32 e;
+} SbDiyFp;
+
+// Powers of ten from 1e-348 to 1e340 in steps of 8, normalized to 64 bits.
+static const u64 sb_cached_powers_f[] = {
+    0xfa8fd5a0081c0288, 0xbaaee17fa23ebf76, 0x8b16fb203055ac76,
+    0xcf42894a5dce35ea, 0x9a6bb0aa55653b2d, 0xe61acf033d1a45df,
+    0xab70fe17c79ac6ca, 0xff77b1fcbebcdc4f, 0xbe5691ef416bd60c,
+    0x8dd01fad907ffc3c, 0xd3515c2831559a83, 0x9d71ac8fada6c9b5,
+    0xea9c227723ee8bcb, 0xaecc49914078536d, 0x823c12795db6ce57,
+    0xc21094364dfb5637, 0x9096ea6f3848984f, 0xd77485cb25823ac7,
+    0xa086cfcd97bf97f4, 0xef340a98172aace5, 0xb23867fb2a35b28e,
+    0x84c8d4dfd2c63f3b, 0xc5dd44271ad3cdba, 0x936b9fcebb25c996,
+    0xdbac6c247d62a584, 0xa3ab66580d5fdaf6, 0xf3e2f893dec3f126,
+    0xb5b5ada8aaff80b8, 0x87625f056c7c4a8b, 0xc9bcff6034c13053,
+    0x964e858c91ba2655, 0xdff9772470297ebd, 0xa6dfbd9fb8e5b88f,
+    0xf8a95fcf88747d94, 0xb94470938fa89bcf, 0x8a08f0f8bf0f156b,
+    0xcdb02555653131b6, 0x993fe2c6d07b7fac, 0xe45c10c42a2b3b06,
+    0xaa242499697392d3, 0xfd87b5f28300ca0e, 0xbce5086492111aeb,
+    0x8cbccc096f5088cc, 0xd1b71758e219652c, 0x9c40000000000000,
+    0xe8d4a51000000000, 0xad78ebc5ac620000, 0x813f3978f8940984,
+    0xc097ce7bc90715b3, 0x8f7e32ce7bea5c70, 0xd5d238a4abe98068,
+    0x9f4f2726179a2245, 0xed63a231d4c4fb27, 0xb0de65388cc8ada8,
+    0x83c7088e1aab65db, 0xc45d1df942711d9a, 0x924d692ca61be758,
+    0xda01ee641a708dea, 0xa26da3999aef774a, 0xf209787bb47d6b85,
+    0xb454e4a179dd1877, 0x865b86925b9bc5c2, 0xc83553c5c8965d3d,
+    0x952ab45cfa97a0b3, 0xde469fbd99a05fe3, 0xa59bc234db398c25,
+    0xf6c69a72a3989f5c, 0xb7dcbf5354e9bece, 0x88fcf317f22241e2,
+    0xcc20ce9bd35c78a5, 0x98165af37b2153df, 0xe2a0b5dc971f303a,
+    0xa8d9d1535ce3b396, 0xfb9b7cd9a4a7443c, 0xbb764c4ca7a44410,
+    0x8bab8eefb6409c1a, 0xd01fef10a657842c, 0x9b10a4e5e9913129,
+    0xe7109bfba19c0c9d, 0xac2820d9623bf429, 0x80444b5e7aa7cf85,
+    0xbf21e44003acdd2d, 0x8e679c2f5e44ff8f, 0xd433179d9c8cb841,
+    0x9e19db92b4e31ba9, 0xeb96bf6ebadf77d9, 0xaf87023b9bf0ee6b,
+};
+static const i16 sb_cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+};
+
+static const u64 sb_pow10[] = {
+    1,
+    10,
+    100,
+    1000,
+    10000,
+    100000,
+    1000000,
+    10000000,
+    100000000,
+    1000000000,
+    10000000000,
+    100000000000,
+    1000000000000,
+    10000000000000,
+    100000000000000,
+    1000000000000000,
+    10000000000000000,
+    100000000000000000,
+    1000000000000000000,
+    10000000000000000000U,
+};
+
+#define SB_F64_HIDDEN_BIT ((u64)1 << 52)
+#define SB_F64_SIGNIFICAND (SB_F64_HIDDEN_BIT - 1)
+
+// The upper 64 bits of the 128 bit product, rounded.
+static SbDiyFp sb_diyfp_mul(SbDiyFp x, SbDiyFp y) {
+  const u64 mask = 0xFFFFFFFF;
+  const u64 a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+  const u64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  u64 tmp = (bd >> 32) + (ad & mask) + (bc & mask);
+  tmp += (u64)1 << 31;
+  return (SbDiyFp){ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64};
+}
+
+static SbDiyFp sb_diyfp_normalize(SbDiyFp x) {
+  while (!(x.f & ((u64)1 << 63))) {
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+static void sb_grisu_round(char *buffer, usize len, u64 delta, u64 rest, u64 ten_kappa, u64 wp_w) {
+  while (rest < wp_w && ten_kappa <= delta - rest &&
+         (rest + ten_kappa < wp_w || rest + ten_kappa - wp_w < wp_w - rest)) {
+    buffer[len - 1]--;
+    rest += ten_kappa;
+  }
+}
+
+// Generates the digits of 'w' until they are inside of the 'delta' below 'mp'.
+static usize sb_grisu_digits(SbDiyFp w, SbDiyFp mp, u64 delta, char *buffer, i32 *k) {
+  const SbDiyFp one = {(u64)1 << -mp.e, mp.e};
+  const u64 wp_w = mp.f - w.f;
+  u32 p1 = (u32)(mp.f >> -one.e);
+  u64 p2 = mp.f & (one.f - 1);
+  i32 kappa = 1;
+  while (kappa < 10 && sb_pow10[kappa] <= p1) {
+    kappa++;
+  }
+  usize len = 0;
+  while (0 < kappa) {
+    const u32 divisor = (u32)sb_pow10[kappa - 1];
+    const u32 digit = p1 / divisor;
+    p1 %= divisor;
+    if (digit || len) {
+      buffer[len++] = (char)('0' + digit);
+    }
+    kappa--;
+    const u64 rest = ((u64)p1 << -one.e) + p2;
+    if (rest <= delta) {
+      *k += kappa;
+      sb_grisu_round(buffer, len, delta, rest, sb_pow10[kappa] << -one.e, wp_w);
+      return len;
+    }
+  }
+  while (true) {
+    p2 *= 10;
+    delta *= 10;
+    const char digit = (char)(p2 >> -one.e);
+    if (digit || len) {
+      buffer[len++] = (char)('0' + digit);
+    }
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      *k += kappa;
+      const u64 scale = -kappa < 20 ? sb_pow10[-kappa] : 0;
+      sb_grisu_round(buffer, len, delta, p2, one.f, wp_w * scale);
+      return len;
+    }
+  }
+}
+
+// Writes the shortest digits of a positive finite value into 'buffer', so that
+// value = digits * 10^k.
+static usize sb_grisu2(f64 value, char *buffer, i32 *k) {
+  u64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const i32 biased = (i32)(bits >> 52 & 0x7FF);
+  SbDiyFp v = {bits & SB_F64_SIGNIFICAND, 1 - 1075};
+  if (biased) {
+    v = (SbDiyFp){v.f + SB_F64_HIDDEN_BIT, biased - 1075};
+  }
+
+  // the boundaries halfway to the neighbouring doubles
+  SbDiyFp plus = {(v.f << 1) + 1, v.e - 1};
+  while (!(plus.f & (SB_F64_HIDDEN_BIT << 1))) {
+    plus.f <<= 1;
+    plus.e--;
+  }
+  plus.f <<= 10;
+  plus.e -= 10;
+  SbDiyFp minus = v.f == SB_F64_HIDDEN_BIT ? (SbDiyFp){(v.f << 2) - 1, v.e - 2}
+                                           : (SbDiyFp){(v.f << 1) - 1, v.e - 1};
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+
+  // a cached power that brings the exponent into [-60, -32]
+  const f64 dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+  i32 cached = (i32)dk;
+  cached += dk - cached > 0.0;
+  const usize index = (usize)((cached >> 3) + 1);
+  *k = -(-348 + (i32)index * 8);
+  const SbDiyFp c = {sb_cached_powers_f[index], sb_cached_powers_e[index]};
+
+  const SbDiyFp w = sb_diyfp_mul(sb_diyfp_normalize(v), c);
+  SbDiyFp wp = sb_diyfp_mul(plus, c);
+  SbDiyFp wm = sb_diyfp_mul(minus, c);
+  wm.f++;
+  wp.f--;
+  return sb_grisu_digits(w, wp, wp.f - wm.f, buffer, k);
+}
+
+// Formats like JavaScript: plain decimals from 1e-6 up to 1e21, exponents
+// outside of that.
+void sb_append_f64(StringBuilder *sb, f64 value) {
+  char buffer[32];
+  usize len = 0;
+  if (value != value) {
+    sb_append_parts(sb, 3, "nan");
+    return;
+  }
+  u64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  if (bits >> 63) {
+    buffer[len++] = '-';
+    value = -value;
+  }
+  if (value == 0) {
+    buffer[len++] = '0';
+    sb_append_parts(sb, len, buffer);
+    return;
+  }
+  if (value - value != 0) {
+    memcpy(&buffer[len], "inf", 3);
+    sb_append_parts(sb, len + 3, buffer);
+    return;
+  }
+
+  char digits[20];
+  i32 k = 0;
+  const usize count = sb_grisu2(value, digits, &k);
+  const i32 n = (i32)count + k; // position of the decimal point
+
+  if ((i32)count <= n && n <= 21) {
+    memcpy(&buffer[len], digits, count);
+    len += count;
+    for (i32 i = (i32)count; i < n; i++) {
+      buffer[len++] = '0';
+    }
+  } else if (0 < n && n <= 21) {
+    memcpy(&buffer[len], digits, (usize)n);
+    len += (usize)n;
+    buffer[len++] = '.';
+    memcpy(&buffer[len], &digits[n], count - (usize)n);
+    len += count - (usize)n;
+  } else if (-6 < n && n <= 0) {
+    buffer[len++] = '0';
+    buffer[len++] = '.';
+    for (i32 i = n; i < 0; i++) {
+      buffer[len++] = '0';
+    }
+    memcpy(&buffer[len], digits, count);
+    len += count;
+  } else {
+    buffer[len++] = digits[0];
+    if (1 < count) {
+      buffer[len++] = '.';
+      memcpy(&buffer[len], &digits[1], count - 1);
+      len += count - 1;
+    }
+    const i32 exponent = n - 1;
+    buffer[len++] = 'e';
+    buffer[len++] = exponent < 0 ? '-' : '+';
+    char *end = &buffer[sizeof(buffer)];
+    const char *start = sb_write_u64(end, (u64)(exponent < 0 ? -exponent : exponent));
+    memmove(&buffer[len], start, (usize)(end - start));
+    len += (usize)(end - start);
+  }
+  sb_append_parts(sb, len, buffer);
+}
+
+#undef SB_F64_HIDDEN_BIT
+#undef SB_F64_SIGNIFICAND
+
+static bool sb_append_part(void *ctx, Str part) {
+  sb_append_str(ctx, part);
+  return true;
+}
+
+void sb_append_replace(StringBuilder *sb, Str s, Str old, Str new) {
+  // enough for the output, if nothing grows
+  da_reserve(sb, s.len);
+  _str_replace_each(s, old, new, false, sb_append_part, sb);
+}
+
+void sb_append_replace_ignorecase(StringBuilder *sb, Str s, Str old, Str new) {
+  da_reserve(sb, s.len);
+  _str_replace_each(s, old, new, true, sb_append_part, sb);
+}
+
+// #include "top_k.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/type/integer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+// A tracked hash gets replaced every time an untracked one is added. The
+// 'HashMap' would fill up with deleted entries, so the tracker uses its own
+// linear probing table that removes entries without tombstones.
+
+static usize topk_slot(const TopK *topk, u64 hash) {
+  return u64_mix(hash) & (topk->table_cap - 1);
+}
+
+// Returns the table index of the hash or of the empty slot where it belongs.
+static usize topk_find(const TopK *topk, u64 hash) {
+  usize idx = topk_slot(topk, hash);
+  while (topk->table[idx] && topk->items[topk->table[idx] - 1].hash != hash) {
+    idx = (idx + 1) & (topk->table_cap - 1);
+  }
+  return idx;
+}
+
+static void topk_table_remove(TopK *topk, u64 hash) {
+  usize idx = topk_find(topk, hash);
+  topk->table[idx] = 0;
+  // move back entries that would not be found anymore
+  for (usize next = (idx + 1) & (topk->table_cap - 1); topk->table[next];
+       next = (next + 1) & (topk->table_cap - 1)) {
+    const usize home = topk_slot(topk, topk->items[topk->table[next] - 1].hash);
+    if (((next - home) & (topk->table_cap - 1)) >= ((next - idx) & (topk->table_cap - 1))) {
+      topk->table[idx] = topk->table[next];
+      topk->table[next] = 0;
+      idx = next;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void topk_heap_swap(TopK *topk, usize a, usize b) {
+  const usize temp = topk->heap[a];
+  topk->heap[a] = topk->heap[b];
+  topk->heap[b] = temp;
+  topk->positions[topk->heap[a]] = a;
+  topk->positions[topk->heap[b]] = b;
+}
+
+static u64 topk_heap_count(const TopK *topk, usize pos) {
+  return topk->items[topk->heap[pos]].count;
+}
+
+static void topk_sift_up(TopK *topk, usize pos) {
+  while (pos && topk_heap_count(topk, pos) < topk_heap_count(topk, (pos - 1) / 2)) {
+    topk_heap_swap(topk, pos, (pos - 1) / 2);
+    pos = (pos - 1) / 2;
+  }
+}
+
+static void topk_sift_down(TopK *topk, usize pos) {
+  while (true) {
+    usize min = pos;
+    const usize left = pos * 2 + 1;
+    const usize right = pos * 2 + 2;
+    if (left < topk->len && topk_heap_count(topk, left) < topk_heap_count(topk, min)) {
+      min = left;
+    }
+    if (right < topk->len && topk_heap_count(topk, right) < topk_heap_count(topk, min)) {
+      min = right;
+    }
+    if (min == pos) {
+      return;
+    }
+    topk_heap_swap(topk, pos, min);
+    pos = min;
+  }
+}
+
+static void topk_push(TopK *topk, TopKEntry entry) {
+  const usize slot = topk->len++;
+  topk->items[slot] = entry;
+  topk->table[topk_find(topk, entry.hash)] = slot + 1;
+  topk->heap[slot] = slot;
+  topk->positions[slot] = slot;
+  topk_sift_up(topk, slot);
+}
+
+static int topk_compare_count(const void *a, const void *b) {
+  const TopKEntry *e1 = a;
+  const TopKEntry *e2 = b;
+  return e1->count < e2->count ? 1 : e1->count > e2->count ? -1 : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+TopK topk_create(Arena *arena, usize k) {
+  cebus_assert(k != 0, "k has to be at least 1");
+  TopK topk = {0};
+  topk.arena = arena;
+  topk.k = k;
+  topk.table_cap = 1;
+  while (topk.table_cap < k * 2) {
+    topk.table_cap *= 2;
+  }
+  topk.items = arena_alloc_chunk(arena, k * sizeof(topk.items[0]));
+  topk.heap = arena_alloc_chunk(arena, k * sizeof(topk.heap[0]));
+  topk.positions = arena_alloc_chunk(arena, k * sizeof(topk.positions[0]));
+  topk.table = arena_calloc_chunk(arena, topk.table_cap * sizeof(topk.table[0]));
+  return topk;
+}
+
+void topk_clear(TopK *topk) {
+  topk->len = 0;
+  topk->total = 0;
+  memset(topk->table, 0, topk->table_cap * sizeof(topk->table[0]));
+}
+
+TopK topk_copy(Arena *arena, const TopK *topk) {
+  TopK new = topk_create(arena, topk->k);
+  for (usize i = 0; i < topk->len; i++) {
+    topk_push(&new, topk->items[i]);
+  }
+  new.total = topk->total;
+  return new;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void topk_add(TopK *topk, u64 hash, u64 count) {
+  topk->total += count;
+  const usize idx = topk_find(topk, hash);
+  if (topk->table[idx]) {
+    const usize slot = topk->table[idx] - 1;
+    topk->items[slot].count += count;
+    topk_sift_down(topk, topk->positions[slot]);
+    return;
+  }
+  if (topk->len < topk->k) {
+    topk_push(topk, (TopKEntry){.hash = hash, .count = count});
+    return;
+  }
+  // replace the least frequent hash, it could have occured 'min' times
+  const usize slot = topk->heap[0];
+  const u64 min = topk->items[slot].count;
+  topk_table_remove(topk, topk->items[slot].hash);
+  topk->items[slot] = (TopKEntry){.hash = hash, .count = min + count, .error = min};
+  topk->table[topk_find(topk, hash)] = slot + 1;
+  topk_sift_down(topk, 0);
+}
+
+const TopKEntry *topk_get(const TopK *topk, u64 hash) {
+  const usize idx = topk_find(topk, hash);
+  return topk->table[idx] ? &topk->items[topk->table[idx] - 1] : NULL;
+}
+
+u64 topk_min(const TopK *topk) {
+  return topk->len < topk->k ? 0 : topk_heap_count(topk, 0);
+}
+
+TopKEntry *topk_sorted(const TopK *topk, Arena *arena) {
+  TopKEntry *entries = arena_alloc(arena, (topk->len + 1) * sizeof(entries[0]));
+  memcpy(entries, topk->items, topk->len * sizeof(entries[0]));
+  qsort(entries, topk->len, sizeof(entries[0]), topk_compare_count);
+  return entries;
+}
+
+// Agarwal et al., "Mergeable Summaries": a hash that is missing in one of the
+// trackers could have occured up to the smallest count of that tracker.
+void topk_merge(TopK *topk, const TopK *other) {
+  const u64 min = topk_min(topk);
+  const u64 other_min = topk_min(other);
+  Arena scratch = {0};
+  TopKEntry *candidates =
+      arena_alloc(&scratch, (topk->len + other->len + 1) * sizeof(candidates[0]));
+  usize len = 0;
+  for (usize i = 0; i < topk->len; i++) {
+    const TopKEntry *entry = &topk->items[i];
+    const TopKEntry *o = topk_get(other, entry->hash);
+    candidates[len++] = (TopKEntry){
+        .hash = entry->hash,
+        .count = entry->count + (o ? o->count : other_min),
+        .error = entry->error + (o ? o->error : other_min),
+    };
+  }
+  for (usize i = 0; i < other->len; i++) {
+    const TopKEntry *entry = &other->items[i];
+    if (topk_get(topk, entry->hash) == NULL) {
+      candidates[len++] = (TopKEntry){
+          .hash = entry->hash,
+          .count = entry->count + min,
+          .error = entry->error + min,
+      };
+    }
+  }
+  qsort(candidates, len, sizeof(candidates[0]), topk_compare_count);
+
+  const u64 total = topk->total + other->total;
+  topk_clear(topk);
+  for (usize i = 0; i < len && i < topk->k; i++) {
+    topk_push(topk, candidates[i]);
+  }
+  topk->total = total;
+  arena_free(&scratch);
+}
+
+// #include "arena.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/core/defines.h"
+// #include "cebus/type/integer.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////
+
+#define CHUNK_DEFAULT_SIZE KILOBYTES(4)
+
+struct Chunk {
+  Chunk *next, *prev;
+  usize cap;
+  usize allocated;
+  u8 data[];
+};
+
+////////////////////////////////////////////////////////////////////////////
+
+static Chunk *chunk_allocate(usize size) {
+  Chunk *chunk = malloc(sizeof(Chunk) + size);
+  cebus_assert(chunk != NULL, "Memory allocation failed: %s", strerror(errno));
+  chunk->cap = size;
+  chunk->allocated = 0;
+  chunk->next = chunk->prev = 0;
+  return chunk;
+}
+
+static void chunk_free(Chunk *chunk) { free(chunk); }
+
+CONST_FN static usize align(usize size) {
+  const usize mask = sizeof(void *) - 1;
+  return (size + mask) & ~mask;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void arena_free(Arena *arena) {
+  Chunk *next = arena->begin;
+  while (next != NULL) {
+    Chunk *temp = next;
+    next = next->next;
+    chunk_free(temp);
+  }
+  arena->begin = NULL;
+}
+
+void arena_reset(Arena *arena) {
+  for (Chunk *next = arena->begin; next != NULL; next = next->next) {
+    if (next->cap != 0) {
+      next->allocated = 0;
+    }
+  }
+}
+
+usize arena_size(Arena *arena) {
+  usize size = 0;
+  for (Chunk *chunk = arena->begin; chunk != NULL; chunk = chunk->next) {
+    size += chunk->allocated;
+  }
+  return size;
+}
+
+usize arena_real_size(Arena *arena) {
+  usize size = 0;
+  for (Chunk *chunk = arena->begin; chunk != NULL; chunk = chunk->next) {
+    size += chunk->cap ? chunk->cap : chunk->allocated;
+  }
+  return size;
+}
+
+void *arena_alloc(Arena *arena, usize size) {
+  size = align(size);
+  Chunk *chunk = arena->begin;
+  for (; chunk != NULL; chunk = chunk->next) {
+    cebus_assert_debug(size <= SIZE_MAX - chunk->allocated, "integer overflow");
+    if (chunk->allocated + size < chunk->cap) {
+      break;
+    }
+  }
+  if (chunk == NULL) {
+    const usize chunk_size = usize_max(size, CHUNK_DEFAULT_SIZE);
+    chunk = chunk_allocate(chunk_size);
+    chunk->next = arena->begin;
+    if (arena->begin) {
+      arena->begin->prev = chunk;
+    }
+    arena->begin = chunk;
+  }
+  void *ptr = &chunk->data[chunk->allocated];
+  chunk->allocated += size;
+  return ptr;
+}
+
+void *arena_calloc(Arena *arena, usize size) {
+  void *ptr = arena_alloc(arena, size);
+  memset(ptr, 0, size);
+  return ptr;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void *arena_alloc_chunk(Arena *arena, usize size) {
+  Chunk *chunk = chunk_allocate(size);
+  chunk->cap = 0;
+  chunk->allocated = size;
+  chunk->next = arena->begin;
+  if (arena->begin) {
+    arena->begin->prev = chunk;
+  }
+  arena->begin = chunk;
+  return chunk->data;
+}
+
+void *arena_calloc_chunk(Arena *arena, usize size) {
+  void *data = arena_alloc_chunk(arena, size);
+  memset(data, 0, size);
+  return data;
+}
+
+void *arena_realloc_chunk(Arena *arena, void *ptr, usize size) {
+  if (ptr == NULL) {
+    return arena_alloc_chunk(arena, size);
+  }
+  Chunk *chunk = (Chunk *)((u8 *)ptr - sizeof(Chunk));
+  if (size < chunk->allocated) {
+    return chunk->data;
+  }
+  Chunk *new_chunk = realloc(chunk, sizeof(Chunk) + size);
+  new_chunk->allocated = size;
+  if (new_chunk->prev) {
+    new_chunk->prev->next = new_chunk;
+  }
+  if (new_chunk->next) {
+    new_chunk->next->prev = new_chunk;
+  }
+  if (arena->begin == chunk) {
+    arena->begin = new_chunk;
+  }
+  return new_chunk->data;
+}
+
+void arena_free_chunk(Arena *arena, void *ptr) {
+  if (ptr == NULL) {
+    return;
+  }
+  Chunk *chunk = (Chunk *)((u8 *)ptr - sizeof(Chunk));
+  if (chunk == arena->begin) {
+    arena->begin = chunk->next;
+  }
+  if (chunk->prev) {
+    chunk->prev->next = chunk->next;
+  }
+  if (chunk->next) {
+    chunk->next->prev = chunk->prev;
+  }
+  free(chunk);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// #include "cpu.h"
+
+// #include "cebus/core/platform.h"
+
+////////////////////////////////////////////////////////////////////////////
+#if defined(CEBUS_SIMD_X86) && (defined(GCC) || defined(CLANG))
+
+bool cpu_has_sse2(void) { return __builtin_cpu_supports("sse2"); }
+
+bool cpu_has_avx2(void) { return __builtin_cpu_supports("avx2"); }
+
+////////////////////////////////////////////////////////////////////////////
+#elif defined(CEBUS_SIMD_X86) && defined(MSVC)
+#include <intrin.h>
+
+bool cpu_has_sse2(void) { return true; }
+
+bool cpu_has_avx2(void) {
+  static i32 has_avx2 = -1;
+  if (has_avx2 == -1) {
+    int info[4] = {0};
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    // the os has to save the ymm registers
+    const bool ymm = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    has_avx2 = ymm && (info[1] & (1 << 5)) != 0;
+  }
+  return has_avx2;
+}
+
+////////////////////////////////////////////////////////////////////////////
+#else
+
+bool cpu_has_sse2(void) { return false; }
+
+bool cpu_has_avx2(void) { return false; }
+
+#endif
+////////////////////////////////////////////////////////////////////////////
+#if defined(LINUX)
+#include <unistd.h>
+
+usize cpu_count(void) {
+  const long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count < 1 ? 1 : (usize)count;
+}
+
+////////////////////////////////////////////////////////////////////////////
+#elif defined(WINDOWS)
+
+usize cpu_count(void) {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors < 1 ? 1 : (usize)info.dwNumberOfProcessors;
+}
+
+////////////////////////////////////////////////////////////////////////////
+#else
+
+usize cpu_count(void) { return 1; }
+
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+// #include "error.h"
+
+// #include "cebus/core/arena.h"
+// #include "cebus/core/error.h"
+// #include "cebus/type/string.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+////////////////////////////////////////////////////////////////////////////
+
+static void error_dump(Error *error) {
+
+  fprintf(stderr, "[Error]: %s:%d: %s()\n", error->location.file, error->location.line,
+          error->location.function);
+  Str message = sb_to_str(&error->info->message);
+  Str msg = str_chop_by_delim(&message, '\n');
+  fprintf(stderr, "  [Message]: " STR_FMT "\n", STR_ARG(msg));
+  for (Str note = {0}; str_try_chop_by_delim(&message, '\n', &note);) {
+    fprintf(stderr, "  [NOTE]: " STR_FMT "\n", STR_ARG(note));
+  }
+
+  // Stack trace
+  fprintf(stderr, "[STACK TRACE]\n");
+  usize location_count = error->info->locations.len;
+  for (usize i = 0; i < location_count; ++i) {
+    FileLocation *location = &da_pop(&error->info->locations);
+    fprintf(stderr, "  [%" USIZE_FMT "]: %s:%d: %s()\n", i + 1, location->file, location->line,
+            location->function);
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void _error_internal_emit(Error *err, i32 code, FileLocation location, const char *fmt, ...) {
+  if (err == ErrDefault) {
+    err = ((Error[]){{
+        .failure = true,
+        .panic_on_emit = true,
+        .location = location,
+        .arena = {0},
+    }});
+  }
+
+  err->failure = true;
+
+  err->info = arena_calloc(&err->arena, sizeof(ErrorInfo));
+  err->info->code = code;
+
+  err->info->message = sb_init(&err->arena);
+  da_init(&err->info->locations, &err->arena);
+
+  da_push(&err->info->locations, location);
+
+  va_list va;
+  va_start(va, fmt);
+  sb_append_va(&err->info->message, fmt, va);
+  va_end(va);
+  err->info->msg = sb_to_str(&err->info->message);
+
+  if (err->panic_on_emit) {
+    _error_internal_panic(err);
+  }
+}
+
+bool _error_internal_occured(Error *err) { return err && err->failure; }
+
+void _error_internal_panic(Error *err) {
+  error_dump(err);
+  arena_free(&err->arena);
+  abort();
+}
+
+void _error_internal_except(Error *err) {
+  arena_free(&err->arena);
+  err->info = NULL;
+  err->failure = false;
+}
+
+void _error_internal_set_code(Error *err, i32 code) { err->info->code = code; }
+
+void _error_internal_set_msg(Error *err, const char *fmt, ...) {
+  sb_clear(&err->info->message);
+  va_list va;
+  va_start(va, fmt);
+  sb_append_va(&err->info->message, fmt, va);
+  va_end(va);
+  err->info->msg = sb_to_str(&err->info->message);
+}
+
+void _error_internal_add_note(Error *err, const char *fmt, ...) {
+  va_list va;
+  va_start(va, fmt);
+  sb_append_c(&err->info->message, '\n');
+  sb_append_va(&err->info->message, fmt, va);
+  va_end(va);
+
+  err->info->msg.data = err->info->message.items;
+}
+
+void _error_internal_add_location(Error *err, FileLocation location) {
+  da_push(&err->info->locations, location);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// #include "logging.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+
+////////////////////////////////////////////////////////////////////////////
+
+#if defined(LINUX)
+#include <unistd.h>
+#elif defined(WINDOWS)
+#include <io.h>
+#define isatty(...) _isatty(__VA_ARGS__)
+#else
+#define isatty(...) false
+#endif
+
+#ifndef STDERR_FILENO
+#define STDERR_FILENO 1
+#endif
+#ifndef STDOUT_FILENO
+#define STDOUT_FILENO 2
+#endif
+
+////////////////////////////////////////////////////////////////////////////
+
+struct CmLogLevelPrefix {
+  const char *prefix;
+  const char *color;
+  int file;
+};
+
+static const struct CmLogLevelPrefix log_level_str[] = {
+    [CEBUS_LOG_FATAL] = {"FATAL", "\033[1m\033[91m", STDERR_FILENO},
+    [CEBUS_LOG_ERROR] = {"ERROR", "\033[91m", STDERR_FILENO},
+    [CEBUS_LOG_WARNING] = {"WARNING", "\033[33m", STDERR_FILENO},
+    [CEBUS_LOG_INFO] = {"INFO", "\033[34m", STDOUT_FILENO},
+    [CEBUS_LOG_DEBUG] = {"DEBUG", "\033[1m\033[95m", STDOUT_FILENO},
+    [CEBUS_LOG_TRACE] = {"TRACE", "\033[97m", STDOUT_FILENO},
+};
+
+#define FMT_RESET "\033[0m"
+
+////////////////////////////////////////////////////////////////////////////
+
+#define _LOG(__log_level, __fmt)                                                                   \
+  _cebus_log(__log_level);                                                                         \
+  va_list __args;                                                                                  \
+  va_start(__args, __fmt);                                                                         \
+  vfprintf(log_level_str[__log_level].file == STDERR_FILENO ? stderr : stdout, __fmt, __args);     \
+  va_end(__args);                                                                                  \
+  fprintf(log_level_str[__log_level].file == STDERR_FILENO ? stderr : stdout, "%s\n",              \
+          display_colors ? FMT_RESET : "");
+
+static bool display_colors = false;
+static bool tty_checked = false;
+
+static void _cebus_log(LogLevel log_level) {
+  if (UNLIKELY(!tty_checked)) {
+    tty_checked = true;
+    display_colors = isatty(STDOUT_FILENO) && isatty(STDERR_FILENO);
+  }
+
+  fprintf(log_level_str[log_level].file == STDERR_FILENO ? stderr : stdout,
+          "%s[%s]: ", display_colors ? log_level_str[log_level].color : "",
+          log_level_str[log_level].prefix);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void cebus_log_level(LogLevel level, const char *fmt, ...) { _LOG(level, fmt); }
+
+void cebus_log(const char *fmt, ...) {
+  va_list args;
+  va_start(args, fmt);
+  vprintf(fmt, args);
+  printf("\n");
+  va_end(args);
+}
+void cebus_log_fatal(const char *fmt, ...) { _LOG(CEBUS_LOG_FATAL, fmt); }
+void cebus_log_error(const char *fmt, ...) { _LOG(CEBUS_LOG_ERROR, fmt); }
+void cebus_log_warning(const char *fmt, ...) { _LOG(CEBUS_LOG_WARNING, fmt); }
+void cebus_log_info(const char *fmt, ...) { _LOG(CEBUS_LOG_INFO, fmt); }
+
+////////////////////////////////////////////////////////////////////////////
+
+void _cebus_log_debug(const char *fmt, ...) { _LOG(CEBUS_LOG_DEBUG, fmt); }
+void _cebus_log_trace(const char *fmt, ...) { _LOG(CEBUS_LOG_TRACE, fmt); }
+
+////////////////////////////////////////////////////////////////////////////
+
+#undef _LOG
+
+////////////////////////////////////////////////////////////////////////////
+
+// #include "args.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/core/error.h"
+// #include "cebus/type/char.h"
+// #include "cebus/type/integer.h"
+// #include "cebus/type/string.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef enum {
+  ERR_INTERNAL,
+  ERR_PARSE,
+} ArgParseError;
+
+bool args_c_shift(int *argc, const char ***argv) {
+  if ((*argc) == 0) {
+    return false;
+  }
+  (*argc)--;
+  (*argv)++;
+  return true;
+}
+
+Str args_shift(Args *args) {
+  if (args->argc == 0) {
+    return (Str){0};
+  }
+  args->argc--;
+  return str_from_cstr(*args->argv++);
+}
+
+Args args_init(Arena *arena, int argc, const char **argv) {
+  Args args = {.argc = argc, .argv = argv};
+
+  da_init(&args.arguments, arena);
+  args.hm = NULL;
+  hm_create(arena);
+
+  args.program = args_shift(&args);
+
+  return args;
+}
+
+void args_add_description(Args *args, const char *description) {
+  args->description = str_from_cstr(description);
+}
+
+void args_print_usage(Args *args, FILE *file) {
+  fprintf(file, "usage: " STR_FMT, STR_ARG(args->program));
+  for (u32 i = 0; i < args->positional; ++i) {
+    Argument *argument = &args->arguments.items[i];
+    fprintf(file, " <" STR_FMT ">", STR_ARG(argument->name));
+  }
+  if (args->arguments.len > args->positional) {
+    fprintf(file, " [...options]");
+  }
+  fprintf(file, "\n");
+}
+
+void args_print_help(Args *args, FILE *file) {
+  args_print_usage(args, file);
+  fprintf(file, "\n");
+
+  if (args->description.len) {
+    fprintf(file, STR_FMT "\n", STR_ARG(args->description));
+    fprintf(file, "\n");
+  }
+
+  if (args->positional) {
+    fprintf(file, "positional arguments:\n");
+  }
+  for (u32 i = 0; i < args->arguments.len && i < args->positional; ++i) {
+    Argument *argument = &args->arguments.items[i];
+    const i32 padding = i32_max(0, 28 - (i32)argument->name.len);
+    fprintf(file, "  " STR_FMT " %*c " STR_FMT "\n", STR_ARG(argument->name), padding, ' ',
+            STR_ARG(argument->description));
+  }
+  if (args->positional) {
+    fprintf(file, "\n");
+  }
+
+  fprintf(file, "options:\n");
+  fprintf(file, "  -h, --help                    show usage or this help message\n");
+  for (usize i = args->positional; i < args->arguments.len; i++) {
+    Argument *argument = &args->arguments.items[i];
+    const i32 padding = i32_max(0, 28 - (i32)argument->name.len);
+    fprintf(file, "  --" STR_FMT "%*c" STR_FMT "\n", STR_ARG(argument->name), padding, ' ',
+            STR_ARG(argument->description));
+  }
+}
+
+static void args_parse_argument(Argument *argument, Str arg, Error *error) {
+  if (arg.len == 0 || arg.data == NULL || str_startswith(arg, STR("--"))) {
+    error_emit(error, ERR_PARSE, STR_REPR " needs parameter: got " STR_REPR,
+               STR_ARG(argument->name), STR_ARG(arg));
+    return;
+  }
+
+  if (arg.data[0] == '"') {
+    arg.data += 1;
+    arg.len -= 2;
+  }
+
+  switch (argument->type) {
+  case ARG_TYPE_NONE:
+  case ARG_TYPE_FLAG: {
+    error_emit(error, ERR_INTERNAL, "this type should never be parsed here: %d", argument->type);
+    return;
+  } break;
+  case ARG_TYPE_I64: {
+    bool minus_number = arg.data[0] == '-' && c_is_digit(arg.data[1]);
+    if (!minus_number && !c_is_digit(arg.data[0])) {
+      error_emit(error, ERR_PARSE, STR_REPR ": " STR_REPR " not a valid i64",
+                 STR_ARG(argument->name), STR_ARG(arg));
+      return;
+    }
+    argument->as.i64 = str_i64(arg);
+  } break;
+  case ARG_TYPE_U64: {
+    bool minus_number = arg.data[0] == '-' && c_is_digit(arg.data[1]);
+    if (minus_number) {
+      error_emit(error, ERR_PARSE, STR_REPR ": " STR_REPR "minus numbers are not valid u64",
+                 STR_ARG(argument->name), STR_ARG(arg));
+      return;
+    }
+    if (!c_is_digit(arg.data[0])) {
+      error_emit(error, ERR_PARSE, STR_REPR ": " STR_REPR " not a valid u64",
+                 STR_ARG(argument->name), STR_ARG(arg));
+      return;
+    }
+    argument->as.u64 = str_u64(arg);
+  } break;
+  case ARG_TYPE_STR: {
+    argument->as.str = arg;
+  } break;
+  }
+
+  argument->parsed = true;
+}
+
+bool args_parse(Args *args) {
+  Error error = ErrNew;
+
+  u32 argument_idx = 0;
+  u32 positional_count = 0;
+  for (Str arg = {0}; (arg = args_shift(args)).data;) {
+    if (str_eq(arg, STR("-h"))) {
+      args_print_usage(args, stdout);
+      exit(0);
+    }
+    if (str_eq(arg, STR("--help"))) {
+      args_print_help(args, stdout);
+      exit(0);
+    }
+
+    bool arg_is_optional = arg.data[0] == '-' && (arg.data[1] == '-' || !c_is_digit(arg.data[1]));
+    if (arg_is_optional) {
+      if (str_eq(arg, STR("--"))) {
+        break;
+      }
+      usize dash_count = str_count(str_substring(arg, 0, 2), STR("-"));
+      Str arg_no_prefix = str_substring(arg, dash_count, arg.len);
+      Str real_argument = str_chop_by_delim(&arg_no_prefix, '=');
+      const usize *idx = hm_get_usize(args->hm, str_hash(real_argument));
+      if (idx == NULL) {
+        error_emit(&error, ERR_PARSE, STR_REPR ": unknown argument", STR_ARG(arg));
+        goto defer;
+      }
+      Argument *argument = &args->arguments.items[*idx];
+      if (argument->parsed) {
+        error_emit(&error, ERR_PARSE, STR_REPR ": argument was passed twice", STR_ARG(arg));
+        goto defer;
+      }
+      if (argument->type == ARG_TYPE_FLAG) {
+        argument->as.flag = true; // flag turned on
+        continue;
+      }
+      if (argument->pos) {
+        positional_count++;
+      }
+
+      Str next_arg = arg_no_prefix.len ? arg_no_prefix : args_shift(args);
+      args_parse_argument(argument, next_arg, &error);
+      error_propagate(&error, { goto defer; });
+
+      continue;
+    }
+
+    while (true) {
+      if (argument_idx >= args->arguments.len) {
+        error_emit(&error, ERR_PARSE,
+                   STR_REPR ": too many positional arguments: got %d expected %" USIZE_FMT,
+                   STR_ARG(arg), argument_idx, args->positional);
+        goto defer;
+      }
+      Argument *argument = &args->arguments.items[argument_idx++];
+      if (argument->parsed) {
+        continue; // next
+      }
+      if (argument->type == ARG_TYPE_FLAG) {
+        continue; // next
+      }
+
+      positional_count++;
+      args_parse_argument(argument, arg, &error);
+      error_propagate(&error, { goto defer; });
+
+      break;
+    }
+  }
+
+  if (positional_count < args->positional) {
+    error_emit(&error, ERR_PARSE, "not enough positional arguments: got %d expected %" USIZE_FMT,
+               positional_count, args->positional);
+    goto defer;
+  }
+
+defer:
+  error_context(&error, {
+    if (error_code(ArgParseError) == ERR_PARSE) {
+      fprintf(stderr, STR_FMT "\n", STR_ARG(error_msg()));
+      args_print_usage(args, stderr);
+      error_except();
+      return false;
+    }
+  });
+
+  return true;
+}
+
+#define ARGS_GENERIC_IMPLEMENTATION(NAME, T, T_ENUM)                                               \
+  void args_add_##NAME(Args *args, const char *argument, const char *description) {                \
+    cebus_assert(args->positional == args->arguments.len,                                          \
+                 "an optional argument was passed before!");                                       \
+    args->positional++;                                                                            \
+    args->hm = args->hm ? args->hm : hm_create(args->arguments.arena);                             \
+    Str name = str_from_cstr(argument);                                                            \
+    hm_insert_usize(args->hm, str_hash(name), da_len(&args->arguments));                           \
+    da_push(&args->arguments, (Argument){                                                          \
+                                  .name = name,                                                    \
+                                  .description = str_from_cstr(description),                       \
+                                  .pos = true,                                                     \
+                                  .type = T_ENUM,                                                  \
+                                  .as = {0},                                                       \
+                              });                                                                  \
+  }                                                                                                \
+  void args_add_opt_##NAME(Args *args, const char *argument, T def, const char *description) {     \
+    args->hm = args->hm ? args->hm : hm_create(args->arguments.arena);                             \
+    Str name = str_from_cstr(argument);                                                            \
+    hm_insert_usize(args->hm, str_hash(name), da_len(&args->arguments));                           \
+    da_push(&args->arguments, (Argument){                                                          \
+                                  .name = name,                                                    \
+                                  .description = str_from_cstr(description),                       \
+                                  .type = T_ENUM,                                                  \
+                                  .as.NAME = def,                                                  \
+                              });                                                                  \
+  }                                                                                                \
+  T args_get_##NAME(Args *args, const char *argument) {                                            \
+    cebus_assert(args->hm != NULL, "no arguments were given");                                     \
+    const usize *idx = hm_get_usize(args->hm, str_hash(str_from_cstr(argument)));                  \
+    cebus_assert(idx && args->arguments.items[*idx].type == T_ENUM, "");                           \
+    return args->arguments.items[*idx].as.NAME;                                                    \
+  }
+
+ARGS_GENERIC_IMPLEMENTATION(i64, i64, ARG_TYPE_I64)
+ARGS_GENERIC_IMPLEMENTATION(u64, u64, ARG_TYPE_U64)
+ARGS_GENERIC_IMPLEMENTATION(str, Str, ARG_TYPE_STR)
+
+void args_add_opt_flag(Args *args, const char *argument, const char *description) {
+  args->hm = args->hm ? args->hm : hm_create(args->arguments.arena);
+  usize idx = da_len(&args->arguments);
+  Str name = str_from_cstr(argument);
+  hm_insert_usize(args->hm, str_hash(name), idx);
+  da_push(&args->arguments, (Argument){
+                                .name = name,
+                                .description = str_from_cstr(description),
+                                .type = ARG_TYPE_FLAG,
+                                .as.flag = false,
+                            });
+}
+
+bool args_get_flag(Args *args, const char *argument) {
+  cebus_assert(args->hm != NULL, "no arguments were given");
+  const usize *idx = hm_get_usize(args->hm, str_hash(str_from_cstr(argument)));
+  cebus_assert(idx && args->arguments.items[*idx].type == ARG_TYPE_FLAG, "");
+  return args->arguments.items[*idx].as.flag;
+}
+
+#undef ARGS_GENERIC_IMPLEMENTATION
+
+// #include "cmd.h"
+
+// #include "cebus/collection/da.h"
+// #include "cebus/core/arena.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void cmd_exec_da(Error *error, const Cmd *cmd) { cmd_exec(error, cmd->len, cmd->items); }
+
+////////////////////////////////////////////////////////////////////////////
+#if defined(LINUX)
+
+#include <errno.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+void cmd_exec(Error *error, size_t argc, Str *argv) {
+  errno = 0;
+  pid_t pid = fork();
+  if (pid == -1) {
+    error_emit(error, CMD_FORK, "fork failed: %s", strerror(errno));
+  } else if (pid == 0) {
+    Arena arena = {0};
+
+    DA(char *) args = {0};
+    da_init(&args, &arena);
+    for (size_t i = 0; i < argc; i++) {
+      char *cmd = arena_calloc(&arena, argv[i].len + 1);
+      strncpy(cmd, argv[i].data, argv[i].len);
+      da_push(&args, cmd);
+    }
+    da_push(&args, NULL);
+    execvp(args.items[0], args.items);
+
+    arena_free(&arena);
+    exit(CMD_NOT_FOUND);
+  }
+
+  int status = 0;
+  waitpid(pid, &status, 0);
+  if (WIFEXITED(status)) {
+    int exit_code = WEXITSTATUS(status);
+    if (exit_code == CMD_NOT_FOUND) {
+      error_emit(error, CMD_NOT_FOUND, "command not found: " STR_FMT, STR_ARG(argv[0]));
+    } else if (exit_code != 0) {
+      error_emit(error, exit_code, "command failed: " STR_FMT ": exit code: %d\n", STR_ARG(argv[0]),
+                 exit_code);
+    }
+  }
+}
+
+////////////////////////////////////////////////////////////////////////////
+#elif defined(WINDOWS)
+
+// #include "cebus/type/string.h"
+
+void cmd_exec(Error *error, size_t argc, Str *argv) {
+  STARTUPINFOA si;
+  PROCESS_INFORMATION pi;
+  ZeroMemory(&si, sizeof(si));
+  si.cb = sizeof(si);
+  ZeroMemory(&pi, sizeof(pi));
+
+  Arena arena = {0};
+
+  Str command = str_wrap(argv[0], STR("\""), &arena);
+  Str args = str_join(STR(" "), argc - 1, argv + 1, &arena);
+  char *cmd = arena_calloc(&arena, command.len + 1 + args.len + 1);
+  strncpy(cmd, command.data, command.len);
+  cmd[command.len] = ' ';
+  strncpy(cmd + command.len + 1, args.data, args.len);
+
+  if (!CreateProcessA(NULL, cmd, NULL, NULL, FALSE, 0, NULL, NULL, &si, &pi)) {
+    DWORD ec = GetLastError();
+    if (ec == 0x2) {
+      error_emit(error, CMD_NOT_FOUND, "command not found: " STR_FMT, STR_ARG(argv[0]));
+    } else {
+      error_emit(error, (i32)ec, "command creation failed: " STR_FMT ": %lu", STR_ARG(argv[0]), ec);
+    }
+    goto defer;
+  }
+  WaitForSingleObject(pi.hProcess, INFINITE);
+
+  DWORD exit_code = 0;
+  if (!GetExitCodeProcess(pi.hProcess, &exit_code)) {
+    DWORD ec = GetLastError();
+    error_emit(error, (i32)ec, "Could not get exit code of process: " STR_FMT ": %lu",
+               STR_ARG(argv[0]), ec);
+    goto defer;
+  }
+  if (exit_code != 0) {
+    error_emit(error, (i32)exit_code, "command failed: " STR_FMT ": %lu", STR_ARG(command),
+               exit_code);
+    goto defer;
+  }
+
+defer:
+  arena_free(&arena);
+  CloseHandle(pi.hProcess);
+  CloseHandle(pi.hThread);
+}
+
+////////////////////////////////////////////////////////////////////////////
+#endif
+
+// #include "dll.h"
+
+// #include "cebus/core/platform.h"
+// #include "cebus/os/fs.h"
+// #include "cebus/type/integer.h"
+// #include "cebus/type/string.h"
+
+#include <stdio.h>
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+#if defined(LINUX)
+#include <dlfcn.h>
+
+Dll *dll_load(Path path, Error *error) {
+  if (!fs_exists(path)) {
+    error_emit(error, FS_NOT_FOUND, "dll: library does not exist: " STR_FMT, STR_ARG(path));
+    return NULL;
+  }
+  char lib_path[FILENAME_MAX] = {0};
+  memcpy(lib_path, path.data, usize_min(path.len, FILENAME_MAX));
+
+  Dll *handle = dlopen(lib_path, RTLD_LAZY);
+  if (handle == NULL) {
+    error_emit(error, -1, "dll: %s: %s\n", lib_path, dlerror());
+    return NULL;
+  }
+  return handle;
+}
+
+void dll_close(Dll *handle) { dlclose(handle); }
+
+Function dll_symbol(Dll *handle, Str symbol, Error *error) {
+  Arena arena = {0};
+  symbol = str_copy(symbol, &arena);
+
+  Function fn;
+  *(void **)(&fn) = dlsym(handle, symbol.data);
+  if (fn == NULL) {
+    error_emit(error, -1, "dll function: %s: %s\n", symbol.data, dlerror());
+    goto defer;
+  }
+
+defer:
+  arena_free(&arena);
+  return fn;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+#elif defined(WINDOWS)
+
+Dll *dll_load(Str path, Error *error) {
+  if (!fs_exists(path)) {
+    error_emit(error, -1, "dll: library does not exist: " STR_FMT, STR_ARG(path));
+    return NULL;
+  }
+  char lib_path[FILENAME_MAX] = {0};
+  memcpy(lib_path, path.data, usize_min(path.len, FILENAME_MAX));
+
+  char temp_path[MAX_PATH];
+  GetTempPath(MAX_PATH, temp_path);
+
+  char temp_file_name[MAX_PATH];
+  GetTempFileName(temp_path, TEXT("lib"), 0, temp_file_name);
+  CopyFile(lib_path, temp_file_name, 0);
+
+  HINSTANCE handle = LoadLibraryA(temp_file_name);
+  if (handle == NULL) {
+    DWORD ec = GetLastError();
+    error_emit(error, (i32)ec, "error loading library: " STR_FMT ": %lu\n", STR_ARG(path),
+               GetLastError());
+    return NULL;
+  }
+  return handle;
+}
+
+void dll_close(Dll *handle) {
+  char temp_file_name[MAX_PATH];
+  GetModuleFileName(handle, temp_file_name, MAX_PATH);
+  FreeLibrary(handle);
+  DeleteFile(temp_file_name);
+}
+
+Function dll_symbol(Dll *handle, Str symbol, Error *error) {
+  Arena arena = {0};
+  symbol = str_copy(symbol, &arena);
+  Function fn = (Function)GetProcAddress(handle, symbol.data);
+  if (fn == NULL) {
+    DWORD err_code = GetLastError();
+    error_emit(error, (i32)err_code, "dll function: %s: %lu\n", symbol.data, err_code);
+    goto defer;
+  }
+
+defer:
+  arena_free(&arena);
+  return fn;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+#endif
+
+// #include "fs.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/core/error.h"
+// #include "cebus/type/byte.h"
+// #include "cebus/type/path.h"
+// #include "cebus/type/string.h"
+// #include "cebus/type/utf8.h"
+// #include "io.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////
+
+static usize file_size(FILE *handle, Error *error) {
+  fseek(handle, 0, SEEK_END);
+  const long size = ftell(handle);
+  fseek(handle, 0, SEEK_SET);
+  if (size < 0) {
+    error_emit(error, errno, "Could not get file size: %s", strerror(errno));
+    return 0;
+  }
+  return (usize)size;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+FILE *fs_file_open(Path path, const char *mode, Error *error) {
+  char _filename[FILENAME_MAX] = {0};
+  memcpy(_filename, path.data, path.len);
+  errno = 0;
+  FILE *handle = fopen(_filename, mode);
+  if (handle == NULL) {
+    error_emit(error, errno, "Could not open file: '%s': %s", _filename, strerror(errno));
+  }
+  return handle;
+}
+
+void fs_file_close(FILE *file, Error *error) {
+  if (file == NULL) {
+    error_emit(error, FS_INVALID, "can't close a FILE* that is NULL");
+    return;
+  }
+  errno = 0;
+  int ret = fclose(file);
+  if (ret == EOF) {
+    error_emit(error, errno, "closing file failed: %s", strerror(errno));
+  }
+}
+
+Bytes fs_file_read_bytes(Path filename, Arena *arena, Error *error) {
+  Bytes result = {0};
+
+  FILE *handle = fs_file_open(filename, "rb", error);
+  error_propagate(error, { goto defer; });
+
+  usize size = file_size(handle, error);
+  error_propagate(error, { goto defer; });
+
+  u8 *buffer = arena_alloc(arena, size);
+
+  result = io_read_bytes(handle, size, buffer, error);
+  error_propagate(error, { goto defer; });
+
+defer:
+  if (handle) {
+    fs_file_close(handle, error);
+  }
+  return result;
+}
+
+Str fs_file_read_str(Path filename, Arena *arena, Error *error) {
+  Bytes result = {0};
+
+  FILE *handle = fs_file_open(filename, "r", error);
+  error_propagate(error, { goto defer; });
+
+  usize size = file_size(handle, error);
+  error_propagate(error, { goto defer; });
+
+  u8 *buffer = arena_alloc(arena, size + 1);
+  buffer[size] = '\0';
+
+  result = io_read_bytes(handle, size, buffer, error);
+  error_propagate(error, { goto defer; });
+
+defer:
+  if (handle) {
+    fs_file_close(handle, error);
+  }
+  return str_from_bytes(result);
+}
+
+Utf8 fs_file_read_utf8(Path filename, Arena *arena, Error *error) {
+  Bytes result = {0};
+
+  FILE *handle = fs_file_open(filename, "r", error);
+  error_propagate(error, { goto defer; });
+
+  usize size = file_size(handle, error);
+  error_propagate(error, { goto defer; });
+
+  u8 *buffer = arena_alloc(arena, size + 1);
+  buffer[size] = '\0';
+
+  result = io_read_bytes(handle, size, buffer, error);
+  error_propagate(error, { goto defer; });
+
+defer:
+  if (handle) {
+    fs_file_close(handle, error);
+  }
+
+  Utf8 res = utf8_decode(result, error);
+  error_propagate(error, { return (Utf8){0}; });
+  return res;
+}
+
+u64 fs_file_hash(Path filename, Error *error) {
+  Hasher hasher = hasher_init(0);
+
+  FILE *handle = fs_file_open(filename, "rb", error);
+  error_propagate(error, { goto defer; });
+
+  u8 buffer[16 * 1024];
+  while (true) {
+    Bytes chunk = io_read_bytes(handle, sizeof(buffer), buffer, error);
+    error_propagate(error, { goto defer; });
+    if (chunk.size == 0) {
+      break;
+    }
+    hasher_update(&hasher, chunk);
+  }
+
+defer:
+  if (handle) {
+    fs_file_close(handle, error);
+  }
+  return hasher_final(&hasher);
+}
+
+void fs_file_write_bytes(Path filename, Bytes bytes, Error *error) {
+  FILE *handle = fs_file_open(filename, "w", error);
+  error_propagate(error, { goto defer; });
+
+  io_write_bytes(handle, bytes, error);
+  error_propagate(error, { goto defer; });
+
+defer:
+  if (handle) {
+    fclose(handle);
+  }
+}
+
+void fs_file_write_str(Path filename, Str content, Error *error) {
+  fs_file_write_bytes(filename, str_to_bytes(content), error);
+}
+
+void fs_file_write_utf8(Path filename, Utf8 content, Error *error) {
+  Bytes bytes = utf8_encode(content, error);
+  error_propagate(error, { return; });
+  fs_file_write_bytes(filename, bytes, error);
+}
+
+void fs_rename(Path old_path, Path new_path, Error *error) {
+  char _old_path[FILENAME_MAX] = {0};
+  memcpy(_old_path, old_path.data, old_path.len);
+
+  char _new_path[FILENAME_MAX] = {0};
+  memcpy(_new_path, new_path.data, new_path.len);
+
+  errno = 0;
+  int ret = rename(_old_path, _new_path);
+  if (ret == -1) {
+    error_emit(error, errno, "Could not rename the file: " STR_FMT ": %s", STR_ARG(old_path),
+               strerror(errno));
+  }
+}
+
+void fs_remove(Path path, Error *error) {
+  char _path[FILENAME_MAX] = {0};
+  memcpy(_path, path.data, path.len);
+
+  errno = 0;
+  int ret = remove(_path);
+  if (ret == -1) {
+    error_emit(error, errno, "Could not remove the file: " STR_FMT ": %s", STR_ARG(path),
+               strerror(errno));
+  }
+}
+
+bool fs_iter_next_filter(FsIter *it, bool (*filter)(FsEntity *entity)) {
+  while (fs_iter_next(it)) {
+    if (filter(&it->current)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool fs_iter_next_directory(FsIter *it) {
+  while (fs_iter_next(it)) {
+    if (it->current.is_dir) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool fs_iter_next_files(FsIter *it) {
+  while (fs_iter_next(it)) {
+    if (!it->current.is_dir) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool fs_iter_next_suffix(FsIter *it, Str suffix) {
+  while (fs_iter_next_files(it)) {
+    if (str_eq(path_suffix(it->current.path), suffix)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+#if defined(LINUX)
+
+#include <dirent.h>
+#include <sys/stat.h> // For struct stat and S_ISDIR
+#include <unistd.h>
+
+typedef struct FsNode {
+  DIR *handle;
+  struct FsNode *next;
+  char name[];
+} FsNode;
+
+bool fs_exists(Path path) {
+  char _path[FILENAME_MAX] = {0};
+  memcpy(_path, path.data, path.len);
+  return access(_path, 0) == 0;
+}
+
+bool fs_is_dir(Path path) {
+  char _path[FILENAME_MAX] = {0};
+  memcpy(_path, path.data, path.len);
+
+  struct stat entry_info;
+  if (stat(_path, &entry_info) == -1) {
+    return false;
+  }
+
+  return S_ISDIR(entry_info.st_mode);
+}
+
+FsIter fs_iter_begin(Path directory, bool recursive) {
+  FsIter it = {.recursive = recursive, .error = ErrNew};
+
+  const usize size = sizeof(FsNode) + directory.len + 1;
+  FsNode *node = arena_calloc_chunk(&it.scratch, size);
+  memcpy(node->name, directory.data, directory.len);
+
+  node->handle = opendir(node->name);
+  if (node->handle == NULL) {
+    error_emit(&it.error, errno, "opendir failed: %s", strerror(errno));
+    return it;
+  }
+  it._stack = node;
+  return it;
+}
+
+void fs_iter_end(FsIter *it, Error *error) {
+  error_propagate(&it->error, {
+    if (!error) {
+      error_panic();
+    }
+    const FileLocation loc = error->location;
+    bool panic = error->panic_on_emit;
+    *error = it->error;
+    error->location = loc;
+    if (panic) {
+      error_panic();
+    }
+  });
+  while (it->_stack != NULL) {
+    FsNode *current = it->_stack;
+    it->_stack = current->next;
+    closedir(current->handle);
+    arena_free_chunk(&it->scratch, current);
+  }
+  arena_free(&it->scratch);
+}
+
+bool fs_iter_next(FsIter *it) {
+  while (it->_stack != NULL) {
+    arena_reset(&it->scratch);
+    FsNode *current = it->_stack;
+
+    struct dirent *entry = readdir(current->handle);
+    if (entry == NULL) {
+      closedir(current->handle);
+      it->_stack = current->next;
+      arena_free_chunk(&it->scratch, current);
+      continue;
+    }
+
+    // skip "." and ".." directories
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+      continue;
+    }
+
+    Str path = str_format(&it->scratch, "%s/%s", current->name, entry->d_name);
+
+    struct stat entry_info;
+    if (stat(path.data, &entry_info) == -1) {
+      error_emit(&it->error, errno, "stat failed: %s", strerror(errno));
+      return false;
+    }
+
+    it->current.path = path;
+    it->current.is_dir = S_ISDIR(entry_info.st_mode);
+
+    if (it->current.is_dir && it->recursive) {
+      const usize size = sizeof(FsNode) + path.len + 1;
+      FsNode *node = arena_calloc_chunk(&it->scratch, size);
+      memcpy(node->name, path.data, path.len);
+      node->handle = opendir(path.data);
+      if (node->handle == NULL) {
+        error_emit(&it->error, errno, "opendir failed: %s", strerror(errno));
+        return false;
+      }
+      node->next = it->_stack;
+      it->_stack = node;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+#elif defined(WINDOWS)
+
+#include <io.h>
+
+typedef struct FsNode {
+  HANDLE handle;
+  struct FsNode *next;
+  usize len;
+  char name[];
+} FsNode;
+
+bool fs_exists(Path path) {
+  char _path[FILENAME_MAX] = {0};
+  memcpy(_path, path.data, path.len);
+  return _access(_path, 0) == 0;
+}
+
+bool fs_is_dir(Path path) {
+  char _path[FILENAME_MAX] = {0};
+  memcpy(_path, path.data, path.len);
+  DWORD attributes = GetFileAttributes(_path);
+  if (attributes == INVALID_FILE_ATTRIBUTES) {
+    return false;
+  }
+  if (attributes & FILE_ATTRIBUTE_DIRECTORY) {
+    return true;
+  }
+
+  return false;
+}
+
+FsIter fs_iter_begin(Path directory, bool recursive) {
+  FsIter it = {.recursive = recursive, .error = ErrNew};
+
+  const usize len = directory.len + (sizeof("/*") - 1);
+  const usize size = sizeof(FsNode) + len + 1;
+  FsNode *node = arena_calloc_chunk(&it.scratch, size);
+  memcpy(node->name, directory.data, directory.len);
+  memcpy(&node->name[directory.len], "/*", 2);
+  node->len = len;
+
+  WIN32_FIND_DATA findFileData;
+  node->handle = FindFirstFile(node->name, &findFileData);
+  if (node->handle == INVALID_HANDLE_VALUE) {
+    DWORD err = GetLastError();
+    error_emit(&it.error, (i32)err, "FindFirstFile failed (%ld)\n", err);
+    return it;
+  }
+
+  it._stack = node;
+
+  return it;
+}
+
+void fs_iter_end(FsIter *it, Error *error) {
+  error_propagate(&it->error, {
+    if (!error) {
+      error_panic();
+    }
+    const FileLocation loc = error->location;
+    bool panic = error->panic_on_emit;
+    *error = it->error;
+    error->location = loc;
+    if (panic) {
+      error_panic();
+    }
+  });
+  while (it->_stack != NULL) {
+    FsNode *current = it->_stack;
+    it->_stack = current->next;
+    FindClose(current->handle);
+    arena_free_chunk(&it->scratch, current);
+  }
+  arena_free(&it->scratch);
+}
+
+bool fs_iter_next(FsIter *it) {
+  while (it->_stack != NULL) {
+    arena_reset(&it->scratch);
+    FsNode *current = it->_stack;
+
+    WIN32_FIND_DATA findFileData;
+    if (!FindNextFile(current->handle, &findFileData)) {
+      FindClose(current->handle);
+      it->_stack = current->next;
+      arena_free_chunk(&it->scratch, current);
+      continue;
+    }
+
+    // skip "." and ".." directories
+    if (strcmp(findFileData.cFileName, ".") == 0 || strcmp(findFileData.cFileName, "..") == 0) {
+      continue;
+    }
+
+    Str path = str_format(&it->scratch, "%.*s/%s", (i32)current->len - 2, current->name,
+                          findFileData.cFileName);
+
+    it->current.path = path;
+    it->current.is_dir = findFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY;
+
+    if (it->current.is_dir && it->recursive) {
+      const usize len = path.len + (sizeof("/*") - 1);
+      const usize size = sizeof(FsNode) + len + 1;
+      FsNode *node = arena_calloc_chunk(&it->scratch, size);
+      memcpy(node->name, path.data, path.len);
+      memcpy(&node->name[path.len], "/*", 2);
+      node->len = len;
+      node->handle = FindFirstFile(node->name, &findFileData);
+      if (node->handle == INVALID_HANDLE_VALUE) {
+        DWORD err = GetLastError();
+        error_emit(&it->error, (i32)err, "FindFirstFile failed (%ld)\n", err);
+        return false;
+      }
+      node->next = it->_stack;
+      it->_stack = node;
+    }
+
+    return true;
+  }
+
+  return false;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+#endif
+
+// #include "io.h"
+
+// #include "cebus/type/byte.h"
+// #include "cebus/type/string.h"
+
+#include <errno.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////
+
+#define IO_MAX_INPUT 512
+
+////////////////////////////////////////////////////////////////////////////
+
+usize io_write_fmt(FILE *file, const char *fmt, ...) {
+  va_list va;
+  va_start(va, fmt);
+  i32 size = vfprintf(file, fmt, va);
+  va_end(va);
+  return (usize)size;
+}
+
+void io_write_bytes(FILE *file, Bytes bytes, Error *error) {
+  errno = 0;
+  fwrite(bytes.data, sizeof(bytes.data[0]), bytes.size, file);
+  if (ferror(file)) {
+    error_emit(error, errno, "Could not write file: %s", strerror(errno));
+  }
+}
+
+void io_write_str(FILE *file, Str string, Error *error) {
+  io_write_bytes(file, str_to_bytes(string), error);
+}
+
+static bool io_write_part(void *ctx, Str part) {
+  FILE *file = ctx;
+  fwrite(part.data, sizeof(part.data[0]), part.len, file);
+  return !ferror(file);
+}
+
+void io_write_replace(FILE *file, Str s, Str old, Str new, Error *error) {
+  errno = 0;
+  _str_replace_each(s, old, new, false, io_write_part, file);
+  if (ferror(file)) {
+    error_emit(error, errno, "Could not write file: %s", strerror(errno));
+  }
+}
+
+void io_write_replace_ignorecase(FILE *file, Str s, Str old, Str new, Error *error) {
+  errno = 0;
+  _str_replace_each(s, old, new, true, io_write_part, file);
+  if (ferror(file)) {
+    error_emit(error, errno, "Could not write file: %s", strerror(errno));
+  }
+}
+
+Bytes io_read_bytes(FILE *file, usize size, void *buffer, Error *error) {
+  errno = 0;
+  const usize bytes_read = fread(buffer, sizeof(u8), size, file);
+  if (ferror(file)) {
+    error_emit(error, errno, "Could not read file: %s", strerror(errno));
+    return (Bytes){0};
+  }
+  return bytes_from_parts(bytes_read, buffer);
+}
+
+Str io_read_line(FILE *file, usize size, char *buffer, Error *error) {
+  clearerr(file);
+  if (fgets(buffer, (int)size, file) == NULL) {
+    if (ferror(file)) {
+      error_emit(error, errno, "Could not read line: %s", strerror(errno));
+      return (Str){0};
+    }
+    error_emit(error, EOF, "EOF");
+    return (Str){0};
+  }
+  return str_from_cstr(buffer);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+Str input(Str prefix) {
+  static char buffer[IO_MAX_INPUT] = {0};
+  printf(STR_FMT, STR_ARG(prefix));
+  fflush(stdout);
+  Str res = io_read_line(stdin, IO_MAX_INPUT, buffer, NULL);
+  return str_substring(res, 0, res.len - 1);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+// #include "os.h"
+
+// #include "cebus/core/debug.h"
+// #include "cebus/type/integer.h"
+// #include "cebus/type/string.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+////////////////////////////////////////////////////////////////////////////
+
+Str os_getenv(const char *env, Error *error) {
+  const char *var = getenv(env);
+  if (var == NULL) {
+    error_emit(error, 0, "Could not get environment variable: %s", env);
+    return (Str){0};
+  }
+  return str_from_cstr(var);
+}
+
+////////////////////////////////////////////////////////////////////////////
+#if defined(LINUX)
+
+#include <errno.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+void os_chdir(Path path) {
+  char pathname[FILENAME_MAX] = {0};
+  memcpy(pathname, path.data, usize_min(path.len, FILENAME_MAX));
+  cebus_assert(chdir(pathname) == -1, "Could not change directory to '" STR_FMT "': %s",
+               STR_ARG(path), strerror(errno));
+}
+
+void os_mkdir(Path path) {
+  os_mkdir_mode(path, 0755); // NOLINT
+}
+
+void os_mkdir_mode(Path path, u32 mode) {
+  char pathname[FILENAME_MAX] = {0};
+  memcpy(pathname, path.data, usize_min(path.len, FILENAME_MAX));
+  mkdir(pathname, mode);
+}
+
+Path os_getcwd(Arena *arena) {
+  char *buf = arena_alloc(arena, FILENAME_MAX);
+  char *ret = getcwd(buf, FILENAME_MAX);
+  cebus_assert(ret, "Could not get cwd");
+  return str_from_cstr(ret);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+#elif defined(WINDOWS)
+
+#include <direct.h>
+
+void os_chdir(Path path) {
+  char buffer[FILENAME_MAX] = {0};
+  memcpy(buffer, path.data, usize_min(path.len, FILENAME_MAX));
+  _chdir(buffer);
+}
+
+void os_mkdir(Path path) {
+  char pathname[FILENAME_MAX] = {0};
+  memcpy(pathname, path.data, usize_min(path.len, FILENAME_MAX));
+  _mkdir(pathname);
+}
+
+void os_mkdir_mode(Path path, u32 mode) {
+  (void)mode;
+  os_mkdir(path);
+}
+
+Path os_getcwd(Arena *arena) {
+  DWORD size = GetCurrentDirectory(0, NULL);
+  char *buf = arena_alloc(arena, size);
+  GetCurrentDirectory((DWORD)size, buf);
+  // TODO error handling
+  return str_from_parts(size, buf);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif
+
+// #include "thread.h"
+
+// #include "cebus/core/cpu.h"
+// #include "cebus/core/debug.h"
+// #include "cebus/core/platform.h"
+
+////////////////////////////////////////////////////////////////////////////
+#if defined(LINUX)
+#include <pthread.h>
+
+typedef pthread_t ThreadHandle;
+typedef pthread_mutex_t ThreadMutex;
+typedef pthread_cond_t ThreadCondition;
+
+#define THREAD_FN(name, arg) static void *name(void *arg)
+#define THREAD_RETURN return NULL
+
+#define mutex_init(m) pthread_mutex_init(m, NULL)
+#define mutex_destroy(m) pthread_mutex_destroy(m)
+#define mutex_lock(m) pthread_mutex_lock(m)
+#define mutex_unlock(m) pthread_mutex_unlock(m)
+#define condition_init(c) pthread_cond_init(c, NULL)
+#define condition_destroy(c) pthread_cond_destroy(c)
+#define condition_wait(c, m) pthread_cond_wait(c, m)
+#define condition_broadcast(c) pthread_cond_broadcast(c)
+
+#define thread_start(t, fn, arg) (pthread_create(t, NULL, fn, arg) == 0)
+#define thread_join(t) pthread_join(t, NULL)
+
+#define THREAD_POOL_THREADS
+
+////////////////////////////////////////////////////////////////////////////
+#elif defined(WINDOWS)
+
+typedef HANDLE ThreadHandle;
+typedef CRITICAL_SECTION ThreadMutex;
+typedef CONDITION_VARIABLE ThreadCondition;
+
+#define THREAD_FN(name, arg) static DWORD WINAPI name(LPVOID arg)
+#define THREAD_RETURN return 0
+
+#define mutex_init(m) InitializeCriticalSection(m)
+#define mutex_destroy(m) DeleteCriticalSection(m)
+#define mutex_lock(m) EnterCriticalSection(m)
+#define mutex_unlock(m) LeaveCriticalSection(m)
+#define condition_init(c) InitializeConditionVariable(c)
+#define condition_destroy(c) ((void)(c))
+#define condition_wait(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define condition_broadcast(c) WakeAllConditionVariable(c)
+
+#define thread_start(t, fn, arg) ((*(t) = CreateThread(NULL, 0, fn, arg, 0, NULL)) != NULL)
+#define thread_join(t) (WaitForSingleObject(t, INFINITE), CloseHandle(t))
+
+#define THREAD_POOL_THREADS
+
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+#if defined(THREAD_POOL_THREADS)
+
+struct ThreadPool {
+  usize threads;
+  ThreadHandle *workers;
+  ThreadMutex mutex;
+  ThreadCondition work;
+  ThreadCondition done;
+  bool stop;
+  // incremented for every job, so a worker knows when there is a new one
+  usize generation;
+  ThreadTask fn;
+  void *ctx;
+  usize tasks;
+  usize next;
+  usize finished;
+};
+
+// Runs tasks of the current job until none are left. Expects the mutex to be
+// locked.
+static void thread_pool_work(ThreadPool *pool) {
+  while (pool->next < pool->tasks) {
+    const usize task = pool->next++;
+    mutex_unlock(&pool->mutex);
+    pool->fn(pool->ctx, task);
+    mutex_lock(&pool->mutex);
+    if (++pool->finished == pool->tasks) {
+      condition_broadcast(&pool->done);
+    }
+  }
+}
+
+THREAD_FN(thread_pool_worker, arg) {
+  ThreadPool *pool = arg;
+  mutex_lock(&pool->mutex);
+  usize generation = pool->generation;
+  while (true) {
+    while (!pool->stop && generation == pool->generation) {
+      condition_wait(&pool->work, &pool->mutex);
+    }
+    if (pool->stop) {
+      break;
+    }
+    generation = pool->generation;
+    thread_pool_work(pool);
+  }
+  mutex_unlock(&pool->mutex);
+  THREAD_RETURN;
+}
+
+ThreadPool *thread_pool_create(Arena *arena, usize threads) {
+  ThreadPool *pool = arena_calloc(arena, sizeof(ThreadPool));
+  pool->threads = threads == 0 ? cpu_count() : threads;
+  pool->workers = arena_calloc(arena, pool->threads * sizeof(ThreadHandle));
+  mutex_init(&pool->mutex);
+  condition_init(&pool->work);
+  condition_init(&pool->done);
+  for (usize i = 0; i + 1 < pool->threads; i++) {
+    const bool started = thread_start(&pool->workers[i], thread_pool_worker, pool);
+    cebus_assert(started, "Could not start worker thread");
+  }
+  return pool;
+}
+
+void thread_pool_destroy(ThreadPool *pool) {
+  mutex_lock(&pool->mutex);
+  pool->stop = true;
+  condition_broadcast(&pool->work);
+  mutex_unlock(&pool->mutex);
+  for (usize i = 0; i + 1 < pool->threads; i++) {
+    thread_join(pool->workers[i]);
+  }
+  condition_destroy(&pool->done);
+  condition_destroy(&pool->work);
+  mutex_destroy(&pool->mutex);
+}
+
+void thread_pool_run(ThreadPool *pool, usize tasks, ThreadTask fn, void *ctx) {
+  if (tasks == 0) {
+    return;
+  }
+  if (tasks == 1 || pool->threads == 1) {
+    for (usize task = 0; task < tasks; task++) {
+      fn(ctx, task);
+    }
+    return;
+  }
+  mutex_lock(&pool->mutex);
+  pool->fn = fn;
+  pool->ctx = ctx;
+  pool->tasks = tasks;
+  pool->next = 0;
+  pool->finished = 0;
+  pool->generation++;
+  condition_broadcast(&pool->work);
+  thread_pool_work(pool);
+  while (pool->finished < pool->tasks) {
+    condition_wait(&pool->done, &pool->mutex);
+  }
+  mutex_unlock(&pool->mutex);
+}
+
+struct ThreadLock {
+  ThreadMutex mutex;
+};
+
+ThreadLock *thread_lock_create(Arena *arena) {
+  ThreadLock *lock = arena_calloc(arena, sizeof(ThreadLock));
+  mutex_init(&lock->mutex);
+  return lock;
+}
+
+void thread_lock_destroy(ThreadLock *lock) { mutex_destroy(&lock->mutex); }
+
+void thread_lock_acquire(ThreadLock *lock) { mutex_lock(&lock->mutex); }
+
+void thread_lock_release(ThreadLock *lock) { mutex_unlock(&lock->mutex); }
+
+////////////////////////////////////////////////////////////////////////////
+#else
+
+struct ThreadPool {
+  usize threads;
+};
+
+ThreadPool *thread_pool_create(Arena *arena, usize threads) {
+  (void)threads;
+  ThreadPool *pool = arena_calloc(arena, sizeof(ThreadPool));
+  pool->threads = 1;
+  return pool;
+}
+
+void thread_pool_destroy(ThreadPool *pool) { (void)pool; }
+
+void thread_pool_run(ThreadPool *pool, usize tasks, ThreadTask fn, void *ctx) {
+  (void)pool;
+  for (usize task = 0; task < tasks; task++) {
+    fn(ctx, task);
+  }
+}
+
+struct ThreadLock {
+  u8 unused;
+};
+
+ThreadLock *thread_lock_create(Arena *arena) { return arena_calloc(arena, sizeof(ThreadLock)); }
+
+void thread_lock_destroy(ThreadLock *lock) { (void)lock; }
+
+void thread_lock_acquire(ThreadLock *lock) { (void)lock; }
+
+void thread_lock_release(ThreadLock *lock) { (void)lock; }
+
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+usize thread_pool_threads(const ThreadPool *pool) { return pool->threads; }
+
+////////////////////////////////////////////////////////////////////////////
+
+#undef THREAD_FN
+#undef THREAD_RETURN
+#undef THREAD_POOL_THREADS
+#undef mutex_init
+#undef mutex_destroy
+#undef mutex_lock
+#undef mutex_unlock
+#undef condition_init
+#undef condition_destroy
+#undef condition_wait
+#undef condition_broadcast
+#undef thread_start
+#undef thread_join
+
+// #include "bool.h"
+
+bool bool_toggle(bool b) { return !b; }
+
+bool bool_any(usize count, const bool *array) {
+  for (usize i = 0; i < count; ++i) {
+    if (array[i]) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool bool_all(usize count, const bool *array) {
+  for (usize i = 0; i < count; ++i) {
+    if (!array[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// #include "byte.h"
+
+// #include "cebus/core/platform.h"
+// #include "cebus/type/char.h"
+// #include "cebus/type/integer.h"
+// #include "cebus/type/string.h"
+
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+Bytes bytes_from_parts(usize size, const void *data) { return (Bytes){.size = size, .data = data}; }
+
+///////////////////////////////////////////////////////////////////////////////
+
+Bytes bytes_copy(Bytes bytes, Arena *arena) {
+  u8 *buffer = arena_alloc(arena, bytes.size);
+  memcpy(buffer, bytes.data, bytes.size);
+  return bytes_from_parts(bytes.size, buffer);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Bytes bytes_slice(Bytes bytes, usize idx1, usize idx2) {
+  if (idx2 <= idx1 || bytes.size <= idx1 || bytes.size < idx2) {
+    return bytes_from_parts(0, bytes.data);
+  }
+  return bytes_from_parts(idx2 - idx1, &bytes.data[idx1]);
+}
+
+Bytes bytes_take(Bytes *bytes, usize count) {
+  count = usize_min(bytes->size, count);
+  Bytes ret = bytes_from_parts(count, bytes->data);
+  bytes->size -= count;
+  bytes->data += count;
+  return ret;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool bytes_eq(Bytes b1, Bytes b2) {
+  if (b1.size != b2.size) {
+    return false;
+  }
+  return memcmp(b1.data, b2.data, b1.size) == 0;
+}
+
+// XXH64, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+#define BYTES_PRIME64_1 0x9E3779B185EBCA87ULL
+#define BYTES_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define BYTES_PRIME64_3 0x165667B19E3779F9ULL
+#define BYTES_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define BYTES_PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline u64 bytes_rotl(u64 value, u32 bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+static inline u64 bytes_read64(const u8 *data) {
+  u64 value;
+  memcpy(&value, data, sizeof(value));
+#if CEBUS_BYTE_ORDER == ENDIAN_BIG
+  value = u64_swap_bytes(value);
+#endif
+  return value;
+}
+
+static inline u32 bytes_read32(const u8 *data) {
+  u32 value;
+  memcpy(&value, data, sizeof(value));
+#if CEBUS_BYTE_ORDER == ENDIAN_BIG
+  value = u32_swap_bytes(value);
+#endif
+  return value;
+}
+
+static inline u64 bytes_hash_round(u64 acc, u64 input) {
+  acc += input * BYTES_PRIME64_2;
+  return bytes_rotl(acc, 31) * BYTES_PRIME64_1;
+}
+
+static inline u64 bytes_hash_merge(u64 hash, u64 acc) {
+  hash ^= bytes_hash_round(0, acc);
+  return hash * BYTES_PRIME64_1 + BYTES_PRIME64_4;
+}
+
+// Consumes full 32 byte stripes into the four lanes and returns the number of
+// bytes that were consumed.
+static usize bytes_hash_stripes(u64 lanes[4], const u8 *data, usize size) {
+  u64 v1 = lanes[0], v2 = lanes[1], v3 = lanes[2], v4 = lanes[3];
+  usize i = 0;
+  for (; i + 32 <= size; i += 32) {
+    v1 = bytes_hash_round(v1, bytes_read64(&data[i]));
+    v2 = bytes_hash_round(v2, bytes_read64(&data[i + 8]));
+    v3 = bytes_hash_round(v3, bytes_read64(&data[i + 16]));
+    v4 = bytes_hash_round(v4, bytes_read64(&data[i + 24]));
+  }
+  lanes[0] = v1, lanes[1] = v2, lanes[2] = v3, lanes[3] = v4;
+  return i;
+}
+
+static u64 bytes_hash_lanes(const u64 lanes[4]) {
+  u64 hash = bytes_rotl(lanes[0], 1) + bytes_rotl(lanes[1], 7) + bytes_rotl(lanes[2], 12) +
+             bytes_rotl(lanes[3], 18);
+  for (usize i = 0; i < 4; i++) {
+    hash = bytes_hash_merge(hash, lanes[i]);
+  }
+  return hash;
+}
+
+// Mixes in the last bytes, less than a stripe, and the avalanche.
+static u64 bytes_hash_finalize(u64 hash, const u8 *data, usize size) {
+  usize i = 0;
+  for (; i + 8 <= size; i += 8) {
+    hash ^= bytes_hash_round(0, bytes_read64(&data[i]));
+    hash = bytes_rotl(hash, 27) * BYTES_PRIME64_1 + BYTES_PRIME64_4;
+  }
+  if (i + 4 <= size) {
+    hash ^= (u64)bytes_read32(&data[i]) * BYTES_PRIME64_1;
+    hash = bytes_rotl(hash, 23) * BYTES_PRIME64_2 + BYTES_PRIME64_3;
+    i += 4;
+  }
+  for (; i < size; i++) {
+    hash ^= data[i] * BYTES_PRIME64_5;
+    hash = bytes_rotl(hash, 11) * BYTES_PRIME64_1;
+  }
+  hash ^= hash >> 33;
+  hash *= BYTES_PRIME64_2;
+  hash ^= hash >> 29;
+  hash *= BYTES_PRIME64_3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+static void bytes_hash_init(u64 lanes[4], u64 seed) {
+  lanes[0] = seed + BYTES_PRIME64_1 + BYTES_PRIME64_2;
+  lanes[1] = seed + BYTES_PRIME64_2;
+  lanes[2] = seed;
+  lanes[3] = seed - BYTES_PRIME64_1;
+}
+
+u64 bytes_hash(Bytes bytes) { return bytes_hash_seed(bytes, 0); }
+
+u64 bytes_hash_seed(Bytes bytes, u64 seed) {
+  u64 hash = seed + BYTES_PRIME64_5;
+  usize consumed = 0;
+  if (32 <= bytes.size) {
+    u64 lanes[4];
+    bytes_hash_init(lanes, seed);
+    consumed = bytes_hash_stripes(lanes, bytes.data, bytes.size);
+    hash = bytes_hash_lanes(lanes);
+  }
+  hash += (u64)bytes.size;
+  return bytes_hash_finalize(hash, &bytes.data[consumed], bytes.size - consumed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Hasher hasher_init(u64 seed) {
+  Hasher hasher = {.seed = seed};
+  bytes_hash_init(hasher.lanes, seed);
+  return hasher;
+}
+
+void hasher_update(Hasher *hasher, Bytes bytes) {
+  const u8 *data = bytes.data;
+  usize size = bytes.size;
+  hasher->total += size;
+  if (hasher->buffered + size < sizeof(hasher->buffer)) {
+    if (size) {
+      memcpy(&hasher->buffer[hasher->buffered], data, size);
+      hasher->buffered += size;
+    }
+    return;
+  }
+  if (hasher->buffered) {
+    const usize fill = sizeof(hasher->buffer) - hasher->buffered;
+    memcpy(&hasher->buffer[hasher->buffered], data, fill);
+    bytes_hash_stripes(hasher->lanes, hasher->buffer, sizeof(hasher->buffer));
+    data += fill;
+    size -= fill;
+  }
+  const usize consumed = bytes_hash_stripes(hasher->lanes, data, size);
+  hasher->buffered = size - consumed;
+  if (hasher->buffered) {
+    memcpy(hasher->buffer, &data[consumed], hasher->buffered);
+  }
+}
+
+void hasher_update_u64(Hasher *hasher, u64 value) {
+  u8 data[sizeof(u64)];
+  for (usize i = 0; i < sizeof(data); i++) {
+    data[i] = (u8)(value >> (i * 8));
+  }
+  hasher_update(hasher, bytes_from_parts(sizeof(data), data));
+}
+
+void hasher_update_i64(Hasher *hasher, i64 value) { hasher_update_u64(hasher, (u64)value); }
+
+void hasher_update_f64(Hasher *hasher, f64 value) {
+  u64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  hasher_update_u64(hasher, bits);
+}
+
+void hasher_update_str(Hasher *hasher, Str s) {
+  hasher_update_u64(hasher, s.len);
+  hasher_update(hasher, bytes_from_parts(s.len, s.data));
+}
+
+u64 hasher_final(const Hasher *hasher) {
+  u64 hash = hasher->seed + BYTES_PRIME64_5;
+  if (sizeof(hasher->buffer) <= hasher->total) {
+    hash = bytes_hash_lanes(hasher->lanes);
+  }
+  hash += hasher->total;
+  return bytes_hash_finalize(hash, hasher->buffer, hasher->buffered);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Str bytes_to_hex(Bytes bytes, Arena *arena) {
+  static const char digits[] = "0123456789abcdef";
+  char *buf = arena_calloc(arena, bytes.size * 2 + 1);
+  usize idx = 0;
+  for (usize i = 0; i < bytes.size; i++) {
+    // the first byte has no leading zero
+    if (i != 0 || 0x10 <= bytes.data[i]) {
+      buf[idx++] = digits[bytes.data[i] >> 4];
+    }
+    buf[idx++] = digits[bytes.data[i] & 0xf];
+  }
+  return (Str){.len = idx, .data = buf};
+}
+
+Bytes bytes_from_hex(Str s, Arena *arena) {
+  if (str_startswith(s, STR("0x"))) {
+    s = str_substring(s, 2, s.len);
+  }
+
+  u8 *buffer = arena_calloc(arena, (s.len / 2) + (s.len % 2));
+  // to convert strings like "0x101".
+  // in the first iteration:
+  // take 1 or 2 chars depending if s.len is even or odd
+  usize idx = 0;
+  for (Str ch = {0}; str_try_take(&s, idx == 0 ? 2 - s.len % 2 : 2, &ch);) {
+    for (usize i = 0; i < ch.len; i++) {
+      buffer[idx] <<= 4;
+      if (c_is_xdigit(ch.data[i])) {
+        buffer[idx] |= c_hex_to_u8(ch.data[i]);
+      }
+    }
+    idx++;
+  }
+  return bytes_from_parts(idx, buffer);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#undef BYTES_PRIME64_1
+#undef BYTES_PRIME64_2
+#undef BYTES_PRIME64_3
+#undef BYTES_PRIME64_4
+#undef BYTES_PRIME64_5
+
+// #include "char.h"
+// #include "cebus/core/debug.h"
+
+#include <ctype.h>
+
+#define DBASE 10
+#define XBASE 16
+
+///////////////////////////////////////////////////////////////////////////////
+
+bool c_is_alnum(char c) { return isalnum(c); }
+bool c_is_alpha(char c) { return isalpha(c); }
+bool c_is_lower(char c) { return islower(c); }
+bool c_is_upper(char c) { return isupper(c); }
+bool c_is_space(char c) { return isspace(c); }
+bool c_is_cntrl(char c) { return iscntrl(c); }
+bool c_is_print(char c) { return isprint(c); }
+bool c_is_graph(char c) { return isgraph(c); }
+bool c_is_blank(char c) { return isblank(c); }
+bool c_is_punct(char c) { return ispunct(c); }
+bool c_is_digit(char c) { return isdigit(c); }
+bool c_is_xdigit(char c) { return isxdigit(c); }
+
+///////////////////////////////////////////////////////////////////////////////
+
+char c_to_lower(char c) { return (char)tolower(c); }
+char c_to_upper(char c) { return (char)toupper(c); }
+
+u8 c_to_u8(char c) {
+  cebus_assert_debug(c_is_digit(c), "not convertible: '%c'", c);
+  return (u8)c - '0';
+}
+
+u8 c_hex_to_u8(char c) {
+  cebus_assert_debug(c_is_xdigit(c), "not convertible: '%c'", c);
+  if ('0' <= c && c <= '9') {
+    return c_to_u8(c);
+  }
+  if ('a' <= c && c <= 'f') {
+    return DBASE + (u8)c - 'a';
+  }
+  if ('A' <= c && c <= 'F') {
+    return DBASE + (u8)c - 'A';
+  }
+  return 0;
+}
+
+char c_u8_to_c(u8 d) {
+  cebus_assert_debug(d < DBASE, "not convertible: '%d'", d);
+  return '0' + (i8)d;
+}
+
+char c_u8_to_hex(u8 d) {
+  cebus_assert_debug(d < XBASE, "not convertible: '%d'", d);
+  if (d < DBASE) {
+    return c_u8_to_c(d);
+  }
+  if (d < XBASE) {
+    return 'a' + ((i8)d - DBASE);
+  }
+  return 0;
+}
+
+char c_u8_to_HEX(u8 d) {
+  cebus_assert_debug(d < XBASE, "not convertible: '%d'", d);
+  if (d < DBASE) {
+    return c_u8_to_c(d);
+  }
+  if (d < XBASE) {
+    return 'A' + ((i8)d - DBASE);
+  }
+  return 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// #include "charset.h"
+
+// #include "cebus/core/cpu.h"
+// #include "cebus/core/platform.h"
+// #include "cebus/type/integer.h"
+
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(GCC) || defined(CLANG)
+#define CHARSET_FIRST_BIT(mask) ((usize)__builtin_ctz(mask))
+#define CHARSET_LAST_BIT(mask) ((usize)(31 - __builtin_clz(mask)))
+#define CHARSET_COUNT_BITS(mask) ((usize)__builtin_popcount(mask))
+#else
+#define CHARSET_FIRST_BIT(mask) u32_trailing_zeros(mask)
+#define CHARSET_LAST_BIT(mask) (31 - u32_leading_zeros(mask))
+#define CHARSET_COUNT_BITS(mask) u32_count_ones(mask)
+#endif
+
+static inline bool charset_test(const u8 *table, u8 c) {
+  return (table[(c & 0x0f) | (c >> 3 & 0x10)] >> (c >> 4 & 7)) & 1;
+}
+
+static inline void charset_insert(CharSet *set, u8 c) {
+  set->table[(c & 0x0f) | (c >> 3 & 0x10)] |= (u8)(1 << (c >> 4 & 7));
+}
+
+// Index of the first character that is 'in' the set or not, 'len' if there
+// is none.
+static usize charset_find_scalar(const CharSet *set, const char *data, usize len, bool in) {
+  usize i = 0;
+  while (i < len && charset_test(set->table, (u8)data[i]) != in) {
+    i++;
+  }
+  return i;
+}
+
+// Index after the last character that is 'in' the set or not, '0' if there
+// is none.
+static usize charset_find_last_scalar(const CharSet *set, const char *data, usize len, bool in) {
+  usize end = len;
+  while (0 < end && charset_test(set->table, (u8)data[end - 1]) != in) {
+    end--;
+  }
+  return end;
+}
+
+static usize charset_count_scalar(const CharSet *set, const char *data, usize len) {
+  usize count = 0;
+  for (usize i = 0; i < len; i++) {
+    count += charset_test(set->table, (u8)data[i]);
+  }
+  return count;
+}
+
+#if defined(CEBUS_SIMD_X86)
+
+// Bit 'i' of the result is set if byte 'i' of 'v' is in the set. The low
+// nibble selects a byte of both halves of the table, the sign selects the half
+// and the rest of the high nibble selects the bit.
+CEBUS_TARGET_AVX2 static inline u32 charset_match_avx2(__m256i lo, __m256i hi, __m256i v) {
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m256i low = _mm256_and_si256(v, nibble);
+  const __m256i row =
+      _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, low), _mm256_shuffle_epi8(hi, low), v);
+  const __m256i bit =
+      _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+  return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+}
+
+// Both 128 bit lanes need the whole half for the shuffle.
+CEBUS_TARGET_AVX2 static inline __m256i charset_half_avx2(const u8 *half) {
+  return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)half));
+}
+
+CEBUS_TARGET_AVX2 static usize charset_find_avx2(const CharSet *set, const char *data, usize len,
+                                                 bool in) {
+  const __m256i lo = charset_half_avx2(&set->table[0]);
+  const __m256i hi = charset_half_avx2(&set->table[16]);
+  const u32 flip = in ? 0 : 0xffffffff;
+  usize i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    const u32 mask = charset_match_avx2(lo, hi, v) ^ flip;
+    if (mask) {
+      return i + CHARSET_FIRST_BIT(mask);
+    }
+  }
+  return i + charset_find_scalar(set, &data[i], len - i, in);
+}
+
+CEBUS_TARGET_AVX2 static usize charset_find_last_avx2(const CharSet *set, const char *data,
+                                                      usize len, bool in) {
+  const __m256i lo = charset_half_avx2(&set->table[0]);
+  const __m256i hi = charset_half_avx2(&set->table[16]);
+  const u32 flip = in ? 0 : 0xffffffff;
+  usize end = len;
+  for (; 32 <= end; end -= 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)&data[end - 32]);
+    const u32 mask = charset_match_avx2(lo, hi, v) ^ flip;
+    if (mask) {
+      return end - 32 + CHARSET_LAST_BIT(mask) + 1;
+    }
+  }
+  return charset_find_last_scalar(set, data, end, in);
+}
+
+CEBUS_TARGET_AVX2 static usize charset_count_avx2(const CharSet *set, const char *data,
+                                                  usize len) {
+  const __m256i lo = charset_half_avx2(&set->table[0]);
+  const __m256i hi = charset_half_avx2(&set->table[16]);
+  usize count = 0;
+  usize i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    count += CHARSET_COUNT_BITS(charset_match_avx2(lo, hi, v));
+  }
+  return count + charset_count_scalar(set, &data[i], len - i);
+}
+
+#endif
+
+// Strings shorter than a vector are not worth the setup.
+static usize charset_find(const CharSet *set, Str s, bool in) {
+#if defined(CEBUS_SIMD_X86)
+  if (32 <= s.len && cpu_has_avx2()) {
+    return charset_find_avx2(set, s.data, s.len, in);
+  }
+#endif
+  return charset_find_scalar(set, s.data, s.len, in);
+}
+
+static usize charset_find_last(const CharSet *set, Str s, bool in) {
+#if defined(CEBUS_SIMD_X86)
+  if (32 <= s.len && cpu_has_avx2()) {
+    return charset_find_last_avx2(set, s.data, s.len, in);
+  }
+#endif
+  return charset_find_last_scalar(set, s.data, s.len, in);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+CharSet charset_from_predicate(bool (*predicate)(char)) {
+  CharSet set = {0};
+  for (usize c = 0; c < 256; c++) {
+    if (predicate((char)c)) {
+      charset_insert(&set, (u8)c);
+    }
+  }
+  return set;
+}
+
+CharSet charset_from_str(Str chars) {
+  CharSet set = {0};
+  for (usize i = 0; i < chars.len; i++) {
+    charset_insert(&set, (u8)chars.data[i]);
+  }
+  return set;
+}
+
+CharSet charset_invert(CharSet set) {
+  for (usize i = 0; i < sizeof(set.table); i++) {
+    set.table[i] = (u8)~set.table[i];
+  }
+  return set;
+}
+
+bool charset_contains(const CharSet *set, char c) { return charset_test(set->table, (u8)c); }
+
+///////////////////////////////////////////////////////////////////////////////
+
+usize charset_span(const CharSet *set, Str s) { return charset_find(set, s, false); }
+
+usize charset_cspan(const CharSet *set, Str s) { return charset_find(set, s, true); }
+
+usize charset_rspan(const CharSet *set, Str s) { return s.len - charset_find_last(set, s, false); }
+
+usize charset_rcspan(const CharSet *set, Str s) { return s.len - charset_find_last(set, s, true); }
+
+usize charset_count(const CharSet *set, Str s) {
+#if defined(CEBUS_SIMD_X86)
+  if (32 <= s.len && cpu_has_avx2()) {
+    return charset_count_avx2(set, s.data, s.len);
+  }
+#endif
+  return charset_count_scalar(set, s.data, s.len);
+}
 
 ///////////////////////////////////////////////////////////////////////////////
 
-// #include "char.h"
+#undef CHARSET_FIRST_BIT
+#undef CHARSET_LAST_BIT
+#undef CHARSET_COUNT_BITS
+
+// #include "float.h" // IWYU pragma: keep
+
+#include <string.h>
+
+#define FLOAT_IMPL(T, BITS)                                                                        \
+  bool T##_eq(T a, T b) { return T##_abs(a - b) < F##BITS##_EPSILON; }                             \
+  bool T##_eq_eps(T a, T b, T epsilon) { return T##_abs(a - b) < epsilon; }                        \
+  bool T##_isnan(T value) { return value != value; }                                               \
+  T T##_abs(T value) {                                                                             \
+    u##BITS *i = (u##BITS *)&value;                                                                \
+    *i &= ~((u##BITS)0x8 << (BITS - 1 - 3));                                                       \
+    return value;                                                                                  \
+  }                                                                                                \
+  T T##_min(T a, T b) { return a < b ? a : b; }                                                    \
+  T T##_max(T a, T b) { return a > b ? a : b; }                                                    \
+  T T##_clamp(T min, T max, T value) { return value < min ? min : value > max ? max : value; }     \
+  T T##_lerp(T min, T max, T value) { return min + value * (max - min); }                          \
+  T T##_rad(T deg) { return deg * ((T)F64_PI / 180.0f); }                                          \
+  T T##_deg(T rad) { return rad * ((T)F64_PI / 180.0f); }
+
+FLOAT_IMPL(f32, 32)
+FLOAT_IMPL(f64, 64)
+
+#undef FLOAT_IMPL
+
+#define F64_LN2 0.6931471805599453
+
+f64 f64_exp(f64 x) {
+  if (x != x) {
+    return x;
+  }
+  if (x < -700.0) {
+    return 0;
+  }
+  x = f64_min(x, 700.0);
+  // e^x = 2^n * e^r with r in [0, ln(2))
+  const f64 t = x * 1.4426950408889634; // log2(e)
+  i64 n = (i64)t;
+  n -= (f64)n > t;
+  const f64 r = (t - (f64)n) * F64_LN2;
+  f64 term = 1.0;
+  f64 sum = 1.0;
+  for (usize i = 1; i < 16; i++) {
+    term *= r / (f64)i;
+    sum += term;
+  }
+  const u64 bits = (u64)(n + 1023) << 52;
+  f64 scale;
+  memcpy(&scale, &bits, sizeof(scale));
+  return sum * scale;
+}
+
+f64 f64_ln(f64 x) {
+  if (x != x || x < 0) {
+    return F64_NAN;
+  }
+  if (x == 0) {
+    return -F64_INF;
+  }
+  if (x == F64_INF) {
+    return x;
+  }
+  i64 exponent = 0;
+  if (x < F64_MIN) {
+    // subnormal, the exponent field does not hold the exponent
+    x *= 18014398509481984.0; // 2^54
+    exponent = -54;
+  }
+  u64 bits;
+  memcpy(&bits, &x, sizeof(bits));
+  exponent += (i64)((bits >> 52) & 0x7ff) - 1023;
+  bits = (bits & 0x000fffffffffffff) | 0x3ff0000000000000;
+  f64 mantissa;
+  memcpy(&mantissa, &bits, sizeof(mantissa));
+  if (1.4142135623730951 < mantissa) {
+    mantissa /= 2;
+    exponent++;
+  }
+  // ln(m) = 2 * atanh((m - 1) / (m + 1))
+  const f64 s = (mantissa - 1) / (mantissa + 1);
+  const f64 s2 = s * s;
+  f64 term = s;
+  f64 sum = 0;
+  for (usize i = 1; i < 40; i += 2) {
+    sum += term / (f64)i;
+    term *= s2;
+  }
+  return (f64)exponent * F64_LN2 + 2 * sum;
+}
+
+f64 f64_sqrt(f64 x) {
+  if (x <= 0 || x != x) {
+    return x == 0 ? x : F64_NAN;
+  }
+  if (x == F64_INF) {
+    return x;
+  }
+  // Newton's method, starting at half the exponent. After the first step it
+  // is never below the root and only gets smaller.
+  u64 bits;
+  memcpy(&bits, &x, sizeof(bits));
+  bits = (bits >> 1) + ((u64)1023 << 51);
+  f64 y;
+  memcpy(&y, &bits, sizeof(y));
+  y = 0.5 * (y + x / y);
+  for (f64 next = 0.5 * (y + x / y); next < y; next = 0.5 * (y + x / y)) {
+    y = next;
+  }
+  return y;
+}
+
+#undef F64_LN2
+
+// #include "integer.h" // IWYU pragma: keep
+
+// #include "cebus/core/cpu.h"
 // #include "cebus/core/debug.h"
+// #include "cebus/core/platform.h"
+// #include "cebus/type/byte.h"
 
-#include <ctype.h>
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
 
-#define DBASE 10
-#define XBASE 16
+#define BITS(T) (sizeof(T) * 8)
 
-///////////////////////////////////////////////////////////////////////////////
+// splitmix64, see https://prng.di.unimi.it/splitmix64.c. Only multiplies,
+// shifts and xors, and every step can be undone, so different values never
+// collide.
+#define INTEGER_HASH_GAMMA ((u64)0x9E3779B97F4A7C15)
+#define INTEGER_HASH_MUL1 ((u64)0xBF58476D1CE4E5B9)
+#define INTEGER_HASH_MUL2 ((u64)0x94D049BB133111EB)
 
-bool c_is_alnum(char c) { return isalnum(c); }
-bool c_is_alpha(char c) { return isalpha(c); }
-bool c_is_lower(char c) { return islower(c); }
-bool c_is_upper(char c) { return isupper(c); }
-bool c_is_space(char c) { return isspace(c); }
-bool c_is_cntrl(char c) { return iscntrl(c); }
-bool c_is_print(char c) { return isprint(c); }
-bool c_is_graph(char c) { return isgraph(c); }
-bool c_is_blank(char c) { return isblank(c); }
-bool c_is_punct(char c) { return ispunct(c); }
-bool c_is_digit(char c) { return isdigit(c); }
-bool c_is_xdigit(char c) { return isxdigit(c); }
+static inline u64 integer_hash_mix(u64 hash) {
+  hash = (hash ^ (hash >> 30)) * INTEGER_HASH_MUL1;
+  hash = (hash ^ (hash >> 27)) * INTEGER_HASH_MUL2;
+  return hash ^ (hash >> 31);
+}
 
-///////////////////////////////////////////////////////////////////////////////
+// 'key' is the mixed seed. Mixing '0' gives '0', so seed '0' is the unseeded
+// hash.
+static inline u64 integer_hash_seeded(u64 value, u64 key) {
+  return integer_hash_mix((value ^ key) + INTEGER_HASH_GAMMA);
+}
 
-char c_to_lower(char c) { return (char)tolower(c); }
-char c_to_upper(char c) { return (char)toupper(c); }
+#define INTEGER_IMPL(T)                                                                            \
+  /* BIT OPERATIONS */                                                                             \
+  T T##_reverse_bits(T value) {                                                                    \
+    T reversed = 0;                                                                                \
+    for (usize i = 0; i < BITS(T); i++) {                                                          \
+      reversed = (T)(reversed << 1);                                                               \
+      if (value & 1) {                                                                             \
+        reversed = reversed | 1;                                                                   \
+      }                                                                                            \
+      value = value >> 1;                                                                          \
+    }                                                                                              \
+    return reversed;                                                                               \
+  }                                                                                                \
+                                                                                                   \
+  usize T##_leading_ones(T value) {                                                                \
+    usize count = 0;                                                                               \
+    for (usize i = 0; i < BITS(T); i++) {                                                          \
+      if (!(value >> (BITS(T) - i - 1) & (T)0x1)) {                                                \
+        break;                                                                                     \
+      }                                                                                            \
+      count++;                                                                                     \
+    }                                                                                              \
+    return count;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  usize T##_trailing_ones(T value) {                                                               \
+    usize count = 0;                                                                               \
+    for (usize i = 0; i < BITS(T); i++) {                                                          \
+      if (!(value >> i & (T)0x1)) {                                                                \
+        break;                                                                                     \
+      }                                                                                            \
+      count++;                                                                                     \
+    }                                                                                              \
+    return count;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  usize T##_leading_zeros(T value) {                                                               \
+    usize count = 0;                                                                               \
+    for (usize i = 0; i < BITS(T); i++) {                                                          \
+      if (value >> (BITS(T) - i - 1) & (T)0x1) {                                                   \
+        break;                                                                                     \
+      }                                                                                            \
+      count++;                                                                                     \
+    }                                                                                              \
+    return count;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  usize T##_trailing_zeros(T value) {                                                              \
+    usize count = 0;                                                                               \
+    for (usize i = 0; i < BITS(T); i++) {                                                          \
+      if (value >> i & (T)0x1) {                                                                   \
+        break;                                                                                     \
+      }                                                                                            \
+      count++;                                                                                     \
+    }                                                                                              \
+    return count;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  usize T##_count_zeros(T value) {                                                                 \
+    usize count = 0;                                                                               \
+    for (usize i = 0; i < BITS(T); i++) {                                                          \
+      if (!(value >> i & (T)0x1)) {                                                                \
+        count++;                                                                                   \
+      }                                                                                            \
+    }                                                                                              \
+    return count;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  usize T##_count_ones(T value) {                                                                  \
+    usize count = 0;                                                                               \
+    for (usize i = 0; i < BITS(T); i++) {                                                          \
+      if (value >> i & (T)0x1) {                                                                   \
+        count++;                                                                                   \
+      }                                                                                            \
+    }                                                                                              \
+    return count;                                                                                  \
+  }                                                                                                \
+  /* BIT OPERATIONS END */                                                                         \
+                                                                                                   \
+  /* BYTE ORDER OPERATIONS */                                                                      \
+  T T##_swap_bytes(T value) {                                                                      \
+    if (1 < sizeof(T)) {                                                                           \
+      u8 *bytes = (u8 *)&value;                                                                    \
+      for (usize i = 0; i < (sizeof(T) + 1) / 2; i++) {                                            \
+        u8 temp = bytes[i];                                                                        \
+        bytes[i] = bytes[sizeof(T) - i - 1];                                                       \
+        bytes[sizeof(T) - i - 1] = temp;                                                           \
+      }                                                                                            \
+    }                                                                                              \
+    return value;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  /*  BIG ENDIAN OPERATIONS */                                                                     \
+  T T##_to_be(T value) {                                                                           \
+    if (CEBUS_BYTE_ORDER == ENDIAN_LITTLE) {                                                       \
+      return T##_swap_bytes(value);                                                                \
+    }                                                                                              \
+    return value;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  T T##_from_be(T value) {                                                                         \
+    if (CEBUS_BYTE_ORDER == ENDIAN_LITTLE) {                                                       \
+      return T##_swap_bytes(value);                                                                \
+    }                                                                                              \
+    return value;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  T T##_from_be_bytes(Bytes bytes) {                                                               \
+    cebus_assert(sizeof(T) == bytes.size, "expected %" USIZE_FMT " bytes but got %" USIZE_FMT,     \
+                 sizeof(T), bytes.size);                                                           \
+    if (CEBUS_BYTE_ORDER == ENDIAN_LITTLE) {                                                       \
+      return T##_swap_bytes(*(const T *)bytes.data);                                               \
+    }                                                                                              \
+    return *(const T *)bytes.data;                                                                 \
+  }                                                                                                \
+                                                                                                   \
+  Bytes T##_to_be_bytes(T value, Arena *arena) {                                                   \
+    u8 *buffer = arena_alloc(arena, sizeof(value));                                                \
+    u8 *bytes = (u8 *)&value;                                                                      \
+    for (usize i = 0; i < sizeof(value); i++) {                                                    \
+      if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                        \
+        buffer[i] = bytes[i];                                                                      \
+      } else {                                                                                     \
+        buffer[sizeof(value) - i - 1] = bytes[i];                                                  \
+      }                                                                                            \
+    }                                                                                              \
+    return bytes_from_parts(sizeof(value), buffer);                                                \
+  }                                                                                                \
+                                                                                                   \
+  /*  LITTLE ENDIAN OPERATIONS */                                                                  \
+  T T##_to_le(T value) {                                                                           \
+    if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                          \
+      return T##_swap_bytes(value);                                                                \
+    }                                                                                              \
+    return value;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  T T##_from_le(T value) {                                                                         \
+    if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                          \
+      return T##_swap_bytes(value);                                                                \
+    }                                                                                              \
+    return value;                                                                                  \
+  }                                                                                                \
+                                                                                                   \
+  T T##_from_le_bytes(Bytes bytes) {                                                               \
+    cebus_assert(sizeof(T) == bytes.size, "expected %" USIZE_FMT " bytes but got %" USIZE_FMT,     \
+                 sizeof(T), bytes.size);                                                           \
+    if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                          \
+      return T##_swap_bytes(*(const T *)bytes.data);                                               \
+    }                                                                                              \
+    return *(const T *)bytes.data;                                                                 \
+  }                                                                                                \
+                                                                                                   \
+  Bytes T##_to_le_bytes(T value, Arena *arena) {                                                   \
+    u8 *buffer = arena_alloc(arena, sizeof(value));                                                \
+    u8 *bytes = (u8 *)&value;                                                                      \
+    for (usize i = 0; i < sizeof(value); i++) {                                                    \
+      if (CEBUS_BYTE_ORDER == ENDIAN_LITTLE) {                                                     \
+        buffer[i] = bytes[i];                                                                      \
+      } else {                                                                                     \
+        buffer[sizeof(value) - i - 1] = bytes[i];                                                  \
+      }                                                                                            \
+    }                                                                                              \
+    return bytes_from_parts(sizeof(value), buffer);                                                \
+  }                                                                                                \
+                                                                                                   \
+  /*  NATIVE ENDIAN OPERATIONS */                                                                  \
+  T T##_from_ne_bytes(Bytes bytes) {                                                               \
+    cebus_assert(sizeof(T) == bytes.size, "expected %" USIZE_FMT " bytes but got %" USIZE_FMT,     \
+                 sizeof(T), bytes.size);                                                           \
+    return *(const T *)bytes.data;                                                                 \
+  }                                                                                                \
+                                                                                                   \
+  Bytes T##_to_ne_bytes(T value, Arena *arena) {                                                   \
+    if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                          \
+      return T##_to_be_bytes(value, arena);                                                        \
+    }                                                                                              \
+    return T##_to_le_bytes(value, arena);                                                          \
+  }                                                                                                \
+  /* BYTE ORDER OPERATIONS END */                                                                  \
+                                                                                                   \
+  /* MATH OPERATIONS */                                                                            \
+  T T##_max(T a, T b) { return a < b ? b : a; }                                                    \
+  T T##_min(T a, T b) { return a > b ? b : a; }                                                    \
+  T T##_clamp(T min, T max, T value) { return value < min ? min : max < value ? max : value; }     \
+  /* MATH OPERATIONS END */                                                                        \
+                                                                                                   \
+  /* UTILS */                                                                                      \
+  u64 T##_hash(T value) { return integer_hash_mix((u64)value + INTEGER_HASH_GAMMA); }              \
+  u64 T##_hash_seed(T value, u64 seed) {                                                           \
+    return integer_hash_seeded((u64)value, integer_hash_mix(seed));                                \
+  }                                                                                                \
+                                                                                                   \
+  void T##_swap(T *v1, T *v2) {                                                                    \
+    T temp = *v1;                                                                                  \
+    *v1 = *v2;                                                                                     \
+    *v2 = temp;                                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  CmpOrdering T##_compare_lt(T a, T b) {                                                           \
+    return a == b ? CMP_EQUAL : a < b ? CMP_LESS : CMP_GREATER;                                    \
+  }                                                                                                \
+                                                                                                   \
+  CmpOrdering T##_compare_gt(T a, T b) {                                                           \
+    return a == b ? CMP_EQUAL : a > b ? CMP_LESS : CMP_GREATER;                                    \
+  }                                                                                                \
+                                                                                                   \
+  static CmpOrdering _##T##_cmp_gt(const void *a, const void *b) {                                 \
+    return T##_compare_gt(*(const T *)a, *(const T *)b);                                           \
+  }                                                                                                \
+                                                                                                   \
+  static CmpOrdering _##T##_cmp_lt(const void *a, const void *b) {                                 \
+    return T##_compare_lt(*(const T *)a, *(const T *)b);                                           \
+  }                                                                                                \
+                                                                                                   \
+  CompareFn T##_compare_qsort(CmpOrdering ordering) {                                              \
+    return ordering == CMP_LESS ? _##T##_cmp_lt : _##T##_cmp_gt;                                   \
+  } /* UTILS END */
+
+INTEGER_IMPL(u8)
+INTEGER_IMPL(i8)
+INTEGER_IMPL(u16)
+INTEGER_IMPL(i16)
+INTEGER_IMPL(u32)
+INTEGER_IMPL(i32)
+INTEGER_IMPL(u64)
+INTEGER_IMPL(i64)
+INTEGER_IMPL(usize)
 
-u8 c_to_u8(char c) {
-  cebus_assert_debug(c_is_digit(c), "not convertible: '%c'", c);
-  return (u8)c - '0';
-}
+//////////////////////////////////////////////////////////////////////////////
 
-u8 c_hex_to_u8(char c) {
-  cebus_assert_debug(c_is_xdigit(c), "not convertible: '%c'", c);
-  if ('0' <= c && c <= '9') {
-    return c_to_u8(c);
-  }
-  if ('a' <= c && c <= 'f') {
-    return DBASE + (u8)c - 'a';
+#if defined(CEBUS_SIMD_X86)
+
+// AVX2 has no 64 bit multiplication, so it is put together from three 32 bit
+// ones. The high half of the constant is known up front.
+CEBUS_TARGET_AVX2 static inline __m256i integer_hash_mul_avx2(__m256i a, __m256i b,
+                                                              __m256i b_high) {
+  const __m256i low = _mm256_mul_epu32(a, b);
+  const __m256i cross =
+      _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, b_high));
+  return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+CEBUS_TARGET_AVX2 static void u64_hash_batch_avx2(usize count, const u64 *values, u64 *hashes,
+                                                  u64 key) {
+  const __m256i add = _mm256_set1_epi64x((i64)INTEGER_HASH_GAMMA);
+  const __m256i key_lanes = _mm256_set1_epi64x((i64)key);
+  const __m256i mul1 = _mm256_set1_epi64x((i64)INTEGER_HASH_MUL1);
+  const __m256i mul1_high = _mm256_srli_epi64(mul1, 32);
+  const __m256i mul2 = _mm256_set1_epi64x((i64)INTEGER_HASH_MUL2);
+  const __m256i mul2_high = _mm256_srli_epi64(mul2, 32);
+  usize i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i h = _mm256_loadu_si256((const __m256i *)&values[i]);
+    h = _mm256_add_epi64(_mm256_xor_si256(h, key_lanes), add);
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 30));
+    h = integer_hash_mul_avx2(h, mul1, mul1_high);
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 27));
+    h = integer_hash_mul_avx2(h, mul2, mul2_high);
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 31));
+    _mm256_storeu_si256((__m256i *)&hashes[i], h);
   }
-  if ('A' <= c && c <= 'F') {
-    return DBASE + (u8)c - 'A';
+  for (; i < count; i++) {
+    hashes[i] = integer_hash_seeded(values[i], key);
   }
-  return 0;
 }
 
-char c_u8_to_c(u8 d) {
-  cebus_assert_debug(d < DBASE, "not convertible: '%d'", d);
-  return '0' + (i8)d;
-}
+#endif
 
-char c_u8_to_hex(u8 d) {
-  cebus_assert_debug(d < XBASE, "not convertible: '%d'", d);
-  if (d < DBASE) {
-    return c_u8_to_c(d);
+void u64_hash_batch(usize count, const u64 *values, u64 *hashes, u64 seed) {
+  const u64 key = integer_hash_mix(seed);
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    u64_hash_batch_avx2(count, values, hashes, key);
+    return;
   }
-  if (d < XBASE) {
-    return 'a' + ((i8)d - DBASE);
+#endif
+  for (usize i = 0; i < count; i++) {
+    hashes[i] = integer_hash_seeded(values[i], key);
   }
-  return 0;
 }
 
-char c_u8_to_HEX(u8 d) {
-  cebus_assert_debug(d < XBASE, "not convertible: '%d'", d);
-  if (d < DBASE) {
-    return c_u8_to_c(d);
-  }
-  if (d < XBASE) {
-    return 'A' + ((i8)d - DBASE);
-  }
-  return 0;
+u64 u64_mix(u64 hash) {
+  hash ^= hash >> 33;
+  hash *= (u64)0xff51afd7ed558ccd;
+  hash ^= hash >> 33;
+  hash *= (u64)0xc4ceb9fe1a85ec53;
+  hash ^= hash >> 33;
+  return hash;
 }
 
-///////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////
 
-// #include "float.h" // IWYU pragma: keep
+#undef INTEGER_IMPL
+#undef BITS
+#undef INTEGER_HASH_GAMMA
+#undef INTEGER_HASH_MUL1
+#undef INTEGER_HASH_MUL2
 
-#define FLOAT_IMPL(T, BITS)                                                                        \
-  bool T##_eq(T a, T b) { return T##_abs(a - b) < F##BITS##_EPSILON; }                             \
-  bool T##_eq_eps(T a, T b, T epsilon) { return T##_abs(a - b) < epsilon; }                        \
-  bool T##_isnan(T value) { return value != value; }                                               \
-  T T##_abs(T value) {                                                                             \
-    u##BITS *i = (u##BITS *)&value;                                                                \
-    *i &= ~((u##BITS)0x8 << (BITS - 1 - 3));                                                       \
-    return value;                                                                                  \
-  }                                                                                                \
-  T T##_min(T a, T b) { return a < b ? a : b; }                                                    \
-  T T##_max(T a, T b) { return a > b ? a : b; }                                                    \
-  T T##_clamp(T min, T max, T value) { return value < min ? min : value > max ? max : value; }     \
-  T T##_lerp(T min, T max, T value) { return min + value * (max - min); }                          \
-  T T##_rad(T deg) { return deg * ((T)F64_PI / 180.0f); }                                          \
-  T T##_deg(T rad) { return rad * ((T)F64_PI / 180.0f); }
+// #include "numeric.h"
 
-FLOAT_IMPL(f32, 32)
-FLOAT_IMPL(f64, 64)
+// #include "cebus/core/cpu.h"
+// #include "cebus/core/platform.h"
 
-#undef FLOAT_IMPL
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
 
-// #include "integer.h" // IWYU pragma: keep
+//////////////////////////////////////////////////////////////////////////////
 
-// #include "cebus/core/debug.h"
-// #include "cebus/core/platform.h"
-// #include "cebus/type/byte.h"
+// Histograms with at most this many bins are counted into four separate
+// histograms, so two values in the same bin do not have to wait for each other.
+#define NUMERIC_HISTOGRAM_LOCAL 256
 
-#define BITS(T) (sizeof(T) * 8)
+//////////////////////////////////////////////////////////////////////////////
 
-#define INTEGER_IMPL(T)                                                                            \
-  /* BIT OPERATIONS */                                                                             \
-  T T##_reverse_bits(T value) {                                                                    \
-    T reversed = 0;                                                                                \
-    for (usize i = 0; i < BITS(T); i++) {                                                          \
-      reversed = (T)(reversed << 1);                                                               \
-      if (value & 1) {                                                                             \
-        reversed = reversed | 1;                                                                   \
-      }                                                                                            \
-      value = value >> 1;                                                                          \
+// Four independent accumulators, so the additions do not wait for each other.
+// 'U' is the type used for the arithmetic, unsigned for signed integers so
+// they wrap around instead of overflowing.
+#define NUMERIC_SCALAR(T, U)                                                                       \
+  UNUSED static T T##_sum_scalar(usize count, const T *values) {                                   \
+    U sums[4] = {0};                                                                               \
+    usize i = 0;                                                                                   \
+    for (; i + 4 <= count; i += 4) {                                                               \
+      sums[0] += (U)values[i];                                                                     \
+      sums[1] += (U)values[i + 1];                                                                 \
+      sums[2] += (U)values[i + 2];                                                                 \
+      sums[3] += (U)values[i + 3];                                                                 \
     }                                                                                              \
-    return reversed;                                                                               \
-  }                                                                                                \
-                                                                                                   \
-  usize T##_leading_ones(T value) {                                                                \
-    usize count = 0;                                                                               \
-    for (usize i = 0; i < BITS(T); i++) {                                                          \
-      if (!(value >> (BITS(T) - i - 1) & (T)0x1)) {                                                \
-        break;                                                                                     \
-      }                                                                                            \
-      count++;                                                                                     \
+    for (; i < count; i++) {                                                                       \
+      sums[0] += (U)values[i];                                                                     \
     }                                                                                              \
-    return count;                                                                                  \
+    return (T)((sums[0] + sums[1]) + (sums[2] + sums[3]));                                         \
   }                                                                                                \
                                                                                                    \
-  usize T##_trailing_ones(T value) {                                                               \
-    usize count = 0;                                                                               \
-    for (usize i = 0; i < BITS(T); i++) {                                                          \
-      if (!(value >> i & (T)0x1)) {                                                                \
-        break;                                                                                     \
-      }                                                                                            \
-      count++;                                                                                     \
+  static T T##_dot_scalar(usize count, const T *a, const T *b) {                                   \
+    U sums[4] = {0};                                                                               \
+    usize i = 0;                                                                                   \
+    for (; i + 4 <= count; i += 4) {                                                               \
+      sums[0] += (U)a[i] * (U)b[i];                                                                \
+      sums[1] += (U)a[i + 1] * (U)b[i + 1];                                                        \
+      sums[2] += (U)a[i + 2] * (U)b[i + 2];                                                        \
+      sums[3] += (U)a[i + 3] * (U)b[i + 3];                                                        \
     }                                                                                              \
-    return count;                                                                                  \
-  }                                                                                                \
-                                                                                                   \
-  usize T##_leading_zeros(T value) {                                                               \
-    usize count = 0;                                                                               \
-    for (usize i = 0; i < BITS(T); i++) {                                                          \
-      if (value >> (BITS(T) - i - 1) & (T)0x1) {                                                   \
-        break;                                                                                     \
-      }                                                                                            \
-      count++;                                                                                     \
+    for (; i < count; i++) {                                                                       \
+      sums[0] += (U)a[i] * (U)b[i];                                                                \
     }                                                                                              \
-    return count;                                                                                  \
+    return (T)((sums[0] + sums[1]) + (sums[2] + sums[3]));                                         \
   }                                                                                                \
                                                                                                    \
-  usize T##_trailing_zeros(T value) {                                                              \
-    usize count = 0;                                                                               \
-    for (usize i = 0; i < BITS(T); i++) {                                                          \
-      if (value >> i & (T)0x1) {                                                                   \
-        break;                                                                                     \
-      }                                                                                            \
-      count++;                                                                                     \
+  static void T##_prefix_sum_scalar(usize count, const T *values, T *out, U sum) {                 \
+    for (usize i = 0; i < count; i++) {                                                            \
+      sum += (U)values[i];                                                                         \
+      out[i] = (T)sum;                                                                             \
     }                                                                                              \
-    return count;                                                                                  \
   }                                                                                                \
                                                                                                    \
-  usize T##_count_zeros(T value) {                                                                 \
-    usize count = 0;                                                                               \
-    for (usize i = 0; i < BITS(T); i++) {                                                          \
-      if (!(value >> i & (T)0x1)) {                                                                \
-        count++;                                                                                   \
-      }                                                                                            \
+  static void T##_minmax_scalar(usize count, const T *values, T *min, T *max) {                    \
+    T lo = *min;                                                                                   \
+    T hi = *max;                                                                                   \
+    for (usize i = 0; i < count; i++) {                                                            \
+      lo = values[i] < lo ? values[i] : lo;                                                        \
+      hi = hi < values[i] ? values[i] : hi;                                                        \
     }                                                                                              \
-    return count;                                                                                  \
-  }                                                                                                \
-                                                                                                   \
-  usize T##_count_ones(T value) {                                                                  \
-    usize count = 0;                                                                               \
-    for (usize i = 0; i < BITS(T); i++) {                                                          \
-      if (value >> i & (T)0x1) {                                                                   \
-        count++;                                                                                   \
-      }                                                                                            \
+    *min = lo;                                                                                     \
+    *max = hi;                                                                                     \
+  }
+
+NUMERIC_SCALAR(f32, f32)
+NUMERIC_SCALAR(f64, f64)
+NUMERIC_SCALAR(i64, u64)
+NUMERIC_SCALAR(u64, u64)
+
+//////////////////////////////////////////////////////////////////////////////
+
+#if defined(CEBUS_SIMD_X86)
+
+// 'W' lanes per vector, 'MM' is the intrinsic prefix and 'S' the suffix.
+#define NUMERIC_FLOAT_KERNELS(T, NAME, TARGET, V, W, MM, S)                                        \
+  TARGET static T T##_sum_##NAME(usize count, const T *values) {                                   \
+    V s0 = MM##_setzero_##S();                                                                     \
+    V s1 = s0, s2 = s0, s3 = s0;                                                                   \
+    usize i = 0;                                                                                   \
+    for (; i + 4 * (W) <= count; i += 4 * (W)) {                                                   \
+      s0 = MM##_add_##S(s0, MM##_loadu_##S(&values[i]));                                           \
+      s1 = MM##_add_##S(s1, MM##_loadu_##S(&values[i + (W)]));                                     \
+      s2 = MM##_add_##S(s2, MM##_loadu_##S(&values[i + 2 * (W)]));                                 \
+      s3 = MM##_add_##S(s3, MM##_loadu_##S(&values[i + 3 * (W)]));                                 \
     }                                                                                              \
-    return count;                                                                                  \
-  }                                                                                                \
-  /* BIT OPERATIONS END */                                                                         \
-                                                                                                   \
-  /* BYTE ORDER OPERATIONS */                                                                      \
-  T T##_swap_bytes(T value) {                                                                      \
-    if (1 < sizeof(T)) {                                                                           \
-      u8 *bytes = (u8 *)&value;                                                                    \
-      for (usize i = 0; i < (sizeof(T) + 1) / 2; i++) {                                            \
-        u8 temp = bytes[i];                                                                        \
-        bytes[i] = bytes[sizeof(T) - i - 1];                                                       \
-        bytes[sizeof(T) - i - 1] = temp;                                                           \
-      }                                                                                            \
+    for (; i + (W) <= count; i += (W)) {                                                           \
+      s0 = MM##_add_##S(s0, MM##_loadu_##S(&values[i]));                                           \
     }                                                                                              \
-    return value;                                                                                  \
+    s0 = MM##_add_##S(MM##_add_##S(s0, s1), MM##_add_##S(s2, s3));                                 \
+    T lanes[W];                                                                                    \
+    MM##_storeu_##S(lanes, s0);                                                                    \
+    T sum = 0;                                                                                     \
+    for (usize l = 0; l < (W); l++) {                                                              \
+      sum += lanes[l];                                                                             \
+    }                                                                                              \
+    return sum + T##_sum_scalar(count - i, &values[i]);                                            \
   }                                                                                                \
                                                                                                    \
-  /*  BIG ENDIAN OPERATIONS */                                                                     \
-  T T##_to_be(T value) {                                                                           \
-    if (CEBUS_BYTE_ORDER == ENDIAN_LITTLE) {                                                       \
-      return T##_swap_bytes(value);                                                                \
+  TARGET static T T##_dot_##NAME(usize count, const T *a, const T *b) {                            \
+    V s0 = MM##_setzero_##S();                                                                     \
+    V s1 = s0, s2 = s0, s3 = s0;                                                                   \
+    usize i = 0;                                                                                   \
+    for (; i + 4 * (W) <= count; i += 4 * (W)) {                                                   \
+      s0 = MM##_add_##S(s0, MM##_mul_##S(MM##_loadu_##S(&a[i]), MM##_loadu_##S(&b[i])));           \
+      s1 = MM##_add_##S(s1, MM##_mul_##S(MM##_loadu_##S(&a[i + (W)]),                              \
+                                         MM##_loadu_##S(&b[i + (W)])));                            \
+      s2 = MM##_add_##S(s2, MM##_mul_##S(MM##_loadu_##S(&a[i + 2 * (W)]),                          \
+                                         MM##_loadu_##S(&b[i + 2 * (W)])));                        \
+      s3 = MM##_add_##S(s3, MM##_mul_##S(MM##_loadu_##S(&a[i + 3 * (W)]),                          \
+                                         MM##_loadu_##S(&b[i + 3 * (W)])));                        \
     }                                                                                              \
-    return value;                                                                                  \
+    for (; i + (W) <= count; i += (W)) {                                                           \
+      s0 = MM##_add_##S(s0, MM##_mul_##S(MM##_loadu_##S(&a[i]), MM##_loadu_##S(&b[i])));           \
+    }                                                                                              \
+    s0 = MM##_add_##S(MM##_add_##S(s0, s1), MM##_add_##S(s2, s3));                                 \
+    T lanes[W];                                                                                    \
+    MM##_storeu_##S(lanes, s0);                                                                    \
+    T sum = 0;                                                                                     \
+    for (usize l = 0; l < (W); l++) {                                                              \
+      sum += lanes[l];                                                                             \
+    }                                                                                              \
+    return sum + T##_dot_scalar(count - i, &a[i], &b[i]);                                          \
   }                                                                                                \
                                                                                                    \
-  T T##_from_be(T value) {                                                                         \
-    if (CEBUS_BYTE_ORDER == ENDIAN_LITTLE) {                                                       \
-      return T##_swap_bytes(value);                                                                \
+  TARGET static void T##_minmax_##NAME(usize count, const T *values, T *min, T *max) {             \
+    V lo = MM##_set1_##S(*min);                                                                    \
+    V hi = MM##_set1_##S(*max);                                                                    \
+    usize i = 0;                                                                                   \
+    for (; i + 2 * (W) <= count; i += 2 * (W)) {                                                   \
+      const V x = MM##_loadu_##S(&values[i]);                                                      \
+      const V y = MM##_loadu_##S(&values[i + (W)]);                                                \
+      lo = MM##_min_##S(lo, MM##_min_##S(x, y));                                                   \
+      hi = MM##_max_##S(hi, MM##_max_##S(x, y));                                                   \
+    }                                                                                              \
+    T lo_lanes[W];                                                                                 \
+    T hi_lanes[W];                                                                                 \
+    MM##_storeu_##S(lo_lanes, lo);                                                                 \
+    MM##_storeu_##S(hi_lanes, hi);                                                                 \
+    T##_minmax_scalar(W, lo_lanes, min, max);                                                      \
+    T##_minmax_scalar(W, hi_lanes, min, max);                                                      \
+    T##_minmax_scalar(count - i, &values[i], min, max);                                            \
+  }
+
+NUMERIC_FLOAT_KERNELS(f32, sse2, , __m128, 4, _mm, ps)
+NUMERIC_FLOAT_KERNELS(f64, sse2, , __m128d, 2, _mm, pd)
+NUMERIC_FLOAT_KERNELS(f32, avx2, CEBUS_TARGET_AVX2, __m256, 8, _mm256, ps)
+NUMERIC_FLOAT_KERNELS(f64, avx2, CEBUS_TARGET_AVX2, __m256d, 4, _mm256, pd)
+
+// Scans four lanes with two shifted additions, then adds the carry of the
+// previous block.
+CEBUS_TARGET_AVX2 static void f64_prefix_sum_avx2(usize count, const f64 *values, f64 *out) {
+  const __m256d zero = _mm256_setzero_pd();
+  __m256d carry = zero;
+  usize i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d x = _mm256_loadu_pd(&values[i]);
+    x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x90), zero, 0x1));
+    x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x40), zero, 0x3));
+    x = _mm256_add_pd(x, carry);
+    _mm256_storeu_pd(&out[i], x);
+    carry = _mm256_permute4x64_pd(x, 0xff);
+  }
+  f64 sum;
+  _mm_store_sd(&sum, _mm256_castpd256_pd128(carry));
+  f64_prefix_sum_scalar(count - i, &values[i], &out[i], sum);
+}
+
+// Scans both 128 bit lanes with byte shifts, then adds the total of the low
+// lane to the high lane and the carry of the previous block.
+CEBUS_TARGET_AVX2 static void f32_prefix_sum_avx2(usize count, const f32 *values, f32 *out) {
+  __m256 carry = _mm256_setzero_ps();
+  usize i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_loadu_ps(&values[i]);
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+    const __m256 last = _mm256_permute_ps(x, 0xff);
+    x = _mm256_add_ps(x, _mm256_permute2f128_ps(last, last, 0x08));
+    x = _mm256_add_ps(x, carry);
+    _mm256_storeu_ps(&out[i], x);
+    const __m256 total = _mm256_permute_ps(x, 0xff);
+    carry = _mm256_permute2f128_ps(total, total, 0x11);
+  }
+  f32 sum;
+  _mm_store_ss(&sum, _mm256_castps256_ps128(carry));
+  f32_prefix_sum_scalar(count - i, &values[i], &out[i], sum);
+}
+
+CEBUS_TARGET_AVX2 static u64 u64_sum_avx2(usize count, const u64 *values) {
+  __m256i s0 = _mm256_setzero_si256();
+  __m256i s1 = s0, s2 = s0, s3 = s0;
+  usize i = 0;
+  for (; i + 16 <= count; i += 16) {
+    s0 = _mm256_add_epi64(s0, _mm256_loadu_si256((const __m256i *)&values[i]));
+    s1 = _mm256_add_epi64(s1, _mm256_loadu_si256((const __m256i *)&values[i + 4]));
+    s2 = _mm256_add_epi64(s2, _mm256_loadu_si256((const __m256i *)&values[i + 8]));
+    s3 = _mm256_add_epi64(s3, _mm256_loadu_si256((const __m256i *)&values[i + 12]));
+  }
+  s0 = _mm256_add_epi64(_mm256_add_epi64(s0, s1), _mm256_add_epi64(s2, s3));
+  u64 lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, s0);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + u64_sum_scalar(count - i, &values[i]);
+}
+
+// AVX2 only compares signed 64 bit integers. Flipping the sign bit of both
+// sides gives the unsigned order.
+CEBUS_TARGET_AVX2 static void i64_minmax_avx2(usize count, const i64 *values, i64 *min, i64 *max,
+                                             bool is_unsigned) {
+  const __m256i flip = _mm256_set1_epi64x(is_unsigned ? I64_MIN : 0);
+  __m256i lo = _mm256_xor_si256(_mm256_set1_epi64x(*min), flip);
+  __m256i hi = _mm256_xor_si256(_mm256_set1_epi64x(*max), flip);
+  usize i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&values[i]), flip);
+    lo = _mm256_blendv_epi8(lo, x, _mm256_cmpgt_epi64(lo, x));
+    hi = _mm256_blendv_epi8(hi, x, _mm256_cmpgt_epi64(x, hi));
+  }
+  i64 lo_lanes[4];
+  i64 hi_lanes[4];
+  _mm256_storeu_si256((__m256i *)lo_lanes, _mm256_xor_si256(lo, flip));
+  _mm256_storeu_si256((__m256i *)hi_lanes, _mm256_xor_si256(hi, flip));
+  if (is_unsigned) {
+    u64_minmax_scalar(4, (const u64 *)lo_lanes, (u64 *)min, (u64 *)max);
+    u64_minmax_scalar(4, (const u64 *)hi_lanes, (u64 *)min, (u64 *)max);
+    u64_minmax_scalar(count - i, (const u64 *)&values[i], (u64 *)min, (u64 *)max);
+  } else {
+    i64_minmax_scalar(4, lo_lanes, min, max);
+    i64_minmax_scalar(4, hi_lanes, min, max);
+    i64_minmax_scalar(count - i, &values[i], min, max);
+  }
+}
+
+#undef NUMERIC_FLOAT_KERNELS
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+f32 f32_sum(usize count, const f32 *values) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return f32_sum_avx2(count, values);
+  }
+  if (cpu_has_sse2()) {
+    return f32_sum_sse2(count, values);
+  }
+#endif
+  return f32_sum_scalar(count, values);
+}
+
+f64 f64_sum(usize count, const f64 *values) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return f64_sum_avx2(count, values);
+  }
+  if (cpu_has_sse2()) {
+    return f64_sum_sse2(count, values);
+  }
+#endif
+  return f64_sum_scalar(count, values);
+}
+
+i64 i64_sum(usize count, const i64 *values) {
+  // the same bits as the wrapping unsigned sum
+  return (i64)u64_sum(count, (const u64 *)values);
+}
+
+u64 u64_sum(usize count, const u64 *values) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return u64_sum_avx2(count, values);
+  }
+#endif
+  return u64_sum_scalar(count, values);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool f32_minmax(usize count, const f32 *values, f32 *min, f32 *max) {
+  if (count == 0) {
+    return false;
+  }
+  *min = *max = values[0];
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    f32_minmax_avx2(count, values, min, max);
+    return true;
+  }
+  if (cpu_has_sse2()) {
+    f32_minmax_sse2(count, values, min, max);
+    return true;
+  }
+#endif
+  f32_minmax_scalar(count, values, min, max);
+  return true;
+}
+
+bool f64_minmax(usize count, const f64 *values, f64 *min, f64 *max) {
+  if (count == 0) {
+    return false;
+  }
+  *min = *max = values[0];
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    f64_minmax_avx2(count, values, min, max);
+    return true;
+  }
+  if (cpu_has_sse2()) {
+    f64_minmax_sse2(count, values, min, max);
+    return true;
+  }
+#endif
+  f64_minmax_scalar(count, values, min, max);
+  return true;
+}
+
+bool i64_minmax(usize count, const i64 *values, i64 *min, i64 *max) {
+  if (count == 0) {
+    return false;
+  }
+  *min = *max = values[0];
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    i64_minmax_avx2(count, values, min, max, false);
+    return true;
+  }
+#endif
+  i64_minmax_scalar(count, values, min, max);
+  return true;
+}
+
+bool u64_minmax(usize count, const u64 *values, u64 *min, u64 *max) {
+  if (count == 0) {
+    return false;
+  }
+  *min = *max = values[0];
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    i64_minmax_avx2(count, (const i64 *)values, (i64 *)min, (i64 *)max, true);
+    return true;
+  }
+#endif
+  u64_minmax_scalar(count, values, min, max);
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+f32 f32_dot(usize count, const f32 *a, const f32 *b) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return f32_dot_avx2(count, a, b);
+  }
+  if (cpu_has_sse2()) {
+    return f32_dot_sse2(count, a, b);
+  }
+#endif
+  return f32_dot_scalar(count, a, b);
+}
+
+f64 f64_dot(usize count, const f64 *a, const f64 *b) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return f64_dot_avx2(count, a, b);
+  }
+  if (cpu_has_sse2()) {
+    return f64_dot_sse2(count, a, b);
+  }
+#endif
+  return f64_dot_scalar(count, a, b);
+}
+
+// AVX2 has no 64 bit multiplication, so the integer dot products stay scalar.
+i64 i64_dot(usize count, const i64 *a, const i64 *b) { return i64_dot_scalar(count, a, b); }
+
+u64 u64_dot(usize count, const u64 *a, const u64 *b) { return u64_dot_scalar(count, a, b); }
+
+//////////////////////////////////////////////////////////////////////////////
+
+void f32_prefix_sum(usize count, const f32 *values, f32 *out) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    f32_prefix_sum_avx2(count, values, out);
+    return;
+  }
+#endif
+  f32_prefix_sum_scalar(count, values, out, 0);
+}
+
+void f64_prefix_sum(usize count, const f64 *values, f64 *out) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    f64_prefix_sum_avx2(count, values, out);
+    return;
+  }
+#endif
+  f64_prefix_sum_scalar(count, values, out, 0);
+}
+
+// Integer additions only take a cycle, so the scalar loop already keeps up
+// with the memory.
+void i64_prefix_sum(usize count, const i64 *values, i64 *out) {
+  i64_prefix_sum_scalar(count, values, out, 0);
+}
+
+void u64_prefix_sum(usize count, const u64 *values, u64 *out) {
+  u64_prefix_sum_scalar(count, values, out, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Bin 'b' of an integer histogram starts at 'ceil(b * range / bins)', so the
+// widths differ by at most one. 'width' and 'rem' are 'range / bins' and
+// 'range % bins'.
+static u64 numeric_int_bin_start(u64 bin, u64 bins, u64 width, u64 rem) {
+  return bin * width + (bin * rem + bins - 1) / bins;
+}
+
+static usize numeric_int_bin(u64 offset, u64 range, u64 bins, u64 width, u64 rem, bool wide) {
+  if (!wide) {
+    return (usize)(offset * bins / range);
+  }
+  // 'offset * bins' would overflow. Every bin is at most 'width + 1' wide, so
+  // this is never after the right bin and only a few bins before it.
+  u64 bin = offset / (width + 1);
+  while (bin + 1 < bins && numeric_int_bin_start(bin + 1, bins, width, rem) <= offset) {
+    bin++;
+  }
+  return (usize)bin;
+}
+
+#define NUMERIC_HISTOGRAM_ADD(T, l, BIN)                                                           \
+  do {                                                                                             \
+    const T value = values[i + (l)];                                                               \
+    if (min <= value && value < max) {                                                             \
+      BIN;                                                                                         \
+      local[l][bin]++;                                                                             \
     }                                                                                              \
-    return value;                                                                                  \
-  }                                                                                                \
-                                                                                                   \
-  T T##_from_be_bytes(Bytes bytes) {                                                               \
-    cebus_assert(sizeof(T) == bytes.size, "expected %" USIZE_FMT " bytes but got %" USIZE_FMT,     \
-                 sizeof(T), bytes.size);                                                           \
-    if (CEBUS_BYTE_ORDER == ENDIAN_LITTLE) {                                                       \
-      return T##_swap_bytes(*(const T *)bytes.data);                                               \
+  } while (0)
+
+// 'PREPARE' runs once, 'BIN' computes the bin of 'value' into 'bin'.
+#define NUMERIC_HISTOGRAM(T, PREPARE, BIN)                                                         \
+  void T##_histogram(usize count, const T *values, T min, T max, usize bins, usize *counts) {      \
+    if (bins == 0 || !(min < max)) {                                                               \
+      return;                                                                                      \
     }                                                                                              \
-    return *(const T *)bytes.data;                                                                 \
-  }                                                                                                \
-                                                                                                   \
-  Bytes T##_to_be_bytes(T value, Arena *arena) {                                                   \
-    u8 *buffer = arena_alloc(arena, sizeof(value));                                                \
-    u8 *bytes = (u8 *)&value;                                                                      \
-    for (usize i = 0; i < sizeof(value); i++) {                                                    \
-      if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                        \
-        buffer[i] = bytes[i];                                                                      \
-      } else {                                                                                     \
-        buffer[sizeof(value) - i - 1] = bytes[i];                                                  \
+    PREPARE;                                                                                       \
+    if (NUMERIC_HISTOGRAM_LOCAL < bins) {                                                          \
+      for (usize i = 0; i < count; i++) {                                                          \
+        const T value = values[i];                                                                 \
+        if (min <= value && value < max) {                                                         \
+          BIN;                                                                                     \
+          counts[bin]++;                                                                           \
+        }                                                                                          \
       }                                                                                            \
+      return;                                                                                      \
     }                                                                                              \
-    return bytes_from_parts(sizeof(value), buffer);                                                \
-  }                                                                                                \
-                                                                                                   \
-  /*  LITTLE ENDIAN OPERATIONS */                                                                  \
-  T T##_to_le(T value) {                                                                           \
-    if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                          \
-      return T##_swap_bytes(value);                                                                \
-    }                                                                                              \
-    return value;                                                                                  \
-  }                                                                                                \
-                                                                                                   \
-  T T##_from_le(T value) {                                                                         \
-    if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                          \
-      return T##_swap_bytes(value);                                                                \
-    }                                                                                              \
-    return value;                                                                                  \
-  }                                                                                                \
-                                                                                                   \
-  T T##_from_le_bytes(Bytes bytes) {                                                               \
-    cebus_assert(sizeof(T) == bytes.size, "expected %" USIZE_FMT " bytes but got %" USIZE_FMT,     \
-                 sizeof(T), bytes.size);                                                           \
-    if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                          \
-      return T##_swap_bytes(*(const T *)bytes.data);                                               \
+    usize local[4][NUMERIC_HISTOGRAM_LOCAL] = {0};                                                 \
+    usize i = 0;                                                                                   \
+    for (; i + 4 <= count; i += 4) {                                                               \
+      NUMERIC_HISTOGRAM_ADD(T, 0, BIN);                                                            \
+      NUMERIC_HISTOGRAM_ADD(T, 1, BIN);                                                            \
+      NUMERIC_HISTOGRAM_ADD(T, 2, BIN);                                                            \
+      NUMERIC_HISTOGRAM_ADD(T, 3, BIN);                                                            \
     }                                                                                              \
-    return *(const T *)bytes.data;                                                                 \
-  }                                                                                                \
-                                                                                                   \
-  Bytes T##_to_le_bytes(T value, Arena *arena) {                                                   \
-    u8 *buffer = arena_alloc(arena, sizeof(value));                                                \
-    u8 *bytes = (u8 *)&value;                                                                      \
-    for (usize i = 0; i < sizeof(value); i++) {                                                    \
-      if (CEBUS_BYTE_ORDER == ENDIAN_LITTLE) {                                                     \
-        buffer[i] = bytes[i];                                                                      \
-      } else {                                                                                     \
-        buffer[sizeof(value) - i - 1] = bytes[i];                                                  \
+    for (; i < count; i++) {                                                                       \
+      const T value = values[i];                                                                   \
+      if (min <= value && value < max) {                                                           \
+        BIN;                                                                                       \
+        local[0][bin]++;                                                                           \
       }                                                                                            \
     }                                                                                              \
-    return bytes_from_parts(sizeof(value), buffer);                                                \
-  }                                                                                                \
-                                                                                                   \
-  /*  NATIVE ENDIAN OPERATIONS */                                                                  \
-  T T##_from_ne_bytes(Bytes bytes) {                                                               \
-    cebus_assert(sizeof(T) == bytes.size, "expected %" USIZE_FMT " bytes but got %" USIZE_FMT,     \
-                 sizeof(T), bytes.size);                                                           \
-    return *(const T *)bytes.data;                                                                 \
-  }                                                                                                \
-                                                                                                   \
-  Bytes T##_to_ne_bytes(T value, Arena *arena) {                                                   \
-    if (CEBUS_BYTE_ORDER == ENDIAN_BIG) {                                                          \
-      return T##_to_be_bytes(value, arena);                                                        \
+    for (usize b = 0; b < bins; b++) {                                                             \
+      counts[b] += local[0][b] + local[1][b] + local[2][b] + local[3][b];                          \
     }                                                                                              \
-    return T##_to_le_bytes(value, arena);                                                          \
-  }                                                                                                \
-  /* BYTE ORDER OPERATIONS END */                                                                  \
-                                                                                                   \
-  /* MATH OPERATIONS */                                                                            \
-  T T##_max(T a, T b) { return a < b ? b : a; }                                                    \
-  T T##_min(T a, T b) { return a > b ? b : a; }                                                    \
-  T T##_clamp(T min, T max, T value) { return value < min ? min : max < value ? max : value; }     \
-  /* MATH OPERATIONS END */                                                                        \
-                                                                                                   \
-  /* UTILS */                                                                                      \
-  u64 T##_hash(T value) {                                                                          \
-    u64 hash = ((u64)value) + 1;                                                                   \
-    hash = (((hash >> 16) ^ hash) % 0x3AA387A8B1) * 0x45d9f3b;                                     \
-    hash = (((hash >> 16) ^ hash) % 0x3AA387A8B1) * 0x45d9f3b;                                     \
-    hash = (hash >> 16) ^ hash;                                                                    \
-    return hash;                                                                                   \
-  }                                                                                                \
-                                                                                                   \
-  void T##_swap(T *v1, T *v2) {                                                                    \
-    T temp = *v1;                                                                                  \
-    *v1 = *v2;                                                                                     \
-    *v2 = temp;                                                                                    \
-  }                                                                                                \
-                                                                                                   \
-  CmpOrdering T##_compare_lt(T a, T b) {                                                           \
-    return a == b ? CMP_EQUAL : a < b ? CMP_LESS : CMP_GREATER;                                    \
-  }                                                                                                \
-                                                                                                   \
-  CmpOrdering T##_compare_gt(T a, T b) {                                                           \
-    return a == b ? CMP_EQUAL : a > b ? CMP_LESS : CMP_GREATER;                                    \
-  }                                                                                                \
-                                                                                                   \
-  static CmpOrdering _##T##_cmp_gt(const void *a, const void *b) {                                 \
-    return T##_compare_gt(*(const T *)a, *(const T *)b);                                           \
-  }                                                                                                \
-                                                                                                   \
-  static CmpOrdering _##T##_cmp_lt(const void *a, const void *b) {                                 \
-    return T##_compare_lt(*(const T *)a, *(const T *)b);                                           \
-  }                                                                                                \
-                                                                                                   \
-  CompareFn T##_compare_qsort(CmpOrdering ordering) {                                              \
-    return ordering == CMP_LESS ? _##T##_cmp_lt : _##T##_cmp_gt;                                   \
-  } /* UTILS END */
+  }
 
-INTEGER_IMPL(u8)
-INTEGER_IMPL(i8)
-INTEGER_IMPL(u16)
-INTEGER_IMPL(i16)
-INTEGER_IMPL(u32)
-INTEGER_IMPL(i32)
-INTEGER_IMPL(u64)
-INTEGER_IMPL(i64)
-INTEGER_IMPL(usize)
+// Rounding can put a value just below 'max' into the bin after the last one.
+#define NUMERIC_FLOAT_PREPARE(T) const T scale = (T)bins / (max - min)
+#define NUMERIC_FLOAT_BIN                                                                          \
+  usize bin = (usize)((value - min) * scale);                                                      \
+  bin = bin < bins ? bin : bins - 1
 
-#undef INTEGER_IMPL
-#undef BITS
+#define NUMERIC_INT_PREPARE                                                                        \
+  const u64 range = (u64)max - (u64)min;                                                           \
+  const u64 width = range / bins;                                                                  \
+  const u64 rem = range % bins;                                                                    \
+  const bool wide = U64_MAX / bins < range
+#define NUMERIC_INT_BIN                                                                            \
+  const usize bin = numeric_int_bin((u64)value - (u64)min, range, bins, width, rem, wide)
+
+NUMERIC_HISTOGRAM(f32, NUMERIC_FLOAT_PREPARE(f32), NUMERIC_FLOAT_BIN)
+NUMERIC_HISTOGRAM(f64, NUMERIC_FLOAT_PREPARE(f64), NUMERIC_FLOAT_BIN)
+NUMERIC_HISTOGRAM(i64, NUMERIC_INT_PREPARE, NUMERIC_INT_BIN)
+NUMERIC_HISTOGRAM(u64, NUMERIC_INT_PREPARE, NUMERIC_INT_BIN)
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef NUMERIC_HISTOGRAM_LOCAL
+#undef NUMERIC_SCALAR
+#undef NUMERIC_HISTOGRAM
+#undef NUMERIC_HISTOGRAM_ADD
+#undef NUMERIC_FLOAT_PREPARE
+#undef NUMERIC_FLOAT_BIN
+#undef NUMERIC_INT_PREPARE
+#undef NUMERIC_INT_BIN
 
 // #include "path.h"
 // #include "cebus/type/string.h"
@@ -5050,26 +11468,310 @@ Str path_stem(Path path) {
   if (idx == STR_NOT_FOUND) {
     return name;
   }
-  return str_substring(name, 0, idx);
+  return str_substring(name, 0, idx);
+}
+
+Path path_parent(Path path) {
+  (void)str_chop_right_by_delim(&path, '/');
+  return path;
+}
+
+// #include "./string.h"
+
+// #include "cebus/collection/aho_corasick.h"
+// #include "cebus/collection/da.h"
+// #include "cebus/collection/string_builder.h"
+// #include "cebus/core/arena.h"
+// #include "cebus/core/cpu.h"
+// #include "cebus/core/platform.h"
+// #include "cebus/type/byte.h"
+// #include "cebus/type/char.h"
+// #include "cebus/type/integer.h"
+
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Without vector instructions, needles with at least this many bytes are
+// searched with Horspool, that can skip up to the length of the needle.
+#define STR_SEARCH_LONG 32
+
+#if defined(GCC) || defined(CLANG)
+#define STR_FIRST_BIT(mask) ((usize)__builtin_ctz(mask))
+#define STR_LAST_BIT(mask) ((usize)(31 - __builtin_clz(mask)))
+#define STR_FIRST_BIT64(mask) ((usize)__builtin_ctzll(mask))
+#else
+#define STR_FIRST_BIT(mask) u32_trailing_zeros(mask)
+#define STR_LAST_BIT(mask) (31 - u32_leading_zeros(mask))
+#define STR_FIRST_BIT64(mask) u64_trailing_zeros(mask)
+#endif
+
+// Finds the first byte with 'memchr' and only compares the rest there.
+static usize str_search_scalar(const char *haystack, usize len, const char *needle, usize n) {
+  if (len < n) {
+    return STR_NOT_FOUND;
+  }
+  const usize end = len - n + 1;
+  for (usize i = 0; i < end; i++) {
+    const char *hit = memchr(&haystack[i], needle[0], end - i);
+    if (hit == NULL) {
+      break;
+    }
+    i = (usize)(hit - haystack);
+    if (memcmp(&haystack[i + 1], &needle[1], n - 1) == 0) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static usize str_search_last_scalar(const char *haystack, usize len, const char *needle,
+                                    usize n) {
+  if (len < n) {
+    return STR_NOT_FOUND;
+  }
+  for (usize i = len - n + 1; 0 < i; i--) {
+    if (haystack[i - 1] == needle[0] && haystack[i + n - 2] == needle[n - 1] &&
+        memcmp(&haystack[i - 1], needle, n) == 0) {
+      return i - 1;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static void str_search_horspool_init(Str needle, usize *skip) {
+  for (usize c = 0; c < 256; c++) {
+    skip[c] = needle.len;
+  }
+  for (usize i = 0; i + 1 < needle.len; i++) {
+    skip[(u8)needle.data[i]] = needle.len - 1 - i;
+  }
+}
+
+static usize str_search_horspool(const char *haystack, usize len, Str needle, const usize *skip) {
+  const usize last = needle.len - 1;
+  const char last_byte = needle.data[last];
+  for (usize i = 0; i + last < len; i += skip[(u8)haystack[i + last]]) {
+    if (haystack[i + last] == last_byte && memcmp(&haystack[i], needle.data, last) == 0) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static bool str_eq_ignorecase_parts(const char *s1, const char *s2, usize n) {
+  for (usize i = 0; i < n; i++) {
+    if (c_to_lower(s1[i]) != c_to_lower(s2[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static usize str_search_ignorecase_scalar(const char *haystack, usize len, const char *needle,
+                                          usize n) {
+  if (len < n) {
+    return STR_NOT_FOUND;
+  }
+  const char first = c_to_lower(needle[0]);
+  for (usize i = 0; i + n <= len; i++) {
+    if (c_to_lower(haystack[i]) == first && str_eq_ignorecase_parts(&haystack[i], needle, n)) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+#if defined(CEBUS_SIMD_X86)
+
+// The two cases of an ASCII letter only differ in bit 5, so setting it in
+// every byte of the haystack makes them equal. No other byte ends up equal to
+// a lowercase letter. Bytes of the needle that are not letters are compared
+// as they are.
+static char str_fold_mask(char c) {
+  const char lower = (char)(c | 0x20);
+  return 'a' <= lower && lower <= 'z' ? 0x20 : 0;
+}
+
+// Compares the first and the last byte of the needle with 'W' positions at
+// once and only calls 'memcmp' where both match. 'n' has to be at least 2.
+#define STR_SEARCH_KERNELS(NAME, TARGET, V, W, LOAD, SET1, CMPEQ, AND, MOVEMASK)                   \
+  TARGET static usize str_search_##NAME(const char *haystack, usize len, const char *needle,       \
+                                        usize n) {                                                 \
+    const V first = SET1(needle[0]);                                                               \
+    const V last = SET1(needle[n - 1]);                                                            \
+    const usize end = len - n + 1;                                                                 \
+    usize i = 0;                                                                                   \
+    for (; i + (W) <= end; i += (W)) {                                                             \
+      const V f = CMPEQ(first, LOAD((const V *)&haystack[i]));                                     \
+      const V l = CMPEQ(last, LOAD((const V *)&haystack[i + n - 1]));                              \
+      for (u32 mask = (u32)MOVEMASK(AND(f, l)); mask; mask &= mask - 1) {                          \
+        const usize idx = i + STR_FIRST_BIT(mask);                                                 \
+        if (memcmp(&haystack[idx + 1], &needle[1], n - 2) == 0) {                                  \
+          return idx;                                                                              \
+        }                                                                                          \
+      }                                                                                            \
+    }                                                                                              \
+    const usize idx = str_search_scalar(&haystack[i], len - i, needle, n);                         \
+    return idx == STR_NOT_FOUND ? idx : i + idx;                                                   \
+  }                                                                                                \
+                                                                                                   \
+  TARGET static usize str_search_last_##NAME(const char *haystack, usize len, const char *needle,  \
+                                             usize n) {                                            \
+    const V first = SET1(needle[0]);                                                               \
+    const V last = SET1(needle[n - 1]);                                                            \
+    usize end = len - n + 1;                                                                       \
+    for (; (W) <= end; end -= (W)) {                                                               \
+      const usize i = end - (W);                                                                   \
+      const V f = CMPEQ(first, LOAD((const V *)&haystack[i]));                                     \
+      const V l = CMPEQ(last, LOAD((const V *)&haystack[i + n - 1]));                              \
+      u32 mask = (u32)MOVEMASK(AND(f, l));                                                         \
+      while (mask) {                                                                               \
+        const usize bit = STR_LAST_BIT(mask);                                                      \
+        if (memcmp(&haystack[i + bit + 1], &needle[1], n - 2) == 0) {                              \
+          return i + bit;                                                                          \
+        }                                                                                          \
+        mask ^= (u32)1 << bit;                                                                     \
+      }                                                                                            \
+    }                                                                                              \
+    return str_search_last_scalar(haystack, end + n - 1, needle, n);                               \
+  }
+
+STR_SEARCH_KERNELS(sse2, , __m128i, 16, _mm_loadu_si128, _mm_set1_epi8, _mm_cmpeq_epi8,
+                   _mm_and_si128, _mm_movemask_epi8)
+STR_SEARCH_KERNELS(avx2, CEBUS_TARGET_AVX2, __m256i, 32, _mm256_loadu_si256, _mm256_set1_epi8,
+                   _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_movemask_epi8)
+
+#undef STR_SEARCH_KERNELS
+
+// Same as 'str_search_##NAME', with the first and the last byte folded with
+// 'str_fold_mask'. 'n' can be 1.
+#define STR_SEARCH_FOLD_KERNEL(NAME, TARGET, V, W, LOAD, SET1, CMPEQ, AND, OR, MOVEMASK)           \
+  TARGET static usize str_search_ignorecase_##NAME(const char *haystack, usize len,                \
+                                                   const char *needle, usize n) {                  \
+    const V first_mask = SET1(str_fold_mask(needle[0]));                                           \
+    const V last_mask = SET1(str_fold_mask(needle[n - 1]));                                        \
+    const V first = SET1((char)(needle[0] | str_fold_mask(needle[0])));                            \
+    const V last = SET1((char)(needle[n - 1] | str_fold_mask(needle[n - 1])));                     \
+    const usize end = len - n + 1;                                                                 \
+    usize i = 0;                                                                                   \
+    for (; i + (W) <= end; i += (W)) {                                                             \
+      const V f = CMPEQ(first, OR(first_mask, LOAD((const V *)&haystack[i])));                     \
+      const V l = CMPEQ(last, OR(last_mask, LOAD((const V *)&haystack[i + n - 1])));               \
+      for (u32 mask = (u32)MOVEMASK(AND(f, l)); mask; mask &= mask - 1) {                          \
+        const usize idx = i + STR_FIRST_BIT(mask);                                                 \
+        if (str_eq_ignorecase_parts(&haystack[idx], needle, n)) {                                  \
+          return idx;                                                                              \
+        }                                                                                          \
+      }                                                                                            \
+    }                                                                                              \
+    const usize idx = str_search_ignorecase_scalar(&haystack[i], len - i, needle, n);              \
+    return idx == STR_NOT_FOUND ? idx : i + idx;                                                   \
+  }
+
+STR_SEARCH_FOLD_KERNEL(sse2, , __m128i, 16, _mm_loadu_si128, _mm_set1_epi8, _mm_cmpeq_epi8,
+                       _mm_and_si128, _mm_or_si128, _mm_movemask_epi8)
+STR_SEARCH_FOLD_KERNEL(avx2, CEBUS_TARGET_AVX2, __m256i, 32, _mm256_loadu_si256, _mm256_set1_epi8,
+                       _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_or_si256, _mm256_movemask_epi8)
+
+#undef STR_SEARCH_FOLD_KERNEL
+
+#endif
+
+// Returns the Horspool table if it is worth building one for the search,
+// 'NULL' otherwise. The vector filter is faster even for long needles, so
+// Horspool is only used without it.
+static const usize *str_search_prepare(usize len, Str needle, usize *skip) {
+  if (needle.len < STR_SEARCH_LONG || len < 4 * needle.len) {
+    return NULL;
+  }
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_sse2()) {
+    return NULL;
+  }
+#endif
+  str_search_horspool_init(needle, skip);
+  return skip;
+}
+
+static usize str_search(Str haystack, Str needle, const usize *skip) {
+  if (haystack.len < needle.len) {
+    return STR_NOT_FOUND;
+  }
+  if (needle.len == 0) {
+    return 0;
+  }
+  if (needle.len == 1) {
+    const char *hit = memchr(haystack.data, needle.data[0], haystack.len);
+    return hit ? (usize)(hit - haystack.data) : STR_NOT_FOUND;
+  }
+  if (skip) {
+    return str_search_horspool(haystack.data, haystack.len, needle, skip);
+  }
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return str_search_avx2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+  if (cpu_has_sse2()) {
+    return str_search_sse2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+#endif
+  return str_search_scalar(haystack.data, haystack.len, needle.data, needle.len);
+}
+
+static usize str_search_ignorecase(Str haystack, Str needle) {
+  if (haystack.len < needle.len) {
+    return STR_NOT_FOUND;
+  }
+  if (needle.len == 0) {
+    return 0;
+  }
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return str_search_ignorecase_avx2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+  if (cpu_has_sse2()) {
+    return str_search_ignorecase_sse2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+#endif
+  return str_search_ignorecase_scalar(haystack.data, haystack.len, needle.data, needle.len);
 }
 
-Path path_parent(Path path) {
-  (void)str_chop_right_by_delim(&path, '/');
-  return path;
+static usize str_search_last(Str haystack, Str needle) {
+  if (haystack.len < needle.len) {
+    return STR_NOT_FOUND;
+  }
+  if (needle.len == 0) {
+    return haystack.len;
+  }
+  if (needle.len == 1) {
+    for (usize i = haystack.len; 0 < i; i--) {
+      if (haystack.data[i - 1] == needle.data[0]) {
+        return i - 1;
+      }
+    }
+    return STR_NOT_FOUND;
+  }
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return str_search_last_avx2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+  if (cpu_has_sse2()) {
+    return str_search_last_sse2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+#endif
+  return str_search_last_scalar(haystack.data, haystack.len, needle.data, needle.len);
 }
 
-// #include "./string.h"
-
-// #include "cebus/core/arena.h"
-// #include "cebus/type/byte.h"
-// #include "cebus/type/char.h"
-// #include "cebus/type/integer.h"
-
-#include <stdarg.h>
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-
 ///////////////////////////////////////////////////////////////////////////////
 
 Str str_from_parts(usize size, const char *cstr) { return (Str){.len = size, .data = cstr}; }
@@ -5093,6 +11795,27 @@ Str str_format(Arena *arena, const char *fmt, ...) {
   return str_from_parts(size - 1, buffer);
 }
 
+// Every number fits, so the builder never grows. The string is terminated like
+// the ones from 'str_format'.
+#define STR_FROM_NUMBER(append, value, arena)                                                      \
+  do {                                                                                             \
+    StringBuilder sb = sb_init(arena);                                                             \
+    da_reserve(&sb, 32);                                                                           \
+    append(&sb, value);                                                                            \
+    da_push(&sb, '\0');                                                                            \
+    return str_from_parts(sb.len - 1, sb.items);                                                   \
+  } while (0)
+
+Str str_from_u64(u64 value, Arena *arena) { STR_FROM_NUMBER(sb_append_u64, value, arena); }
+
+Str str_from_i64(i64 value, Arena *arena) { STR_FROM_NUMBER(sb_append_i64, value, arena); }
+
+Str str_from_hex(u64 value, Arena *arena) { STR_FROM_NUMBER(sb_append_hex, value, arena); }
+
+Str str_from_f64(f64 value, Arena *arena) { STR_FROM_NUMBER(sb_append_f64, value, arena); }
+
+#undef STR_FROM_NUMBER
+
 ///////////////////////////////////////////////////////////////////////////////
 
 Str str_copy(Str s, Arena *arena) {
@@ -5232,22 +11955,74 @@ Str str_lower(Str s, Arena *arena) {
 }
 
 Str str_replace(Str s, Str old, Str new, Arena *arena) {
-  usize count = str_count(s, old);
-  usize new_size = (s.len - (old.len * count) + (count * new.len));
+  if (old.len == 0) {
+    return str_copy(s, arena);
+  }
+  // the positions of the matches, so the input is only searched once
+  Arena scratch = {0};
+  DA(usize) matches = da_new(&scratch);
+  usize skip[256];
+  const usize *table = str_search_prepare(s.len, old, skip);
+  for (usize i = 0; i < s.len;) {
+    const Str rest = str_from_parts(s.len - i, &s.data[i]);
+    const usize idx = str_search(rest, old, table);
+    if (idx == STR_NOT_FOUND) {
+      break;
+    }
+    da_push(&matches, i + idx);
+    i += idx + old.len;
+  }
+
+  const usize count = da_len(&matches);
+  const usize new_size = s.len - old.len * count + new.len * count;
   char *buffer = arena_alloc(arena, new_size + 1);
   buffer[new_size] = '\0';
+  usize i = 0;
+  usize j = 0;
+  for (usize m = 0; m < count; m++) {
+    const usize idx = da_get(&matches, m);
+    memcpy(&buffer[j], &s.data[i], idx - i);
+    j += idx - i;
+    memcpy(&buffer[j], new.data, new.len);
+    j += new.len;
+    i = idx + old.len;
+  }
+  memcpy(&buffer[j], &s.data[i], s.len - i);
+
+  arena_free(&scratch);
+  return str_from_parts(new_size, buffer);
+}
 
-  for (usize i = 0, j = 0; i < s.len;) {
-    if (old.len <= s.len - i && memcmp(&s.data[i], old.data, old.len) == 0) {
-      memcpy(&buffer[j], new.data, new.len);
-      i += old.len;
-      j += new.len;
-    } else {
-      buffer[j++] = s.data[i++];
+void _str_replace_each(Str s, Str old, Str new, bool ignorecase,
+                       bool (*write)(void *ctx, Str part), void *ctx) {
+  if (old.len == 0) {
+    write(ctx, s);
+    return;
+  }
+  usize skip[256];
+  const usize *table = ignorecase ? NULL : str_search_prepare(s.len, old, skip);
+  for (;;) {
+    const usize idx = ignorecase ? str_search_ignorecase(s, old) : str_search(s, old, table);
+    if (idx == STR_NOT_FOUND) {
+      break;
+    }
+    if (!write(ctx, str_from_parts(idx, s.data)) || !write(ctx, new)) {
+      return;
     }
+    s = str_from_parts(s.len - idx - old.len, &s.data[idx + old.len]);
   }
+  write(ctx, s);
+}
 
-  return str_from_parts(new_size, buffer);
+Str str_replace_many(Str s, usize count, const Str *olds, const Str *news, Arena *arena) {
+  Arena scratch = {0};
+  const AhoCorasick *ac = ac_create(&scratch, count, olds);
+  StringBuilder sb = sb_init(arena);
+  da_reserve(&sb, s.len + 1);
+  ac_replace(ac, s, news, &sb);
+  sb_append_c(&sb, '\0');
+  arena_free(&scratch);
+  return str_from_parts(sb.len - 1, sb.items);
 }
 
 Str str_center(Str s, usize width, char fillchar, Arena *arena) {
@@ -5338,12 +12113,7 @@ bool str_eq_ignorecase(Str s1, Str s2) {
   if (s1.len != s2.len) {
     return false;
   }
-  for (size_t i = 0; i < s1.len; i++) {
-    if (c_to_lower(s1.data[i]) != c_to_lower(s2.data[i])) {
-      return false;
-    }
-  }
-  return true;
+  return str_eq_ignorecase_parts(s1.data, s2.data, s1.len);
 }
 
 bool str_startswith(Str s1, Str prefix) {
@@ -5362,15 +12132,7 @@ bool str_endswith(Str s1, Str suffix) {
 }
 
 bool str_contains(Str haystack, Str needle) {
-  if (haystack.len < needle.len) {
-    return false;
-  }
-  for (usize i = 0; i < haystack.len - needle.len + 1; i++) {
-    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
-      return true;
-    }
-  }
-  return false;
+  return str_search(haystack, needle, NULL) != STR_NOT_FOUND;
 }
 
 bool str_includes(Str haystack, char needle) {
@@ -5578,6 +12340,60 @@ Str str_chop_right_by_predicate(Str *s, bool (*predicate)(char)) {
   return *s;
 }
 
+Str str_trim_left_by_charset(Str s, const CharSet *set) {
+  const usize n = charset_span(set, s);
+  return str_from_parts(s.len - n, &s.data[n]);
+}
+
+Str str_trim_right_by_charset(Str s, const CharSet *set) {
+  return str_from_parts(s.len - charset_rspan(set, s), s.data);
+}
+
+Str str_trim_by_charset(Str s, const CharSet *set) {
+  return str_trim_left_by_charset(str_trim_right_by_charset(s, set), set);
+}
+
+bool str_try_chop_by_charset(Str *s, const CharSet *set, Str *chunk) {
+  if (s->len == 0) {
+    return false;
+  }
+  const usize i = charset_cspan(set, *s);
+  if (chunk) {
+    *chunk = str_from_parts(i, s->data);
+  }
+  const usize new_len = usize_min(s->len, i + 1);
+  s->data += new_len;
+  s->len -= new_len;
+  *s = str_trim_left_by_charset(*s, set);
+  return true;
+}
+
+Str str_chop_by_charset(Str *s, const CharSet *set) {
+  Str chunk = *s;
+  str_try_chop_by_charset(s, set, &chunk);
+  return chunk;
+}
+
+Str str_chop_right_by_charset(Str *s, const CharSet *set) {
+  if (s->len == 0) {
+    return *s;
+  }
+  const usize i = charset_rcspan(set, *s);
+  Str chunk = str_from_parts(i, &s->data[s->len - i]);
+  s->len -= usize_min(s->len, i + 1);
+  *s = str_trim_right_by_charset(*s, set);
+  return chunk;
+}
+
+bool _str_split_next(Str *s, const CharSet *set, Str *field) {
+  *s = str_trim_left_by_charset(*s, set);
+  if (s->len == 0) {
+    return false;
+  }
+  *field = str_take(s, charset_cspan(set, *s));
+  return true;
+}
+
 Str str_substring(Str s, usize start, usize end) {
   if (end <= start || s.len <= start || s.len < end) {
     return STR("");
@@ -5623,115 +12439,463 @@ bool str_try_take_right(Str *s, usize count, Str *chunk) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-u64 str_u64(Str s) {
-  const int radix = 10;
-  Arena arena = {0};
-  Str owned = str_copy(s, &arena);
-  u64 value = strtoull(owned.data, NULL, radix);
-  arena_free(&arena);
+// 'c_is_digit' is not inlined from another file, and this is the hot loop.
+static inline bool str_is_digit(char c) { return (u8)(c - '0') < 10; }
+
+// Loads 8 characters with the first one in the lowest byte.
+static inline u64 str_load_le64(const char *data) {
+  u64 value;
+  memcpy(&value, data, sizeof(value));
+#if CEBUS_BYTE_ORDER == ENDIAN_BIG
+  value = u64_swap_bytes(value);
+#endif
   return value;
 }
 
-u64 str_chop_u64(Str *s) {
-  const int radix = 10;
-  Arena arena = {0};
-  Str owned = str_copy(*s, &arena);
-  char *endptr;
-  u64 value = strtoull(owned.data, &endptr, radix);
+// Returns how many of the 8 characters are digits, before the first one that
+// is not. After the xor digits are the bytes below 10, and adding 0x76 sets the
+// high bit of all others. A carry only changes bytes after the first one.
+static inline usize str_count_8_digits(u64 chunk) {
+  const u64 x = chunk ^ 0x3030303030303030;
+  const u64 mask = ((x + 0x7676767676767676) | x) & 0x8080808080808080;
+  return mask ? STR_FIRST_BIT64(mask) / 8 : 8;
+}
+
+// Converts 8 digits with three multiplications: first into pairs of digits,
+// then into groups of four and then into one number.
+static inline u64 str_parse_8_digits(u64 chunk) {
+  const u64 mask = 0x000000FF000000FF;
+  const u64 mul1 = 100 + (1000000ULL << 32);
+  const u64 mul2 = 1 + (10000ULL << 32);
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+}
 
-  const usize size = (usize)(endptr - owned.data);
-  s->data += size;
-  s->len -= size;
+static const u64 str_u64_pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
 
-  arena_free(&arena);
-  return value;
+// Parses the digits at the start of 's' and returns how many there were.
+// 'overflow' is set if the number does not fit into an u64.
+static usize str_scan_digits(Str s, u64 *value, bool *overflow) {
+  usize i = 0;
+  while (i < s.len && s.data[i] == '0') {
+    i++;
+  }
+  const usize start = i;
+  u64 result = 0;
+  // Up to 8 digits at a time without a branch per digit. The missing digits
+  // are filled up with leading zeros. 19 digits always fit into an u64.
+  while (i + 8 <= s.len) {
+    u64 chunk = str_load_le64(&s.data[i]);
+    const usize digits = str_count_8_digits(chunk);
+    if (digits == 0 || 19 < i - start + digits) {
+      break;
+    }
+    if (digits < 8) {
+      chunk = (chunk << (8 * (8 - digits))) | (0x3030303030303030 >> (8 * digits));
+    }
+    result = result * str_u64_pow10[digits] + str_parse_8_digits(chunk);
+    i += digits;
+    if (digits < 8) {
+      *value = result;
+      return i;
+    }
+  }
+  for (; i < s.len && str_is_digit(s.data[i]); i++) {
+    const u64 digit = (u64)(s.data[i] - '0');
+    if (19 <= i - start && (U64_MAX - digit) / 10 < result) {
+      *overflow = true;
+    }
+    result = result * 10 + digit;
+  }
+  *value = *overflow ? U64_MAX : result;
+  return i;
+}
+
+// Parses '[+-]digits' and returns the number of characters, or 0 if there are
+// no digits.
+static usize str_scan_integer(Str s, bool *negative, u64 *magnitude, bool *overflow) {
+  usize i = 0;
+  *negative = false;
+  if (i < s.len && (s.data[i] == '+' || s.data[i] == '-')) {
+    *negative = s.data[i] == '-';
+    i++;
+  }
+  const usize digits = str_scan_digits(str_from_parts(s.len - i, &s.data[i]), magnitude, overflow);
+  return digits ? i + digits : 0;
+}
+
+// Checks if the magnitude fits into an i64. '-9223372036854775808' does, but
+// its magnitude does not.
+static bool str_integer_i64(bool negative, u64 magnitude, i64 *value) {
+  if (negative) {
+    if ((u64)I64_MAX + 1 < magnitude) {
+      *value = I64_MIN;
+      return false;
+    }
+    *value = magnitude ? -(i64)(magnitude - 1) - 1 : 0;
+    return true;
+  }
+  if ((u64)I64_MAX < magnitude) {
+    *value = I64_MAX;
+    return false;
+  }
+  *value = (i64)magnitude;
+  return true;
 }
 
-i64 str_i64(Str s) {
-  const int radix = 10;
+///////////////////////////////////////////////////////////////////////////////
+
+// Powers of ten that are exact in a double.
+static const f64 str_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Doubles have 53 bits of mantissa.
+#define STR_F64_EXACT ((u64)1 << 53)
+// Numbers with more than this many characters, that need 'strtod', are copied
+// into an arena instead of the stack.
+#define STR_F64_BUFFER 64
+
+// 'strtod' needs a terminated string.
+static f64 str_strtod(Str s, usize *consumed, bool *overflow) {
+  char buffer[STR_F64_BUFFER];
   Arena arena = {0};
-  Str owned = str_copy(s, &arena);
-  i64 value = strtoll(owned.data, NULL, radix);
+  char *cstr = buffer;
+  if (sizeof(buffer) <= s.len) {
+    cstr = arena_alloc(&arena, s.len + 1);
+  }
+  memcpy(cstr, s.data, s.len);
+  cstr[s.len] = '\0';
+
+  char *end;
+  errno = 0;
+  const f64 value = strtod(cstr, &end);
+  *consumed = (usize)(end - cstr);
+  *overflow = errno == ERANGE && (value == HUGE_VAL || value == -HUGE_VAL);
   arena_free(&arena);
   return value;
 }
 
-i64 str_chop_i64(Str *s) {
-  const int radix = 10;
-  Arena arena = {0};
-  Str owned = str_copy(*s, &arena);
-  char *endptr;
-  i64 value = strtoll(owned.data, &endptr, radix);
+static usize str_scan_word(Str s, const char *word) {
+  usize i = 0;
+  while (word[i] && i < s.len && (s.data[i] | 0x20) == word[i]) {
+    i++;
+  }
+  return word[i] ? 0 : i;
+}
 
-  const usize size = (usize)(endptr - owned.data);
-  s->data += size;
-  s->len -= size;
+// Parses a float the way 'strtod' does, and returns the number of characters or
+// 0. Numbers with up to 19 significant digits, that are exact in a double and
+// only need an exact power of ten, are converted with a single multiplication
+// or division (Clinger's fast path). All others go through 'strtod'.
+static usize str_scan_f64(Str s, f64 *value, bool *overflow) {
+  usize i = 0;
+  bool negative = false;
+  if (i < s.len && (s.data[i] == '+' || s.data[i] == '-')) {
+    negative = s.data[i] == '-';
+    i++;
+  }
+  const Str rest = str_from_parts(s.len - i, &s.data[i]);
+  usize special = str_scan_word(rest, "infinity");
+  special = special ? special : str_scan_word(rest, "inf");
+  if (special) {
+    *value = negative ? -HUGE_VAL : HUGE_VAL;
+    return i + special;
+  }
+  if (str_scan_word(rest, "nan") || str_scan_word(rest, "0x")) {
+    usize consumed = 0;
+    *value = str_strtod(s, &consumed, overflow);
+    return consumed;
+  }
+
+  u64 mantissa = 0;
+  usize kept = 0;
+  bool truncated = false;
+  usize digits = 0;
+  i64 exponent = 0;
+  for (; i < s.len && str_is_digit(s.data[i]); i++, digits++) {
+    if (kept < 19) {
+      mantissa = mantissa * 10 + (u64)(s.data[i] - '0');
+      kept += mantissa != 0;
+    } else {
+      truncated |= s.data[i] != '0';
+      exponent++;
+    }
+  }
+  if (i < s.len && s.data[i] == '.') {
+    for (i++; i < s.len && str_is_digit(s.data[i]); i++, digits++) {
+      if (kept < 19) {
+        mantissa = mantissa * 10 + (u64)(s.data[i] - '0');
+        kept += mantissa != 0;
+        exponent--;
+      } else {
+        truncated |= s.data[i] != '0';
+      }
+    }
+  }
+  if (digits == 0) {
+    return 0;
+  }
+  if (i < s.len && (s.data[i] | 0x20) == 'e') {
+    bool exp_negative = false;
+    u64 exp_value = 0;
+    bool exp_overflow = false;
+    const usize len = str_scan_integer(str_from_parts(s.len - i - 1, &s.data[i + 1]),
+                                       &exp_negative, &exp_value, &exp_overflow);
+    if (len) {
+      i += 1 + len;
+      // anything this large is either zero or infinity anyway
+      exp_value = exp_value < 100000 ? exp_value : 100000;
+      exponent += exp_negative ? -(i64)exp_value : (i64)exp_value;
+    }
+  }
 
-  arena_free(&arena);
-  return value;
+  *overflow = false;
+  if (mantissa == 0 && !truncated) {
+    *value = negative ? -0.0 : 0.0;
+    return i;
+  }
+  if (!truncated && mantissa <= STR_F64_EXACT && -22 <= exponent && exponent <= 22) {
+    const f64 m = (f64)mantissa;
+    *value = exponent < 0 ? m / str_pow10[-exponent] : m * str_pow10[exponent];
+    *value = negative ? -*value : *value;
+    return i;
+  }
+  usize consumed = 0;
+  *value = str_strtod(str_from_parts(i, s.data), &consumed, overflow);
+  return consumed;
 }
 
-f64 str_f64(Str s) {
-  Arena arena = {0};
-  Str owned = str_copy(s, &arena);
-  double value = strtod(owned.data, NULL);
-  arena_free(&arena);
+#undef STR_F64_EXACT
+#undef STR_F64_BUFFER
+
+///////////////////////////////////////////////////////////////////////////////
+
+u64 str_u64(Str s) { return str_chop_u64(&s); }
+
+u64 str_chop_u64(Str *s) {
+  const Str trimmed = str_trim_left(*s);
+  bool negative = false;
+  bool overflow = false;
+  u64 magnitude = 0;
+  const usize len = str_scan_integer(trimmed, &negative, &magnitude, &overflow);
+  if (len == 0) {
+    return 0;
+  }
+  *s = str_from_parts(trimmed.len - len, &trimmed.data[len]);
+  // the same as 'strtoull'
+  return negative && !overflow ? 0 - magnitude : magnitude;
+}
+
+i64 str_i64(Str s) { return str_chop_i64(&s); }
+
+i64 str_chop_i64(Str *s) {
+  const Str trimmed = str_trim_left(*s);
+  bool negative = false;
+  bool overflow = false;
+  u64 magnitude = 0;
+  const usize len = str_scan_integer(trimmed, &negative, &magnitude, &overflow);
+  if (len == 0) {
+    return 0;
+  }
+  *s = str_from_parts(trimmed.len - len, &trimmed.data[len]);
+  i64 value = 0;
+  str_integer_i64(negative, magnitude, &value);
   return value;
 }
 
+f64 str_f64(Str s) { return str_chop_f64(&s); }
+
 f64 str_chop_f64(Str *s) {
-  Arena arena = {0};
-  Str owned = str_copy(*s, &arena);
+  const Str trimmed = str_trim_left(*s);
+  bool overflow = false;
+  f64 value = 0;
+  const usize len = str_scan_f64(trimmed, &value, &overflow);
+  if (len == 0) {
+    return 0;
+  }
+  *s = str_from_parts(trimmed.len - len, &trimmed.data[len]);
+  return value;
+}
 
-  char *endptr;
-  f64 value = strtod(owned.data, &endptr);
+///////////////////////////////////////////////////////////////////////////////
 
-  const usize size = (usize)(endptr - owned.data);
-  s->data += size;
-  s->len -= size;
+static StrParseError str_try_u64(Str s, u64 *value) {
+  bool overflow = false;
+  usize len = 0;
+  if (s.len && s.data[0] == '+') {
+    len = 1;
+  }
+  const usize digits = str_scan_digits(str_from_parts(s.len - len, &s.data[len]), value, &overflow);
+  if (digits == 0 || len + digits != s.len) {
+    return STR_PARSE_INVALID;
+  }
+  return overflow ? STR_PARSE_OVERFLOW : STR_PARSE_OK;
+}
 
-  arena_free(&arena);
+static StrParseError str_try_i64(Str s, i64 *value) {
+  bool negative = false;
+  bool overflow = false;
+  u64 magnitude = 0;
+  const usize len = str_scan_integer(s, &negative, &magnitude, &overflow);
+  if (len == 0 || len != s.len) {
+    return STR_PARSE_INVALID;
+  }
+  const bool fits = str_integer_i64(negative, magnitude, value);
+  return overflow || !fits ? STR_PARSE_OVERFLOW : STR_PARSE_OK;
+}
+
+static StrParseError str_try_f64(Str s, f64 *value) {
+  bool overflow = false;
+  const usize len = str_scan_f64(s, value, &overflow);
+  if (len == 0 || len != s.len) {
+    return STR_PARSE_INVALID;
+  }
+  return overflow ? STR_PARSE_OVERFLOW : STR_PARSE_OK;
+}
+
+// 'field' is the index of the field in a column, or 'STR_NOT_FOUND'.
+static void str_parse_error(Error *error, StrParseError code, Str s, const char *type,
+                            usize field) {
+  char prefix[32] = "";
+  if (field != STR_NOT_FOUND) {
+    snprintf(prefix, sizeof(prefix), "field %" USIZE_FMT ": ", field);
+  }
+  if (code == STR_PARSE_OVERFLOW) {
+    error_emit(error, code, "%s'" STR_FMT "' does not fit into %s", prefix, STR_ARG(s), type);
+  } else {
+    error_emit(error, code, "%s'" STR_FMT "' is not a valid %s", prefix, STR_ARG(s), type);
+  }
+}
+
+u64 str_parse_u64(Str s, Error *error) {
+  u64 value = 0;
+  const StrParseError code = str_try_u64(s, &value);
+  if (code != STR_PARSE_OK) {
+    str_parse_error(error, code, s, "u64", STR_NOT_FOUND);
+    return 0;
+  }
   return value;
 }
 
-usize str_find(Str haystack, Str needle) {
-  if (haystack.len < needle.len) {
-    return STR_NOT_FOUND;
+i64 str_parse_i64(Str s, Error *error) {
+  i64 value = 0;
+  const StrParseError code = str_try_i64(s, &value);
+  if (code != STR_PARSE_OK) {
+    str_parse_error(error, code, s, "i64", STR_NOT_FOUND);
+    return 0;
   }
-  for (usize i = 0; i < haystack.len - needle.len + 1; i++) {
-    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
-      return i;
-    }
+  return value;
+}
+
+f64 str_parse_f64(Str s, Error *error) {
+  f64 value = 0;
+  const StrParseError code = str_try_f64(s, &value);
+  if (code != STR_PARSE_OK) {
+    str_parse_error(error, code, s, "f64", STR_NOT_FOUND);
+    return 0;
   }
-  return STR_NOT_FOUND;
+  return value;
 }
 
-usize str_find_last(Str haystack, Str needle) {
-  if (haystack.len < needle.len) {
-    return STR_NOT_FOUND;
+///////////////////////////////////////////////////////////////////////////////
+
+// 'str_trim' calls a predicate for every character. Fields are rarely padded.
+static inline Str str_trim_field(Str s) {
+  while (s.len && (s.data[0] == ' ' || (u8)(s.data[0] - '\t') < 5)) {
+    s.data++;
+    s.len--;
   }
-  for (usize i = haystack.len - needle.len + 1; i > 0; i--) {
-    if (memcmp(&haystack.data[i - 1], needle.data, needle.len) == 0) {
-      return i - 1;
-    }
+  while (s.len && (s.data[s.len - 1] == ' ' || (u8)(s.data[s.len - 1] - '\t') < 5)) {
+    s.len--;
   }
-  return STR_NOT_FOUND;
+  return s;
+}
+
+usize _str_field_count(Str s, char delim) {
+  usize count = 1;
+  for (const char *p = s.data, *end = s.data + s.len; (p = memchr(p, delim, (usize)(end - p)));
+       p++) {
+    count++;
+  }
+  return count;
+}
+
+// Calls 'parse' for every trimmed field. An empty last field, from a trailing
+// delimiter or newline, is skipped. Stops at the first invalid field.
+#define STR_PARSE_FIELDS(s, delim, out, error, parse, type)                                        \
+  do {                                                                                             \
+    usize count = 0;                                                                               \
+    usize field = 0;                                                                               \
+    for (bool last = false; !last; field++) {                                                      \
+      const char *next = s.len ? memchr(s.data, delim, s.len) : NULL;                              \
+      last = next == NULL;                                                                         \
+      const usize len = last ? s.len : (usize)(next - s.data);                                     \
+      const Str value = str_trim_field(str_from_parts(len, s.data));                               \
+      s = last ? str_from_parts(0, &s.data[s.len]) : str_from_parts(s.len - len - 1, next + 1);    \
+      if (last && value.len == 0) {                                                                \
+        break;                                                                                     \
+      }                                                                                            \
+      const StrParseError code = parse(value, &out[count]);                                        \
+      if (code != STR_PARSE_OK) {                                                                  \
+        str_parse_error(error, code, value, type, field);                                          \
+        break;                                                                                     \
+      }                                                                                            \
+      count++;                                                                                     \
+    }                                                                                              \
+    return count;                                                                                  \
+  } while (0)
+
+usize _str_parse_u64s(Str s, char delim, u64 *out, Error *error) {
+  STR_PARSE_FIELDS(s, delim, out, error, str_try_u64, "u64");
+}
+
+usize _str_parse_i64s(Str s, char delim, i64 *out, Error *error) {
+  STR_PARSE_FIELDS(s, delim, out, error, str_try_i64, "i64");
+}
+
+usize _str_parse_f64s(Str s, char delim, f64 *out, Error *error) {
+  STR_PARSE_FIELDS(s, delim, out, error, str_try_f64, "f64");
+}
+
+#undef STR_PARSE_FIELDS
+
+///////////////////////////////////////////////////////////////////////////////
+
+usize str_find(Str haystack, Str needle) {
+  usize skip[256];
+  return str_search(haystack, needle, str_search_prepare(haystack.len, needle, skip));
+}
+
+usize str_find_last(Str haystack, Str needle) { return str_search_last(haystack, needle); }
+
+usize str_find_ignorecase(Str haystack, Str needle) {
+  return str_search_ignorecase(haystack, needle);
 }
 
 usize str_count(Str haystack, Str needle) {
-  usize count = 0;
-  if (haystack.len < needle.len) {
-    return count;
+  if (needle.len == 0) {
+    return 0;
   }
-  for (usize i = 0; i < haystack.len - needle.len + 1; i++) {
-    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
-      count++;
-      i += needle.len - 1;
+  usize skip[256];
+  const usize *table = str_search_prepare(haystack.len, needle, skip);
+  usize count = 0;
+  for (usize i = 0; i < haystack.len;) {
+    const Str rest = str_from_parts(haystack.len - i, &haystack.data[i]);
+    const usize idx = str_search(rest, needle, table);
+    if (idx == STR_NOT_FOUND) {
+      break;
     }
+    count++;
+    i += idx + needle.len;
   }
   return count;
 }
 
+usize str_count_by_charset(Str s, const CharSet *set) { return charset_count(set, s); }
+
 char str_getc(Str s, usize idx) {
   if (s.len <= idx) {
     return '\0';
@@ -5739,17 +12903,17 @@ char str_getc(Str s, usize idx) {
   return s.data[idx];
 }
 
-u64 str_hash(Str s) {
-  const uint64_t magic_prime = 0x00000100000001b3;
-  uint64_t hash = 0xcbf29ce484222325; // NOLINT
-  for (usize i = 0; i < s.len; ++i) {
-    hash = (hash ^ (u64)s.data[i]) * magic_prime;
-  }
-  return hash;
-}
+u64 str_hash(Str s) { return bytes_hash(str_to_bytes(s)); }
+
+u64 str_hash_seed(Str s, u64 seed) { return bytes_hash_seed(str_to_bytes(s), seed); }
 
 ///////////////////////////////////////////////////////////////////////////////
 
+#undef STR_SEARCH_LONG
+#undef STR_FIRST_BIT
+#undef STR_FIRST_BIT64
+#undef STR_LAST_BIT
+
 // #include "utf8.h"
 
 // #include "cebus/core/arena.h"
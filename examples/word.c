@@ -53,9 +53,12 @@ int main(int argc, const char **argv) {
   // intialize the HashMap
   HashMap *word_idx = hm_create(&arena);
 
+  // build the set of separators once, instead of calling the predicate for every character
+  const CharSet separators = charset_from_predicate(predicate);
+
   usize total_words = 0;
   // Iterate over the content word by word
-  for (Str word = {0}; str_try_chop_by_predicate(&content, predicate, &word);) {
+  for (Str word = {0}; str_try_chop_by_charset(&content, &separators, &word);) {
     total_words++;
 
     // calculate hash of the current word
@@ -8,6 +8,10 @@ FIRST = [
     Path("src/cebus/core/defines.h"),
     Path("src/cebus/core/arena.h"),
     Path("src/cebus/core/debug.h"),
+    Path("src/cebus/collection/da.h"),
+    Path("src/cebus/collection/string_builder.h"),
+    Path("src/cebus/core/error.h"),
+    Path("src/cebus/os/thread.h"),
 ]
 
 
@@ -10,12 +10,26 @@ Include this file to include all the header files that are listed below.
 
 // IWYU pragma: begin_exports
 
+#include "cebus/collection/aho_corasick.h"
+#include "cebus/collection/bloom.h"
+#include "cebus/collection/count_min.h"
 #include "cebus/collection/da.h"
+#include "cebus/collection/da_par.h"
+#include "cebus/collection/eytzinger.h"
 #include "cebus/collection/hashmap.h"
+#include "cebus/collection/heap.h"
+#include "cebus/collection/hll.h"
+#include "cebus/collection/iter.h"
+#include "cebus/collection/ring_buffer.h"
+#include "cebus/collection/seg_array.h"
 #include "cebus/collection/set.h"
+#include "cebus/collection/soa.h"
+#include "cebus/collection/str_pool.h"
 #include "cebus/collection/string_builder.h"
+#include "cebus/collection/top_k.h"
 
 #include "cebus/core/arena.h"
+#include "cebus/core/cpu.h"
 #include "cebus/core/debug.h"
 #include "cebus/core/error.h"
 #include "cebus/core/logging.h"
@@ -27,11 +41,14 @@ Include this file to include all the header files that are listed below.
 #include "cebus/os/fs.h"
 #include "cebus/os/io.h"
 #include "cebus/os/os.h"
+#include "cebus/os/thread.h"
 
 #include "cebus/type/byte.h"
 #include "cebus/type/char.h"
+#include "cebus/type/charset.h"
 #include "cebus/type/float.h"
 #include "cebus/type/integer.h"
+#include "cebus/type/numeric.h"
 #include "cebus/type/string.h"
 #include "cebus/type/utf8.h"
 
@@ -0,0 +1,365 @@
+#include "aho_corasick.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/byte.h"
+#include "cebus/type/integer.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define AC_NONE U32_MAX
+// The dense table is used up to this many transitions, 1 MiB.
+#define AC_DENSE_MAX 262144
+
+struct AhoCorasick {
+  usize count;
+  usize *lens;
+  // the next pattern with the same bytes
+  u32 *next_same;
+  usize max_len;
+
+  usize states;
+  // the first pattern that ends in the state
+  u32 *ends;
+  // the closest state on the failure path that ends a pattern, '0' if none
+  u32 *output;
+  // if the state ends a pattern or has an output
+  bool *reports;
+
+  // dense: 'delta[state * classes + class_of[byte]]'
+  usize classes;
+  u8 class_of[256];
+  u32 *delta;
+
+  // compact: the sorted edges of every state and the failure links
+  u32 root[256];
+  u32 *fail;
+  u32 *edge_start;
+  u8 *edge_bytes;
+  u32 *edge_targets;
+};
+
+// The edges of the trie while it is built, a list for every node.
+typedef struct {
+  u32 target;
+  u32 next;
+  u8 byte;
+} AcEdge;
+
+typedef struct {
+  u32 *first;
+  AcEdge *edges;
+} AcTrie;
+
+//////////////////////////////////////////////////////////////////////////////
+
+static u32 ac_trie_child(const AcTrie *trie, u32 node, u8 byte) {
+  for (u32 e = trie->first[node]; e != AC_NONE; e = trie->edges[e].next) {
+    if (trie->edges[e].byte == byte) {
+      return trie->edges[e].target;
+    }
+  }
+  return AC_NONE;
+}
+
+static void ac_build_dense(AhoCorasick *ac, Arena *arena, const AcTrie *trie, const u32 *order) {
+  const usize k = ac->classes;
+  ac->delta = arena_alloc(arena, ac->states * k * sizeof(u32));
+  // a failure link always points to a state that comes earlier in the breadth
+  // first order, so its row is already done
+  for (usize i = 0; i < ac->states; i++) {
+    const u32 node = order[i];
+    u32 *row = &ac->delta[node * k];
+    if (node == 0) {
+      memset(row, 0, k * sizeof(u32));
+    } else {
+      memcpy(row, &ac->delta[ac->fail[node] * k], k * sizeof(u32));
+    }
+    for (u32 e = trie->first[node]; e != AC_NONE; e = trie->edges[e].next) {
+      row[ac->class_of[trie->edges[e].byte]] = trie->edges[e].target;
+    }
+  }
+}
+
+static void ac_build_compact(AhoCorasick *ac, Arena *arena, const AcTrie *trie) {
+  ac->edge_start = arena_alloc(arena, (ac->states + 1) * sizeof(u32));
+  ac->edge_bytes = arena_alloc(arena, ac->states * sizeof(u8));
+  ac->edge_targets = arena_alloc(arena, ac->states * sizeof(u32));
+  u32 n = 0;
+  for (usize node = 0; node < ac->states; node++) {
+    ac->edge_start[node] = n;
+    for (u32 e = trie->first[node]; e != AC_NONE; e = trie->edges[e].next) {
+      // insertion sort by byte, most states only have a single edge
+      u32 i = n++;
+      for (; ac->edge_start[node] < i && trie->edges[e].byte < ac->edge_bytes[i - 1]; i--) {
+        ac->edge_bytes[i] = ac->edge_bytes[i - 1];
+        ac->edge_targets[i] = ac->edge_targets[i - 1];
+      }
+      ac->edge_bytes[i] = trie->edges[e].byte;
+      ac->edge_targets[i] = trie->edges[e].target;
+    }
+  }
+  ac->edge_start[ac->states] = n;
+  for (u32 e = trie->first[0]; e != AC_NONE; e = trie->edges[e].next) {
+    ac->root[trie->edges[e].byte] = trie->edges[e].target;
+  }
+}
+
+static inline u32 ac_step_compact(const AhoCorasick *ac, u32 state, u8 byte) {
+  while (state) {
+    const u32 end = ac->edge_start[state + 1];
+    for (u32 e = ac->edge_start[state]; e < end && ac->edge_bytes[e] <= byte; e++) {
+      if (ac->edge_bytes[e] == byte) {
+        return ac->edge_targets[e];
+      }
+    }
+    state = ac->fail[state];
+  }
+  return ac->root[byte];
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+AhoCorasick *ac_create(Arena *arena, usize count, const Str *patterns) {
+  Arena scratch = {0};
+  Bytes *bytes = arena_alloc(&scratch, count * sizeof(Bytes) + 1);
+  for (usize i = 0; i < count; i++) {
+    bytes[i] = bytes_from_parts(patterns[i].len, patterns[i].data);
+  }
+  AhoCorasick *ac = ac_create_bytes(arena, count, bytes);
+  arena_free(&scratch);
+  return ac;
+}
+
+AhoCorasick *ac_create_bytes(Arena *arena, usize count, const Bytes *patterns) {
+  AhoCorasick *ac = arena_calloc(arena, sizeof(AhoCorasick));
+  ac->count = count;
+  ac->lens = arena_alloc(arena, count * sizeof(usize) + 1);
+  ac->next_same = arena_alloc(arena, count * sizeof(u32) + 1);
+
+  usize total = 0;
+  for (usize i = 0; i < count; i++) {
+    total += patterns[i].size;
+  }
+  cebus_assert(total < AC_NONE && count < AC_NONE, "AhoCorasick: too many patterns");
+
+  // the trie has at most one node for every byte of the patterns
+  Arena scratch = {0};
+  AcTrie trie = {
+      .first = arena_alloc(&scratch, (total + 1) * sizeof(u32)),
+      .edges = arena_alloc(&scratch, (total + 1) * sizeof(AcEdge)),
+  };
+  u32 *ends = arena_alloc(&scratch, (total + 1) * sizeof(u32));
+  trie.first[0] = AC_NONE;
+  ends[0] = AC_NONE;
+  u32 states = 1;
+  bool used[256] = {0};
+  for (usize p = 0; p < count; p++) {
+    ac->lens[p] = patterns[p].size;
+    ac->next_same[p] = AC_NONE;
+    if (patterns[p].size == 0) {
+      continue;
+    }
+    ac->max_len = usize_max(ac->max_len, patterns[p].size);
+    u32 node = 0;
+    for (usize i = 0; i < patterns[p].size; i++) {
+      const u8 byte = patterns[p].data[i];
+      u32 child = ac_trie_child(&trie, node, byte);
+      if (child == AC_NONE) {
+        child = states++;
+        trie.first[child] = AC_NONE;
+        ends[child] = AC_NONE;
+        trie.edges[child] = (AcEdge){.target = child, .next = trie.first[node], .byte = byte};
+        trie.first[node] = child;
+        used[byte] = true;
+      }
+      node = child;
+    }
+    // duplicates are reported in the order of the patterns
+    u32 *last = &ends[node];
+    while (*last != AC_NONE) {
+      last = &ac->next_same[*last];
+    }
+    *last = (u32)p;
+  }
+
+  ac->states = states;
+  ac->ends = arena_alloc(arena, states * sizeof(u32));
+  memcpy(ac->ends, ends, states * sizeof(u32));
+  ac->output = arena_alloc(arena, states * sizeof(u32));
+  ac->reports = arena_alloc(arena, states * sizeof(bool));
+  ac->fail = arena_alloc(arena, states * sizeof(u32));
+
+  // breadth first, so the failure link of a node is known before its children
+  u32 *order = arena_alloc(&scratch, states * sizeof(u32));
+  usize head = 0;
+  usize tail = 1;
+  order[0] = 0;
+  ac->fail[0] = 0;
+  ac->output[0] = 0;
+  ac->reports[0] = false;
+  while (head < tail) {
+    const u32 node = order[head++];
+    for (u32 e = trie.first[node]; e != AC_NONE; e = trie.edges[e].next) {
+      const u32 child = trie.edges[e].target;
+      u32 fail = 0;
+      if (node != 0) {
+        u32 f = ac->fail[node];
+        while ((fail = ac_trie_child(&trie, f, trie.edges[e].byte)) == AC_NONE && f != 0) {
+          f = ac->fail[f];
+        }
+        fail = fail == AC_NONE ? 0 : fail;
+      }
+      ac->fail[child] = fail;
+      ac->output[child] = ac->ends[fail] != AC_NONE ? fail : ac->output[fail];
+      ac->reports[child] = ac->ends[child] != AC_NONE || ac->output[child] != 0;
+      order[tail++] = child;
+    }
+  }
+
+  ac->classes = 1;
+  for (usize b = 0; b < 256; b++) {
+    ac->class_of[b] = used[b] ? (u8)ac->classes++ : 0;
+  }
+  if (ac->classes == 257 || AC_DENSE_MAX < states * ac->classes) {
+    ac_build_compact(ac, arena, &trie);
+  } else {
+    ac_build_dense(ac, arena, &trie, order);
+  }
+
+  arena_free(&scratch);
+  return ac;
+}
+
+usize ac_len(const AhoCorasick *ac) { return ac->count; }
+
+bool ac_is_dense(const AhoCorasick *ac) { return ac->delta != NULL; }
+
+//////////////////////////////////////////////////////////////////////////////
+
+AcStream ac_stream(const AhoCorasick *ac) {
+  return (AcStream){.ac = ac, .report = 0, .pattern = AC_NONE};
+}
+
+void ac_feed(AcStream *stream, Bytes chunk) {
+  stream->offset += stream->pos;
+  stream->pos = 0;
+  stream->chunk = chunk;
+}
+
+void ac_feed_str(AcStream *stream, Str chunk) {
+  ac_feed(stream, bytes_from_parts(chunk.len, chunk.data));
+}
+
+bool ac_next(AcStream *stream, AcMatch *match) {
+  const AhoCorasick *ac = stream->ac;
+  if (stream->pattern == AC_NONE) {
+    const u8 *data = stream->chunk.data;
+    const usize size = stream->chunk.size;
+    usize pos = stream->pos;
+    u32 state = stream->state;
+    bool found = false;
+    if (ac->delta) {
+      const usize k = ac->classes;
+      while (pos < size && !found) {
+        state = ac->delta[state * k + ac->class_of[data[pos++]]];
+        found = ac->reports[state];
+      }
+    } else {
+      while (pos < size && !found) {
+        state = ac_step_compact(ac, state, data[pos++]);
+        found = ac->reports[state];
+      }
+    }
+    stream->pos = pos;
+    stream->state = state;
+    if (!found) {
+      return false;
+    }
+    stream->report = ac->ends[state] != AC_NONE ? state : ac->output[state];
+    stream->pattern = ac->ends[stream->report];
+  }
+
+  const u32 pattern = stream->pattern;
+  match->pattern = pattern;
+  match->end = stream->offset + stream->pos;
+  match->start = match->end - ac->lens[pattern];
+
+  stream->pattern = ac->next_same[pattern];
+  if (stream->pattern == AC_NONE) {
+    stream->report = ac->output[stream->report];
+    stream->pattern = stream->report ? ac->ends[stream->report] : AC_NONE;
+  }
+  return true;
+}
+
+void ac_each(AcStream *stream, Bytes chunk, AcMatchFn fn, void *ctx) {
+  ac_feed(stream, chunk);
+  for (AcMatch match; ac_next(stream, &match);) {
+    fn(ctx, match);
+  }
+}
+
+bool ac_find(const AhoCorasick *ac, Str s, AcMatch *match) {
+  AcStream stream = ac_stream(ac);
+  ac_feed_str(&stream, s);
+  return ac_next(&stream, match);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// The leftmost candidate, the longest one if they start at the same position.
+static usize ac_replace_best(usize count, const AcMatch *candidates) {
+  usize best = 0;
+  for (usize i = 1; i < count; i++) {
+    if (candidates[i].start < candidates[best].start ||
+        (candidates[i].start == candidates[best].start &&
+         candidates[best].end < candidates[i].end)) {
+      best = i;
+    }
+  }
+  return best;
+}
+
+void ac_replace(const AhoCorasick *ac, Str s, const Str *replacements, StringBuilder *sb) {
+  Arena scratch = {0};
+  DA(AcMatch) candidates = da_new(&scratch);
+  AcStream stream = ac_stream(ac);
+  ac_feed_str(&stream, s);
+
+  usize copied = 0;
+  AcMatch match = {0};
+  for (bool more = true; more;) {
+    more = ac_next(&stream, &match);
+    if (more && copied <= match.start) {
+      da_push(&candidates, match);
+    }
+    // The best candidate is final once no match that ends later can start at
+    // or before it.
+    while (da_len(&candidates)) {
+      const usize idx = ac_replace_best(da_len(&candidates), candidates.items);
+      const AcMatch best = da_get(&candidates, idx);
+      if (more && match.end - best.start <= ac->max_len) {
+        break;
+      }
+      sb_append_parts(sb, best.start - copied, &s.data[copied]);
+      sb_append_str(sb, replacements[best.pattern]);
+      copied = best.end;
+      usize kept = 0;
+      for (usize i = 0; i < da_len(&candidates); i++) {
+        if (copied <= da_get(&candidates, i).start) {
+          da_get(&candidates, kept++) = da_get(&candidates, i);
+        }
+      }
+      da_len(&candidates) = kept;
+    }
+  }
+  sb_append_parts(sb, s.len - copied, &s.data[copied]);
+  arena_free(&scratch);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef AC_NONE
+#undef AC_DENSE_MAX
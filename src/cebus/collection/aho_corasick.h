@@ -0,0 +1,113 @@
+/* DOCUMENTATION
+`AhoCorasick` searches for many patterns at once in a single pass over the
+text, no matter how many patterns there are. It is built once from the
+patterns and never changes, so it can be shared between threads.
+
+Small pattern sets are compiled into a dense table with one transition for
+every state and byte class, so every byte of the text costs one lookup. The
+bytes that do not occur in any pattern share a class. Large sets, where that
+table would get too big, keep the sorted edges of every state and follow the
+failure links instead.
+
+```c
+Arena arena = {0};
+const Str keywords[] = {STR("if"), STR("else"), STR("while")};
+AhoCorasick *ac = ac_create(&arena, ARRAY_LEN(keywords), keywords);
+
+AcStream stream = ac_stream(ac);
+ac_feed_str(&stream, text);
+for (AcMatch match; ac_next(&stream, &match);) {
+  printf("%" USIZE_FMT ": %" USIZE_FMT "\n", match.pattern, match.start);
+}
+```
+
+- `ac_create(arena, count, patterns)`, `ac_create_bytes(arena, count,
+patterns)`: Builds the automaton from `Str` or `Bytes` patterns. Empty patterns
+never match.
+- `ac_len(ac)`: Returns the number of patterns.
+- `ac_is_dense(ac)`: Checks if it uses the dense table.
+
+## Searching
+
+A stream keeps the state between chunks, so matches that cross the border of
+two chunks are found too. The positions are counted from the start of the
+first chunk.
+
+- `ac_stream(ac)`: Starts a search.
+- `ac_feed(&stream, bytes)`, `ac_feed_str(&stream, str)`: Continues the search
+with the next chunk. Call it after `ac_next` returned `false`, the chunk has to
+stay valid until then.
+- `ac_next(&stream, &match)`: Finds the next match in the current chunk. Every
+match is reported, including overlapping ones, ordered by their end. Matches
+with the same end are reported from the longest to the shortest.
+- `ac_each(&stream, bytes, fn, ctx)`: Feeds a chunk and calls `fn(ctx, match)`
+for every match.
+- `ac_find(ac, str, &match)`: Finds the match that ends first.
+
+## Replacing
+
+- `ac_replace(ac, str, replacements, &sb)`: Appends the string to a
+`StringBuilder`, with every match replaced by `replacements[pattern]`. The
+matches do not overlap. If matches overlap, the one that starts first wins,
+and the longest one wins if they start at the same position.
+
+`str_replace_many` builds an automaton for a single call.
+*/
+
+#ifndef __CEBUS_AHO_CORASICK_H__
+#define __CEBUS_AHO_CORASICK_H__
+
+#include "cebus/collection/string_builder.h"
+#include "cebus/core/arena.h"
+#include "cebus/core/defines.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct AhoCorasick AhoCorasick;
+
+typedef struct {
+  // index of the pattern
+  usize pattern;
+  // position of the first byte and after the last byte
+  usize start;
+  usize end;
+} AcMatch;
+
+typedef struct {
+  const AhoCorasick *ac;
+  u32 state;
+  // the state and pattern of the next match that ends at 'pos'
+  u32 report;
+  u32 pattern;
+  usize offset;
+  usize pos;
+  Bytes chunk;
+} AcStream;
+
+typedef void (*AcMatchFn)(void *ctx, AcMatch match);
+
+//////////////////////////////////////////////////////////////////////////////
+
+AhoCorasick *ac_create(Arena *arena, usize count, const Str *patterns);
+AhoCorasick *ac_create_bytes(Arena *arena, usize count, const Bytes *patterns);
+
+usize ac_len(const AhoCorasick *ac);
+bool ac_is_dense(const AhoCorasick *ac);
+
+//////////////////////////////////////////////////////////////////////////////
+
+AcStream ac_stream(const AhoCorasick *ac);
+void ac_feed(AcStream *stream, Bytes chunk);
+void ac_feed_str(AcStream *stream, Str chunk);
+bool ac_next(AcStream *stream, AcMatch *match);
+
+void ac_each(AcStream *stream, Bytes chunk, AcMatchFn fn, void *ctx);
+bool ac_find(const AhoCorasick *ac, Str s, AcMatch *match);
+
+//////////////////////////////////////////////////////////////////////////////
+
+void ac_replace(const AhoCorasick *ac, Str s, const Str *replacements, StringBuilder *sb);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_AHO_CORASICK_H__ */
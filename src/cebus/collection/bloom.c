@@ -0,0 +1,271 @@
+#include "bloom.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/core/platform.h"
+#include "cebus/type/float.h"
+#include "cebus/type/integer.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define BLOOM_BLOCK_BITS 512
+#define BLOOM_BLOCK_WORDS (BLOOM_BLOCK_BITS / 64)
+#define BLOOM_MAX_K 32
+#define BLOOM_MAX_BLOCKED_K 16
+#define BLOOM_BATCH 16
+
+#if defined(GCC) || defined(CLANG)
+#define BLOOM_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define BLOOM_PREFETCH(ptr) ((void)(ptr))
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+static f64 bloom_powi(f64 x, usize n) {
+  f64 result = 1.0;
+  while (n) {
+    if (n & 1) {
+      result *= x;
+    }
+    x *= x;
+    n >>= 1;
+  }
+  return result;
+}
+
+static f64 bloom_classic_fp(usize bits, usize k, usize count) {
+  const f64 filled = 1.0 - f64_exp(-(f64)k * (f64)count / (f64)bits);
+  return bloom_powi(filled, k);
+}
+
+// The number of members per block is poisson distributed, so sum up the false
+// positive rate of every block load weighted by its probability.
+static f64 bloom_blocked_fp(usize bits, usize k, usize count) {
+  const f64 lambda = (f64)count * BLOOM_BLOCK_BITS / (f64)bits;
+  const f64 empty = bloom_powi(1.0 - 1.0 / BLOOM_BLOCK_BITS, k);
+  f64 probability = f64_exp(-lambda);
+  f64 empty_bits = 1.0;
+  f64 fp = 0;
+  for (usize i = 0; i < 4 * BLOOM_BLOCK_BITS; i++) {
+    fp += probability * bloom_powi(1.0 - empty_bits, k);
+    probability *= lambda / (f64)(i + 1);
+    empty_bits *= empty;
+    if (lambda < (f64)i && probability < 1e-18) {
+      break;
+    }
+  }
+  return fp;
+}
+
+static usize bloom_best_k(usize bits, usize count, bool blocked, f64 *fp) {
+  usize best = 1;
+  *fp = 1.0;
+  const usize max_k = blocked ? BLOOM_MAX_BLOCKED_K : BLOOM_MAX_K;
+  for (usize k = 1; k <= max_k; k++) {
+    const f64 rate =
+        blocked ? bloom_blocked_fp(bits, k, count) : bloom_classic_fp(bits, k, count);
+    if (rate < *fp) {
+      *fp = rate;
+      best = k;
+    }
+  }
+  return best;
+}
+
+static BloomFilter bloom_create_sized(Arena *arena, usize expected, f64 fp_rate, bool blocked) {
+  cebus_assert(0 < fp_rate && fp_rate < 1, "The false positive rate has to be in (0, 1)");
+  const usize align = blocked ? BLOOM_BLOCK_BITS : 64;
+  usize bits = usize_max(expected, align);
+  f64 fp = 1.0;
+  usize k = bloom_best_k(bits, expected, blocked, &fp);
+  while (fp_rate < fp) {
+    bits += bits / 64 + align;
+    k = bloom_best_k(bits, expected, blocked, &fp);
+  }
+  return bloom_with_size(arena, bits, k, blocked);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static u64 *bloom_block(const BloomFilter *bf, u64 hash) {
+  const u64 blocks = bf->bits / BLOOM_BLOCK_BITS;
+  return &bf->items[((hash >> 32) * blocks >> 32) * BLOOM_BLOCK_WORDS];
+}
+
+// Double hashing inside of a small block correlates the bits too much, so every
+// position takes the top 9 bits of the next step of a LCG instead.
+static u64 bloom_block_next(u64 state) {
+  return state * 0x5851f42d4c957f2d + 0x14057b7ef767814f;
+}
+
+static bool bloom_block_add(BloomFilter *bf, u64 hash) {
+  u64 *block = bloom_block(bf, hash);
+  u64 missing = 0;
+  for (usize i = 0; i < bf->k; i++) {
+    hash = bloom_block_next(hash);
+    const usize pos = hash >> 55;
+    const u64 bit = (u64)1 << (pos % 64);
+    missing |= ~block[pos / 64] & bit;
+    block[pos / 64] |= bit;
+  }
+  return missing != 0;
+}
+
+static bool bloom_block_contains(const BloomFilter *bf, u64 hash) {
+  const u64 *block = bloom_block(bf, hash);
+  for (usize i = 0; i < bf->k; i++) {
+    hash = bloom_block_next(hash);
+    const usize pos = hash >> 55;
+    if (!(block[pos / 64] & ((u64)1 << (pos % 64)))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static bool bloom_classic_add(BloomFilter *bf, u64 hash) {
+  usize pos = hash % bf->bits;
+  const usize step = u64_mix(hash) % (bf->bits - 1) + 1;
+  u64 missing = 0;
+  for (usize i = 0; i < bf->k; i++) {
+    const u64 bit = (u64)1 << (pos % 64);
+    missing |= ~bf->items[pos / 64] & bit;
+    bf->items[pos / 64] |= bit;
+    pos += step;
+    pos -= bf->bits <= pos ? bf->bits : 0;
+  }
+  return missing != 0;
+}
+
+static bool bloom_classic_contains(const BloomFilter *bf, u64 hash) {
+  usize pos = hash % bf->bits;
+  const usize step = u64_mix(hash) % (bf->bits - 1) + 1;
+  for (usize i = 0; i < bf->k; i++) {
+    if (!(bf->items[pos / 64] & ((u64)1 << (pos % 64)))) {
+      return false;
+    }
+    pos += step;
+    pos -= bf->bits <= pos ? bf->bits : 0;
+  }
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+BloomFilter bloom_create(Arena *arena, usize expected, f64 fp_rate) {
+  return bloom_create_sized(arena, expected, fp_rate, false);
+}
+
+BloomFilter bloom_create_blocked(Arena *arena, usize expected, f64 fp_rate) {
+  return bloom_create_sized(arena, expected, fp_rate, true);
+}
+
+BloomFilter bloom_with_size(Arena *arena, usize bits, usize k, bool blocked) {
+  cebus_assert(k != 0, "The bloom filter needs at least one hash per member");
+  const usize align = blocked ? BLOOM_BLOCK_BITS : 64;
+  BloomFilter bf = {0};
+  bf.arena = arena;
+  bf.blocked = blocked;
+  bf.k = usize_min(k, blocked ? BLOOM_MAX_BLOCKED_K : BLOOM_MAX_K);
+  bf.bits = usize_max((bits + align - 1) / align * align, align);
+  cebus_assert(!blocked || bf.bits / BLOOM_BLOCK_BITS <= U32_MAX, "Too many blocks");
+  bf.items = arena_calloc_chunk(arena, bf.bits / 8);
+  return bf;
+}
+
+void bloom_clear(BloomFilter *bf) {
+  bf->count = 0;
+  memset(bf->items, 0, bf->bits / 8);
+}
+
+BloomFilter bloom_copy(Arena *arena, const BloomFilter *bf) {
+  BloomFilter new = bloom_with_size(arena, bf->bits, bf->k, bf->blocked);
+  memcpy(new.items, bf->items, bf->bits / 8);
+  new.count = bf->count;
+  return new;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool bloom_add(BloomFilter *bf, u64 hash) {
+  hash = u64_mix(hash);
+  const bool added = bf->blocked ? bloom_block_add(bf, hash) : bloom_classic_add(bf, hash);
+  bf->count += added;
+  return added;
+}
+
+void bloom_extend(BloomFilter *bf, usize count, const u64 *hashes) {
+  for (usize i = 0; i < count; i++) {
+    bloom_add(bf, hashes[i]);
+  }
+}
+
+bool bloom_contains(const BloomFilter *bf, u64 hash) {
+  hash = u64_mix(hash);
+  return bf->blocked ? bloom_block_contains(bf, hash) : bloom_classic_contains(bf, hash);
+}
+
+usize bloom_contains_batch(const BloomFilter *bf, usize count, const u64 *hashes, bool *result) {
+  usize found = 0;
+  u64 mixed[BLOOM_BATCH];
+  for (usize i = 0; i < count; i += BLOOM_BATCH) {
+    const usize n = usize_min(BLOOM_BATCH, count - i);
+    for (usize j = 0; j < n; j++) {
+      mixed[j] = u64_mix(hashes[i + j]);
+      if (bf->blocked) {
+        BLOOM_PREFETCH(bloom_block(bf, mixed[j]));
+      } else {
+        BLOOM_PREFETCH(&bf->items[mixed[j] % bf->bits / 64]);
+      }
+    }
+    for (usize j = 0; j < n; j++) {
+      const bool contains = bf->blocked ? bloom_block_contains(bf, mixed[j])
+                                        : bloom_classic_contains(bf, mixed[j]);
+      if (result) {
+        result[i + j] = contains;
+      }
+      found += contains;
+    }
+  }
+  return found;
+}
+
+void bloom_union(BloomFilter *bf, const BloomFilter *other) {
+  cebus_assert(bf->bits == other->bits && bf->k == other->k && bf->blocked == other->blocked,
+               "Bloom filters need the same parameters for a union");
+  for (usize i = 0; i < bf->bits / 64; i++) {
+    bf->items[i] |= other->items[i];
+  }
+  // Shared members would be counted twice, so the count is estimated from the
+  // number of set bits. The real count lies between the larger and the sum of
+  // both counts.
+  const usize sum = bf->count + other->count;
+  const usize low = usize_max(bf->count, other->count);
+  usize set = 0;
+  for (usize i = 0; i < bf->bits / 64; i++) {
+    set += u64_count_ones(bf->items[i]);
+  }
+  if (set == bf->bits) {
+    bf->count = sum;
+    return;
+  }
+  const f64 m = (f64)bf->bits;
+  const f64 estimate = -m / (f64)bf->k * f64_ln(1.0 - (f64)set / m);
+  bf->count = usize_min(usize_max((usize)(estimate + 0.5), low), sum);
+}
+
+f64 bloom_fp_rate(const BloomFilter *bf) {
+  return bf->blocked ? bloom_blocked_fp(bf->bits, bf->k, bf->count)
+                     : bloom_classic_fp(bf->bits, bf->k, bf->count);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef BLOOM_BLOCK_BITS
+#undef BLOOM_BLOCK_WORDS
+#undef BLOOM_MAX_K
+#undef BLOOM_MAX_BLOCKED_K
+#undef BLOOM_BATCH
+#undef BLOOM_PREFETCH
@@ -0,0 +1,94 @@
+/* DOCUMENTATION
+A `BloomFilter` answers the question "was this hash added?" with either
+"definitely not" or "probably yes". It only stores a few bits per member, so it
+is a lot smaller than a `Set`, which needs 8 bytes per member. Use it in front
+of a `Set`, `HashMap` or something more expensive to reject most of the
+candidates early.
+
+Like `Set` and `HashMap` it works on precomputed `u64` hashes.
+
+## Initialization
+
+The filter is sized from the expected number of members and the accepted
+false positive rate:
+
+```c
+Arena arena = {0};
+BloomFilter bf = bloom_create(&arena, 1000000, 0.01);
+```
+
+- `bloom_create`: Creates a classic bloom filter, the bits of one member are
+spread over the whole filter.
+- `bloom_create_blocked`: Creates a blocked bloom filter. All bits of a member
+are in a single 64 byte block, so every operation touches only one cache line.
+It is a lot faster for big filters, but needs a few more bits per member for
+the same false positive rate.
+- `bloom_with_size`: Creates a filter with an explicit number of bits and
+hashes per member.
+- `bloom_clear`: Removes all members.
+- `bloom_copy`: Creates a copy of the filter.
+
+## Operations
+
+- `bloom_add`: Adds a hash. Returns false if it was probably added before.
+- `bloom_extend`: Adds multiple hashes at once.
+- `bloom_contains`: Checks if the hash was probably added.
+- `bloom_contains_batch`: Checks multiple hashes at once and writes the results
+into an array. Returns how many of them were probably added. The memory of the
+next hashes is prefetched while the current ones are checked.
+- `bloom_union`: Adds all members of another filter. Both filters need to be
+created with the same parameters. Members of both filters are only counted
+once, so the new count is estimated from the number of set bits.
+- `bloom_fp_rate`: Estimates the false positive rate for the current number of
+members.
+
+```c
+bloom_add(&bf, str_hash(STR("hello")));
+if (bloom_contains(&bf, str_hash(STR("hello")))) {
+  // probably in the filter, now check the real set
+}
+```
+*/
+
+#ifndef __CEBUS_BLOOM_H__
+#define __CEBUS_BLOOM_H__
+
+#include "cebus/core/arena.h"
+#include "cebus/core/defines.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize bits;
+  usize k;
+  usize count;
+  bool blocked;
+  Arena *arena;
+  u64 *items;
+} BloomFilter;
+
+//////////////////////////////////////////////////////////////////////////////
+
+BloomFilter bloom_create(Arena *arena, usize expected, f64 fp_rate);
+BloomFilter bloom_create_blocked(Arena *arena, usize expected, f64 fp_rate);
+BloomFilter bloom_with_size(Arena *arena, usize bits, usize k, bool blocked);
+
+void bloom_clear(BloomFilter *bf);
+
+BloomFilter bloom_copy(Arena *arena, const BloomFilter *bf);
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool bloom_add(BloomFilter *bf, u64 hash);
+void bloom_extend(BloomFilter *bf, usize count, const u64 *hashes);
+
+bool bloom_contains(const BloomFilter *bf, u64 hash);
+usize bloom_contains_batch(const BloomFilter *bf, usize count, const u64 *hashes, bool *result);
+
+void bloom_union(BloomFilter *bf, const BloomFilter *other);
+
+f64 bloom_fp_rate(const BloomFilter *bf);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_BLOOM_H__ */
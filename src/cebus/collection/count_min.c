@@ -0,0 +1,100 @@
+#include "count_min.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/integer.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define CMS_MAX_DEPTH 32
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Every row uses its own hash function: h1 + row * h2.
+static void cms_indices(const CountMin *cms, u64 hash, usize *indices) {
+  const u64 h1 = u64_mix(hash);
+  const u64 h2 = u64_mix(h1) | 1;
+  for (usize row = 0; row < cms->depth; row++) {
+    indices[row] = row * cms->width + ((h1 + row * h2) & (cms->width - 1));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+CountMin cms_create(Arena *arena, f64 epsilon, f64 delta) {
+  cebus_assert(0 < epsilon && epsilon < 1, "epsilon has to be in (0, 1)");
+  cebus_assert(0 < delta && delta < 1, "delta has to be in (0, 1)");
+  // width = e / epsilon, depth = ln(1 / delta)
+  const usize width = (usize)(2.718281828459045 / epsilon) + 1;
+  usize depth = 1;
+  for (f64 p = 1 / 2.718281828459045; delta < p; p /= 2.718281828459045) {
+    depth++;
+  }
+  return cms_with_size(arena, width, depth);
+}
+
+CountMin cms_with_size(Arena *arena, usize width, usize depth) {
+  cebus_assert(0 < depth && depth <= CMS_MAX_DEPTH, "depth has to be in [1, %d]", CMS_MAX_DEPTH);
+  CountMin cms = {0};
+  cms.arena = arena;
+  cms.width = 1;
+  while (cms.width < width) {
+    cms.width *= 2;
+  }
+  cms.depth = depth;
+  cms.items = arena_calloc_chunk(arena, cms.width * cms.depth * sizeof(u64));
+  return cms;
+}
+
+void cms_clear(CountMin *cms) {
+  cms->total = 0;
+  memset(cms->items, 0, cms->width * cms->depth * sizeof(u64));
+}
+
+CountMin cms_copy(Arena *arena, const CountMin *cms) {
+  CountMin new = cms_with_size(arena, cms->width, cms->depth);
+  memcpy(new.items, cms->items, cms->width * cms->depth * sizeof(u64));
+  new.total = cms->total;
+  return new;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+u64 cms_add(CountMin *cms, u64 hash, u64 count) {
+  usize indices[CMS_MAX_DEPTH];
+  cms_indices(cms, hash, indices);
+  u64 estimate = U64_MAX;
+  for (usize row = 0; row < cms->depth; row++) {
+    estimate = u64_min(estimate, cms->items[indices[row]]);
+  }
+  estimate += count;
+  for (usize row = 0; row < cms->depth; row++) {
+    cms->items[indices[row]] = u64_max(cms->items[indices[row]], estimate);
+  }
+  cms->total += count;
+  return estimate;
+}
+
+u64 cms_estimate(const CountMin *cms, u64 hash) {
+  usize indices[CMS_MAX_DEPTH];
+  cms_indices(cms, hash, indices);
+  u64 estimate = U64_MAX;
+  for (usize row = 0; row < cms->depth; row++) {
+    estimate = u64_min(estimate, cms->items[indices[row]]);
+  }
+  return estimate;
+}
+
+void cms_merge(CountMin *cms, const CountMin *other) {
+  cebus_assert(cms->width == other->width && cms->depth == other->depth,
+               "Sketches need the same dimensions to be merged");
+  for (usize i = 0; i < cms->width * cms->depth; i++) {
+    cms->items[i] += other->items[i];
+  }
+  cms->total += other->total;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef CMS_MAX_DEPTH
@@ -0,0 +1,73 @@
+/* DOCUMENTATION
+`CountMin` is a Count-Min sketch. It estimates how often a hash was added to a
+stream with a fixed amount of memory. The estimate is never lower than the
+real count. With a width `w` and a depth `d` it overestimates by more than
+`e / w * total` with a probability of `e^-d`.
+
+The items are `u64` hashes, for example from `str_hash`. Every row derives its
+column from that one hash, so an item is never hashed more than once.
+
+## Initialization
+
+```c
+Arena arena = {0};
+// error of 0.1% of the total count with a probability of 99%
+CountMin cms = cms_create(&arena, 0.001, 0.01);
+```
+
+- `cms_create`: Creates a sketch from the accepted error (relative to the total
+count) and the probability to exceed it.
+- `cms_with_size`: Creates a sketch with an explicit width and depth. The width
+is rounded up to a power of two.
+- `cms_clear`: Resets all counters.
+- `cms_copy`: Creates a copy of the sketch.
+
+## Operations
+
+- `cms_add`: Adds `count` to the hash. It uses the conservative update: only
+the counters that are smaller than the new estimate are increased, which
+makes the estimates a lot more accurate. Returns the new estimate.
+- `cms_estimate`: Estimates how often the hash was added.
+- `cms_merge`: Adds all counters of another sketch with the same dimensions.
+
+```c
+cms_add(&cms, str_hash(word), 1);
+u64 count = cms_estimate(&cms, str_hash(word));
+```
+*/
+
+#ifndef __CEBUS_COUNT_MIN_H__
+#define __CEBUS_COUNT_MIN_H__
+
+#include "cebus/core/arena.h"
+#include "cebus/core/defines.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize width;
+  usize depth;
+  u64 total;
+  Arena *arena;
+  u64 *items;
+} CountMin;
+
+//////////////////////////////////////////////////////////////////////////////
+
+CountMin cms_create(Arena *arena, f64 epsilon, f64 delta);
+CountMin cms_with_size(Arena *arena, usize width, usize depth);
+
+void cms_clear(CountMin *cms);
+
+CountMin cms_copy(Arena *arena, const CountMin *cms);
+
+//////////////////////////////////////////////////////////////////////////////
+
+u64 cms_add(CountMin *cms, u64 hash, u64 count);
+u64 cms_estimate(const CountMin *cms, u64 hash);
+
+void cms_merge(CountMin *cms, const CountMin *other);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_COUNT_MIN_H__ */
@@ -10,6 +10,24 @@ Arena arena = {0};
 DA(int) vec = da_new(&arena);
 ```
 
+## Small Dynamic Arrays
+
+`SDA(T, N)` stores up to `N` elements inside of the struct and only allocates
+in the arena once it grows past that. Use it for arrays that are small most of
+the time. All `da_*` operations work on it.
+
+```c
+SDA(Str, 8) args = sda_new(&args, &arena);
+da_push(&args, STR("gcc"));
+```
+
+- `sda_new`: Initializer, that needs the address of the array itself.
+- `sda_init`: Initialize the small dynamic array.
+- `sda_is_inline`: Check if the elements are still stored inside of the struct.
+
+> :warning: While the elements are inline, `items` points into the struct
+itself. Do not copy or move the struct, pass a pointer to it instead.
+
 ## Adding Elements
 
 Elements can be added to the dynamic array using `da_push`, which automatically
@@ -49,7 +67,21 @@ int popped = da_pop(&vec);
 > :warning: These operations do not perform any bound checks.
 
 - `da_insert`: Insert a value at a specified index.
+- `da_insert_n`: Insert `count` values from an array at a specified index. The
+array must not point into the dynamic array itself.
 - `da_remove`: Remove a value at a specified index.
+- `da_remove_range`: Remove `count` values starting at a specified index.
+- `da_swap_remove`: Remove a value by replacing it with the last one. Does not
+keep the order, but does not need to move the other elements.
+- `da_retain`: Keep only the elements for which the predicate returns `true`.
+Compacts the array in place in one pass.
+- `da_retain_ctx`: Same but the predicate also takes a context.
+
+```c
+da_insert_n(&vec, 3, ((int[]){1, 2, 3}), 0);
+da_remove_range(&vec, 0, 2);
+da_retain(&vec, is_even);
+```
 
 ## Resizing and Reserving Space
 
@@ -70,6 +102,50 @@ destination.
 `void*` as a context, and place it into a destination.
 - `da_sort`: Sort the array using a comparison function.
 - `da_reverse`: Reverse the order of elements in the array.
+
+## Sorting
+
+`da_sort` calls the comparison function through a pointer for every
+comparison. The following macros inline the comparison instead, which is a lot
+faster for big arrays.
+
+- `da_sort_by(list, T, less)`: Sorts the array with introsort. `less` is an
+expression that compares the items `const T *a` and `const T *b`.
+- `da_sort_stable_by(list, T, less)`: Same but keeps the order of equal items.
+Needs a temporary buffer of the size of the array.
+- `da_radix_sort_u64(list, key)`: Stable radix sort by a `u64` key. `key` is a
+function or macro that takes an item and returns its key. Signed or floating
+point keys have to be mapped to an unsigned key that keeps the order.
+
+```c
+da_sort_by(&vec, int, *a < *b);
+da_sort_stable_by(&people, Person, a->age < b->age);
+#define PERSON_ID(p) ((p).id)
+da_radix_sort_u64(&people, PERSON_ID);
+```
+## Sorted Arrays
+
+These macros work on arrays sorted by the same `less` expression as
+`da_sort_by`. The key is a value of type `T` and the result is written into
+the `usize` variable `idx`.
+
+- `da_lower_bound(list, T, key, idx, less)`: Index of the first item that is
+not less than `key`, or the length.
+- `da_upper_bound(list, T, key, idx, less)`: Index of the first item that is
+greater than `key`, or the length.
+- `da_bsearch(list, T, key, idx, less)`: Index of an item equal to `key`, or
+`DA_NOT_FOUND`.
+- `da_unique(list, T, less)`: Removes all but the first of equal items.
+- `da_merge_sorted(first, second, dest, T, less)`: Appends the items of both
+arrays to `dest` in sorted order. `dest` must not be one of them.
+
+```c
+usize idx;
+da_bsearch(&vec, int, 42, idx, *a < *b);
+if (idx != DA_NOT_FOUND) {
+  // found
+}
+```
 */
 
 #ifndef __CEBUS_DA_H__
@@ -78,7 +154,9 @@ destination.
 #include "cebus/core/arena.h"   // IWYU pragma: export
 #include "cebus/core/defines.h" // IWYU pragma: export
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -101,6 +179,8 @@ destination.
 
 #define DA_ARG(da) (da)->len, (da)->items
 
+#define DA_NOT_FOUND ((usize)-1)
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define da_new(_arena)                                                                             \
@@ -132,6 +212,35 @@ destination.
     da_init_list(list, _arena, ARRAY_LEN((__VA_ARGS__)), (__VA_ARGS__));                           \
   } while (0)
 
+// Small dynamic array, that stores up to N items inside of the struct. The
+// items only move into the arena once it grows past that.
+#define SDA(T, N)                                                                                  \
+  struct {                                                                                         \
+    usize cap;                                                                                     \
+    usize len;                                                                                     \
+    Arena *arena;                                                                                  \
+    T *items;                                                                                      \
+    T inline_items[N];                                                                             \
+  }
+
+#define sda_new(list, _arena)                                                                      \
+  {                                                                                                \
+    .cap = ARRAY_LEN((list)->inline_items), .arena = (_arena), .items = (list)->inline_items,      \
+  }
+
+#define sda_init(list, _arena)                                                                     \
+  do {                                                                                             \
+    (list)->len = 0;                                                                               \
+    (list)->cap = ARRAY_LEN((list)->inline_items);                                                 \
+    (list)->arena = _arena;                                                                        \
+    (list)->items = (list)->inline_items;                                                          \
+  } while (0)
+
+// Checks if the items point into the struct itself. Always false for 'DA'.
+#define sda_is_inline(list)                                                                        \
+  ((list)->items != NULL &&                                                                        \
+   (uintptr_t)(const void *)(list)->items - (uintptr_t)(const void *)(list) < sizeof(*(list)))
+
 #define da_copy(src, dest)                                                                         \
   do {                                                                                             \
     da_resize((dest), (src)->len);                                                                 \
@@ -145,7 +254,14 @@ destination.
 
 #define da_resize(list, size)                                                                      \
   do {                                                                                             \
-    if (size < (list)->cap) {                                                                      \
+    if ((size) <= (list)->cap) {                                                                   \
+      break;                                                                                       \
+    }                                                                                              \
+    if (sda_is_inline(list)) {                                                                     \
+      void *const __rz_items = arena_alloc_chunk((list)->arena, (size) * sizeof(*(list)->items));  \
+      memcpy(__rz_items, (list)->items, (list)->len * sizeof(*(list)->items));                     \
+      (list)->items = __rz_items;                                                                  \
+      (list)->cap = (size);                                                                        \
       break;                                                                                       \
     }                                                                                              \
     (list)->cap = size;                                                                            \
@@ -156,7 +272,7 @@ destination.
 #define da_reserve(list, size)                                                                     \
   do {                                                                                             \
     const usize __rs = da_len(list) + size;                                                        \
-    if (__rs < (list)->cap) {                                                                      \
+    if (__rs <= (list)->cap) {                                                                     \
       break;                                                                                       \
     }                                                                                              \
     usize __ns = (list)->cap == 0 ? 5 : (list)->cap;                                               \
@@ -194,22 +310,82 @@ destination.
 
 #define da_insert(list, value, idx)                                                                \
   do {                                                                                             \
+    const usize __in_idx = (idx);                                                                  \
     da_reserve(list, 1);                                                                           \
-    for (usize __r_i = idx + 1; __r_i < da_len(list) + 1; __r_i++) {                               \
-      da_get(list, __r_i) = da_get(list, __r_i - 1);                                               \
-    }                                                                                              \
-    da_get(list, idx) = value;                                                                     \
+    memmove(&da_get(list, __in_idx + 1), &da_get(list, __in_idx),                                  \
+            (da_len(list) - __in_idx) * sizeof((list)->items[0]));                                 \
+    da_get(list, __in_idx) = value;                                                                \
     da_len(list)++;                                                                                \
   } while (0)
 
+#define da_insert_n(list, count, array, idx)                                                       \
+  do {                                                                                             \
+    const usize __in_idx = (idx);                                                                  \
+    const usize __in_count = (count);                                                              \
+    da_reserve(list, __in_count);                                                                  \
+    memmove(&da_get(list, __in_idx + __in_count), &da_get(list, __in_idx),                         \
+            (da_len(list) - __in_idx) * sizeof((list)->items[0]));                                 \
+    memcpy(&da_get(list, __in_idx), (array), __in_count * sizeof((list)->items[0]));               \
+    da_len(list) += __in_count;                                                                    \
+  } while (0)
+
 #define da_remove(list, idx)                                                                       \
   do {                                                                                             \
-    for (usize __r_i = idx + 1; __r_i < da_len(list); __r_i++) {                                   \
-      da_get(list, __r_i - 1) = da_get(list, __r_i);                                               \
-    }                                                                                              \
+    const usize __r_idx = (idx);                                                                   \
+    memmove(&da_get(list, __r_idx), &da_get(list, __r_idx + 1),                                    \
+            (da_len(list) - __r_idx - 1) * sizeof((list)->items[0]));                              \
     da_len(list)--;                                                                                \
   } while (0)
 
+#define da_remove_range(list, idx, count)                                                          \
+  do {                                                                                             \
+    const usize __r_idx = (idx);                                                                   \
+    const usize __r_count = (count);                                                               \
+    memmove(&da_get(list, __r_idx), &da_get(list, __r_idx + __r_count),                            \
+            (da_len(list) - __r_idx - __r_count) * sizeof((list)->items[0]));                      \
+    da_len(list) -= __r_count;                                                                     \
+  } while (0)
+
+#define da_swap_remove(list, idx)                                                                  \
+  do {                                                                                             \
+    const usize __r_idx = (idx);                                                                   \
+    da_get(list, __r_idx) = da_get(list, da_len(list) - 1);                                        \
+    da_len(list)--;                                                                                \
+  } while (0)
+
+// Moves every run of kept elements with one memmove, short runs are copied
+// directly. The run is moved when the first element after it is removed, or
+// after the last element.
+#define _da_retain(list, keep)                                                                     \
+  do {                                                                                             \
+    usize __rt_w = 0;                                                                              \
+    usize __rt_start = 0;                                                                          \
+    const usize __rt_n = da_len(list);                                                             \
+    for (usize __rt_r = 0; __rt_r <= __rt_n; __rt_r++) {                                           \
+      if (__rt_r < __rt_n && (keep)) {                                                             \
+        continue;                                                                                  \
+      }                                                                                            \
+      if (__rt_w == __rt_start) {                                                                  \
+        __rt_w = __rt_r;                                                                           \
+      } else if (__rt_r - __rt_start < 8) {                                                        \
+        for (usize __rt_i = __rt_start; __rt_i < __rt_r; __rt_i++) {                               \
+          da_get(list, __rt_w++) = da_get(list, __rt_i);                                           \
+        }                                                                                          \
+      } else {                                                                                     \
+        memmove(&da_get(list, __rt_w), &da_get(list, __rt_start),                                  \
+                (__rt_r - __rt_start) * sizeof((list)->items[0]));                                 \
+        __rt_w += __rt_r - __rt_start;                                                             \
+      }                                                                                            \
+      __rt_start = __rt_r + 1;                                                                     \
+    }                                                                                              \
+    da_len(list) = __rt_w;                                                                         \
+  } while (0)
+
+#define da_retain(list, predicate) _da_retain(list, predicate(da_get(list, __rt_r)))
+
+#define da_retain_ctx(list, predicate, ctx)                                                        \
+  _da_retain(list, predicate((ctx), da_get(list, __rt_r)))
+
 ///////////////////////////////////////////////////////////////////////////////
 
 #define da_map(src, dest, map)                                                                     \
@@ -256,6 +432,322 @@ destination.
 
 #define da_sort(src, sort) qsort(&da_get(src, 0), da_len(src), sizeof((src)->items[0]), sort)
 
+// Evaluates the comparison expression with 'a' and 'b' pointing to the items.
+#define _da_less(T, result, x, y, ...)                                                             \
+  do {                                                                                             \
+    const T *a = (x);                                                                              \
+    const T *b = (y);                                                                              \
+    (void)a;                                                                                       \
+    (void)b;                                                                                       \
+    (result) = (__VA_ARGS__);                                                                      \
+  } while (0)
+
+#define _da_swap(T, x, y)                                                                          \
+  do {                                                                                             \
+    T __sw_t = (x);                                                                                \
+    (x) = (y);                                                                                     \
+    (y) = __sw_t;                                                                                  \
+  } while (0)
+
+// Stable insertion sort of [lo, hi).
+#define _da_insertion_sort(T, items, lo, hi, ...)                                                  \
+  do {                                                                                             \
+    for (usize __is_i = (lo) + 1; __is_i < (hi); __is_i++) {                                       \
+      T __is_v = (items)[__is_i];                                                                  \
+      usize __is_j = __is_i;                                                                       \
+      for (; (lo) < __is_j; __is_j--) {                                                            \
+        bool __is_lt;                                                                              \
+        _da_less(T, __is_lt, &__is_v, &(items)[__is_j - 1], __VA_ARGS__);                          \
+        if (!__is_lt) {                                                                            \
+          break;                                                                                   \
+        }                                                                                          \
+        (items)[__is_j] = (items)[__is_j - 1];                                                     \
+      }                                                                                            \
+      (items)[__is_j] = __is_v;                                                                    \
+    }                                                                                              \
+  } while (0)
+
+// Heapsort of [lo, hi). The first 'n / 2' steps build the heap, the other 'n'
+// steps move the biggest item to the end.
+#define _da_heap_sort(T, items, lo, hi, ...)                                                       \
+  do {                                                                                             \
+    T *__hs_h = &(items)[lo];                                                                      \
+    const usize __hs_n = (hi) - (lo);                                                              \
+    for (usize __hs_s = __hs_n + __hs_n / 2; __hs_s-- > 0;) {                                      \
+      usize __hs_root = 0;                                                                         \
+      usize __hs_end = __hs_n;                                                                     \
+      if (__hs_s < __hs_n) {                                                                       \
+        _da_swap(T, __hs_h[0], __hs_h[__hs_s]);                                                    \
+        __hs_end = __hs_s;                                                                         \
+      } else {                                                                                     \
+        __hs_root = __hs_s - __hs_n;                                                               \
+      }                                                                                            \
+      for (usize __hs_c = __hs_root * 2 + 1; __hs_c < __hs_end; __hs_c = __hs_root * 2 + 1) {      \
+        bool __hs_lt;                                                                              \
+        if (__hs_c + 1 < __hs_end) {                                                               \
+          _da_less(T, __hs_lt, &__hs_h[__hs_c], &__hs_h[__hs_c + 1], __VA_ARGS__);                 \
+          __hs_c += __hs_lt;                                                                       \
+        }                                                                                          \
+        _da_less(T, __hs_lt, &__hs_h[__hs_root], &__hs_h[__hs_c], __VA_ARGS__);                    \
+        if (!__hs_lt) {                                                                            \
+          break;                                                                                   \
+        }                                                                                          \
+        _da_swap(T, __hs_h[__hs_root], __hs_h[__hs_c]);                                            \
+        __hs_root = __hs_c;                                                                        \
+      }                                                                                            \
+    }                                                                                              \
+  } while (0)
+
+#define DA_SORT_INSERTION_SIZE 16
+
+// Introsort: quicksort with a median of three pivot, that falls back to
+// heapsort if the partitions get too unbalanced. Partitions smaller than
+// 'DA_SORT_INSERTION_SIZE' are left alone and sorted by one insertion sort at
+// the end.
+#define da_sort_by(list, T, ...)                                                                   \
+  do {                                                                                             \
+    T *const __qs_items = (list)->items;                                                           \
+    usize __qs_stack[64 * 3];                                                                      \
+    usize __qs_top = 0;                                                                            \
+    usize __qs_depth = 0;                                                                          \
+    for (usize __qs_n = da_len(list); 1 < __qs_n; __qs_n >>= 1) {                                  \
+      __qs_depth += 2;                                                                             \
+    }                                                                                              \
+    __qs_stack[__qs_top++] = 0;                                                                    \
+    __qs_stack[__qs_top++] = da_len(list);                                                         \
+    __qs_stack[__qs_top++] = __qs_depth;                                                           \
+    while (__qs_top) {                                                                             \
+      usize __qs_d = __qs_stack[--__qs_top];                                                       \
+      usize __qs_hi = __qs_stack[--__qs_top];                                                      \
+      usize __qs_lo = __qs_stack[--__qs_top];                                                      \
+      while (DA_SORT_INSERTION_SIZE < __qs_hi - __qs_lo) {                                         \
+        if (__qs_d-- == 0) {                                                                       \
+          _da_heap_sort(T, __qs_items, __qs_lo, __qs_hi, __VA_ARGS__);                             \
+          break;                                                                                   \
+        }                                                                                          \
+        bool __qs_lt;                                                                              \
+        const usize __qs_mid = __qs_lo + (__qs_hi - __qs_lo) / 2;                                  \
+        _da_less(T, __qs_lt, &__qs_items[__qs_mid], &__qs_items[__qs_lo], __VA_ARGS__);            \
+        if (__qs_lt) {                                                                             \
+          _da_swap(T, __qs_items[__qs_mid], __qs_items[__qs_lo]);                                  \
+        }                                                                                          \
+        _da_less(T, __qs_lt, &__qs_items[__qs_hi - 1], &__qs_items[__qs_mid], __VA_ARGS__);        \
+        if (__qs_lt) {                                                                             \
+          _da_swap(T, __qs_items[__qs_hi - 1], __qs_items[__qs_mid]);                              \
+          _da_less(T, __qs_lt, &__qs_items[__qs_mid], &__qs_items[__qs_lo], __VA_ARGS__);          \
+          if (__qs_lt) {                                                                           \
+            _da_swap(T, __qs_items[__qs_mid], __qs_items[__qs_lo]);                                \
+          }                                                                                        \
+        }                                                                                          \
+        const T __qs_pivot = __qs_items[__qs_mid];                                                 \
+        usize __qs_i = __qs_lo;                                                                    \
+        usize __qs_j = __qs_hi - 1;                                                                \
+        while (true) {                                                                             \
+          do {                                                                                     \
+            __qs_i++;                                                                              \
+            _da_less(T, __qs_lt, &__qs_items[__qs_i], &__qs_pivot, __VA_ARGS__);                   \
+          } while (__qs_lt);                                                                       \
+          do {                                                                                     \
+            __qs_j--;                                                                              \
+            _da_less(T, __qs_lt, &__qs_pivot, &__qs_items[__qs_j], __VA_ARGS__);                   \
+          } while (__qs_lt);                                                                       \
+          if (__qs_j <= __qs_i) {                                                                  \
+            break;                                                                                 \
+          }                                                                                        \
+          _da_swap(T, __qs_items[__qs_i], __qs_items[__qs_j]);                                     \
+        }                                                                                          \
+        /* continue with the smaller partition, so the stack stays small */                        \
+        if (__qs_i - __qs_lo < __qs_hi - __qs_i) {                                                 \
+          __qs_stack[__qs_top++] = __qs_i;                                                         \
+          __qs_stack[__qs_top++] = __qs_hi;                                                        \
+          __qs_stack[__qs_top++] = __qs_d;                                                         \
+          __qs_hi = __qs_i;                                                                        \
+        } else {                                                                                   \
+          __qs_stack[__qs_top++] = __qs_lo;                                                        \
+          __qs_stack[__qs_top++] = __qs_i;                                                         \
+          __qs_stack[__qs_top++] = __qs_d;                                                         \
+          __qs_lo = __qs_i;                                                                        \
+        }                                                                                          \
+      }                                                                                            \
+    }                                                                                              \
+    _da_insertion_sort(T, __qs_items, (usize)0, da_len(list), __VA_ARGS__);                        \
+  } while (0)
+
+// Bottom up merge sort. Sorts runs of 'DA_SORT_INSERTION_SIZE' with insertion
+// sort and then merges them between the array and a temporary buffer.
+#define da_sort_stable_by(list, T, ...)                                                            \
+  do {                                                                                             \
+    const usize __ms_n = da_len(list);                                                             \
+    if (__ms_n <= 1) {                                                                             \
+      break;                                                                                       \
+    }                                                                                              \
+    T *__ms_src = (list)->items;                                                                   \
+    T *__ms_dst = arena_alloc_chunk((list)->arena, __ms_n * sizeof(T));                            \
+    T *const __ms_temp = __ms_dst;                                                                 \
+    for (usize __ms_lo = 0; __ms_lo < __ms_n; __ms_lo += DA_SORT_INSERTION_SIZE) {                 \
+      const usize __ms_hi =                                                                        \
+          __ms_n - __ms_lo < DA_SORT_INSERTION_SIZE ? __ms_n : __ms_lo + DA_SORT_INSERTION_SIZE;   \
+      _da_insertion_sort(T, __ms_src, __ms_lo, __ms_hi, __VA_ARGS__);                              \
+    }                                                                                              \
+    for (usize __ms_w = DA_SORT_INSERTION_SIZE; __ms_w < __ms_n; __ms_w *= 2) {                    \
+      for (usize __ms_lo = 0; __ms_lo < __ms_n; __ms_lo += 2 * __ms_w) {                           \
+        const usize __ms_mid = __ms_n - __ms_lo < __ms_w ? __ms_n : __ms_lo + __ms_w;              \
+        const usize __ms_hi = __ms_n - __ms_mid < __ms_w ? __ms_n : __ms_mid + __ms_w;             \
+        usize __ms_i = __ms_lo;                                                                    \
+        usize __ms_j = __ms_mid;                                                                   \
+        usize __ms_k = __ms_lo;                                                                    \
+        while (__ms_i < __ms_mid && __ms_j < __ms_hi) {                                            \
+          bool __ms_lt;                                                                            \
+          _da_less(T, __ms_lt, &__ms_src[__ms_j], &__ms_src[__ms_i], __VA_ARGS__);                 \
+          __ms_dst[__ms_k++] = __ms_lt ? __ms_src[__ms_j++] : __ms_src[__ms_i++];                  \
+        }                                                                                          \
+        while (__ms_i < __ms_mid) {                                                                \
+          __ms_dst[__ms_k++] = __ms_src[__ms_i++];                                                 \
+        }                                                                                          \
+        while (__ms_j < __ms_hi) {                                                                 \
+          __ms_dst[__ms_k++] = __ms_src[__ms_j++];                                                 \
+        }                                                                                          \
+      }                                                                                            \
+      T *__ms_swap = __ms_src;                                                                     \
+      __ms_src = __ms_dst;                                                                         \
+      __ms_dst = __ms_swap;                                                                        \
+    }                                                                                              \
+    if (__ms_src != (list)->items) {                                                               \
+      memcpy((list)->items, __ms_src, __ms_n * sizeof(T));                                         \
+    }                                                                                              \
+    arena_free_chunk((list)->arena, __ms_temp);                                                    \
+  } while (0)
+
+// LSD radix sort over the 'u64' key of every item, one byte per pass. Passes
+// where all keys have the same byte are skipped. The sort is stable.
+#define da_radix_sort_u64(list, key)                                                               \
+  do {                                                                                             \
+    const usize __rx_n = da_len(list);                                                             \
+    const usize __rx_size = sizeof((list)->items[0]);                                              \
+    if (__rx_n <= 1) {                                                                             \
+      break;                                                                                       \
+    }                                                                                              \
+    usize __rx_counts[8][256] = {0};                                                               \
+    for (usize __rx_i = 0; __rx_i < __rx_n; __rx_i++) {                                            \
+      const u64 __rx_key = key((list)->items[__rx_i]);                                             \
+      for (usize __rx_d = 0; __rx_d < 8; __rx_d++) {                                               \
+        __rx_counts[__rx_d][(__rx_key >> (__rx_d * 8)) & 0xff]++;                                  \
+      }                                                                                            \
+    }                                                                                              \
+    void *const __rx_items = (list)->items;                                                        \
+    void *const __rx_temp = arena_alloc_chunk((list)->arena, __rx_n * __rx_size);                  \
+    void *__rx_dst = __rx_temp;                                                                    \
+    for (usize __rx_d = 0; __rx_d < 8; __rx_d++) {                                                 \
+      usize *__rx_offsets = __rx_counts[__rx_d];                                                   \
+      if (__rx_offsets[(key((list)->items[0]) >> (__rx_d * 8)) & 0xff] == __rx_n) {                \
+        continue;                                                                                  \
+      }                                                                                            \
+      for (usize __rx_b = 0, __rx_sum = 0; __rx_b < 256; __rx_b++) {                               \
+        const usize __rx_c = __rx_offsets[__rx_b];                                                 \
+        __rx_offsets[__rx_b] = __rx_sum;                                                           \
+        __rx_sum += __rx_c;                                                                        \
+      }                                                                                            \
+      for (usize __rx_i = 0; __rx_i < __rx_n; __rx_i++) {                                          \
+        const usize __rx_b = (usize)((key((list)->items[__rx_i]) >> (__rx_d * 8)) & 0xff);         \
+        memcpy((u8 *)__rx_dst + __rx_offsets[__rx_b]++ * __rx_size, &(list)->items[__rx_i],        \
+               __rx_size);                                                                         \
+      }                                                                                            \
+      void *__rx_src = (list)->items;                                                              \
+      (list)->items = __rx_dst;                                                                    \
+      __rx_dst = __rx_src;                                                                         \
+    }                                                                                              \
+    if ((void *)(list)->items != __rx_items) {                                                     \
+      memcpy(__rx_items, (list)->items, __rx_n * __rx_size);                                       \
+      (list)->items = __rx_items;                                                                  \
+    }                                                                                              \
+    arena_free_chunk((list)->arena, __rx_temp);                                                    \
+  } while (0)
+
+// Branchless binary search: the range only shrinks by moving its start, so the
+// compiler emits a conditional move instead of a hard to predict branch.
+#define _da_search(list, T, key, idx, upper, ...)                                                  \
+  do {                                                                                             \
+    const T __bs_key = (key);                                                                      \
+    const T *__bs_base = (list)->items;                                                            \
+    usize __bs_n = da_len(list);                                                                   \
+    bool __bs_lt = false;                                                                          \
+    if (__bs_n == 0) {                                                                             \
+      (idx) = 0;                                                                                   \
+      break;                                                                                       \
+    }                                                                                              \
+    while (1 < __bs_n) {                                                                           \
+      const usize __bs_half = __bs_n / 2;                                                          \
+      if (upper) {                                                                                 \
+        _da_less(T, __bs_lt, &__bs_key, &__bs_base[__bs_half], __VA_ARGS__);                       \
+        __bs_lt = !__bs_lt;                                                                        \
+      } else {                                                                                     \
+        _da_less(T, __bs_lt, &__bs_base[__bs_half], &__bs_key, __VA_ARGS__);                       \
+      }                                                                                            \
+      __bs_base = __bs_lt ? __bs_base + __bs_half : __bs_base;                                     \
+      __bs_n -= __bs_half;                                                                         \
+    }                                                                                              \
+    if (upper) {                                                                                   \
+      _da_less(T, __bs_lt, &__bs_key, __bs_base, __VA_ARGS__);                                     \
+      __bs_lt = !__bs_lt;                                                                          \
+    } else {                                                                                       \
+      _da_less(T, __bs_lt, __bs_base, &__bs_key, __VA_ARGS__);                                     \
+    }                                                                                              \
+    (idx) = (usize)(__bs_base - (list)->items) + __bs_lt;                                          \
+  } while (0)
+
+#define da_lower_bound(list, T, key, idx, ...) _da_search(list, T, key, idx, false, __VA_ARGS__)
+#define da_upper_bound(list, T, key, idx, ...) _da_search(list, T, key, idx, true, __VA_ARGS__)
+
+#define da_bsearch(list, T, key, idx, ...)                                                         \
+  do {                                                                                             \
+    const T __bf_key = (key);                                                                      \
+    usize __bf_idx;                                                                                \
+    da_lower_bound(list, T, __bf_key, __bf_idx, __VA_ARGS__);                                      \
+    bool __bf_gt = true;                                                                           \
+    if (__bf_idx < da_len(list)) {                                                                 \
+      _da_less(T, __bf_gt, &__bf_key, &da_get(list, __bf_idx), __VA_ARGS__);                       \
+    }                                                                                              \
+    (idx) = __bf_gt ? DA_NOT_FOUND : __bf_idx;                                                     \
+  } while (0)
+
+// Keeps the first item of every run of equal items.
+#define da_unique(list, T, ...)                                                                    \
+  do {                                                                                             \
+    const usize __uq_n = da_len(list);                                                             \
+    usize __uq_w = __uq_n ? 1 : 0;                                                                 \
+    for (usize __uq_r = 1; __uq_r < __uq_n; __uq_r++) {                                            \
+      bool __uq_lt;                                                                                \
+      _da_less(T, __uq_lt, &da_get(list, __uq_w - 1), &da_get(list, __uq_r), __VA_ARGS__);         \
+      if (__uq_lt) {                                                                               \
+        da_get(list, __uq_w++) = da_get(list, __uq_r);                                             \
+      }                                                                                            \
+    }                                                                                              \
+    da_len(list) = __uq_w;                                                                         \
+  } while (0)
+
+// Takes from 'a' on ties, so the merge is stable.
+#define da_merge_sorted(first, second, dest, T, ...)                                               \
+  do {                                                                                             \
+    const usize __mg_n = da_len(first);                                                            \
+    const usize __mg_m = da_len(second);                                                           \
+    da_reserve((dest), __mg_n + __mg_m);                                                           \
+    T *__mg_out = &da_get(dest, da_len(dest));                                                     \
+    usize __mg_i = 0;                                                                              \
+    usize __mg_j = 0;                                                                              \
+    while (__mg_i < __mg_n && __mg_j < __mg_m) {                                                   \
+      bool __mg_lt;                                                                                \
+      _da_less(T, __mg_lt, &da_get(second, __mg_j), &da_get(first, __mg_i), __VA_ARGS__);          \
+      *__mg_out++ = __mg_lt ? da_get(second, __mg_j++) : da_get(first, __mg_i++);                  \
+    }                                                                                              \
+    while (__mg_i < __mg_n) {                                                                      \
+      *__mg_out++ = da_get(first, __mg_i++);                                                       \
+    }                                                                                              \
+    while (__mg_j < __mg_m) {                                                                      \
+      *__mg_out++ = da_get(second, __mg_j++);                                                      \
+    }                                                                                              \
+    da_len(dest) += __mg_n + __mg_m;                                                               \
+  } while (0)
+
 #define da_reverse(list)                                                                           \
   do {                                                                                             \
     da_reserve((list), 1);                                                                         \
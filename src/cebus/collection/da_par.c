@@ -0,0 +1,300 @@
+#include "da_par.h"
+
+#include "cebus/core/arena.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+// The chunks only depend on the number of items, never on the number of
+// threads, so every pool computes the same result.
+#define DA_PAR_MIN_CHUNK 1024
+#define DA_PAR_MAX_TASKS 256
+// Sorting uses a power of two number of runs, so they can be merged in pairs.
+#define DA_PAR_MIN_RUN 4096
+#define DA_PAR_MAX_RUNS 64
+
+static usize da_par_tasks(usize count) {
+  usize chunk = (count + DA_PAR_MAX_TASKS - 1) / DA_PAR_MAX_TASKS;
+  chunk = chunk < DA_PAR_MIN_CHUNK ? DA_PAR_MIN_CHUNK : chunk;
+  return (count + chunk - 1) / chunk;
+}
+
+// Start of part 'idx' if 'count' items are split into 'parts' parts.
+static usize da_par_bound(usize count, usize parts, usize idx) {
+  return count / parts * idx + count % parts * idx / parts;
+}
+
+// Copies one item. The common sizes get a copy with a constant size, that the
+// compiler turns into a single move instead of a call.
+static inline void da_par_copy(u8 *dest, const u8 *src, usize size) {
+  switch (size) {
+  case sizeof(u32):
+    memcpy(dest, src, sizeof(u32));
+    break;
+  case sizeof(u64):
+    memcpy(dest, src, sizeof(u64));
+    break;
+  default:
+    memcpy(dest, src, size);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize count;
+  usize tasks;
+  const u8 *src;
+  usize src_size;
+  u8 *dest;
+  usize dest_size;
+  // only one of them is set
+  void (*map)(const void *item, void *out);
+  void (*map_ctx)(void *ctx, const void *item, void *out);
+  void *ctx;
+} DaParMap;
+
+static void da_par_map_task(void *ctx, usize task) {
+  const DaParMap *m = ctx;
+  const usize begin = da_par_bound(m->count, m->tasks, task);
+  const usize end = da_par_bound(m->count, m->tasks, task + 1);
+  if (m->map_ctx) {
+    for (usize i = begin; i < end; i++) {
+      m->map_ctx(m->ctx, &m->src[i * m->src_size], &m->dest[i * m->dest_size]);
+    }
+  } else {
+    for (usize i = begin; i < end; i++) {
+      m->map(&m->src[i * m->src_size], &m->dest[i * m->dest_size]);
+    }
+  }
+}
+
+void _da_par_map(ThreadPool *pool, usize count, const void *src, usize src_size, void *dest,
+                 usize dest_size, void (*map)(const void *item, void *out)) {
+  DaParMap m = {
+      .count = count,
+      .tasks = da_par_tasks(count),
+      .src = src,
+      .src_size = src_size,
+      .dest = dest,
+      .dest_size = dest_size,
+      .map = map,
+  };
+  thread_pool_run(pool, m.tasks, da_par_map_task, &m);
+}
+
+void _da_par_map_ctx(ThreadPool *pool, usize count, const void *src, usize src_size, void *dest,
+                     usize dest_size, void (*map)(void *ctx, const void *item, void *out),
+                     void *ctx) {
+  DaParMap m = {
+      .count = count,
+      .tasks = da_par_tasks(count),
+      .src = src,
+      .src_size = src_size,
+      .dest = dest,
+      .dest_size = dest_size,
+      .map_ctx = map,
+      .ctx = ctx,
+  };
+  thread_pool_run(pool, m.tasks, da_par_map_task, &m);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize count;
+  usize tasks;
+  const u8 *src;
+  u8 *dest;
+  usize size;
+  // only one of them is set
+  bool (*filter)(const void *item);
+  bool (*filter_ctx)(void *ctx, const void *item);
+  void *ctx;
+  bool *keep;
+  // number of kept items per chunk, then the offset of every chunk in 'dest'
+  usize *offsets;
+} DaParFilter;
+
+static void da_par_filter_count(void *ctx, usize task) {
+  DaParFilter *f = ctx;
+  const usize end = da_par_bound(f->count, f->tasks, task + 1);
+  usize kept = 0;
+  for (usize i = da_par_bound(f->count, f->tasks, task); i < end; i++) {
+    const u8 *item = &f->src[i * f->size];
+    f->keep[i] = f->filter_ctx ? f->filter_ctx(f->ctx, item) : f->filter(item);
+    kept += f->keep[i];
+  }
+  f->offsets[task] = kept;
+}
+
+static void da_par_filter_copy(void *ctx, usize task) {
+  const DaParFilter *f = ctx;
+  const usize end = da_par_bound(f->count, f->tasks, task + 1);
+  u8 *out = &f->dest[f->offsets[task] * f->size];
+  for (usize i = da_par_bound(f->count, f->tasks, task); i < end; i++) {
+    if (f->keep[i]) {
+      da_par_copy(out, &f->src[i * f->size], f->size);
+      out += f->size;
+    }
+  }
+}
+
+static usize da_par_filter_run(ThreadPool *pool, DaParFilter f) {
+  if (f.count == 0) {
+    return 0;
+  }
+  Arena scratch = {0};
+  f.tasks = da_par_tasks(f.count);
+  f.keep = arena_alloc(&scratch, f.count * sizeof(bool));
+  f.offsets = arena_alloc(&scratch, f.tasks * sizeof(usize));
+
+  thread_pool_run(pool, f.tasks, da_par_filter_count, &f);
+  usize total = 0;
+  for (usize task = 0; task < f.tasks; task++) {
+    const usize kept = f.offsets[task];
+    f.offsets[task] = total;
+    total += kept;
+  }
+  thread_pool_run(pool, f.tasks, da_par_filter_copy, &f);
+
+  arena_free(&scratch);
+  return total;
+}
+
+usize _da_par_filter(ThreadPool *pool, usize count, const void *src, void *dest, usize size,
+                     bool (*filter)(const void *item)) {
+  DaParFilter f = {.count = count, .src = src, .dest = dest, .size = size, .filter = filter};
+  return da_par_filter_run(pool, f);
+}
+
+usize _da_par_filter_ctx(ThreadPool *pool, usize count, const void *src, void *dest, usize size,
+                         bool (*filter)(void *ctx, const void *item), void *ctx) {
+  DaParFilter f = {
+      .count = count,
+      .src = src,
+      .dest = dest,
+      .size = size,
+      .filter_ctx = filter,
+      .ctx = ctx,
+  };
+  return da_par_filter_run(pool, f);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize count;
+  usize runs;
+  usize size;
+  CompareFn compare;
+  u8 *src;
+  u8 *dest;
+  // number of runs in each half of a merge
+  usize width;
+} DaParSort;
+
+static void da_par_sort_run(void *ctx, usize task) {
+  const DaParSort *s = ctx;
+  const usize begin = da_par_bound(s->count, s->runs, task);
+  const usize end = da_par_bound(s->count, s->runs, task + 1);
+  qsort(&s->src[begin * s->size], end - begin, s->size, s->compare);
+}
+
+// Number of items taken from 'a' for the first 'k' items of the merge. Items
+// of 'a' come first if they are equal, so the merge is stable.
+static usize da_par_sort_split(const DaParSort *s, const u8 *a, usize a_len, const u8 *b,
+                               usize b_len, usize k) {
+  usize lo = b_len < k ? k - b_len : 0;
+  usize hi = a_len < k ? a_len : k;
+  while (lo < hi) {
+    const usize i = lo + (hi - lo) / 2;
+    if (s->compare(&a[i * s->size], &b[(k - i - 1) * s->size]) <= 0) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+// Every merge is split into 'runs / pairs' parts of the output, so every
+// round has 'runs' tasks of about the same size.
+static void da_par_sort_merge(void *ctx, usize task) {
+  const DaParSort *s = ctx;
+  const usize pairs = s->runs / (2 * s->width);
+  const usize parts = s->runs / pairs;
+  const usize pair = task / parts;
+  const usize part = task % parts;
+
+  const usize begin = da_par_bound(s->count, s->runs, pair * 2 * s->width);
+  const usize mid = da_par_bound(s->count, s->runs, pair * 2 * s->width + s->width);
+  const usize end = da_par_bound(s->count, s->runs, (pair + 1) * 2 * s->width);
+  const u8 *a = &s->src[begin * s->size];
+  const u8 *b = &s->src[mid * s->size];
+  const usize a_len = mid - begin;
+  const usize b_len = end - mid;
+
+  const usize k_begin = da_par_bound(end - begin, parts, part);
+  const usize k_end = da_par_bound(end - begin, parts, part + 1);
+  usize i = da_par_sort_split(s, a, a_len, b, b_len, k_begin);
+  usize j = k_begin - i;
+  const usize i_end = da_par_sort_split(s, a, a_len, b, b_len, k_end);
+  const usize j_end = k_end - i_end;
+
+  u8 *out = &s->dest[(begin + k_begin) * s->size];
+  while (i < i_end && j < j_end) {
+    if (s->compare(&b[j * s->size], &a[i * s->size]) < 0) {
+      da_par_copy(out, &b[j++ * s->size], s->size);
+    } else {
+      da_par_copy(out, &a[i++ * s->size], s->size);
+    }
+    out += s->size;
+  }
+  memcpy(out, &a[i * s->size], (i_end - i) * s->size);
+  out += (i_end - i) * s->size;
+  memcpy(out, &b[j * s->size], (j_end - j) * s->size);
+}
+
+void _da_par_sort(ThreadPool *pool, usize count, void *items, usize size, CompareFn compare) {
+  usize runs = 1;
+  while (runs < DA_PAR_MAX_RUNS && DA_PAR_MIN_RUN <= count / (runs * 2)) {
+    runs *= 2;
+  }
+  if (runs == 1) {
+    if (count) {
+      qsort(items, count, size, compare);
+    }
+    return;
+  }
+
+  Arena scratch = {0};
+  DaParSort s = {
+      .count = count,
+      .runs = runs,
+      .size = size,
+      .compare = compare,
+      .src = items,
+      .dest = arena_alloc(&scratch, count * size),
+  };
+  thread_pool_run(pool, runs, da_par_sort_run, &s);
+  for (s.width = 1; s.width < runs; s.width *= 2) {
+    thread_pool_run(pool, runs, da_par_sort_merge, &s);
+    u8 *temp = s.src;
+    s.src = s.dest;
+    s.dest = temp;
+  }
+  if (s.src != items) {
+    memcpy(items, s.src, count * size);
+  }
+  arena_free(&scratch);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef DA_PAR_MIN_CHUNK
+#undef DA_PAR_MAX_TASKS
+#undef DA_PAR_MIN_RUN
+#undef DA_PAR_MAX_RUNS
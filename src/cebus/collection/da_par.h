@@ -0,0 +1,98 @@
+/* DOCUMENTATION
+Parallel versions of `da_map`, `da_filter` and `da_sort`, that split the array
+into chunks and run them on a `ThreadPool`. The chunks only depend on the
+length of the array, so the result is the same for every number of threads.
+
+The functions are called through pointers, like the comparison function of
+`da_sort`, because a macro can not hand an expression to another thread.
+
+## Functions
+
+- `da_par_map(pool, src, dest, map)`: Calls `void map(const void *item, void
+*out)` for every item and stores the results in `dest`.
+- `da_par_map_ctx(pool, src, dest, map, ctx)`: Same but calls `void map(void
+*ctx, const void *item, void *out)`. Every thread gets the same `ctx`, so it
+should only be read.
+- `da_par_filter(pool, src, dest, filter)`: Copies the items for which `bool
+filter(const void *item)` returns `true` into `dest`, in the same order. The
+chunks are filtered in parallel and then copied to their offsets from a prefix
+sum of their counts.
+- `da_par_filter_ctx(pool, src, dest, filter, ctx)`: Same but calls `bool
+filter(void *ctx, const void *item)`.
+- `da_par_sort(pool, list, compare)`: Sorts the array with a `CompareFn`,
+like `da_sort`. The chunks are sorted in parallel and then merged in
+rounds, with every merge split into parallel parts.
+
+`dest` must not be `src`.
+
+```c
+static void square(const void *item, void *out) {
+  *(u64 *)out = *(const u64 *)item * *(const u64 *)item;
+}
+
+ThreadPool *pool = thread_pool_create(&arena, 0);
+DA(u64) squares = da_new(&arena);
+da_par_map(pool, &values, &squares, square);
+da_par_sort(pool, &squares, u64_compare_qsort(CMP_LESS));
+thread_pool_destroy(pool);
+```
+*/
+
+#ifndef __CEBUS_DA_PAR_H__
+#define __CEBUS_DA_PAR_H__
+
+#include "cebus/collection/da.h" // IWYU pragma: export
+#include "cebus/core/defines.h"
+#include "cebus/os/thread.h" // IWYU pragma: export
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define da_par_map(pool, src, dest, map)                                                           \
+  do {                                                                                             \
+    da_reserve((dest), da_len(src));                                                               \
+    _da_par_map(pool, da_len(src), (src)->items, sizeof(*(src)->items), (dest)->items,             \
+                sizeof(*(dest)->items), map);                                                      \
+    da_len(dest) = da_len(src);                                                                    \
+  } while (0)
+
+#define da_par_map_ctx(pool, src, dest, map, ctx)                                                  \
+  do {                                                                                             \
+    da_reserve((dest), da_len(src));                                                               \
+    _da_par_map_ctx(pool, da_len(src), (src)->items, sizeof(*(src)->items), (dest)->items,         \
+                    sizeof(*(dest)->items), map, ctx);                                             \
+    da_len(dest) = da_len(src);                                                                    \
+  } while (0)
+
+#define da_par_filter(pool, src, dest, filter)                                                     \
+  do {                                                                                             \
+    da_reserve((dest), da_len(src));                                                               \
+    da_len(dest) = _da_par_filter(pool, da_len(src), (src)->items, (dest)->items,                  \
+                                  sizeof(*(src)->items), filter);                                  \
+  } while (0)
+
+#define da_par_filter_ctx(pool, src, dest, filter, ctx)                                            \
+  do {                                                                                             \
+    da_reserve((dest), da_len(src));                                                               \
+    da_len(dest) = _da_par_filter_ctx(pool, da_len(src), (src)->items, (dest)->items,              \
+                                      sizeof(*(src)->items), filter, ctx);                         \
+  } while (0)
+
+#define da_par_sort(pool, list, compare)                                                           \
+  _da_par_sort(pool, da_len(list), (list)->items, sizeof(*(list)->items), compare)
+
+///////////////////////////////////////////////////////////////////////////////
+
+void _da_par_map(ThreadPool *pool, usize count, const void *src, usize src_size, void *dest,
+                 usize dest_size, void (*map)(const void *item, void *out));
+void _da_par_map_ctx(ThreadPool *pool, usize count, const void *src, usize src_size, void *dest,
+                     usize dest_size, void (*map)(void *ctx, const void *item, void *out),
+                     void *ctx);
+usize _da_par_filter(ThreadPool *pool, usize count, const void *src, void *dest, usize size,
+                     bool (*filter)(const void *item));
+usize _da_par_filter_ctx(ThreadPool *pool, usize count, const void *src, void *dest, usize size,
+                         bool (*filter)(void *ctx, const void *item), void *ctx);
+void _da_par_sort(ThreadPool *pool, usize count, void *items, usize size, CompareFn compare);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_DA_PAR_H__ */
@@ -0,0 +1,130 @@
+#include "eytzinger.h"
+
+#include "cebus/collection/da.h"
+#include "cebus/core/platform.h"
+#include "cebus/type/integer.h"
+
+#include <stdint.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define EYTZINGER_LINE 64
+#define EYTZINGER_KEYS_PER_LINE (EYTZINGER_LINE / sizeof(u64))
+
+#if defined(GCC) || defined(CLANG)
+#define EYTZINGER_PREFETCH(ptr) __builtin_prefetch(ptr)
+#define EYTZINGER_TRAILING_ONES(x) ((usize)__builtin_ctzll(~(unsigned long long)(x)))
+#else
+#define EYTZINGER_PREFETCH(ptr) ((void)(ptr))
+#define EYTZINGER_TRAILING_ONES(x) u64_trailing_ones(x)
+#endif
+
+#define EYTZINGER_KEY(key) (key)
+#define EYTZINGER_BATCH 8
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Fills the tree with an in order traversal, so it takes the sorted keys in
+// order.
+static usize eytzinger_fill(u64 *tree, usize n, const u64 *sorted, usize i, usize k) {
+  if (k <= n) {
+    i = eytzinger_fill(tree, n, sorted, i, 2 * k);
+    tree[k] = sorted[i++];
+    i = eytzinger_fill(tree, n, sorted, i, 2 * k + 1);
+  }
+  return i;
+}
+
+// Walks down to a leaf and returns the position of the lower bound: Every step
+// to the right appends a 1 bit to 'k'. The lower bound is the last node where
+// the search went left, so remove the trailing ones and that zero bit.
+static usize eytzinger_search(const Eytzinger *ez, u64 key) {
+  const u64 *tree = ez->keys;
+  usize k = 1;
+  while (k <= ez->len) {
+    // the 8 keys 3 levels further down share a cache line
+    EYTZINGER_PREFETCH(&tree[k * EYTZINGER_KEYS_PER_LINE]);
+    k = 2 * k + (tree[k] < key);
+  }
+  return k >> (EYTZINGER_TRAILING_ONES(k) + 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Eytzinger eytzinger_create(Arena *arena, usize count, const u64 *keys) {
+  Arena scratch = {0};
+  DA(u64) sorted = da_new(&scratch);
+  da_extend(&sorted, count, keys);
+  da_radix_sort_u64(&sorted, EYTZINGER_KEY);
+  da_unique(&sorted, u64, *a < *b);
+
+  Eytzinger ez = {0};
+  ez.arena = arena;
+  ez.len = da_len(&sorted);
+  // index 0 is unused, align index 0 to a cache line so the prefetched groups
+  // of 8 keys do not cross cache lines
+  u8 *data = arena_alloc_chunk(arena, (ez.len + 1) * sizeof(u64) + EYTZINGER_LINE);
+  const usize misaligned = (uintptr_t)data % EYTZINGER_LINE;
+  ez.keys = (u64 *)(void *)(data + (misaligned ? EYTZINGER_LINE - misaligned : 0));
+  ez.keys[0] = 0;
+  eytzinger_fill(ez.keys, ez.len, sorted.items, 0, 1);
+
+  arena_free(&scratch);
+  return ez;
+}
+
+bool eytzinger_contains(const Eytzinger *ez, u64 key) {
+  const usize k = eytzinger_search(ez, key);
+  return k != 0 && ez->keys[k] == key;
+}
+
+bool eytzinger_lower_bound(const Eytzinger *ez, u64 key, u64 *result) {
+  const usize k = eytzinger_search(ez, key);
+  if (k == 0) {
+    return false;
+  }
+  *result = ez->keys[k];
+  return true;
+}
+
+// Searches for multiple keys in lockstep, so the cache misses of the searches
+// overlap.
+usize eytzinger_contains_batch(const Eytzinger *ez, usize count, const u64 *keys, bool *result) {
+  const u64 *tree = ez->keys;
+  usize found = 0;
+  usize k[EYTZINGER_BATCH];
+  for (usize i = 0; i < count; i += EYTZINGER_BATCH) {
+    const usize n = usize_min(EYTZINGER_BATCH, count - i);
+    for (usize j = 0; j < n; j++) {
+      k[j] = 1;
+    }
+    for (bool running = true; running;) {
+      running = false;
+      for (usize j = 0; j < n; j++) {
+        if (k[j] <= ez->len) {
+          EYTZINGER_PREFETCH(&tree[k[j] * EYTZINGER_KEYS_PER_LINE]);
+          k[j] = 2 * k[j] + (tree[k[j]] < keys[i + j]);
+          running = true;
+        }
+      }
+    }
+    for (usize j = 0; j < n; j++) {
+      const usize lower = k[j] >> (EYTZINGER_TRAILING_ONES(k[j]) + 1);
+      const bool contains = lower != 0 && tree[lower] == keys[i + j];
+      if (result) {
+        result[i + j] = contains;
+      }
+      found += contains;
+    }
+  }
+  return found;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef EYTZINGER_LINE
+#undef EYTZINGER_KEY
+#undef EYTZINGER_KEYS_PER_LINE
+#undef EYTZINGER_PREFETCH
+#undef EYTZINGER_TRAILING_ONES
+#undef EYTZINGER_BATCH
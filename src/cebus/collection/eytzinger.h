@@ -0,0 +1,54 @@
+/* DOCUMENTATION
+`Eytzinger` is a static sorted set of `u64` keys for fast lookups. The keys
+are stored in breadth first order of a complete binary search tree: the
+children of the key at `k` are at `2k` and `2k + 1`. A search always walks
+down the array, the first levels of the tree share a few cache lines, and the
+keys a few levels further down can be prefetched while comparing. The search
+loop has no branches that depend on the keys.
+
+It uses one `u64` per key, which is a lot smaller than a `Set`, and does not
+need the keys to be hashes.
+
+```c
+Arena arena = {0};
+Eytzinger ez = eytzinger_create(&arena, count, keys);
+if (eytzinger_contains(&ez, 42)) {
+  // ...
+}
+```
+
+- `eytzinger_create`: Creates the set from an array of keys in any order.
+Duplicates are removed.
+- `eytzinger_contains`: Checks if a key is in the set.
+- `eytzinger_lower_bound`: Finds the smallest key that is not less than a
+key. Returns `false` if there is none.
+- `eytzinger_contains_batch`: Checks multiple keys at once and returns how many
+were found. Writes the result for every key into `result` if it is not
+`NULL`.
+*/
+
+#ifndef __CEBUS_EYTZINGER_H__
+#define __CEBUS_EYTZINGER_H__
+
+#include "cebus/core/arena.h"
+#include "cebus/core/defines.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  usize len;
+  Arena *arena;
+  u64 *keys;
+} Eytzinger;
+
+//////////////////////////////////////////////////////////////////////////////
+
+Eytzinger eytzinger_create(Arena *arena, usize count, const u64 *keys);
+
+bool eytzinger_contains(const Eytzinger *ez, u64 key);
+bool eytzinger_lower_bound(const Eytzinger *ez, u64 key, u64 *result);
+usize eytzinger_contains_batch(const Eytzinger *ez, usize count, const u64 *keys, bool *result);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_EYTZINGER_H__ */
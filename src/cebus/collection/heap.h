@@ -0,0 +1,159 @@
+/* DOCUMENTATION
+A heap is a priority queue, that always knows its smallest element. The heap
+is stored in a dynamic array, so `Heap(T)` is the same as `DA(T)` and the
+`da_*` macros like `da_len` work on it.
+
+`HEAP_DEFINE(Name, T, ARITY, less)` defines the type `Name` and its
+functions. The comparison `less` is an expression that compares the items
+`const T *a` and `const T *b`, like in `da_sort_by`. It gets inlined into the
+functions. `ARITY` is the number of children per node. A binary heap (2) does
+the fewest comparisons, a 4-ary heap is shallower and touches fewer cache
+lines, which is usually faster for big heaps.
+
+```c
+HEAP_DEFINE(TaskQueue, Task, 4, a->deadline < b->deadline)
+
+Arena arena = {0};
+TaskQueue queue = da_new(&arena);
+TaskQueue_push(&queue, task);
+Task next = TaskQueue_pop(&queue);
+```
+
+## Functions
+
+> :warning: `pop` and `peek` do not check if the heap is empty.
+
+- `Name_push(heap, value)`: Adds a value.
+- `Name_pop(heap)`: Removes and returns the smallest value.
+- `Name_peek(heap)`: Returns the smallest value.
+- `Name_replace(heap, value)`: Removes the smallest value and adds a new one.
+Faster than a pop followed by a push.
+- `Name_heapify(heap)`: Turns the items of the dynamic array into a heap in
+linear time.
+- `Name_from(arena, count, items)`: Creates a heap from an array in linear time.
+Use `DA_ARG` to create it from an existing dynamic array.
+
+## Top-K
+
+`Name_push_top_k(heap, k, value)` keeps the `k` biggest values pushed into the
+heap. The smallest of them is at the top, so a new value only has to be
+compared with it. Returns `true` if the value was kept.
+
+```c
+HEAP_DEFINE(Scores, u64, 2, *a < *b)
+Scores best = da_new(&arena);
+for (usize i = 0; i < count; i++) {
+  Scores_push_top_k(&best, 10, scores[i]);
+}
+```
+*/
+
+#ifndef __CEBUS_HEAP_H__
+#define __CEBUS_HEAP_H__
+
+#include "cebus/collection/da.h"
+#include "cebus/core/defines.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define Heap(T) DA(T)
+
+#define HEAP_DEFINE(Name, T, ARITY, ...)                                                           \
+  typedef Heap(T) Name;                                                                            \
+                                                                                                   \
+  UNUSED static inline bool Name##_less(const T *a, const T *b) {                                  \
+    (void)a;                                                                                       \
+    (void)b;                                                                                       \
+    return (__VA_ARGS__);                                                                          \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_sift_up(Name *heap, usize idx) {                                       \
+    T value = heap->items[idx];                                                                    \
+    while (0 < idx) {                                                                              \
+      const usize parent = (idx - 1) / (ARITY);                                                    \
+      if (!Name##_less(&value, &heap->items[parent])) {                                            \
+        break;                                                                                     \
+      }                                                                                            \
+      heap->items[idx] = heap->items[parent];                                                      \
+      idx = parent;                                                                                \
+    }                                                                                              \
+    heap->items[idx] = value;                                                                      \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_sift_down(Name *heap, usize idx) {                                     \
+    const usize len = heap->len;                                                                   \
+    T *const items = heap->items;                                                                  \
+    T value = items[idx];                                                                          \
+    while (true) {                                                                                 \
+      const usize first = idx * (ARITY) + 1;                                                       \
+      if (len <= first) {                                                                          \
+        break;                                                                                     \
+      }                                                                                            \
+      const usize last = len - first < (ARITY) ? len : first + (ARITY);                            \
+      usize child = first;                                                                         \
+      for (usize i = first + 1; i < last; i++) {                                                   \
+        child = Name##_less(&items[i], &items[child]) ? i : child;                                 \
+      }                                                                                            \
+      if (!Name##_less(&items[child], &value)) {                                                   \
+        break;                                                                                     \
+      }                                                                                            \
+      items[idx] = items[child];                                                                   \
+      idx = child;                                                                                 \
+    }                                                                                              \
+    items[idx] = value;                                                                            \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_push(Name *heap, T value) {                                            \
+    da_push(heap, value);                                                                          \
+    Name##_sift_up(heap, heap->len - 1);                                                           \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static T Name##_peek(const Name *heap) { return heap->items[0]; }                         \
+                                                                                                   \
+  UNUSED static T Name##_pop(Name *heap) {                                                         \
+    const T top = heap->items[0];                                                                  \
+    heap->items[0] = heap->items[--heap->len];                                                     \
+    if (heap->len) {                                                                               \
+      Name##_sift_down(heap, 0);                                                                   \
+    }                                                                                              \
+    return top;                                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static T Name##_replace(Name *heap, T value) {                                            \
+    const T top = heap->items[0];                                                                  \
+    heap->items[0] = value;                                                                        \
+    Name##_sift_down(heap, 0);                                                                     \
+    return top;                                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_heapify(Name *heap) {                                                  \
+    for (usize i = heap->len / (ARITY) + 1; 0 < i; i--) {                                          \
+      if (i - 1 < heap->len) {                                                                     \
+        Name##_sift_down(heap, i - 1);                                                             \
+      }                                                                                            \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static Name Name##_from(Arena *arena, usize count, const T *items) {                      \
+    Name heap = da_new(arena);                                                                     \
+    da_extend(&heap, count, items);                                                                \
+    Name##_heapify(&heap);                                                                         \
+    return heap;                                                                                   \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static bool Name##_push_top_k(Name *heap, usize k, T value) {                             \
+    if (heap->len < k) {                                                                           \
+      Name##_push(heap, value);                                                                    \
+      return true;                                                                                 \
+    }                                                                                              \
+    if (k == 0 || !Name##_less(&heap->items[0], &value)) {                                         \
+      return false;                                                                                \
+    }                                                                                              \
+    heap->items[0] = value;                                                                        \
+    Name##_sift_down(heap, 0);                                                                     \
+    return true;                                                                                   \
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_HEAP_H__ */
@@ -0,0 +1,360 @@
+#include "hll.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/core/platform.h"
+#include "cebus/type/byte.h"
+#include "cebus/type/float.h"
+#include "cebus/type/integer.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+// The sparse representation stores the register index with this precision,
+// so it can be converted into the dense registers of every precision.
+#define HLL_SPARSE_PRECISION 25
+#define HLL_SPARSE_RHO_BITS 6
+#define HLL_SPARSE_DEFAULT_SIZE 16
+
+#define HLL_HEADER_SIZE 6
+#define HLL_VERSION 1
+
+//////////////////////////////////////////////////////////////////////////////
+
+static usize hll_leading_zeros(u64 value) {
+  if (value == 0) {
+    return 64;
+  }
+#if defined(GCC) || defined(CLANG)
+  return (usize)__builtin_clzll(value);
+#else
+  return u64_leading_zeros(value);
+#endif
+}
+
+// The register value: position of the first set bit after the index bits.
+static u8 hll_rho(u64 hash, usize precision) {
+  return (u8)usize_min(hll_leading_zeros(hash << precision), 64 - precision) + 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static u32 hll_sparse_entry(u64 hash) {
+  const u32 idx = (u32)(hash >> (64 - HLL_SPARSE_PRECISION));
+  return (u32)(idx << HLL_SPARSE_RHO_BITS) | hll_rho(hash, HLL_SPARSE_PRECISION);
+}
+
+static u32 hll_sparse_idx(u32 entry) { return entry >> HLL_SPARSE_RHO_BITS; }
+
+static u8 hll_sparse_rho(u32 entry) {
+  return (u8)(entry & ((1u << HLL_SPARSE_RHO_BITS) - 1));
+}
+
+static usize hll_sparse_max(usize precision) { return ((usize)1 << precision) / sizeof(u32); }
+
+static void hll_dense_set(HyperLogLog *hll, usize idx, u8 rho) {
+  hll->registers[idx] = hll->registers[idx] < rho ? rho : hll->registers[idx];
+}
+
+// Converts the sparse entry into the register of the dense representation.
+static void hll_dense_add_entry(HyperLogLog *hll, u32 entry) {
+  const usize shift = HLL_SPARSE_PRECISION - hll->precision;
+  const u32 idx = hll_sparse_idx(entry);
+  const u32 low = idx & (((u32)1 << shift) - 1);
+  u8 rho = 0;
+  if (low) {
+    rho = (u8)(shift - (64 - hll_leading_zeros(low)) + 1);
+  } else {
+    rho = (u8)(shift + hll_sparse_rho(entry));
+  }
+  hll_dense_set(hll, idx >> shift, rho);
+}
+
+static void hll_to_dense(HyperLogLog *hll) {
+  hll->registers = arena_calloc_chunk(hll->arena, (usize)1 << hll->precision);
+  for (usize i = 0; i < hll->len; i++) {
+    hll_dense_add_entry(hll, hll->entries[i]);
+  }
+  arena_free_chunk(hll->arena, hll->entries);
+  hll->entries = NULL;
+  hll->sparse = false;
+  hll->len = 0;
+  hll->cap = 0;
+}
+
+static void hll_sparse_insert(HyperLogLog *hll, u32 entry) {
+  const u32 idx = hll_sparse_idx(entry);
+  usize lo = 0;
+  usize hi = hll->len;
+  while (lo < hi) {
+    const usize mid = lo + (hi - lo) / 2;
+    if (hll_sparse_idx(hll->entries[mid]) < idx) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < hll->len && hll_sparse_idx(hll->entries[lo]) == idx) {
+    if (hll->entries[lo] < entry) {
+      hll->entries[lo] = entry;
+    }
+    return;
+  }
+
+  if (hll_sparse_max(hll->precision) <= hll->len) {
+    hll_to_dense(hll);
+    hll_dense_add_entry(hll, entry);
+    return;
+  }
+  if (hll->cap <= hll->len) {
+    hll->cap = usize_max(hll->cap * 2, HLL_SPARSE_DEFAULT_SIZE);
+    hll->entries = arena_realloc_chunk(hll->arena, hll->entries, hll->cap * sizeof(u32));
+  }
+  memmove(&hll->entries[lo + 1], &hll->entries[lo], (hll->len - lo) * sizeof(u32));
+  hll->entries[lo] = entry;
+  hll->len++;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Ertl, "New cardinality estimation algorithms for HyperLogLog sketches"
+static f64 hll_sigma(f64 x) {
+  if (x == 1) {
+    return F64_INF;
+  }
+  f64 y = 1;
+  f64 z = x;
+  f64 prev = 0;
+  do {
+    x *= x;
+    prev = z;
+    z += x * y;
+    y += y;
+  } while (z != prev);
+  return z;
+}
+
+static f64 hll_tau(f64 x) {
+  if (x == 0 || x == 1) {
+    return 0;
+  }
+  f64 y = 1;
+  f64 z = 1 - x;
+  f64 prev = 0;
+  do {
+    x = f64_sqrt(x);
+    prev = z;
+    y *= 0.5;
+    z -= (1 - x) * (1 - x) * y;
+  } while (z != prev);
+  return z / 3;
+}
+
+static f64 hll_dense_estimate(const HyperLogLog *hll) {
+  const usize m = (usize)1 << hll->precision;
+  const usize q = 64 - hll->precision;
+  usize histogram[64 + 2] = {0};
+  for (usize i = 0; i < m; i++) {
+    histogram[hll->registers[i]]++;
+  }
+  if (histogram[0] == m) {
+    return 0;
+  }
+  f64 z = (f64)m * hll_tau(1 - (f64)histogram[q + 1] / (f64)m);
+  for (usize k = q; 0 < k; k--) {
+    z = 0.5 * (z + (f64)histogram[k]);
+  }
+  z += (f64)m * hll_sigma((f64)histogram[0] / (f64)m);
+  return 0.5 / 0.6931471805599453 * (f64)m * (f64)m / z;
+}
+
+// Linear counting is very precise with this many registers.
+static f64 hll_sparse_estimate(const HyperLogLog *hll) {
+  const f64 m = (f64)((u64)1 << HLL_SPARSE_PRECISION);
+  return m * f64_ln(m / (m - (f64)hll->len));
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+HyperLogLog hll_create(Arena *arena, usize precision) {
+  cebus_assert(HLL_MIN_PRECISION <= precision && precision <= HLL_MAX_PRECISION,
+               "precision has to be between %d and %d: %" USIZE_FMT, HLL_MIN_PRECISION,
+               HLL_MAX_PRECISION, precision);
+  HyperLogLog hll = {0};
+  hll.arena = arena;
+  hll.precision = precision;
+  hll.sparse = true;
+  return hll;
+}
+
+void hll_clear(HyperLogLog *hll) {
+  if (!hll->sparse) {
+    arena_free_chunk(hll->arena, hll->registers);
+    hll->registers = NULL;
+  }
+  hll->sparse = true;
+  hll->len = 0;
+}
+
+HyperLogLog hll_copy(Arena *arena, const HyperLogLog *hll) {
+  HyperLogLog new = hll_create(arena, hll->precision);
+  if (hll->sparse) {
+    new.cap = usize_max(hll->len, HLL_SPARSE_DEFAULT_SIZE);
+    new.len = hll->len;
+    new.entries = arena_alloc_chunk(arena, new.cap * sizeof(u32));
+    if (hll->len) {
+      memcpy(new.entries, hll->entries, hll->len * sizeof(u32));
+    }
+  } else {
+    new.sparse = false;
+    new.registers = arena_alloc_chunk(arena, (usize)1 << hll->precision);
+    memcpy(new.registers, hll->registers, (usize)1 << hll->precision);
+  }
+  return new;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void hll_add(HyperLogLog *hll, u64 hash) {
+  hash = u64_mix(hash);
+  if (hll->sparse) {
+    hll_sparse_insert(hll, hll_sparse_entry(hash));
+  } else {
+    hll_dense_set(hll, hash >> (64 - hll->precision), hll_rho(hash, hll->precision));
+  }
+}
+
+void hll_extend(HyperLogLog *hll, usize count, const u64 *hashes) {
+  for (usize i = 0; i < count; i++) {
+    hll_add(hll, hashes[i]);
+  }
+}
+
+void hll_merge(HyperLogLog *hll, const HyperLogLog *other) {
+  cebus_assert(hll->precision == other->precision,
+               "Sketches need the same precision to be merged: %" USIZE_FMT " != %" USIZE_FMT,
+               hll->precision, other->precision);
+  if (other->sparse) {
+    for (usize i = 0; i < other->len; i++) {
+      if (hll->sparse) {
+        hll_sparse_insert(hll, other->entries[i]);
+      } else {
+        hll_dense_add_entry(hll, other->entries[i]);
+      }
+    }
+    return;
+  }
+  if (hll->sparse) {
+    hll_to_dense(hll);
+  }
+  for (usize i = 0; i < (usize)1 << hll->precision; i++) {
+    hll_dense_set(hll, i, other->registers[i]);
+  }
+}
+
+u64 hll_count(const HyperLogLog *hll) {
+  const f64 estimate = hll->sparse ? hll_sparse_estimate(hll) : hll_dense_estimate(hll);
+  return (u64)(estimate + 0.5);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+Bytes hll_serialize(const HyperLogLog *hll, Arena *arena) {
+  const usize m = (usize)1 << hll->precision;
+  const usize size = HLL_HEADER_SIZE + (hll->sparse ? sizeof(u32) + hll->len * sizeof(u32) : m);
+  u8 *data = arena_alloc(arena, size);
+  data[0] = 'H';
+  data[1] = 'L';
+  data[2] = 'L';
+  data[3] = HLL_VERSION;
+  data[4] = (u8)hll->precision;
+  data[5] = hll->sparse;
+  if (hll->sparse) {
+    u8 *p = &data[HLL_HEADER_SIZE];
+    for (usize i = 0; i < hll->len + 1; i++) {
+      const u32 value = i == 0 ? (u32)hll->len : hll->entries[i - 1];
+      for (usize b = 0; b < sizeof(u32); b++) {
+        *p++ = (u8)(value >> (b * 8));
+      }
+    }
+  } else {
+    memcpy(&data[HLL_HEADER_SIZE], hll->registers, m);
+  }
+  return bytes_from_parts(size, data);
+}
+
+static u32 hll_read_u32(const u8 *data) {
+  return (u32)data[0] | (u32)data[1] << 8 | (u32)data[2] << 16 | (u32)data[3] << 24;
+}
+
+HyperLogLog hll_deserialize(Bytes bytes, Arena *arena, Error *error) {
+  HyperLogLog hll = {0};
+  if (bytes.size < HLL_HEADER_SIZE || memcmp(bytes.data, "HLL", 3) != 0) {
+    error_emit(error, HLL_INVALID, "HyperLogLog: data is not a sketch");
+    return hll;
+  }
+  if (bytes.data[3] != HLL_VERSION) {
+    error_emit(error, HLL_INVALID, "HyperLogLog: unknown version %d", bytes.data[3]);
+    return hll;
+  }
+  const usize precision = bytes.data[4];
+  if (precision < HLL_MIN_PRECISION || HLL_MAX_PRECISION < precision || 1 < bytes.data[5]) {
+    error_emit(error, HLL_INVALID, "HyperLogLog: invalid header");
+    return hll;
+  }
+  const usize m = (usize)1 << precision;
+  const u8 *data = &bytes.data[HLL_HEADER_SIZE];
+  const usize size = bytes.size - HLL_HEADER_SIZE;
+
+  if (bytes.data[5]) {
+    const usize len = size < sizeof(u32) ? 0 : hll_read_u32(data);
+    if (size < sizeof(u32) || hll_sparse_max(precision) < len ||
+        size != sizeof(u32) + len * sizeof(u32)) {
+      error_emit(error, HLL_INVALID, "HyperLogLog: wrong size of sparse data");
+      return hll;
+    }
+    for (usize i = 0; i < len; i++) {
+      const u32 entry = hll_read_u32(&data[(i + 1) * sizeof(u32)]);
+      const u8 rho = hll_sparse_rho(entry);
+      const bool sorted =
+          i == 0 || hll_sparse_idx(hll_read_u32(&data[i * sizeof(u32)])) < hll_sparse_idx(entry);
+      if (!sorted || rho == 0 || 64 - HLL_SPARSE_PRECISION + 1 < rho ||
+          (entry >> (HLL_SPARSE_PRECISION + HLL_SPARSE_RHO_BITS))) {
+        error_emit(error, HLL_INVALID, "HyperLogLog: invalid sparse entry at %" USIZE_FMT, i);
+        return hll;
+      }
+    }
+    hll = hll_create(arena, precision);
+    hll.cap = usize_max(len, HLL_SPARSE_DEFAULT_SIZE);
+    hll.len = len;
+    hll.entries = arena_alloc_chunk(arena, hll.cap * sizeof(u32));
+    for (usize i = 0; i < len; i++) {
+      hll.entries[i] = hll_read_u32(&data[(i + 1) * sizeof(u32)]);
+    }
+    return hll;
+  }
+
+  if (size != m) {
+    error_emit(error, HLL_INVALID, "HyperLogLog: wrong size of registers");
+    return hll;
+  }
+  for (usize i = 0; i < m; i++) {
+    if (64 - precision + 1 < data[i]) {
+      error_emit(error, HLL_INVALID, "HyperLogLog: invalid register at %" USIZE_FMT, i);
+      return hll;
+    }
+  }
+  hll = hll_create(arena, precision);
+  hll.sparse = false;
+  hll.registers = arena_alloc_chunk(arena, m);
+  memcpy(hll.registers, data, m);
+  return hll;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef HLL_SPARSE_PRECISION
+#undef HLL_SPARSE_RHO_BITS
+#undef HLL_SPARSE_DEFAULT_SIZE
+#undef HLL_HEADER_SIZE
+#undef HLL_VERSION
@@ -0,0 +1,107 @@
+/* DOCUMENTATION
+`HyperLogLog` estimates the number of distinct hashes in a stream without
+storing them. With a precision of `p` it uses at most `2^p` bytes, the
+standard error of the estimate is about `1.04 / sqrt(2^p)`:
+
+| precision | memory   | error |
+|-----------|----------|-------|
+| 10        | 1 KiB    | 3.3%  |
+| 12        | 4 KiB    | 1.6%  |
+| 14        | 16 KiB   | 0.8%  |
+
+Like `Set` it works on precomputed `u64` hashes, for example from `str_hash` or
+`bytes_hash`.
+
+## Initialization
+
+```c
+Arena arena = {0};
+HyperLogLog hll = hll_create(&arena, 12);
+```
+
+- `hll_create`: Creates a new sketch. The precision has to be between
+`HLL_MIN_PRECISION` and `HLL_MAX_PRECISION`.
+- `hll_clear`: Removes all hashes.
+- `hll_copy`: Creates a copy of the sketch.
+
+Small sketches start in a sparse representation that only stores the
+registers that were set. It is exact enough for a few thousand distinct
+hashes and switches to the dense registers once it would need more memory
+than them.
+
+## Operations
+
+- `hll_add`: Adds a hash.
+- `hll_extend`: Adds multiple hashes at once.
+- `hll_merge`: Adds all hashes of another sketch with the same precision. Use
+it to combine the sketches of multiple threads or shards.
+- `hll_count`: Estimates the number of distinct hashes.
+
+```c
+for (usize i = 0; i < words.len; i++) {
+  hll_add(&hll, str_hash(words.items[i]));
+}
+printf("%" U64_FMT "\n", hll_count(&hll));
+```
+
+## Serialization
+
+- `hll_serialize`: Writes the sketch into a byte array. The format does not
+depend on the platform.
+- `hll_deserialize`: Reads a sketch from a byte array. Emits `HLL_INVALID` if
+the data is not a valid sketch.
+
+*/
+
+#ifndef __CEBUS_HLL_H__
+#define __CEBUS_HLL_H__
+
+#include "cebus/core/arena.h"
+#include "cebus/core/defines.h"
+#include "cebus/core/error.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define HLL_MIN_PRECISION 4
+#define HLL_MAX_PRECISION 18
+
+typedef enum {
+  HLL_OK,
+  HLL_INVALID,
+} HllError;
+
+typedef struct {
+  usize precision;
+  bool sparse;
+  usize len;
+  usize cap;
+  Arena *arena;
+  u32 *entries;
+  u8 *registers;
+} HyperLogLog;
+
+//////////////////////////////////////////////////////////////////////////////
+
+HyperLogLog hll_create(Arena *arena, usize precision);
+
+void hll_clear(HyperLogLog *hll);
+
+HyperLogLog hll_copy(Arena *arena, const HyperLogLog *hll);
+
+//////////////////////////////////////////////////////////////////////////////
+
+void hll_add(HyperLogLog *hll, u64 hash);
+void hll_extend(HyperLogLog *hll, usize count, const u64 *hashes);
+
+void hll_merge(HyperLogLog *hll, const HyperLogLog *other);
+
+u64 hll_count(const HyperLogLog *hll);
+
+//////////////////////////////////////////////////////////////////////////////
+
+Bytes hll_serialize(const HyperLogLog *hll, Arena *arena);
+HyperLogLog hll_deserialize(Bytes bytes, Arena *arena, Error *error);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_HLL_H__ */
@@ -0,0 +1,118 @@
+/* DOCUMENTATION
+Lazy iterator pipelines. Chaining `da_filter` and `da_map` fills a whole
+intermediate array for every step. These macros expand into nested loops
+instead, so the whole pipeline runs as one loop over the source and nothing
+is allocated until the end of the pipeline.
+
+Every pipeline starts with a source, followed by any number of adapters, and
+ends with a terminal or a normal statement:
+
+```c
+DA(usize) squares = da_new(&arena);
+it_da(usize, x, &numbers)
+  it_filter(x % 2 == 0)
+    it_map(usize, y, x * x)
+      it_take(10)
+        it_collect(&squares, y);
+```
+
+## Sources
+
+Each source declares the variable that holds the current element.
+
+- `it_da(T, x, list)`: Iterates over the elements of a dynamic array.
+- `it_range(T, x, begin, end)`: Iterates over the numbers in `[begin, end)`.
+- `it_split(x, str, delim)`: Iterates over the parts of a `Str` split by a
+character.
+- `it_fs(e, it)`: Iterates over the `FsEntity`s of a started `FsIter`. The
+entities are only valid for one iteration, see `fs_iter_next`.
+
+## Adapters
+
+- `it_map(U, y, expr)`: Declares `y` as the result of `expr`.
+- `it_filter(cond)`: Skips elements where `cond` is false.
+- `it_take(n)`: Stops the whole pipeline after `n` elements reached it. Only one
+`it_take` per pipeline.
+- `it_zip(U, y, list)`: Declares `y` as the next element of another dynamic
+array. Stops the pipeline when that array has no elements left. Only one
+`it_zip` per pipeline.
+
+## Terminals
+
+- `it_collect(list, value)`: Pushes the value into a dynamic array.
+- `it_fold(acc, expr)`: Assigns `expr` to the accumulator `acc`.
+- `it_count(n)`: Counts the elements.
+
+```c
+u64 sum = 0;
+it_split(line, content, '\n')
+  it_filter(line.len != 0)
+    it_fold(sum, sum + line.len);
+```
+
+> :warning: `break` inside of a pipeline only skips the current element. Use
+`it_take` to stop early.
+*/
+
+#ifndef __CEBUS_ITER_H__
+#define __CEBUS_ITER_H__
+
+#include "cebus/collection/da.h"
+#include "cebus/core/defines.h"
+#include "cebus/os/fs.h"
+#include "cebus/type/string.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The state of the pipeline is declared by the source, so the adapters can
+// stop it.
+#define _IT_STATE __it_stop = 0, __it_taken = 0, __it_z = 0
+#define _IT_RUNNING ((void)__it_taken, (void)__it_z, !__it_stop)
+
+// Declares a variable for exactly one iteration.
+#define _it_let(T, x, expr)                                                                        \
+  for (int __it_once = 1; __it_once; __it_once = 0)                                               \
+    for (T x = (expr); (void)x, __it_once; __it_once = 0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define it_da(T, x, list)                                                                          \
+  for (usize __it_i = 0, _IT_STATE; _IT_RUNNING && __it_i < da_len(list); __it_i++)               \
+  _it_let(T, x, da_get(list, __it_i))
+
+#define it_range(T, x, begin, end)                                                                 \
+  for (usize _IT_STATE; _IT_RUNNING; __it_stop = 1)                                                \
+    for (T x = (begin); _IT_RUNNING && x < (end); x++)
+
+#define it_split(x, str, delim)                                                                    \
+  for (usize _IT_STATE; _IT_RUNNING; __it_stop = 1)                                                \
+    for (Str __it_s = (str), x = {0}; _IT_RUNNING && str_try_chop_by_delim(&__it_s, delim, &x);)
+
+#define it_fs(e, it)                                                                               \
+  for (usize _IT_STATE; _IT_RUNNING; __it_stop = 1)                                                \
+    while (_IT_RUNNING && fs_iter_next(it))                                                        \
+  _it_let(FsEntity, e, (it)->current)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define it_map(U, y, expr) _it_let(U, y, expr)
+
+#define it_filter(cond) if (cond)
+
+#define it_take(n)                                                                                 \
+  if (__it_taken + 1 <= (n) ? (++__it_taken == (n) ? (__it_stop = 1, 1) : 1) : (__it_stop = 1, 0))
+
+#define it_zip(U, y, list)                                                                         \
+  for (int __it_once = 1; __it_once && (__it_z < da_len(list) || (__it_stop = 1, 0));             \
+       __it_once = 0)                                                                              \
+    for (U y = da_get(list, __it_z++); (void)y, __it_once; __it_once = 0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define it_collect(list, value) da_push(list, value)
+#define it_fold(acc, expr) (acc) = (expr)
+#define it_count(n) (n)++
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_ITER_H__ */
@@ -0,0 +1,161 @@
+/* DOCUMENTATION
+A ring buffer stores its elements in a power of two sized array, that wraps
+around at the end. Elements can be added and removed at both ends in constant
+time, so it works as a FIFO queue or a double ended queue. `Deque(T)` is the
+same type as `RingBuffer(T)`. Like `DA` the memory belongs to an `Arena`.
+
+```c
+Arena arena = {0};
+RingBuffer(int) queue = rb_new(&arena);
+rb_push_back(&queue, 1);
+rb_push_back(&queue, 2);
+int first = rb_pop_front(&queue); // 1
+```
+
+## Accessing Elements
+
+> :warning: These operations do not perform any bounds checks.
+
+- `rb_get`: Get the element at an index, counted from the front.
+- `rb_front`, `rb_back`: Get the first or last element.
+- `rb_len`, `rb_empty`: Get the number of elements or check if there are
+none.
+
+## Adding and Removing
+
+- `rb_push_back`, `rb_push_front`: Add an element at the back or front.
+- `rb_pop_back`, `rb_pop_front`: Remove and return the last or first element.
+- `rb_push_back_n`: Add `count` elements from an array at the back. Copies at
+most two spans.
+- `rb_pop_front_n`: Remove `count` elements from the front and copy them into
+an array. Copies at most two spans.
+- `rb_clear`: Remove all elements.
+
+## Resizing and Reserving Space
+
+- `rb_reserve`: Ensure there is enough space for additional elements. The
+capacity is always a power of two. When it grows, the part that wrapped around
+is moved behind the old end, so the elements are contiguous again.
+*/
+
+#ifndef __CEBUS_RING_BUFFER_H__
+#define __CEBUS_RING_BUFFER_H__
+
+#include "cebus/core/arena.h"   // IWYU pragma: export
+#include "cebus/core/defines.h" // IWYU pragma: export
+
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define RingBuffer(T)                                                                              \
+  struct {                                                                                         \
+    usize cap;                                                                                     \
+    usize len;                                                                                     \
+    usize head;                                                                                    \
+    Arena *arena;                                                                                  \
+    T *items;                                                                                      \
+  }
+
+#define Deque(T) RingBuffer(T)
+
+#define RB_MIN_CAP 8
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define _rb_idx(rb, idx) (((rb)->head + (idx)) & ((rb)->cap - 1))
+
+#define rb_get(rb, idx) (rb)->items[_rb_idx(rb, idx)]
+#define rb_front(rb) (rb)->items[(rb)->head]
+#define rb_back(rb) rb_get(rb, (rb)->len - 1)
+#define rb_empty(rb) (!(rb)->len)
+#define rb_len(rb) ((rb)->len)
+
+#define rb_clear(rb) ((rb)->len = 0, (rb)->head = 0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define rb_new(_arena)                                                                             \
+  { .arena = (_arena), .items = NULL, }
+
+#define rb_reserve(rb, size)                                                                       \
+  do {                                                                                             \
+    const usize __rr_size = (rb)->len + (size);                                                    \
+    if (__rr_size <= (rb)->cap) {                                                                  \
+      break;                                                                                       \
+    }                                                                                              \
+    const usize __rr_old = (rb)->cap;                                                              \
+    usize __rr_cap = __rr_old == 0 ? RB_MIN_CAP : __rr_old;                                        \
+    while (__rr_cap < __rr_size) {                                                                 \
+      __rr_cap *= 2;                                                                               \
+    }                                                                                              \
+    (rb)->items = arena_realloc_chunk((rb)->arena, (rb)->items, __rr_cap * sizeof(*(rb)->items));  \
+    (rb)->cap = __rr_cap;                                                                          \
+    if (__rr_old < (rb)->head + (rb)->len) {                                                       \
+      memcpy(&(rb)->items[__rr_old], &(rb)->items[0],                                              \
+             ((rb)->head + (rb)->len - __rr_old) * sizeof(*(rb)->items));                          \
+    }                                                                                              \
+  } while (0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define rb_push_back(rb, ...)                                                                      \
+  do {                                                                                             \
+    rb_reserve(rb, 1);                                                                             \
+    rb_get(rb, (rb)->len) = (__VA_ARGS__);                                                         \
+    (rb)->len++;                                                                                   \
+  } while (0)
+
+#define rb_push_front(rb, ...)                                                                     \
+  do {                                                                                             \
+    rb_reserve(rb, 1);                                                                             \
+    (rb)->head = ((rb)->head - 1) & ((rb)->cap - 1);                                               \
+    (rb)->items[(rb)->head] = (__VA_ARGS__);                                                       \
+    (rb)->len++;                                                                                   \
+  } while (0)
+
+#define rb_pop_back(rb) ((rb)->len--, rb_get(rb, (rb)->len))
+
+#define rb_pop_front(rb)                                                                           \
+  ((rb)->len--, (rb)->head = _rb_idx(rb, 1), (rb)->items[((rb)->head - 1) & ((rb)->cap - 1)])
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define rb_push_back_n(rb, count, array)                                                           \
+  do {                                                                                             \
+    const usize __rp_count = (count);                                                              \
+    if (__rp_count == 0) {                                                                         \
+      break;                                                                                       \
+    }                                                                                              \
+    rb_reserve(rb, __rp_count);                                                                    \
+    const usize __rp_tail = _rb_idx(rb, (rb)->len);                                                \
+    const usize __rp_first =                                                                       \
+        __rp_count < (rb)->cap - __rp_tail ? __rp_count : (rb)->cap - __rp_tail;                   \
+    memcpy(&(rb)->items[__rp_tail], &(array)[0], __rp_first * sizeof(*(rb)->items));               \
+    if (__rp_first < __rp_count) {                                                                 \
+      memcpy(&(rb)->items[0], &(array)[__rp_first],                                                \
+             (__rp_count - __rp_first) * sizeof(*(rb)->items));                                    \
+    }                                                                                              \
+    (rb)->len += __rp_count;                                                                       \
+  } while (0)
+
+#define rb_pop_front_n(rb, count, array)                                                           \
+  do {                                                                                             \
+    const usize __rp_count = (count);                                                              \
+    if (__rp_count == 0) {                                                                         \
+      break;                                                                                       \
+    }                                                                                              \
+    const usize __rp_first =                                                                       \
+        __rp_count < (rb)->cap - (rb)->head ? __rp_count : (rb)->cap - (rb)->head;                 \
+    memcpy(&(array)[0], &(rb)->items[(rb)->head], __rp_first * sizeof(*(rb)->items));              \
+    if (__rp_first < __rp_count) {                                                                 \
+      memcpy(&(array)[__rp_first], &(rb)->items[0],                                                \
+             (__rp_count - __rp_first) * sizeof(*(rb)->items));                                    \
+    }                                                                                              \
+    (rb)->head = _rb_idx(rb, __rp_count);                                                          \
+    (rb)->len -= __rp_count;                                                                       \
+  } while (0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_RING_BUFFER_H__ */
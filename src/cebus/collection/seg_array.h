@@ -0,0 +1,153 @@
+/* DOCUMENTATION
+A segmented array stores its elements in segments that double in size:
+16, 32, 64, ... elements. Growing allocates a new segment instead of
+reallocating, so elements are never copied and pointers to them stay valid
+until the arena is freed.
+
+```c
+Arena arena = {0};
+SEG(Node) nodes = seg_new(&arena);
+seg_push(&nodes, ((Node){.id = 1}));
+Node *node = &seg_get(&nodes, 0); // stays valid
+```
+
+## Accessing Elements
+
+> :warning: These operations do not perform any bounds checks. `seg_get`
+evaluates the index more than once.
+
+- `seg_get`: Get any element. Finding the segment of an index costs one count
+leading zeros instruction.
+- `seg_first`, `seg_last`: Get the first or last element.
+- `seg_pop`: Remove and return the last element.
+- `seg_len`, `seg_empty`: Get the number of elements or check if there are
+none.
+
+## Adding Elements
+
+- `seg_push`: Add an element.
+- `seg_extend`: Add multiple elements from an array.
+- `seg_reserve`: Allocate the segments for additional elements.
+- `seg_clear`: Remove all elements. Keeps the segments for reuse.
+
+## Iteration
+
+`seg_for_each` walks over the elements one segment at a time with a pointer,
+which is as fast as iterating over a dynamic array:
+
+```c
+seg_for_each(Node *, node, &nodes) {
+  node->visited = false;
+}
+```
+
+> :warning: `break` only leaves the current segment.
+*/
+
+#ifndef __CEBUS_SEG_ARRAY_H__
+#define __CEBUS_SEG_ARRAY_H__
+
+#include "cebus/core/arena.h"    // IWYU pragma: export
+#include "cebus/core/defines.h"  // IWYU pragma: export
+#include "cebus/core/platform.h" // IWYU pragma: export
+#include "cebus/type/integer.h"  // IWYU pragma: export
+
+#include <string.h>
+
+///////////////////////////////////////////////////////////////////////////////
+
+// The first segment holds 2^SEG_FIRST_BITS elements.
+#define SEG_FIRST_BITS 4
+#define SEG_FIRST ((usize)1 << SEG_FIRST_BITS)
+#define SEG_MAX_SEGMENTS 48
+
+#define SEG(T)                                                                                     \
+  struct {                                                                                         \
+    usize cap;                                                                                     \
+    usize len;                                                                                     \
+    Arena *arena;                                                                                  \
+    T *segments[SEG_MAX_SEGMENTS];                                                                 \
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(GCC) || defined(CLANG)
+#define _seg_log2(x) ((usize)(63 - __builtin_clzll((unsigned long long)(x))))
+#else
+#define _seg_log2(x) (63 - u64_leading_zeros((u64)(x)))
+#endif
+
+// Segment 'k' holds the indices [SEG_FIRST * (2^k - 1), SEG_FIRST * (2^(k+1) - 1)).
+#define _seg_segment(idx) (_seg_log2((idx) + SEG_FIRST) - SEG_FIRST_BITS)
+#define _seg_offset(idx) ((idx) + SEG_FIRST - (SEG_FIRST << _seg_segment(idx)))
+
+#define _seg_grow(list)                                                                            \
+  do {                                                                                             \
+    const usize __sg_k = _seg_segment((list)->cap);                                                \
+    (list)->segments[__sg_k] =                                                                     \
+        arena_alloc_chunk((list)->arena, (SEG_FIRST << __sg_k) * sizeof(*(list)->segments[0]));    \
+    (list)->cap += SEG_FIRST << __sg_k;                                                            \
+  } while (0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define seg_new(_arena)                                                                            \
+  { .arena = (_arena), }
+
+#define seg_get(list, idx) (list)->segments[_seg_segment(idx)][_seg_offset(idx)]
+#define seg_first(list) (list)->segments[0][0]
+#define seg_last(list) seg_get(list, (list)->len - 1)
+#define seg_pop(list) ((list)->len--, seg_get(list, (list)->len))
+#define seg_empty(list) (!(list)->len)
+#define seg_len(list) ((list)->len)
+
+#define seg_clear(list) ((list)->len = 0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define seg_reserve(list, size)                                                                    \
+  do {                                                                                             \
+    const usize __sr_size = (list)->len + (size);                                                  \
+    while ((list)->cap < __sr_size) {                                                              \
+      _seg_grow(list);                                                                             \
+    }                                                                                              \
+  } while (0)
+
+#define seg_push(list, ...)                                                                        \
+  do {                                                                                             \
+    if ((list)->len == (list)->cap) {                                                              \
+      _seg_grow(list);                                                                             \
+    }                                                                                              \
+    const usize __sp_i = (list)->len++;                                                            \
+    seg_get(list, __sp_i) = (__VA_ARGS__);                                                         \
+  } while (0)
+
+// Copies the array one segment at a time.
+#define seg_extend(list, count, ...)                                                               \
+  do {                                                                                             \
+    const usize __se_count = (count);                                                              \
+    seg_reserve(list, __se_count);                                                                 \
+    for (usize __se_i = 0; __se_i < __se_count;) {                                                 \
+      const usize __se_idx = (list)->len;                                                          \
+      const usize __se_k = _seg_segment(__se_idx);                                                 \
+      const usize __se_off = _seg_offset(__se_idx);                                                \
+      const usize __se_n = usize_min((SEG_FIRST << __se_k) - __se_off, __se_count - __se_i);       \
+      memcpy(&(list)->segments[__se_k][__se_off], &(__VA_ARGS__)[__se_i],                          \
+             __se_n * sizeof(*(list)->segments[0]));                                               \
+      (list)->len += __se_n;                                                                       \
+      __se_i += __se_n;                                                                            \
+    }                                                                                              \
+  } while (0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define seg_for_each(T, iter, list)                                                                \
+  for (usize __sf_k = 0, __sf_i = 0, __sf_n = 0;                                                   \
+       __sf_i < (list)->len &&                                                                     \
+       (__sf_n = usize_min(SEG_FIRST << __sf_k, (list)->len - __sf_i), true);                      \
+       __sf_i += SEG_FIRST << __sf_k++)                                                            \
+    for (T iter = (list)->segments[__sf_k]; iter < (list)->segments[__sf_k] + __sf_n; iter++)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_SEG_ARRAY_H__ */
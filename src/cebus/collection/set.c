@@ -1,14 +1,193 @@
 #include "set.h"
 
+#include "cebus/core/cpu.h"
+#include "cebus/core/platform.h"
 #include "cebus/type/integer.h"
 
 #include <string.h>
 
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
+
 //////////////////////////////////////////////////////////////////////////////
 
 #define SET_DEFAULT_SIZE 8
 #define SET_DELETED_HASH 0xdeaddeaddeaddead
 
+// Both sets need this many members before sorting beats probing the tables.
+#define SET_SORTED_MIN_COUNT 1048576
+// If one set is this many times bigger, probing it with the smaller one wins.
+#define SET_SORTED_MAX_RATIO 4
+// Probing only gets slow once the probe sequences of the table get long.
+#define SET_SORTED_MIN_LOAD_PERCENT 75
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void set_radix_sort(usize count, u64 *items, u64 *temp) {
+  if (count == 0) {
+    return;
+  }
+  static const usize digits = sizeof(u64);
+  usize histogram[sizeof(u64)][256] = {0};
+  for (usize i = 0; i < count; i++) {
+    for (usize d = 0; d < digits; d++) {
+      histogram[d][(items[i] >> (d * 8)) & 0xff]++;
+    }
+  }
+
+  u64 *src = items;
+  u64 *dst = temp;
+  for (usize d = 0; d < digits; d++) {
+    usize *offsets = histogram[d];
+    // every member has the same digit, this pass would not change anything
+    if (offsets[(src[0] >> (d * 8)) & 0xff] == count) {
+      continue;
+    }
+    usize offset = 0;
+    for (usize b = 0; b < 256; b++) {
+      const usize c = offsets[b];
+      offsets[b] = offset;
+      offset += c;
+    }
+    for (usize i = 0; i < count; i++) {
+      dst[offsets[(src[i] >> (d * 8)) & 0xff]++] = src[i];
+    }
+    u64 *swap = src;
+    src = dst;
+    dst = swap;
+  }
+
+  if (src != items) {
+    memcpy(items, src, count * sizeof(u64));
+  }
+}
+
+static usize set_sorted_intersection_scalar(usize n1, const u64 *s1, usize n2, const u64 *s2,
+                                            u64 *out) {
+  usize i = 0, j = 0, k = 0;
+  while (i < n1 && j < n2) {
+    const u64 a = s1[i];
+    const u64 b = s2[j];
+    out[k] = a;
+    k += a == b;
+    i += a <= b;
+    j += b <= a;
+  }
+  return k;
+}
+
+#if defined(CEBUS_SIMD_X86)
+// Compares blocks of four against each other and advances the block with the
+// smaller maximum. Every block writes all four members and only keeps the
+// matches, so the last blocks, that could write past the end of 'out', are
+// left to the scalar loop.
+CEBUS_TARGET_AVX2 static usize set_sorted_intersection_avx2(usize n1, const u64 *s1, usize n2,
+                                                           const u64 *s2, u64 *out) {
+  const usize cap = usize_min(n1, n2);
+  usize i = 0, j = 0, k = 0;
+  while (i + 4 <= n1 && j + 4 <= n2 && k + 4 <= cap) {
+    const __m256i a = _mm256_loadu_si256((const __m256i *)&s1[i]);
+    const __m256i b = _mm256_loadu_si256((const __m256i *)&s2[j]);
+    __m256i eq = _mm256_cmpeq_epi64(a, b);
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x39)));
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x4e)));
+    eq = _mm256_or_si256(eq, _mm256_cmpeq_epi64(a, _mm256_permute4x64_epi64(b, 0x93)));
+    const u32 mask = (u32)_mm256_movemask_pd(_mm256_castsi256_pd(eq));
+    for (usize l = 0; l < 4; l++) {
+      out[k] = s1[i + l];
+      k += (mask >> l) & 1;
+    }
+    const u64 a_max = s1[i + 3];
+    const u64 b_max = s2[j + 3];
+    i += a_max <= b_max ? 4 : 0;
+    j += b_max <= a_max ? 4 : 0;
+  }
+  return k + set_sorted_intersection_scalar(n1 - i, &s1[i], n2 - j, &s2[j], &out[k]);
+}
+#endif
+
+// 'out' needs space for the smaller of the two.
+static usize set_sorted_intersection(usize n1, const u64 *s1, usize n2, const u64 *s2, u64 *out) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return set_sorted_intersection_avx2(n1, s1, n2, s2, out);
+  }
+#endif
+  return set_sorted_intersection_scalar(n1, s1, n2, s2, out);
+}
+
+// 'out' needs space for 'n1' members.
+static usize set_sorted_difference(usize n1, const u64 *s1, usize n2, const u64 *s2, u64 *out) {
+  usize i = 0, j = 0, k = 0;
+  while (i < n1 && j < n2) {
+    const u64 a = s1[i];
+    const u64 b = s2[j];
+    out[k] = a;
+    k += a < b;
+    i += a <= b;
+    j += b <= a;
+  }
+  memcpy(&out[k], &s1[i], (n1 - i) * sizeof(u64));
+  return k + n1 - i;
+}
+
+// 'out' needs space for 'n1 + n2' members.
+static usize set_sorted_symmetric_difference(usize n1, const u64 *s1, usize n2, const u64 *s2,
+                                             u64 *out) {
+  usize i = 0, j = 0, k = 0;
+  while (i < n1 && j < n2) {
+    const u64 a = s1[i];
+    const u64 b = s2[j];
+    out[k] = a < b ? a : b;
+    k += a != b;
+    i += a <= b;
+    j += b <= a;
+  }
+  memcpy(&out[k], &s1[i], (n1 - i) * sizeof(u64));
+  k += n1 - i;
+  memcpy(&out[k], &s2[j], (n2 - j) * sizeof(u64));
+  return k + n2 - j;
+}
+
+static bool set_sorted_subset(usize n1, const u64 *s1, usize n2, const u64 *s2) {
+  usize j = 0;
+  for (usize i = 0; i < n1; i++) {
+    while (j < n2 && s2[j] < s1[i]) {
+      j++;
+    }
+    if (j == n2 || s2[j] != s1[i]) {
+      return false;
+    }
+    j++;
+  }
+  return true;
+}
+
+static bool set_sorted_disjoint(usize n1, const u64 *s1, usize n2, const u64 *s2) {
+  usize i = 0, j = 0;
+  while (i < n1 && j < n2) {
+    const u64 a = s1[i];
+    const u64 b = s2[j];
+    if (a == b) {
+      return false;
+    }
+    i += a < b;
+    j += b < a;
+  }
+  return true;
+}
+
+// Decides if iterating 'set' and probing 'probed' is slower than sorting both.
+static bool set_use_sorted(const Set *set, const Set *probed) {
+  const usize small = usize_min(set->count, probed->count);
+  const usize large = usize_max(set->count, probed->count);
+  if (small < SET_SORTED_MIN_COUNT || SET_SORTED_MAX_RATIO < large / small) {
+    return false;
+  }
+  return probed->cap * SET_SORTED_MIN_LOAD_PERCENT <= probed->count * 100;
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 Set set_create(Arena *arena) {
@@ -61,6 +240,20 @@ void set_resize(Set *set, usize size) {
   arena_free_chunk(set->arena, old_items);
 }
 
+u64 *set_sorted(const Set *set, Arena *arena) {
+  u64 *members = arena_alloc_chunk(arena, usize_max(set->count, 1) * sizeof(u64));
+  usize count = 0;
+  for (usize i = 0; i < set->cap; i++) {
+    if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
+      members[count++] = set->items[i];
+    }
+  }
+  u64 *temp = arena_alloc_chunk(arena, usize_max(count, 1) * sizeof(u64));
+  set_radix_sort(count, members, temp);
+  arena_free_chunk(arena, temp);
+  return members;
+}
+
 void set_reserve(Set *set, usize size) {
   const usize required_size = set->count + size;
   if (required_size < set->cap) {
@@ -169,6 +362,16 @@ bool set_eq(const Set *set, const Set *other) {
     set = other;
     other = temp;
   }
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    const bool eq = memcmp(s1, s2, set->count * sizeof(u64)) == 0;
+    arena_free(&scratch);
+    return eq;
+  }
+
   for (usize i = 0; i < set->cap; i++) {
     if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
       if (!set_contains(other, set->items[i])) {
@@ -183,6 +386,16 @@ bool set_subset(const Set *set, const Set *other) {
   if (other->count < set->count) {
     return false;
   }
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    const bool subset = set_sorted_subset(set->count, s1, other->count, s2);
+    arena_free(&scratch);
+    return subset;
+  }
+
   for (usize i = 0; i < set->cap; i++) {
     if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
       if (!set_contains(other, set->items[i])) {
@@ -203,6 +416,16 @@ bool set_disjoint(const Set *set, const Set *other) {
     set = other;
     other = temp;
   }
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    const bool disjoint = set_sorted_disjoint(set->count, s1, other->count, s2);
+    arena_free(&scratch);
+    return disjoint;
+  }
+
   for (usize i = 0; i < set->cap; i++) {
     if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
       if (set_contains(other, set->items[i])) {
@@ -224,6 +447,20 @@ Set set_intersection(const Set *set, const Set *other, Arena *arena) {
 
   Set intersection = set_create(arena);
   set_reserve(&intersection, usize_min(set->count, other->count) * 2);
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    u64 *out = arena_alloc_chunk(&scratch, usize_min(set->count, other->count) * sizeof(u64));
+    const usize count = set_sorted_intersection(set->count, s1, other->count, s2, out);
+    for (usize i = 0; i < count; i++) {
+      set_add(&intersection, out[i]);
+    }
+    arena_free(&scratch);
+    return intersection;
+  }
+
   for (usize i = 0; i < set->cap; i++) {
     if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
       if (set_contains(other, set->items[i])) {
@@ -237,6 +474,20 @@ Set set_intersection(const Set *set, const Set *other, Arena *arena) {
 Set set_difference(const Set *set, const Set *other, Arena *arena) {
   Set difference = set_create(arena);
   set_reserve(&difference, set->count * 2);
+
+  if (set_use_sorted(set, other)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    u64 *out = arena_alloc_chunk(&scratch, set->count * sizeof(u64));
+    const usize count = set_sorted_difference(set->count, s1, other->count, s2, out);
+    for (usize i = 0; i < count; i++) {
+      set_add(&difference, out[i]);
+    }
+    arena_free(&scratch);
+    return difference;
+  }
+
   for (usize i = 0; i < set->cap; i++) {
     if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
       if (!set_contains(other, set->items[i])) {
@@ -249,6 +500,21 @@ Set set_difference(const Set *set, const Set *other, Arena *arena) {
 
 Set set_union(const Set *set, const Set *other, Arena *arena) {
   Set _union = set_with_size(arena, set->count * 2);
+
+  if (set_use_sorted(set, other) || set_use_sorted(other, set)) {
+    Arena scratch = {0};
+    const u64 *s1 = set_sorted(set, &scratch);
+    const u64 *s2 = set_sorted(other, &scratch);
+    u64 *out = arena_alloc_chunk(&scratch, (set->count + other->count) * sizeof(u64));
+    const usize count = set_sorted_symmetric_difference(set->count, s1, other->count, s2, out);
+    set_reserve(&_union, count);
+    for (usize i = 0; i < count; i++) {
+      set_add(&_union, out[i]);
+    }
+    arena_free(&scratch);
+    return _union;
+  }
+
   for (usize i = 0; i < set->cap; i++) {
     if (set->items[i] && set->items[i] != SET_DELETED_HASH) {
       if (!set_contains(other, set->items[i])) {
@@ -258,7 +524,7 @@ Set set_union(const Set *set, const Set *other, Arena *arena) {
   }
 
   for (usize i = 0; i < other->cap; i++) {
-    if (other->items[i] && set->items[i] != SET_DELETED_HASH) {
+    if (other->items[i] && other->items[i] != SET_DELETED_HASH) {
       if (!set_contains(set, other->items[i])) {
         set_add(&_union, other->items[i]);
       }
@@ -269,6 +535,9 @@ Set set_union(const Set *set, const Set *other, Arena *arena) {
 
 //////////////////////////////////////////////////////////////////////////////
 
+#undef SET_SORTED_MIN_LOAD_PERCENT
+#undef SET_SORTED_MAX_RATIO
+#undef SET_SORTED_MIN_COUNT
 #undef SET_DELETED_HASH
 #undef SET_DEFAULT_SIZE
 
@@ -50,6 +50,23 @@ Combine sets or find their differences using algebraic set operations:
 - `set_intersection`: Find the intersection of two sets.
 - `set_difference`: Find the difference between two sets.
 - `set_union`: Combine two sets into a union.
+
+## Sorted Members
+
+Large sets of similar size are not compared by probing one table with the
+members of the other. Both sets are radix sorted into `u64` arrays and merged
+instead, which reads memory sequentially. Sets that are small or very
+different in size still use the hash lookups.
+
+- `set_sorted`: Get the members of the set as a sorted array with `count`
+elements, allocated in the arena.
+
+```c
+u64 *members = set_sorted(&set, &arena);
+for (usize i = 0; i < set.count; i++) {
+  printf("%" U64_HEX "\n", members[i]);
+}
+```
 */
 
 #ifndef __CEBUS_SET_H__
@@ -80,6 +97,8 @@ Set set_copy(Arena *arena, Set *set);
 void set_resize(Set *set, usize size);
 void set_reserve(Set *set, usize size);
 
+u64 *set_sorted(const Set *set, Arena *arena);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 bool set_add(Set *set, u64 hash);
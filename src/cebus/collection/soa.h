@@ -0,0 +1,117 @@
+/* DOCUMENTATION
+A structure of arrays stores every field of a record in its own column. A loop
+that only reads one field then only loads that column into the cache instead
+of the whole records, and the compiler can vectorize it.
+
+The fields are given as a list macro, that calls `X(T, name)` for every field.
+`SOA_DEFINE(Name, FIELDS)` defines the type `Name` with one column per field,
+the type `NameRow` with one member per field and the functions.
+
+```c
+#define WORD_COUNT_FIELDS(X) X(Str, word) X(usize, count)
+SOA_DEFINE(WordCounts, WORD_COUNT_FIELDS)
+
+Arena arena = {0};
+WordCounts counts = soa_new(&arena);
+WordCounts_push(&counts, (WordCountsRow){.word = STR("hello"), .count = 1});
+
+usize total = 0;
+for (usize i = 0; i < soa_len(&counts); i++) {
+  total += counts.count[i];
+}
+```
+
+## Columns
+
+Every column is a pointer with the name of the field, that can be used
+directly: `counts.count[i]`. Like `DA` the columns belong to the arena and are
+reallocated when they grow, so do not keep pointers into them.
+
+- `soa_new`: Initializer.
+- `soa_len`, `soa_empty`: Get the number of rows or check if there are none.
+- `soa_clear`: Removes all rows.
+
+## Functions
+
+> :warning: These operations do not perform any bounds checks.
+
+- `Name_reserve(soa, size)`: Ensures there is enough space for `size`
+additional rows in every column.
+- `Name_push(soa, row)`: Adds a row.
+- `Name_get(soa, idx)`: Gathers the row at an index.
+- `Name_set(soa, idx, row)`: Overwrites the row at an index.
+- `Name_swap_remove(soa, idx)`: Removes a row by replacing it with the last
+one.
+*/
+
+#ifndef __CEBUS_SOA_H__
+#define __CEBUS_SOA_H__
+
+#include "cebus/core/arena.h"   // IWYU pragma: export
+#include "cebus/core/defines.h" // IWYU pragma: export
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define _SOA_COLUMN(T, name) T *name;
+#define _SOA_MEMBER(T, name) T name;
+#define _SOA_RESIZE(T, name)                                                                       \
+  soa->name = arena_realloc_chunk(soa->arena, soa->name, cap * sizeof(T));
+#define _SOA_SET(T, name) soa->name[idx] = row.name;
+#define _SOA_GET(T, name) row.name = soa->name[idx];
+#define _SOA_MOVE_LAST(T, name) soa->name[idx] = soa->name[soa->len];
+
+#define SOA_DEFINE(Name, FIELDS)                                                                   \
+  typedef struct {                                                                                 \
+    FIELDS(_SOA_MEMBER)                                                                            \
+  } Name##Row;                                                                                     \
+                                                                                                   \
+  typedef struct {                                                                                 \
+    usize cap;                                                                                     \
+    usize len;                                                                                     \
+    Arena *arena;                                                                                  \
+    FIELDS(_SOA_COLUMN)                                                                            \
+  } Name;                                                                                          \
+                                                                                                   \
+  UNUSED static void Name##_reserve(Name *soa, usize size) {                                       \
+    const usize needed = soa->len + size;                                                          \
+    if (needed <= soa->cap) {                                                                      \
+      return;                                                                                      \
+    }                                                                                              \
+    usize cap = soa->cap == 0 ? 8 : soa->cap;                                                      \
+    while (cap < needed) {                                                                         \
+      cap *= 2;                                                                                    \
+    }                                                                                              \
+    FIELDS(_SOA_RESIZE)                                                                            \
+    soa->cap = cap;                                                                                \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_set(Name *soa, usize idx, Name##Row row) { FIELDS(_SOA_SET) }          \
+                                                                                                   \
+  UNUSED static Name##Row Name##_get(const Name *soa, usize idx) {                                 \
+    Name##Row row;                                                                                 \
+    FIELDS(_SOA_GET)                                                                               \
+    return row;                                                                                    \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_push(Name *soa, Name##Row row) {                                       \
+    Name##_reserve(soa, 1);                                                                        \
+    Name##_set(soa, soa->len++, row);                                                              \
+  }                                                                                                \
+                                                                                                   \
+  UNUSED static void Name##_swap_remove(Name *soa, usize idx) {                                    \
+    soa->len--;                                                                                    \
+    FIELDS(_SOA_MOVE_LAST)                                                                         \
+  }
+
+///////////////////////////////////////////////////////////////////////////////
+
+#define soa_new(_arena)                                                                            \
+  { .arena = (_arena), }
+
+#define soa_len(soa) ((soa)->len)
+#define soa_empty(soa) (!(soa)->len)
+#define soa_clear(soa) ((soa)->len = 0)
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_SOA_H__ */
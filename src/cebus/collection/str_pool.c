@@ -0,0 +1,246 @@
+#include "str_pool.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/core/platform.h"
+#include "cebus/os/thread.h"
+#include "cebus/type/string.h"
+
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+#define STR_POOL_DEFAULT_SIZE 16
+// Strings are copied into blocks of this size. Strings bigger than a quarter
+// of it get their own allocation, so a block never wastes much.
+#define STR_POOL_BLOCK 65536
+#define STR_POOL_BATCH 16
+// The slot index comes from the low bits of the hash, the slot stores the high
+// bits next to the id.
+#define STR_POOL_TAG ((u64)0xffffffff00000000)
+
+#if defined(GCC) || defined(CLANG)
+#define STR_POOL_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define STR_POOL_PREFETCH(ptr) ((void)(ptr))
+#endif
+
+struct StrPool {
+  Arena *arena;
+  ThreadLock *lock;
+  // the unique strings and their hashes, indexed by id
+  usize len;
+  usize cap;
+  Str *strs;
+  u64 *hashes;
+  // open addressing with linear probing, '0' is an empty slot
+  usize mask;
+  u64 *table;
+  char *block;
+  usize block_left;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+static inline void str_pool_lock(StrPool *pool) {
+  if (pool->lock) {
+    thread_lock_acquire(pool->lock);
+  }
+}
+
+static inline void str_pool_unlock(StrPool *pool) {
+  if (pool->lock) {
+    thread_lock_release(pool->lock);
+  }
+}
+
+static void str_pool_rehash(StrPool *pool, usize size) {
+  arena_free_chunk(pool->arena, pool->table);
+  pool->table = arena_calloc_chunk(pool->arena, size * sizeof(pool->table[0]));
+  pool->mask = size - 1;
+  for (usize id = 0; id < pool->len; id++) {
+    usize idx = pool->hashes[id] & pool->mask;
+    while (pool->table[idx]) {
+      idx = (idx + 1) & pool->mask;
+    }
+    pool->table[idx] = (pool->hashes[id] & STR_POOL_TAG) | (id + 1);
+  }
+}
+
+// Keeps the table at most three quarters full.
+static void str_pool_reserve_table(StrPool *pool, usize count) {
+  usize size = pool->mask + 1;
+  while (size / 4 * 3 < count) {
+    size *= 2;
+  }
+  if (size != pool->mask + 1) {
+    str_pool_rehash(pool, size);
+  }
+}
+
+static void str_pool_reserve_ids(StrPool *pool, usize count) {
+  if (count <= pool->cap) {
+    return;
+  }
+  usize cap = pool->cap ? pool->cap : STR_POOL_DEFAULT_SIZE;
+  while (cap < count) {
+    cap *= 2;
+  }
+  pool->strs = arena_realloc_chunk(pool->arena, pool->strs, cap * sizeof(pool->strs[0]));
+  pool->hashes = arena_realloc_chunk(pool->arena, pool->hashes, cap * sizeof(pool->hashes[0]));
+  pool->cap = cap;
+}
+
+static const char *str_pool_store(StrPool *pool, Str s) {
+  const usize size = s.len + 1;
+  char *data;
+  if (STR_POOL_BLOCK / 4 < size) {
+    data = arena_alloc(pool->arena, size);
+  } else {
+    if (pool->block_left < size) {
+      pool->block = arena_alloc(pool->arena, STR_POOL_BLOCK);
+      pool->block_left = STR_POOL_BLOCK;
+    }
+    data = pool->block;
+    pool->block += size;
+    pool->block_left -= size;
+  }
+  if (s.len) {
+    memcpy(data, s.data, s.len);
+  }
+  data[s.len] = '\0';
+  return data;
+}
+
+// Returns the slot with the string or the empty slot where it belongs.
+static usize str_pool_probe(const StrPool *pool, Str s, u64 hash) {
+  const u64 tag = hash & STR_POOL_TAG;
+  usize idx = hash & pool->mask;
+  for (u64 slot; (slot = pool->table[idx]); idx = (idx + 1) & pool->mask) {
+    if ((slot & STR_POOL_TAG) == tag && str_eq(pool->strs[(u32)slot - 1], s)) {
+      break;
+    }
+  }
+  return idx;
+}
+
+static u32 str_pool_insert(StrPool *pool, Str s, u64 hash) {
+  str_pool_reserve_table(pool, pool->len + 1);
+  const usize idx = str_pool_probe(pool, s, hash);
+  if (pool->table[idx]) {
+    return (u32)pool->table[idx] - 1;
+  }
+
+  cebus_assert(pool->len < U32_MAX, "StrPool: more than U32_MAX strings");
+  str_pool_reserve_ids(pool, pool->len + 1);
+  pool->strs[pool->len] = str_from_parts(s.len, str_pool_store(pool, s));
+  pool->hashes[pool->len] = hash;
+  pool->table[idx] = (hash & STR_POOL_TAG) | (pool->len + 1);
+  return (u32)pool->len++;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+StrPool *str_pool_create(Arena *arena) {
+  StrPool *pool = arena_calloc(arena, sizeof(StrPool));
+  pool->arena = arena;
+  pool->table = arena_calloc_chunk(arena, STR_POOL_DEFAULT_SIZE * sizeof(pool->table[0]));
+  pool->mask = STR_POOL_DEFAULT_SIZE - 1;
+  return pool;
+}
+
+StrPool *str_pool_create_shared(Arena *arena) {
+  StrPool *pool = str_pool_create(arena);
+  pool->lock = thread_lock_create(arena);
+  return pool;
+}
+
+void str_pool_destroy(StrPool *pool) {
+  if (pool->lock) {
+    thread_lock_destroy(pool->lock);
+    pool->lock = NULL;
+  }
+}
+
+void str_pool_reserve(StrPool *pool, usize count) {
+  str_pool_lock(pool);
+  str_pool_reserve_table(pool, count);
+  str_pool_reserve_ids(pool, count);
+  str_pool_unlock(pool);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+u32 str_pool_intern(StrPool *pool, Str s) {
+  const u64 hash = str_hash(s);
+  str_pool_lock(pool);
+  const u32 id = str_pool_insert(pool, s, hash);
+  str_pool_unlock(pool);
+  return id;
+}
+
+Str str_pool_intern_str(StrPool *pool, Str s) {
+  const u64 hash = str_hash(s);
+  str_pool_lock(pool);
+  const u32 id = str_pool_insert(pool, s, hash);
+  const Str result = pool->strs[id];
+  str_pool_unlock(pool);
+  return result;
+}
+
+void str_pool_intern_batch(StrPool *pool, usize count, const Str *strs, u32 *ids) {
+  u64 hashes[STR_POOL_BATCH];
+  str_pool_lock(pool);
+  for (usize i = 0; i < count; i += STR_POOL_BATCH) {
+    const usize n = count - i < STR_POOL_BATCH ? count - i : STR_POOL_BATCH;
+    for (usize j = 0; j < n; j++) {
+      hashes[j] = str_hash(strs[i + j]);
+      STR_POOL_PREFETCH(&pool->table[hashes[j] & pool->mask]);
+    }
+    for (usize j = 0; j < n; j++) {
+      ids[i + j] = str_pool_insert(pool, strs[i + j], hashes[j]);
+    }
+  }
+  str_pool_unlock(pool);
+}
+
+bool str_pool_find(StrPool *pool, Str s, u32 *id) {
+  const u64 hash = str_hash(s);
+  str_pool_lock(pool);
+  const u64 slot = pool->table[str_pool_probe(pool, s, hash)];
+  str_pool_unlock(pool);
+  if (slot && id) {
+    *id = (u32)slot - 1;
+  }
+  return slot != 0;
+}
+
+Str str_pool_get(StrPool *pool, u32 id) {
+  str_pool_lock(pool);
+  cebus_assert(id < pool->len, "StrPool: id %u out of bounds", id);
+  const Str s = pool->strs[id];
+  str_pool_unlock(pool);
+  return s;
+}
+
+u64 str_pool_hash(StrPool *pool, u32 id) {
+  str_pool_lock(pool);
+  cebus_assert(id < pool->len, "StrPool: id %u out of bounds", id);
+  const u64 hash = pool->hashes[id];
+  str_pool_unlock(pool);
+  return hash;
+}
+
+usize str_pool_len(StrPool *pool) {
+  str_pool_lock(pool);
+  const usize len = pool->len;
+  str_pool_unlock(pool);
+  return len;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef STR_POOL_DEFAULT_SIZE
+#undef STR_POOL_BLOCK
+#undef STR_POOL_BATCH
+#undef STR_POOL_TAG
+#undef STR_POOL_PREFETCH
@@ -0,0 +1,87 @@
+/* DOCUMENTATION
+A `StrPool` interns strings: every unique string is stored once and gets a
+dense `u32` id, starting at `0` in the order they were added. Comparing two
+interned strings is comparing their ids, and data for every string can be kept
+in a plain array that is indexed by the id.
+
+The strings are copied into large blocks of the arena and are terminated with
+a `'\0'`. They never move, so the `Str` of an id stays valid for the lifetime of
+the arena. Two canonical `Str`s are equal if their `data` pointers are equal.
+
+The table stores the id together with 32 bits of the hash, so looking up a
+string compares the whole string only if the hashes match. Adding a string that
+is not in the pool uses the empty slot that the lookup ended on.
+
+## Initialization
+
+```c
+Arena arena = {0};
+StrPool *pool = str_pool_create(&arena);
+```
+
+- `str_pool_create(arena)`: Creates a pool for a single thread.
+- `str_pool_create_shared(arena)`: Creates a pool that can be used by multiple
+threads at once. Every call locks it. It allocates from the arena while it is
+locked, so no other thread may use the arena at the same time.
+- `str_pool_destroy(pool)`: Destroys the lock of a shared pool. The memory
+belongs to the arena.
+- `str_pool_reserve(pool, count)`: Makes room for `count` unique strings.
+
+## Operations
+
+- `str_pool_intern(pool, str)`: Returns the id of the string and adds it, if
+it is not in the pool yet.
+- `str_pool_intern_str(pool, str)`: Same, but returns the canonical `Str`.
+- `str_pool_intern_batch(pool, count, strs, ids)`: Interns `count` strings and
+stores their ids. The next strings are hashed and their slots are prefetched
+while the current ones are looked up. A shared pool is only locked once.
+- `str_pool_find(pool, str, &id)`: Returns `true` and the id if the string is
+in the pool, without adding it.
+- `str_pool_get(pool, id)`: Returns the canonical `Str` of an id.
+- `str_pool_hash(pool, id)`: Returns `str_hash` of the string, without hashing
+it again.
+- `str_pool_len(pool)`: Returns the number of unique strings.
+
+```c
+DA(u32) counts = da_new(&arena);
+for (Str word; str_try_chop_by_charset(&text, &separators, &word);) {
+  const u32 id = str_pool_intern(pool, word);
+  if (id == counts.len) {
+    da_push(&counts, 0);
+  }
+  counts.items[id]++;
+}
+```
+*/
+
+#ifndef __CEBUS_STR_POOL_H__
+#define __CEBUS_STR_POOL_H__
+
+#include "cebus/core/arena.h"
+#include "cebus/core/defines.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct StrPool StrPool;
+
+StrPool *str_pool_create(Arena *arena);
+StrPool *str_pool_create_shared(Arena *arena);
+void str_pool_destroy(StrPool *pool);
+
+void str_pool_reserve(StrPool *pool, usize count);
+
+//////////////////////////////////////////////////////////////////////////////
+
+u32 str_pool_intern(StrPool *pool, Str s);
+Str str_pool_intern_str(StrPool *pool, Str s);
+void str_pool_intern_batch(StrPool *pool, usize count, const Str *strs, u32 *ids);
+
+bool str_pool_find(StrPool *pool, Str s, u32 *id);
+
+Str str_pool_get(StrPool *pool, u32 id);
+u64 str_pool_hash(StrPool *pool, u32 id);
+usize str_pool_len(StrPool *pool);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_STR_POOL_H__ */
@@ -16,11 +16,20 @@ void sb_clear(StringBuilder *sb) { da_clear(sb); }
 
 Str sb_to_str(StringBuilder *sb) { return str_from_parts(sb->len, sb->items); }
 
-void sb_append_parts(StringBuilder *sb, usize size, const char *s) { da_extend(sb, size, s); }
+void sb_append_parts(StringBuilder *sb, usize size, const char *s) {
+  if (size == 0) {
+    return;
+  }
+  da_reserve(sb, size);
+  memcpy(&sb->items[sb->len], s, size);
+  sb->len += size;
+}
 
-void sb_append_cstr(StringBuilder *sb, const char *cstr) { da_extend(sb, strlen(cstr), cstr); }
+void sb_append_cstr(StringBuilder *sb, const char *cstr) {
+  sb_append_parts(sb, strlen(cstr), cstr);
+}
 
-void sb_append_str(StringBuilder *sb, Str str) { da_extend(sb, str.len, str.data); }
+void sb_append_str(StringBuilder *sb, Str str) { sb_append_parts(sb, str.len, str.data); }
 
 void sb_append_c(StringBuilder *sb, char c) { da_push(sb, c); }
 
@@ -60,3 +69,337 @@ usize sb_append_va(StringBuilder *sb, const char *fmt, va_list va) {
 
   return size;
 }
+
+///////////////////////////////////////////////////////////////////////////////
+
+static const char sb_digit_pairs[] = "00010203040506070809"
+                                     "10111213141516171819"
+                                     "20212223242526272829"
+                                     "30313233343536373839"
+                                     "40414243444546474849"
+                                     "50515253545556575859"
+                                     "60616263646566676869"
+                                     "70717273747576777879"
+                                     "80818283848586878889"
+                                     "90919293949596979899";
+
+// Writes the digits backwards from 'end', two at a time, and returns the
+// first one.
+static char *sb_write_u64(char *end, u64 value) {
+  while (100 <= value) {
+    end -= 2;
+    memcpy(end, &sb_digit_pairs[(value % 100) * 2], 2);
+    value /= 100;
+  }
+  if (10 <= value) {
+    end -= 2;
+    memcpy(end, &sb_digit_pairs[value * 2], 2);
+  } else {
+    *--end = (char)('0' + value);
+  }
+  return end;
+}
+
+void sb_append_u64(StringBuilder *sb, u64 value) {
+  char buffer[20];
+  const char *start = sb_write_u64(&buffer[sizeof(buffer)], value);
+  sb_append_parts(sb, (usize)(&buffer[sizeof(buffer)] - start), start);
+}
+
+void sb_append_i64(StringBuilder *sb, i64 value) {
+  char buffer[21];
+  char *start = sb_write_u64(&buffer[sizeof(buffer)], value < 0 ? 0 - (u64)value : (u64)value);
+  if (value < 0) {
+    *--start = '-';
+  }
+  sb_append_parts(sb, (usize)(&buffer[sizeof(buffer)] - start), start);
+}
+
+void sb_append_hex(StringBuilder *sb, u64 value) {
+  static const char digits[] = "0123456789abcdef";
+  char buffer[16];
+  char *start = &buffer[sizeof(buffer)];
+  do {
+    *--start = digits[value & 0xf];
+    value >>= 4;
+  } while (value);
+  sb_append_parts(sb, (usize)(&buffer[sizeof(buffer)] - start), start);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Grisu2 by Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+// Accurately with Integers". It finds the shortest digits in almost every case
+// and digits that round trip in all of them, with 64 bit integers only.
+
+typedef struct {
+  u64 f;
+  i32 e;
+} SbDiyFp;
+
+// Powers of ten from 1e-348 to 1e340 in steps of 8, normalized to 64 bits.
+static const u64 sb_cached_powers_f[] = {
+    0xfa8fd5a0081c0288, 0xbaaee17fa23ebf76, 0x8b16fb203055ac76,
+    0xcf42894a5dce35ea, 0x9a6bb0aa55653b2d, 0xe61acf033d1a45df,
+    0xab70fe17c79ac6ca, 0xff77b1fcbebcdc4f, 0xbe5691ef416bd60c,
+    0x8dd01fad907ffc3c, 0xd3515c2831559a83, 0x9d71ac8fada6c9b5,
+    0xea9c227723ee8bcb, 0xaecc49914078536d, 0x823c12795db6ce57,
+    0xc21094364dfb5637, 0x9096ea6f3848984f, 0xd77485cb25823ac7,
+    0xa086cfcd97bf97f4, 0xef340a98172aace5, 0xb23867fb2a35b28e,
+    0x84c8d4dfd2c63f3b, 0xc5dd44271ad3cdba, 0x936b9fcebb25c996,
+    0xdbac6c247d62a584, 0xa3ab66580d5fdaf6, 0xf3e2f893dec3f126,
+    0xb5b5ada8aaff80b8, 0x87625f056c7c4a8b, 0xc9bcff6034c13053,
+    0x964e858c91ba2655, 0xdff9772470297ebd, 0xa6dfbd9fb8e5b88f,
+    0xf8a95fcf88747d94, 0xb94470938fa89bcf, 0x8a08f0f8bf0f156b,
+    0xcdb02555653131b6, 0x993fe2c6d07b7fac, 0xe45c10c42a2b3b06,
+    0xaa242499697392d3, 0xfd87b5f28300ca0e, 0xbce5086492111aeb,
+    0x8cbccc096f5088cc, 0xd1b71758e219652c, 0x9c40000000000000,
+    0xe8d4a51000000000, 0xad78ebc5ac620000, 0x813f3978f8940984,
+    0xc097ce7bc90715b3, 0x8f7e32ce7bea5c70, 0xd5d238a4abe98068,
+    0x9f4f2726179a2245, 0xed63a231d4c4fb27, 0xb0de65388cc8ada8,
+    0x83c7088e1aab65db, 0xc45d1df942711d9a, 0x924d692ca61be758,
+    0xda01ee641a708dea, 0xa26da3999aef774a, 0xf209787bb47d6b85,
+    0xb454e4a179dd1877, 0x865b86925b9bc5c2, 0xc83553c5c8965d3d,
+    0x952ab45cfa97a0b3, 0xde469fbd99a05fe3, 0xa59bc234db398c25,
+    0xf6c69a72a3989f5c, 0xb7dcbf5354e9bece, 0x88fcf317f22241e2,
+    0xcc20ce9bd35c78a5, 0x98165af37b2153df, 0xe2a0b5dc971f303a,
+    0xa8d9d1535ce3b396, 0xfb9b7cd9a4a7443c, 0xbb764c4ca7a44410,
+    0x8bab8eefb6409c1a, 0xd01fef10a657842c, 0x9b10a4e5e9913129,
+    0xe7109bfba19c0c9d, 0xac2820d9623bf429, 0x80444b5e7aa7cf85,
+    0xbf21e44003acdd2d, 0x8e679c2f5e44ff8f, 0xd433179d9c8cb841,
+    0x9e19db92b4e31ba9, 0xeb96bf6ebadf77d9, 0xaf87023b9bf0ee6b,
+};
+static const i16 sb_cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980, -954, -927,
+    -901, -874, -847, -821, -794, -768, -741, -715, -688, -661, -635, -608,
+    -582, -555, -529, -502, -475, -449, -422, -396, -369, -343, -316, -289,
+    -263, -236, -210, -183, -157, -130, -103, -77, -50, -24, 3, 30,
+    56, 83, 109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614, 641, 667,
+    694, 720, 747, 774, 800, 827, 853, 880, 907, 933, 960, 986,
+    1013, 1039, 1066,
+};
+
+static const u64 sb_pow10[] = {
+    1,
+    10,
+    100,
+    1000,
+    10000,
+    100000,
+    1000000,
+    10000000,
+    100000000,
+    1000000000,
+    10000000000,
+    100000000000,
+    1000000000000,
+    10000000000000,
+    100000000000000,
+    1000000000000000,
+    10000000000000000,
+    100000000000000000,
+    1000000000000000000,
+    10000000000000000000U,
+};
+
+#define SB_F64_HIDDEN_BIT ((u64)1 << 52)
+#define SB_F64_SIGNIFICAND (SB_F64_HIDDEN_BIT - 1)
+
+// The upper 64 bits of the 128 bit product, rounded.
+static SbDiyFp sb_diyfp_mul(SbDiyFp x, SbDiyFp y) {
+  const u64 mask = 0xFFFFFFFF;
+  const u64 a = x.f >> 32, b = x.f & mask, c = y.f >> 32, d = y.f & mask;
+  const u64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+  u64 tmp = (bd >> 32) + (ad & mask) + (bc & mask);
+  tmp += (u64)1 << 31;
+  return (SbDiyFp){ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), x.e + y.e + 64};
+}
+
+static SbDiyFp sb_diyfp_normalize(SbDiyFp x) {
+  while (!(x.f & ((u64)1 << 63))) {
+    x.f <<= 1;
+    x.e--;
+  }
+  return x;
+}
+
+static void sb_grisu_round(char *buffer, usize len, u64 delta, u64 rest, u64 ten_kappa, u64 wp_w) {
+  while (rest < wp_w && ten_kappa <= delta - rest &&
+         (rest + ten_kappa < wp_w || rest + ten_kappa - wp_w < wp_w - rest)) {
+    buffer[len - 1]--;
+    rest += ten_kappa;
+  }
+}
+
+// Generates the digits of 'w' until they are inside of the 'delta' below 'mp'.
+static usize sb_grisu_digits(SbDiyFp w, SbDiyFp mp, u64 delta, char *buffer, i32 *k) {
+  const SbDiyFp one = {(u64)1 << -mp.e, mp.e};
+  const u64 wp_w = mp.f - w.f;
+  u32 p1 = (u32)(mp.f >> -one.e);
+  u64 p2 = mp.f & (one.f - 1);
+  i32 kappa = 1;
+  while (kappa < 10 && sb_pow10[kappa] <= p1) {
+    kappa++;
+  }
+  usize len = 0;
+  while (0 < kappa) {
+    const u32 divisor = (u32)sb_pow10[kappa - 1];
+    const u32 digit = p1 / divisor;
+    p1 %= divisor;
+    if (digit || len) {
+      buffer[len++] = (char)('0' + digit);
+    }
+    kappa--;
+    const u64 rest = ((u64)p1 << -one.e) + p2;
+    if (rest <= delta) {
+      *k += kappa;
+      sb_grisu_round(buffer, len, delta, rest, sb_pow10[kappa] << -one.e, wp_w);
+      return len;
+    }
+  }
+  while (true) {
+    p2 *= 10;
+    delta *= 10;
+    const char digit = (char)(p2 >> -one.e);
+    if (digit || len) {
+      buffer[len++] = (char)('0' + digit);
+    }
+    p2 &= one.f - 1;
+    kappa--;
+    if (p2 < delta) {
+      *k += kappa;
+      const u64 scale = -kappa < 20 ? sb_pow10[-kappa] : 0;
+      sb_grisu_round(buffer, len, delta, p2, one.f, wp_w * scale);
+      return len;
+    }
+  }
+}
+
+// Writes the shortest digits of a positive finite value into 'buffer', so that
+// value = digits * 10^k.
+static usize sb_grisu2(f64 value, char *buffer, i32 *k) {
+  u64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  const i32 biased = (i32)(bits >> 52 & 0x7FF);
+  SbDiyFp v = {bits & SB_F64_SIGNIFICAND, 1 - 1075};
+  if (biased) {
+    v = (SbDiyFp){v.f + SB_F64_HIDDEN_BIT, biased - 1075};
+  }
+
+  // the boundaries halfway to the neighbouring doubles
+  SbDiyFp plus = {(v.f << 1) + 1, v.e - 1};
+  while (!(plus.f & (SB_F64_HIDDEN_BIT << 1))) {
+    plus.f <<= 1;
+    plus.e--;
+  }
+  plus.f <<= 10;
+  plus.e -= 10;
+  SbDiyFp minus = v.f == SB_F64_HIDDEN_BIT ? (SbDiyFp){(v.f << 2) - 1, v.e - 2}
+                                           : (SbDiyFp){(v.f << 1) - 1, v.e - 1};
+  minus.f <<= minus.e - plus.e;
+  minus.e = plus.e;
+
+  // a cached power that brings the exponent into [-60, -32]
+  const f64 dk = (-61 - plus.e) * 0.30102999566398114 + 347;
+  i32 cached = (i32)dk;
+  cached += dk - cached > 0.0;
+  const usize index = (usize)((cached >> 3) + 1);
+  *k = -(-348 + (i32)index * 8);
+  const SbDiyFp c = {sb_cached_powers_f[index], sb_cached_powers_e[index]};
+
+  const SbDiyFp w = sb_diyfp_mul(sb_diyfp_normalize(v), c);
+  SbDiyFp wp = sb_diyfp_mul(plus, c);
+  SbDiyFp wm = sb_diyfp_mul(minus, c);
+  wm.f++;
+  wp.f--;
+  return sb_grisu_digits(w, wp, wp.f - wm.f, buffer, k);
+}
+
+// Formats like JavaScript: plain decimals from 1e-6 up to 1e21, exponents
+// outside of that.
+void sb_append_f64(StringBuilder *sb, f64 value) {
+  char buffer[32];
+  usize len = 0;
+  if (value != value) {
+    sb_append_parts(sb, 3, "nan");
+    return;
+  }
+  u64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  if (bits >> 63) {
+    buffer[len++] = '-';
+    value = -value;
+  }
+  if (value == 0) {
+    buffer[len++] = '0';
+    sb_append_parts(sb, len, buffer);
+    return;
+  }
+  if (value - value != 0) {
+    memcpy(&buffer[len], "inf", 3);
+    sb_append_parts(sb, len + 3, buffer);
+    return;
+  }
+
+  char digits[20];
+  i32 k = 0;
+  const usize count = sb_grisu2(value, digits, &k);
+  const i32 n = (i32)count + k; // position of the decimal point
+
+  if ((i32)count <= n && n <= 21) {
+    memcpy(&buffer[len], digits, count);
+    len += count;
+    for (i32 i = (i32)count; i < n; i++) {
+      buffer[len++] = '0';
+    }
+  } else if (0 < n && n <= 21) {
+    memcpy(&buffer[len], digits, (usize)n);
+    len += (usize)n;
+    buffer[len++] = '.';
+    memcpy(&buffer[len], &digits[n], count - (usize)n);
+    len += count - (usize)n;
+  } else if (-6 < n && n <= 0) {
+    buffer[len++] = '0';
+    buffer[len++] = '.';
+    for (i32 i = n; i < 0; i++) {
+      buffer[len++] = '0';
+    }
+    memcpy(&buffer[len], digits, count);
+    len += count;
+  } else {
+    buffer[len++] = digits[0];
+    if (1 < count) {
+      buffer[len++] = '.';
+      memcpy(&buffer[len], &digits[1], count - 1);
+      len += count - 1;
+    }
+    const i32 exponent = n - 1;
+    buffer[len++] = 'e';
+    buffer[len++] = exponent < 0 ? '-' : '+';
+    char *end = &buffer[sizeof(buffer)];
+    const char *start = sb_write_u64(end, (u64)(exponent < 0 ? -exponent : exponent));
+    memmove(&buffer[len], start, (usize)(end - start));
+    len += (usize)(end - start);
+  }
+  sb_append_parts(sb, len, buffer);
+}
+
+#undef SB_F64_HIDDEN_BIT
+#undef SB_F64_SIGNIFICAND
+
+static bool sb_append_part(void *ctx, Str part) {
+  sb_append_str(ctx, part);
+  return true;
+}
+
+void sb_append_replace(StringBuilder *sb, Str s, Str old, Str new) {
+  // enough for the output, if nothing grows
+  da_reserve(sb, s.len);
+  _str_replace_each(s, old, new, false, sb_append_part, sb);
+}
+
+void sb_append_replace_ignorecase(StringBuilder *sb, Str s, Str old, Str new) {
+  da_reserve(sb, s.len);
+  _str_replace_each(s, old, new, true, sb_append_part, sb);
+}
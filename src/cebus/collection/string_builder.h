@@ -33,6 +33,29 @@ formatting.
   Appends a formatted string and va_list to the `StringBuilder`, similar to
 `vprintf` style formatting.
 
+- **`void sb_append_u64(StringBuilder *sb, u64 value);`**,
+**`void sb_append_i64(StringBuilder *sb, i64 value);`**
+  Appends a number in decimal, two digits at a time from a table.
+
+- **`void sb_append_hex(StringBuilder *sb, u64 value);`**
+  Appends a number in lowercase hexadecimal without a prefix.
+
+- **`void sb_append_f64(StringBuilder *sb, f64 value);`**
+  Appends the shortest digits that read back as the same `f64` (Grisu2), like
+JavaScript: `0.1`, `1e+21`, `1.5e-7`, `nan`, `-inf`.
+
+None of these go through `printf`, so they do not depend on the locale.
+
+- **`void sb_append_replace(StringBuilder *sb, Str s, Str old, Str new);`**,
+**`void sb_append_replace_ignorecase(StringBuilder *sb, Str s, Str old, Str
+new);`**
+  Appends `s` with every non overlapping occurrence of `old` replaced by `new`,
+in a single pass. Unlike `str_replace`, it does not keep a scratch list of the
+match positions and does not allocate the whole result at once at the end, it
+copies every span into the builder as soon as it is found. The `_ignorecase`
+version ignores the case of ASCII letters. `io_write_replace` writes into a
+`FILE *` instead.
+
 */
 
 #ifndef __CEBUS_STRING_BUILDER_H__
@@ -59,4 +82,12 @@ void sb_append_c(StringBuilder *sb, char c);
 FMT(2) usize sb_append_fmt(StringBuilder *sb, const char *fmt, ...);
 usize sb_append_va(StringBuilder *sb, const char *fmt, va_list va);
 
+void sb_append_u64(StringBuilder *sb, u64 value);
+void sb_append_i64(StringBuilder *sb, i64 value);
+void sb_append_hex(StringBuilder *sb, u64 value);
+void sb_append_f64(StringBuilder *sb, f64 value);
+
+void sb_append_replace(StringBuilder *sb, Str s, Str old, Str new);
+void sb_append_replace_ignorecase(StringBuilder *sb, Str s, Str old, Str new);
+
 #endif /* !__CEBUS_STRING_BUILDER_H__ */
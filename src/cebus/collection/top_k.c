@@ -0,0 +1,208 @@
+#include "top_k.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/integer.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+//////////////////////////////////////////////////////////////////////////////
+
+// A tracked hash gets replaced every time an untracked one is added. The
+// 'HashMap' would fill up with deleted entries, so the tracker uses its own
+// linear probing table that removes entries without tombstones.
+
+static usize topk_slot(const TopK *topk, u64 hash) {
+  return u64_mix(hash) & (topk->table_cap - 1);
+}
+
+// Returns the table index of the hash or of the empty slot where it belongs.
+static usize topk_find(const TopK *topk, u64 hash) {
+  usize idx = topk_slot(topk, hash);
+  while (topk->table[idx] && topk->items[topk->table[idx] - 1].hash != hash) {
+    idx = (idx + 1) & (topk->table_cap - 1);
+  }
+  return idx;
+}
+
+static void topk_table_remove(TopK *topk, u64 hash) {
+  usize idx = topk_find(topk, hash);
+  topk->table[idx] = 0;
+  // move back entries that would not be found anymore
+  for (usize next = (idx + 1) & (topk->table_cap - 1); topk->table[next];
+       next = (next + 1) & (topk->table_cap - 1)) {
+    const usize home = topk_slot(topk, topk->items[topk->table[next] - 1].hash);
+    if (((next - home) & (topk->table_cap - 1)) >= ((next - idx) & (topk->table_cap - 1))) {
+      topk->table[idx] = topk->table[next];
+      topk->table[next] = 0;
+      idx = next;
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+static void topk_heap_swap(TopK *topk, usize a, usize b) {
+  const usize temp = topk->heap[a];
+  topk->heap[a] = topk->heap[b];
+  topk->heap[b] = temp;
+  topk->positions[topk->heap[a]] = a;
+  topk->positions[topk->heap[b]] = b;
+}
+
+static u64 topk_heap_count(const TopK *topk, usize pos) {
+  return topk->items[topk->heap[pos]].count;
+}
+
+static void topk_sift_up(TopK *topk, usize pos) {
+  while (pos && topk_heap_count(topk, pos) < topk_heap_count(topk, (pos - 1) / 2)) {
+    topk_heap_swap(topk, pos, (pos - 1) / 2);
+    pos = (pos - 1) / 2;
+  }
+}
+
+static void topk_sift_down(TopK *topk, usize pos) {
+  while (true) {
+    usize min = pos;
+    const usize left = pos * 2 + 1;
+    const usize right = pos * 2 + 2;
+    if (left < topk->len && topk_heap_count(topk, left) < topk_heap_count(topk, min)) {
+      min = left;
+    }
+    if (right < topk->len && topk_heap_count(topk, right) < topk_heap_count(topk, min)) {
+      min = right;
+    }
+    if (min == pos) {
+      return;
+    }
+    topk_heap_swap(topk, pos, min);
+    pos = min;
+  }
+}
+
+static void topk_push(TopK *topk, TopKEntry entry) {
+  const usize slot = topk->len++;
+  topk->items[slot] = entry;
+  topk->table[topk_find(topk, entry.hash)] = slot + 1;
+  topk->heap[slot] = slot;
+  topk->positions[slot] = slot;
+  topk_sift_up(topk, slot);
+}
+
+static int topk_compare_count(const void *a, const void *b) {
+  const TopKEntry *e1 = a;
+  const TopKEntry *e2 = b;
+  return e1->count < e2->count ? 1 : e1->count > e2->count ? -1 : 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+TopK topk_create(Arena *arena, usize k) {
+  cebus_assert(k != 0, "k has to be at least 1");
+  TopK topk = {0};
+  topk.arena = arena;
+  topk.k = k;
+  topk.table_cap = 1;
+  while (topk.table_cap < k * 2) {
+    topk.table_cap *= 2;
+  }
+  topk.items = arena_alloc_chunk(arena, k * sizeof(topk.items[0]));
+  topk.heap = arena_alloc_chunk(arena, k * sizeof(topk.heap[0]));
+  topk.positions = arena_alloc_chunk(arena, k * sizeof(topk.positions[0]));
+  topk.table = arena_calloc_chunk(arena, topk.table_cap * sizeof(topk.table[0]));
+  return topk;
+}
+
+void topk_clear(TopK *topk) {
+  topk->len = 0;
+  topk->total = 0;
+  memset(topk->table, 0, topk->table_cap * sizeof(topk->table[0]));
+}
+
+TopK topk_copy(Arena *arena, const TopK *topk) {
+  TopK new = topk_create(arena, topk->k);
+  for (usize i = 0; i < topk->len; i++) {
+    topk_push(&new, topk->items[i]);
+  }
+  new.total = topk->total;
+  return new;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+void topk_add(TopK *topk, u64 hash, u64 count) {
+  topk->total += count;
+  const usize idx = topk_find(topk, hash);
+  if (topk->table[idx]) {
+    const usize slot = topk->table[idx] - 1;
+    topk->items[slot].count += count;
+    topk_sift_down(topk, topk->positions[slot]);
+    return;
+  }
+  if (topk->len < topk->k) {
+    topk_push(topk, (TopKEntry){.hash = hash, .count = count});
+    return;
+  }
+  // replace the least frequent hash, it could have occured 'min' times
+  const usize slot = topk->heap[0];
+  const u64 min = topk->items[slot].count;
+  topk_table_remove(topk, topk->items[slot].hash);
+  topk->items[slot] = (TopKEntry){.hash = hash, .count = min + count, .error = min};
+  topk->table[topk_find(topk, hash)] = slot + 1;
+  topk_sift_down(topk, 0);
+}
+
+const TopKEntry *topk_get(const TopK *topk, u64 hash) {
+  const usize idx = topk_find(topk, hash);
+  return topk->table[idx] ? &topk->items[topk->table[idx] - 1] : NULL;
+}
+
+u64 topk_min(const TopK *topk) {
+  return topk->len < topk->k ? 0 : topk_heap_count(topk, 0);
+}
+
+TopKEntry *topk_sorted(const TopK *topk, Arena *arena) {
+  TopKEntry *entries = arena_alloc(arena, (topk->len + 1) * sizeof(entries[0]));
+  memcpy(entries, topk->items, topk->len * sizeof(entries[0]));
+  qsort(entries, topk->len, sizeof(entries[0]), topk_compare_count);
+  return entries;
+}
+
+// Agarwal et al., "Mergeable Summaries": a hash that is missing in one of the
+// trackers could have occured up to the smallest count of that tracker.
+void topk_merge(TopK *topk, const TopK *other) {
+  const u64 min = topk_min(topk);
+  const u64 other_min = topk_min(other);
+  Arena scratch = {0};
+  TopKEntry *candidates =
+      arena_alloc(&scratch, (topk->len + other->len + 1) * sizeof(candidates[0]));
+  usize len = 0;
+  for (usize i = 0; i < topk->len; i++) {
+    const TopKEntry *entry = &topk->items[i];
+    const TopKEntry *o = topk_get(other, entry->hash);
+    candidates[len++] = (TopKEntry){
+        .hash = entry->hash,
+        .count = entry->count + (o ? o->count : other_min),
+        .error = entry->error + (o ? o->error : other_min),
+    };
+  }
+  for (usize i = 0; i < other->len; i++) {
+    const TopKEntry *entry = &other->items[i];
+    if (topk_get(topk, entry->hash) == NULL) {
+      candidates[len++] = (TopKEntry){
+          .hash = entry->hash,
+          .count = entry->count + min,
+          .error = entry->error + min,
+      };
+    }
+  }
+  qsort(candidates, len, sizeof(candidates[0]), topk_compare_count);
+
+  const u64 total = topk->total + other->total;
+  topk_clear(topk);
+  for (usize i = 0; i < len && i < topk->k; i++) {
+    topk_push(topk, candidates[i]);
+  }
+  topk->total = total;
+  arena_free(&scratch);
+}
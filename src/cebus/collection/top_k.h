@@ -0,0 +1,93 @@
+/* DOCUMENTATION
+`TopK` keeps track of the `k` most frequent hashes of a stream with the
+Space-Saving algorithm. It never stores more than `k` hashes, no matter how big
+the stream gets.
+
+Every tracked hash has a `count` and an `error`. The real count of the hash is
+between `count - error` and `count`. Every hash that occurs more than
+`total / k` times is guaranteed to be tracked.
+
+Only the `u64` hashes are tracked, not the items themselves. Keep a `HashMap`
+from the hash to the item, if the items are needed for the report.
+
+## Initialization
+
+```c
+Arena arena = {0};
+TopK topk = topk_create(&arena, 100);
+```
+
+- `topk_create`: Creates a tracker for `k` hashes.
+- `topk_clear`: Removes all hashes.
+- `topk_copy`: Creates a copy of the tracker.
+
+## Operations
+
+- `topk_add`: Adds `count` occurences of the hash. If `k` hashes are already
+tracked, the least frequent one is replaced.
+- `topk_get`: Gets the entry of a tracked hash or `NULL`.
+- `topk_min`: Gets the smallest tracked count. Every hash that is not tracked
+occured at most this many times.
+- `topk_sorted`: Gets all tracked entries sorted by their count, the most
+frequent first. The array has `len` elements and is allocated in the arena.
+- `topk_merge`: Adds another tracker, for example from another thread or shard.
+
+```c
+for (usize i = 0; i < words.len; i++) {
+  topk_add(&topk, str_hash(words.items[i]), 1);
+}
+TopKEntry *top = topk_sorted(&topk, &arena);
+for (usize i = 0; i < topk.len; i++) {
+  printf("%" U64_FMT "\n", top[i].count);
+}
+```
+*/
+
+#ifndef __CEBUS_TOP_K_H__
+#define __CEBUS_TOP_K_H__
+
+#include "cebus/core/arena.h"
+#include "cebus/core/defines.h"
+
+//////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  u64 hash;
+  u64 count;
+  u64 error;
+} TopKEntry;
+
+typedef struct {
+  usize k;
+  usize len;
+  u64 total;
+  Arena *arena;
+  TopKEntry *items;
+  usize *heap;
+  usize *positions;
+  usize table_cap;
+  usize *table;
+} TopK;
+
+//////////////////////////////////////////////////////////////////////////////
+
+TopK topk_create(Arena *arena, usize k);
+
+void topk_clear(TopK *topk);
+
+TopK topk_copy(Arena *arena, const TopK *topk);
+
+//////////////////////////////////////////////////////////////////////////////
+
+void topk_add(TopK *topk, u64 hash, u64 count);
+
+const TopKEntry *topk_get(const TopK *topk, u64 hash);
+u64 topk_min(const TopK *topk);
+
+TopKEntry *topk_sorted(const TopK *topk, Arena *arena);
+
+void topk_merge(TopK *topk, const TopK *other);
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_TOP_K_H__ */
@@ -132,6 +132,7 @@ void *arena_realloc_chunk(Arena *arena, void *ptr, usize size) {
     return chunk->data;
   }
   Chunk *new_chunk = realloc(chunk, sizeof(Chunk) + size);
+  new_chunk->allocated = size;
   if (new_chunk->prev) {
     new_chunk->prev->next = new_chunk;
   }
@@ -0,0 +1,65 @@
+#include "cpu.h"
+
+#include "cebus/core/platform.h"
+
+////////////////////////////////////////////////////////////////////////////
+#if defined(CEBUS_SIMD_X86) && (defined(GCC) || defined(CLANG))
+
+bool cpu_has_sse2(void) { return __builtin_cpu_supports("sse2"); }
+
+bool cpu_has_avx2(void) { return __builtin_cpu_supports("avx2"); }
+
+////////////////////////////////////////////////////////////////////////////
+#elif defined(CEBUS_SIMD_X86) && defined(MSVC)
+#include <intrin.h>
+
+bool cpu_has_sse2(void) { return true; }
+
+bool cpu_has_avx2(void) {
+  static i32 has_avx2 = -1;
+  if (has_avx2 == -1) {
+    int info[4] = {0};
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    // the os has to save the ymm registers
+    const bool ymm = osxsave && avx && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    has_avx2 = ymm && (info[1] & (1 << 5)) != 0;
+  }
+  return has_avx2;
+}
+
+////////////////////////////////////////////////////////////////////////////
+#else
+
+bool cpu_has_sse2(void) { return false; }
+
+bool cpu_has_avx2(void) { return false; }
+
+#endif
+////////////////////////////////////////////////////////////////////////////
+#if defined(LINUX)
+#include <unistd.h>
+
+usize cpu_count(void) {
+  const long count = sysconf(_SC_NPROCESSORS_ONLN);
+  return count < 1 ? 1 : (usize)count;
+}
+
+////////////////////////////////////////////////////////////////////////////
+#elif defined(WINDOWS)
+
+usize cpu_count(void) {
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwNumberOfProcessors < 1 ? 1 : (usize)info.dwNumberOfProcessors;
+}
+
+////////////////////////////////////////////////////////////////////////////
+#else
+
+usize cpu_count(void) { return 1; }
+
+#endif
+////////////////////////////////////////////////////////////////////////////
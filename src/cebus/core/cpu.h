@@ -0,0 +1,32 @@
+/* DOCUMENTATION
+## Runtime CPU Features
+
+Functions that have a vectorized implementation check these at runtime, so the
+library can be compiled for the baseline architecture and still use wider
+instructions if the machine supports them.
+
+- `cpu_has_sse2()`: Checks if the CPU supports SSE2.
+- `cpu_has_avx2()`: Checks if the CPU and the operating system support AVX2.
+- `cpu_count()`: Returns the number of logical CPUs that are online.
+
+```c
+if (cpu_has_avx2()) {
+  // use the AVX2 kernel
+}
+```
+*/
+
+#ifndef __CEBUS_CPU_H__
+#define __CEBUS_CPU_H__
+
+#include "cebus/core/defines.h"
+
+////////////////////////////////////////////////////////////////////////////
+
+bool cpu_has_sse2(void);
+bool cpu_has_avx2(void);
+usize cpu_count(void);
+
+////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_CPU_H__ */
@@ -9,6 +9,8 @@ ARM.
 MSVC.
 - **CPU Bitness**: Distinguishes between 32-bit and 64-bit environments.
 - **Byte Order**: Defines the system's byte order (endianness).
+- **SIMD**: Defines `CEBUS_SIMD_X86` if x86 vector intrinsics can be used and
+`CEBUS_TARGET_AVX2` to compile single functions for AVX2.
 */
 
 #ifndef __CEBUS_PLATFORM_H__
@@ -162,6 +164,17 @@ MSVC.
 #endif
 /* !Byte-Order */
 
+////////////////////////////////////////////////////////////////////////////
+/* SIMD */
+#if defined(x86_64) && (defined(GCC) || defined(CLANG))
+#define CEBUS_SIMD_X86
+#define CEBUS_TARGET_AVX2 __attribute__((target("avx2")))
+#elif defined(x86_64) && defined(MSVC)
+#define CEBUS_SIMD_X86
+#define CEBUS_TARGET_AVX2
+#endif
+/* !SIMD */
+
 ////////////////////////////////////////////////////////////////////////////
 
 #ifdef __cross__
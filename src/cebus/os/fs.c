@@ -2,6 +2,7 @@
 
 #include "cebus/core/debug.h"
 #include "cebus/core/error.h"
+#include "cebus/type/byte.h"
 #include "cebus/type/path.h"
 #include "cebus/type/string.h"
 #include "cebus/type/utf8.h"
@@ -117,6 +118,29 @@ defer:
   return res;
 }
 
+u64 fs_file_hash(Path filename, Error *error) {
+  Hasher hasher = hasher_init(0);
+
+  FILE *handle = fs_file_open(filename, "rb", error);
+  error_propagate(error, { goto defer; });
+
+  u8 buffer[16 * 1024];
+  while (true) {
+    Bytes chunk = io_read_bytes(handle, sizeof(buffer), buffer, error);
+    error_propagate(error, { goto defer; });
+    if (chunk.size == 0) {
+      break;
+    }
+    hasher_update(&hasher, chunk);
+  }
+
+defer:
+  if (handle) {
+    fs_file_close(handle, error);
+  }
+  return hasher_final(&hasher);
+}
+
 void fs_file_write_bytes(Path filename, Bytes bytes, Error *error) {
   FILE *handle = fs_file_open(filename, "w", error);
   error_propagate(error, { goto defer; });
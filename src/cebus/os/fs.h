@@ -9,6 +9,10 @@ string.
   - `fs_file_read_utf8(filename, arena, error)`: Reads the entire file into
 UTF-8 format.
 
+- **Hashing Files**:
+  - `fs_file_hash(filename, error)`: Hashes the file in chunks with a `Hasher`,
+without reading all of it into memory. Same as `bytes_hash` of its content.
+
 - **Writing Files**:
   - `fs_file_write_bytes(filename, bytes, error)`: Writes byte data to a file.
   - `fs_file_write_str(filename, content, error)`: Writes a string to a file.
@@ -64,6 +68,8 @@ Bytes fs_file_read_bytes(Path filename, Arena *arena, Error *error);
 Str fs_file_read_str(Path filename, Arena *arena, Error *error);
 Utf8 fs_file_read_utf8(Path filename, Arena *arena, Error *error);
 
+u64 fs_file_hash(Path filename, Error *error);
+
 void fs_file_write_bytes(Path filename, Bytes bytes, Error *error);
 void fs_file_write_str(Path filename, Str content, Error *error);
 void fs_file_write_utf8(Path filename, Utf8 content, Error *error);
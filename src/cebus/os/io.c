@@ -34,6 +34,28 @@ void io_write_str(FILE *file, Str string, Error *error) {
   io_write_bytes(file, str_to_bytes(string), error);
 }
 
+static bool io_write_part(void *ctx, Str part) {
+  FILE *file = ctx;
+  fwrite(part.data, sizeof(part.data[0]), part.len, file);
+  return !ferror(file);
+}
+
+void io_write_replace(FILE *file, Str s, Str old, Str new, Error *error) {
+  errno = 0;
+  _str_replace_each(s, old, new, false, io_write_part, file);
+  if (ferror(file)) {
+    error_emit(error, errno, "Could not write file: %s", strerror(errno));
+  }
+}
+
+void io_write_replace_ignorecase(FILE *file, Str s, Str old, Str new, Error *error) {
+  errno = 0;
+  _str_replace_each(s, old, new, true, io_write_part, file);
+  if (ferror(file)) {
+    error_emit(error, errno, "Could not write file: %s", strerror(errno));
+  }
+}
+
 Bytes io_read_bytes(FILE *file, usize size, void *buffer, Error *error) {
   errno = 0;
   const usize bytes_read = fread(buffer, sizeof(u8), size, file);
@@ -4,6 +4,10 @@
 - **Output**:
   - `io_write(file, fmt, ...)`: Writes a formated string into the file
   - `io_write_bytes(file, bytes, error)`: Writes byte data to a file or stream.
+  - `io_write_replace(file, str, old, new, error)`,
+`io_write_replace_ignorecase(...)`: Writes the string with every occurrence of
+`old` replaced by `new`, like `sb_append_replace`, without building the result
+in memory first.
 
 - **Input**:
   - `io_read_bytes(file, size, buffer, error)`: Reads a specified amount of byte
@@ -43,6 +47,8 @@ input: 'name'
 FMT(2) usize io_write_fmt(FILE *file, const char *fmt, ...);
 void io_write_bytes(FILE *file, Bytes bytes, Error *error);
 void io_write_str(FILE *file, Str string, Error *error);
+void io_write_replace(FILE *file, Str s, Str old, Str new, Error *error);
+void io_write_replace_ignorecase(FILE *file, Str s, Str old, Str new, Error *error);
 
 Bytes io_read_bytes(FILE *file, usize size, void *buffer, Error *error);
 Str io_read_line(FILE *file, usize size, char *buffer, Error *error);
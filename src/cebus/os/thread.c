@@ -0,0 +1,231 @@
+#include "thread.h"
+
+#include "cebus/core/cpu.h"
+#include "cebus/core/debug.h"
+#include "cebus/core/platform.h"
+
+////////////////////////////////////////////////////////////////////////////
+#if defined(LINUX)
+#include <pthread.h>
+
+typedef pthread_t ThreadHandle;
+typedef pthread_mutex_t ThreadMutex;
+typedef pthread_cond_t ThreadCondition;
+
+#define THREAD_FN(name, arg) static void *name(void *arg)
+#define THREAD_RETURN return NULL
+
+#define mutex_init(m) pthread_mutex_init(m, NULL)
+#define mutex_destroy(m) pthread_mutex_destroy(m)
+#define mutex_lock(m) pthread_mutex_lock(m)
+#define mutex_unlock(m) pthread_mutex_unlock(m)
+#define condition_init(c) pthread_cond_init(c, NULL)
+#define condition_destroy(c) pthread_cond_destroy(c)
+#define condition_wait(c, m) pthread_cond_wait(c, m)
+#define condition_broadcast(c) pthread_cond_broadcast(c)
+
+#define thread_start(t, fn, arg) (pthread_create(t, NULL, fn, arg) == 0)
+#define thread_join(t) pthread_join(t, NULL)
+
+#define THREAD_POOL_THREADS
+
+////////////////////////////////////////////////////////////////////////////
+#elif defined(WINDOWS)
+
+typedef HANDLE ThreadHandle;
+typedef CRITICAL_SECTION ThreadMutex;
+typedef CONDITION_VARIABLE ThreadCondition;
+
+#define THREAD_FN(name, arg) static DWORD WINAPI name(LPVOID arg)
+#define THREAD_RETURN return 0
+
+#define mutex_init(m) InitializeCriticalSection(m)
+#define mutex_destroy(m) DeleteCriticalSection(m)
+#define mutex_lock(m) EnterCriticalSection(m)
+#define mutex_unlock(m) LeaveCriticalSection(m)
+#define condition_init(c) InitializeConditionVariable(c)
+#define condition_destroy(c) ((void)(c))
+#define condition_wait(c, m) SleepConditionVariableCS(c, m, INFINITE)
+#define condition_broadcast(c) WakeAllConditionVariable(c)
+
+#define thread_start(t, fn, arg) ((*(t) = CreateThread(NULL, 0, fn, arg, 0, NULL)) != NULL)
+#define thread_join(t) (WaitForSingleObject(t, INFINITE), CloseHandle(t))
+
+#define THREAD_POOL_THREADS
+
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+#if defined(THREAD_POOL_THREADS)
+
+struct ThreadPool {
+  usize threads;
+  ThreadHandle *workers;
+  ThreadMutex mutex;
+  ThreadCondition work;
+  ThreadCondition done;
+  bool stop;
+  // incremented for every job, so a worker knows when there is a new one
+  usize generation;
+  ThreadTask fn;
+  void *ctx;
+  usize tasks;
+  usize next;
+  usize finished;
+};
+
+// Runs tasks of the current job until none are left. Expects the mutex to be
+// locked.
+static void thread_pool_work(ThreadPool *pool) {
+  while (pool->next < pool->tasks) {
+    const usize task = pool->next++;
+    mutex_unlock(&pool->mutex);
+    pool->fn(pool->ctx, task);
+    mutex_lock(&pool->mutex);
+    if (++pool->finished == pool->tasks) {
+      condition_broadcast(&pool->done);
+    }
+  }
+}
+
+THREAD_FN(thread_pool_worker, arg) {
+  ThreadPool *pool = arg;
+  mutex_lock(&pool->mutex);
+  usize generation = pool->generation;
+  while (true) {
+    while (!pool->stop && generation == pool->generation) {
+      condition_wait(&pool->work, &pool->mutex);
+    }
+    if (pool->stop) {
+      break;
+    }
+    generation = pool->generation;
+    thread_pool_work(pool);
+  }
+  mutex_unlock(&pool->mutex);
+  THREAD_RETURN;
+}
+
+ThreadPool *thread_pool_create(Arena *arena, usize threads) {
+  ThreadPool *pool = arena_calloc(arena, sizeof(ThreadPool));
+  pool->threads = threads == 0 ? cpu_count() : threads;
+  pool->workers = arena_calloc(arena, pool->threads * sizeof(ThreadHandle));
+  mutex_init(&pool->mutex);
+  condition_init(&pool->work);
+  condition_init(&pool->done);
+  for (usize i = 0; i + 1 < pool->threads; i++) {
+    const bool started = thread_start(&pool->workers[i], thread_pool_worker, pool);
+    cebus_assert(started, "Could not start worker thread");
+  }
+  return pool;
+}
+
+void thread_pool_destroy(ThreadPool *pool) {
+  mutex_lock(&pool->mutex);
+  pool->stop = true;
+  condition_broadcast(&pool->work);
+  mutex_unlock(&pool->mutex);
+  for (usize i = 0; i + 1 < pool->threads; i++) {
+    thread_join(pool->workers[i]);
+  }
+  condition_destroy(&pool->done);
+  condition_destroy(&pool->work);
+  mutex_destroy(&pool->mutex);
+}
+
+void thread_pool_run(ThreadPool *pool, usize tasks, ThreadTask fn, void *ctx) {
+  if (tasks == 0) {
+    return;
+  }
+  if (tasks == 1 || pool->threads == 1) {
+    for (usize task = 0; task < tasks; task++) {
+      fn(ctx, task);
+    }
+    return;
+  }
+  mutex_lock(&pool->mutex);
+  pool->fn = fn;
+  pool->ctx = ctx;
+  pool->tasks = tasks;
+  pool->next = 0;
+  pool->finished = 0;
+  pool->generation++;
+  condition_broadcast(&pool->work);
+  thread_pool_work(pool);
+  while (pool->finished < pool->tasks) {
+    condition_wait(&pool->done, &pool->mutex);
+  }
+  mutex_unlock(&pool->mutex);
+}
+
+struct ThreadLock {
+  ThreadMutex mutex;
+};
+
+ThreadLock *thread_lock_create(Arena *arena) {
+  ThreadLock *lock = arena_calloc(arena, sizeof(ThreadLock));
+  mutex_init(&lock->mutex);
+  return lock;
+}
+
+void thread_lock_destroy(ThreadLock *lock) { mutex_destroy(&lock->mutex); }
+
+void thread_lock_acquire(ThreadLock *lock) { mutex_lock(&lock->mutex); }
+
+void thread_lock_release(ThreadLock *lock) { mutex_unlock(&lock->mutex); }
+
+////////////////////////////////////////////////////////////////////////////
+#else
+
+struct ThreadPool {
+  usize threads;
+};
+
+ThreadPool *thread_pool_create(Arena *arena, usize threads) {
+  (void)threads;
+  ThreadPool *pool = arena_calloc(arena, sizeof(ThreadPool));
+  pool->threads = 1;
+  return pool;
+}
+
+void thread_pool_destroy(ThreadPool *pool) { (void)pool; }
+
+void thread_pool_run(ThreadPool *pool, usize tasks, ThreadTask fn, void *ctx) {
+  (void)pool;
+  for (usize task = 0; task < tasks; task++) {
+    fn(ctx, task);
+  }
+}
+
+struct ThreadLock {
+  u8 unused;
+};
+
+ThreadLock *thread_lock_create(Arena *arena) { return arena_calloc(arena, sizeof(ThreadLock)); }
+
+void thread_lock_destroy(ThreadLock *lock) { (void)lock; }
+
+void thread_lock_acquire(ThreadLock *lock) { (void)lock; }
+
+void thread_lock_release(ThreadLock *lock) { (void)lock; }
+
+#endif
+////////////////////////////////////////////////////////////////////////////
+
+usize thread_pool_threads(const ThreadPool *pool) { return pool->threads; }
+
+////////////////////////////////////////////////////////////////////////////
+
+#undef THREAD_FN
+#undef THREAD_RETURN
+#undef THREAD_POOL_THREADS
+#undef mutex_init
+#undef mutex_destroy
+#undef mutex_lock
+#undef mutex_unlock
+#undef condition_init
+#undef condition_destroy
+#undef condition_wait
+#undef condition_broadcast
+#undef thread_start
+#undef thread_join
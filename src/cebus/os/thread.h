@@ -0,0 +1,75 @@
+/* DOCUMENTATION
+## Thread Pool
+
+A thread pool keeps worker threads alive between jobs, so splitting a loop
+into tasks does not pay for starting threads every time. The thread that calls
+`thread_pool_run` works on the tasks too, so a pool with `threads` threads
+starts `threads - 1` workers.
+
+- `thread_pool_create(arena, threads)`: Creates a pool. With `0` threads it
+uses one per CPU.
+- `thread_pool_run(pool, tasks, fn, ctx)`: Calls `fn(ctx, task)` for every task
+from `0` to `tasks - 1` and returns after all of them are done. The tasks run in
+any order and on any thread.
+- `thread_pool_threads(pool)`: Returns the number of threads, including the
+calling one.
+- `thread_pool_destroy(pool)`: Stops the workers and waits for them. The memory
+belongs to the arena.
+
+```c
+static void square(void *ctx, usize task) {
+  u64 *values = ctx;
+  values[task] *= values[task];
+}
+
+Arena arena = {0};
+ThreadPool *pool = thread_pool_create(&arena, 0);
+thread_pool_run(pool, 1000, square, values);
+thread_pool_destroy(pool);
+arena_free(&arena);
+```
+
+## Thread Lock
+
+A mutex for data that is shared between the tasks.
+
+- `thread_lock_create(arena)`: Creates an unlocked lock.
+- `thread_lock_acquire(lock)`, `thread_lock_release(lock)`: Locks and unlocks
+it.
+- `thread_lock_destroy(lock)`: Destroys the lock. The memory belongs to the
+arena.
+
+On platforms without threads the pool runs every task on the calling thread and
+the lock does nothing.
+*/
+
+#ifndef __CEBUS_THREAD_H__
+#define __CEBUS_THREAD_H__
+
+#include "cebus/core/arena.h"
+#include "cebus/core/defines.h"
+
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct ThreadPool ThreadPool;
+typedef void (*ThreadTask)(void *ctx, usize task);
+
+ThreadPool *thread_pool_create(Arena *arena, usize threads);
+void thread_pool_destroy(ThreadPool *pool);
+
+void thread_pool_run(ThreadPool *pool, usize tasks, ThreadTask fn, void *ctx);
+usize thread_pool_threads(const ThreadPool *pool);
+
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct ThreadLock ThreadLock;
+
+ThreadLock *thread_lock_create(Arena *arena);
+void thread_lock_destroy(ThreadLock *lock);
+
+void thread_lock_acquire(ThreadLock *lock);
+void thread_lock_release(ThreadLock *lock);
+
+////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_THREAD_H__ */
@@ -1,10 +1,10 @@
 #include "byte.h"
 
+#include "cebus/core/platform.h"
 #include "cebus/type/char.h"
 #include "cebus/type/integer.h"
 #include "cebus/type/string.h"
 
-#include <stdio.h>
 #include <string.h>
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -45,24 +45,190 @@ bool bytes_eq(Bytes b1, Bytes b2) {
   return memcmp(b1.data, b2.data, b1.size) == 0;
 }
 
-u64 bytes_hash(Bytes bytes) {
-  const u64 offset = 2166136261UL;
-  const u64 prime = 16777619;
-  u64 hash = offset;
-  for (usize i = 0; i < bytes.size; i++) {
-    hash ^= (unsigned long)bytes.data[i];
-    hash *= prime;
+// XXH64, see https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+#define BYTES_PRIME64_1 0x9E3779B185EBCA87ULL
+#define BYTES_PRIME64_2 0xC2B2AE3D27D4EB4FULL
+#define BYTES_PRIME64_3 0x165667B19E3779F9ULL
+#define BYTES_PRIME64_4 0x85EBCA77C2B2AE63ULL
+#define BYTES_PRIME64_5 0x27D4EB2F165667C5ULL
+
+static inline u64 bytes_rotl(u64 value, u32 bits) {
+  return (value << bits) | (value >> (64 - bits));
+}
+
+static inline u64 bytes_read64(const u8 *data) {
+  u64 value;
+  memcpy(&value, data, sizeof(value));
+#if CEBUS_BYTE_ORDER == ENDIAN_BIG
+  value = u64_swap_bytes(value);
+#endif
+  return value;
+}
+
+static inline u32 bytes_read32(const u8 *data) {
+  u32 value;
+  memcpy(&value, data, sizeof(value));
+#if CEBUS_BYTE_ORDER == ENDIAN_BIG
+  value = u32_swap_bytes(value);
+#endif
+  return value;
+}
+
+static inline u64 bytes_hash_round(u64 acc, u64 input) {
+  acc += input * BYTES_PRIME64_2;
+  return bytes_rotl(acc, 31) * BYTES_PRIME64_1;
+}
+
+static inline u64 bytes_hash_merge(u64 hash, u64 acc) {
+  hash ^= bytes_hash_round(0, acc);
+  return hash * BYTES_PRIME64_1 + BYTES_PRIME64_4;
+}
+
+// Consumes full 32 byte stripes into the four lanes and returns the number of
+// bytes that were consumed.
+static usize bytes_hash_stripes(u64 lanes[4], const u8 *data, usize size) {
+  u64 v1 = lanes[0], v2 = lanes[1], v3 = lanes[2], v4 = lanes[3];
+  usize i = 0;
+  for (; i + 32 <= size; i += 32) {
+    v1 = bytes_hash_round(v1, bytes_read64(&data[i]));
+    v2 = bytes_hash_round(v2, bytes_read64(&data[i + 8]));
+    v3 = bytes_hash_round(v3, bytes_read64(&data[i + 16]));
+    v4 = bytes_hash_round(v4, bytes_read64(&data[i + 24]));
   }
+  lanes[0] = v1, lanes[1] = v2, lanes[2] = v3, lanes[3] = v4;
+  return i;
+}
+
+static u64 bytes_hash_lanes(const u64 lanes[4]) {
+  u64 hash = bytes_rotl(lanes[0], 1) + bytes_rotl(lanes[1], 7) + bytes_rotl(lanes[2], 12) +
+             bytes_rotl(lanes[3], 18);
+  for (usize i = 0; i < 4; i++) {
+    hash = bytes_hash_merge(hash, lanes[i]);
+  }
+  return hash;
+}
+
+// Mixes in the last bytes, less than a stripe, and the avalanche.
+static u64 bytes_hash_finalize(u64 hash, const u8 *data, usize size) {
+  usize i = 0;
+  for (; i + 8 <= size; i += 8) {
+    hash ^= bytes_hash_round(0, bytes_read64(&data[i]));
+    hash = bytes_rotl(hash, 27) * BYTES_PRIME64_1 + BYTES_PRIME64_4;
+  }
+  if (i + 4 <= size) {
+    hash ^= (u64)bytes_read32(&data[i]) * BYTES_PRIME64_1;
+    hash = bytes_rotl(hash, 23) * BYTES_PRIME64_2 + BYTES_PRIME64_3;
+    i += 4;
+  }
+  for (; i < size; i++) {
+    hash ^= data[i] * BYTES_PRIME64_5;
+    hash = bytes_rotl(hash, 11) * BYTES_PRIME64_1;
+  }
+  hash ^= hash >> 33;
+  hash *= BYTES_PRIME64_2;
+  hash ^= hash >> 29;
+  hash *= BYTES_PRIME64_3;
+  hash ^= hash >> 32;
   return hash;
 }
 
+static void bytes_hash_init(u64 lanes[4], u64 seed) {
+  lanes[0] = seed + BYTES_PRIME64_1 + BYTES_PRIME64_2;
+  lanes[1] = seed + BYTES_PRIME64_2;
+  lanes[2] = seed;
+  lanes[3] = seed - BYTES_PRIME64_1;
+}
+
+u64 bytes_hash(Bytes bytes) { return bytes_hash_seed(bytes, 0); }
+
+u64 bytes_hash_seed(Bytes bytes, u64 seed) {
+  u64 hash = seed + BYTES_PRIME64_5;
+  usize consumed = 0;
+  if (32 <= bytes.size) {
+    u64 lanes[4];
+    bytes_hash_init(lanes, seed);
+    consumed = bytes_hash_stripes(lanes, bytes.data, bytes.size);
+    hash = bytes_hash_lanes(lanes);
+  }
+  hash += (u64)bytes.size;
+  return bytes_hash_finalize(hash, &bytes.data[consumed], bytes.size - consumed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+Hasher hasher_init(u64 seed) {
+  Hasher hasher = {.seed = seed};
+  bytes_hash_init(hasher.lanes, seed);
+  return hasher;
+}
+
+void hasher_update(Hasher *hasher, Bytes bytes) {
+  const u8 *data = bytes.data;
+  usize size = bytes.size;
+  hasher->total += size;
+  if (hasher->buffered + size < sizeof(hasher->buffer)) {
+    if (size) {
+      memcpy(&hasher->buffer[hasher->buffered], data, size);
+      hasher->buffered += size;
+    }
+    return;
+  }
+  if (hasher->buffered) {
+    const usize fill = sizeof(hasher->buffer) - hasher->buffered;
+    memcpy(&hasher->buffer[hasher->buffered], data, fill);
+    bytes_hash_stripes(hasher->lanes, hasher->buffer, sizeof(hasher->buffer));
+    data += fill;
+    size -= fill;
+  }
+  const usize consumed = bytes_hash_stripes(hasher->lanes, data, size);
+  hasher->buffered = size - consumed;
+  if (hasher->buffered) {
+    memcpy(hasher->buffer, &data[consumed], hasher->buffered);
+  }
+}
+
+void hasher_update_u64(Hasher *hasher, u64 value) {
+  u8 data[sizeof(u64)];
+  for (usize i = 0; i < sizeof(data); i++) {
+    data[i] = (u8)(value >> (i * 8));
+  }
+  hasher_update(hasher, bytes_from_parts(sizeof(data), data));
+}
+
+void hasher_update_i64(Hasher *hasher, i64 value) { hasher_update_u64(hasher, (u64)value); }
+
+void hasher_update_f64(Hasher *hasher, f64 value) {
+  u64 bits;
+  memcpy(&bits, &value, sizeof(bits));
+  hasher_update_u64(hasher, bits);
+}
+
+void hasher_update_str(Hasher *hasher, Str s) {
+  hasher_update_u64(hasher, s.len);
+  hasher_update(hasher, bytes_from_parts(s.len, s.data));
+}
+
+u64 hasher_final(const Hasher *hasher) {
+  u64 hash = hasher->seed + BYTES_PRIME64_5;
+  if (sizeof(hasher->buffer) <= hasher->total) {
+    hash = bytes_hash_lanes(hasher->lanes);
+  }
+  hash += hasher->total;
+  return bytes_hash_finalize(hash, hasher->buffer, hasher->buffered);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 Str bytes_to_hex(Bytes bytes, Arena *arena) {
+  static const char digits[] = "0123456789abcdef";
   char *buf = arena_calloc(arena, bytes.size * 2 + 1);
   usize idx = 0;
   for (usize i = 0; i < bytes.size; i++) {
-    idx += (usize)snprintf(&buf[idx], 3, "%0*x", (i != 0) + 1, bytes.data[i]);
+    // the first byte has no leading zero
+    if (i != 0 || 0x10 <= bytes.data[i]) {
+      buf[idx++] = digits[bytes.data[i] >> 4];
+    }
+    buf[idx++] = digits[bytes.data[i] & 0xf];
   }
   return (Str){.len = idx, .data = buf};
 }
@@ -90,3 +256,9 @@ Bytes bytes_from_hex(Str s, Arena *arena) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+#undef BYTES_PRIME64_1
+#undef BYTES_PRIME64_2
+#undef BYTES_PRIME64_3
+#undef BYTES_PRIME64_4
+#undef BYTES_PRIME64_5
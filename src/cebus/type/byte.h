@@ -22,6 +22,40 @@ the first `count` bytes, returning the removed portion.
 - **Checking Equality**:
   - `bytes_eq(b1, b2)`: Checks if two byte arrays are equal.
 
+- **Hashing**:
+  - `bytes_hash(bytes)`: Hashes the bytes with XXH64 and seed `0`.
+  - `bytes_hash_seed(bytes, seed)`: Same with another seed, for example to get
+independent hash functions.
+
+The hash is XXH64, which processes 32 bytes per step. Its output is stable: the
+same bytes and seed give the same hash on every platform and in every future
+version, so it can be stored or sent over the network.
+
+- **Streaming Hash**:
+  - `hasher_init(seed)`: Creates a `Hasher` for input that arrives in pieces.
+  - `hasher_update(hasher, bytes)`: Adds the next bytes.
+  - `hasher_final(hasher)`: Returns the hash of everything added so far. The
+hasher can still be updated afterwards.
+
+The result is the same as `bytes_hash_seed` of all the bytes one after another,
+no matter how they were split.
+
+  - `hasher_update_u64(hasher, value)`, `hasher_update_i64(hasher, value)`,
+`hasher_update_f64(hasher, value)`: Add a number as 8 little endian bytes, so
+the hash does not depend on the byte order of the platform.
+  - `hasher_update_str(hasher, s)`: Adds the length and then the characters, so
+`"ab", "c"` and `"a", "bc"` hash differently.
+
+These hash a struct field by field, without its padding:
+```c
+u64 user_hash(const User *user) {
+  Hasher hasher = hasher_init(0);
+  hasher_update_u64(&hasher, user->id);
+  hasher_update_str(&hasher, user->name);
+  return hasher_final(&hasher);
+}
+```
+
 - **Hexadecimal Conversion**:
   - `bytes_to_hex(bytes, arena)`: Converts a byte array into a hexadecimal
 string representation, using memory from the arena.
@@ -74,6 +108,25 @@ Bytes bytes_take(Bytes *bytes, usize count);
 
 bool bytes_eq(Bytes b1, Bytes b2);
 u64 bytes_hash(Bytes bytes);
+u64 bytes_hash_seed(Bytes bytes, u64 seed);
+
+////////////////////////////////////////////////////////////////////////////
+
+typedef struct {
+  u64 seed;
+  u64 lanes[4];
+  u64 total;
+  usize buffered;
+  u8 buffer[32];
+} Hasher;
+
+Hasher hasher_init(u64 seed);
+void hasher_update(Hasher *hasher, Bytes bytes);
+void hasher_update_u64(Hasher *hasher, u64 value);
+void hasher_update_i64(Hasher *hasher, i64 value);
+void hasher_update_f64(Hasher *hasher, f64 value);
+void hasher_update_str(Hasher *hasher, Str s);
+u64 hasher_final(const Hasher *hasher);
 
 ////////////////////////////////////////////////////////////////////////////
 
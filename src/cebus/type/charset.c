@@ -0,0 +1,199 @@
+#include "charset.h"
+
+#include "cebus/core/cpu.h"
+#include "cebus/core/platform.h"
+#include "cebus/type/integer.h"
+
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+#if defined(GCC) || defined(CLANG)
+#define CHARSET_FIRST_BIT(mask) ((usize)__builtin_ctz(mask))
+#define CHARSET_LAST_BIT(mask) ((usize)(31 - __builtin_clz(mask)))
+#define CHARSET_COUNT_BITS(mask) ((usize)__builtin_popcount(mask))
+#else
+#define CHARSET_FIRST_BIT(mask) u32_trailing_zeros(mask)
+#define CHARSET_LAST_BIT(mask) (31 - u32_leading_zeros(mask))
+#define CHARSET_COUNT_BITS(mask) u32_count_ones(mask)
+#endif
+
+static inline bool charset_test(const u8 *table, u8 c) {
+  return (table[(c & 0x0f) | (c >> 3 & 0x10)] >> (c >> 4 & 7)) & 1;
+}
+
+static inline void charset_insert(CharSet *set, u8 c) {
+  set->table[(c & 0x0f) | (c >> 3 & 0x10)] |= (u8)(1 << (c >> 4 & 7));
+}
+
+// Index of the first character that is 'in' the set or not, 'len' if there
+// is none.
+static usize charset_find_scalar(const CharSet *set, const char *data, usize len, bool in) {
+  usize i = 0;
+  while (i < len && charset_test(set->table, (u8)data[i]) != in) {
+    i++;
+  }
+  return i;
+}
+
+// Index after the last character that is 'in' the set or not, '0' if there
+// is none.
+static usize charset_find_last_scalar(const CharSet *set, const char *data, usize len, bool in) {
+  usize end = len;
+  while (0 < end && charset_test(set->table, (u8)data[end - 1]) != in) {
+    end--;
+  }
+  return end;
+}
+
+static usize charset_count_scalar(const CharSet *set, const char *data, usize len) {
+  usize count = 0;
+  for (usize i = 0; i < len; i++) {
+    count += charset_test(set->table, (u8)data[i]);
+  }
+  return count;
+}
+
+#if defined(CEBUS_SIMD_X86)
+
+// Bit 'i' of the result is set if byte 'i' of 'v' is in the set. The low
+// nibble selects a byte of both halves of the table, the sign selects the half
+// and the rest of the high nibble selects the bit.
+CEBUS_TARGET_AVX2 static inline u32 charset_match_avx2(__m256i lo, __m256i hi, __m256i v) {
+  const __m256i nibble = _mm256_set1_epi8(0x0f);
+  const __m256i bits = _mm256_setr_epi8(1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128,
+                                        1, 2, 4, 8, 16, 32, 64, -128, 1, 2, 4, 8, 16, 32, 64, -128);
+  const __m256i low = _mm256_and_si256(v, nibble);
+  const __m256i row =
+      _mm256_blendv_epi8(_mm256_shuffle_epi8(lo, low), _mm256_shuffle_epi8(hi, low), v);
+  const __m256i bit =
+      _mm256_shuffle_epi8(bits, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+  return (u32)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(row, bit), bit));
+}
+
+// Both 128 bit lanes need the whole half for the shuffle.
+CEBUS_TARGET_AVX2 static inline __m256i charset_half_avx2(const u8 *half) {
+  return _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i *)half));
+}
+
+CEBUS_TARGET_AVX2 static usize charset_find_avx2(const CharSet *set, const char *data, usize len,
+                                                 bool in) {
+  const __m256i lo = charset_half_avx2(&set->table[0]);
+  const __m256i hi = charset_half_avx2(&set->table[16]);
+  const u32 flip = in ? 0 : 0xffffffff;
+  usize i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    const u32 mask = charset_match_avx2(lo, hi, v) ^ flip;
+    if (mask) {
+      return i + CHARSET_FIRST_BIT(mask);
+    }
+  }
+  return i + charset_find_scalar(set, &data[i], len - i, in);
+}
+
+CEBUS_TARGET_AVX2 static usize charset_find_last_avx2(const CharSet *set, const char *data,
+                                                      usize len, bool in) {
+  const __m256i lo = charset_half_avx2(&set->table[0]);
+  const __m256i hi = charset_half_avx2(&set->table[16]);
+  const u32 flip = in ? 0 : 0xffffffff;
+  usize end = len;
+  for (; 32 <= end; end -= 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)&data[end - 32]);
+    const u32 mask = charset_match_avx2(lo, hi, v) ^ flip;
+    if (mask) {
+      return end - 32 + CHARSET_LAST_BIT(mask) + 1;
+    }
+  }
+  return charset_find_last_scalar(set, data, end, in);
+}
+
+CEBUS_TARGET_AVX2 static usize charset_count_avx2(const CharSet *set, const char *data,
+                                                  usize len) {
+  const __m256i lo = charset_half_avx2(&set->table[0]);
+  const __m256i hi = charset_half_avx2(&set->table[16]);
+  usize count = 0;
+  usize i = 0;
+  for (; i + 32 <= len; i += 32) {
+    const __m256i v = _mm256_loadu_si256((const __m256i *)&data[i]);
+    count += CHARSET_COUNT_BITS(charset_match_avx2(lo, hi, v));
+  }
+  return count + charset_count_scalar(set, &data[i], len - i);
+}
+
+#endif
+
+// Strings shorter than a vector are not worth the setup.
+static usize charset_find(const CharSet *set, Str s, bool in) {
+#if defined(CEBUS_SIMD_X86)
+  if (32 <= s.len && cpu_has_avx2()) {
+    return charset_find_avx2(set, s.data, s.len, in);
+  }
+#endif
+  return charset_find_scalar(set, s.data, s.len, in);
+}
+
+static usize charset_find_last(const CharSet *set, Str s, bool in) {
+#if defined(CEBUS_SIMD_X86)
+  if (32 <= s.len && cpu_has_avx2()) {
+    return charset_find_last_avx2(set, s.data, s.len, in);
+  }
+#endif
+  return charset_find_last_scalar(set, s.data, s.len, in);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+CharSet charset_from_predicate(bool (*predicate)(char)) {
+  CharSet set = {0};
+  for (usize c = 0; c < 256; c++) {
+    if (predicate((char)c)) {
+      charset_insert(&set, (u8)c);
+    }
+  }
+  return set;
+}
+
+CharSet charset_from_str(Str chars) {
+  CharSet set = {0};
+  for (usize i = 0; i < chars.len; i++) {
+    charset_insert(&set, (u8)chars.data[i]);
+  }
+  return set;
+}
+
+CharSet charset_invert(CharSet set) {
+  for (usize i = 0; i < sizeof(set.table); i++) {
+    set.table[i] = (u8)~set.table[i];
+  }
+  return set;
+}
+
+bool charset_contains(const CharSet *set, char c) { return charset_test(set->table, (u8)c); }
+
+///////////////////////////////////////////////////////////////////////////////
+
+usize charset_span(const CharSet *set, Str s) { return charset_find(set, s, false); }
+
+usize charset_cspan(const CharSet *set, Str s) { return charset_find(set, s, true); }
+
+usize charset_rspan(const CharSet *set, Str s) { return s.len - charset_find_last(set, s, false); }
+
+usize charset_rcspan(const CharSet *set, Str s) { return s.len - charset_find_last(set, s, true); }
+
+usize charset_count(const CharSet *set, Str s) {
+#if defined(CEBUS_SIMD_X86)
+  if (32 <= s.len && cpu_has_avx2()) {
+    return charset_count_avx2(set, s.data, s.len);
+  }
+#endif
+  return charset_count_scalar(set, s.data, s.len);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+#undef CHARSET_FIRST_BIT
+#undef CHARSET_LAST_BIT
+#undef CHARSET_COUNT_BITS
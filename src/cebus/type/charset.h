@@ -0,0 +1,62 @@
+/* DOCUMENTATION
+## Character Sets
+
+A `CharSet` is a table with one bit for each of the 256 byte values. It is
+built once, from a predicate or from a list of characters, and then replaces
+calling a predicate for every character. Scanning a string checks 32 bytes at
+once with AVX2, if the CPU supports it.
+
+- `charset_from_predicate(predicate)`: Contains every character for which
+`predicate` returns `true`.
+- `charset_from_str(chars)`: Contains every character of `chars`.
+- `charset_invert(set)`: Contains every character that `set` does not contain.
+- `charset_contains(&set, c)`: Checks if `c` is in the set.
+- `charset_span(&set, str)`, `charset_cspan(&set, str)`: Number of characters
+at the start of the string that are or are not in the set, like `strspn` and
+`strcspn`.
+- `charset_rspan(&set, str)`, `charset_rcspan(&set, str)`: Same for the end of
+the string.
+- `charset_count(&set, str)`: Number of characters of the string that are in
+the set.
+
+The string functions `str_trim_by_charset`, `str_chop_by_charset`,
+`str_split` etc. use these.
+
+```c
+const CharSet separators = charset_from_predicate(c_is_space);
+const usize word = charset_cspan(&separators, STR("hello world"));
+```
+*/
+
+#ifndef __CEBUS_CHARSET_H__
+#define __CEBUS_CHARSET_H__
+
+#include "cebus/core/defines.h"
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Bit 'c >> 4 & 7' of byte 'c & 0x0f | c >> 3 & 0x10' is set if 'c' is in the
+// set. Every half is indexed by the low nibble, so a shuffle can look up 32
+// characters at once.
+typedef struct {
+  u8 table[32];
+} CharSet;
+
+CharSet charset_from_predicate(bool (*predicate)(char));
+CharSet charset_from_str(Str chars);
+CONST_FN CharSet charset_invert(CharSet set);
+
+bool charset_contains(const CharSet *set, char c);
+
+///////////////////////////////////////////////////////////////////////////////
+
+usize charset_span(const CharSet *set, Str s);
+usize charset_cspan(const CharSet *set, Str s);
+usize charset_rspan(const CharSet *set, Str s);
+usize charset_rcspan(const CharSet *set, Str s);
+
+usize charset_count(const CharSet *set, Str s);
+
+///////////////////////////////////////////////////////////////////////////////
+
+#endif /* !__CEBUS_CHARSET_H__ */
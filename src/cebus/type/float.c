@@ -1,5 +1,7 @@
 #include "float.h" // IWYU pragma: keep
 
+#include <string.h>
+
 #define FLOAT_IMPL(T, BITS)                                                                        \
   bool T##_eq(T a, T b) { return T##_abs(a - b) < F##BITS##_EPSILON; }                             \
   bool T##_eq_eps(T a, T b, T epsilon) { return T##_abs(a - b) < epsilon; }                        \
@@ -20,3 +22,91 @@ FLOAT_IMPL(f32, 32)
 FLOAT_IMPL(f64, 64)
 
 #undef FLOAT_IMPL
+
+#define F64_LN2 0.6931471805599453
+
+f64 f64_exp(f64 x) {
+  if (x != x) {
+    return x;
+  }
+  if (x < -700.0) {
+    return 0;
+  }
+  x = f64_min(x, 700.0);
+  // e^x = 2^n * e^r with r in [0, ln(2))
+  const f64 t = x * 1.4426950408889634; // log2(e)
+  i64 n = (i64)t;
+  n -= (f64)n > t;
+  const f64 r = (t - (f64)n) * F64_LN2;
+  f64 term = 1.0;
+  f64 sum = 1.0;
+  for (usize i = 1; i < 16; i++) {
+    term *= r / (f64)i;
+    sum += term;
+  }
+  const u64 bits = (u64)(n + 1023) << 52;
+  f64 scale;
+  memcpy(&scale, &bits, sizeof(scale));
+  return sum * scale;
+}
+
+f64 f64_ln(f64 x) {
+  if (x != x || x < 0) {
+    return F64_NAN;
+  }
+  if (x == 0) {
+    return -F64_INF;
+  }
+  if (x == F64_INF) {
+    return x;
+  }
+  i64 exponent = 0;
+  if (x < F64_MIN) {
+    // subnormal, the exponent field does not hold the exponent
+    x *= 18014398509481984.0; // 2^54
+    exponent = -54;
+  }
+  u64 bits;
+  memcpy(&bits, &x, sizeof(bits));
+  exponent += (i64)((bits >> 52) & 0x7ff) - 1023;
+  bits = (bits & 0x000fffffffffffff) | 0x3ff0000000000000;
+  f64 mantissa;
+  memcpy(&mantissa, &bits, sizeof(mantissa));
+  if (1.4142135623730951 < mantissa) {
+    mantissa /= 2;
+    exponent++;
+  }
+  // ln(m) = 2 * atanh((m - 1) / (m + 1))
+  const f64 s = (mantissa - 1) / (mantissa + 1);
+  const f64 s2 = s * s;
+  f64 term = s;
+  f64 sum = 0;
+  for (usize i = 1; i < 40; i += 2) {
+    sum += term / (f64)i;
+    term *= s2;
+  }
+  return (f64)exponent * F64_LN2 + 2 * sum;
+}
+
+f64 f64_sqrt(f64 x) {
+  if (x <= 0 || x != x) {
+    return x == 0 ? x : F64_NAN;
+  }
+  if (x == F64_INF) {
+    return x;
+  }
+  // Newton's method, starting at half the exponent. After the first step it
+  // is never below the root and only gets smaller.
+  u64 bits;
+  memcpy(&bits, &x, sizeof(bits));
+  bits = (bits >> 1) + ((u64)1023 << 51);
+  f64 y;
+  memcpy(&y, &bits, sizeof(y));
+  y = 0.5 * (y + x / y);
+  for (f64 next = 0.5 * (y + x / y); next < y; next = 0.5 * (y + x / y)) {
+    y = next;
+  }
+  return y;
+}
+
+#undef F64_LN2
@@ -13,6 +13,14 @@ These functions are available for `f32` and `f64`.
 - `f32_lerp(min, max, value)`: Linear interpolation between `min` and `max`.
 - `f32_rad(deg)`: Converts degrees to radians.
 - `f32_deg(rad)`: Converts radians to degrees.
+
+These are only available for `f64`:
+
+- `f64_exp(x)`, `f64_ln(x)`, `f64_sqrt(x)`: The exponential function, the
+natural logarithm and the square root. The sketches need them for sizing and
+estimates, and they are implemented here so the library does not have to link
+against libm. They are close to, but not always exactly, the results of
+`<math.h>`.
 */
 
 #ifndef __CEBUS_FLOATS_H__
@@ -37,4 +45,8 @@ FLOAT_DECL(f64)
 
 #undef FLOAT_DECL
 
+CONST_FN f64 f64_exp(f64 x);
+CONST_FN f64 f64_ln(f64 x);
+CONST_FN f64 f64_sqrt(f64 x);
+
 #endif /* !__CEBUS_FLOATS_H__ */
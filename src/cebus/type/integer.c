@@ -1,11 +1,35 @@
 #include "integer.h" // IWYU pragma: keep
 
+#include "cebus/core/cpu.h"
 #include "cebus/core/debug.h"
 #include "cebus/core/platform.h"
 #include "cebus/type/byte.h"
 
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
+
 #define BITS(T) (sizeof(T) * 8)
 
+// splitmix64, see https://prng.di.unimi.it/splitmix64.c. Only multiplies,
+// shifts and xors, and every step can be undone, so different values never
+// collide.
+#define INTEGER_HASH_GAMMA ((u64)0x9E3779B97F4A7C15)
+#define INTEGER_HASH_MUL1 ((u64)0xBF58476D1CE4E5B9)
+#define INTEGER_HASH_MUL2 ((u64)0x94D049BB133111EB)
+
+static inline u64 integer_hash_mix(u64 hash) {
+  hash = (hash ^ (hash >> 30)) * INTEGER_HASH_MUL1;
+  hash = (hash ^ (hash >> 27)) * INTEGER_HASH_MUL2;
+  return hash ^ (hash >> 31);
+}
+
+// 'key' is the mixed seed. Mixing '0' gives '0', so seed '0' is the unseeded
+// hash.
+static inline u64 integer_hash_seeded(u64 value, u64 key) {
+  return integer_hash_mix((value ^ key) + INTEGER_HASH_GAMMA);
+}
+
 #define INTEGER_IMPL(T)                                                                            \
   /* BIT OPERATIONS */                                                                             \
   T T##_reverse_bits(T value) {                                                                    \
@@ -194,12 +218,9 @@
   /* MATH OPERATIONS END */                                                                        \
                                                                                                    \
   /* UTILS */                                                                                      \
-  u64 T##_hash(T value) {                                                                          \
-    u64 hash = ((u64)value) + 1;                                                                   \
-    hash = (((hash >> 16) ^ hash) % 0x3AA387A8B1) * 0x45d9f3b;                                     \
-    hash = (((hash >> 16) ^ hash) % 0x3AA387A8B1) * 0x45d9f3b;                                     \
-    hash = (hash >> 16) ^ hash;                                                                    \
-    return hash;                                                                                   \
+  u64 T##_hash(T value) { return integer_hash_mix((u64)value + INTEGER_HASH_GAMMA); }              \
+  u64 T##_hash_seed(T value, u64 seed) {                                                           \
+    return integer_hash_seeded((u64)value, integer_hash_mix(seed));                                \
   }                                                                                                \
                                                                                                    \
   void T##_swap(T *v1, T *v2) {                                                                    \
@@ -238,5 +259,72 @@ INTEGER_IMPL(u64)
 INTEGER_IMPL(i64)
 INTEGER_IMPL(usize)
 
+//////////////////////////////////////////////////////////////////////////////
+
+#if defined(CEBUS_SIMD_X86)
+
+// AVX2 has no 64 bit multiplication, so it is put together from three 32 bit
+// ones. The high half of the constant is known up front.
+CEBUS_TARGET_AVX2 static inline __m256i integer_hash_mul_avx2(__m256i a, __m256i b,
+                                                              __m256i b_high) {
+  const __m256i low = _mm256_mul_epu32(a, b);
+  const __m256i cross =
+      _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b), _mm256_mul_epu32(a, b_high));
+  return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+CEBUS_TARGET_AVX2 static void u64_hash_batch_avx2(usize count, const u64 *values, u64 *hashes,
+                                                  u64 key) {
+  const __m256i add = _mm256_set1_epi64x((i64)INTEGER_HASH_GAMMA);
+  const __m256i key_lanes = _mm256_set1_epi64x((i64)key);
+  const __m256i mul1 = _mm256_set1_epi64x((i64)INTEGER_HASH_MUL1);
+  const __m256i mul1_high = _mm256_srli_epi64(mul1, 32);
+  const __m256i mul2 = _mm256_set1_epi64x((i64)INTEGER_HASH_MUL2);
+  const __m256i mul2_high = _mm256_srli_epi64(mul2, 32);
+  usize i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256i h = _mm256_loadu_si256((const __m256i *)&values[i]);
+    h = _mm256_add_epi64(_mm256_xor_si256(h, key_lanes), add);
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 30));
+    h = integer_hash_mul_avx2(h, mul1, mul1_high);
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 27));
+    h = integer_hash_mul_avx2(h, mul2, mul2_high);
+    h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 31));
+    _mm256_storeu_si256((__m256i *)&hashes[i], h);
+  }
+  for (; i < count; i++) {
+    hashes[i] = integer_hash_seeded(values[i], key);
+  }
+}
+
+#endif
+
+void u64_hash_batch(usize count, const u64 *values, u64 *hashes, u64 seed) {
+  const u64 key = integer_hash_mix(seed);
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    u64_hash_batch_avx2(count, values, hashes, key);
+    return;
+  }
+#endif
+  for (usize i = 0; i < count; i++) {
+    hashes[i] = integer_hash_seeded(values[i], key);
+  }
+}
+
+u64 u64_mix(u64 hash) {
+  hash ^= hash >> 33;
+  hash *= (u64)0xff51afd7ed558ccd;
+  hash ^= hash >> 33;
+  hash *= (u64)0xc4ceb9fe1a85ec53;
+  hash ^= hash >> 33;
+  return hash;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
 #undef INTEGER_IMPL
 #undef BITS
+#undef INTEGER_HASH_GAMMA
+#undef INTEGER_HASH_MUL1
+#undef INTEGER_HASH_MUL2
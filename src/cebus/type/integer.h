@@ -32,7 +32,17 @@ Basic math operations including max, min, and clamp are provided.
 
 ## Utilities
 
-- `T_hash(T value)`: Generates a hash for `value`.
+- `T_hash(T value)`: Generates a hash for `value`. This is the splitmix64 mixer,
+a few multiplications and shifts without any division. Different values never
+get the same hash, and the high bits are as good as the low ones, so they can
+index power of two tables.
+- `T_hash_seed(T value, u64 seed)`: Same with another seed, for example to get
+independent hash functions. Seed `0` gives `T_hash`.
+- `u64_hash_batch(count, values, hashes, seed)`: Writes `u64_hash_seed` of
+every value into `hashes`, four at a time with AVX2.
+- `u64_mix(hash)`: Remixes a hash that is already a hash, with the finalizer
+of MurmurHash3. The sketches use it to derive their indices, so they also work
+with hashes whose low or high bits are weak.
 - `T_swap(T *v1, T *v2)`: Swaps the values of `v1` and `v2`.
 - `T_compare_lt(T a, T b)`: Compares `a` and `b` for less than.
 - `T_compare_gt(T a, T b)`: Compares `a` and `b` for greater than.
@@ -83,6 +93,7 @@ suitable for `qsort`.
                                                                                                    \
   /* UTILS */                                                                                      \
   CONST_FN u64 T##_hash(T value);                                                                  \
+  CONST_FN u64 T##_hash_seed(T value, u64 seed);                                                   \
   void T##_swap(T *v1, T *v2);                                                                     \
   CONST_FN CmpOrdering T##_compare_lt(T a, T b);                                                   \
   CONST_FN CmpOrdering T##_compare_gt(T a, T b);                                                   \
@@ -101,4 +112,7 @@ INTEGER_DECL(usize)
 
 #undef INTEGER_DECL
 
+void u64_hash_batch(usize count, const u64 *values, u64 *hashes, u64 seed);
+CONST_FN u64 u64_mix(u64 hash);
+
 #endif /* !__CEBUS_INTEGERS_H__ */
@@ -0,0 +1,511 @@
+#include "numeric.h"
+
+#include "cebus/core/cpu.h"
+#include "cebus/core/platform.h"
+
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Histograms with at most this many bins are counted into four separate
+// histograms, so two values in the same bin do not have to wait for each other.
+#define NUMERIC_HISTOGRAM_LOCAL 256
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Four independent accumulators, so the additions do not wait for each other.
+// 'U' is the type used for the arithmetic, unsigned for signed integers so
+// they wrap around instead of overflowing.
+#define NUMERIC_SCALAR(T, U)                                                                       \
+  UNUSED static T T##_sum_scalar(usize count, const T *values) {                                   \
+    U sums[4] = {0};                                                                               \
+    usize i = 0;                                                                                   \
+    for (; i + 4 <= count; i += 4) {                                                               \
+      sums[0] += (U)values[i];                                                                     \
+      sums[1] += (U)values[i + 1];                                                                 \
+      sums[2] += (U)values[i + 2];                                                                 \
+      sums[3] += (U)values[i + 3];                                                                 \
+    }                                                                                              \
+    for (; i < count; i++) {                                                                       \
+      sums[0] += (U)values[i];                                                                     \
+    }                                                                                              \
+    return (T)((sums[0] + sums[1]) + (sums[2] + sums[3]));                                         \
+  }                                                                                                \
+                                                                                                   \
+  static T T##_dot_scalar(usize count, const T *a, const T *b) {                                   \
+    U sums[4] = {0};                                                                               \
+    usize i = 0;                                                                                   \
+    for (; i + 4 <= count; i += 4) {                                                               \
+      sums[0] += (U)a[i] * (U)b[i];                                                                \
+      sums[1] += (U)a[i + 1] * (U)b[i + 1];                                                        \
+      sums[2] += (U)a[i + 2] * (U)b[i + 2];                                                        \
+      sums[3] += (U)a[i + 3] * (U)b[i + 3];                                                        \
+    }                                                                                              \
+    for (; i < count; i++) {                                                                       \
+      sums[0] += (U)a[i] * (U)b[i];                                                                \
+    }                                                                                              \
+    return (T)((sums[0] + sums[1]) + (sums[2] + sums[3]));                                         \
+  }                                                                                                \
+                                                                                                   \
+  static void T##_prefix_sum_scalar(usize count, const T *values, T *out, U sum) {                 \
+    for (usize i = 0; i < count; i++) {                                                            \
+      sum += (U)values[i];                                                                         \
+      out[i] = (T)sum;                                                                             \
+    }                                                                                              \
+  }                                                                                                \
+                                                                                                   \
+  static void T##_minmax_scalar(usize count, const T *values, T *min, T *max) {                    \
+    T lo = *min;                                                                                   \
+    T hi = *max;                                                                                   \
+    for (usize i = 0; i < count; i++) {                                                            \
+      lo = values[i] < lo ? values[i] : lo;                                                        \
+      hi = hi < values[i] ? values[i] : hi;                                                        \
+    }                                                                                              \
+    *min = lo;                                                                                     \
+    *max = hi;                                                                                     \
+  }
+
+NUMERIC_SCALAR(f32, f32)
+NUMERIC_SCALAR(f64, f64)
+NUMERIC_SCALAR(i64, u64)
+NUMERIC_SCALAR(u64, u64)
+
+//////////////////////////////////////////////////////////////////////////////
+
+#if defined(CEBUS_SIMD_X86)
+
+// 'W' lanes per vector, 'MM' is the intrinsic prefix and 'S' the suffix.
+#define NUMERIC_FLOAT_KERNELS(T, NAME, TARGET, V, W, MM, S)                                        \
+  TARGET static T T##_sum_##NAME(usize count, const T *values) {                                   \
+    V s0 = MM##_setzero_##S();                                                                     \
+    V s1 = s0, s2 = s0, s3 = s0;                                                                   \
+    usize i = 0;                                                                                   \
+    for (; i + 4 * (W) <= count; i += 4 * (W)) {                                                   \
+      s0 = MM##_add_##S(s0, MM##_loadu_##S(&values[i]));                                           \
+      s1 = MM##_add_##S(s1, MM##_loadu_##S(&values[i + (W)]));                                     \
+      s2 = MM##_add_##S(s2, MM##_loadu_##S(&values[i + 2 * (W)]));                                 \
+      s3 = MM##_add_##S(s3, MM##_loadu_##S(&values[i + 3 * (W)]));                                 \
+    }                                                                                              \
+    for (; i + (W) <= count; i += (W)) {                                                           \
+      s0 = MM##_add_##S(s0, MM##_loadu_##S(&values[i]));                                           \
+    }                                                                                              \
+    s0 = MM##_add_##S(MM##_add_##S(s0, s1), MM##_add_##S(s2, s3));                                 \
+    T lanes[W];                                                                                    \
+    MM##_storeu_##S(lanes, s0);                                                                    \
+    T sum = 0;                                                                                     \
+    for (usize l = 0; l < (W); l++) {                                                              \
+      sum += lanes[l];                                                                             \
+    }                                                                                              \
+    return sum + T##_sum_scalar(count - i, &values[i]);                                            \
+  }                                                                                                \
+                                                                                                   \
+  TARGET static T T##_dot_##NAME(usize count, const T *a, const T *b) {                            \
+    V s0 = MM##_setzero_##S();                                                                     \
+    V s1 = s0, s2 = s0, s3 = s0;                                                                   \
+    usize i = 0;                                                                                   \
+    for (; i + 4 * (W) <= count; i += 4 * (W)) {                                                   \
+      s0 = MM##_add_##S(s0, MM##_mul_##S(MM##_loadu_##S(&a[i]), MM##_loadu_##S(&b[i])));           \
+      s1 = MM##_add_##S(s1, MM##_mul_##S(MM##_loadu_##S(&a[i + (W)]),                              \
+                                         MM##_loadu_##S(&b[i + (W)])));                            \
+      s2 = MM##_add_##S(s2, MM##_mul_##S(MM##_loadu_##S(&a[i + 2 * (W)]),                          \
+                                         MM##_loadu_##S(&b[i + 2 * (W)])));                        \
+      s3 = MM##_add_##S(s3, MM##_mul_##S(MM##_loadu_##S(&a[i + 3 * (W)]),                          \
+                                         MM##_loadu_##S(&b[i + 3 * (W)])));                        \
+    }                                                                                              \
+    for (; i + (W) <= count; i += (W)) {                                                           \
+      s0 = MM##_add_##S(s0, MM##_mul_##S(MM##_loadu_##S(&a[i]), MM##_loadu_##S(&b[i])));           \
+    }                                                                                              \
+    s0 = MM##_add_##S(MM##_add_##S(s0, s1), MM##_add_##S(s2, s3));                                 \
+    T lanes[W];                                                                                    \
+    MM##_storeu_##S(lanes, s0);                                                                    \
+    T sum = 0;                                                                                     \
+    for (usize l = 0; l < (W); l++) {                                                              \
+      sum += lanes[l];                                                                             \
+    }                                                                                              \
+    return sum + T##_dot_scalar(count - i, &a[i], &b[i]);                                          \
+  }                                                                                                \
+                                                                                                   \
+  TARGET static void T##_minmax_##NAME(usize count, const T *values, T *min, T *max) {             \
+    V lo = MM##_set1_##S(*min);                                                                    \
+    V hi = MM##_set1_##S(*max);                                                                    \
+    usize i = 0;                                                                                   \
+    for (; i + 2 * (W) <= count; i += 2 * (W)) {                                                   \
+      const V x = MM##_loadu_##S(&values[i]);                                                      \
+      const V y = MM##_loadu_##S(&values[i + (W)]);                                                \
+      lo = MM##_min_##S(lo, MM##_min_##S(x, y));                                                   \
+      hi = MM##_max_##S(hi, MM##_max_##S(x, y));                                                   \
+    }                                                                                              \
+    T lo_lanes[W];                                                                                 \
+    T hi_lanes[W];                                                                                 \
+    MM##_storeu_##S(lo_lanes, lo);                                                                 \
+    MM##_storeu_##S(hi_lanes, hi);                                                                 \
+    T##_minmax_scalar(W, lo_lanes, min, max);                                                      \
+    T##_minmax_scalar(W, hi_lanes, min, max);                                                      \
+    T##_minmax_scalar(count - i, &values[i], min, max);                                            \
+  }
+
+NUMERIC_FLOAT_KERNELS(f32, sse2, , __m128, 4, _mm, ps)
+NUMERIC_FLOAT_KERNELS(f64, sse2, , __m128d, 2, _mm, pd)
+NUMERIC_FLOAT_KERNELS(f32, avx2, CEBUS_TARGET_AVX2, __m256, 8, _mm256, ps)
+NUMERIC_FLOAT_KERNELS(f64, avx2, CEBUS_TARGET_AVX2, __m256d, 4, _mm256, pd)
+
+// Scans four lanes with two shifted additions, then adds the carry of the
+// previous block.
+CEBUS_TARGET_AVX2 static void f64_prefix_sum_avx2(usize count, const f64 *values, f64 *out) {
+  const __m256d zero = _mm256_setzero_pd();
+  __m256d carry = zero;
+  usize i = 0;
+  for (; i + 4 <= count; i += 4) {
+    __m256d x = _mm256_loadu_pd(&values[i]);
+    x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x90), zero, 0x1));
+    x = _mm256_add_pd(x, _mm256_blend_pd(_mm256_permute4x64_pd(x, 0x40), zero, 0x3));
+    x = _mm256_add_pd(x, carry);
+    _mm256_storeu_pd(&out[i], x);
+    carry = _mm256_permute4x64_pd(x, 0xff);
+  }
+  f64 sum;
+  _mm_store_sd(&sum, _mm256_castpd256_pd128(carry));
+  f64_prefix_sum_scalar(count - i, &values[i], &out[i], sum);
+}
+
+// Scans both 128 bit lanes with byte shifts, then adds the total of the low
+// lane to the high lane and the carry of the previous block.
+CEBUS_TARGET_AVX2 static void f32_prefix_sum_avx2(usize count, const f32 *values, f32 *out) {
+  __m256 carry = _mm256_setzero_ps();
+  usize i = 0;
+  for (; i + 8 <= count; i += 8) {
+    __m256 x = _mm256_loadu_ps(&values[i]);
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(_mm256_slli_si256(_mm256_castps_si256(x), 8)));
+    const __m256 last = _mm256_permute_ps(x, 0xff);
+    x = _mm256_add_ps(x, _mm256_permute2f128_ps(last, last, 0x08));
+    x = _mm256_add_ps(x, carry);
+    _mm256_storeu_ps(&out[i], x);
+    const __m256 total = _mm256_permute_ps(x, 0xff);
+    carry = _mm256_permute2f128_ps(total, total, 0x11);
+  }
+  f32 sum;
+  _mm_store_ss(&sum, _mm256_castps256_ps128(carry));
+  f32_prefix_sum_scalar(count - i, &values[i], &out[i], sum);
+}
+
+CEBUS_TARGET_AVX2 static u64 u64_sum_avx2(usize count, const u64 *values) {
+  __m256i s0 = _mm256_setzero_si256();
+  __m256i s1 = s0, s2 = s0, s3 = s0;
+  usize i = 0;
+  for (; i + 16 <= count; i += 16) {
+    s0 = _mm256_add_epi64(s0, _mm256_loadu_si256((const __m256i *)&values[i]));
+    s1 = _mm256_add_epi64(s1, _mm256_loadu_si256((const __m256i *)&values[i + 4]));
+    s2 = _mm256_add_epi64(s2, _mm256_loadu_si256((const __m256i *)&values[i + 8]));
+    s3 = _mm256_add_epi64(s3, _mm256_loadu_si256((const __m256i *)&values[i + 12]));
+  }
+  s0 = _mm256_add_epi64(_mm256_add_epi64(s0, s1), _mm256_add_epi64(s2, s3));
+  u64 lanes[4];
+  _mm256_storeu_si256((__m256i *)lanes, s0);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + u64_sum_scalar(count - i, &values[i]);
+}
+
+// AVX2 only compares signed 64 bit integers. Flipping the sign bit of both
+// sides gives the unsigned order.
+CEBUS_TARGET_AVX2 static void i64_minmax_avx2(usize count, const i64 *values, i64 *min, i64 *max,
+                                             bool is_unsigned) {
+  const __m256i flip = _mm256_set1_epi64x(is_unsigned ? I64_MIN : 0);
+  __m256i lo = _mm256_xor_si256(_mm256_set1_epi64x(*min), flip);
+  __m256i hi = _mm256_xor_si256(_mm256_set1_epi64x(*max), flip);
+  usize i = 0;
+  for (; i + 4 <= count; i += 4) {
+    const __m256i x = _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)&values[i]), flip);
+    lo = _mm256_blendv_epi8(lo, x, _mm256_cmpgt_epi64(lo, x));
+    hi = _mm256_blendv_epi8(hi, x, _mm256_cmpgt_epi64(x, hi));
+  }
+  i64 lo_lanes[4];
+  i64 hi_lanes[4];
+  _mm256_storeu_si256((__m256i *)lo_lanes, _mm256_xor_si256(lo, flip));
+  _mm256_storeu_si256((__m256i *)hi_lanes, _mm256_xor_si256(hi, flip));
+  if (is_unsigned) {
+    u64_minmax_scalar(4, (const u64 *)lo_lanes, (u64 *)min, (u64 *)max);
+    u64_minmax_scalar(4, (const u64 *)hi_lanes, (u64 *)min, (u64 *)max);
+    u64_minmax_scalar(count - i, (const u64 *)&values[i], (u64 *)min, (u64 *)max);
+  } else {
+    i64_minmax_scalar(4, lo_lanes, min, max);
+    i64_minmax_scalar(4, hi_lanes, min, max);
+    i64_minmax_scalar(count - i, &values[i], min, max);
+  }
+}
+
+#undef NUMERIC_FLOAT_KERNELS
+
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+f32 f32_sum(usize count, const f32 *values) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return f32_sum_avx2(count, values);
+  }
+  if (cpu_has_sse2()) {
+    return f32_sum_sse2(count, values);
+  }
+#endif
+  return f32_sum_scalar(count, values);
+}
+
+f64 f64_sum(usize count, const f64 *values) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return f64_sum_avx2(count, values);
+  }
+  if (cpu_has_sse2()) {
+    return f64_sum_sse2(count, values);
+  }
+#endif
+  return f64_sum_scalar(count, values);
+}
+
+i64 i64_sum(usize count, const i64 *values) {
+  // the same bits as the wrapping unsigned sum
+  return (i64)u64_sum(count, (const u64 *)values);
+}
+
+u64 u64_sum(usize count, const u64 *values) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return u64_sum_avx2(count, values);
+  }
+#endif
+  return u64_sum_scalar(count, values);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+bool f32_minmax(usize count, const f32 *values, f32 *min, f32 *max) {
+  if (count == 0) {
+    return false;
+  }
+  *min = *max = values[0];
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    f32_minmax_avx2(count, values, min, max);
+    return true;
+  }
+  if (cpu_has_sse2()) {
+    f32_minmax_sse2(count, values, min, max);
+    return true;
+  }
+#endif
+  f32_minmax_scalar(count, values, min, max);
+  return true;
+}
+
+bool f64_minmax(usize count, const f64 *values, f64 *min, f64 *max) {
+  if (count == 0) {
+    return false;
+  }
+  *min = *max = values[0];
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    f64_minmax_avx2(count, values, min, max);
+    return true;
+  }
+  if (cpu_has_sse2()) {
+    f64_minmax_sse2(count, values, min, max);
+    return true;
+  }
+#endif
+  f64_minmax_scalar(count, values, min, max);
+  return true;
+}
+
+bool i64_minmax(usize count, const i64 *values, i64 *min, i64 *max) {
+  if (count == 0) {
+    return false;
+  }
+  *min = *max = values[0];
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    i64_minmax_avx2(count, values, min, max, false);
+    return true;
+  }
+#endif
+  i64_minmax_scalar(count, values, min, max);
+  return true;
+}
+
+bool u64_minmax(usize count, const u64 *values, u64 *min, u64 *max) {
+  if (count == 0) {
+    return false;
+  }
+  *min = *max = values[0];
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    i64_minmax_avx2(count, (const i64 *)values, (i64 *)min, (i64 *)max, true);
+    return true;
+  }
+#endif
+  u64_minmax_scalar(count, values, min, max);
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+f32 f32_dot(usize count, const f32 *a, const f32 *b) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return f32_dot_avx2(count, a, b);
+  }
+  if (cpu_has_sse2()) {
+    return f32_dot_sse2(count, a, b);
+  }
+#endif
+  return f32_dot_scalar(count, a, b);
+}
+
+f64 f64_dot(usize count, const f64 *a, const f64 *b) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return f64_dot_avx2(count, a, b);
+  }
+  if (cpu_has_sse2()) {
+    return f64_dot_sse2(count, a, b);
+  }
+#endif
+  return f64_dot_scalar(count, a, b);
+}
+
+// AVX2 has no 64 bit multiplication, so the integer dot products stay scalar.
+i64 i64_dot(usize count, const i64 *a, const i64 *b) { return i64_dot_scalar(count, a, b); }
+
+u64 u64_dot(usize count, const u64 *a, const u64 *b) { return u64_dot_scalar(count, a, b); }
+
+//////////////////////////////////////////////////////////////////////////////
+
+void f32_prefix_sum(usize count, const f32 *values, f32 *out) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    f32_prefix_sum_avx2(count, values, out);
+    return;
+  }
+#endif
+  f32_prefix_sum_scalar(count, values, out, 0);
+}
+
+void f64_prefix_sum(usize count, const f64 *values, f64 *out) {
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    f64_prefix_sum_avx2(count, values, out);
+    return;
+  }
+#endif
+  f64_prefix_sum_scalar(count, values, out, 0);
+}
+
+// Integer additions only take a cycle, so the scalar loop already keeps up
+// with the memory.
+void i64_prefix_sum(usize count, const i64 *values, i64 *out) {
+  i64_prefix_sum_scalar(count, values, out, 0);
+}
+
+void u64_prefix_sum(usize count, const u64 *values, u64 *out) {
+  u64_prefix_sum_scalar(count, values, out, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Bin 'b' of an integer histogram starts at 'ceil(b * range / bins)', so the
+// widths differ by at most one. 'width' and 'rem' are 'range / bins' and
+// 'range % bins'.
+static u64 numeric_int_bin_start(u64 bin, u64 bins, u64 width, u64 rem) {
+  return bin * width + (bin * rem + bins - 1) / bins;
+}
+
+static usize numeric_int_bin(u64 offset, u64 range, u64 bins, u64 width, u64 rem, bool wide) {
+  if (!wide) {
+    return (usize)(offset * bins / range);
+  }
+  // 'offset * bins' would overflow. Every bin is at most 'width + 1' wide, so
+  // this is never after the right bin and only a few bins before it.
+  u64 bin = offset / (width + 1);
+  while (bin + 1 < bins && numeric_int_bin_start(bin + 1, bins, width, rem) <= offset) {
+    bin++;
+  }
+  return (usize)bin;
+}
+
+#define NUMERIC_HISTOGRAM_ADD(T, l, BIN)                                                           \
+  do {                                                                                             \
+    const T value = values[i + (l)];                                                               \
+    if (min <= value && value < max) {                                                             \
+      BIN;                                                                                         \
+      local[l][bin]++;                                                                             \
+    }                                                                                              \
+  } while (0)
+
+// 'PREPARE' runs once, 'BIN' computes the bin of 'value' into 'bin'.
+#define NUMERIC_HISTOGRAM(T, PREPARE, BIN)                                                         \
+  void T##_histogram(usize count, const T *values, T min, T max, usize bins, usize *counts) {      \
+    if (bins == 0 || !(min < max)) {                                                               \
+      return;                                                                                      \
+    }                                                                                              \
+    PREPARE;                                                                                       \
+    if (NUMERIC_HISTOGRAM_LOCAL < bins) {                                                          \
+      for (usize i = 0; i < count; i++) {                                                          \
+        const T value = values[i];                                                                 \
+        if (min <= value && value < max) {                                                         \
+          BIN;                                                                                     \
+          counts[bin]++;                                                                           \
+        }                                                                                          \
+      }                                                                                            \
+      return;                                                                                      \
+    }                                                                                              \
+    usize local[4][NUMERIC_HISTOGRAM_LOCAL] = {0};                                                 \
+    usize i = 0;                                                                                   \
+    for (; i + 4 <= count; i += 4) {                                                               \
+      NUMERIC_HISTOGRAM_ADD(T, 0, BIN);                                                            \
+      NUMERIC_HISTOGRAM_ADD(T, 1, BIN);                                                            \
+      NUMERIC_HISTOGRAM_ADD(T, 2, BIN);                                                            \
+      NUMERIC_HISTOGRAM_ADD(T, 3, BIN);                                                            \
+    }                                                                                              \
+    for (; i < count; i++) {                                                                       \
+      const T value = values[i];                                                                   \
+      if (min <= value && value < max) {                                                           \
+        BIN;                                                                                       \
+        local[0][bin]++;                                                                           \
+      }                                                                                            \
+    }                                                                                              \
+    for (usize b = 0; b < bins; b++) {                                                             \
+      counts[b] += local[0][b] + local[1][b] + local[2][b] + local[3][b];                          \
+    }                                                                                              \
+  }
+
+// Rounding can put a value just below 'max' into the bin after the last one.
+#define NUMERIC_FLOAT_PREPARE(T) const T scale = (T)bins / (max - min)
+#define NUMERIC_FLOAT_BIN                                                                          \
+  usize bin = (usize)((value - min) * scale);                                                      \
+  bin = bin < bins ? bin : bins - 1
+
+#define NUMERIC_INT_PREPARE                                                                        \
+  const u64 range = (u64)max - (u64)min;                                                           \
+  const u64 width = range / bins;                                                                  \
+  const u64 rem = range % bins;                                                                    \
+  const bool wide = U64_MAX / bins < range
+#define NUMERIC_INT_BIN                                                                            \
+  const usize bin = numeric_int_bin((u64)value - (u64)min, range, bins, width, rem, wide)
+
+NUMERIC_HISTOGRAM(f32, NUMERIC_FLOAT_PREPARE(f32), NUMERIC_FLOAT_BIN)
+NUMERIC_HISTOGRAM(f64, NUMERIC_FLOAT_PREPARE(f64), NUMERIC_FLOAT_BIN)
+NUMERIC_HISTOGRAM(i64, NUMERIC_INT_PREPARE, NUMERIC_INT_BIN)
+NUMERIC_HISTOGRAM(u64, NUMERIC_INT_PREPARE, NUMERIC_INT_BIN)
+
+//////////////////////////////////////////////////////////////////////////////
+
+#undef NUMERIC_HISTOGRAM_LOCAL
+#undef NUMERIC_SCALAR
+#undef NUMERIC_HISTOGRAM
+#undef NUMERIC_HISTOGRAM_ADD
+#undef NUMERIC_FLOAT_PREPARE
+#undef NUMERIC_FLOAT_BIN
+#undef NUMERIC_INT_PREPARE
+#undef NUMERIC_INT_BIN
@@ -0,0 +1,54 @@
+/* DOCUMENTATION
+## Functions
+
+Reductions over arrays of numbers. They take a count and a pointer, so a
+dynamic array can be passed with `DA_ARG`. They use AVX2 or SSE2 if the CPU
+supports it and fall back to a scalar implementation otherwise.
+
+These functions are available for `f32`, `f64`, `i64` and `u64`.
+
+- `T_sum(count, values)`: Returns the sum of the values.
+- `T_minmax(count, values, min, max)`: Writes the smallest and the biggest
+value into `min` and `max`. Returns `false` if there are no values.
+- `T_dot(count, a, b)`: Returns the dot product of two arrays.
+- `T_prefix_sum(count, values, out)`: Writes the inclusive prefix sums into
+`out`. `out` can be `values`.
+- `T_histogram(count, values, min, max, bins, counts)`: Splits `[min, max)`
+into `bins` bins of the same width and adds the number of values in every bin
+to `counts`. Values outside of the range are ignored. For integers, the value
+`v` goes into bin `(v - min) * bins / (max - min)`, so if the range is not a
+multiple of `bins` some bins are one wider than others.
+
+```c
+DA(f64) samples = da_new(&arena);
+// ...
+f64 mean = f64_sum(DA_ARG(&samples)) / (f64)da_len(&samples);
+f64 min, max;
+f64_minmax(DA_ARG(&samples), &min, &max);
+```
+
+The floating point functions add the values in multiple lanes, so the result
+can differ from a simple loop in the last bits. The integer functions wrap
+around on overflow.
+*/
+
+#ifndef __CEBUS_NUMERIC_H__
+#define __CEBUS_NUMERIC_H__
+
+#include "cebus/core/defines.h"
+
+#define NUMERIC_DECL(T)                                                                            \
+  T T##_sum(usize count, const T *values);                                                         \
+  bool T##_minmax(usize count, const T *values, T *min, T *max);                                   \
+  T T##_dot(usize count, const T *a, const T *b);                                                  \
+  void T##_prefix_sum(usize count, const T *values, T *out);                                       \
+  void T##_histogram(usize count, const T *values, T min, T max, usize bins, usize *counts);
+
+NUMERIC_DECL(f32)
+NUMERIC_DECL(f64)
+NUMERIC_DECL(i64)
+NUMERIC_DECL(u64)
+
+#undef NUMERIC_DECL
+
+#endif /* !__CEBUS_NUMERIC_H__ */
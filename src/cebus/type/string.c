@@ -1,15 +1,299 @@
 #include "./string.h"
 
+#include "cebus/collection/aho_corasick.h"
+#include "cebus/collection/da.h"
+#include "cebus/collection/string_builder.h"
 #include "cebus/core/arena.h"
+#include "cebus/core/cpu.h"
+#include "cebus/core/platform.h"
 #include "cebus/type/byte.h"
 #include "cebus/type/char.h"
 #include "cebus/type/integer.h"
 
+#include <errno.h>
+#include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(CEBUS_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+
+// Without vector instructions, needles with at least this many bytes are
+// searched with Horspool, that can skip up to the length of the needle.
+#define STR_SEARCH_LONG 32
+
+#if defined(GCC) || defined(CLANG)
+#define STR_FIRST_BIT(mask) ((usize)__builtin_ctz(mask))
+#define STR_LAST_BIT(mask) ((usize)(31 - __builtin_clz(mask)))
+#define STR_FIRST_BIT64(mask) ((usize)__builtin_ctzll(mask))
+#else
+#define STR_FIRST_BIT(mask) u32_trailing_zeros(mask)
+#define STR_LAST_BIT(mask) (31 - u32_leading_zeros(mask))
+#define STR_FIRST_BIT64(mask) u64_trailing_zeros(mask)
+#endif
+
+// Finds the first byte with 'memchr' and only compares the rest there.
+static usize str_search_scalar(const char *haystack, usize len, const char *needle, usize n) {
+  if (len < n) {
+    return STR_NOT_FOUND;
+  }
+  const usize end = len - n + 1;
+  for (usize i = 0; i < end; i++) {
+    const char *hit = memchr(&haystack[i], needle[0], end - i);
+    if (hit == NULL) {
+      break;
+    }
+    i = (usize)(hit - haystack);
+    if (memcmp(&haystack[i + 1], &needle[1], n - 1) == 0) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static usize str_search_last_scalar(const char *haystack, usize len, const char *needle,
+                                    usize n) {
+  if (len < n) {
+    return STR_NOT_FOUND;
+  }
+  for (usize i = len - n + 1; 0 < i; i--) {
+    if (haystack[i - 1] == needle[0] && haystack[i + n - 2] == needle[n - 1] &&
+        memcmp(&haystack[i - 1], needle, n) == 0) {
+      return i - 1;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static void str_search_horspool_init(Str needle, usize *skip) {
+  for (usize c = 0; c < 256; c++) {
+    skip[c] = needle.len;
+  }
+  for (usize i = 0; i + 1 < needle.len; i++) {
+    skip[(u8)needle.data[i]] = needle.len - 1 - i;
+  }
+}
+
+static usize str_search_horspool(const char *haystack, usize len, Str needle, const usize *skip) {
+  const usize last = needle.len - 1;
+  const char last_byte = needle.data[last];
+  for (usize i = 0; i + last < len; i += skip[(u8)haystack[i + last]]) {
+    if (haystack[i + last] == last_byte && memcmp(&haystack[i], needle.data, last) == 0) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static bool str_eq_ignorecase_parts(const char *s1, const char *s2, usize n) {
+  for (usize i = 0; i < n; i++) {
+    if (c_to_lower(s1[i]) != c_to_lower(s2[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+static usize str_search_ignorecase_scalar(const char *haystack, usize len, const char *needle,
+                                          usize n) {
+  if (len < n) {
+    return STR_NOT_FOUND;
+  }
+  const char first = c_to_lower(needle[0]);
+  for (usize i = 0; i + n <= len; i++) {
+    if (c_to_lower(haystack[i]) == first && str_eq_ignorecase_parts(&haystack[i], needle, n)) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+#if defined(CEBUS_SIMD_X86)
+
+// The two cases of an ASCII letter only differ in bit 5, so setting it in
+// every byte of the haystack makes them equal. No other byte ends up equal to
+// a lowercase letter. Bytes of the needle that are not letters are compared
+// as they are.
+static char str_fold_mask(char c) {
+  const char lower = (char)(c | 0x20);
+  return 'a' <= lower && lower <= 'z' ? 0x20 : 0;
+}
+
+// Compares the first and the last byte of the needle with 'W' positions at
+// once and only calls 'memcmp' where both match. 'n' has to be at least 2.
+#define STR_SEARCH_KERNELS(NAME, TARGET, V, W, LOAD, SET1, CMPEQ, AND, MOVEMASK)                   \
+  TARGET static usize str_search_##NAME(const char *haystack, usize len, const char *needle,       \
+                                        usize n) {                                                 \
+    const V first = SET1(needle[0]);                                                               \
+    const V last = SET1(needle[n - 1]);                                                            \
+    const usize end = len - n + 1;                                                                 \
+    usize i = 0;                                                                                   \
+    for (; i + (W) <= end; i += (W)) {                                                             \
+      const V f = CMPEQ(first, LOAD((const V *)&haystack[i]));                                     \
+      const V l = CMPEQ(last, LOAD((const V *)&haystack[i + n - 1]));                              \
+      for (u32 mask = (u32)MOVEMASK(AND(f, l)); mask; mask &= mask - 1) {                          \
+        const usize idx = i + STR_FIRST_BIT(mask);                                                 \
+        if (memcmp(&haystack[idx + 1], &needle[1], n - 2) == 0) {                                  \
+          return idx;                                                                              \
+        }                                                                                          \
+      }                                                                                            \
+    }                                                                                              \
+    const usize idx = str_search_scalar(&haystack[i], len - i, needle, n);                         \
+    return idx == STR_NOT_FOUND ? idx : i + idx;                                                   \
+  }                                                                                                \
+                                                                                                   \
+  TARGET static usize str_search_last_##NAME(const char *haystack, usize len, const char *needle,  \
+                                             usize n) {                                            \
+    const V first = SET1(needle[0]);                                                               \
+    const V last = SET1(needle[n - 1]);                                                            \
+    usize end = len - n + 1;                                                                       \
+    for (; (W) <= end; end -= (W)) {                                                               \
+      const usize i = end - (W);                                                                   \
+      const V f = CMPEQ(first, LOAD((const V *)&haystack[i]));                                     \
+      const V l = CMPEQ(last, LOAD((const V *)&haystack[i + n - 1]));                              \
+      u32 mask = (u32)MOVEMASK(AND(f, l));                                                         \
+      while (mask) {                                                                               \
+        const usize bit = STR_LAST_BIT(mask);                                                      \
+        if (memcmp(&haystack[i + bit + 1], &needle[1], n - 2) == 0) {                              \
+          return i + bit;                                                                          \
+        }                                                                                          \
+        mask ^= (u32)1 << bit;                                                                     \
+      }                                                                                            \
+    }                                                                                              \
+    return str_search_last_scalar(haystack, end + n - 1, needle, n);                               \
+  }
+
+STR_SEARCH_KERNELS(sse2, , __m128i, 16, _mm_loadu_si128, _mm_set1_epi8, _mm_cmpeq_epi8,
+                   _mm_and_si128, _mm_movemask_epi8)
+STR_SEARCH_KERNELS(avx2, CEBUS_TARGET_AVX2, __m256i, 32, _mm256_loadu_si256, _mm256_set1_epi8,
+                   _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_movemask_epi8)
+
+#undef STR_SEARCH_KERNELS
+
+// Same as 'str_search_##NAME', with the first and the last byte folded with
+// 'str_fold_mask'. 'n' can be 1.
+#define STR_SEARCH_FOLD_KERNEL(NAME, TARGET, V, W, LOAD, SET1, CMPEQ, AND, OR, MOVEMASK)           \
+  TARGET static usize str_search_ignorecase_##NAME(const char *haystack, usize len,                \
+                                                   const char *needle, usize n) {                  \
+    const V first_mask = SET1(str_fold_mask(needle[0]));                                           \
+    const V last_mask = SET1(str_fold_mask(needle[n - 1]));                                        \
+    const V first = SET1((char)(needle[0] | str_fold_mask(needle[0])));                            \
+    const V last = SET1((char)(needle[n - 1] | str_fold_mask(needle[n - 1])));                     \
+    const usize end = len - n + 1;                                                                 \
+    usize i = 0;                                                                                   \
+    for (; i + (W) <= end; i += (W)) {                                                             \
+      const V f = CMPEQ(first, OR(first_mask, LOAD((const V *)&haystack[i])));                     \
+      const V l = CMPEQ(last, OR(last_mask, LOAD((const V *)&haystack[i + n - 1])));               \
+      for (u32 mask = (u32)MOVEMASK(AND(f, l)); mask; mask &= mask - 1) {                          \
+        const usize idx = i + STR_FIRST_BIT(mask);                                                 \
+        if (str_eq_ignorecase_parts(&haystack[idx], needle, n)) {                                  \
+          return idx;                                                                              \
+        }                                                                                          \
+      }                                                                                            \
+    }                                                                                              \
+    const usize idx = str_search_ignorecase_scalar(&haystack[i], len - i, needle, n);              \
+    return idx == STR_NOT_FOUND ? idx : i + idx;                                                   \
+  }
+
+STR_SEARCH_FOLD_KERNEL(sse2, , __m128i, 16, _mm_loadu_si128, _mm_set1_epi8, _mm_cmpeq_epi8,
+                       _mm_and_si128, _mm_or_si128, _mm_movemask_epi8)
+STR_SEARCH_FOLD_KERNEL(avx2, CEBUS_TARGET_AVX2, __m256i, 32, _mm256_loadu_si256, _mm256_set1_epi8,
+                       _mm256_cmpeq_epi8, _mm256_and_si256, _mm256_or_si256, _mm256_movemask_epi8)
+
+#undef STR_SEARCH_FOLD_KERNEL
+
+#endif
+
+// Returns the Horspool table if it is worth building one for the search,
+// 'NULL' otherwise. The vector filter is faster even for long needles, so
+// Horspool is only used without it.
+static const usize *str_search_prepare(usize len, Str needle, usize *skip) {
+  if (needle.len < STR_SEARCH_LONG || len < 4 * needle.len) {
+    return NULL;
+  }
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_sse2()) {
+    return NULL;
+  }
+#endif
+  str_search_horspool_init(needle, skip);
+  return skip;
+}
+
+static usize str_search(Str haystack, Str needle, const usize *skip) {
+  if (haystack.len < needle.len) {
+    return STR_NOT_FOUND;
+  }
+  if (needle.len == 0) {
+    return 0;
+  }
+  if (needle.len == 1) {
+    const char *hit = memchr(haystack.data, needle.data[0], haystack.len);
+    return hit ? (usize)(hit - haystack.data) : STR_NOT_FOUND;
+  }
+  if (skip) {
+    return str_search_horspool(haystack.data, haystack.len, needle, skip);
+  }
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return str_search_avx2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+  if (cpu_has_sse2()) {
+    return str_search_sse2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+#endif
+  return str_search_scalar(haystack.data, haystack.len, needle.data, needle.len);
+}
+
+static usize str_search_ignorecase(Str haystack, Str needle) {
+  if (haystack.len < needle.len) {
+    return STR_NOT_FOUND;
+  }
+  if (needle.len == 0) {
+    return 0;
+  }
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return str_search_ignorecase_avx2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+  if (cpu_has_sse2()) {
+    return str_search_ignorecase_sse2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+#endif
+  return str_search_ignorecase_scalar(haystack.data, haystack.len, needle.data, needle.len);
+}
+
+static usize str_search_last(Str haystack, Str needle) {
+  if (haystack.len < needle.len) {
+    return STR_NOT_FOUND;
+  }
+  if (needle.len == 0) {
+    return haystack.len;
+  }
+  if (needle.len == 1) {
+    for (usize i = haystack.len; 0 < i; i--) {
+      if (haystack.data[i - 1] == needle.data[0]) {
+        return i - 1;
+      }
+    }
+    return STR_NOT_FOUND;
+  }
+#if defined(CEBUS_SIMD_X86)
+  if (cpu_has_avx2()) {
+    return str_search_last_avx2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+  if (cpu_has_sse2()) {
+    return str_search_last_sse2(haystack.data, haystack.len, needle.data, needle.len);
+  }
+#endif
+  return str_search_last_scalar(haystack.data, haystack.len, needle.data, needle.len);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 
 Str str_from_parts(usize size, const char *cstr) { return (Str){.len = size, .data = cstr}; }
@@ -33,6 +317,27 @@ Str str_format(Arena *arena, const char *fmt, ...) {
   return str_from_parts(size - 1, buffer);
 }
 
+// Every number fits, so the builder never grows. The string is terminated like
+// the ones from 'str_format'.
+#define STR_FROM_NUMBER(append, value, arena)                                                      \
+  do {                                                                                             \
+    StringBuilder sb = sb_init(arena);                                                             \
+    da_reserve(&sb, 32);                                                                           \
+    append(&sb, value);                                                                            \
+    da_push(&sb, '\0');                                                                            \
+    return str_from_parts(sb.len - 1, sb.items);                                                   \
+  } while (0)
+
+Str str_from_u64(u64 value, Arena *arena) { STR_FROM_NUMBER(sb_append_u64, value, arena); }
+
+Str str_from_i64(i64 value, Arena *arena) { STR_FROM_NUMBER(sb_append_i64, value, arena); }
+
+Str str_from_hex(u64 value, Arena *arena) { STR_FROM_NUMBER(sb_append_hex, value, arena); }
+
+Str str_from_f64(f64 value, Arena *arena) { STR_FROM_NUMBER(sb_append_f64, value, arena); }
+
+#undef STR_FROM_NUMBER
+
 ///////////////////////////////////////////////////////////////////////////////
 
 Str str_copy(Str s, Arena *arena) {
@@ -172,22 +477,74 @@ Str str_lower(Str s, Arena *arena) {
 }
 
 Str str_replace(Str s, Str old, Str new, Arena *arena) {
-  usize count = str_count(s, old);
-  usize new_size = (s.len - (old.len * count) + (count * new.len));
+  if (old.len == 0) {
+    return str_copy(s, arena);
+  }
+  // the positions of the matches, so the input is only searched once
+  Arena scratch = {0};
+  DA(usize) matches = da_new(&scratch);
+  usize skip[256];
+  const usize *table = str_search_prepare(s.len, old, skip);
+  for (usize i = 0; i < s.len;) {
+    const Str rest = str_from_parts(s.len - i, &s.data[i]);
+    const usize idx = str_search(rest, old, table);
+    if (idx == STR_NOT_FOUND) {
+      break;
+    }
+    da_push(&matches, i + idx);
+    i += idx + old.len;
+  }
+
+  const usize count = da_len(&matches);
+  const usize new_size = s.len - old.len * count + new.len * count;
   char *buffer = arena_alloc(arena, new_size + 1);
   buffer[new_size] = '\0';
+  usize i = 0;
+  usize j = 0;
+  for (usize m = 0; m < count; m++) {
+    const usize idx = da_get(&matches, m);
+    memcpy(&buffer[j], &s.data[i], idx - i);
+    j += idx - i;
+    memcpy(&buffer[j], new.data, new.len);
+    j += new.len;
+    i = idx + old.len;
+  }
+  memcpy(&buffer[j], &s.data[i], s.len - i);
 
-  for (usize i = 0, j = 0; i < s.len;) {
-    if (old.len <= s.len - i && memcmp(&s.data[i], old.data, old.len) == 0) {
-      memcpy(&buffer[j], new.data, new.len);
-      i += old.len;
-      j += new.len;
-    } else {
-      buffer[j++] = s.data[i++];
+  arena_free(&scratch);
+  return str_from_parts(new_size, buffer);
+}
+
+void _str_replace_each(Str s, Str old, Str new, bool ignorecase,
+                       bool (*write)(void *ctx, Str part), void *ctx) {
+  if (old.len == 0) {
+    write(ctx, s);
+    return;
+  }
+  usize skip[256];
+  const usize *table = ignorecase ? NULL : str_search_prepare(s.len, old, skip);
+  for (;;) {
+    const usize idx = ignorecase ? str_search_ignorecase(s, old) : str_search(s, old, table);
+    if (idx == STR_NOT_FOUND) {
+      break;
     }
+    if (!write(ctx, str_from_parts(idx, s.data)) || !write(ctx, new)) {
+      return;
+    }
+    s = str_from_parts(s.len - idx - old.len, &s.data[idx + old.len]);
   }
+  write(ctx, s);
+}
 
-  return str_from_parts(new_size, buffer);
+Str str_replace_many(Str s, usize count, const Str *olds, const Str *news, Arena *arena) {
+  Arena scratch = {0};
+  const AhoCorasick *ac = ac_create(&scratch, count, olds);
+  StringBuilder sb = sb_init(arena);
+  da_reserve(&sb, s.len + 1);
+  ac_replace(ac, s, news, &sb);
+  sb_append_c(&sb, '\0');
+  arena_free(&scratch);
+  return str_from_parts(sb.len - 1, sb.items);
 }
 
 Str str_center(Str s, usize width, char fillchar, Arena *arena) {
@@ -278,12 +635,7 @@ bool str_eq_ignorecase(Str s1, Str s2) {
   if (s1.len != s2.len) {
     return false;
   }
-  for (size_t i = 0; i < s1.len; i++) {
-    if (c_to_lower(s1.data[i]) != c_to_lower(s2.data[i])) {
-      return false;
-    }
-  }
-  return true;
+  return str_eq_ignorecase_parts(s1.data, s2.data, s1.len);
 }
 
 bool str_startswith(Str s1, Str prefix) {
@@ -302,15 +654,7 @@ bool str_endswith(Str s1, Str suffix) {
 }
 
 bool str_contains(Str haystack, Str needle) {
-  if (haystack.len < needle.len) {
-    return false;
-  }
-  for (usize i = 0; i < haystack.len - needle.len + 1; i++) {
-    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
-      return true;
-    }
-  }
-  return false;
+  return str_search(haystack, needle, NULL) != STR_NOT_FOUND;
 }
 
 bool str_includes(Str haystack, char needle) {
@@ -518,6 +862,60 @@ Str str_chop_right_by_predicate(Str *s, bool (*predicate)(char)) {
   return *s;
 }
 
+Str str_trim_left_by_charset(Str s, const CharSet *set) {
+  const usize n = charset_span(set, s);
+  return str_from_parts(s.len - n, &s.data[n]);
+}
+
+Str str_trim_right_by_charset(Str s, const CharSet *set) {
+  return str_from_parts(s.len - charset_rspan(set, s), s.data);
+}
+
+Str str_trim_by_charset(Str s, const CharSet *set) {
+  return str_trim_left_by_charset(str_trim_right_by_charset(s, set), set);
+}
+
+bool str_try_chop_by_charset(Str *s, const CharSet *set, Str *chunk) {
+  if (s->len == 0) {
+    return false;
+  }
+  const usize i = charset_cspan(set, *s);
+  if (chunk) {
+    *chunk = str_from_parts(i, s->data);
+  }
+  const usize new_len = usize_min(s->len, i + 1);
+  s->data += new_len;
+  s->len -= new_len;
+  *s = str_trim_left_by_charset(*s, set);
+  return true;
+}
+
+Str str_chop_by_charset(Str *s, const CharSet *set) {
+  Str chunk = *s;
+  str_try_chop_by_charset(s, set, &chunk);
+  return chunk;
+}
+
+Str str_chop_right_by_charset(Str *s, const CharSet *set) {
+  if (s->len == 0) {
+    return *s;
+  }
+  const usize i = charset_rcspan(set, *s);
+  Str chunk = str_from_parts(i, &s->data[s->len - i]);
+  s->len -= usize_min(s->len, i + 1);
+  *s = str_trim_right_by_charset(*s, set);
+  return chunk;
+}
+
+bool _str_split_next(Str *s, const CharSet *set, Str *field) {
+  *s = str_trim_left_by_charset(*s, set);
+  if (s->len == 0) {
+    return false;
+  }
+  *field = str_take(s, charset_cspan(set, *s));
+  return true;
+}
+
 Str str_substring(Str s, usize start, usize end) {
   if (end <= start || s.len <= start || s.len < end) {
     return STR("");
@@ -563,115 +961,463 @@ bool str_try_take_right(Str *s, usize count, Str *chunk) {
 
 ///////////////////////////////////////////////////////////////////////////////
 
-u64 str_u64(Str s) {
-  const int radix = 10;
-  Arena arena = {0};
-  Str owned = str_copy(s, &arena);
-  u64 value = strtoull(owned.data, NULL, radix);
-  arena_free(&arena);
+// 'c_is_digit' is not inlined from another file, and this is the hot loop.
+static inline bool str_is_digit(char c) { return (u8)(c - '0') < 10; }
+
+// Loads 8 characters with the first one in the lowest byte.
+static inline u64 str_load_le64(const char *data) {
+  u64 value;
+  memcpy(&value, data, sizeof(value));
+#if CEBUS_BYTE_ORDER == ENDIAN_BIG
+  value = u64_swap_bytes(value);
+#endif
   return value;
 }
 
-u64 str_chop_u64(Str *s) {
-  const int radix = 10;
-  Arena arena = {0};
-  Str owned = str_copy(*s, &arena);
-  char *endptr;
-  u64 value = strtoull(owned.data, &endptr, radix);
+// Returns how many of the 8 characters are digits, before the first one that
+// is not. After the xor digits are the bytes below 10, and adding 0x76 sets the
+// high bit of all others. A carry only changes bytes after the first one.
+static inline usize str_count_8_digits(u64 chunk) {
+  const u64 x = chunk ^ 0x3030303030303030;
+  const u64 mask = ((x + 0x7676767676767676) | x) & 0x8080808080808080;
+  return mask ? STR_FIRST_BIT64(mask) / 8 : 8;
+}
 
-  const usize size = (usize)(endptr - owned.data);
-  s->data += size;
-  s->len -= size;
+// Converts 8 digits with three multiplications: first into pairs of digits,
+// then into groups of four and then into one number.
+static inline u64 str_parse_8_digits(u64 chunk) {
+  const u64 mask = 0x000000FF000000FF;
+  const u64 mul1 = 100 + (1000000ULL << 32);
+  const u64 mul2 = 1 + (10000ULL << 32);
+  chunk -= 0x3030303030303030;
+  chunk = (chunk * 10) + (chunk >> 8);
+  return (((chunk & mask) * mul1) + (((chunk >> 16) & mask) * mul2)) >> 32;
+}
 
-  arena_free(&arena);
-  return value;
+static const u64 str_u64_pow10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+// Parses the digits at the start of 's' and returns how many there were.
+// 'overflow' is set if the number does not fit into an u64.
+static usize str_scan_digits(Str s, u64 *value, bool *overflow) {
+  usize i = 0;
+  while (i < s.len && s.data[i] == '0') {
+    i++;
+  }
+  const usize start = i;
+  u64 result = 0;
+  // Up to 8 digits at a time without a branch per digit. The missing digits
+  // are filled up with leading zeros. 19 digits always fit into an u64.
+  while (i + 8 <= s.len) {
+    u64 chunk = str_load_le64(&s.data[i]);
+    const usize digits = str_count_8_digits(chunk);
+    if (digits == 0 || 19 < i - start + digits) {
+      break;
+    }
+    if (digits < 8) {
+      chunk = (chunk << (8 * (8 - digits))) | (0x3030303030303030 >> (8 * digits));
+    }
+    result = result * str_u64_pow10[digits] + str_parse_8_digits(chunk);
+    i += digits;
+    if (digits < 8) {
+      *value = result;
+      return i;
+    }
+  }
+  for (; i < s.len && str_is_digit(s.data[i]); i++) {
+    const u64 digit = (u64)(s.data[i] - '0');
+    if (19 <= i - start && (U64_MAX - digit) / 10 < result) {
+      *overflow = true;
+    }
+    result = result * 10 + digit;
+  }
+  *value = *overflow ? U64_MAX : result;
+  return i;
+}
+
+// Parses '[+-]digits' and returns the number of characters, or 0 if there are
+// no digits.
+static usize str_scan_integer(Str s, bool *negative, u64 *magnitude, bool *overflow) {
+  usize i = 0;
+  *negative = false;
+  if (i < s.len && (s.data[i] == '+' || s.data[i] == '-')) {
+    *negative = s.data[i] == '-';
+    i++;
+  }
+  const usize digits = str_scan_digits(str_from_parts(s.len - i, &s.data[i]), magnitude, overflow);
+  return digits ? i + digits : 0;
+}
+
+// Checks if the magnitude fits into an i64. '-9223372036854775808' does, but
+// its magnitude does not.
+static bool str_integer_i64(bool negative, u64 magnitude, i64 *value) {
+  if (negative) {
+    if ((u64)I64_MAX + 1 < magnitude) {
+      *value = I64_MIN;
+      return false;
+    }
+    *value = magnitude ? -(i64)(magnitude - 1) - 1 : 0;
+    return true;
+  }
+  if ((u64)I64_MAX < magnitude) {
+    *value = I64_MAX;
+    return false;
+  }
+  *value = (i64)magnitude;
+  return true;
 }
 
-i64 str_i64(Str s) {
-  const int radix = 10;
+///////////////////////////////////////////////////////////////////////////////
+
+// Powers of ten that are exact in a double.
+static const f64 str_pow10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
+
+// Doubles have 53 bits of mantissa.
+#define STR_F64_EXACT ((u64)1 << 53)
+// Numbers with more than this many characters, that need 'strtod', are copied
+// into an arena instead of the stack.
+#define STR_F64_BUFFER 64
+
+// 'strtod' needs a terminated string.
+static f64 str_strtod(Str s, usize *consumed, bool *overflow) {
+  char buffer[STR_F64_BUFFER];
   Arena arena = {0};
-  Str owned = str_copy(s, &arena);
-  i64 value = strtoll(owned.data, NULL, radix);
+  char *cstr = buffer;
+  if (sizeof(buffer) <= s.len) {
+    cstr = arena_alloc(&arena, s.len + 1);
+  }
+  memcpy(cstr, s.data, s.len);
+  cstr[s.len] = '\0';
+
+  char *end;
+  errno = 0;
+  const f64 value = strtod(cstr, &end);
+  *consumed = (usize)(end - cstr);
+  *overflow = errno == ERANGE && (value == HUGE_VAL || value == -HUGE_VAL);
   arena_free(&arena);
   return value;
 }
 
-i64 str_chop_i64(Str *s) {
-  const int radix = 10;
-  Arena arena = {0};
-  Str owned = str_copy(*s, &arena);
-  char *endptr;
-  i64 value = strtoll(owned.data, &endptr, radix);
+static usize str_scan_word(Str s, const char *word) {
+  usize i = 0;
+  while (word[i] && i < s.len && (s.data[i] | 0x20) == word[i]) {
+    i++;
+  }
+  return word[i] ? 0 : i;
+}
 
-  const usize size = (usize)(endptr - owned.data);
-  s->data += size;
-  s->len -= size;
+// Parses a float the way 'strtod' does, and returns the number of characters or
+// 0. Numbers with up to 19 significant digits, that are exact in a double and
+// only need an exact power of ten, are converted with a single multiplication
+// or division (Clinger's fast path). All others go through 'strtod'.
+static usize str_scan_f64(Str s, f64 *value, bool *overflow) {
+  usize i = 0;
+  bool negative = false;
+  if (i < s.len && (s.data[i] == '+' || s.data[i] == '-')) {
+    negative = s.data[i] == '-';
+    i++;
+  }
+  const Str rest = str_from_parts(s.len - i, &s.data[i]);
+  usize special = str_scan_word(rest, "infinity");
+  special = special ? special : str_scan_word(rest, "inf");
+  if (special) {
+    *value = negative ? -HUGE_VAL : HUGE_VAL;
+    return i + special;
+  }
+  if (str_scan_word(rest, "nan") || str_scan_word(rest, "0x")) {
+    usize consumed = 0;
+    *value = str_strtod(s, &consumed, overflow);
+    return consumed;
+  }
 
-  arena_free(&arena);
-  return value;
+  u64 mantissa = 0;
+  usize kept = 0;
+  bool truncated = false;
+  usize digits = 0;
+  i64 exponent = 0;
+  for (; i < s.len && str_is_digit(s.data[i]); i++, digits++) {
+    if (kept < 19) {
+      mantissa = mantissa * 10 + (u64)(s.data[i] - '0');
+      kept += mantissa != 0;
+    } else {
+      truncated |= s.data[i] != '0';
+      exponent++;
+    }
+  }
+  if (i < s.len && s.data[i] == '.') {
+    for (i++; i < s.len && str_is_digit(s.data[i]); i++, digits++) {
+      if (kept < 19) {
+        mantissa = mantissa * 10 + (u64)(s.data[i] - '0');
+        kept += mantissa != 0;
+        exponent--;
+      } else {
+        truncated |= s.data[i] != '0';
+      }
+    }
+  }
+  if (digits == 0) {
+    return 0;
+  }
+  if (i < s.len && (s.data[i] | 0x20) == 'e') {
+    bool exp_negative = false;
+    u64 exp_value = 0;
+    bool exp_overflow = false;
+    const usize len = str_scan_integer(str_from_parts(s.len - i - 1, &s.data[i + 1]),
+                                       &exp_negative, &exp_value, &exp_overflow);
+    if (len) {
+      i += 1 + len;
+      // anything this large is either zero or infinity anyway
+      exp_value = exp_value < 100000 ? exp_value : 100000;
+      exponent += exp_negative ? -(i64)exp_value : (i64)exp_value;
+    }
+  }
+
+  *overflow = false;
+  if (mantissa == 0 && !truncated) {
+    *value = negative ? -0.0 : 0.0;
+    return i;
+  }
+  if (!truncated && mantissa <= STR_F64_EXACT && -22 <= exponent && exponent <= 22) {
+    const f64 m = (f64)mantissa;
+    *value = exponent < 0 ? m / str_pow10[-exponent] : m * str_pow10[exponent];
+    *value = negative ? -*value : *value;
+    return i;
+  }
+  usize consumed = 0;
+  *value = str_strtod(str_from_parts(i, s.data), &consumed, overflow);
+  return consumed;
 }
 
-f64 str_f64(Str s) {
-  Arena arena = {0};
-  Str owned = str_copy(s, &arena);
-  double value = strtod(owned.data, NULL);
-  arena_free(&arena);
+#undef STR_F64_EXACT
+#undef STR_F64_BUFFER
+
+///////////////////////////////////////////////////////////////////////////////
+
+u64 str_u64(Str s) { return str_chop_u64(&s); }
+
+u64 str_chop_u64(Str *s) {
+  const Str trimmed = str_trim_left(*s);
+  bool negative = false;
+  bool overflow = false;
+  u64 magnitude = 0;
+  const usize len = str_scan_integer(trimmed, &negative, &magnitude, &overflow);
+  if (len == 0) {
+    return 0;
+  }
+  *s = str_from_parts(trimmed.len - len, &trimmed.data[len]);
+  // the same as 'strtoull'
+  return negative && !overflow ? 0 - magnitude : magnitude;
+}
+
+i64 str_i64(Str s) { return str_chop_i64(&s); }
+
+i64 str_chop_i64(Str *s) {
+  const Str trimmed = str_trim_left(*s);
+  bool negative = false;
+  bool overflow = false;
+  u64 magnitude = 0;
+  const usize len = str_scan_integer(trimmed, &negative, &magnitude, &overflow);
+  if (len == 0) {
+    return 0;
+  }
+  *s = str_from_parts(trimmed.len - len, &trimmed.data[len]);
+  i64 value = 0;
+  str_integer_i64(negative, magnitude, &value);
   return value;
 }
 
+f64 str_f64(Str s) { return str_chop_f64(&s); }
+
 f64 str_chop_f64(Str *s) {
-  Arena arena = {0};
-  Str owned = str_copy(*s, &arena);
+  const Str trimmed = str_trim_left(*s);
+  bool overflow = false;
+  f64 value = 0;
+  const usize len = str_scan_f64(trimmed, &value, &overflow);
+  if (len == 0) {
+    return 0;
+  }
+  *s = str_from_parts(trimmed.len - len, &trimmed.data[len]);
+  return value;
+}
 
-  char *endptr;
-  f64 value = strtod(owned.data, &endptr);
+///////////////////////////////////////////////////////////////////////////////
 
-  const usize size = (usize)(endptr - owned.data);
-  s->data += size;
-  s->len -= size;
+static StrParseError str_try_u64(Str s, u64 *value) {
+  bool overflow = false;
+  usize len = 0;
+  if (s.len && s.data[0] == '+') {
+    len = 1;
+  }
+  const usize digits = str_scan_digits(str_from_parts(s.len - len, &s.data[len]), value, &overflow);
+  if (digits == 0 || len + digits != s.len) {
+    return STR_PARSE_INVALID;
+  }
+  return overflow ? STR_PARSE_OVERFLOW : STR_PARSE_OK;
+}
 
-  arena_free(&arena);
+static StrParseError str_try_i64(Str s, i64 *value) {
+  bool negative = false;
+  bool overflow = false;
+  u64 magnitude = 0;
+  const usize len = str_scan_integer(s, &negative, &magnitude, &overflow);
+  if (len == 0 || len != s.len) {
+    return STR_PARSE_INVALID;
+  }
+  const bool fits = str_integer_i64(negative, magnitude, value);
+  return overflow || !fits ? STR_PARSE_OVERFLOW : STR_PARSE_OK;
+}
+
+static StrParseError str_try_f64(Str s, f64 *value) {
+  bool overflow = false;
+  const usize len = str_scan_f64(s, value, &overflow);
+  if (len == 0 || len != s.len) {
+    return STR_PARSE_INVALID;
+  }
+  return overflow ? STR_PARSE_OVERFLOW : STR_PARSE_OK;
+}
+
+// 'field' is the index of the field in a column, or 'STR_NOT_FOUND'.
+static void str_parse_error(Error *error, StrParseError code, Str s, const char *type,
+                            usize field) {
+  char prefix[32] = "";
+  if (field != STR_NOT_FOUND) {
+    snprintf(prefix, sizeof(prefix), "field %" USIZE_FMT ": ", field);
+  }
+  if (code == STR_PARSE_OVERFLOW) {
+    error_emit(error, code, "%s'" STR_FMT "' does not fit into %s", prefix, STR_ARG(s), type);
+  } else {
+    error_emit(error, code, "%s'" STR_FMT "' is not a valid %s", prefix, STR_ARG(s), type);
+  }
+}
+
+u64 str_parse_u64(Str s, Error *error) {
+  u64 value = 0;
+  const StrParseError code = str_try_u64(s, &value);
+  if (code != STR_PARSE_OK) {
+    str_parse_error(error, code, s, "u64", STR_NOT_FOUND);
+    return 0;
+  }
   return value;
 }
 
-usize str_find(Str haystack, Str needle) {
-  if (haystack.len < needle.len) {
-    return STR_NOT_FOUND;
+i64 str_parse_i64(Str s, Error *error) {
+  i64 value = 0;
+  const StrParseError code = str_try_i64(s, &value);
+  if (code != STR_PARSE_OK) {
+    str_parse_error(error, code, s, "i64", STR_NOT_FOUND);
+    return 0;
   }
-  for (usize i = 0; i < haystack.len - needle.len + 1; i++) {
-    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
-      return i;
-    }
+  return value;
+}
+
+f64 str_parse_f64(Str s, Error *error) {
+  f64 value = 0;
+  const StrParseError code = str_try_f64(s, &value);
+  if (code != STR_PARSE_OK) {
+    str_parse_error(error, code, s, "f64", STR_NOT_FOUND);
+    return 0;
   }
-  return STR_NOT_FOUND;
+  return value;
 }
 
-usize str_find_last(Str haystack, Str needle) {
-  if (haystack.len < needle.len) {
-    return STR_NOT_FOUND;
+///////////////////////////////////////////////////////////////////////////////
+
+// 'str_trim' calls a predicate for every character. Fields are rarely padded.
+static inline Str str_trim_field(Str s) {
+  while (s.len && (s.data[0] == ' ' || (u8)(s.data[0] - '\t') < 5)) {
+    s.data++;
+    s.len--;
   }
-  for (usize i = haystack.len - needle.len + 1; i > 0; i--) {
-    if (memcmp(&haystack.data[i - 1], needle.data, needle.len) == 0) {
-      return i - 1;
-    }
+  while (s.len && (s.data[s.len - 1] == ' ' || (u8)(s.data[s.len - 1] - '\t') < 5)) {
+    s.len--;
   }
-  return STR_NOT_FOUND;
+  return s;
+}
+
+usize _str_field_count(Str s, char delim) {
+  usize count = 1;
+  for (const char *p = s.data, *end = s.data + s.len; (p = memchr(p, delim, (usize)(end - p)));
+       p++) {
+    count++;
+  }
+  return count;
+}
+
+// Calls 'parse' for every trimmed field. An empty last field, from a trailing
+// delimiter or newline, is skipped. Stops at the first invalid field.
+#define STR_PARSE_FIELDS(s, delim, out, error, parse, type)                                        \
+  do {                                                                                             \
+    usize count = 0;                                                                               \
+    usize field = 0;                                                                               \
+    for (bool last = false; !last; field++) {                                                      \
+      const char *next = s.len ? memchr(s.data, delim, s.len) : NULL;                              \
+      last = next == NULL;                                                                         \
+      const usize len = last ? s.len : (usize)(next - s.data);                                     \
+      const Str value = str_trim_field(str_from_parts(len, s.data));                               \
+      s = last ? str_from_parts(0, &s.data[s.len]) : str_from_parts(s.len - len - 1, next + 1);    \
+      if (last && value.len == 0) {                                                                \
+        break;                                                                                     \
+      }                                                                                            \
+      const StrParseError code = parse(value, &out[count]);                                        \
+      if (code != STR_PARSE_OK) {                                                                  \
+        str_parse_error(error, code, value, type, field);                                          \
+        break;                                                                                     \
+      }                                                                                            \
+      count++;                                                                                     \
+    }                                                                                              \
+    return count;                                                                                  \
+  } while (0)
+
+usize _str_parse_u64s(Str s, char delim, u64 *out, Error *error) {
+  STR_PARSE_FIELDS(s, delim, out, error, str_try_u64, "u64");
+}
+
+usize _str_parse_i64s(Str s, char delim, i64 *out, Error *error) {
+  STR_PARSE_FIELDS(s, delim, out, error, str_try_i64, "i64");
+}
+
+usize _str_parse_f64s(Str s, char delim, f64 *out, Error *error) {
+  STR_PARSE_FIELDS(s, delim, out, error, str_try_f64, "f64");
+}
+
+#undef STR_PARSE_FIELDS
+
+///////////////////////////////////////////////////////////////////////////////
+
+usize str_find(Str haystack, Str needle) {
+  usize skip[256];
+  return str_search(haystack, needle, str_search_prepare(haystack.len, needle, skip));
+}
+
+usize str_find_last(Str haystack, Str needle) { return str_search_last(haystack, needle); }
+
+usize str_find_ignorecase(Str haystack, Str needle) {
+  return str_search_ignorecase(haystack, needle);
 }
 
 usize str_count(Str haystack, Str needle) {
-  usize count = 0;
-  if (haystack.len < needle.len) {
-    return count;
+  if (needle.len == 0) {
+    return 0;
   }
-  for (usize i = 0; i < haystack.len - needle.len + 1; i++) {
-    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
-      count++;
-      i += needle.len - 1;
+  usize skip[256];
+  const usize *table = str_search_prepare(haystack.len, needle, skip);
+  usize count = 0;
+  for (usize i = 0; i < haystack.len;) {
+    const Str rest = str_from_parts(haystack.len - i, &haystack.data[i]);
+    const usize idx = str_search(rest, needle, table);
+    if (idx == STR_NOT_FOUND) {
+      break;
     }
+    count++;
+    i += idx + needle.len;
   }
   return count;
 }
 
+usize str_count_by_charset(Str s, const CharSet *set) { return charset_count(set, s); }
+
 char str_getc(Str s, usize idx) {
   if (s.len <= idx) {
     return '\0';
@@ -679,13 +1425,13 @@ char str_getc(Str s, usize idx) {
   return s.data[idx];
 }
 
-u64 str_hash(Str s) {
-  const uint64_t magic_prime = 0x00000100000001b3;
-  uint64_t hash = 0xcbf29ce484222325; // NOLINT
-  for (usize i = 0; i < s.len; ++i) {
-    hash = (hash ^ (u64)s.data[i]) * magic_prime;
-  }
-  return hash;
-}
+u64 str_hash(Str s) { return bytes_hash(str_to_bytes(s)); }
+
+u64 str_hash_seed(Str s, u64 seed) { return bytes_hash_seed(str_to_bytes(s), seed); }
 
 ///////////////////////////////////////////////////////////////////////////////
+
+#undef STR_SEARCH_LONG
+#undef STR_FIRST_BIT
+#undef STR_FIRST_BIT64
+#undef STR_LAST_BIT
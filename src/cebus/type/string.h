@@ -6,6 +6,9 @@
   - `str_from_cstr(str)`: Create new string from a char array.
   - `str_from_bytes(str)`: Create new string from bytes.
   - `str_format(fmt, ...)`: Create new string as formated.
+  - `str_from_u64(n, &arena)`, `str_from_i64(n, &arena)`, `str_from_hex(n,
+&arena)`, `str_from_f64(n, &arena)`: Format a number without `printf`, like
+the `sb_append_*` functions of the `StringBuilder`.
   - `printf(STR_FMT"\n", STR_ARG(str))`: Print strings using macros.
 
 - **String Manipulation**:
@@ -21,6 +24,12 @@ Append or prepend strings.
 whitespace.
   - `str_chop_by_delim(str, delim)`, `str_try_chop_by_delim(str, delim,
 &chunk)`: Chop strings by delimiter.
+  - `str_trim_by_charset(str, &set)`, `str_chop_by_charset(&str, &set)`,
+`str_try_chop_by_charset(&str, &set, &chunk)`, etc.: Same as the `_by_predicate`
+versions, with a `CharSet` that is built once instead of calling a predicate
+for every character.
+  - `str_split(str, &set, list)`: Appends every run of characters that are not
+in the set to a `DA(Str)`, in a single pass. Empty fields are skipped.
   - `str_substring(str, start, end)`: Extract a substring.
 
 - **String Comparison and Search**:
@@ -28,11 +37,37 @@ whitespace.
   - `str_startswith(str, prefix)`, `str_endswith(str, suffix)`: Check
 prefixes/suffixes.
   - `str_contains(haystack, needle)`: Check if string contains a substring.
+  - `str_find(haystack, needle)`, `str_find_last(haystack, needle)`: Find the
+first or last position of a substring.
+  - `str_find_ignorecase(haystack, needle)`: Find the first position of a
+substring, ignoring the case of ASCII letters.
+  - `str_count(haystack, needle)`: Count the non overlapping occurrences of a
+substring.
+  - `str_count_by_charset(str, &set)`: Count the characters that are in a
+`CharSet`.
+
+The search compares the first and last byte of the needle at 16 or 32
+positions at once with SSE2 or AVX2, if the CPU supports it.
 
 - **Conversion and Utility**:
-  - `str_to_u64(str)`, `str_u64(n, &arena)`: Convert between strings and
-unsigned 64-bit integers.
-  - `str_hash(str)`: Generate a hash value for a string.
+  - `str_u64(str)`, `str_i64(str)`, `str_f64(str)`: Parse a number at the
+start of the string, like `strtoull`, `strtoll` and `strtod`. They return `0`
+if there is no number.
+  - `str_chop_u64(&str)`, `str_chop_i64(&str)`, `str_chop_f64(&str)`: Same, and
+remove the number from the string.
+  - `str_parse_u64(str, error)`, `str_parse_i64(str, error)`,
+`str_parse_f64(str, error)`: The whole string has to be the number. Emits
+`STR_PARSE_INVALID` or `STR_PARSE_OVERFLOW` and returns `0` otherwise.
+  - `str_parse_u64_da(str, delim, list, error)`, `str_parse_i64_da(...)`,
+`str_parse_f64_da(...)`: Parse every field between the delimiters, for
+example a column, and append them to a `DA`. Whitespace around the fields and
+an empty last field are ignored. Stops at the first invalid field.
+  - `str_hash(str)`, `str_hash_seed(str, seed)`: Generate a hash value for a
+string. Same as `bytes_hash` of the string.
+
+The parsers do not allocate. Integers are converted 8 digits at a time. Floats
+with up to 19 significant digits and a small exponent are converted with a
+single exact multiplication or division, everything else goes to `strtod`.
 
 ## Usage Example
 
@@ -49,6 +84,8 @@ printf(STR_FMT"\n", STR_ARG(lower));
 
 #include "cebus/core/arena.h"
 #include "cebus/core/defines.h" // IWYU pragma: private: include "str.h"
+#include "cebus/core/error.h"
+#include "cebus/type/charset.h" // IWYU pragma: export
 
 ///////////////////////////////////////////////////////////////////////////////
 
@@ -70,6 +107,11 @@ Bytes str_to_bytes(Str s);
 Str str_from_cstr(const char *cstr);
 FMT(2) Str str_format(Arena *arena, const char *fmt, ...);
 
+Str str_from_u64(u64 value, Arena *arena);
+Str str_from_i64(i64 value, Arena *arena);
+Str str_from_hex(u64 value, Arena *arena);
+Str str_from_f64(f64 value, Arena *arena);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 Str str_copy(Str s, Arena *arena);
@@ -89,6 +131,7 @@ Str str_join_wrap(Str sep, Str wrap, usize count, Str *s, Arena *arena);
 Str str_upper(Str s, Arena *arena);
 Str str_lower(Str s, Arena *arena);
 Str str_replace(Str s, Str old, Str new, Arena *arena);
+Str str_replace_many(Str s, usize count, const Str *olds, const Str *news, Arena *arena);
 Str str_center(Str s, usize width, char fillchar, Arena *arena);
 Str str_ljust(Str s, usize width, char fillchar, Arena *arena);
 Str str_rjust(Str s, usize width, char fillchar, Arena *arena);
@@ -116,21 +159,27 @@ CompareFn str_compare_qsort(CmpOrdering ordering);
 Str str_trim_left(Str s);
 Str str_trim_left_by_delim(Str s, char delim);
 Str str_trim_left_by_predicate(Str s, bool (*predicate)(char));
+Str str_trim_left_by_charset(Str s, const CharSet *set);
 
 Str str_trim_right(Str s);
 Str str_trim_right_by_delim(Str s, char delim);
 Str str_trim_right_by_predicate(Str s, bool (*predicate)(char));
+Str str_trim_right_by_charset(Str s, const CharSet *set);
 
 Str str_trim(Str s);
 Str str_trim_by_delim(Str s, char delim);
 Str str_trim_by_predicate(Str s, bool (*predicate)(char));
+Str str_trim_by_charset(Str s, const CharSet *set);
 
 bool str_try_chop_by_delim(Str *s, char delim, Str *chunk);
 Str str_chop_by_delim(Str *s, char delim);
 bool str_try_chop_by_predicate(Str *s, bool (*predicate)(char), Str *chunk);
 Str str_chop_by_predicate(Str *s, bool (*predicate)(char));
+bool str_try_chop_by_charset(Str *s, const CharSet *set, Str *chunk);
+Str str_chop_by_charset(Str *s, const CharSet *set);
 Str str_chop_right_by_delim(Str *s, char delim);
 Str str_chop_right_by_predicate(Str *s, bool (*predicate)(char));
+Str str_chop_right_by_charset(Str *s, const CharSet *set);
 Str str_take(Str *s, usize count);
 bool str_try_take(Str *s, usize count, Str *chunk);
 Str str_take_right(Str *s, usize count);
@@ -138,6 +187,22 @@ bool str_try_take_right(Str *s, usize count, Str *chunk);
 
 Str str_substring(Str s, usize start, usize end);
 
+#define str_split(s, set, list)                                                                    \
+  do {                                                                                             \
+    Str __ss = (s);                                                                                \
+    for (Str __field; _str_split_next(&__ss, set, &__field);) {                                    \
+      da_push(list, __field);                                                                      \
+    }                                                                                              \
+  } while (0)
+
+bool _str_split_next(Str *s, const CharSet *set, Str *field);
+
+// Calls 'write' with every span of 's' between the matches of 'old' and with
+// 'new' for every match, in order. Stops early if 'write' returns 'false'.
+// Used by 'sb_append_replace' and 'io_write_replace'.
+void _str_replace_each(Str s, Str old, Str new, bool ignorecase,
+                       bool (*write)(void *ctx, Str part), void *ctx);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 u64 str_u64(Str s);
@@ -149,18 +214,51 @@ i64 str_chop_i64(Str *s);
 f64 str_f64(Str s);
 f64 str_chop_f64(Str *s);
 
+typedef enum {
+  STR_PARSE_OK,
+  STR_PARSE_INVALID,
+  STR_PARSE_OVERFLOW,
+} StrParseError;
+
+u64 str_parse_u64(Str s, Error *error);
+i64 str_parse_i64(Str s, Error *error);
+f64 str_parse_f64(Str s, Error *error);
+
+#define str_parse_u64_da(s, delim, list, error)                                                    \
+  _STR_PARSE_DA(s, delim, list, error, _str_parse_u64s)
+#define str_parse_i64_da(s, delim, list, error)                                                    \
+  _STR_PARSE_DA(s, delim, list, error, _str_parse_i64s)
+#define str_parse_f64_da(s, delim, list, error)                                                    \
+  _STR_PARSE_DA(s, delim, list, error, _str_parse_f64s)
+
+#define _STR_PARSE_DA(s, delim, list, error, parse)                                                \
+  do {                                                                                             \
+    const Str __ps = (s);                                                                          \
+    da_reserve((list), _str_field_count(__ps, delim));                                             \
+    da_len(list) += parse(__ps, delim, &(list)->items[da_len(list)], error);                       \
+  } while (0)
+
+usize _str_field_count(Str s, char delim);
+usize _str_parse_u64s(Str s, char delim, u64 *out, Error *error);
+usize _str_parse_i64s(Str s, char delim, i64 *out, Error *error);
+usize _str_parse_f64s(Str s, char delim, f64 *out, Error *error);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // Returns 'STR_NOT_FOUND' if 'needle' was not found.
 usize str_find(Str haystack, Str needle);
 // Returns 'STR_NOT_FOUND' if 'needle' was not found.
 usize str_find_last(Str haystack, Str needle);
+// Returns 'STR_NOT_FOUND' if 'needle' was not found.
+usize str_find_ignorecase(Str haystack, Str needle);
 usize str_count(Str haystack, Str needle);
+usize str_count_by_charset(Str s, const CharSet *set);
 // Returns '\0' if the index is out of bounds.
 char str_getc(Str s, usize idx);
 
-// Basic FNV hash.
+// XXH64, the same as 'bytes_hash' of the string.
 u64 str_hash(Str s);
+u64 str_hash_seed(Str s, u64 seed);
 
 ///////////////////////////////////////////////////////////////////////////////
 
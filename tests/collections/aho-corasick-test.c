@@ -0,0 +1,274 @@
+#include "cebus/collection/aho_corasick.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/integer.h"
+#include "cebus/type/string.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+static u64 next_random(u64 *seed) {
+  *seed = *seed * 6364136223846793005 + 1442695040888963407;
+  return *seed >> 33;
+}
+
+// Every match, ordered like 'ac_next': by end, then the longest first, then
+// by pattern.
+static usize naive_matches(usize count, const Str *patterns, Str text, AcMatch *out) {
+  usize n = 0;
+  for (usize end = 1; end <= text.len; end++) {
+    for (usize len = end; 0 < len; len--) {
+      for (usize p = 0; p < count; p++) {
+        if (patterns[p].len == len &&
+            memcmp(&text.data[end - len], patterns[p].data, len) == 0) {
+          out[n++] = (AcMatch){.pattern = p, .start = end - len, .end = end};
+        }
+      }
+    }
+  }
+  return n;
+}
+
+static int compare_matches(const void *a, const void *b) {
+  const AcMatch *m1 = a;
+  const AcMatch *m2 = b;
+  if (m1->end != m2->end) {
+    return m1->end < m2->end ? -1 : 1;
+  }
+  if (m1->start != m2->start) {
+    return m1->start < m2->start ? -1 : 1;
+  }
+  return m1->pattern < m2->pattern ? -1 : m1->pattern > m2->pattern;
+}
+
+// Same as 'naive_matches', but fast enough for a lot of patterns.
+static usize naive_matches_sorted(usize count, const Str *patterns, Str text, AcMatch *out) {
+  usize n = 0;
+  for (usize p = 0; p < count; p++) {
+    for (usize i = 0; i + patterns[p].len <= text.len; i++) {
+      if (text.data[i] == patterns[p].data[0] &&
+          memcmp(&text.data[i], patterns[p].data, patterns[p].len) == 0) {
+        out[n++] = (AcMatch){.pattern = p, .start = i, .end = i + patterns[p].len};
+      }
+    }
+  }
+  qsort(out, n, sizeof(AcMatch), compare_matches);
+  return n;
+}
+
+static void random_patterns(u64 *seed, usize count, Str *patterns, char *buffer, usize min_len,
+                            usize max_len, usize alphabet) {
+  for (usize p = 0; p < count; p++) {
+    const usize len = next_random(seed) % (max_len - min_len + 1) + min_len;
+    for (usize i = 0; i < len; i++) {
+      buffer[i] = (char)('a' + next_random(seed) % alphabet);
+    }
+    patterns[p] = str_from_parts(len, buffer);
+    buffer += len;
+  }
+}
+
+static void test_basic(void) {
+  Arena arena = {0};
+  const Str patterns[] = {STR("he"), STR("she"), STR("his"), STR("hers"), STR(""), STR("he")};
+  AhoCorasick *ac = ac_create(&arena, ARRAY_LEN(patterns), patterns);
+  cebus_assert(ac_len(ac) == ARRAY_LEN(patterns), "");
+  cebus_assert(ac_is_dense(ac), "");
+
+  AcStream stream = ac_stream(ac);
+  ac_feed_str(&stream, STR("ushers"));
+  AcMatch match = {0};
+  const AcMatch expected[] = {
+      {.pattern = 1, .start = 1, .end = 4},
+      {.pattern = 0, .start = 2, .end = 4},
+      {.pattern = 5, .start = 2, .end = 4},
+      {.pattern = 3, .start = 2, .end = 6},
+  };
+  for (usize i = 0; i < ARRAY_LEN(expected); i++) {
+    cebus_assert(ac_next(&stream, &match), "%" USIZE_FMT, i);
+    cebus_assert(match.pattern == expected[i].pattern && match.start == expected[i].start &&
+                     match.end == expected[i].end,
+                 "%" USIZE_FMT ": %" USIZE_FMT, i, match.pattern);
+  }
+  cebus_assert(!ac_next(&stream, &match), "");
+
+  cebus_assert(ac_find(ac, STR("this"), &match), "");
+  cebus_assert(match.pattern == 2 && match.start == 1, "");
+  cebus_assert(!ac_find(ac, STR("nothing"), &match), "");
+  cebus_assert(!ac_find(ac, STR(""), &match), "");
+
+  AhoCorasick *empty = ac_create(&arena, 0, NULL);
+  cebus_assert(!ac_find(empty, STR("text"), &match), "");
+
+  arena_free(&arena);
+}
+
+static void test_random(void) {
+  Arena arena = {0};
+  u64 seed = 42;
+  char buffer[4096];
+  Str patterns[300];
+  static AcMatch expected[8192];
+  for (usize round = 0; round < 200; round++) {
+    const usize count = next_random(&seed) % 40 + 1;
+    const usize alphabet = next_random(&seed) % 4 + 2;
+    random_patterns(&seed, count, patterns, buffer, 1, 6, alphabet);
+    AhoCorasick *ac = ac_create(&arena, count, patterns);
+
+    char text_buffer[200];
+    for (usize i = 0; i < sizeof(text_buffer); i++) {
+      text_buffer[i] = (char)('a' + next_random(&seed) % alphabet);
+    }
+    const Str text = str_from_parts(sizeof(text_buffer), text_buffer);
+    const usize n = naive_matches(count, patterns, text, expected);
+
+    // fed in random chunks
+    AcStream stream = ac_stream(ac);
+    usize found = 0;
+    for (usize pos = 0; pos < text.len;) {
+      const usize len = usize_min(next_random(&seed) % 8, text.len - pos);
+      ac_feed_str(&stream, str_from_parts(len, &text.data[pos]));
+      pos += len;
+      for (AcMatch match; ac_next(&stream, &match); found++) {
+        cebus_assert(found < n, "too many matches");
+        cebus_assert(match.start == expected[found].start && match.end == expected[found].end,
+                     "%" USIZE_FMT, found);
+        cebus_assert(str_eq(patterns[match.pattern], patterns[expected[found].pattern]), "");
+      }
+    }
+    cebus_assert(found == n, "%" USIZE_FMT " != %" USIZE_FMT, found, n);
+  }
+  arena_free(&arena);
+}
+
+static void test_compact(void) {
+  Arena arena = {0};
+  u64 seed = 1337;
+  static char buffer[5000 * 24];
+  static Str patterns[5000];
+  random_patterns(&seed, ARRAY_LEN(patterns), patterns, buffer, 4, 24, 26);
+  AhoCorasick *ac = ac_create(&arena, ARRAY_LEN(patterns), patterns);
+  cebus_assert(!ac_is_dense(ac), "");
+
+  // the text contains some of the patterns
+  static char text_buffer[20000];
+  usize len = 0;
+  while (len + 30 < sizeof(text_buffer)) {
+    if (next_random(&seed) % 4 == 0) {
+      const Str p = patterns[next_random(&seed) % ARRAY_LEN(patterns)];
+      memcpy(&text_buffer[len], p.data, p.len);
+      len += p.len;
+    } else {
+      text_buffer[len++] = (char)('a' + next_random(&seed) % 26);
+    }
+  }
+  const Str text = str_from_parts(len, text_buffer);
+
+  static AcMatch expected[20000];
+  const usize n = naive_matches_sorted(ARRAY_LEN(patterns), patterns, text, expected);
+  cebus_assert(500 < n, "%" USIZE_FMT, n);
+  AcStream stream = ac_stream(ac);
+  ac_feed_str(&stream, text);
+  usize found = 0;
+  for (AcMatch match; ac_next(&stream, &match); found++) {
+    cebus_assert(match.start == expected[found].start && match.end == expected[found].end, "");
+    cebus_assert(str_eq(patterns[match.pattern], patterns[expected[found].pattern]), "");
+  }
+  cebus_assert(found == n, "%" USIZE_FMT " != %" USIZE_FMT, found, n);
+  arena_free(&arena);
+}
+
+typedef struct {
+  usize count;
+  usize last_end;
+} EachCtx;
+
+static void count_match(void *ctx, AcMatch match) {
+  EachCtx *c = ctx;
+  cebus_assert(c->last_end <= match.end, "not ordered");
+  c->last_end = match.end;
+  c->count++;
+}
+
+static void test_each(void) {
+  Arena arena = {0};
+  const Bytes patterns[] = {BYTES_STR("\x00\xff"), BYTES_STR("\xff\xff")};
+  AhoCorasick *ac = ac_create_bytes(&arena, ARRAY_LEN(patterns), patterns);
+  EachCtx ctx = {0};
+  AcStream stream = ac_stream(ac);
+  ac_each(&stream, BYTES_STR("\x00\xff\xff"), count_match, &ctx);
+  ac_each(&stream, BYTES_STR("\xff\x00"), count_match, &ctx);
+  ac_each(&stream, BYTES_STR("\xff"), count_match, &ctx);
+  cebus_assert(ctx.count == 4, "%" USIZE_FMT, ctx.count);
+  cebus_assert(ctx.last_end == 6, "%" USIZE_FMT, ctx.last_end);
+  arena_free(&arena);
+}
+
+// Leftmost, then longest.
+static Str naive_replace_many(Str s, usize count, const Str *olds, const Str *news,
+                              Arena *arena) {
+  StringBuilder sb = sb_init(arena);
+  for (usize i = 0; i < s.len;) {
+    usize best = count;
+    for (usize p = 0; p < count; p++) {
+      if (olds[p].len && olds[p].len <= s.len - i &&
+          memcmp(&s.data[i], olds[p].data, olds[p].len) == 0 &&
+          (best == count || olds[best].len < olds[p].len)) {
+        best = p;
+      }
+    }
+    if (best == count) {
+      sb_append_c(&sb, s.data[i++]);
+    } else {
+      sb_append_str(&sb, news[best]);
+      i += olds[best].len;
+    }
+  }
+  return sb_to_str(&sb);
+}
+
+static void test_replace_many(void) {
+  Arena arena = {0};
+  const Str olds[] = {STR("cat"), STR("category"), STR("dog"), STR("go")};
+  const Str news[] = {STR("CAT"), STR("KIND"), STR("DOG"), STR("")};
+  const Str result = str_replace_many(STR("a category of cats, dogs and gophers"),
+                                      ARRAY_LEN(olds), olds, news, &arena);
+  cebus_assert(str_eq(result, STR("a KIND of CATs, DOGs and phers")), STR_FMT,
+               STR_ARG(result));
+  cebus_assert(result.data[result.len] == '\0', "");
+
+  const Str none = str_replace_many(STR("nothing here"), ARRAY_LEN(olds), olds, news, &arena);
+  cebus_assert(str_eq(none, STR("nothing here")), "");
+  const Str empty = str_replace_many(STR(""), ARRAY_LEN(olds), olds, news, &arena);
+  cebus_assert(str_eq(empty, STR("")), "");
+
+  u64 seed = 7;
+  char buffer[4096];
+  Str patterns[40];
+  Str replacements[40];
+  for (usize i = 0; i < ARRAY_LEN(replacements); i++) {
+    replacements[i] = str_format(&arena, "<%" USIZE_FMT ">", i);
+  }
+  for (usize round = 0; round < 300; round++) {
+    const usize count = next_random(&seed) % ARRAY_LEN(patterns) + 1;
+    const usize alphabet = next_random(&seed) % 3 + 2;
+    random_patterns(&seed, count, patterns, buffer, 1, 8, alphabet);
+    char text_buffer[300];
+    for (usize i = 0; i < sizeof(text_buffer); i++) {
+      text_buffer[i] = (char)('a' + next_random(&seed) % alphabet);
+    }
+    const Str text = str_from_parts(sizeof(text_buffer), text_buffer);
+    const Str a = str_replace_many(text, count, patterns, replacements, &arena);
+    const Str b = naive_replace_many(text, count, patterns, replacements, &arena);
+    cebus_assert(str_eq(a, b), STR_FMT "\n" STR_FMT, STR_ARG(a), STR_ARG(b));
+  }
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_basic();
+  test_random();
+  test_compact();
+  test_each();
+  test_replace_many();
+}
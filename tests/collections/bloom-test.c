@@ -0,0 +1,104 @@
+#include "cebus/collection/bloom.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/integer.h"
+
+#define TEST_BLOOM_COUNT 10000
+
+static usize count_false_positives(const BloomFilter *bf) {
+  usize fp = 0;
+  for (usize i = TEST_BLOOM_COUNT; i < TEST_BLOOM_COUNT * 11; i++) {
+    fp += bloom_contains(bf, i);
+  }
+  return fp;
+}
+
+static void test_bloom(bool blocked) {
+  Arena arena = {0};
+  BloomFilter bf = blocked ? bloom_create_blocked(&arena, TEST_BLOOM_COUNT, 0.01)
+                           : bloom_create(&arena, TEST_BLOOM_COUNT, 0.01);
+  cebus_assert(bf.blocked == blocked, "Wrong kind of bloom filter");
+  cebus_assert(bf.k != 0, "Filter should have hashes");
+
+  for (usize i = 0; i < TEST_BLOOM_COUNT; i++) {
+    bloom_add(&bf, i);
+  }
+  cebus_assert(bloom_add(&bf, 1) == false, "1 should already be in the filter");
+  cebus_assert(bf.count <= TEST_BLOOM_COUNT, "count: %" USIZE_FMT, bf.count);
+
+  for (usize i = 0; i < TEST_BLOOM_COUNT; i++) {
+    cebus_assert(bloom_contains(&bf, i), "No false negatives: %" USIZE_FMT, i);
+  }
+
+  // 100000 lookups with a rate of 1%
+  const usize fp = count_false_positives(&bf);
+  cebus_assert(fp < 1500, "Too many false positives: %" USIZE_FMT, fp);
+  const f64 estimate = bloom_fp_rate(&bf);
+  cebus_assert(0.005 < estimate && estimate < 0.015, "estimate: %f", estimate);
+
+  bloom_clear(&bf);
+  cebus_assert(bf.count == 0, "Filter should be empty");
+  cebus_assert(bloom_contains(&bf, 1) == false, "Filter should be empty");
+
+  arena_free(&arena);
+}
+
+static void test_bloom_batch(void) {
+  Arena arena = {0};
+  BloomFilter bf = bloom_create_blocked(&arena, TEST_BLOOM_COUNT, 0.001);
+
+  u64 hashes[100];
+  bool result[100];
+  for (usize i = 0; i < 100; i++) {
+    hashes[i] = i;
+    if (i % 2 == 0) {
+      bloom_add(&bf, i);
+    }
+  }
+
+  const usize found = bloom_contains_batch(&bf, 100, hashes, result);
+  cebus_assert(50 <= found && found < 53, "found: %" USIZE_FMT, found);
+  for (usize i = 0; i < 100; i++) {
+    cebus_assert(result[i] == bloom_contains(&bf, i), "Batch result differs: %" USIZE_FMT, i);
+  }
+  cebus_assert(bloom_contains_batch(&bf, 100, hashes, NULL) == found, "Result is optional");
+
+  arena_free(&arena);
+}
+
+static void test_bloom_union(void) {
+  Arena arena = {0};
+  BloomFilter bf1 = bloom_create(&arena, TEST_BLOOM_COUNT, 0.01);
+  BloomFilter bf2 = bloom_with_size(&arena, bf1.bits, bf1.k, false);
+
+  for (usize i = 0; i < TEST_BLOOM_COUNT / 2; i++) {
+    bloom_add(&bf1, i);
+    bloom_add(&bf2, i + TEST_BLOOM_COUNT / 2);
+  }
+
+  BloomFilter copy = bloom_copy(&arena, &bf1);
+  bloom_union(&copy, &bf2);
+  for (usize i = 0; i < TEST_BLOOM_COUNT; i++) {
+    cebus_assert(bloom_contains(&copy, i), "Union should contain: %" USIZE_FMT, i);
+  }
+  const usize total = bf1.count + bf2.count;
+  cebus_assert(total * 98 / 100 <= copy.count && copy.count <= total, "count: %" USIZE_FMT,
+               copy.count);
+
+  const usize fp = count_false_positives(&copy);
+  cebus_assert(fp < 1500, "Too many false positives: %" USIZE_FMT, fp);
+
+  const usize count = copy.count;
+  bloom_union(&copy, &bf1);
+  cebus_assert(count * 98 / 100 <= copy.count && copy.count <= count * 102 / 100,
+               "Shared members should only be counted once: %" USIZE_FMT, copy.count);
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_bloom(false);
+  test_bloom(true);
+  test_bloom_batch();
+  test_bloom_union();
+}
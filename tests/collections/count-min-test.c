@@ -0,0 +1,56 @@
+#include "cebus/collection/count_min.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/integer.h"
+
+static void test_cms_estimate(void) {
+  Arena arena = {0};
+  CountMin cms = cms_create(&arena, 0.001, 0.01);
+  cebus_assert(cms.width == 4096, "width: %" USIZE_FMT, cms.width);
+  cebus_assert(cms.depth == 5, "depth: %" USIZE_FMT, cms.depth);
+
+  // hash i occurs i % 100 times
+  for (usize i = 0; i < 10000; i++) {
+    cms_add(&cms, i, i % 100);
+  }
+  cebus_assert(cms.total == 495000, "total: %" U64_FMT, cms.total);
+
+  usize exact = 0;
+  for (usize i = 0; i < 10000; i++) {
+    const u64 estimate = cms_estimate(&cms, i);
+    cebus_assert(i % 100 <= estimate, "Never underestimates: %" USIZE_FMT, i);
+    cebus_assert(estimate <= i % 100 + 495, "Error too big: %" U64_FMT, estimate);
+    exact += estimate == i % 100;
+  }
+  // conservative update keeps most of the estimates exact
+  cebus_assert(5000 < exact, "exact: %" USIZE_FMT, exact);
+
+  cms_clear(&cms);
+  cebus_assert(cms_estimate(&cms, 1) == 0, "Sketch should be empty");
+
+  arena_free(&arena);
+}
+
+static void test_cms_merge(void) {
+  Arena arena = {0};
+  CountMin cms1 = cms_with_size(&arena, 1000, 4);
+  cebus_assert(cms1.width == 1024, "Width should be a power of two");
+  CountMin cms2 = cms_with_size(&arena, 1024, 4);
+
+  cms_add(&cms1, 42, 10);
+  cebus_assert(cms_add(&cms2, 42, 5) == 5, "Should return the estimate");
+  cms_add(&cms2, 7, 3);
+
+  CountMin merged = cms_copy(&arena, &cms1);
+  cms_merge(&merged, &cms2);
+  cebus_assert(cms_estimate(&merged, 42) == 15, "merged: %" U64_FMT, cms_estimate(&merged, 42));
+  cebus_assert(cms_estimate(&merged, 7) == 3, "merged: %" U64_FMT, cms_estimate(&merged, 7));
+  cebus_assert(merged.total == 18, "total: %" U64_FMT, merged.total);
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_cms_estimate();
+  test_cms_merge();
+}
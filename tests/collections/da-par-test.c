@@ -0,0 +1,141 @@
+#include "cebus/collection/da_par.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/integer.h"
+
+typedef struct {
+  u64 key;
+  usize idx;
+} Record;
+
+typedef DA(Record) Records;
+
+static void square(const void *item, void *out) {
+  const u64 value = *(const u64 *)item;
+  *(u64 *)out = value * value;
+}
+
+static bool is_odd(const void *item) { return *(const u64 *)item % 2; }
+
+static void add_offset(void *ctx, const void *item, void *out) {
+  *(u64 *)out = *(const u64 *)item + *(const u64 *)ctx;
+}
+
+static bool is_below(void *ctx, const void *item) {
+  return *(const u64 *)item < *(const u64 *)ctx;
+}
+
+static CmpOrdering record_compare(const void *a, const void *b) {
+  const Record *x = a;
+  const Record *y = b;
+  return x->key < y->key ? CMP_LESS : x->key > y->key ? CMP_GREATER : CMP_EQUAL;
+}
+
+static void test_map(void) {
+  Arena arena = {0};
+  ThreadPool *pool = thread_pool_create(&arena, 4);
+  DA(u64) values = da_new(&arena);
+  for (u64 i = 0; i < 100000; i++) {
+    da_push(&values, i);
+  }
+  DA(u64) squares = da_new(&arena);
+  da_par_map(pool, &values, &squares, square);
+  cebus_assert(da_len(&squares) == da_len(&values), "not every item was mapped");
+  for (usize i = 0; i < da_len(&squares); i++) {
+    cebus_assert(da_get(&squares, i) == i * i, "item was not mapped correctly");
+  }
+
+  DA(u64) empty = da_new(&arena);
+  da_par_map(pool, &empty, &squares, square);
+  cebus_assert(da_len(&squares) == 0, "empty array should map to empty array");
+
+  u64 offset = 7;
+  DA(u64) shifted = da_new(&arena);
+  da_par_map_ctx(pool, &values, &shifted, add_offset, &offset);
+  cebus_assert(da_len(&shifted) == da_len(&values), "not every item was mapped");
+  for (usize i = 0; i < da_len(&shifted); i++) {
+    cebus_assert(da_get(&shifted, i) == i + 7, "item was not mapped with the context");
+  }
+
+  thread_pool_destroy(pool);
+  arena_free(&arena);
+}
+
+static void test_filter(void) {
+  Arena arena = {0};
+  ThreadPool *pool = thread_pool_create(&arena, 3);
+  DA(u64) values = da_new(&arena);
+  u64 seed = 42;
+  usize odd = 0;
+  for (usize i = 0; i < 100003; i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    da_push(&values, seed >> 33);
+    odd += (seed >> 33) % 2;
+  }
+  DA(u64) filtered = da_new(&arena);
+  da_par_filter(pool, &values, &filtered, is_odd);
+  cebus_assert(da_len(&filtered) == odd, "wrong number of items kept");
+  usize j = 0;
+  for (usize i = 0; i < da_len(&values); i++) {
+    if (da_get(&values, i) % 2) {
+      cebus_assert(da_get(&filtered, j++) == da_get(&values, i), "order was not kept");
+    }
+  }
+
+  u64 threshold = (u64)1 << 30;
+  usize below = 0;
+  for (usize i = 0; i < da_len(&values); i++) {
+    below += da_get(&values, i) < threshold;
+  }
+  da_par_filter_ctx(pool, &values, &filtered, is_below, &threshold);
+  cebus_assert(da_len(&filtered) == below, "wrong number of items kept");
+  for (usize i = 0; i < da_len(&filtered); i++) {
+    cebus_assert(da_get(&filtered, i) < threshold, "item should not be kept");
+  }
+
+  thread_pool_destroy(pool);
+  arena_free(&arena);
+}
+
+static void test_sort(void) {
+  Arena arena = {0};
+  Records records[3];
+  for (usize threads = 1; threads <= 3; threads++) {
+    ThreadPool *pool = thread_pool_create(&arena, threads);
+    Records *list = &records[threads - 1];
+    *list = (Records)da_new(&arena);
+    u64 seed = 42;
+    for (usize i = 0; i < 300001; i++) {
+      seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+      da_push(list, ((Record){.key = (seed >> 33) % 1000, .idx = i}));
+    }
+    da_par_sort(pool, list, record_compare);
+    for (usize i = 1; i < da_len(list); i++) {
+      cebus_assert(da_get(list, i - 1).key <= da_get(list, i).key, "array is not sorted");
+    }
+    thread_pool_destroy(pool);
+  }
+  // the same result for every number of threads
+  for (usize i = 0; i < da_len(&records[0]); i++) {
+    cebus_assert(da_get(&records[0], i).idx == da_get(&records[1], i).idx &&
+                     da_get(&records[0], i).idx == da_get(&records[2], i).idx,
+                 "result depends on the number of threads");
+  }
+
+  ThreadPool *pool = thread_pool_create(&arena, 2);
+  DA(u64) small = da_new(&arena);
+  da_push(&small, 3);
+  da_push(&small, 1);
+  da_push(&small, 2);
+  da_par_sort(pool, &small, u64_compare_qsort(CMP_LESS));
+  cebus_assert(da_get(&small, 0) == 1 && da_get(&small, 2) == 3, "small array is not sorted");
+  thread_pool_destroy(pool);
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_map();
+  test_filter();
+  test_sort();
+}
@@ -261,6 +261,140 @@ static void test_remove(void) {
   arena_free(&arena);
 }
 
+static void test_insert_front(void) {
+  Arena arena = {0};
+  DA(usize) list = da_new(&arena);
+  for (usize i = 0; i < 10; i++) {
+    da_insert(&list, i, 0);
+  }
+  for (usize i = 0; i < 10; i++) {
+    cebus_assert(da_get(&list, i) == 9 - i, "%" USIZE_FMT, da_get(&list, i));
+  }
+  arena_free(&arena);
+}
+
+static void test_insert_n(void) {
+  Arena arena = {0};
+  DA(usize) list = da_new(&arena);
+  da_push(&list, 1);
+  da_push(&list, 5);
+
+  da_insert_n(&list, 3, ((usize[]){2, 3, 4}), 1);
+  da_insert_n(&list, 2, ((usize[]){6, 7}), 5);
+  da_insert_n(&list, 0, ((usize[]){0}), 0);
+
+  cebus_assert(list.len == 7, "len: %" USIZE_FMT, list.len);
+  for (usize i = 0; i < list.len; i++) {
+    cebus_assert(da_get(&list, i) == i + 1, "%" USIZE_FMT, da_get(&list, i));
+  }
+  arena_free(&arena);
+}
+
+static void test_remove_range(void) {
+  Arena arena = {0};
+  DA(usize) list = da_new(&arena);
+  for (usize i = 0; i < 10; i++) {
+    da_push(&list, i);
+  }
+  da_remove_range(&list, 2, 3);
+  da_remove_range(&list, 5, 2);
+  da_remove_range(&list, 0, 0);
+
+  const usize expected[] = {0, 1, 5, 6, 7};
+  cebus_assert(list.len == ARRAY_LEN(expected), "len: %" USIZE_FMT, list.len);
+  for (usize i = 0; i < list.len; i++) {
+    cebus_assert(da_get(&list, i) == expected[i], "%" USIZE_FMT, da_get(&list, i));
+  }
+  arena_free(&arena);
+}
+
+static void test_swap_remove(void) {
+  Arena arena = {0};
+  DA(usize) list = da_new(&arena);
+  for (usize i = 0; i < 5; i++) {
+    da_push(&list, i);
+  }
+  da_swap_remove(&list, 1);
+  da_swap_remove(&list, 3);
+
+  cebus_assert(list.len == 3, "len: %" USIZE_FMT, list.len);
+  cebus_assert(da_get(&list, 0) == 0, "%" USIZE_FMT, da_get(&list, 0));
+  cebus_assert(da_get(&list, 1) == 4, "%" USIZE_FMT, da_get(&list, 1));
+  cebus_assert(da_get(&list, 2) == 2, "%" USIZE_FMT, da_get(&list, 2));
+  arena_free(&arena);
+}
+
+static bool keep_runs(usize i) { return i % 10 < 3 || i % 10 == 7; }
+
+static bool greater_than(Ctx *ctx, usize i) { return ctx->a < i; }
+
+static void test_retain(void) {
+  Arena arena = {0};
+  DA(usize) list = da_new(&arena);
+  for (usize i = 0; i < 100; i++) {
+    da_push(&list, i);
+  }
+  da_retain(&list, keep_runs);
+  cebus_assert(list.len == 40, "len: %" USIZE_FMT, list.len);
+  for (usize i = 0; i < list.len; i++) {
+    const usize expected = i / 4 * 10 + (i % 4 == 3 ? 7 : i % 4);
+    cebus_assert(da_get(&list, i) == expected, "%" USIZE_FMT, da_get(&list, i));
+  }
+
+  Ctx ctx = {.a = 50};
+  da_retain_ctx(&list, greater_than, &ctx);
+  cebus_assert(list.len == 19, "len: %" USIZE_FMT, list.len);
+  cebus_assert(da_first(&list) == 51 && da_last(&list) == 97, "wrong elements");
+
+  da_retain(&list, is_odd);
+  da_retain(&list, keep_runs);
+  cebus_assert(list.len == 9, "len: %" USIZE_FMT, list.len);
+
+  ctx.a = 1000;
+  da_retain_ctx(&list, greater_than, &ctx);
+  cebus_assert(list.len == 0, "len: %" USIZE_FMT, list.len);
+  arena_free(&arena);
+}
+
+static void test_sda(void) {
+  Arena arena = {0};
+  SDA(usize, 8) list = sda_new(&list, &arena);
+  cebus_assert(sda_is_inline(&list), "Should start inline");
+  for (usize i = 0; i < 8; i++) {
+    da_push(&list, i);
+  }
+  cebus_assert(sda_is_inline(&list), "8 items should still be inline");
+  cebus_assert(arena_size(&arena) == 0, "Nothing should be allocated");
+
+  da_insert(&list, 100, 0);
+  cebus_assert(!sda_is_inline(&list), "Should have moved into the arena");
+  cebus_assert(da_len(&list) == 9, "len: %" USIZE_FMT, da_len(&list));
+  cebus_assert(da_get(&list, 0) == 100, "Insert did not work");
+  for (usize i = 1; i < da_len(&list); i++) {
+    cebus_assert(da_get(&list, i) == i - 1, "Items were not moved correctly");
+  }
+  for (usize i = 0; i < 100; i++) {
+    da_push(&list, i);
+  }
+  cebus_assert(da_len(&list) == 109, "len: %" USIZE_FMT, da_len(&list));
+  cebus_assert(da_last(&list) == 99, "Wrong last item");
+
+  SDA(usize, 4) small;
+  sda_init(&small, &arena);
+  da_extend(&small, 3, ((usize[]){3, 1, 2}));
+  da_sort_by(&small, usize, *a < *b);
+  da_reverse(&small);
+  cebus_assert(sda_is_inline(&small), "Should still be inline");
+  cebus_assert(da_get(&small, 0) == 3 && da_get(&small, 2) == 1, "Sort or reverse did not work");
+
+  DA(usize) copy = da_new(&arena);
+  da_copy(&small, &copy);
+  cebus_assert(da_len(&copy) == 3 && da_get(&copy, 1) == 2, "Copy did not work");
+  cebus_assert(!sda_is_inline(&copy), "A normal dynamic array is never inline");
+
+  arena_free(&arena);
+}
+
 static void test_for_each(void) {
   Arena arena = {0};
   DA(usize) list = {0};
@@ -276,6 +410,198 @@ static void test_for_each(void) {
   cebus_assert(i == list.len, "");
 }
 
+static u64 next_random(u64 *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+static void test_sort_by(void) {
+  Arena arena = {0};
+  DA(u64) list = da_new(&arena);
+  u64 state = 0x2545F4914F6CDD1D;
+  const usize sizes[] = {0, 1, 2, 3, 16, 17, 100, 1000, 100000};
+  for (usize s = 0; s < ARRAY_LEN(sizes); s++) {
+    // random, sorted, reversed, few unique values and organ pipe
+    for (usize pattern = 0; pattern < 5; pattern++) {
+      da_clear(&list);
+      const usize n = sizes[s];
+      for (usize i = 0; i < n; i++) {
+        const u64 values[] = {next_random(&state), i, n - i, next_random(&state) % 4,
+                              i < n / 2 ? i : n - i};
+        da_push(&list, values[pattern]);
+      }
+      da_sort_by(&list, u64, *a < *b);
+      for (usize i = 1; i < list.len; i++) {
+        cebus_assert(list.items[i - 1] <= list.items[i], "not sorted: %" USIZE_FMT, i);
+      }
+    }
+  }
+
+  // descending
+  da_sort_by(&list, u64, *b < *a);
+  for (usize i = 1; i < list.len; i++) {
+    cebus_assert(list.items[i - 1] >= list.items[i], "not sorted: %" USIZE_FMT, i);
+  }
+
+  arena_free(&arena);
+}
+
+typedef struct {
+  u64 key;
+  usize idx;
+} Record;
+
+#define RECORD_KEY(r) ((r).key)
+
+static void test_sort_stable_by(void) {
+  Arena arena = {0};
+  DA(Record) list = da_new(&arena);
+  u64 state = 0x9E3779B97F4A7C15;
+  for (usize i = 0; i < 10000; i++) {
+    da_push(&list, (Record){.key = next_random(&state) % 100, .idx = i});
+  }
+  da_sort_stable_by(&list, Record, a->key < b->key);
+  for (usize i = 1; i < list.len; i++) {
+    const Record *r1 = &list.items[i - 1];
+    const Record *r2 = &list.items[i];
+    cebus_assert(r1->key < r2->key || (r1->key == r2->key && r1->idx < r2->idx),
+                 "not stable at %" USIZE_FMT, i);
+  }
+  arena_free(&arena);
+}
+
+static void test_radix_sort(void) {
+  Arena arena = {0};
+  DA(Record) list = da_new(&arena);
+  u64 state = 0x1234567;
+  for (usize i = 0; i < 10000; i++) {
+    // the upper bytes are the same for all keys
+    da_push(&list, (Record){.key = next_random(&state) % 1000, .idx = i});
+  }
+  da_radix_sort_u64(&list, RECORD_KEY);
+  for (usize i = 1; i < list.len; i++) {
+    const Record *r1 = &list.items[i - 1];
+    const Record *r2 = &list.items[i];
+    cebus_assert(r1->key < r2->key || (r1->key == r2->key && r1->idx < r2->idx),
+                 "not sorted at %" USIZE_FMT, i);
+  }
+
+  DA(u64) numbers = da_new(&arena);
+  for (usize i = 0; i < 1000; i++) {
+    da_push(&numbers, next_random(&state));
+  }
+  da_radix_sort_u64(&numbers, (u64));
+  for (usize i = 1; i < numbers.len; i++) {
+    cebus_assert(numbers.items[i - 1] <= numbers.items[i], "not sorted: %" USIZE_FMT, i);
+  }
+  arena_free(&arena);
+}
+
+static void test_lower_bound(void) {
+  Arena arena = {0};
+  DA(u64) list = da_new(&arena);
+  usize idx = 0;
+  da_lower_bound(&list, u64, 5, idx, *a < *b);
+  cebus_assert(idx == 0, "Empty array");
+  da_bsearch(&list, u64, 5, idx, *a < *b);
+  cebus_assert(idx == DA_NOT_FOUND, "Empty array");
+
+  // 0, 2, 2, 2, 4, ..., 18
+  for (u64 i = 0; i < 10; i++) {
+    da_push(&list, i * 2);
+    if (i == 1) {
+      da_push(&list, 2);
+      da_push(&list, 2);
+    }
+  }
+  for (u64 key = 0; key < 22; key++) {
+    usize lower = 0;
+    usize upper = 0;
+    da_lower_bound(&list, u64, key, lower, *a < *b);
+    da_upper_bound(&list, u64, key, upper, *a < *b);
+    usize expected_lower = 0;
+    while (expected_lower < da_len(&list) && da_get(&list, expected_lower) < key) {
+      expected_lower++;
+    }
+    usize expected_upper = expected_lower;
+    while (expected_upper < da_len(&list) && da_get(&list, expected_upper) <= key) {
+      expected_upper++;
+    }
+    cebus_assert(lower == expected_lower, "lower bound of %" U64_FMT ": %" USIZE_FMT, key, lower);
+    cebus_assert(upper == expected_upper, "upper bound of %" U64_FMT ": %" USIZE_FMT, key, upper);
+
+    da_bsearch(&list, u64, key, idx, *a < *b);
+    if (key % 2 == 0 && key < 20) {
+      cebus_assert(idx != DA_NOT_FOUND && da_get(&list, idx) == key, "Did not find %" U64_FMT, key);
+    } else {
+      cebus_assert(idx == DA_NOT_FOUND, "Should not find %" U64_FMT, key);
+    }
+  }
+  da_lower_bound(&list, u64, 2, idx, *a < *b);
+  cebus_assert(idx == 1, "Should find the first of the equal items");
+
+  DA(Record) records = da_new(&arena);
+  for (usize i = 0; i < 100; i++) {
+    da_push(&records, ((Record){.key = i / 10, .idx = i}));
+  }
+  da_upper_bound(&records, Record, ((Record){.key = 4}), idx, a->key < b->key);
+  cebus_assert(idx == 50, "idx: %" USIZE_FMT, idx);
+
+  arena_free(&arena);
+}
+
+static void test_unique(void) {
+  Arena arena = {0};
+  DA(u64) list = da_new(&arena);
+  da_unique(&list, u64, *a < *b);
+  cebus_assert(da_len(&list) == 0, "Empty array");
+
+  da_extend(&list, 10, ((u64[]){1, 1, 2, 3, 3, 3, 4, 7, 7, 9}));
+  da_unique(&list, u64, *a < *b);
+  const u64 expected[] = {1, 2, 3, 4, 7, 9};
+  cebus_assert(da_len(&list) == ARRAY_LEN(expected), "len: %" USIZE_FMT, da_len(&list));
+  for (usize i = 0; i < ARRAY_LEN(expected); i++) {
+    cebus_assert(da_get(&list, i) == expected[i], "Wrong value at %" USIZE_FMT, i);
+  }
+
+  DA(Record) records = da_new(&arena);
+  for (usize i = 0; i < 100; i++) {
+    da_push(&records, ((Record){.key = i / 10, .idx = i}));
+  }
+  da_unique(&records, Record, a->key < b->key);
+  cebus_assert(da_len(&records) == 10, "len: %" USIZE_FMT, da_len(&records));
+  cebus_assert(da_get(&records, 3).idx == 30, "Should keep the first of equal items");
+
+  arena_free(&arena);
+}
+
+static void test_merge_sorted(void) {
+  Arena arena = {0};
+  DA(Record) first = da_new(&arena);
+  DA(Record) second = da_new(&arena);
+  DA(Record) merged = da_new(&arena);
+  for (usize i = 0; i < 10; i++) {
+    da_push(&first, ((Record){.key = i * 2, .idx = 0}));
+  }
+  for (usize i = 0; i < 15; i++) {
+    da_push(&second, ((Record){.key = i, .idx = 1}));
+  }
+  da_push(&merged, ((Record){.key = 100, .idx = 2}));
+  da_merge_sorted(&first, &second, &merged, Record, a->key < b->key);
+  cebus_assert(da_len(&merged) == 26, "len: %" USIZE_FMT, da_len(&merged));
+  cebus_assert(da_get(&merged, 0).key == 100, "Should append to the destination");
+  for (usize i = 2; i < da_len(&merged); i++) {
+    const Record prev = da_get(&merged, i - 1);
+    const Record cur = da_get(&merged, i);
+    cebus_assert(prev.key <= cur.key, "Not sorted at %" USIZE_FMT, i);
+    cebus_assert(prev.key != cur.key || prev.idx <= cur.idx, "Not stable at %" USIZE_FMT, i);
+  }
+
+  arena_free(&arena);
+}
+
 int main(void) {
   test_vec();
   test_da_init();
@@ -284,6 +610,9 @@ int main(void) {
   test_reserve();
   test_reverse();
   test_sort();
+  test_sort_by();
+  test_sort_stable_by();
+  test_radix_sort();
   test_last();
   test_filter();
   test_filter_ctx();
@@ -291,5 +620,14 @@ int main(void) {
   test_pop();
   test_insert();
   test_remove();
+  test_insert_front();
+  test_insert_n();
+  test_remove_range();
+  test_swap_remove();
+  test_retain();
+  test_sda();
+  test_lower_bound();
+  test_unique();
+  test_merge_sorted();
   test_for_each();
 }
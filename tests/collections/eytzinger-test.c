@@ -0,0 +1,72 @@
+#include "cebus/collection/eytzinger.h"
+
+#include "cebus/core/debug.h"
+
+static void test_contains(void) {
+  Arena arena = {0};
+  for (usize n = 0; n < 70; n++) {
+    u64 keys[70];
+    // odd keys in reverse order
+    for (usize i = 0; i < n; i++) {
+      keys[i] = (n - i) * 2 - 1;
+    }
+    Eytzinger ez = eytzinger_create(&arena, n, keys);
+    cebus_assert(ez.len == n, "len: %" USIZE_FMT, ez.len);
+    for (u64 key = 0; key < 2 * n + 2; key++) {
+      const bool expected = key % 2 == 1 && key < 2 * n;
+      cebus_assert(eytzinger_contains(&ez, key) == expected, "key %" U64_FMT " in %" USIZE_FMT,
+                   key, n);
+
+      u64 lower = 0;
+      const bool has_lower = eytzinger_lower_bound(&ez, key, &lower);
+      cebus_assert(has_lower == (key < 2 * n), "lower bound of %" U64_FMT, key);
+      if (has_lower) {
+        cebus_assert(lower == (key % 2 ? key : key + 1), "lower bound of %" U64_FMT ": %" U64_FMT,
+                     key, lower);
+      }
+    }
+  }
+  arena_free(&arena);
+}
+
+static void test_duplicates(void) {
+  Arena arena = {0};
+  const u64 keys[] = {5, 1, 5, 1, 3, U64_MAX, 0};
+  Eytzinger ez = eytzinger_create(&arena, ARRAY_LEN(keys), keys);
+  cebus_assert(ez.len == 5, "len: %" USIZE_FMT, ez.len);
+  cebus_assert(eytzinger_contains(&ez, 0), "0 is in the set");
+  cebus_assert(eytzinger_contains(&ez, U64_MAX), "U64_MAX is in the set");
+  cebus_assert(!eytzinger_contains(&ez, 4), "4 is not in the set");
+  arena_free(&arena);
+}
+
+static void test_batch(void) {
+  Arena arena = {0};
+  u64 keys[1000];
+  for (usize i = 0; i < ARRAY_LEN(keys); i++) {
+    keys[i] = i * 3;
+  }
+  Eytzinger ez = eytzinger_create(&arena, ARRAY_LEN(keys), keys);
+
+  u64 lookups[100];
+  bool result[100];
+  for (usize i = 0; i < ARRAY_LEN(lookups); i++) {
+    lookups[i] = i * 7;
+  }
+  const usize found = eytzinger_contains_batch(&ez, ARRAY_LEN(lookups), lookups, result);
+  usize expected = 0;
+  for (usize i = 0; i < ARRAY_LEN(lookups); i++) {
+    cebus_assert(result[i] == eytzinger_contains(&ez, lookups[i]), "Wrong result at %" USIZE_FMT,
+                 i);
+    expected += result[i];
+  }
+  cebus_assert(found == expected && found == 34, "found: %" USIZE_FMT, found);
+  cebus_assert(eytzinger_contains_batch(&ez, 3, lookups, NULL) == 1, "Without result");
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_contains();
+  test_duplicates();
+  test_batch();
+}
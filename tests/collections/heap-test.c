@@ -0,0 +1,107 @@
+#include "cebus/collection/heap.h"
+
+#include "cebus/core/debug.h"
+
+typedef struct {
+  u32 deadline;
+  usize id;
+} Task;
+
+HEAP_DEFINE(MinHeap, u64, 2, *a < *b)
+HEAP_DEFINE(MaxHeap4, u64, 4, *a > *b)
+HEAP_DEFINE(TaskQueue, Task, 3, a->deadline < b->deadline)
+
+static u64 next_random(u64 *state) {
+  *state ^= *state << 13;
+  *state ^= *state >> 7;
+  *state ^= *state << 17;
+  return *state;
+}
+
+static void test_push_pop(void) {
+  Arena arena = {0};
+  MinHeap min = da_new(&arena);
+  MaxHeap4 max = da_new(&arena);
+  u64 seed = 0x2545F4914F6CDD1D;
+  for (usize i = 0; i < 1000; i++) {
+    const u64 value = next_random(&seed) % 500;
+    MinHeap_push(&min, value);
+    MaxHeap4_push(&max, value);
+  }
+  cebus_assert(da_len(&min) == 1000, "len: %" USIZE_FMT, da_len(&min));
+
+  u64 last = MinHeap_peek(&min);
+  while (!da_empty(&min)) {
+    const u64 value = MinHeap_pop(&min);
+    cebus_assert(last <= value, "Min heap out of order");
+    last = value;
+  }
+  last = MaxHeap4_pop(&max);
+  while (!da_empty(&max)) {
+    const u64 value = MaxHeap4_pop(&max);
+    cebus_assert(value <= last, "Max heap out of order");
+    last = value;
+  }
+
+  arena_free(&arena);
+}
+
+static void test_struct(void) {
+  Arena arena = {0};
+  TaskQueue queue = da_new(&arena);
+  const u32 deadlines[] = {30, 10, 50, 20, 40, 10};
+  for (usize i = 0; i < ARRAY_LEN(deadlines); i++) {
+    TaskQueue_push(&queue, (Task){.deadline = deadlines[i], .id = i});
+  }
+  cebus_assert(TaskQueue_peek(&queue).deadline == 10, "Wrong first task");
+  Task task = TaskQueue_replace(&queue, (Task){.deadline = 5, .id = 100});
+  cebus_assert(task.deadline == 10, "Wrong replaced task");
+  cebus_assert(TaskQueue_pop(&queue).id == 100, "Replaced task should be first");
+  cebus_assert(TaskQueue_pop(&queue).deadline == 10, "Wrong second task");
+  cebus_assert(TaskQueue_pop(&queue).deadline == 20, "Wrong third task");
+  cebus_assert(da_len(&queue) == 3, "len: %" USIZE_FMT, da_len(&queue));
+
+  arena_free(&arena);
+}
+
+static void test_heapify(void) {
+  Arena arena = {0};
+  DA(u64) values = da_new(&arena);
+  for (u64 i = 0; i < 100; i++) {
+    da_push(&values, (i * 37) % 100);
+  }
+  MaxHeap4 heap = MaxHeap4_from(&arena, DA_ARG(&values));
+  cebus_assert(da_len(&heap) == 100, "len: %" USIZE_FMT, da_len(&heap));
+  for (u64 i = 100; 0 < i; i--) {
+    cebus_assert(MaxHeap4_pop(&heap) == i - 1, "Wrong order");
+  }
+
+  MinHeap small = da_new(&arena);
+  da_extend(&small, 2, ((u64[]){2, 1}));
+  MinHeap_heapify(&small);
+  cebus_assert(MinHeap_peek(&small) == 1, "Heapify did not work");
+
+  arena_free(&arena);
+}
+
+static void test_top_k(void) {
+  Arena arena = {0};
+  MinHeap best = da_new(&arena);
+  for (u64 i = 0; i < 1000; i++) {
+    MinHeap_push_top_k(&best, 10, (i * 7919) % 1000);
+  }
+  cebus_assert(da_len(&best) == 10, "len: %" USIZE_FMT, da_len(&best));
+  for (u64 i = 990; i < 1000; i++) {
+    cebus_assert(MinHeap_pop(&best) == i, "Wrong top k value");
+  }
+  cebus_assert(!MinHeap_push_top_k(&best, 0, 1), "k = 0 keeps nothing");
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_push_pop();
+  test_struct();
+  test_heapify();
+  test_top_k();
+}
@@ -0,0 +1,116 @@
+#include "cebus/collection/hll.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/byte.h"
+#include "cebus/type/integer.h"
+
+static bool within(u64 estimate, u64 expected, f64 error) {
+  const f64 diff = (f64)estimate - (f64)expected;
+  return -error * (f64)expected <= diff && diff <= error * (f64)expected;
+}
+
+static void test_hll_sparse(void) {
+  Arena arena = {0};
+  HyperLogLog hll = hll_create(&arena, 14);
+  cebus_assert(hll_count(&hll) == 0, "Empty sketch");
+
+  for (usize i = 0; i < 1000; i++) {
+    hll_add(&hll, i);
+    hll_add(&hll, i);
+  }
+  cebus_assert(hll.sparse, "1000 hashes should still be sparse");
+  const u64 count = hll_count(&hll);
+  cebus_assert(within(count, 1000, 0.01), "count: %" U64_FMT, count);
+
+  hll_clear(&hll);
+  cebus_assert(hll_count(&hll) == 0, "Sketch should be empty");
+
+  arena_free(&arena);
+}
+
+static void test_hll_dense(void) {
+  Arena arena = {0};
+  HyperLogLog hll = hll_create(&arena, 12);
+
+  for (usize i = 0; i < 1000000; i++) {
+    hll_add(&hll, i % 500000);
+  }
+  cebus_assert(hll.sparse == false, "Sketch should be dense");
+  cebus_assert(hll.registers != NULL, "Sketch should be dense");
+  const u64 count = hll_count(&hll);
+  // 1.6% standard error, allow 3 of them
+  cebus_assert(within(count, 500000, 0.05), "count: %" U64_FMT, count);
+
+  arena_free(&arena);
+}
+
+static void test_hll_merge(void) {
+  Arena arena = {0};
+  HyperLogLog shards[4];
+  for (usize i = 0; i < 4; i++) {
+    shards[i] = hll_create(&arena, 14);
+  }
+  // overlapping ranges: [0, 200000)
+  for (usize i = 0; i < 4; i++) {
+    for (usize j = i * 40000; j < i * 40000 + 80000; j++) {
+      hll_add(&shards[i], j);
+    }
+  }
+  HyperLogLog sparse = hll_create(&arena, 14);
+  hll_add(&sparse, 300000);
+  hll_add(&sparse, 300001);
+
+  HyperLogLog merged = hll_create(&arena, 14);
+  hll_merge(&merged, &sparse);
+  cebus_assert(merged.sparse && merged.len == 2, "Merging sparse sketches stays sparse");
+  for (usize i = 0; i < 4; i++) {
+    hll_merge(&merged, &shards[i]);
+  }
+  const u64 count = hll_count(&merged);
+  cebus_assert(within(count, 200002, 0.03), "count: %" U64_FMT, count);
+
+  HyperLogLog copy = hll_copy(&arena, &shards[0]);
+  hll_merge(&copy, &sparse);
+  cebus_assert(within(hll_count(&copy), 80002, 0.03), "count: %" U64_FMT, hll_count(&copy));
+
+  arena_free(&arena);
+}
+
+static void test_hll_serialize(void) {
+  Arena arena = {0};
+  HyperLogLog sparse = hll_create(&arena, 10);
+  HyperLogLog dense = hll_create(&arena, 10);
+  for (usize i = 0; i < 100; i++) {
+    hll_add(&sparse, i);
+  }
+  for (usize i = 0; i < 100000; i++) {
+    hll_add(&dense, i);
+  }
+
+  Bytes bytes = hll_serialize(&sparse, &arena);
+  HyperLogLog hll = hll_deserialize(bytes, &arena, ErrPanic);
+  cebus_assert(hll.sparse && hll.len == sparse.len, "Sparse sketch was not restored");
+  cebus_assert(hll_count(&hll) == hll_count(&sparse), "Estimate changed");
+
+  bytes = hll_serialize(&dense, &arena);
+  cebus_assert(bytes.size == 6 + 1024, "size: %" USIZE_FMT, bytes.size);
+  hll = hll_deserialize(bytes, &arena, ErrPanic);
+  cebus_assert(!hll.sparse && hll.precision == 10, "Dense sketch was not restored");
+  cebus_assert(hll_count(&hll) == hll_count(&dense), "Estimate changed");
+
+  Error error = ErrNew;
+  hll_deserialize(bytes_slice(bytes, 0, 100), &arena, &error);
+  error_context(&error, {
+    cebus_assert(error_code(HllError) == HLL_INVALID, "Wrong error code");
+    error_except();
+  });
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_hll_sparse();
+  test_hll_dense();
+  test_hll_merge();
+  test_hll_serialize();
+}
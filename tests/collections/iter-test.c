@@ -0,0 +1,176 @@
+#include "cebus/collection/iter.h"
+
+#include "cebus/core/arena.h"
+#include "cebus/core/debug.h"
+#include "cebus/type/integer.h"
+
+static void test_da(void) {
+  Arena arena = {0};
+  DA(usize) numbers = da_new(&arena);
+  for (usize i = 0; i < 100; i++) {
+    da_push(&numbers, i);
+  }
+
+  DA(usize) squares = da_new(&arena);
+  it_da(usize, x, &numbers)
+    it_filter(x % 2 == 0)
+      it_map(usize, y, x * x)
+        it_collect(&squares, y);
+
+  cebus_assert(da_len(&squares) == 50, "len: %" USIZE_FMT, da_len(&squares));
+  for (usize i = 0; i < da_len(&squares); i++) {
+    cebus_assert(da_get(&squares, i) == (2 * i) * (2 * i), "Wrong value at %" USIZE_FMT, i);
+  }
+
+  usize sum = 0;
+  it_da(usize, x, &numbers)
+    it_fold(sum, sum + x);
+  cebus_assert(sum == 4950, "sum: %" USIZE_FMT, sum);
+
+  usize count = 0;
+  it_da(usize, x, &numbers)
+    it_filter(x % 3 == 0)
+      it_count(count);
+  cebus_assert(count == 34, "count: %" USIZE_FMT, count);
+
+  arena_free(&arena);
+}
+
+static void test_take(void) {
+  Arena arena = {0};
+  DA(usize) numbers = da_new(&arena);
+  for (usize i = 0; i < 100; i++) {
+    da_push(&numbers, i);
+  }
+
+  // the filter and map stop being evaluated after the take is done
+  usize evaluated = 0;
+  DA(usize) odd = da_new(&arena);
+  it_da(usize, x, &numbers)
+    it_filter((evaluated++, x % 2 == 1))
+      it_map(usize, y, x + 1000)
+        it_take(5)
+          it_collect(&odd, y);
+  cebus_assert(da_len(&odd) == 5, "len: %" USIZE_FMT, da_len(&odd));
+  cebus_assert(da_get(&odd, 0) == 1001, "Wrong first value");
+  cebus_assert(da_get(&odd, 4) == 1009, "Wrong last value");
+  cebus_assert(evaluated == 10, "evaluated: %" USIZE_FMT, evaluated);
+
+  usize count = 0;
+  it_da(usize, x, &numbers)
+    it_take(0)
+      it_count(count);
+  cebus_assert(count == 0, "Nothing should be taken");
+
+  count = 0;
+  it_range(usize, i, 0, 10)
+    it_take(100)
+      it_count(count);
+  cebus_assert(count == 10, "Take more than available: %" USIZE_FMT, count);
+
+  arena_free(&arena);
+}
+
+static void test_range(void) {
+  i32 sum = 0;
+  it_range(i32, i, -5, 5)
+    it_filter(i != 0)
+      it_map(i32, sq, i * i)
+        it_fold(sum, sum + sq);
+  cebus_assert(sum == 85, "sum: %d", sum);
+
+  usize count = 0;
+  it_range(usize, i, 10, 10)
+    it_count(count);
+  cebus_assert(count == 0, "Empty range");
+}
+
+static void test_zip(void) {
+  Arena arena = {0};
+  DA(usize) keys = da_new(&arena);
+  DA(u64) values = da_new(&arena);
+  for (usize i = 0; i < 10; i++) {
+    da_push(&keys, i);
+  }
+  for (usize i = 0; i < 5; i++) {
+    da_push(&values, (u64)i * 10);
+  }
+
+  // stops with the shorter one
+  u64 dot = 0;
+  usize count = 0;
+  it_da(usize, k, &keys)
+    it_zip(u64, v, &values) {
+      dot += k * v;
+      count++;
+    }
+  cebus_assert(count == 5, "count: %" USIZE_FMT, count);
+  cebus_assert(dot == 300, "dot: %" U64_FMT, dot);
+
+  // zip after a filter pairs the filtered elements
+  DA(u64) pairs = da_new(&arena);
+  it_da(usize, k, &keys)
+    it_filter(k % 2 == 1)
+      it_zip(u64, v, &values)
+        it_collect(&pairs, k * 100 + v);
+  cebus_assert(da_len(&pairs) == 5, "len: %" USIZE_FMT, da_len(&pairs));
+  cebus_assert(da_get(&pairs, 0) == 100, "first: %" U64_FMT, da_get(&pairs, 0));
+  cebus_assert(da_get(&pairs, 4) == 940, "last: %" U64_FMT, da_get(&pairs, 4));
+
+  arena_free(&arena);
+}
+
+static void test_split(void) {
+  Arena arena = {0};
+  Str text = STR("alpha,,beta,gamma,delta");
+
+  DA(Str) words = da_new(&arena);
+  it_split(word, text, ',')
+    it_filter(!str_eq(word, STR("")))
+      it_take(3)
+        it_collect(&words, word);
+  cebus_assert(da_len(&words) == 3, "len: %" USIZE_FMT, da_len(&words));
+  cebus_assert(str_eq(da_get(&words, 0), STR("alpha")), "Wrong first word");
+  cebus_assert(str_eq(da_get(&words, 2), STR("gamma")), "Wrong last word");
+
+  usize len = 0;
+  it_split(word, text, ',')
+    it_fold(len, len + word.len);
+  cebus_assert(len == 19, "len: %" USIZE_FMT, len);
+
+  arena_free(&arena);
+}
+
+static void test_fs(void) {
+  FsIter it = fs_iter_begin(STR("tests/collections"), false);
+  usize count = 0;
+  bool found = false;
+  it_fs(e, &it)
+    it_filter(!e.is_dir && str_endswith(e.path, STR(".c"))) {
+      found |= str_eq(e.path, STR("tests/collections/iter-test.c"));
+      count++;
+    }
+  Error error = ErrNew;
+  fs_iter_end(&it, &error);
+  error_context(&error, { error_panic(); });
+  cebus_assert(found, "Did not find this file");
+  cebus_assert(8 <= count, "count: %" USIZE_FMT, count);
+
+  it = fs_iter_begin(STR("tests/collections"), false);
+  count = 0;
+  it_fs(e, &it)
+    it_take(2)
+      it_count(count);
+  fs_iter_end(&it, &error);
+  error_context(&error, { error_panic(); });
+  cebus_assert(count == 2, "count: %" USIZE_FMT, count);
+}
+
+int main(void) {
+  test_da();
+  test_take();
+  test_range();
+  test_zip();
+  test_split();
+  test_fs();
+}
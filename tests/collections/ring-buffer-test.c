@@ -0,0 +1,106 @@
+#include "cebus/collection/ring_buffer.h"
+
+#include "cebus/core/debug.h"
+
+static void test_queue(void) {
+  Arena arena = {0};
+  RingBuffer(usize) queue = rb_new(&arena);
+  cebus_assert(rb_empty(&queue), "Should be empty");
+
+  // keeps wrapping around without growing
+  usize next = 0;
+  for (usize i = 0; i < 5; i++) {
+    rb_push_back(&queue, i);
+  }
+  for (usize i = 5; i < 1000; i++) {
+    rb_push_back(&queue, i);
+    cebus_assert(rb_pop_front(&queue) == next, "Wrong order at %" USIZE_FMT, i);
+    next++;
+  }
+  cebus_assert(queue.cap == RB_MIN_CAP, "cap: %" USIZE_FMT, queue.cap);
+  cebus_assert(rb_len(&queue) == 5, "len: %" USIZE_FMT, rb_len(&queue));
+  cebus_assert(rb_front(&queue) == 995, "Wrong front");
+  cebus_assert(rb_back(&queue) == 999, "Wrong back");
+
+  arena_free(&arena);
+}
+
+static void test_deque(void) {
+  Arena arena = {0};
+  Deque(i32) deque = rb_new(&arena);
+  for (i32 i = 0; i < 100; i++) {
+    rb_push_back(&deque, i);
+    rb_push_front(&deque, -i - 1);
+  }
+  cebus_assert(rb_len(&deque) == 200, "len: %" USIZE_FMT, rb_len(&deque));
+  cebus_assert((deque.cap & (deque.cap - 1)) == 0, "cap is not a power of two");
+  for (usize i = 0; i < rb_len(&deque); i++) {
+    cebus_assert(rb_get(&deque, i) == (i32)i - 100, "Wrong value at %" USIZE_FMT, i);
+  }
+  cebus_assert(rb_pop_back(&deque) == 99, "Wrong back");
+  cebus_assert(rb_pop_front(&deque) == -100, "Wrong front");
+  cebus_assert(rb_len(&deque) == 198, "len: %" USIZE_FMT, rb_len(&deque));
+
+  rb_clear(&deque);
+  cebus_assert(rb_empty(&deque), "Clear did not remove the elements");
+
+  arena_free(&arena);
+}
+
+static void test_grow_wrapped(void) {
+  Arena arena = {0};
+  RingBuffer(usize) rb = rb_new(&arena);
+  for (usize i = 0; i < RB_MIN_CAP; i++) {
+    rb_push_back(&rb, i);
+  }
+  // move the head to the middle, so the elements wrap around
+  for (usize i = 0; i < RB_MIN_CAP / 2; i++) {
+    (void)rb_pop_front(&rb);
+    rb_push_back(&rb, RB_MIN_CAP + i);
+  }
+  cebus_assert(rb.head == RB_MIN_CAP / 2, "head: %" USIZE_FMT, rb.head);
+  rb_push_back(&rb, 100);
+  cebus_assert(rb.cap == RB_MIN_CAP * 2, "cap: %" USIZE_FMT, rb.cap);
+  for (usize i = 0; i < RB_MIN_CAP; i++) {
+    cebus_assert(rb_get(&rb, i) == RB_MIN_CAP / 2 + i, "Wrong value at %" USIZE_FMT, i);
+    cebus_assert(&rb_get(&rb, i) == &rb.items[rb.head + i], "Not contiguous at %" USIZE_FMT, i);
+  }
+  cebus_assert(rb_back(&rb) == 100, "Wrong back");
+
+  arena_free(&arena);
+}
+
+static void test_bulk(void) {
+  Arena arena = {0};
+  RingBuffer(u32) rb = rb_new(&arena);
+  u32 values[100];
+  for (u32 i = 0; i < 100; i++) {
+    values[i] = i;
+  }
+  u32 out[100] = {0};
+
+  rb_push_back_n(&rb, 10, values);
+  rb_pop_front_n(&rb, 7, out);
+  cebus_assert(out[0] == 0 && out[6] == 6, "Wrong values popped");
+  // wraps around the end
+  rb_push_back_n(&rb, 20, &values[10]);
+  cebus_assert(rb_len(&rb) == 23, "len: %" USIZE_FMT, rb_len(&rb));
+  rb_pop_front_n(&rb, 23, out);
+  for (u32 i = 0; i < 23; i++) {
+    cebus_assert(out[i] == i + 7, "Wrong value at %u", i);
+  }
+  cebus_assert(rb_empty(&rb), "Should be empty");
+
+  rb_push_back_n(&rb, 0, values);
+  rb_pop_front_n(&rb, 0, out);
+  cebus_assert(rb_empty(&rb), "Should still be empty");
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_queue();
+  test_deque();
+  test_grow_wrapped();
+  test_bulk();
+}
@@ -1,6 +1,8 @@
 #include "cebus.h"
 
 #include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
 
 static void sb_va_test(const char *fmt, ...) {
   Arena arena = {0};
@@ -17,6 +19,150 @@ static void sb_va_test(const char *fmt, ...) {
   arena_free(&arena);
 }
 
+static void sb_number_test(void) {
+  Arena arena = {0};
+  StringBuilder sb = sb_init(&arena);
+
+  const struct {
+    i64 value;
+    Str expected;
+  } integers[] = {
+      {0, STR("0")},
+      {9, STR("9")},
+      {10, STR("10")},
+      {-99, STR("-99")},
+      {100, STR("100")},
+      {I64_MAX, STR("9223372036854775807")},
+      {I64_MIN, STR("-9223372036854775808")},
+  };
+  for (usize i = 0; i < ARRAY_LEN(integers); i++) {
+    sb_clear(&sb);
+    sb_append_i64(&sb, integers[i].value);
+    Str s = sb_to_str(&sb);
+    cebus_assert(str_eq(s, integers[i].expected), STR_FMT, STR_ARG(s));
+  }
+
+  u64 state = 0x9e3779b97f4a7c15;
+  for (usize i = 0; i < 10000; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    const u64 value = state >> (state % 64);
+    char expected[32];
+    snprintf(expected, sizeof(expected), "%" U64_FMT, value);
+    sb_clear(&sb);
+    sb_append_u64(&sb, value);
+    cebus_assert(str_eq(sb_to_str(&sb), str_from_cstr(expected)), "%s", expected);
+    snprintf(expected, sizeof(expected), "%" U64_HEX, value);
+    sb_clear(&sb);
+    sb_append_hex(&sb, value);
+    cebus_assert(str_eq(sb_to_str(&sb), str_from_cstr(expected)), "%s", expected);
+  }
+
+  Str s = str_from_i64(-42, &arena);
+  cebus_assert(str_eq(s, STR("-42")) && s.data[s.len] == '\0', STR_FMT, STR_ARG(s));
+  s = str_from_u64(U64_MAX, &arena);
+  cebus_assert(str_eq(s, STR("18446744073709551615")), STR_FMT, STR_ARG(s));
+  s = str_from_hex(0xdeadbeef, &arena);
+  cebus_assert(str_eq(s, STR("deadbeef")), STR_FMT, STR_ARG(s));
+
+  arena_free(&arena);
+}
+
+static void sb_f64_test(void) {
+  Arena arena = {0};
+  StringBuilder sb = sb_init(&arena);
+
+  const struct {
+    f64 value;
+    Str expected;
+  } tests[] = {
+      {0.0, STR("0")},
+      {-0.0, STR("-0")},
+      {1.0, STR("1")},
+      {-2.5, STR("-2.5")},
+      {0.1, STR("0.1")},
+      {0.3, STR("0.3")},
+      {123.456, STR("123.456")},
+      {1e20, STR("100000000000000000000")},
+      {1e21, STR("1e+21")},
+      {0.000001, STR("0.000001")},
+      {1.5e-7, STR("1.5e-7")},
+      {9007199254740992.0, STR("9007199254740992")},
+      {5e-324, STR("5e-324")},
+      {1.7976931348623157e308, STR("1.7976931348623157e+308")},
+      {1.0 / 0.0, STR("inf")},
+      {-1.0 / 0.0, STR("-inf")},
+      {0.0 / 0.0, STR("nan")},
+  };
+  for (usize i = 0; i < ARRAY_LEN(tests); i++) {
+    sb_clear(&sb);
+    sb_append_f64(&sb, tests[i].value);
+    Str s = sb_to_str(&sb);
+    cebus_assert(str_eq(s, tests[i].expected), "%" USIZE_FMT ": " STR_FMT, i, STR_ARG(s));
+  }
+
+  // Every double has to read back as itself.
+  u64 state = 0x2545f4914f6cdd1d;
+  for (usize i = 0; i < 100000; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    f64 value;
+    memcpy(&value, &state, sizeof(value));
+    if (value != value || value - value != 0) {
+      continue;
+    }
+    sb_clear(&sb);
+    sb_append_f64(&sb, value);
+    const f64 parsed = str_f64(sb_to_str(&sb));
+    cebus_assert(memcmp(&parsed, &value, sizeof(f64)) == 0, STR_FMT ": %.17g",
+                 STR_ARG(sb_to_str(&sb)), value);
+  }
+
+  Str s = str_from_f64(0.25, &arena);
+  cebus_assert(str_eq(s, STR("0.25")), STR_FMT, STR_ARG(s));
+
+  arena_free(&arena);
+}
+
+static void sb_replace_test(void) {
+  Arena arena = {0};
+  StringBuilder sb = sb_init(&arena);
+
+  sb_append_str(&sb, STR("> "));
+  sb_append_replace(&sb, STR("Hello {name}, {name}!"), STR("{name}"), STR("World"));
+  cebus_assert(str_eq(sb_to_str(&sb), STR("> Hello World, World!")), STR_FMT,
+               STR_ARG(sb_to_str(&sb)));
+
+  sb_clear(&sb);
+  sb_append_replace(&sb, STR("abc"), STR(""), STR("x"));
+  cebus_assert(str_eq(sb_to_str(&sb), STR("abc")), "");
+
+  sb_clear(&sb);
+  sb_append_replace_ignorecase(&sb, STR("Select * FROM t where x select"), STR("SELECT"),
+                               STR("s"));
+  cebus_assert(str_eq(sb_to_str(&sb), STR("s * FROM t where x s")), STR_FMT,
+               STR_ARG(sb_to_str(&sb)));
+
+  // the same as 'str_replace'
+  char text[2000];
+  u64 state = 0x9e3779b97f4a7c15;
+  for (usize i = 0; i < sizeof(text); i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    text[i] = (char)('a' + (state >> 33) % 3);
+  }
+  const Str s = str_from_parts(sizeof(text), text);
+  const Str olds[] = {STR("a"), STR("ab"), STR("abc"), STR("cccc"), STR("abcabcabcabcabcabc")};
+  const Str news[] = {STR(""), STR("x"), STR("<long replacement>")};
+  for (usize i = 0; i < ARRAY_LEN(olds); i++) {
+    for (usize j = 0; j < ARRAY_LEN(news); j++) {
+      sb_clear(&sb);
+      sb_append_replace(&sb, s, olds[i], news[j]);
+      const Str expected = str_replace(s, olds[i], news[j], &arena);
+      cebus_assert(str_eq(sb_to_str(&sb), expected), "%" USIZE_FMT ", %" USIZE_FMT, i, j);
+    }
+  }
+
+  arena_free(&arena);
+}
+
 int main(void) {
   Arena arena = {0};
   StringBuilder sb = sb_init(&arena);
@@ -31,6 +177,9 @@ int main(void) {
   cebus_assert(str_eq(s, STR("Hello, World 420!")), STR_FMT, STR_ARG(s));
 
   sb_va_test("%d %d", 420, 69);
+  sb_number_test();
+  sb_f64_test();
+  sb_replace_test();
 
   sb_clear(&sb);
   cebus_assert(sb.len == 0, "Did not reset correctly");
@@ -0,0 +1,104 @@
+#include "cebus/collection/seg_array.h"
+
+#include "cebus/core/debug.h"
+
+static void test_push(void) {
+  Arena arena = {0};
+  SEG(usize) list = seg_new(&arena);
+  cebus_assert(seg_empty(&list), "Should be empty");
+
+  const usize n = 100000;
+  usize *first = NULL;
+  for (usize i = 0; i < n; i++) {
+    seg_push(&list, i * 3);
+    if (i == 0) {
+      first = &seg_get(&list, 0);
+    }
+  }
+  cebus_assert(seg_len(&list) == n, "len: %" USIZE_FMT, seg_len(&list));
+  cebus_assert(first == &seg_first(&list), "Pointers have to stay valid");
+  for (usize i = 0; i < n; i++) {
+    cebus_assert(seg_get(&list, i) == i * 3, "Wrong value at %" USIZE_FMT, i);
+  }
+  cebus_assert(seg_last(&list) == (n - 1) * 3, "Wrong last value");
+  cebus_assert(seg_pop(&list) == (n - 1) * 3, "Wrong popped value");
+  cebus_assert(seg_len(&list) == n - 1, "Pop did not remove the value");
+
+  arena_free(&arena);
+}
+
+static void test_segments(void) {
+  Arena arena = {0};
+  SEG(usize) list = seg_new(&arena);
+  // the boundaries between the segments
+  for (usize i = 0; i < SEG_FIRST * 7; i++) {
+    seg_push(&list, i);
+  }
+  cebus_assert(list.cap == SEG_FIRST * 7, "cap: %" USIZE_FMT, list.cap);
+  cebus_assert(&seg_get(&list, SEG_FIRST - 1) == &list.segments[0][SEG_FIRST - 1],
+               "Last of the first segment");
+  cebus_assert(&seg_get(&list, SEG_FIRST) == &list.segments[1][0], "First of the second segment");
+  cebus_assert(&seg_get(&list, SEG_FIRST * 3) == &list.segments[2][0],
+               "First of the third segment");
+  cebus_assert(&seg_get(&list, SEG_FIRST * 7 - 1) == &list.segments[2][SEG_FIRST * 4 - 1],
+               "Last of the third segment");
+
+  seg_clear(&list);
+  cebus_assert(seg_len(&list) == 0, "Clear did not reset the len");
+  cebus_assert(list.cap == SEG_FIRST * 7, "Clear should keep the segments");
+
+  seg_reserve(&list, 1000);
+  cebus_assert(1000 <= list.cap, "cap: %" USIZE_FMT, list.cap);
+
+  arena_free(&arena);
+}
+
+static void test_extend(void) {
+  Arena arena = {0};
+  SEG(u32) list = seg_new(&arena);
+  u32 values[1000];
+  for (u32 i = 0; i < 1000; i++) {
+    values[i] = i;
+  }
+  seg_push(&list, 42);
+  seg_extend(&list, 1000, values);
+  seg_extend(&list, 3, ((u32[]){1, 2, 3}));
+  cebus_assert(seg_len(&list) == 1004, "len: %" USIZE_FMT, seg_len(&list));
+  cebus_assert(seg_first(&list) == 42, "Wrong first value");
+  for (usize i = 0; i < 1000; i++) {
+    cebus_assert(seg_get(&list, i + 1) == i, "Wrong value at %" USIZE_FMT, i);
+  }
+  cebus_assert(seg_last(&list) == 3, "Wrong last value");
+
+  arena_free(&arena);
+}
+
+static void test_for_each(void) {
+  Arena arena = {0};
+  SEG(usize) list = seg_new(&arena);
+  usize count = 0;
+  seg_for_each(usize *, v, &list) { count++; }
+  cebus_assert(count == 0, "Empty array");
+
+  for (usize i = 0; i < 1000; i++) {
+    seg_push(&list, i);
+  }
+  usize sum = 0;
+  seg_for_each(usize *, v, &list) {
+    sum += *v;
+    *v = 0;
+    count++;
+  }
+  cebus_assert(count == 1000, "count: %" USIZE_FMT, count);
+  cebus_assert(sum == 499500, "sum: %" USIZE_FMT, sum);
+  cebus_assert(seg_get(&list, 999) == 0, "Could not write through the iterator");
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_push();
+  test_segments();
+  test_extend();
+  test_for_each();
+}
@@ -5,6 +5,8 @@
 #include "cebus/type/integer.h"
 #include "cebus/type/string.h"
 
+#include <stdlib.h>
+
 #define TEST_SET_DEFAULT_SIZE 10
 
 static void test_set_insert(void) {
@@ -229,6 +231,109 @@ static void test_set_union(void) {
   arena_free(&arena);
 }
 
+static void test_set_sorted(void) {
+  Arena arena = {0};
+
+  Set set = set_create(&arena);
+  const usize n = 1000;
+  for (usize i = 0; i < n; i++) {
+    set_add(&set, u64_hash(i));
+  }
+  set_remove(&set, u64_hash(5));
+
+  u64 *sorted = set_sorted(&set, &arena);
+  for (usize i = 0; i < set.count; i++) {
+    cebus_assert(set_contains(&set, sorted[i]), "sorted array has unknown member");
+    if (i != 0) {
+      cebus_assert(sorted[i - 1] < sorted[i], "array is not sorted");
+    }
+  }
+
+  arena_free(&arena);
+}
+
+// bijective, so there are no collisions like in 'u64_hash'
+static u64 spread(usize i) { return (u64)(i + 1) * 0x9E3779B97F4A7C15; }
+
+static void test_set_sorted_algebra(void) {
+  Arena arena = {0};
+
+  // big and full enough to use the sorted algorithms
+  const usize n = 1700000;
+  Set set1 = set_create(&arena);
+  Set set2 = set_create(&arena);
+  for (usize i = 0; i < n; i++) {
+    set_add(&set1, spread(i));
+    set_add(&set2, spread(i + n / 2));
+  }
+
+  Set inter = set_intersection(&set1, &set2, &arena);
+  cebus_assert(inter.count == n / 2, "%" USIZE_FMT, inter.count);
+  cebus_assert(set_contains(&inter, spread(n / 2)), "should be in the intersection");
+  cebus_assert(!set_contains(&inter, spread(0)), "should not be in the intersection");
+
+  Set diff = set_difference(&set1, &set2, &arena);
+  cebus_assert(diff.count == n / 2, "%" USIZE_FMT, diff.count);
+  cebus_assert(set_contains(&diff, spread(0)), "should be in the difference");
+  cebus_assert(!set_contains(&diff, spread(n)), "should not be in the difference");
+
+  Set _union = set_union(&set1, &set2, &arena);
+  cebus_assert(_union.count == n, "%" USIZE_FMT, _union.count);
+  cebus_assert(set_contains(&_union, spread(0)), "should be in the union");
+  cebus_assert(set_contains(&_union, spread(n)), "should be in the union");
+
+  cebus_assert(set_subset(&inter, &set1), "should be a subset");
+  cebus_assert(set_subset(&inter, &set2), "should be a subset");
+  cebus_assert(!set_subset(&diff, &set2), "should not be a subset");
+
+  cebus_assert(set_disjoint(&diff, &set2), "should be disjoint");
+  cebus_assert(!set_disjoint(&set1, &set2), "should not be disjoint");
+
+  Set copy = set_copy(&arena, &set1);
+  cebus_assert(set_eq(&set1, &copy), "should be equal");
+  cebus_assert(!set_eq(&set1, &set2), "should not be equal");
+
+  arena_free(&arena);
+}
+
+static int compare_u64(const void *a, const void *b) {
+  const u64 x = *(const u64 *)a;
+  const u64 y = *(const u64 *)b;
+  return x < y ? -1 : x > y;
+}
+
+// The smaller set is fully matched in the middle of a block of the bigger one,
+// the rest of the block must not be written past the end of the result.
+static void test_set_sorted_intersection_end(void) {
+  Arena arena = {0};
+
+  const usize n = 1700003;
+  u64 *sorted = arena_alloc(&arena, n * sizeof(u64));
+  Set set1 = set_create(&arena);
+  for (usize i = 0; i < n; i++) {
+    sorted[i] = spread(i);
+    set_add(&set1, sorted[i]);
+  }
+  qsort(sorted, n, sizeof(u64), compare_u64);
+
+  // the last member is the first of its block of four in 'sorted', and it is
+  // not a prefix of it because one member is missing
+  const usize last = 1600000;
+  Set set2 = set_create(&arena);
+  for (usize i = 0; i <= last; i++) {
+    if (i != 5) {
+      set_add(&set2, sorted[i]);
+    }
+  }
+  cebus_assert(set2.count % 4 == 0, "");
+
+  Set inter = set_intersection(&set1, &set2, &arena);
+  cebus_assert(inter.count == set2.count, "%" USIZE_FMT, inter.count);
+  cebus_assert(set_eq(&inter, &set2), "should be equal");
+
+  arena_free(&arena);
+}
+
 static bool filter_duplicates(void *set, Str s) { return set_add(set, str_hash(s)); }
 
 static void test_example_deduplicate(void) {
@@ -337,6 +442,9 @@ int main(void) {
   test_intersection();
   test_difference();
   test_set_union();
+  test_set_sorted();
+  test_set_sorted_algebra();
+  test_set_sorted_intersection_end();
 
   test_example_deduplicate();
   test_example_duplicates();
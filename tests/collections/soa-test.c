@@ -0,0 +1,66 @@
+#include "cebus/collection/soa.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/string.h"
+
+#define PARTICLE_FIELDS(X) X(f32, x) X(f32, y) X(u8, alive)
+SOA_DEFINE(Particles, PARTICLE_FIELDS)
+
+#define WORD_COUNT_FIELDS(X) X(Str, word) X(usize, count)
+SOA_DEFINE(WordCounts, WORD_COUNT_FIELDS)
+
+static void test_push_get(void) {
+  Arena arena = {0};
+  Particles particles = soa_new(&arena);
+  cebus_assert(soa_empty(&particles), "Should be empty");
+  for (usize i = 0; i < 100; i++) {
+    Particles_push(&particles, (ParticlesRow){.x = (f32)i, .y = (f32)i * 2, .alive = i % 2});
+  }
+  cebus_assert(soa_len(&particles) == 100, "len: %" USIZE_FMT, soa_len(&particles));
+  cebus_assert(100 <= particles.cap, "cap: %" USIZE_FMT, particles.cap);
+
+  ParticlesRow row = Particles_get(&particles, 42);
+  cebus_assert(row.x == 42 && row.y == 84 && row.alive == 0, "Wrong row");
+
+  // columns can be used directly
+  f32 sum = 0;
+  usize alive = 0;
+  for (usize i = 0; i < soa_len(&particles); i++) {
+    sum += particles.x[i];
+    alive += particles.alive[i];
+  }
+  cebus_assert(sum == 4950, "sum: %f", (double)sum);
+  cebus_assert(alive == 50, "alive: %" USIZE_FMT, alive);
+
+  Particles_set(&particles, 0, (ParticlesRow){.x = -1, .y = -2, .alive = 1});
+  cebus_assert(particles.x[0] == -1 && particles.y[0] == -2, "Set did not write every column");
+
+  soa_clear(&particles);
+  cebus_assert(soa_empty(&particles), "Clear did not remove the rows");
+
+  arena_free(&arena);
+}
+
+static void test_reserve_remove(void) {
+  Arena arena = {0};
+  WordCounts counts = soa_new(&arena);
+  WordCounts_reserve(&counts, 3);
+  const usize cap = counts.cap;
+  WordCounts_push(&counts, (WordCountsRow){.word = STR("a"), .count = 1});
+  WordCounts_push(&counts, (WordCountsRow){.word = STR("b"), .count = 2});
+  WordCounts_push(&counts, (WordCountsRow){.word = STR("c"), .count = 3});
+  cebus_assert(counts.cap == cap, "Reserve did not allocate enough");
+
+  WordCounts_swap_remove(&counts, 0);
+  cebus_assert(soa_len(&counts) == 2, "len: %" USIZE_FMT, soa_len(&counts));
+  WordCountsRow row = WordCounts_get(&counts, 0);
+  cebus_assert(str_eq(row.word, STR("c")) && row.count == 3, "Last row was not moved");
+  cebus_assert(str_eq(counts.word[1], STR("b")) && counts.count[1] == 2, "Wrong second row");
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_push_get();
+  test_reserve_remove();
+}
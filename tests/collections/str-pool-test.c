@@ -0,0 +1,156 @@
+#include "cebus/collection/str_pool.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/os/thread.h"
+#include "cebus/type/string.h"
+
+#include <stdio.h>
+
+static void test_intern(void) {
+  Arena arena = {0};
+  StrPool *pool = str_pool_create(&arena);
+
+  const u32 hello = str_pool_intern(pool, STR("hello"));
+  const u32 world = str_pool_intern(pool, STR("world"));
+  const u32 empty = str_pool_intern(pool, STR(""));
+  cebus_assert(hello == 0 && world == 1 && empty == 2, "ids are not dense");
+  cebus_assert(str_pool_len(pool) == 3, "");
+
+  char buffer[] = "hello world";
+  cebus_assert(str_pool_intern(pool, str_from_parts(5, buffer)) == hello, "");
+  cebus_assert(str_pool_intern(pool, str_from_parts(5, &buffer[6])) == world, "");
+  cebus_assert(str_pool_intern(pool, STR("")) == empty, "");
+  cebus_assert(str_pool_len(pool) == 3, "");
+
+  // the pool owns a copy
+  buffer[0] = 'j';
+  const Str s = str_pool_get(pool, hello);
+  cebus_assert(str_eq(s, STR("hello")), STR_FMT, STR_ARG(s));
+  cebus_assert(s.data[s.len] == '\0', "not terminated");
+  cebus_assert(str_pool_get(pool, empty).len == 0, "");
+  cebus_assert(str_pool_hash(pool, world) == str_hash(STR("world")), "");
+
+  const Str a = str_pool_intern_str(pool, STR("world"));
+  const Str b = str_pool_intern_str(pool, str_from_parts(5, &buffer[6]));
+  cebus_assert(a.data == b.data && a.len == b.len, "not canonical");
+  cebus_assert(a.data == str_pool_get(pool, world).data, "not canonical");
+
+  u32 id = 0;
+  cebus_assert(str_pool_find(pool, STR("world"), &id) && id == world, "");
+  cebus_assert(!str_pool_find(pool, STR("jello"), &id), "");
+  cebus_assert(!str_pool_find(pool, STR("hello world"), NULL), "");
+  cebus_assert(str_pool_len(pool) == 3, "find added a string");
+
+  str_pool_destroy(pool);
+  arena_free(&arena);
+}
+
+static void test_many(void) {
+  Arena arena = {0};
+  StrPool *pool = str_pool_create(&arena);
+
+  // longer than a block, so it gets its own allocation
+  char *long_string = arena_alloc(&arena, 100000);
+  for (usize i = 0; i < 100000; i++) {
+    long_string[i] = (char)('a' + i % 26);
+  }
+  const Str big = str_from_parts(100000, long_string);
+  const u32 big_id = str_pool_intern(pool, big);
+
+  char buffer[32];
+  for (usize i = 0; i < 100000; i++) {
+    const Str s = str_from_parts((usize)snprintf(buffer, sizeof(buffer), "%" USIZE_FMT, i), buffer);
+    cebus_assert(str_pool_intern(pool, s) == i + 1, "%" USIZE_FMT, i);
+  }
+  cebus_assert(str_pool_len(pool) == 100001, "");
+  for (usize i = 0; i < 100000; i += 7) {
+    const Str s = str_from_parts((usize)snprintf(buffer, sizeof(buffer), "%" USIZE_FMT, i), buffer);
+    u32 id = 0;
+    cebus_assert(str_pool_find(pool, s, &id) && id == i + 1, "%" USIZE_FMT, i);
+    cebus_assert(str_eq(str_pool_get(pool, id), s), "%" USIZE_FMT, i);
+  }
+  cebus_assert(str_eq(str_pool_get(pool, big_id), big), "");
+  cebus_assert(str_pool_intern(pool, big) == big_id, "");
+
+  str_pool_destroy(pool);
+  arena_free(&arena);
+}
+
+static void test_batch(void) {
+  Arena arena = {0};
+  StrPool *pool = str_pool_create(&arena);
+  str_pool_reserve(pool, 1000);
+
+  Str text = STR("the quick brown fox jumps over the lazy dog the end");
+  const CharSet space = charset_from_str(STR(" "));
+  DA(Str) words = da_new(&arena);
+  str_split(text, &space, &words);
+
+  u32 ids[16] = {0};
+  str_pool_intern_batch(pool, words.len, words.items, ids);
+  cebus_assert(str_pool_len(pool) == 9, "%" USIZE_FMT, str_pool_len(pool));
+  for (usize i = 0; i < words.len; i++) {
+    cebus_assert(ids[i] == str_pool_intern(pool, words.items[i]), "");
+    cebus_assert(str_eq(str_pool_get(pool, ids[i]), words.items[i]), "");
+  }
+  cebus_assert(ids[0] == 0 && ids[6] == 0 && ids[9] == 0, "'the' has the wrong id");
+  cebus_assert(ids[10] == 8, "");
+
+  str_pool_intern_batch(pool, 0, NULL, NULL);
+  cebus_assert(str_pool_len(pool) == 9, "");
+
+  str_pool_destroy(pool);
+  arena_free(&arena);
+}
+
+typedef struct {
+  StrPool *pool;
+  u32 ids[8][200];
+} SharedCtx;
+
+static void intern_task(void *ctx, usize task) {
+  SharedCtx *c = ctx;
+  char buffer[32];
+  Str strs[200];
+  for (usize i = 0; i < 200; i++) {
+    // every task interns the same strings, in a different order
+    const usize n = (i * 7 + task * 13) % 200;
+    const usize len = (usize)snprintf(buffer, sizeof(buffer), "str-%" USIZE_FMT, n);
+    if (task % 2) {
+      c->ids[task][n] = str_pool_intern(c->pool, str_from_parts(len, buffer));
+    } else {
+      strs[i] = str_pool_intern_str(c->pool, str_from_parts(len, buffer));
+    }
+  }
+  if (task % 2 == 0) {
+    u32 ids[200];
+    str_pool_intern_batch(c->pool, 200, strs, ids);
+    for (usize i = 0; i < 200; i++) {
+      c->ids[task][(i * 7 + task * 13) % 200] = ids[i];
+    }
+  }
+}
+
+static void test_shared(void) {
+  Arena arena = {0};
+  ThreadPool *threads = thread_pool_create(&arena, 4);
+  static SharedCtx ctx;
+  ctx.pool = str_pool_create_shared(&arena);
+  thread_pool_run(threads, 8, intern_task, &ctx);
+  cebus_assert(str_pool_len(ctx.pool) == 200, "%" USIZE_FMT, str_pool_len(ctx.pool));
+  for (usize i = 0; i < 200; i++) {
+    for (usize task = 1; task < 8; task++) {
+      cebus_assert(ctx.ids[task][i] == ctx.ids[0][i], "tasks got different ids");
+    }
+  }
+  str_pool_destroy(ctx.pool);
+  thread_pool_destroy(threads);
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_intern();
+  test_many();
+  test_batch();
+  test_shared();
+}
@@ -0,0 +1,93 @@
+#include "cebus/collection/top_k.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/integer.h"
+
+static void test_topk_exact(void) {
+  Arena arena = {0};
+  TopK topk = topk_create(&arena, 10);
+
+  for (usize i = 0; i < 5; i++) {
+    topk_add(&topk, i, i + 1);
+  }
+  cebus_assert(topk.len == 5, "len: %" USIZE_FMT, topk.len);
+  cebus_assert(topk_min(&topk) == 0, "Tracker is not full");
+  cebus_assert(topk_get(&topk, 3)->count == 4, "Should be counted exactly");
+  cebus_assert(topk_get(&topk, 3)->error == 0, "Should be counted exactly");
+  cebus_assert(topk_get(&topk, 100) == NULL, "Should not be tracked");
+
+  TopKEntry *sorted = topk_sorted(&topk, &arena);
+  for (usize i = 0; i < topk.len; i++) {
+    cebus_assert(sorted[i].hash == 4 - i, "Wrong order at %" USIZE_FMT, i);
+  }
+
+  topk_clear(&topk);
+  cebus_assert(topk.len == 0 && topk_get(&topk, 3) == NULL, "Tracker should be empty");
+
+  arena_free(&arena);
+}
+
+static void test_topk_stream(void) {
+  Arena arena = {0};
+  TopK topk = topk_create(&arena, 20);
+
+  // 10 heavy hitters hidden in a lot of noise
+  u64 noise = 1000;
+  for (usize round = 0; round < 1000; round++) {
+    for (usize i = 0; i < 10; i++) {
+      topk_add(&topk, i, 1);
+    }
+    for (usize i = 0; i < 5; i++) {
+      topk_add(&topk, noise++, 1);
+    }
+  }
+  cebus_assert(topk.len == 20, "len: %" USIZE_FMT, topk.len);
+  cebus_assert(topk.total == 15000, "total: %" U64_FMT, topk.total);
+
+  for (usize i = 0; i < 10; i++) {
+    const TopKEntry *entry = topk_get(&topk, i);
+    cebus_assert(entry != NULL, "Heavy hitter %" USIZE_FMT " should be tracked", i);
+    cebus_assert(entry->count - entry->error <= 1000 && 1000 <= entry->count,
+                 "count %" U64_FMT " error %" U64_FMT, entry->count, entry->error);
+  }
+  TopKEntry *sorted = topk_sorted(&topk, &arena);
+  for (usize i = 0; i < 10; i++) {
+    cebus_assert(sorted[i].hash < 10, "Heavy hitters should be first");
+  }
+
+  TopK copy = topk_copy(&arena, &topk);
+  cebus_assert(copy.len == topk.len && topk_get(&copy, 5)->count == topk_get(&topk, 5)->count,
+               "Copy differs");
+
+  arena_free(&arena);
+}
+
+static void test_topk_merge(void) {
+  Arena arena = {0};
+  TopK shards[2] = {topk_create(&arena, 8), topk_create(&arena, 8)};
+
+  for (usize s = 0; s < 2; s++) {
+    for (usize round = 0; round < 100; round++) {
+      topk_add(&shards[s], 1, 2);
+      topk_add(&shards[s], 2 + s, 1);
+      topk_add(&shards[s], 1000 + s * 1000 + round, 1);
+    }
+  }
+
+  topk_merge(&shards[0], &shards[1]);
+  cebus_assert(shards[0].total == 800, "total: %" U64_FMT, shards[0].total);
+  cebus_assert(shards[0].len == 8, "len: %" USIZE_FMT, shards[0].len);
+  const TopKEntry *entry = topk_get(&shards[0], 1);
+  cebus_assert(entry && entry->count - entry->error <= 400 && 400 <= entry->count,
+               "Heavy hitter should be merged");
+  TopKEntry *sorted = topk_sorted(&shards[0], &arena);
+  cebus_assert(sorted[0].hash == 1, "Most frequent hash should be first");
+
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_topk_exact();
+  test_topk_stream();
+  test_topk_merge();
+}
@@ -3,8 +3,12 @@
 #include "cebus/collection/da.h"
 #include "cebus/core/debug.h"
 #include "cebus/core/defines.h"
+#include "cebus/os/io.h"
+#include "cebus/type/byte.h"
 #include "cebus/type/string.h"
 
+#include <stdio.h>
+
 static void test_file(void) {
   Arena arena = {0};
 
@@ -36,6 +40,35 @@ static void test_file(void) {
   arena_free(&arena);
 }
 
+static void test_file_hash(void) {
+  Arena arena = {0};
+  Error *PANIC = ErrPanic;
+
+  // Larger than the chunks 'fs_file_hash' reads.
+  const usize size = 100 * 1000;
+  u8 *data = arena_alloc(&arena, size);
+  for (usize i = 0; i < size; i++) {
+    data[i] = (u8)(i * 31 + i / 256);
+  }
+  Path filename = PATH("__test_hash_");
+  fs_file_write_bytes(filename, bytes_from_parts(size, data), PANIC);
+
+  const u64 hash = fs_file_hash(filename, PANIC);
+  cebus_assert(hash == bytes_hash(bytes_from_parts(size, data)), "file hash is wrong");
+  fs_remove(filename, PANIC);
+
+  Error error = ErrNew;
+  fs_file_hash(filename, &error);
+  bool failed = false;
+  error_context(&error, {
+    failed = true;
+    error_except();
+  });
+  cebus_assert(failed, "hashing a missing file should fail");
+
+  arena_free(&arena);
+}
+
 static bool filter(FsEntity *entity) {
   return !entity->is_dir && (str_startswith(entity->path, STR(".h")));
 }
@@ -66,7 +99,28 @@ static void test_iter(void) {
   error_context(&err, { error_panic(); });
 }
 
+static void test_write_replace(void) {
+  Arena arena = {0};
+  Error *PANIC = ErrPanic;
+  Path filename = PATH("__test_replace_");
+
+  FILE *file = fopen(filename.data, "wb");
+  cebus_assert(file != NULL, "Could not open file");
+  io_write_replace(file, STR("a {x} b {x}"), STR("{x}"), STR("42"), PANIC);
+  io_write_replace_ignorecase(file, STR(", Foo fOO"), STR("foo"), STR("bar"), PANIC);
+  fclose(file);
+
+  Bytes content = fs_file_read_bytes(filename, &arena, PANIC);
+  cebus_assert(str_eq(str_from_bytes(content), STR("a 42 b 42, bar bar")), STR_FMT,
+               STR_ARG(str_from_bytes(content)));
+  fs_remove(filename, PANIC);
+
+  arena_free(&arena);
+}
+
 int main(void) {
   test_file();
+  test_file_hash();
   test_iter();
+  test_write_replace();
 }
@@ -0,0 +1,70 @@
+#include "cebus/os/thread.h"
+
+#include "cebus/core/debug.h"
+
+#include <string.h>
+
+typedef struct {
+  u64 *values;
+} SquareCtx;
+
+static void square(void *ctx, usize task) {
+  SquareCtx *c = ctx;
+  c->values[task] = (u64)task * (u64)task;
+}
+
+static void test_run(void) {
+  Arena arena = {0};
+  u64 values[1000] = {0};
+  SquareCtx ctx = {.values = values};
+
+  for (usize threads = 1; threads <= 4; threads++) {
+    ThreadPool *pool = thread_pool_create(&arena, threads);
+    cebus_assert(thread_pool_threads(pool) == threads, "pool has the wrong number of threads");
+    for (usize job = 0; job < 10; job++) {
+      memset(values, 0, sizeof(values));
+      thread_pool_run(pool, 1000, square, &ctx);
+      for (usize i = 0; i < 1000; i++) {
+        cebus_assert(values[i] == i * i, "task %" USIZE_FMT " was not run", i);
+      }
+    }
+    thread_pool_run(pool, 0, square, &ctx);
+    thread_pool_destroy(pool);
+  }
+
+  ThreadPool *pool = thread_pool_create(&arena, 0);
+  cebus_assert(1 <= thread_pool_threads(pool), "pool needs at least one thread");
+  thread_pool_destroy(pool);
+
+  arena_free(&arena);
+}
+
+typedef struct {
+  ThreadLock *lock;
+  u64 total;
+} SumCtx;
+
+static void sum(void *ctx, usize task) {
+  SumCtx *c = ctx;
+  for (usize i = 0; i < 100; i++) {
+    thread_lock_acquire(c->lock);
+    c->total += task;
+    thread_lock_release(c->lock);
+  }
+}
+
+static void test_lock(void) {
+  Arena arena = {0};
+  ThreadPool *pool = thread_pool_create(&arena, 4);
+  SumCtx ctx = {.lock = thread_lock_create(&arena)};
+  thread_pool_run(pool, 1000, sum, &ctx);
+  cebus_assert(ctx.total == 100 * (999 * 1000 / 2), "%" U64_FMT, ctx.total);
+  thread_lock_destroy(ctx.lock);
+  thread_pool_destroy(pool);
+  arena_free(&arena);
+}
+
+int main(void) {
+  test_run();
+  test_lock();
+}
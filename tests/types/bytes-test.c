@@ -3,6 +3,9 @@
 #include "cebus/core/debug.h"
 #include "cebus/type/string.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 static void test_bytes(void) {
   Arena arena = {0};
   Bytes b = BYTES(0x02, 0xFF, 0xAA, 0xBB, 0x41, 0x41, 0x41);
@@ -106,6 +109,174 @@ static void test_bytes_hash(void) {
   cebus_assert(bytes_hash(b1) != bytes_hash(b3), "should not be equal");
 }
 
+static void test_bytes_hash_vectors(void) {
+  const struct {
+    Bytes bytes;
+    u64 seed;
+    u64 hash;
+  } tests[] = {
+      {BYTES_STR(""), 0, 0xef46db3751d8e999},
+      {BYTES_STR("a"), 0, 0xd24ec4f1a98c6e5b},
+      {BYTES_STR("abc"), 0, 0x44bc2cf5ad770999},
+      {BYTES_STR("xxhash"), 20141025, 0xb559b98d844e0635},
+      {BYTES_STR("Nobody inspects the spammish repetition"), 0, 0xfbcea83c8a378bf1},
+  };
+  for (usize i = 0; i < ARRAY_LEN(tests); i++) {
+    const u64 hash = bytes_hash_seed(tests[i].bytes, tests[i].seed);
+    cebus_assert(hash == tests[i].hash, "%" USIZE_FMT ": has 0x%" U64_HEX " expected 0x%" U64_HEX,
+                 i, hash, tests[i].hash);
+  }
+
+  u8 data[100];
+  for (usize i = 0; i < sizeof(data); i++) {
+    data[i] = (u8)(i * 7);
+  }
+  const Bytes bytes = bytes_from_parts(sizeof(data), data);
+  cebus_assert(bytes_hash(bytes) == 0x8e2272c08247d5db, "wrong hash for 100 bytes");
+  cebus_assert(bytes_hash_seed(bytes, 42) == 0x9bb39a008c03147c, "wrong seeded hash");
+}
+
+static u64 test_random(u64 *state) {
+  *state = *state * 6364136223846793005ULL + 1442695040888963407ULL;
+  return *state >> 11 ^ *state << 23;
+}
+
+// Flipping any input bit should flip every output bit with a probability of
+// about one half.
+static void test_bytes_hash_avalanche(void) {
+  const usize lengths[] = {4, 8, 16, 31, 64};
+  const usize samples = 200;
+  u64 state = 42;
+  for (usize l = 0; l < ARRAY_LEN(lengths); l++) {
+    const usize len = lengths[l];
+    static usize flips[64 * 8][64];
+    memset(flips, 0, sizeof(flips));
+    for (usize s = 0; s < samples; s++) {
+      u8 key[64];
+      for (usize i = 0; i < len; i++) {
+        key[i] = (u8)test_random(&state);
+      }
+      const u64 hash = bytes_hash(bytes_from_parts(len, key));
+      for (usize bit = 0; bit < len * 8; bit++) {
+        key[bit / 8] ^= (u8)(1 << bit % 8);
+        const u64 diff = hash ^ bytes_hash(bytes_from_parts(len, key));
+        key[bit / 8] ^= (u8)(1 << bit % 8);
+        for (usize out = 0; out < 64; out++) {
+          flips[bit][out] += diff >> out & 1;
+        }
+      }
+    }
+    for (usize bit = 0; bit < len * 8; bit++) {
+      for (usize out = 0; out < 64; out++) {
+        const usize count = flips[bit][out];
+        cebus_assert(samples * 3 / 10 < count && count < samples * 7 / 10,
+                     "len %" USIZE_FMT ": input bit %" USIZE_FMT " flips output bit %" USIZE_FMT
+                     " %" USIZE_FMT " times",
+                     len, bit, out, count);
+      }
+    }
+  }
+}
+
+static int test_compare_u64(const void *a, const void *b) {
+  const u64 x = *(const u64 *)a;
+  const u64 y = *(const u64 *)b;
+  return (x > y) - (x < y);
+}
+
+// Keys with only one or two bits set should not collide.
+static void test_bytes_hash_sparse(void) {
+  enum { BITS = 32 * 8 };
+  static u64 hashes[BITS + BITS * (BITS - 1) / 2];
+  usize count = 0;
+  u8 key[32] = {0};
+  for (usize a = 0; a < BITS; a++) {
+    key[a / 8] ^= (u8)(1 << a % 8);
+    hashes[count++] = bytes_hash(bytes_from_parts(sizeof(key), key));
+    for (usize b = a + 1; b < BITS; b++) {
+      key[b / 8] ^= (u8)(1 << b % 8);
+      hashes[count++] = bytes_hash(bytes_from_parts(sizeof(key), key));
+      key[b / 8] ^= (u8)(1 << b % 8);
+    }
+    key[a / 8] ^= (u8)(1 << a % 8);
+  }
+  qsort(hashes, count, sizeof(u64), test_compare_u64);
+  for (usize i = 1; i < count; i++) {
+    cebus_assert(hashes[i - 1] != hashes[i], "sparse keys collide");
+  }
+}
+
+// Sequential keys should spread evenly over the high bits, that power of two
+// tables use.
+static void test_bytes_hash_distribution(void) {
+  usize buckets[256] = {0};
+  const usize keys = 256 * 256;
+  for (u64 i = 0; i < keys; i++) {
+    buckets[bytes_hash(bytes_from_parts(sizeof(i), &i)) >> 56]++;
+  }
+  for (usize i = 0; i < 256; i++) {
+    cebus_assert(192 < buckets[i] && buckets[i] < 320, "bucket %" USIZE_FMT " has %" USIZE_FMT,
+                 i, buckets[i]);
+  }
+
+  const Bytes key = BYTES_STR("seed");
+  cebus_assert(bytes_hash_seed(key, 1) != bytes_hash_seed(key, 2), "seeds should differ");
+  cebus_assert(bytes_hash_seed(key, 0) == bytes_hash(key), "default seed is 0");
+}
+
+static void test_hasher(void) {
+  u8 data[300];
+  for (usize i = 0; i < sizeof(data); i++) {
+    data[i] = (u8)(i * 13 + 7);
+  }
+  // Every split into three pieces has to give the same hash as the whole.
+  const usize sizes[] = {0, 1, 31, 32, 33, 64, 100, 300};
+  for (usize s = 0; s < ARRAY_LEN(sizes); s++) {
+    const usize size = sizes[s];
+    const u64 expected = bytes_hash_seed(bytes_from_parts(size, data), 42);
+    for (usize a = 0; a <= size; a += 7) {
+      for (usize b = a; b <= size; b += 5) {
+        Hasher hasher = hasher_init(42);
+        hasher_update(&hasher, bytes_from_parts(a, data));
+        hasher_update(&hasher, bytes_from_parts(b - a, &data[a]));
+        hasher_update(&hasher, bytes_from_parts(size - b, &data[b]));
+        cebus_assert(hasher_final(&hasher) == expected, "split at %" USIZE_FMT " and %" USIZE_FMT,
+                     a, b);
+      }
+    }
+  }
+
+  Hasher bytewise = hasher_init(0);
+  for (usize i = 0; i < sizeof(data); i++) {
+    hasher_update(&bytewise, bytes_from_parts(1, &data[i]));
+    cebus_assert(hasher_final(&bytewise) == bytes_hash(bytes_from_parts(i + 1, data)),
+                 "byte %" USIZE_FMT, i);
+  }
+
+  // Numbers are hashed as little endian bytes.
+  Hasher number = hasher_init(0);
+  hasher_update_u64(&number, 0x0807060504030201);
+  cebus_assert(hasher_final(&number) == bytes_hash(BYTES(1, 2, 3, 4, 5, 6, 7, 8)), "u64 bytes");
+
+  Hasher h1 = hasher_init(0);
+  hasher_update_str(&h1, STR("ab"));
+  hasher_update_str(&h1, STR("c"));
+  Hasher h2 = hasher_init(0);
+  hasher_update_str(&h2, STR("a"));
+  hasher_update_str(&h2, STR("bc"));
+  cebus_assert(hasher_final(&h1) != hasher_final(&h2), "strings are not separated");
+
+  Hasher f1 = hasher_init(0);
+  hasher_update_i64(&f1, -1);
+  hasher_update_f64(&f1, 1.5);
+  Hasher f2 = hasher_init(0);
+  hasher_update_i64(&f2, -1);
+  hasher_update_f64(&f2, 1.5);
+  cebus_assert(hasher_final(&f1) == hasher_final(&f2), "same fields have the same hash");
+  hasher_update_f64(&f2, 0);
+  cebus_assert(hasher_final(&f1) != hasher_final(&f2), "more fields change the hash");
+}
+
 int main(void) {
   test_bytes();
   test_bytes_str();
@@ -115,4 +286,9 @@ int main(void) {
   test_bytes_take();
   test_bytes_from_hex();
   test_bytes_hash();
+  test_bytes_hash_vectors();
+  test_bytes_hash_avalanche();
+  test_bytes_hash_sparse();
+  test_bytes_hash_distribution();
+  test_hasher();
 }
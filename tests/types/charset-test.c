@@ -0,0 +1,100 @@
+#include "cebus/type/charset.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/char.h"
+#include "cebus/type/string.h"
+
+static bool is_separator(char c) { return c_is_space(c) || c_is_punct(c); }
+
+static bool is_high(char c) { return (u8)c & 0x80; }
+
+static void test_build(void) {
+  bool (*predicates[])(char) = {c_is_space, c_is_digit, c_is_punct, is_separator, is_high};
+  for (usize p = 0; p < ARRAY_LEN(predicates); p++) {
+    const CharSet set = charset_from_predicate(predicates[p]);
+    const CharSet inverted = charset_invert(set);
+    for (usize c = 0; c < 256; c++) {
+      const bool expected = predicates[p]((char)c);
+      cebus_assert(charset_contains(&set, (char)c) == expected, "%" USIZE_FMT, c);
+      cebus_assert(charset_contains(&inverted, (char)c) != expected, "%" USIZE_FMT, c);
+    }
+  }
+
+  const CharSet set = charset_from_str(STR(",; \xff"));
+  cebus_assert(charset_contains(&set, ','), "");
+  cebus_assert(charset_contains(&set, ';'), "");
+  cebus_assert(charset_contains(&set, ' '), "");
+  cebus_assert(charset_contains(&set, '\xff'), "");
+  cebus_assert(!charset_contains(&set, 'a'), "");
+  cebus_assert(!charset_contains(&set, '\0'), "");
+  cebus_assert(!charset_contains(&set, '\x7f'), "");
+
+  const CharSet empty = charset_from_str(STR(""));
+  for (usize c = 0; c < 256; c++) {
+    cebus_assert(!charset_contains(&empty, (char)c), "%" USIZE_FMT, c);
+  }
+}
+
+static void test_span(void) {
+  const CharSet space = charset_from_predicate(c_is_space);
+  const Str s = STR("  \t hello world \n");
+  cebus_assert(charset_span(&space, s) == 4, "");
+  cebus_assert(charset_cspan(&space, s) == 0, "");
+  cebus_assert(charset_rspan(&space, s) == 2, "");
+  cebus_assert(charset_rcspan(&space, s) == 0, "");
+  cebus_assert(charset_count(&space, s) == 7, "");
+
+  const Str word = STR("hello");
+  cebus_assert(charset_span(&space, word) == 0, "");
+  cebus_assert(charset_cspan(&space, word) == 5, "");
+  cebus_assert(charset_rspan(&space, word) == 0, "");
+  cebus_assert(charset_rcspan(&space, word) == 5, "");
+
+  cebus_assert(charset_span(&space, STR("")) == 0, "");
+  cebus_assert(charset_cspan(&space, STR("")) == 0, "");
+  cebus_assert(charset_rspan(&space, STR("")) == 0, "");
+  cebus_assert(charset_count(&space, STR("")) == 0, "");
+}
+
+// Every position in and around a vector, including bytes with the high bit.
+static void test_span_long(void) {
+  const CharSet set = charset_from_str(STR("a\x80\xfe"));
+  const char members[] = {'a', '\x80', '\xfe'};
+  char buffer[100];
+  for (usize len = 0; len <= sizeof(buffer); len++) {
+    for (usize pos = 0; pos < len; pos++) {
+      for (usize m = 0; m < ARRAY_LEN(members); m++) {
+        for (usize i = 0; i < len; i++) {
+          buffer[i] = i % 2 ? 'b' : '\x81';
+        }
+        buffer[pos] = members[m];
+        const Str s = str_from_parts(len, buffer);
+        cebus_assert(charset_cspan(&set, s) == pos, "%" USIZE_FMT, pos);
+        cebus_assert(charset_rcspan(&set, s) == len - pos - 1, "%" USIZE_FMT, pos);
+        cebus_assert(charset_count(&set, s) == 1, "%" USIZE_FMT, pos);
+
+        for (usize i = 0; i < len; i++) {
+          buffer[i] = members[(i + m) % ARRAY_LEN(members)];
+        }
+        buffer[pos] = '\x7f';
+        cebus_assert(charset_span(&set, s) == pos, "%" USIZE_FMT, pos);
+        cebus_assert(charset_rspan(&set, s) == len - pos - 1, "%" USIZE_FMT, pos);
+        cebus_assert(charset_count(&set, s) == len - 1, "%" USIZE_FMT, pos);
+      }
+    }
+    const Str s = str_from_parts(len, buffer);
+    for (usize i = 0; i < len; i++) {
+      buffer[i] = 'a';
+    }
+    cebus_assert(charset_span(&set, s) == len, "");
+    cebus_assert(charset_rspan(&set, s) == len, "");
+    cebus_assert(charset_cspan(&set, s) == 0, "");
+    cebus_assert(charset_count(&set, s) == len, "");
+  }
+}
+
+int main(void) {
+  test_build();
+  test_span();
+  test_span_long();
+}
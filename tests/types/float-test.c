@@ -84,6 +84,35 @@ static void test_f64_math(void) {
   cebus_assert(f64_eq(rad, res), "Rad was not correct");
 }
 
+static void test_f64_exp_ln(void) {
+  const struct {
+    f64 x, exp, ln, sqrt;
+  } tests[] = {
+      {0.5, 1.6487212707001282, -0.6931471805599453, 0.7071067811865476},
+      {1.0, 2.718281828459045, 0.0, 1.0},
+      {2.0, 7.38905609893065, 0.6931471805599453, 1.4142135623730951},
+      {10.0, 22026.465794806718, 2.302585092994046, 3.1622776601683795},
+      {1e-5, 1.00001000005, -11.512925464970229, 0.0031622776601683794},
+  };
+  for (usize i = 0; i < ARRAY_LEN(tests); i++) {
+    const f64 exp = f64_exp(tests[i].x);
+    const f64 ln = f64_ln(tests[i].x);
+    const f64 sqrt = f64_sqrt(tests[i].x);
+    cebus_assert(f64_abs(exp - tests[i].exp) <= 1e-12 * tests[i].exp, "exp(%g) = %.17g",
+                 tests[i].x, exp);
+    cebus_assert(f64_abs(ln - tests[i].ln) <= 1e-12, "ln(%g) = %.17g", tests[i].x, ln);
+    cebus_assert(f64_abs(sqrt - tests[i].sqrt) <= 1e-15 * tests[i].sqrt, "sqrt(%g) = %.17g",
+                 tests[i].x, sqrt);
+  }
+  cebus_assert(f64_exp(-1000) == 0, "");
+  cebus_assert(f64_eq_eps(f64_ln(f64_exp(-100)), -100, 1e-9), "");
+  cebus_assert(f64_eq_eps(f64_ln(5e-320), -735.2178029785398, 1e-9), "subnormal");
+  cebus_assert(f64_ln(0) == -F64_INF, "");
+  cebus_assert(f64_isnan(f64_ln(-1)), "");
+  cebus_assert(f64_eq_eps(f64_sqrt(1e300), 1e150, 1e136), "");
+  cebus_assert(f64_sqrt(0) == 0 && f64_isnan(f64_sqrt(-1)), "");
+}
+
 int main(void) {
   test_f32_eq();
   test_f32_eq_eps();
@@ -96,4 +125,5 @@ int main(void) {
   test_f64_abs();
   test_f64_isnan();
   test_f64_math();
+  test_f64_exp_ln();
 }
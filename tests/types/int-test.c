@@ -50,9 +50,9 @@ static void test_u8_to_bytes(void) {
 }
 
 static void test_u8_hash(void) {
-  cebus_assert(u8_hash(0) == 0x130f353e031ba7, "0x%" U64_HEX, u8_hash(0));
-  cebus_assert(u8_hash(69) == 0x53620494cc400a2, "0x%" U64_HEX, u8_hash(69));
-  cebus_assert(u8_hash(42) == 0x333883cd70fb570, "0x%" U64_HEX, u8_hash(42));
+  cebus_assert(u8_hash(0) == 0xe220a8397b1dcdaf, "0x%" U64_HEX, u8_hash(0));
+  cebus_assert(u8_hash(69) == 0x5351ebfc8b302867, "0x%" U64_HEX, u8_hash(69));
+  cebus_assert(u8_hash(42) == 0xbdd732262feb6e95, "0x%" U64_HEX, u8_hash(42));
 }
 /* u8 */
 
@@ -103,10 +103,10 @@ static void test_i8_to_bytes(void) {
 }
 
 static void test_i8_hash(void) {
-  cebus_assert(i8_hash(0) == 0x130f353e031ba7, "0x%" U64_HEX, i8_hash(0));
-  cebus_assert(i8_hash(69) == 0x53620494cc400a2, "0x%" U64_HEX, i8_hash(69));
-  cebus_assert(i8_hash(-69) == 0xe8a748836a8337d1, "0x%" U64_HEX, i8_hash(-69));
-  cebus_assert(i8_hash(42) == 0x333883cd70fb570, "0x%" U64_HEX, i8_hash(42));
+  cebus_assert(i8_hash(0) == 0xe220a8397b1dcdaf, "0x%" U64_HEX, i8_hash(0));
+  cebus_assert(i8_hash(69) == 0x5351ebfc8b302867, "0x%" U64_HEX, i8_hash(69));
+  cebus_assert(i8_hash(-69) == 0xcd6368ee8362ec8e, "0x%" U64_HEX, i8_hash(-69));
+  cebus_assert(i8_hash(42) == 0xbdd732262feb6e95, "0x%" U64_HEX, i8_hash(42));
 }
 /* i8 */
 
@@ -165,9 +165,9 @@ static void test_u16_to_bytes(void) {
 }
 
 static void test_u16_hash(void) {
-  cebus_assert(u16_hash(0) == 0x130f353e031ba7, "0x%" U64_HEX, u16_hash(0));
-  cebus_assert(u16_hash(69) == 0x53620494cc400a2, "0x%" U64_HEX, u16_hash(69));
-  cebus_assert(u16_hash(42) == 0x333883cd70fb570, "0x%" U64_HEX, u16_hash(42));
+  cebus_assert(u16_hash(0) == 0xe220a8397b1dcdaf, "0x%" U64_HEX, u16_hash(0));
+  cebus_assert(u16_hash(69) == 0x5351ebfc8b302867, "0x%" U64_HEX, u16_hash(69));
+  cebus_assert(u16_hash(42) == 0xbdd732262feb6e95, "0x%" U64_HEX, u16_hash(42));
 }
 /* u16 */
 
@@ -226,9 +226,9 @@ static void test_i16_to_bytes(void) {
 }
 
 static void test_i16_hash(void) {
-  cebus_assert(i16_hash(0) == 0x130f353e031ba7, "0x%" U64_HEX, i16_hash(0));
-  cebus_assert(i16_hash(69) == 0x53620494cc400a2, "0x%" U64_HEX, i16_hash(69));
-  cebus_assert(i16_hash(42) == 0x333883cd70fb570, "0x%" U64_HEX, i16_hash(42));
+  cebus_assert(i16_hash(0) == 0xe220a8397b1dcdaf, "0x%" U64_HEX, i16_hash(0));
+  cebus_assert(i16_hash(69) == 0x5351ebfc8b302867, "0x%" U64_HEX, i16_hash(69));
+  cebus_assert(i16_hash(42) == 0xbdd732262feb6e95, "0x%" U64_HEX, i16_hash(42));
 }
 /* i16 */
 
@@ -291,9 +291,9 @@ static void test_u32_to_bytes(void) {
 }
 
 static void test_u32_hash(void) {
-  cebus_assert(u32_hash(0) == 0x130f353e031ba7, "0x%" U64_HEX, u32_hash(0));
-  cebus_assert(u32_hash(69) == 0x53620494cc400a2, "0x%" U64_HEX, u32_hash(69));
-  cebus_assert(u32_hash(42) == 0x333883cd70fb570, "0x%" U64_HEX, u32_hash(42));
+  cebus_assert(u32_hash(0) == 0xe220a8397b1dcdaf, "0x%" U64_HEX, u32_hash(0));
+  cebus_assert(u32_hash(69) == 0x5351ebfc8b302867, "0x%" U64_HEX, u32_hash(69));
+  cebus_assert(u32_hash(42) == 0xbdd732262feb6e95, "0x%" U64_HEX, u32_hash(42));
 }
 /* u32 */
 
@@ -356,9 +356,9 @@ static void test_i32_to_bytes(void) {
 }
 
 static void test_i32_hash(void) {
-  cebus_assert(i32_hash(0) == 0x130f353e031ba7, "0x%" U64_HEX, i32_hash(0));
-  cebus_assert(i32_hash(69) == 0x53620494cc400a2, "0x%" U64_HEX, i32_hash(69));
-  cebus_assert(i32_hash(42) == 0x333883cd70fb570, "0x%" U64_HEX, i32_hash(42));
+  cebus_assert(i32_hash(0) == 0xe220a8397b1dcdaf, "0x%" U64_HEX, i32_hash(0));
+  cebus_assert(i32_hash(69) == 0x5351ebfc8b302867, "0x%" U64_HEX, i32_hash(69));
+  cebus_assert(i32_hash(42) == 0xbdd732262feb6e95, "0x%" U64_HEX, i32_hash(42));
 }
 /* i32 */
 
@@ -430,9 +430,70 @@ static void test_u64_to_bytes(void) {
 }
 
 static void test_u64_hash(void) {
-  cebus_assert(u64_hash(0) == 0x130f353e031ba7, "0x%" U64_HEX, u64_hash(0));
-  cebus_assert(u64_hash(69) == 0x53620494cc400a2, "0x%" U64_HEX, u64_hash(69));
-  cebus_assert(u64_hash(42) == 0x333883cd70fb570, "0x%" U64_HEX, u64_hash(42));
+  cebus_assert(u64_hash(0) == 0xe220a8397b1dcdaf, "0x%" U64_HEX, u64_hash(0));
+  cebus_assert(u64_hash(69) == 0x5351ebfc8b302867, "0x%" U64_HEX, u64_hash(69));
+  cebus_assert(u64_hash(42) == 0xbdd732262feb6e95, "0x%" U64_HEX, u64_hash(42));
+}
+
+static void test_u64_hash_seed(void) {
+  cebus_assert(u64_hash_seed(42, 0) == u64_hash(42), "seed 0 should be the default");
+  cebus_assert(u64_hash_seed(42, 1) != u64_hash_seed(42, 2), "seeds should differ");
+
+  // The values, that the hash tables remap, must not map to themselves.
+  const u64 special[] = {0, 0xdeaddeaddeaddead};
+  for (usize i = 0; i < ARRAY_LEN(special); i++) {
+    const u64 hash = u64_hash(special[i]);
+    cebus_assert(hash != 0 && hash != 0xdeaddeaddeaddead, "0x%" U64_HEX, hash);
+  }
+
+  u64 values[103];
+  u64 hashes[103];
+  for (usize i = 0; i < ARRAY_LEN(values); i++) {
+    values[i] = i * i * 0x9e3779b9;
+  }
+  u64_hash_batch(ARRAY_LEN(values), values, hashes, 1234);
+  for (usize i = 0; i < ARRAY_LEN(values); i++) {
+    cebus_assert(hashes[i] == u64_hash_seed(values[i], 1234), "batch %" USIZE_FMT, i);
+  }
+
+  // the sketches derive their indices from it, so it must not change
+  cebus_assert(u64_mix(0) == 0, "0x%" U64_HEX, u64_mix(0));
+  cebus_assert(u64_mix(1) == 0xb456bcfc34c2cb2c, "0x%" U64_HEX, u64_mix(1));
+  cebus_assert(u64_mix(42) == 0x810879608e4259cc, "0x%" U64_HEX, u64_mix(42));
+}
+
+// Sequential keys spread evenly over the high and the low bits, and flipping an
+// input bit flips every output bit about half of the time.
+static void test_u64_hash_distribution(void) {
+  usize high[256] = {0};
+  usize low[256] = {0};
+  const u64 keys = 256 * 256;
+  for (u64 i = 0; i < keys; i++) {
+    const u64 hash = u64_hash(i);
+    high[hash >> 56]++;
+    low[hash & 0xff]++;
+  }
+  for (usize i = 0; i < 256; i++) {
+    cebus_assert(192 < high[i] && high[i] < 320, "high %" USIZE_FMT ": %" USIZE_FMT, i, high[i]);
+    cebus_assert(192 < low[i] && low[i] < 320, "low %" USIZE_FMT ": %" USIZE_FMT, i, low[i]);
+  }
+
+  const usize samples = 1000;
+  for (usize bit = 0; bit < 64; bit++) {
+    usize flips[64] = {0};
+    for (u64 s = 0; s < samples; s++) {
+      const u64 value = u64_hash(s + bit * samples);
+      const u64 diff = u64_hash(value) ^ u64_hash(value ^ (1ULL << bit));
+      for (usize out = 0; out < 64; out++) {
+        flips[out] += diff >> out & 1;
+      }
+    }
+    for (usize out = 0; out < 64; out++) {
+      cebus_assert(400 < flips[out] && flips[out] < 600,
+                   "input bit %" USIZE_FMT " flips output bit %" USIZE_FMT " %" USIZE_FMT " times",
+                   bit, out, flips[out]);
+    }
+  }
 }
 /* u64 */
 
@@ -504,9 +565,9 @@ static void test_i64_to_bytes(void) {
 }
 
 static void test_i64_hash(void) {
-  cebus_assert(i64_hash(0) == 0x130f353e031ba7, "0x%" U64_HEX, i64_hash(0));
-  cebus_assert(i64_hash(69) == 0x53620494cc400a2, "0x%" U64_HEX, i64_hash(69));
-  cebus_assert(i64_hash(42) == 0x333883cd70fb570, "0x%" U64_HEX, i64_hash(42));
+  cebus_assert(i64_hash(0) == 0xe220a8397b1dcdaf, "0x%" U64_HEX, i64_hash(0));
+  cebus_assert(i64_hash(69) == 0x5351ebfc8b302867, "0x%" U64_HEX, i64_hash(69));
+  cebus_assert(i64_hash(42) == 0xbdd732262feb6e95, "0x%" U64_HEX, i64_hash(42));
 }
 /* i64 */
 
@@ -566,6 +627,8 @@ int main(void) {
   test_u64_from_bytes();
   test_u64_to_bytes();
   test_u64_hash();
+  test_u64_hash_seed();
+  test_u64_hash_distribution();
 
   test_i64_leading_bits();
   test_i64_swaping_bits();
@@ -0,0 +1,172 @@
+#include "cebus/type/numeric.h"
+
+#include "cebus/core/debug.h"
+#include "cebus/type/float.h"
+
+// odd counts, so the scalar tails are used too
+#define COUNT 1003
+
+static void test_sum(void) {
+  f32 f32s[COUNT];
+  f64 f64s[COUNT];
+  i64 i64s[COUNT];
+  u64 u64s[COUNT];
+  for (usize i = 0; i < COUNT; i++) {
+    f32s[i] = (f32)i;
+    f64s[i] = (f64)i;
+    i64s[i] = (i64)i - 500;
+    u64s[i] = i;
+  }
+  const usize expected = COUNT * (COUNT - 1) / 2;
+  cebus_assert(f32_eq(f32_sum(COUNT, f32s), (f32)expected), "f32 sum is not correct");
+  cebus_assert(f64_eq(f64_sum(COUNT, f64s), (f64)expected), "f64 sum is not correct");
+  cebus_assert(i64_sum(COUNT, i64s) == (i64)expected - 500 * COUNT, "i64 sum is not correct");
+  cebus_assert(u64_sum(COUNT, u64s) == expected, "u64 sum is not correct");
+
+  cebus_assert(f64_sum(0, f64s) == 0, "empty sum should be 0");
+  cebus_assert(u64_sum(3, u64s) == 3, "short sum is not correct");
+
+  const u64 wrap[] = {U64_MAX, 2};
+  cebus_assert(u64_sum(2, wrap) == 1, "u64 sum should wrap around");
+}
+
+static void test_minmax(void) {
+  f64 f64s[COUNT];
+  i64 i64s[COUNT];
+  u64 u64s[COUNT];
+  for (usize i = 0; i < COUNT; i++) {
+    const i64 value = (i64)((i * 7919) % COUNT) - 300;
+    f64s[i] = (f64)value;
+    i64s[i] = value;
+    u64s[i] = (u64)value;
+  }
+  f64 f64_lo, f64_hi;
+  cebus_assert(f64_minmax(COUNT, f64s, &f64_lo, &f64_hi), "should find values");
+  cebus_assert(f64_eq(f64_lo, -300) && f64_eq(f64_hi, COUNT - 301), "f64 minmax is not correct");
+
+  i64 i64_lo, i64_hi;
+  cebus_assert(i64_minmax(COUNT, i64s, &i64_lo, &i64_hi), "should find values");
+  cebus_assert(i64_lo == -300 && i64_hi == COUNT - 301, "i64 minmax is not correct");
+
+  // the negative values are the biggest unsigned values
+  u64 u64_lo, u64_hi;
+  cebus_assert(u64_minmax(COUNT, u64s, &u64_lo, &u64_hi), "should find values");
+  cebus_assert(u64_lo == 0 && u64_hi == U64_MAX, "u64 minmax is not correct");
+
+  f32 f32s[] = {3, -1, 2};
+  f32 f32_lo, f32_hi;
+  cebus_assert(f32_minmax(3, f32s, &f32_lo, &f32_hi), "should find values");
+  cebus_assert(f32_eq(f32_lo, -1) && f32_eq(f32_hi, 3), "f32 minmax is not correct");
+
+  cebus_assert(!f32_minmax(0, f32s, &f32_lo, &f32_hi), "empty array has no minmax");
+}
+
+static void test_dot(void) {
+  f32 f32s[COUNT];
+  f64 f64s[COUNT];
+  i64 i64s[COUNT];
+  u64 u64s[COUNT];
+  u64 expected = 0;
+  for (usize i = 0; i < COUNT; i++) {
+    const usize value = i % 10;
+    f32s[i] = (f32)value;
+    f64s[i] = (f64)value;
+    i64s[i] = -(i64)value;
+    u64s[i] = value;
+    expected += value * value;
+  }
+  cebus_assert(f32_eq(f32_dot(COUNT, f32s, f32s), (f32)expected), "f32 dot is not correct");
+  cebus_assert(f64_eq(f64_dot(COUNT, f64s, f64s), (f64)expected), "f64 dot is not correct");
+  cebus_assert(i64_dot(COUNT, i64s, i64s) == (i64)expected, "i64 dot is not correct");
+  cebus_assert(u64_dot(COUNT, u64s, u64s) == expected, "u64 dot is not correct");
+}
+
+static void test_prefix_sum(void) {
+  f32 f32s[COUNT];
+  f64 f64s[COUNT];
+  i64 i64s[COUNT];
+  for (usize i = 0; i < COUNT; i++) {
+    f32s[i] = (f32)(i % 3);
+    f64s[i] = (f64)i;
+    i64s[i] = i % 2 ? -1 : 2;
+  }
+  f32 f32_out[COUNT];
+  f32_prefix_sum(COUNT, f32s, f32_out);
+  f64_prefix_sum(COUNT, f64s, f64s);
+  i64_prefix_sum(COUNT, i64s, i64s);
+
+  f32 f32_expected = 0;
+  i64 i64_expected = 0;
+  for (usize i = 0; i < COUNT; i++) {
+    f32_expected += (f32)(i % 3);
+    i64_expected += i % 2 ? -1 : 2;
+    cebus_assert(f32_eq(f32_out[i], f32_expected), "f32 prefix sum is not correct");
+    cebus_assert(f64_eq(f64s[i], (f64)(i * (i + 1) / 2)), "f64 prefix sum is not correct");
+    cebus_assert(i64s[i] == i64_expected, "i64 prefix sum is not correct");
+  }
+
+  u64 u64s[] = {1, 2, 3};
+  u64_prefix_sum(3, u64s, u64s);
+  cebus_assert(u64s[0] == 1 && u64s[1] == 3 && u64s[2] == 6, "u64 prefix sum is not correct");
+}
+
+static void test_histogram(void) {
+  f64 f64s[COUNT];
+  i64 i64s[COUNT];
+  for (usize i = 0; i < COUNT; i++) {
+    f64s[i] = (f64)i / 10;
+    i64s[i] = (i64)i - 3;
+  }
+
+  usize counts[1000] = {0};
+  f64_histogram(COUNT, f64s, 0, 100, 10, counts);
+  for (usize i = 0; i < 10; i++) {
+    cebus_assert(counts[i] == 100, "f64 histogram is not correct");
+  }
+
+  // 1000 values in [0, 1000), the bins start at 0, 334 and 667
+  usize small[3] = {0};
+  i64_histogram(COUNT, i64s, 0, 1000, 3, small);
+  cebus_assert(small[0] == 334 && small[1] == 333 && small[2] == 333,
+               "i64 histogram is not correct");
+
+  // every bin gets a value, even if the range is just above a multiple
+  const i64 five[] = {-2, -1, 0, 1, 2};
+  usize four[4] = {0};
+  i64_histogram(ARRAY_LEN(five), five, -2, 3, 4, four);
+  cebus_assert(four[0] == 2 && four[1] == 1 && four[2] == 1 && four[3] == 1,
+               "i64 histogram is not correct");
+
+  // 'offset * bins' does not fit into 64 bits
+  const u64 huge[] = {0, U64_MAX / 3 - 1, U64_MAX / 3, U64_MAX / 3 + 1, U64_MAX - 1};
+  usize thirds[3] = {0};
+  u64_histogram(ARRAY_LEN(huge), huge, 0, U64_MAX, 3, thirds);
+  cebus_assert(thirds[0] == 2 && thirds[1] == 2 && thirds[2] == 1,
+               "u64 histogram is not correct");
+
+  // more bins than the local histograms
+  usize big[1000] = {0};
+  u64 u64s[COUNT];
+  for (usize i = 0; i < COUNT; i++) {
+    u64s[i] = i;
+  }
+  u64_histogram(COUNT, u64s, 0, 1000, 1000, big);
+  for (usize i = 0; i < 1000; i++) {
+    cebus_assert(big[i] == 1, "u64 histogram is not correct");
+  }
+
+  // counts are added
+  f32 f32s[] = {0.5f, 1.5f, 2.5f, 2.9f, 3.f};
+  usize f32_counts[3] = {1, 1, 1};
+  f32_histogram(5, f32s, 0, 3, 3, f32_counts);
+  cebus_assert(f32_counts[0] == 2 && f32_counts[1] == 2 && f32_counts[2] == 3,
+               "f32 histogram is not correct");
+}
+
+int main(void) {
+  test_sum();
+  test_minmax();
+  test_dot();
+  test_prefix_sum();
+  test_histogram();
+}
@@ -5,7 +5,9 @@
 #include "cebus/core/debug.h"
 #include "cebus/type/string.h"
 
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 static void test_compare(void) {
   Str s = STR("Hello, World");
@@ -133,6 +135,96 @@ static void test_chop_right(void) {
   cebus_assert(str_eq(rest3, STR("")), "");
 }
 
+static bool is_separator(char c) { return c_is_space(c) || c_is_punct(c); }
+
+static void test_charset(void) {
+  const CharSet separators = charset_from_predicate(is_separator);
+  const Str texts[] = {
+      STR(""),
+      STR("word"),
+      STR("  Hello, World!  "),
+      STR(",leading and trailing,"),
+      STR("/* a comment */ int main(void) { return 0; }\n\n"),
+      STR("a much longer line of text, so the scan goes over more than a single vector; "
+          "with-some-punctuation... and\ttabs\nand newlines"),
+  };
+  for (usize i = 0; i < ARRAY_LEN(texts); i++) {
+    const Str text = texts[i];
+    cebus_assert(str_eq(str_trim_by_charset(text, &separators),
+                        str_trim_by_predicate(text, is_separator)),
+                 "");
+    cebus_assert(str_eq(str_trim_left_by_charset(text, &separators),
+                        str_trim_left_by_predicate(text, is_separator)),
+                 "");
+    cebus_assert(str_eq(str_trim_right_by_charset(text, &separators),
+                        str_trim_right_by_predicate(text, is_separator)),
+                 "");
+
+    Str a = text;
+    Str b = text;
+    Str chunk_a = {0};
+    Str chunk_b = {0};
+    while (true) {
+      const bool more = str_try_chop_by_charset(&a, &separators, &chunk_a);
+      cebus_assert(more == str_try_chop_by_predicate(&b, is_separator, &chunk_b), "");
+      if (!more) {
+        break;
+      }
+      cebus_assert(str_eq(chunk_a, chunk_b), STR_FMT, STR_ARG(chunk_a));
+      cebus_assert(a.data == b.data && a.len == b.len, "");
+    }
+
+    a = text;
+    b = text;
+    do {
+      chunk_a = str_chop_by_charset(&a, &separators);
+      chunk_b = str_chop_by_predicate(&b, is_separator);
+      cebus_assert(str_eq(chunk_a, chunk_b), STR_FMT, STR_ARG(chunk_a));
+      cebus_assert(a.data == b.data && a.len == b.len, "");
+    } while (a.len);
+
+    a = text;
+    b = text;
+    do {
+      chunk_a = str_chop_right_by_charset(&a, &separators);
+      chunk_b = str_chop_right_by_predicate(&b, is_separator);
+      cebus_assert(str_eq(chunk_a, chunk_b), STR_FMT, STR_ARG(chunk_a));
+      cebus_assert(a.data == b.data && a.len == b.len, "");
+    } while (a.len);
+  }
+
+  const CharSet vowels = charset_from_str(STR("aeiou"));
+  cebus_assert(str_count_by_charset(STR("the quick brown fox"), &vowels) == 5, "");
+  cebus_assert(str_count_by_charset(STR(""), &vowels) == 0, "");
+}
+
+static void test_split(void) {
+  Arena arena = {0};
+  const CharSet separators = charset_from_str(STR(" ,\n"));
+
+  DA(Str) fields = {0};
+  da_init(&fields, &arena);
+  str_split(STR("  alpha, beta,,gamma\n delta  "), &separators, &fields);
+  cebus_assert(fields.len == 4, "%" USIZE_FMT, fields.len);
+  cebus_assert(str_eq(fields.items[0], STR("alpha")), "");
+  cebus_assert(str_eq(fields.items[1], STR("beta")), "");
+  cebus_assert(str_eq(fields.items[2], STR("gamma")), "");
+  cebus_assert(str_eq(fields.items[3], STR("delta")), "");
+
+  // appends to the list
+  str_split(STR("epsilon"), &separators, &fields);
+  cebus_assert(fields.len == 5, "%" USIZE_FMT, fields.len);
+  cebus_assert(str_eq(fields.items[4], STR("epsilon")), "");
+
+  da_clear(&fields);
+  str_split(STR(""), &separators, &fields);
+  cebus_assert(fields.len == 0, "");
+  str_split(STR(" ,\n "), &separators, &fields);
+  cebus_assert(fields.len == 0, "");
+
+  arena_free(&arena);
+}
+
 static void test_number_converting(void) {
   Arena arena = {0};
 
@@ -158,6 +250,184 @@ static void test_number_converting(void) {
   arena_free(&arena);
 }
 
+static void test_chop_numbers(void) {
+  const struct {
+    Str s;
+    i64 value;
+    usize rest;
+  } integers[] = {
+      {STR("  -42 apples"), -42, 7},
+      {STR("+7"), 7, 0},
+      {STR("12345678901234567"), 12345678901234567, 0},
+      {STR("0000000000000000000000001x"), 1, 1},
+      {STR("9223372036854775807"), I64_MAX, 0},
+      {STR("-9223372036854775808"), I64_MIN, 0},
+      {STR("99999999999999999999"), I64_MAX, 0},
+      {STR("-99999999999999999999"), I64_MIN, 0},
+      {STR("x1"), 0, 2},
+      {STR("-"), 0, 1},
+      {STR(""), 0, 0},
+  };
+  for (usize i = 0; i < ARRAY_LEN(integers); i++) {
+    Str s = integers[i].s;
+    const i64 value = str_chop_i64(&s);
+    cebus_assert(value == integers[i].value, "%" USIZE_FMT ": %" I64_FMT, i, value);
+    cebus_assert(s.len == integers[i].rest, "%" USIZE_FMT ": " STR_FMT, i, STR_ARG(s));
+  }
+
+  cebus_assert(str_u64(STR("18446744073709551615")) == U64_MAX, "");
+  cebus_assert(str_u64(STR("18446744073709551616")) == U64_MAX, "");
+  cebus_assert(str_u64(STR("1234567890123456789")) == 1234567890123456789, "");
+
+  Str f = STR(" 1.5e3ms");
+  cebus_assert(str_chop_f64(&f) == 1500, "");
+  cebus_assert(str_eq(f, STR("ms")), STR_FMT, STR_ARG(f));
+  Str e = STR("2e");
+  cebus_assert(str_chop_f64(&e) == 2, "");
+  cebus_assert(str_eq(e, STR("e")), STR_FMT, STR_ARG(e));
+  cebus_assert(str_f64(STR("-inf")) < 0 && str_f64(STR("-inf")) * 0 != 0, "");
+  const f64 nan = str_f64(STR("nan"));
+  cebus_assert(nan != nan, "");
+  cebus_assert(str_f64(STR("0x10")) == 16, "");
+  cebus_assert(str_f64(STR(".5")) == 0.5, "");
+  cebus_assert(str_f64(STR("-0")) == 0, "");
+}
+
+// The fast paths have to give exactly the same bits as 'strtod'.
+static void test_f64_exact(void) {
+  const char *formats[] = {"%.17g", "%.6f", "%.3e", "%.15g", "%.2f", "%.20g"};
+  u64 state = 0x123456789;
+  for (usize i = 0; i < 20000; i++) {
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    f64 value;
+    if (i % 2) {
+      u64 bits = state;
+      memcpy(&value, &bits, sizeof(value));
+      if (value != value || value - value != 0) {
+        continue;
+      }
+    } else {
+      value = (f64)(state >> 20) / (f64)(1 << (state % 30));
+    }
+    char buffer[64];
+    snprintf(buffer, sizeof(buffer), formats[i % ARRAY_LEN(formats)], value);
+    const f64 expected = strtod(buffer, NULL);
+    const f64 parsed = str_f64(str_from_cstr(buffer));
+    cebus_assert(memcmp(&parsed, &expected, sizeof(f64)) == 0, "%s: %.17g", buffer, parsed);
+  }
+
+  const char *cases[] = {
+      "0.1",
+      "9007199254740993",
+      "1e23",
+      "1.7976931348623157e308",
+      "4.9e-324",
+      "2.2250738585072014e-308",
+      "123456789012345678901234567890",
+      "0.000000000000000000000000000001",
+      "1e-400",
+      "3.14159",
+  };
+  for (usize i = 0; i < ARRAY_LEN(cases); i++) {
+    const f64 expected = strtod(cases[i], NULL);
+    const f64 parsed = str_f64(str_from_cstr(cases[i]));
+    cebus_assert(memcmp(&parsed, &expected, sizeof(f64)) == 0, "%s: %.17g", cases[i], parsed);
+  }
+}
+
+static void test_parse_numbers(void) {
+  cebus_assert(str_parse_u64(STR("18446744073709551615"), ErrPanic) == U64_MAX, "");
+  cebus_assert(str_parse_i64(STR("-12"), ErrPanic) == -12, "");
+  cebus_assert(str_parse_f64(STR("-1.25"), ErrPanic) == -1.25, "");
+
+  const struct {
+    Str s;
+    StrParseError u64;
+    StrParseError i64;
+    StrParseError f64;
+  } tests[] = {
+      {STR(""), STR_PARSE_INVALID, STR_PARSE_INVALID, STR_PARSE_INVALID},
+      {STR(" 1"), STR_PARSE_INVALID, STR_PARSE_INVALID, STR_PARSE_INVALID},
+      {STR("1x"), STR_PARSE_INVALID, STR_PARSE_INVALID, STR_PARSE_INVALID},
+      {STR("-1"), STR_PARSE_INVALID, STR_PARSE_OK, STR_PARSE_OK},
+      {STR("1.5"), STR_PARSE_INVALID, STR_PARSE_INVALID, STR_PARSE_OK},
+      {STR("18446744073709551616"), STR_PARSE_OVERFLOW, STR_PARSE_OVERFLOW, STR_PARSE_OK},
+      {STR("9223372036854775808"), STR_PARSE_OK, STR_PARSE_OVERFLOW, STR_PARSE_OK},
+      {STR("-9223372036854775809"), STR_PARSE_INVALID, STR_PARSE_OVERFLOW, STR_PARSE_OK},
+      {STR("1e999"), STR_PARSE_INVALID, STR_PARSE_INVALID, STR_PARSE_OVERFLOW},
+  };
+  for (usize i = 0; i < ARRAY_LEN(tests); i++) {
+    Error error = ErrNew;
+    str_parse_u64(tests[i].s, &error);
+    StrParseError code = STR_PARSE_OK;
+    error_context(&error, {
+      code = error_code(StrParseError);
+      error_except();
+    });
+    cebus_assert(code == tests[i].u64, "u64 %" USIZE_FMT ": %d", i, code);
+
+    code = STR_PARSE_OK;
+    str_parse_i64(tests[i].s, &error);
+    error_context(&error, {
+      code = error_code(StrParseError);
+      error_except();
+    });
+    cebus_assert(code == tests[i].i64, "i64 %" USIZE_FMT ": %d", i, code);
+
+    code = STR_PARSE_OK;
+    str_parse_f64(tests[i].s, &error);
+    error_context(&error, {
+      code = error_code(StrParseError);
+      error_except();
+    });
+    cebus_assert(code == tests[i].f64, "f64 %" USIZE_FMT ": %d", i, code);
+  }
+}
+
+static void test_parse_da(void) {
+  Arena arena = {0};
+
+  DA(u64) ids = da_new(&arena);
+  str_parse_u64_da(STR("1\n22\n333\n"), '\n', &ids, ErrPanic);
+  cebus_assert(da_len(&ids) == 3, "%" USIZE_FMT, da_len(&ids));
+  cebus_assert(ids.items[0] == 1 && ids.items[1] == 22 && ids.items[2] == 333, "");
+
+  DA(f64) prices = da_new(&arena);
+  str_parse_f64_da(STR("1.5, -2 ,3e2"), ',', &prices, ErrPanic);
+  str_parse_f64_da(STR("4"), ',', &prices, ErrPanic);
+  cebus_assert(da_len(&prices) == 4, "%" USIZE_FMT, da_len(&prices));
+  cebus_assert(prices.items[1] == -2 && prices.items[2] == 300 && prices.items[3] == 4, "");
+
+  DA(i64) values = da_new(&arena);
+  Error error = ErrNew;
+  str_parse_i64_da(STR("1,-2,,4"), ',', &values, &error);
+  bool failed = false;
+  error_context(&error, {
+    failed = error_code(StrParseError) == STR_PARSE_INVALID;
+    error_except();
+  });
+  cebus_assert(failed, "the empty field is invalid");
+  cebus_assert(da_len(&values) == 2 && values.items[1] == -2, "");
+
+  da_clear(&values);
+  str_parse_i64_da(STR("1, 99999999999999999999"), ',', &values, &error);
+  Str msg = {0};
+  error_context(&error, {
+    failed = error_code(StrParseError) == STR_PARSE_OVERFLOW;
+    msg = str_copy(error_msg(), &arena);
+    error_except();
+  });
+  cebus_assert(failed, "the field does not fit");
+  cebus_assert(str_eq(msg, STR("field 1: '99999999999999999999' does not fit into i64")), STR_FMT,
+               STR_ARG(msg));
+
+  da_clear(&values);
+  str_parse_i64_da(STR(""), ',', &values, ErrPanic);
+  cebus_assert(da_len(&values) == 0, "");
+
+  arena_free(&arena);
+}
+
 static void test_find(void) {
   Str s = STR("Hello, World");
   cebus_assert(str_find(s, STR("Hello")) == 0, "");
@@ -205,6 +475,105 @@ static void test_replace(void) {
   arena_free(&arena);
 }
 
+static usize naive_find(Str haystack, Str needle, usize from) {
+  for (usize i = from; i + needle.len <= haystack.len; i++) {
+    if (memcmp(&haystack.data[i], needle.data, needle.len) == 0) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static usize naive_find_ignorecase(Str haystack, Str needle) {
+  for (usize i = 0; i + needle.len <= haystack.len; i++) {
+    if (str_eq_ignorecase(str_substring(haystack, i, i + needle.len), needle)) {
+      return i;
+    }
+  }
+  return STR_NOT_FOUND;
+}
+
+static void test_search_ignorecase(void) {
+  // letters and the bytes that only differ from them in bit 5
+  const char alphabet[] = "aAbB@`[{";
+  char text[3000];
+  u64 seed = 1337;
+  for (usize i = 0; i < sizeof(text); i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    text[i] = alphabet[(seed >> 33) % (sizeof(alphabet) - 1)];
+  }
+  const Str haystack = str_from_parts(sizeof(text), text);
+
+  const usize lengths[] = {1, 2, 3, 5, 16, 17, 32, 33};
+  for (usize l = 0; l < ARRAY_LEN(lengths); l++) {
+    for (usize start = 0; start < 2900; start += 191) {
+      char needle_buffer[64];
+      for (usize i = 0; i < lengths[l]; i++) {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const char c = text[start + i];
+        needle_buffer[i] = (seed >> 40) & 1 ? c_to_upper(c) : c_to_lower(c);
+      }
+      const Str needle = str_from_parts(lengths[l], needle_buffer);
+      const usize expected = naive_find_ignorecase(haystack, needle);
+      cebus_assert(expected <= start, "");
+      cebus_assert(str_find_ignorecase(haystack, needle) == expected, "wrong first match");
+    }
+  }
+
+  cebus_assert(str_find_ignorecase(STR("Hello, World"), STR("WORLD")) == 7, "");
+  cebus_assert(str_find_ignorecase(STR("Hello, World"), STR("")) == 0, "");
+  cebus_assert(str_find_ignorecase(STR("@@@"), STR("`")) == STR_NOT_FOUND, "");
+  cebus_assert(str_find_ignorecase(STR("ab"), STR("abc")) == STR_NOT_FOUND, "");
+}
+
+static void test_search(void) {
+  Arena arena = {0};
+  // a small alphabet, so there are a lot of partial matches
+  char text[5000];
+  u64 seed = 42;
+  for (usize i = 0; i < sizeof(text); i++) {
+    seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+    text[i] = (char)('a' + (seed >> 33) % 3);
+  }
+  const Str haystack = str_from_parts(sizeof(text), text);
+
+  const usize lengths[] = {1, 2, 3, 5, 8, 16, 17, 31, 32, 33, 40, 64};
+  for (usize l = 0; l < ARRAY_LEN(lengths); l++) {
+    for (usize start = 0; start < 4000; start += 397) {
+      const Str needle = str_substring(haystack, start, start + lengths[l]);
+      const usize first = naive_find(haystack, needle, 0);
+      cebus_assert(str_find(haystack, needle) == first, "wrong first match");
+      cebus_assert(str_contains(haystack, needle), "needle should be found");
+
+      usize last = first;
+      usize count = 0;
+      for (usize i = first; i != STR_NOT_FOUND; i = naive_find(haystack, needle, i + 1)) {
+        last = i;
+      }
+      for (usize i = first; i != STR_NOT_FOUND; i = naive_find(haystack, needle, i + needle.len)) {
+        count++;
+      }
+      cebus_assert(str_find_last(haystack, needle) == last, "wrong last match");
+      cebus_assert(str_count(haystack, needle) == count, "wrong count");
+
+      const Str replaced = str_replace(haystack, needle, STR("<>"), &arena);
+      cebus_assert(replaced.len == haystack.len - count * needle.len + count * 2,
+                   "wrong length after replace");
+      cebus_assert(str_count(replaced, STR("<>")) == count, "not every match was replaced");
+    }
+  }
+
+  const Str missing = STR("abcabcabcabcabcabcabcabcabcabcabcabcd");
+  cebus_assert(str_find(haystack, missing) == naive_find(haystack, missing, 0), "");
+  cebus_assert(str_find(STR("ab"), STR("abc")) == STR_NOT_FOUND, "");
+  cebus_assert(str_find_last(STR("abc"), STR("")) == 3, "");
+  cebus_assert(str_count(STR("aaaa"), STR("aa")) == 2, "matches should not overlap");
+  cebus_assert(str_count(STR("abc"), STR("")) == 0, "");
+  cebus_assert(str_eq(str_replace(STR("abc"), STR(""), STR("x"), &arena), STR("abc")), "");
+
+  arena_free(&arena);
+}
+
 static void test_substring(void) {
   Str s = STR("Hello, World");
   Str substring = str_substring(s, 0, 4);
@@ -278,10 +647,10 @@ static void test_hash(void) {
     Str s;
     u64 hash;
   } tests[] = {
-      {STR("Hello"), 0x63f0bfacf2c00f6b},
-      {STR("This is a very long string"), 0xf276220f1fa71f6b},
-      {STR("Another"), 0x90c0e53673f3e9f4},
-      {STR("Hello"), 0x63f0bfacf2c00f6b},
+      {STR("Hello"), 0x0a75a91375b27d44},
+      {STR("This is a very long string"), 0xd82273928be822a4},
+      {STR("Another"), 0x333a4250cd3d062b},
+      {STR("Hello"), 0x0a75a91375b27d44},
   };
 
   for (size_t i = 0; i < sizeof(tests) / sizeof(tests[0]); i++) {
@@ -334,10 +703,18 @@ int main(void) {
   test_chop();
   test_try_chop();
   test_chop_right();
+  test_charset();
+  test_split();
   test_number_converting();
+  test_chop_numbers();
+  test_f64_exact();
+  test_parse_numbers();
+  test_parse_da();
   test_find();
   test_count();
   test_replace();
+  test_search();
+  test_search_ignorecase();
   test_substring();
   test_join();
   test_justify();